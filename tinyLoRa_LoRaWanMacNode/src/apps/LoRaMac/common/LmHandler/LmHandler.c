@@ -32,6 +32,9 @@
 #include "radio.h"
 #include "LmHandler.h"
 #include "LmhPackage.h"
+#if defined( USE_ENTROPY_POOL )
+#include "sx-entropy.h"
+#endif
 #include "LmhpCompliance.h"
 #include "LmhpClockSync.h"
 #include "LmhpRemoteMcastSetup.h"
@@ -154,6 +157,84 @@ static TimerTime_t DutyCycleWaitTime = 0;
  */
 static bool IsUplinkTxPending = false;
 
+/*
+ *=============================================================================
+ * UPLINK QUEUE
+ *=============================================================================
+ */
+typedef struct LmHandlerUplink_s
+{
+    LmHandlerUplinkParams_t Params;
+    /*!
+     * Arrival order, breaks the ties between entries of same priority
+     */
+    uint32_t Sequence;
+    TimerTime_t EnqueueTime;
+    uint8_t Port;
+    uint8_t BufferSize;
+    uint8_t Buffer[LMH_UPLINK_QUEUE_BUFFER_SIZE];
+}LmHandlerUplink_t;
+
+/*!
+ * Queued uplinks, unordered in [0, UplinkQueueDepth[
+ */
+static LmHandlerUplink_t UplinkQueue[LMH_UPLINK_QUEUE_SIZE];
+static uint8_t UplinkQueueDepth = 0;
+static uint32_t UplinkQueueSequence = 0;
+static LmHandlerUplinkQueueStats_t UplinkQueueStats;
+
+/*!
+ * Set while the duty-cycle forbids the next uplink
+ */
+static bool IsUplinkQueueWaiting = false;
+
+/*!
+ * Ends the duty-cycle wait of the uplink queue
+ */
+static TimerEvent_t UplinkQueueTimer;
+
+/*!
+ * Hands the next queued uplink to the MAC layer when possible
+ */
+static void LmHandlerUplinkQueueProcess( void );
+
+static void OnUplinkQueueTimerEvent( void* context );
+
+/*
+ *=============================================================================
+ * AGGREGATION
+ *=============================================================================
+ */
+typedef struct LmHandlerRecord_s
+{
+    /*!
+     * Time at which the record is flushed
+     */
+    TimerTime_t FlushTime;
+    uint8_t Port;
+    uint8_t BufferSize;
+    uint8_t Buffer[LMH_AGGREGATION_RECORD_SIZE];
+}LmHandlerRecord_t;
+
+/*!
+ * Pending records, in arrival order in [0, AggregationDepth[
+ */
+static LmHandlerRecord_t AggregationRecords[LMH_AGGREGATION_SIZE];
+static uint8_t AggregationDepth = 0;
+static LmHandlerAggregationStats_t AggregationStats;
+
+/*!
+ * Wakes up the application when the oldest record reaches its latency
+ */
+static TimerEvent_t AggregationTimer;
+
+/*!
+ * Packs the pending records into an uplink when due
+ */
+static void LmHandlerAggregationProcess( void );
+
+static void OnAggregationTimerEvent( void* context );
+
 /*!
  * \brief   MCPS-Confirm event function
  *
@@ -250,6 +331,16 @@ LmHandlerErrorStatus_t LmHandlerInit( LmHandlerCallbacks_t *handlerCallbacks,
     IsClassBSwitchPending = false;
     IsUplinkTxPending = false;
 
+    UplinkQueueDepth = 0;
+    UplinkQueueSequence = 0;
+    memset1( ( uint8_t* )&UplinkQueueStats, 0, sizeof( UplinkQueueStats ) );
+    IsUplinkQueueWaiting = false;
+    TimerInit( &UplinkQueueTimer, OnUplinkQueueTimerEvent );
+
+    AggregationDepth = 0;
+    memset1( ( uint8_t* )&AggregationStats, 0, sizeof( AggregationStats ) );
+    TimerInit( &AggregationTimer, OnAggregationTimerEvent );
+
     if( LoRaMacInitialization( &LoRaMacPrimitives, &LoRaMacCallbacks, LmHandlerParams->Region ) != LORAMAC_STATUS_OK )
     {
         return LORAMAC_HANDLER_ERROR;
@@ -367,6 +458,11 @@ void LmHandlerProcess( void )
     // Processes the LoRaMac events
     LoRaMacProcess( );
 
+#if defined( USE_ENTROPY_POOL )
+    // Keep random numbers ready for the MAC
+    EntropyProcess( );
+#endif
+
     // Store to NVM if required
     size = NvmDataMgmtStore( );
 
@@ -378,6 +474,12 @@ void LmHandlerProcess( void )
     // Call all packages process functions
     LmHandlerPackagesProcess( );
 
+    // Pack the pending records when due
+    LmHandlerAggregationProcess( );
+
+    // Hand the next queued uplink to the MAC layer
+    LmHandlerUplinkQueueProcess( );
+
     // Check if a package transmission is pending.
     // If it is the case exit function earlier
     if( LmHandlerPackageIsTxPending( ) == true )
@@ -385,8 +487,9 @@ void LmHandlerProcess( void )
         return;
     }
 
-    // If a MAC layer scheduled uplink is still pending try to send it.
-    if( IsUplinkTxPending == true )
+    // If a MAC layer scheduled uplink is still pending queue it. Any queued
+    // uplink flushes the server as well.
+    if( ( IsUplinkTxPending == true ) && ( UplinkQueueDepth == 0 ) )
     {
         // Send an empty message
         LmHandlerAppData_t appData =
@@ -395,8 +498,15 @@ void LmHandlerProcess( void )
             .BufferSize = 0,
             .Port = 0,
         };
+        LmHandlerUplinkParams_t params =
+        {
+            .MsgType = LmHandlerParams->IsTxConfirmed,
+            .Priority = LORAMAC_HANDLER_PRIORITY_HIGH,
+            .Deadline = 0,
+            .CoalescingKey = LMH_UPLINK_COALESCING_KEY_MAC,
+        };
 
-        if( LmHandlerSend( &appData, LmHandlerParams->IsTxConfirmed ) == LORAMAC_HANDLER_SUCCESS )
+        if( LmHandlerEnqueue( &appData, &params ) == LORAMAC_HANDLER_SUCCESS )
         {
             IsUplinkTxPending = false;
         }
@@ -408,6 +518,21 @@ TimerTime_t LmHandlerGetDutyCycleWaitTime( void )
     return DutyCycleWaitTime;
 }
 
+LmHandlerErrorStatus_t LmHandlerGetNextTxDelay( uint8_t size, TimerTime_t *delay )
+{
+    int8_t datarate = LmHandlerParams->TxDatarate;
+
+    if( LmHandlerParams->AdrEnable == true )
+    {
+        datarate = LmHandlerGetCurrentDatarate( );
+    }
+    if( LoRaMacQueryNextTxDelay( size, datarate, delay ) != LORAMAC_STATUS_OK )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
 /*!
  * Join a LoRa Network in classA
  *
@@ -469,31 +594,41 @@ LmHandlerFlagStatus_t LmHandlerJoinStatus( void )
     }
 }
 
-LmHandlerErrorStatus_t LmHandlerSend( LmHandlerAppData_t *appData, LmHandlerMsgTypes_t isTxConfirmed )
+/*!
+ * Hands an uplink to the MAC layer
+ *
+ * \param [IN]  appData       Data to be sent
+ * \param [IN]  isTxConfirmed Indicates if the uplink requires an acknowledgement
+ * \param [OUT] isDataSent    Set when the data is sent, cleared when an empty
+ *                            frame is sent instead to flush the MAC commands
+ *
+ * \retval status MAC layer request status
+ */
+static LoRaMacStatus_t LmHandlerMcpsRequest( LmHandlerAppData_t *appData, LmHandlerMsgTypes_t isTxConfirmed, bool *isDataSent )
 {
     LoRaMacStatus_t status;
     McpsReq_t mcpsReq;
     LoRaMacTxInfo_t txInfo;
 
-    if( LmHandlerJoinStatus( ) != LORAMAC_HANDLER_SET )
-    {
-        // The network isn't joined, try again.
-        LmHandlerJoinRequest( CommissioningParams.IsOtaaActivation );
-        return LORAMAC_HANDLER_ERROR;
-    }
-
     TxParams.MsgType = isTxConfirmed;
     mcpsReq.Type = ( isTxConfirmed == LORAMAC_HANDLER_UNCONFIRMED_MSG ) ? MCPS_UNCONFIRMED : MCPS_CONFIRMED;
     mcpsReq.Req.Unconfirmed.Datarate = LmHandlerParams->TxDatarate;
     if( LoRaMacQueryTxPossible( appData->BufferSize, &txInfo ) != LORAMAC_STATUS_OK )
     {
+        if( appData->BufferSize > txInfo.CurrentPossiblePayloadSize )
+        {
+            // Does not fit the current datarate even without MAC commands
+            return LORAMAC_STATUS_LENGTH_ERROR;
+        }
         // Send empty frame in order to flush MAC commands
+        *isDataSent = false;
         mcpsReq.Type = MCPS_UNCONFIRMED;
         mcpsReq.Req.Unconfirmed.fBuffer = NULL;
         mcpsReq.Req.Unconfirmed.fBufferSize = 0;
     }
     else
     {
+        *isDataSent = true;
         mcpsReq.Req.Unconfirmed.fPort = appData->Port;
         mcpsReq.Req.Unconfirmed.fBufferSize = appData->BufferSize;
         mcpsReq.Req.Unconfirmed.fBuffer = appData->Buffer;
@@ -509,12 +644,476 @@ LmHandlerErrorStatus_t LmHandlerSend( LmHandlerAppData_t *appData, LmHandlerMsgT
     if( status == LORAMAC_STATUS_OK )
     {
         IsUplinkTxPending = false;
-        return LORAMAC_HANDLER_SUCCESS;
     }
-    else
+    return status;
+}
+
+LmHandlerErrorStatus_t LmHandlerSend( LmHandlerAppData_t *appData, LmHandlerMsgTypes_t isTxConfirmed )
+{
+    LmHandlerUplinkParams_t params =
+    {
+        .MsgType = isTxConfirmed,
+        .Priority = LORAMAC_HANDLER_PRIORITY_NORMAL,
+        .Deadline = 0,
+        .CoalescingKey = 0,
+    };
+
+    return LmHandlerEnqueue( appData, &params );
+}
+
+/*!
+ * Gets the next queued uplink to send
+ *
+ * \retval index Entry index, highest priority first then oldest [-1: empty queue]
+ */
+static int8_t LmHandlerUplinkQueueNext( void )
+{
+    int8_t next = -1;
+
+    for( uint8_t i = 0; i < UplinkQueueDepth; i++ )
+    {
+        if( ( next < 0 ) ||
+            ( UplinkQueue[i].Params.Priority > UplinkQueue[next].Params.Priority ) ||
+            ( ( UplinkQueue[i].Params.Priority == UplinkQueue[next].Params.Priority ) &&
+              ( ( int32_t )( UplinkQueue[i].Sequence - UplinkQueue[next].Sequence ) < 0 ) ) )
+        {
+            next = i;
+        }
+    }
+    return next;
+}
+
+/*!
+ * Gets the queued uplink evicted first when the queue is full
+ *
+ * \retval index Entry index, lowest priority first then newest [-1: empty queue]
+ */
+static int8_t LmHandlerUplinkQueueVictim( void )
+{
+    int8_t victim = -1;
+
+    for( uint8_t i = 0; i < UplinkQueueDepth; i++ )
+    {
+        if( ( victim < 0 ) ||
+            ( UplinkQueue[i].Params.Priority < UplinkQueue[victim].Params.Priority ) ||
+            ( ( UplinkQueue[i].Params.Priority == UplinkQueue[victim].Params.Priority ) &&
+              ( ( int32_t )( UplinkQueue[i].Sequence - UplinkQueue[victim].Sequence ) > 0 ) ) )
+        {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+/*!
+ * Suspends the uplink queue until the duty-cycle allows the next uplink
+ *
+ * \param [IN] delay Time to wait [ms]
+ */
+static void LmHandlerUplinkQueueWait( TimerTime_t delay )
+{
+    IsUplinkQueueWaiting = true;
+    TimerSetValue( &UplinkQueueTimer, ( delay > 0 ) ? delay : 1 );
+    TimerStart( &UplinkQueueTimer );
+}
+
+static void LmHandlerUplinkQueueRemove( uint8_t index )
+{
+    UplinkQueueDepth--;
+    if( index != UplinkQueueDepth )
+    {
+        UplinkQueue[index] = UplinkQueue[UplinkQueueDepth];
+    }
+    UplinkQueueStats.Depth = UplinkQueueDepth;
+}
+
+/*!
+ * Hands a queued uplink to the MAC layer and updates the queue accordingly
+ *
+ * \param [IN] index Entry index
+ *
+ * \retval status MAC layer request status
+ */
+static LoRaMacStatus_t LmHandlerUplinkQueueSend( uint8_t index )
+{
+    LmHandlerUplink_t *uplink = &UplinkQueue[index];
+    LmHandlerAppData_t appData =
+    {
+        .Port = uplink->Port,
+        .BufferSize = uplink->BufferSize,
+        .Buffer = uplink->Buffer,
+    };
+    bool isDataSent = false;
+    LoRaMacStatus_t status;
+    TimerTime_t delay = 0;
+    uint32_t waitTime;
+
+    // Sleep until the uplink is allowed instead of issuing a restricted request
+    if( ( LmHandlerGetNextTxDelay( uplink->BufferSize, &delay ) == LORAMAC_HANDLER_SUCCESS ) && ( delay > 0 ) )
+    {
+        DutyCycleWaitTime = delay;
+        LmHandlerUplinkQueueWait( delay );
+        return LORAMAC_STATUS_DUTYCYCLE_RESTRICTED;
+    }
+
+    if( uplink->Params.OnSend != NULL )
+    {
+        uplink->Params.OnSend( &appData );
+    }
+
+    status = LmHandlerMcpsRequest( &appData, uplink->Params.MsgType, &isDataSent );
+    if( ( ( status != LORAMAC_STATUS_OK ) || ( isDataSent == false ) ) && ( uplink->Params.OnSendAbort != NULL ) )
+    {
+        // Only the refused requests of the default case below drop the entry
+        uplink->Params.OnSendAbort( ( status != LORAMAC_STATUS_OK ) &&
+                                    ( status != LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) &&
+                                    ( status != LORAMAC_STATUS_BUSY ) );
+    }
+    switch( status )
+    {
+        case LORAMAC_STATUS_OK:
+        {
+            if( isDataSent == true )
+            {
+                waitTime = TimerGetElapsedTime( uplink->EnqueueTime );
+                UplinkQueueStats.NbSent++;
+                UplinkQueueStats.TotalWaitTime += waitTime;
+                if( waitTime > UplinkQueueStats.MaxWaitTime )
+                {
+                    UplinkQueueStats.MaxWaitTime = waitTime;
+                }
+                LmHandlerUplinkQueueRemove( index );
+            }
+            break;
+        }
+        case LORAMAC_STATUS_DUTYCYCLE_RESTRICTED:
+        {
+            LmHandlerUplinkQueueWait( DutyCycleWaitTime );
+            break;
+        }
+        case LORAMAC_STATUS_BUSY:
+        {
+            // Retried once the MAC layer is idle
+            break;
+        }
+        default:
+        {
+            UplinkQueueStats.NbDroppedError++;
+            LmHandlerUplinkQueueRemove( index );
+            break;
+        }
+    }
+    return status;
+}
+
+LmHandlerErrorStatus_t LmHandlerEnqueue( LmHandlerAppData_t *appData, const LmHandlerUplinkParams_t *params )
+{
+    LmHandlerUplink_t *uplink = NULL;
+    int8_t index = -1;
+
+    if( ( appData == NULL ) || ( params == NULL ) ||
+        ( appData->BufferSize > LMH_UPLINK_QUEUE_BUFFER_SIZE ) ||
+        ( ( appData->BufferSize > 0 ) && ( appData->Buffer == NULL ) ) )
     {
         return LORAMAC_HANDLER_ERROR;
     }
+
+    if( LmHandlerJoinStatus( ) != LORAMAC_HANDLER_SET )
+    {
+        // The network isn't joined, try again.
+        LmHandlerJoinRequest( CommissioningParams.IsOtaaActivation );
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    if( params->CoalescingKey != 0 )
+    {
+        for( uint8_t i = 0; i < UplinkQueueDepth; i++ )
+        {
+            if( UplinkQueue[i].Params.CoalescingKey == params->CoalescingKey )
+            {
+                // Keeps the position of the replaced entry
+                index = i;
+                UplinkQueueStats.NbCoalesced++;
+                break;
+            }
+        }
+    }
+
+    if( index < 0 )
+    {
+        if( UplinkQueueDepth >= LMH_UPLINK_QUEUE_SIZE )
+        {
+            index = LmHandlerUplinkQueueVictim( );
+            UplinkQueueStats.NbDroppedFull++;
+            if( params->Priority <= UplinkQueue[index].Params.Priority )
+            {
+                return LORAMAC_HANDLER_ERROR;
+            }
+        }
+        else
+        {
+            index = UplinkQueueDepth++;
+        }
+        UplinkQueue[index].Sequence = UplinkQueueSequence++;
+        UplinkQueue[index].EnqueueTime = TimerGetCurrentTime( );
+    }
+
+    uplink = &UplinkQueue[index];
+    uplink->Params = *params;
+    uplink->Port = appData->Port;
+    uplink->BufferSize = appData->BufferSize;
+    if( appData->BufferSize > 0 )
+    {
+        memcpy1( uplink->Buffer, appData->Buffer, appData->BufferSize );
+    }
+
+    UplinkQueueStats.NbEnqueued++;
+    UplinkQueueStats.Depth = UplinkQueueDepth;
+    if( UplinkQueueDepth > UplinkQueueStats.MaxDepth )
+    {
+        UplinkQueueStats.MaxDepth = UplinkQueueDepth;
+    }
+
+    // Send at once when nothing else is waiting
+    if( ( UplinkQueueDepth == 1 ) && ( IsUplinkQueueWaiting == false ) && ( LoRaMacIsBusy( ) == false ) )
+    {
+        if( LmHandlerUplinkQueueSend( index ) == LORAMAC_STATUS_LENGTH_ERROR )
+        {
+            return LORAMAC_HANDLER_ERROR;
+        }
+    }
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
+static void LmHandlerUplinkQueueProcess( void )
+{
+    TimerTime_t now;
+    int8_t index;
+
+    if( ( UplinkQueueDepth == 0 ) || ( IsUplinkQueueWaiting == true ) ||
+        ( LoRaMacIsBusy( ) == true ) || ( LmHandlerJoinStatus( ) != LORAMAC_HANDLER_SET ) )
+    {
+        return;
+    }
+
+    now = TimerGetCurrentTime( );
+    for( uint8_t i = UplinkQueueDepth; i > 0; i-- )
+    {
+        LmHandlerUplink_t *uplink = &UplinkQueue[i - 1];
+
+        if( ( uplink->Params.Deadline != 0 ) && ( ( now - uplink->EnqueueTime ) > uplink->Params.Deadline ) )
+        {
+            UplinkQueueStats.NbDroppedDeadline++;
+            LmHandlerUplinkQueueRemove( i - 1 );
+        }
+    }
+
+    index = LmHandlerUplinkQueueNext( );
+    if( index >= 0 )
+    {
+        LmHandlerUplinkQueueSend( index );
+    }
+}
+
+void LmHandlerGetUplinkQueueStats( LmHandlerUplinkQueueStats_t *stats )
+{
+    *stats = UplinkQueueStats;
+}
+
+static void OnUplinkQueueTimerEvent( void* context )
+{
+    TimerStop( &UplinkQueueTimer );
+    IsUplinkQueueWaiting = false;
+
+    // Wake up the application so that LmHandlerProcess drains the queue
+    if( LmHandlerCallbacks->OnMacProcess != NULL )
+    {
+        LmHandlerCallbacks->OnMacProcess( );
+    }
+}
+
+LmHandlerErrorStatus_t LmHandlerAggregate( LmHandlerAppData_t *appData, TimerTime_t maxLatency )
+{
+    LmHandlerRecord_t *record = NULL;
+    TimerTime_t now;
+
+    if( ( appData == NULL ) || ( appData->Port == 0 ) || ( appData->Port > 223 ) ||
+        ( appData->BufferSize > LMH_AGGREGATION_RECORD_SIZE ) ||
+        ( ( appData->BufferSize > 0 ) && ( appData->Buffer == NULL ) ) )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    if( LmHandlerJoinStatus( ) != LORAMAC_HANDLER_SET )
+    {
+        // The network isn't joined, try again.
+        LmHandlerJoinRequest( CommissioningParams.IsOtaaActivation );
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    if( AggregationDepth >= LMH_AGGREGATION_SIZE )
+    {
+        AggregationStats.NbDroppedFull++;
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    now = TimerGetCurrentTime( );
+    record = &AggregationRecords[AggregationDepth++];
+    record->FlushTime = now + maxLatency;
+    record->Port = appData->Port;
+    record->BufferSize = appData->BufferSize;
+    if( appData->BufferSize > 0 )
+    {
+        memcpy1( record->Buffer, appData->Buffer, appData->BufferSize );
+    }
+    AggregationStats.NbRecords++;
+
+    // Flush at once when due, else rearm the timer on the earliest flush time
+    LmHandlerAggregationProcess( );
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
+/*!
+ * Gets the earliest flush time of the pending records
+ *
+ * \retval flushTime Earliest flush time
+ */
+static TimerTime_t LmHandlerAggregationFlushTime( void )
+{
+    TimerTime_t flushTime = AggregationRecords[0].FlushTime;
+
+    for( uint8_t i = 1; i < AggregationDepth; i++ )
+    {
+        if( ( int32_t )( AggregationRecords[i].FlushTime - flushTime ) < 0 )
+        {
+            flushTime = AggregationRecords[i].FlushTime;
+        }
+    }
+    return flushTime;
+}
+
+/*!
+ * Checks if an uplink of the aggregation stage is still queued
+ */
+static bool LmHandlerAggregationIsQueued( void )
+{
+    for( uint8_t i = 0; i < UplinkQueueDepth; i++ )
+    {
+        if( UplinkQueue[i].Params.CoalescingKey == LMH_UPLINK_COALESCING_KEY_AGGREGATION )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void LmHandlerAggregationProcess( void )
+{
+    uint8_t buffer[LMH_UPLINK_QUEUE_BUFFER_SIZE];
+    LmHandlerAppData_t appData;
+    LmHandlerUplinkParams_t params =
+    {
+        .MsgType = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+        .Priority = LORAMAC_HANDLER_PRIORITY_NORMAL,
+        .Deadline = 0,
+        .CoalescingKey = LMH_UPLINK_COALESCING_KEY_AGGREGATION,
+    };
+    LoRaMacTxInfo_t txInfo;
+    TimerTime_t flushTime;
+    TimerTime_t now;
+    uint16_t maxSize;
+    uint16_t size = 0;
+    uint8_t nbRecords = 0;
+
+    if( ( AggregationDepth == 0 ) || ( LmHandlerAggregationIsQueued( ) == true ) )
+    {
+        // The records queued meanwhile join the next uplink
+        return;
+    }
+
+    LoRaMacQueryTxPossible( 0, &txInfo );
+    maxSize = MIN( txInfo.MaxPossibleApplicationDataSize, LMH_UPLINK_QUEUE_BUFFER_SIZE );
+
+    for( uint8_t i = 0; i < AggregationDepth; i++ )
+    {
+        size += LMH_AGGREGATION_RECORD_HEADER_SIZE + AggregationRecords[i].BufferSize;
+    }
+
+    now = TimerGetCurrentTime( );
+    flushTime = LmHandlerAggregationFlushTime( );
+    if( ( ( int32_t )( flushTime - now ) > 0 ) && ( size < maxSize ) )
+    {
+        // Not due yet, wait for more records
+        TimerStop( &AggregationTimer );
+        TimerSetValue( &AggregationTimer, flushTime - now );
+        TimerStart( &AggregationTimer );
+        return;
+    }
+    TimerStop( &AggregationTimer );
+
+    // Pack the oldest records that fit
+    size = 0;
+    while( ( nbRecords < AggregationDepth ) &&
+           ( ( size + LMH_AGGREGATION_RECORD_HEADER_SIZE + AggregationRecords[nbRecords].BufferSize ) <= maxSize ) )
+    {
+        LmHandlerRecord_t *record = &AggregationRecords[nbRecords++];
+
+        buffer[size++] = record->Port;
+        buffer[size++] = record->BufferSize;
+        memcpy1( buffer + size, record->Buffer, record->BufferSize );
+        size += record->BufferSize;
+    }
+
+    if( nbRecords <= 1 )
+    {
+        // A lone record is sent as is, saving the record header
+        nbRecords = 1;
+        appData.Port = AggregationRecords[0].Port;
+        appData.BufferSize = AggregationRecords[0].BufferSize;
+        appData.Buffer = AggregationRecords[0].Buffer;
+    }
+    else
+    {
+        appData.Port = LMH_AGGREGATION_PORT;
+        appData.BufferSize = size;
+        appData.Buffer = buffer;
+        AggregationStats.NbAggregatedFrames++;
+    }
+    AggregationStats.NbFrames++;
+    AggregationStats.NbBytes += appData.BufferSize;
+
+    // The records are released even when rejected, the uplink queue accounts
+    // for the errors
+    LmHandlerEnqueue( &appData, &params );
+
+    AggregationDepth -= nbRecords;
+    for( uint8_t i = 0; i < AggregationDepth; i++ )
+    {
+        AggregationRecords[i] = AggregationRecords[i + nbRecords];
+    }
+
+    if( AggregationDepth > 0 )
+    {
+        // Wake up the application at the next flush time
+        TimerSetValue( &AggregationTimer, 1 );
+        TimerStart( &AggregationTimer );
+    }
+}
+
+void LmHandlerGetAggregationStats( LmHandlerAggregationStats_t *stats )
+{
+    *stats = AggregationStats;
+}
+
+static void OnAggregationTimerEvent( void* context )
+{
+    TimerStop( &AggregationTimer );
+
+    // Wake up the application so that LmHandlerProcess packs the records
+    if( LmHandlerCallbacks->OnMacProcess != NULL )
+    {
+        LmHandlerCallbacks->OnMacProcess( );
+    }
 }
 
 static LmHandlerErrorStatus_t LmHandlerDeviceTimeReq( void )
@@ -32,6 +32,59 @@ extern "C"
 
 #include "LmHandlerTypes.h"
 
+/*!
+ * Number of uplinks held by the uplink queue
+ */
+#ifndef LMH_UPLINK_QUEUE_SIZE
+#define LMH_UPLINK_QUEUE_SIZE                       4
+#endif
+
+/*!
+ * Maximum payload size of a queued uplink
+ */
+#ifndef LMH_UPLINK_QUEUE_BUFFER_SIZE
+#define LMH_UPLINK_QUEUE_BUFFER_SIZE                242
+#endif
+
+/*!
+ * Coalescing key of the empty uplinks requested by the MAC layer
+ */
+#define LMH_UPLINK_COALESCING_KEY_MAC               0xFF
+
+/*!
+ * Coalescing key of the aggregated uplinks
+ */
+#define LMH_UPLINK_COALESCING_KEY_AGGREGATION       0xFE
+
+/*!
+ * FPort of the aggregated uplinks
+ *
+ * \remark The payload is a sequence of records
+ *         [FPort 1 byte][Size 1 byte][Payload Size bytes]
+ */
+#ifndef LMH_AGGREGATION_PORT
+#define LMH_AGGREGATION_PORT                        210
+#endif
+
+/*!
+ * Number of records held by the aggregation stage
+ */
+#ifndef LMH_AGGREGATION_SIZE
+#define LMH_AGGREGATION_SIZE                        8
+#endif
+
+/*!
+ * Maximum payload size of an aggregated record
+ */
+#ifndef LMH_AGGREGATION_RECORD_SIZE
+#define LMH_AGGREGATION_RECORD_SIZE                 32
+#endif
+
+/*!
+ * Aggregated record header size
+ */
+#define LMH_AGGREGATION_RECORD_HEADER_SIZE          2
+
 typedef struct LmHandlerJoinParams_s
 {
     CommissioningParams_t *CommissioningParams;
@@ -65,6 +118,114 @@ typedef struct LmHandlerRxParams_s
     int8_t RxSlot;
 }LmHandlerRxParams_t;
 
+/*!
+ * Uplink queue entry parameters
+ */
+typedef struct LmHandlerUplinkParams_s
+{
+    /*!
+     * Uplink frame type
+     */
+    LmHandlerMsgTypes_t MsgType;
+    /*!
+     * Entries are sent by decreasing priority, then in arrival order
+     */
+    LmHandlerPriorities_t Priority;
+    /*!
+     * Time after which the entry is dropped if not yet sent [ms, 0: none]
+     */
+    TimerTime_t Deadline;
+    /*!
+     * A queued entry with the same key is replaced by the new one [0: none]
+     */
+    uint8_t CoalescingKey;
+    /*!
+     * Called right before the entry is handed to the MAC layer [NULL: none].
+     * It may rewrite the payload in place and change the MAC layer settings
+     * for this uplink.
+     */
+    void ( *OnSend )( LmHandlerAppData_t *appData );
+    /*!
+     * Called when the uplink prepared by OnSend did not leave [NULL: none].
+     * The entry stays queued unless isDropped is set.
+     */
+    void ( *OnSendAbort )( bool isDropped );
+}LmHandlerUplinkParams_t;
+
+/*!
+ * Uplink queue statistics
+ */
+typedef struct LmHandlerUplinkQueueStats_s
+{
+    /*!
+     * Current number of queued entries
+     */
+    uint8_t Depth;
+    /*!
+     * Highest number of queued entries
+     */
+    uint8_t MaxDepth;
+    /*!
+     * Entries accepted by the queue
+     */
+    uint32_t NbEnqueued;
+    /*!
+     * Entries handed to the MAC layer
+     */
+    uint32_t NbSent;
+    /*!
+     * Entries replaced by a newer entry with the same coalescing key
+     */
+    uint32_t NbCoalesced;
+    /*!
+     * Entries rejected or evicted because the queue was full
+     */
+    uint32_t NbDroppedFull;
+    /*!
+     * Entries dropped because their deadline expired
+     */
+    uint32_t NbDroppedDeadline;
+    /*!
+     * Entries dropped because the MAC layer rejected them
+     */
+    uint32_t NbDroppedError;
+    /*!
+     * Sum of the queueing times of the sent entries [ms]
+     */
+    uint32_t TotalWaitTime;
+    /*!
+     * Longest queueing time of a sent entry [ms]
+     */
+    uint32_t MaxWaitTime;
+}LmHandlerUplinkQueueStats_t;
+
+/*!
+ * Aggregation stage statistics
+ */
+typedef struct LmHandlerAggregationStats_s
+{
+    /*!
+     * Records accepted by the aggregation stage
+     */
+    uint32_t NbRecords;
+    /*!
+     * Records rejected because the aggregation stage was full
+     */
+    uint32_t NbDroppedFull;
+    /*!
+     * Uplinks queued by the aggregation stage
+     */
+    uint32_t NbFrames;
+    /*!
+     * Uplinks carrying more than one record
+     */
+    uint32_t NbAggregatedFrames;
+    /*!
+     * Application payload bytes queued, record headers included
+     */
+    uint32_t NbBytes;
+}LmHandlerAggregationStats_t;
+
 typedef struct LoRaMacHandlerBeaconParams_s
 {
     LoRaMacEventInfoStatus_t Status;
@@ -252,17 +413,85 @@ void LmHandlerProcess( void );
  */
 TimerTime_t LmHandlerGetDutyCycleWaitTime( void );
 
+/*!
+ * Gets the time until an uplink of the given size is allowed by the duty-cycle
+ *
+ * \remark Uses the current datarate when ADR is ON, else the configured one.
+ *
+ * \param [IN]  size  Application payload size
+ * \param [OUT] delay Time to wait [ms, 0: now]
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if the delay is known
+ *                else \ref LORAMAC_HANDLER_ERROR
+ */
+LmHandlerErrorStatus_t LmHandlerGetNextTxDelay( uint8_t size, TimerTime_t *delay );
+
 /*!
  * Instructs the MAC layer to send a ClassA uplink
  *
+ * \remark Queues the uplink with \ref LORAMAC_HANDLER_PRIORITY_NORMAL priority,
+ *         no deadline and no coalescing, see \ref LmHandlerEnqueue. A queued
+ *         uplink may still be evicted or refused by the MAC layer later on,
+ *         see \ref LmHandlerGetUplinkQueueStats. Its
+ *         \ref LmHandlerCallbacks_t.OnTxData reports the transmission.
+ *
  * \param [IN] appData Data to be sent
  * \param [IN] isTxConfirmed Indicates if the uplink requires an acknowledgement
  *
- * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if request has been
- *                processed else \ref LORAMAC_HANDLER_ERROR
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if the uplink has been
+ *                sent or only queued else \ref LORAMAC_HANDLER_ERROR
  */
 LmHandlerErrorStatus_t LmHandlerSend( LmHandlerAppData_t *appData, LmHandlerMsgTypes_t isTxConfirmed );
 
+/*!
+ * Queues a ClassA uplink
+ *
+ * \remark The data is copied. The uplink is handed to the MAC layer at once
+ *         when the queue is empty and the MAC layer is idle, else by
+ *         \ref LmHandlerProcess as soon as the MAC layer and the duty-cycle
+ *         allow it. A full queue evicts its newest entry of lowest priority
+ *         when the new entry has a higher priority.
+ *
+ * \param [IN] appData Data to be sent
+ * \param [IN] params  Queue entry parameters
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if the uplink has been
+ *                sent or queued else \ref LORAMAC_HANDLER_ERROR
+ */
+LmHandlerErrorStatus_t LmHandlerEnqueue( LmHandlerAppData_t *appData, const LmHandlerUplinkParams_t *params );
+
+/*!
+ * Gets the uplink queue statistics
+ *
+ * \param [OUT] stats Statistics since \ref LmHandlerInit
+ */
+void LmHandlerGetUplinkQueueStats( LmHandlerUplinkQueueStats_t *stats );
+
+/*!
+ * Adds a record to the aggregation stage
+ *
+ * \remark The data is copied. The pending records are packed into a single
+ *         uplink on \ref LMH_AGGREGATION_PORT once the oldest record reaches
+ *         its maximum latency or once they fill the maximum application
+ *         payload of the current datarate. A lone record is sent on its own
+ *         port. The records wait while an aggregated uplink is queued, the
+ *         latency bounds the aggregation delay, not the duty-cycle delay.
+ *
+ * \param [IN] appData    Record to be sent, FPort in [1..223]
+ * \param [IN] maxLatency Longest time the record may wait for other records [ms]
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if the record has been
+ *                accepted else \ref LORAMAC_HANDLER_ERROR
+ */
+LmHandlerErrorStatus_t LmHandlerAggregate( LmHandlerAppData_t *appData, TimerTime_t maxLatency );
+
+/*!
+ * Gets the aggregation stage statistics
+ *
+ * \param [OUT] stats Statistics since \ref LmHandlerInit
+ */
+void LmHandlerGetAggregationStats( LmHandlerAggregationStats_t *stats );
+
 /*!
  * Join a LoRa Network in classA
  *
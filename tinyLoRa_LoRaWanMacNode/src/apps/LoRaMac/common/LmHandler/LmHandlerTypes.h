@@ -73,6 +73,16 @@ typedef enum
     LORAMAC_HANDLER_TRUE = !LORAMAC_HANDLER_FALSE
 }LmHandlerBoolean_t;
 
+/*!
+ * Uplink queue priorities
+ */
+typedef enum
+{
+    LORAMAC_HANDLER_PRIORITY_LOW = 0,
+    LORAMAC_HANDLER_PRIORITY_NORMAL,
+    LORAMAC_HANDLER_PRIORITY_HIGH,
+}LmHandlerPriorities_t;
+
 typedef enum
 {
     LORAMAC_HANDLER_BEACON_ACQUIRING,
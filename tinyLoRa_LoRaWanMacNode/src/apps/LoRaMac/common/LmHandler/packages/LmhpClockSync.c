@@ -49,6 +49,14 @@ typedef struct LmhpClockSyncState_s
             uint8_t RFU:         3;
         }Fields;
     }TimeReqParam;
+    /*!
+     * An AppTimeReq waits in the LmHandler uplink queue
+     */
+    bool AppTimeReqQueued;
+    /*!
+     * An AppTimeReq has been handed to the MAC layer with the settings below
+     * overridden
+     */
     bool AppTimeReqPending;
     bool AdrEnabledPrev;
     uint8_t NbTransPrev;
@@ -116,11 +124,27 @@ static void LmhpClockSyncOnMcpsConfirm( McpsConfirm_t *mcpsConfirm );
  */
 static void LmhpClockSyncOnMcpsIndication( McpsIndication_t *mcpsIndication );
 
+/*!
+ * Applies the MAC layer settings of an AppTimeReq and stamps it with the
+ * current device time, called when the uplink queue hands it to the MAC layer
+ *
+ * \param [IN] appData Queued AppTimeReq
+ */
+static void LmhpClockSyncOnAppTimeReqSend( LmHandlerAppData_t *appData );
+
+/*!
+ * Reverts the MAC layer settings of an AppTimeReq that did not leave
+ *
+ * \param [IN] isDropped Set when the uplink queue dropped the request
+ */
+static void LmhpClockSyncOnAppTimeReqSendAbort( bool isDropped );
+
 static LmhpClockSyncState_t LmhpClockSyncState =
 {
     .Initialized = false,
     .IsTxPending = false,
     .TimeReqParam.Value = 0,
+    .AppTimeReqQueued = false,
     .AppTimeReqPending = false,
     .AdrEnabledPrev = false,
     .NbTransPrev = 0,
@@ -177,16 +201,18 @@ static bool LmhpClockSyncIsTxPending( void )
 
 static void LmhpClockSyncProcess( void )
 {
-    if( LmhpClockSyncState.NbTransmissions > 0 )
+    // NbTransmissions counts the requests that actually left
+    if( ( LmhpClockSyncState.NbTransmissions > 0 ) && ( LmhpClockSyncState.AppTimeReqQueued == false ) &&
+        ( LmhpClockSyncState.AppTimeReqPending == false ) )
     {
-        if( LmhpClockSyncAppTimeReq( ) == LORAMAC_HANDLER_SUCCESS )
-        {
-            LmhpClockSyncState.NbTransmissions--;
-        }
+        LmhpClockSyncAppTimeReq( );
     }
 }
 
-static void LmhpClockSyncOnMcpsConfirm( McpsConfirm_t *mcpsConfirm )
+/*!
+ * Restores the MAC layer settings overridden for an AppTimeReq
+ */
+static void LmhpClockSyncRevertMacSettings( void )
 {
     MibRequestConfirm_t mibReq;
 
@@ -211,6 +237,18 @@ static void LmhpClockSyncOnMcpsConfirm( McpsConfirm_t *mcpsConfirm )
     }
 }
 
+static void LmhpClockSyncOnMcpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+    if( LmhpClockSyncState.AppTimeReqPending == true )
+    {
+        LmhpClockSyncRevertMacSettings( );
+        if( LmhpClockSyncState.NbTransmissions > 0 )
+        {
+            LmhpClockSyncState.NbTransmissions--;
+        }
+    }
+}
+
 static void LmhpClockSyncOnMcpsIndication( McpsIndication_t *mcpsIndication )
 {
     uint8_t cmdIndex = 0;
@@ -306,16 +344,45 @@ static void LmhpClockSyncOnMcpsIndication( McpsIndication_t *mcpsIndication )
             .BufferSize = dataBufferIndex,
             .Port = CLOCK_SYNC_PORT
         };
-        LmHandlerSend( &appData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+        LmHandlerUplinkParams_t params =
+        {
+            .MsgType = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+            .Priority = LORAMAC_HANDLER_PRIORITY_HIGH,
+            .Deadline = 0,
+            .CoalescingKey = 0,
+        };
+        LmHandlerEnqueue( &appData, &params );
     }
 }
 
-LmHandlerErrorStatus_t LmhpClockSyncAppTimeReq( void )
+/*!
+ * Writes an AppTimeReq stamped with the current device time
+ *
+ * \param [OUT] buffer Request payload
+ *
+ * \retval size Payload size
+ */
+static uint8_t LmhpClockSyncAppTimeReqBuild( uint8_t *buffer )
 {
-    if( LmHandlerIsBusy( ) == true )
-    {
-        return LORAMAC_HANDLER_ERROR;
-    }
+    SysTime_t curTime = SysTimeGet( );
+    uint8_t dataBufferIndex = 0;
+
+    // Substract Unix to Gps epcoh offset. The system time is based on Unix time.
+    curTime.Seconds -= UNIX_GPS_EPOCH_OFFSET;
+
+    buffer[dataBufferIndex++] = CLOCK_SYNC_APP_TIME_REQ;
+    buffer[dataBufferIndex++] = ( curTime.Seconds >> 0  ) & 0xFF;
+    buffer[dataBufferIndex++] = ( curTime.Seconds >> 8  ) & 0xFF;
+    buffer[dataBufferIndex++] = ( curTime.Seconds >> 16 ) & 0xFF;
+    buffer[dataBufferIndex++] = ( curTime.Seconds >> 24 ) & 0xFF;
+    LmhpClockSyncState.TimeReqParam.Fields.AnsRequired = 0;
+    buffer[dataBufferIndex++] = LmhpClockSyncState.TimeReqParam.Value;
+    return dataBufferIndex;
+}
+
+static void LmhpClockSyncOnAppTimeReqSend( LmHandlerAppData_t *appData )
+{
+    LmhpClockSyncState.AppTimeReqQueued = false;
 
     if( LmhpClockSyncState.AppTimeReqPending == false )
     {
@@ -345,28 +412,53 @@ LmHandlerErrorStatus_t LmhpClockSyncAppTimeReq( void )
         // this package will use DeviceTimeAns answer as clock synchronization
         // mechanism.
         LmhpClockSyncPackage.OnDeviceTimeRequest( );
+
+        LmhpClockSyncState.AppTimeReqPending = true;
     }
 
-    SysTime_t curTime = SysTimeGet( );
-    uint8_t dataBufferIndex = 0;
+    // The time spent in the queue must not skew the request
+    appData->BufferSize = LmhpClockSyncAppTimeReqBuild( appData->Buffer );
+}
 
-    // Substract Unix to Gps epcoh offset. The system time is based on Unix time.
-    curTime.Seconds -= UNIX_GPS_EPOCH_OFFSET;
+static void LmhpClockSyncOnAppTimeReqSendAbort( bool isDropped )
+{
+    LmhpClockSyncRevertMacSettings( );
+    LmhpClockSyncState.AppTimeReqQueued = !isDropped;
+}
 
-    LmhpClockSyncState.DataBuffer[dataBufferIndex++] = CLOCK_SYNC_APP_TIME_REQ;
-    LmhpClockSyncState.DataBuffer[dataBufferIndex++] = ( curTime.Seconds >> 0  ) & 0xFF;
-    LmhpClockSyncState.DataBuffer[dataBufferIndex++] = ( curTime.Seconds >> 8  ) & 0xFF;
-    LmhpClockSyncState.DataBuffer[dataBufferIndex++] = ( curTime.Seconds >> 16 ) & 0xFF;
-    LmhpClockSyncState.DataBuffer[dataBufferIndex++] = ( curTime.Seconds >> 24 ) & 0xFF;
-    LmhpClockSyncState.TimeReqParam.Fields.AnsRequired = 0;
-    LmhpClockSyncState.DataBuffer[dataBufferIndex++] = LmhpClockSyncState.TimeReqParam.Value;
+LmHandlerErrorStatus_t LmhpClockSyncAppTimeReq( void )
+{
+    LmHandlerErrorStatus_t status;
+
+    if( LmHandlerIsBusy( ) == true )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
 
     LmHandlerAppData_t appData =
     {
         .Buffer = LmhpClockSyncState.DataBuffer,
-        .BufferSize = dataBufferIndex,
+        .BufferSize = LmhpClockSyncAppTimeReqBuild( LmhpClockSyncState.DataBuffer ),
         .Port = CLOCK_SYNC_PORT
     };
-    LmhpClockSyncState.AppTimeReqPending = true;
-    return LmHandlerSend( &appData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+    LmHandlerUplinkParams_t params =
+    {
+        .MsgType = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+        .Priority = LORAMAC_HANDLER_PRIORITY_HIGH,
+        // Stamped when sent, no deadline needed
+        .Deadline = 0,
+        // A newer request replaces a queued one
+        .CoalescingKey = CLOCK_SYNC_PORT,
+        .OnSend = LmhpClockSyncOnAppTimeReqSend,
+        .OnSendAbort = LmhpClockSyncOnAppTimeReqSendAbort,
+    };
+
+    // Set first, the queue may hand the request to the MAC layer at once
+    LmhpClockSyncState.AppTimeReqQueued = true;
+    status = LmHandlerEnqueue( &appData, &params );
+    if( status != LORAMAC_HANDLER_SUCCESS )
+    {
+        LmhpClockSyncState.AppTimeReqQueued = false;
+    }
+    return status;
 }
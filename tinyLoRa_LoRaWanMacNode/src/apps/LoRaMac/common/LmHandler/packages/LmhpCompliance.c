@@ -248,8 +248,15 @@ static void LmhpComplianceProcess( void )
                     .BufferSize = ComplianceTestState.DataBufferSize,
                     .Port       = COMPLIANCE_PORT,
                 };
+                LmHandlerUplinkParams_t params = {
+                    .MsgType       = ComplianceTestState.IsTxConfirmed,
+                    .Priority      = LORAMAC_HANDLER_PRIORITY_HIGH,
+                    .Deadline      = 0,
+                    // Only the latest answer is relevant
+                    .CoalescingKey = COMPLIANCE_PORT,
+                };
 
-                if( LmHandlerSend( &appData, ComplianceTestState.IsTxConfirmed ) != LORAMAC_HANDLER_SUCCESS )
+                if( LmHandlerEnqueue( &appData, &params ) != LORAMAC_HANDLER_SUCCESS )
                 {
                     // try to send the message again
                     ComplianceTestState.IsTxPending = true;
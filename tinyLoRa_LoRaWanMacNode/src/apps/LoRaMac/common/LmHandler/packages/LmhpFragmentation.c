@@ -33,6 +33,16 @@
 
 #define FRAGMENTATION_MAX_SESSIONS                  4
 
+/*!
+ * Bulk session setup frequency unit [Hz]
+ */
+#define FRAGMENTATION_BULK_FREQUENCY_UNIT           100
+
+/*!
+ * Bulk session setup bitrate unit [bps]
+ */
+#define FRAGMENTATION_BULK_BITRATE_UNIT             1000
+
 // Fragmentation Tx delay state
 typedef enum LmhpFragmentationTxDelayStates_e
 {
@@ -52,6 +62,9 @@ typedef struct LmhpFragmentationState_s
     bool Initialized;
     bool IsTxPending;
     LmhpFragmentationTxDelayStates_t TxDelayState;
+    bool IsBulkSessionActive;
+    bool IsBulkSessionTimeout;
+    uint8_t BulkSessionFragIndex;
     uint8_t DataBufferMaxSize;
     uint8_t *DataBuffer;
     uint8_t *file;
@@ -63,6 +76,7 @@ typedef enum LmhpFragmentationMoteCmd_e
     FRAGMENTATION_FRAG_STATUS_ANS         = 0x01,
     FRAGMENTATION_FRAG_SESSION_SETUP_ANS  = 0x02,
     FRAGMENTATION_FRAG_SESSION_DELETE_ANS = 0x03,
+    FRAGMENTATION_BULK_SESSION_SETUP_ANS  = 0x80, // Vendor extension
 }LmhpFragmentationMoteCmd_t;
 
 typedef enum LmhpFragmentationSrvCmd_e
@@ -72,6 +86,7 @@ typedef enum LmhpFragmentationSrvCmd_e
     FRAGMENTATION_FRAG_SESSION_SETUP_REQ  = 0x02,
     FRAGMENTATION_FRAG_SESSION_DELETE_REQ = 0x03,
     FRAGMENTATION_DATA_FRAGMENT           = 0x08,
+    FRAGMENTATION_BULK_SESSION_SETUP_REQ  = 0x80, // Vendor extension
 }LmhpFragmentationSrvCmd_t;
 
 /*!
@@ -121,6 +136,8 @@ static LmhpFragmentationState_t LmhpFragmentationState =
     .Initialized = false,
     .IsTxPending = false,
     .TxDelayState = FRAGMENTATION_TX_DELAY_STATE_IDLE,
+    .IsBulkSessionActive = false,
+    .IsBulkSessionTimeout = false,
 };
 
 typedef struct FragGroupData_s
@@ -164,6 +181,17 @@ FragSessionData_t FragSessionData[FRAGMENTATION_MAX_SESSIONS];
 // Answer struct for the commands.
 LmHandlerAppData_t DelayedReplyAppData;
 
+/*!
+ * Queue parameters of the package answers
+ */
+static const LmHandlerUplinkParams_t ReplyParams =
+{
+    .MsgType = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+    .Priority = LORAMAC_HANDLER_PRIORITY_HIGH,
+    .Deadline = 0,
+    .CoalescingKey = 0,
+};
+
 static LmhPackage_t LmhpFragmentationPackage =
 {
     .Port = FRAGMENTATION_PORT,
@@ -199,6 +227,41 @@ static void OnFragmentTxDelay( void* context )
     LmhpFragmentationState.TxDelayState = FRAGMENTATION_TX_DELAY_STATE_STOP;
 }
 
+// Bulk session timeout timer struct
+static TimerEvent_t BulkSessionTimer;
+
+/*!
+ * \brief Callback function for the bulk session timeout timer.
+ */
+static void OnBulkSessionTimeout( void* context )
+{
+    TimerStop( &BulkSessionTimer );
+    LmhpFragmentationState.IsBulkSessionTimeout = true;
+}
+
+/*!
+ * \brief Stops the class C GFSK bulk reception and falls back to the
+ *        regular class C LoRa reception.
+ */
+static void BulkSessionStop( void )
+{
+    MibRequestConfirm_t mibReq;
+
+    TimerStop( &BulkSessionTimer );
+    LmhpFragmentationState.IsBulkSessionTimeout = false;
+    if( LmhpFragmentationState.IsBulkSessionActive == false )
+    {
+        return;
+    }
+    LmhpFragmentationState.IsBulkSessionActive = false;
+
+    mibReq.Type = MIB_RXC_BULK_PARAMS;
+    mibReq.Param.RxCBulkParams.Enabled = false;
+    mibReq.Param.RxCBulkParams.Frequency = 0;
+    mibReq.Param.RxCBulkParams.Bitrate = 0;
+    LoRaMacMibSetRequestConfirm( &mibReq );
+}
+
 LmhPackage_t *LmhpFragmentationPackageFactory( void )
 {
     return &LmhpFragmentationPackage;
@@ -216,6 +279,8 @@ static void LmhpFragmentationInit( void *params, uint8_t *dataBuffer, uint8_t da
         TxDelayTime = 0;
         // Initialize Fragmentation delay timer.
         TimerInit( &FragmentTxDelayTimer, OnFragmentTxDelay );
+        // Initialize bulk session timeout timer.
+        TimerInit( &BulkSessionTimer, OnBulkSessionTimeout );
     }
     else
     {
@@ -238,14 +303,21 @@ static bool  LmhpFragmentationIsTxPending( void )
 static void LmhpFragmentationProcess( void )
 {
     LmhpFragmentationTxDelayStates_t delayTimerState;
+    bool isBulkSessionTimeout;
 
     CRITICAL_SECTION_BEGIN( );
+    isBulkSessionTimeout = LmhpFragmentationState.IsBulkSessionTimeout;
     delayTimerState = LmhpFragmentationState.TxDelayState;
     // Set the state to idle so that the other states are executed only when they are set
     // in the appropriate functions.
     LmhpFragmentationState.TxDelayState = FRAGMENTATION_TX_DELAY_STATE_IDLE;
     CRITICAL_SECTION_END( );
 
+    if( isBulkSessionTimeout == true )
+    {
+        BulkSessionStop( );
+    }
+
     switch( delayTimerState )
     {
         case FRAGMENTATION_TX_DELAY_STATE_START:
@@ -256,7 +328,7 @@ static void LmhpFragmentationProcess( void )
             break;
         case FRAGMENTATION_TX_DELAY_STATE_STOP:
             // Send the reply.
-            LmHandlerSend( &DelayedReplyAppData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+            LmHandlerEnqueue( &DelayedReplyAppData, &ReplyParams );
             break;
         case FRAGMENTATION_TX_DELAY_STATE_IDLE:
             // Intentional fall through
@@ -422,6 +494,10 @@ static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication
                 {
                     // Delete session
                     FragSessionData[id].FragGroupData.IsActive = false;
+                    if( LmhpFragmentationState.BulkSessionFragIndex == id )
+                    {
+                        BulkSessionStop( );
+                    }
                 }
                 LmhpFragmentationState.DataBuffer[dataBufferIndex++] = FRAGMENTATION_FRAG_SESSION_DELETE_ANS;
                 LmhpFragmentationState.DataBuffer[dataBufferIndex++] = status;
@@ -473,6 +549,10 @@ static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication
                     {
                         // Fragmentation successfully done
                         FragSessionData[fragIndex].FragDecoderPorcessStatus = FRAG_SESSION_NOT_STARTED;
+                        if( LmhpFragmentationState.BulkSessionFragIndex == fragIndex )
+                        {
+                            BulkSessionStop( );
+                        }
                         if( LmhpFragmentationParams->OnDone != NULL )
                         {
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
@@ -489,6 +569,76 @@ static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication
                 cmdIndex += FragSessionData[fragIndex].FragGroupData.FragSize;
                 break;
             }
+            case FRAGMENTATION_BULK_SESSION_SETUP_REQ:
+            {
+                if( mcpsIndication->Multicast == 1 )
+                {
+                    // Multicast channel. Don't process command.
+                    break;
+                }
+                MibRequestConfirm_t mibReq;
+                uint8_t status = 0x00;
+                uint8_t fragIndex = mcpsIndication->Buffer[cmdIndex++] & 0x03;
+                uint32_t frequency = 0;
+                uint32_t bitrate = 0;
+                uint8_t timeout = 0;
+
+                frequency =  ( mcpsIndication->Buffer[cmdIndex++] << 0  ) & 0x000000FF;
+                frequency |= ( mcpsIndication->Buffer[cmdIndex++] << 8  ) & 0x0000FF00;
+                frequency |= ( mcpsIndication->Buffer[cmdIndex++] << 16 ) & 0x00FF0000;
+                frequency *= FRAGMENTATION_BULK_FREQUENCY_UNIT;
+
+                bitrate =  ( mcpsIndication->Buffer[cmdIndex++] << 0 ) & 0x00FF;
+                bitrate |= ( mcpsIndication->Buffer[cmdIndex++] << 8 ) & 0xFF00;
+                bitrate *= FRAGMENTATION_BULK_BITRATE_UNIT;
+
+                // Session timeout = 2^SessionTimeout seconds
+                timeout = mcpsIndication->Buffer[cmdIndex++] & 0x0F;
+
+                status |= ( fragIndex << 6 ) & 0xC0;
+                if( ( bitrate < LORAMAC_BULK_RX_MIN_BITRATE ) || ( bitrate > LORAMAC_BULK_RX_MAX_BITRATE ) )
+                {
+                    status |= 0x01; // Bitrate not supported
+                }
+                if( ( fragIndex >= FRAGMENTATION_MAX_SESSIONS ) ||
+                    ( FragSessionData[fragIndex].FragDecoderPorcessStatus != FRAG_SESSION_ONGOING ) )
+                {
+                    status |= 0x04; // FragSession does not exist
+                }
+                mibReq.Type = MIB_DEVICE_CLASS;
+                LoRaMacMibGetRequestConfirm( &mibReq );
+                if( mibReq.Param.Class != CLASS_C )
+                {
+                    status |= 0x08; // Device not in class C
+                }
+
+                if( ( status & 0x0F ) == 0 )
+                {
+                    mibReq.Type = MIB_RXC_BULK_PARAMS;
+                    mibReq.Param.RxCBulkParams.Enabled = true;
+                    mibReq.Param.RxCBulkParams.Frequency = frequency;
+                    mibReq.Param.RxCBulkParams.Bitrate = bitrate;
+                    if( LoRaMacMibSetRequestConfirm( &mibReq ) != LORAMAC_STATUS_OK )
+                    {
+                        status |= 0x02; // Frequency not supported
+                    }
+                }
+
+                if( ( status & 0x0F ) == 0 )
+                {
+                    // The BulkSessionSetup is accepted. Class C reception
+                    // uses GFSK until the session ends or times out.
+                    LmhpFragmentationState.IsBulkSessionActive = true;
+                    LmhpFragmentationState.BulkSessionFragIndex = fragIndex;
+                    TimerStop( &BulkSessionTimer );
+                    TimerSetValue( &BulkSessionTimer, ( 1 << timeout ) * 1000 );
+                    TimerStart( &BulkSessionTimer );
+                }
+                LmhpFragmentationState.DataBuffer[dataBufferIndex++] = FRAGMENTATION_BULK_SESSION_SETUP_ANS;
+                LmhpFragmentationState.DataBuffer[dataBufferIndex++] = status;
+                isAnswerDelayed = false;
+                break;
+            }
             default:
             {
                 break;
@@ -523,7 +673,7 @@ static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication
         else
         {
             // Send the prepared answer
-            LmHandlerSend( &cmdReplyAppData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+            LmHandlerEnqueue( &cmdReplyAppData, &ReplyParams );
         }
     }
 }
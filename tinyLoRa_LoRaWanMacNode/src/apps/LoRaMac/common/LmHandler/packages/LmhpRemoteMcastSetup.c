@@ -177,6 +177,17 @@ static TimerEvent_t SessionStartTimer;
  */
 static TimerEvent_t SessionStopTimer;
 
+/*!
+ * Queue parameters of the package answers
+ */
+static const LmHandlerUplinkParams_t ReplyParams =
+{
+    .MsgType = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+    .Priority = LORAMAC_HANDLER_PRIORITY_HIGH,
+    .Deadline = 0,
+    .CoalescingKey = 0,
+};
+
 static LmhPackage_t LmhpRemoteMcastSetupPackage =
 {
     .Port = REMOTE_MCAST_SETUP_PORT,
@@ -422,7 +433,7 @@ static void LmhpRemoteMcastSetupOnMcpsIndication( McpsIndication_t *mcpsIndicati
             .BufferSize = dataBufferIndex,
             .Port = REMOTE_MCAST_SETUP_PORT
         };
-        LmHandlerSend( &appData, LORAMAC_HANDLER_UNCONFIRMED_MSG );
+        LmHandlerEnqueue( &appData, &ReplyParams );
 
         DBG( "ID          : %d\n", McSessionData[0].McGroupData.IdHeader.Fields.McGroupId );
         DBG( "McAddr      : %08lX\n", McSessionData[0].McGroupData.McAddr );
@@ -0,0 +1,304 @@
+#!/usr/bin/env python3
+##
+## Decodes the uplinks of the LmHandler aggregation stage and estimates the
+## airtime saved by the aggregation.
+##
+## Usage:
+##   lmh_aggregation.py decode <hex payload> [<hex payload> ...]
+##   lmh_aggregation.py simulate [--dr 0] [--records 3] [--period 10] \
+##                               [--latency 60] [--streams 1] [--duration 3600] \
+##                               [--duty-cycle 1] [--queue 4] [--depth 8] [--trace]
+##
+## An aggregated payload, received on LMH_AGGREGATION_PORT, is a sequence of
+## records [FPort 1 byte][Size 1 byte][Payload Size bytes].
+##
+## The simulation replays periodic records, on EU868 datarates, through the
+## LmHandler uplink queue, once with one uplink per record and once behind the
+## aggregation stage. The uplinks are limited by the band duty cycle with the
+## time credits of RegionCommon.c, so records are delayed in the queue and
+## dropped when the queue or the aggregation stage is full. It reports the
+## airtime, the records sent, dropped or left pending, and their delays.
+##
+
+import argparse
+import math
+import sys
+
+RECORD_HEADER_SIZE = 2
+
+# MHDR + FHDR without FOpts + FPort + MIC
+LORAWAN_OVERHEAD = 13
+
+# EU868 datarates: spreading factor, maximum application payload size
+EU868_DATARATES = [(12, 51), (11, 51), (10, 51), (9, 115), (8, 242), (7, 242)]
+
+# DUTY_CYCLE_TIME_PERIOD of RegionCommon.c, the largest time credits [s]
+DUTY_CYCLE_TIME_PERIOD = 1800.0
+
+# End of the RX2 window after the end of the uplink, the MAC is busy until then [s]
+RX2_END = 2.1
+
+
+def decode(payload):
+    """Returns the ( port, data ) records of an aggregated payload."""
+    records = []
+    index = 0
+    while index < len(payload):
+        if index + RECORD_HEADER_SIZE > len(payload):
+            raise ValueError("truncated record header at offset %d" % index)
+        port = payload[index]
+        size = payload[index + 1]
+        index += RECORD_HEADER_SIZE
+        if index + size > len(payload):
+            raise ValueError("truncated record at offset %d" % (index - RECORD_HEADER_SIZE))
+        records.append((port, payload[index:index + size]))
+        index += size
+    return records
+
+
+def time_on_air(sf, size, bandwidth=125000, coding_rate=1, preamble=8):
+    """LoRa time on air [s] of a PHY payload of size bytes, explicit header, CRC on."""
+    symbol = (1 << sf) / bandwidth
+    ldro = 1 if symbol > 0.016 else 0
+    symbols = 8 * size - 4 * sf + 28 + 16
+    payload_symbols = 8 + max(math.ceil(symbols / (4 * (sf - 2 * ldro))) * (coding_rate + 4), 0)
+    return (preamble + 4.25 + payload_symbols) * symbol
+
+
+class DutyCycleBand:
+    """Time credits of a band, as kept by RegionCommon.c for a joined device.
+
+    The credits grow with the elapsed time up to the observation period and
+    an uplink costs its time on air times the duty cycle divisor. The band is
+    ready when the credits exceed the cost.
+    """
+
+    def __init__(self, duty_cycle):
+        self.divisor = 100.0 / duty_cycle if duty_cycle > 0 else 0
+        self.credits = DUTY_CYCLE_TIME_PERIOD
+        self.update_time = 0.0
+
+    def update(self, t):
+        self.credits = min(self.credits + t - self.update_time, DUTY_CYCLE_TIME_PERIOD)
+        self.update_time = t
+
+    def ready_time(self, t, airtime):
+        """Returns the earliest time not before t the uplink is allowed."""
+        if self.divisor == 0:
+            return t
+        self.update(t)
+        cost = airtime * self.divisor
+        if self.credits > cost:
+            return t
+        return t + cost - self.credits + 0.001
+
+    def transmit(self, t, airtime):
+        if self.divisor > 0:
+            self.update(t)
+            self.credits -= airtime * self.divisor
+
+
+class Uplinks:
+    """Uplink queue of LmHandler in front of the MAC and the duty cycle."""
+
+    def __init__(self, args, sf):
+        self.sf = sf
+        self.queue_size = args.queue
+        self.band = DutyCycleBand(args.duty_cycle)
+        self.queue = []
+        self.mac_free = 0.0
+        self.frames = 0
+        self.airtime = 0.0
+        self.delays = []
+        self.dropped = []
+        self.trace = args.trace
+
+    def enqueue(self, t, records, size, aggregated=False):
+        """Queues a frame carrying the given record arrival times."""
+        if len(self.queue) >= self.queue_size:
+            # Same priority as the queued uplinks: the new uplink is refused
+            self.drop(t, records, "uplink queue full")
+            return False
+        self.queue.append((records, size, aggregated))
+        return True
+
+    def drop(self, t, records, reason):
+        for arrival in records:
+            self.dropped.append((arrival, t, reason))
+            if self.trace:
+                print("    %8.1f s record of %8.1f s dropped: %s" % (t, arrival, reason))
+
+    def next_send_time(self, t):
+        if not self.queue:
+            return None
+        _, size, _ = self.queue[0]
+        airtime = time_on_air(self.sf, LORAWAN_OVERHEAD + size)
+        return self.band.ready_time(max(t, self.mac_free), airtime)
+
+    def send(self, t):
+        records, size, aggregated = self.queue.pop(0)
+        airtime = time_on_air(self.sf, LORAWAN_OVERHEAD + size)
+        self.band.transmit(t, airtime)
+        self.mac_free = t + airtime + RX2_END
+        self.frames += 1
+        self.airtime += airtime
+        for arrival in records:
+            self.delays.append(t - arrival)
+        if self.trace:
+            print("    %8.1f s uplink of %3d bytes, %d record(s), oldest delayed %.1f s"
+                  % (t, size, len(records), t - records[0]))
+        return aggregated
+
+
+def run(args, sf, max_size, events, aggregate):
+    """Replays the records through the uplink queue, optionally behind the
+    aggregation stage, up to the simulated duration."""
+    uplinks = Uplinks(args, sf)
+    pending = []
+    aggregation_queued = False
+    index = 0
+
+    def pack():
+        size = 0
+        count = 0
+        for _, s in pending:
+            if size + RECORD_HEADER_SIZE + s > max_size:
+                break
+            size += RECORD_HEADER_SIZE + s
+            count += 1
+        if count <= 1:
+            return 1, pending[0][1]
+        return count, size
+
+    def stage(t):
+        """LmHandlerAggregationProcess, returns the next flush time."""
+        nonlocal aggregation_queued
+        if not pending or aggregation_queued:
+            return None
+        flush_time = min(a for a, _ in pending) + args.latency
+        if flush_time > t and sum(RECORD_HEADER_SIZE + s for _, s in pending) < max_size:
+            return flush_time
+        count, size = pack()
+        # The records are released even when the queue refuses the uplink
+        aggregation_queued = uplinks.enqueue(t, [a for a, _ in pending[:count]], size, True)
+        del pending[:count]
+        return stage(t) if pending and not aggregation_queued else None
+
+    flush_time = None
+    t = 0.0
+    while True:
+        candidates = []
+        if index < len(events):
+            candidates.append(events[index][0])
+        if flush_time is not None:
+            candidates.append(flush_time)
+        send_time = uplinks.next_send_time(t)
+        if send_time is not None:
+            candidates.append(send_time)
+        if not candidates:
+            break
+        t = min(candidates)
+        if t >= args.duration:
+            break
+        if send_time is not None and t == send_time:
+            if uplinks.send(t):
+                aggregation_queued = False
+            flush_time = stage(t) if aggregate else None
+            continue
+        if index < len(events) and t == events[index][0]:
+            size = events[index][1]
+            index += 1
+            if not aggregate:
+                uplinks.enqueue(t, [t], size)
+                continue
+            if len(pending) >= args.depth:
+                uplinks.drop(t, [t], "aggregation stage full")
+            else:
+                pending.append((t, size))
+        flush_time = stage(t) if aggregate else None
+
+    left = [a for records, _, _ in uplinks.queue for a in records] + [a for a, _ in pending]
+    return uplinks, len(left)
+
+
+def simulate(args):
+    sf, max_size = EU868_DATARATES[args.dr]
+    events = []
+    for stream in range(args.streams):
+        # Spread the streams over the period
+        offset = stream * args.period / args.streams
+        t = offset
+        while t < args.duration:
+            events.append((t, args.records))
+            t += args.period
+    events.sort()
+
+    print("DR%d SF%d, %d stream(s) of %d byte records every %g s, latency %g s, %g s"
+          % (args.dr, sf, args.streams, args.records, args.period, args.latency, args.duration))
+    if args.duty_cycle > 0:
+        print("%g %% duty cycle, uplink queue of %d, aggregation stage of %d records"
+              % (args.duty_cycle, args.queue, args.depth))
+    else:
+        print("no duty cycle, uplink queue of %d, aggregation stage of %d records" % (args.queue, args.depth))
+    print("                         uplinks  airtime [s]  records sent  dropped  left  delay avg / max [s]")
+
+    airtimes = []
+    for name, aggregate in (("one uplink per record", False), ("aggregated", True)):
+        if args.trace:
+            print("  %s:" % name)
+        uplinks, left = run(args, sf, max_size, events, aggregate)
+        delays = uplinks.delays
+        print("  %-21s %8d %12.3f %13d %8d %5d %10.1f / %.1f"
+              % (name, uplinks.frames, uplinks.airtime, len(delays), len(uplinks.dropped), left,
+                 sum(delays) / len(delays) if delays else 0.0, max(delays) if delays else 0.0))
+        reasons = {}
+        for _, _, reason in uplinks.dropped:
+            reasons[reason] = reasons.get(reason, 0) + 1
+        for reason, count in sorted(reasons.items()):
+            print("  %21s   %d records dropped: %s" % ("", count, reason))
+        airtimes.append((uplinks.airtime, len(delays)))
+
+    (plain_airtime, plain_sent), (aggregated_airtime, aggregated_sent) = airtimes
+    if plain_sent > 0 and aggregated_sent > 0:
+        print("  airtime per record saved: %5.1f %%"
+              % (100.0 * (1.0 - (aggregated_airtime / aggregated_sent) / (plain_airtime / plain_sent))))
+    return 0
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="LmHandler aggregation stage tool")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    decoder = commands.add_parser("decode", help="decode aggregated payloads")
+    decoder.add_argument("payloads", nargs="+", help="hexadecimal payloads")
+
+    simulator = commands.add_parser("simulate", help="estimate the airtime saved")
+    simulator.add_argument("--dr", type=int, default=0, choices=range(len(EU868_DATARATES)))
+    simulator.add_argument("--records", type=int, default=3, help="record size [bytes]")
+    simulator.add_argument("--period", type=float, default=10.0, help="record period [s]")
+    simulator.add_argument("--latency", type=float, default=60.0, help="record maximum latency [s]")
+    simulator.add_argument("--streams", type=int, default=1, help="number of record streams")
+    simulator.add_argument("--duration", type=float, default=3600.0, help="simulated time [s]")
+    simulator.add_argument("--duty-cycle", type=float, default=1.0,
+                           help="duty cycle of the band [%%], 0 disables it")
+    simulator.add_argument("--queue", type=int, default=4, help="LMH_UPLINK_QUEUE_SIZE")
+    simulator.add_argument("--depth", type=int, default=8, help="LMH_AGGREGATION_SIZE")
+    simulator.add_argument("--trace", action="store_true", help="print each uplink and dropped record")
+
+    args = parser.parse_args(argv[1:])
+    if args.command == "simulate":
+        return simulate(args)
+
+    for payload in args.payloads:
+        try:
+            records = decode(bytes.fromhex(payload))
+        except ValueError as error:
+            sys.stderr.write("%s: %s\n" % (payload, error))
+            return 1
+        for port, data in records:
+            print("port %3d size %3d: %s" % (port, len(data), data.hex()))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -47,6 +47,7 @@ const char* MacStatusStrings[] =
     "Duty-cycle restricted",         // LORAMAC_STATUS_DUTYCYCLE_RESTRICTED
     "No channel found",              // LORAMAC_STATUS_NO_CHANNEL_FOUND
     "No free channel found",         // LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND
+    "Channel sense pending",         // LORAMAC_STATUS_CHANNEL_SENSE_PENDING
     "Busy beacon reserved time",     // LORAMAC_STATUS_BUSY_BEACON_RESERVED_TIME
     "Busy ping-slot window time",    // LORAMAC_STATUS_BUSY_PING_SLOT_WINDOW_TIME
     "Busy uplink collision",         // LORAMAC_STATUS_BUSY_UPLINK_COLLISION
@@ -316,6 +317,7 @@ void DisplayTxUpdate( LmHandlerTxParams_t *params )
             case LORAMAC_REGION_KR920:
             case LORAMAC_REGION_EU433:
             case LORAMAC_REGION_RU864:
+            case LORAMAC_REGION_PRIV868:
             {
                 printf( "%04X ", mibGet.Param.ChannelsMask[0] );
                 break;
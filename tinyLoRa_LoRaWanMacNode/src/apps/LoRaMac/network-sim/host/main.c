@@ -0,0 +1,445 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Class A receive energy simulation on the host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs LoRaMac on the host board against the gateway and network
+ *            server of network-server.c. The ABP device sends an unconfirmed
+ *            uplink every UPLINK_PERIOD, the network server answers every
+ *            DOWNLINK_CYCLES cycle in RX1. The program argument is the
+ *            number of class A cycles [default NB_CYCLES].
+ *
+ *            The cycles alternately run the simulated radio:
+ *            early   RX windows closed when no preamble is detected within
+ *                    the symbol timeout ( SX126x RX timer stopped on
+ *                    preamble detection )
+ *            timeout RX windows held until the Radio.Rx timeout
+ *                    ( MaxRxWindow ), a RX1 window still listening then
+ *                    skips RX2
+ *            and the listen time of each cycle is read from
+ *            MIB_RX_WINDOW_STATS. The receive charge is the listen time
+ *            multiplied by RX_CURRENT.
+ *
+ *            Records:
+ *            CYCLE,cycle,mode,rx1_ms,rx2_ms,windows,extended,downlink
+ *            ENERGY,mode,cycles,listen_ms,charge_uC,charge_per_cycle_uC
+ *            DOWNLINKS,sent,received
+ *            SAVING,percent                Receive charge saved by early
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+#include "board.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "LoRaMac.h"
+#include "sim-radio.h"
+#include "host-board.h"
+#include "network-server.h"
+
+#ifndef ACTIVE_REGION
+
+#warning "No active region defined, LORAMAC_REGION_EU868 will be used as default."
+
+#define ACTIVE_REGION LORAMAC_REGION_EU868
+
+#endif
+
+/*!
+ * Default number of class A cycles
+ */
+#define NB_CYCLES                                   20
+
+/*!
+ * Uplink period [ms]
+ */
+#define UPLINK_PERIOD                               10000
+
+/*!
+ * Uplink datarate, ADR off
+ */
+#define UPLINK_DATARATE                             DR_5
+
+/*!
+ * Uplink port and size
+ */
+#define UPLINK_PORT                                 2
+#define UPLINK_SIZE                                 12
+
+/*!
+ * Period of the RX1 downlinks [cycles]
+ */
+#define DOWNLINK_CYCLES                             5
+
+/*!
+ * Downlink port and size
+ */
+#define DOWNLINK_PORT                               10
+#define DOWNLINK_SIZE                               8
+
+/*!
+ * Radio supply current in reception, SX1262 with DC-DC [uA]
+ */
+#define RX_CURRENT                                  4600
+
+/*!
+ * Distance between the gateway and the device [m]
+ */
+#define GATEWAY_DISTANCE                            100
+
+/*!
+ * ABP session
+ */
+#define DEVICE_ADDRESS                              0x260B1A2C
+
+static uint8_t NwkSKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+static uint8_t AppSKey[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+
+/*!
+ * RX windows handling of a cycle
+ */
+typedef enum
+{
+    RX_MODE_EARLY,
+    RX_MODE_TIMEOUT,
+    RX_MODE_MAX,
+}RxModes_t;
+
+static const char* const RxModeNames[RX_MODE_MAX] = { "early", "timeout" };
+
+/*!
+ * Listen time of the cycles of a mode
+ */
+typedef struct sRxModeStats
+{
+    uint32_t NbCycles;
+    uint32_t ListenTime;
+}RxModeStats_t;
+
+static RxModeStats_t RxModeStats[RX_MODE_MAX];
+
+static uint32_t NbCycles = NB_CYCLES;
+static uint32_t Cycle = 0;
+static RxModes_t CycleMode = RX_MODE_EARLY;
+static bool IsCycleRunning = false;
+static bool IsCycleDone = false;
+static bool IsDownlinkReceived = false;
+static uint32_t NbDownlinksReceived = 0;
+
+static volatile bool IsUplinkDue = false;
+static volatile bool IsMacProcessPending = false;
+
+static uint8_t UplinkBuffer[UPLINK_SIZE];
+
+static LoRaMacPrimitives_t MacPrimitives;
+static LoRaMacCallback_t MacCallbacks;
+
+/*!
+ * Timer starting the cycles
+ */
+static TimerEvent_t UplinkTimer;
+
+/*!
+ * \brief MCPS-Confirm primitive, end of the class A cycle
+ */
+static void McpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    IsCycleDone = true;
+}
+
+/*!
+ * \brief MCPS-Indication primitive
+ */
+static void McpsIndication( McpsIndication_t* mcpsIndication )
+{
+    if( ( mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK ) && ( mcpsIndication->RxData == true ) &&
+        ( mcpsIndication->Port == DOWNLINK_PORT ) && ( mcpsIndication->BufferSize == DOWNLINK_SIZE ) )
+    {
+        IsDownlinkReceived = true;
+        NbDownlinksReceived++;
+    }
+}
+
+/*!
+ * \brief MLME-Confirm primitive
+ */
+static void MlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+}
+
+/*!
+ * \brief MLME-Indication primitive
+ */
+static void MlmeIndication( MlmeIndication_t* mlmeIndication )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    IsMacProcessPending = true;
+}
+
+static void OnUplinkTimerEvent( void* context )
+{
+    IsUplinkDue = true;
+}
+
+/*!
+ * \brief Sets a MIB attribute, the simulation fails on error
+ */
+static void MibSet( MibRequestConfirm_t* mibReq )
+{
+    if( LoRaMacMibSetRequestConfirm( mibReq ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,mib %d\r\n", mibReq->Type );
+        exit( EXIT_FAILURE );
+    }
+}
+
+/*!
+ * \brief Activates the device by personalization
+ */
+static void DeviceActivate( void )
+{
+    MibRequestConfirm_t mibReq;
+    MlmeReq_t mlmeReq;
+
+    mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+    mibReq.Param.AbpLrWanVersion.Value = 0x01000400; // 1.0.4.0
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_NET_ID;
+    mibReq.Param.NetID = 0;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_DEV_ADDR;
+    mibReq.Param.DevAddr = DEVICE_ADDRESS;
+    MibSet( &mibReq );
+
+    // LoRaWAN 1.0.x: a single network session key
+    mibReq.Type = MIB_F_NWK_S_INT_KEY;
+    mibReq.Param.FNwkSIntKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_S_NWK_S_INT_KEY;
+    mibReq.Param.SNwkSIntKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_NWK_S_ENC_KEY;
+    mibReq.Param.NwkSEncKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_APP_S_KEY;
+    mibReq.Param.AppSKey = AppSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_PUBLIC_NETWORK;
+    mibReq.Param.EnablePublicNetwork = true;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_ADR;
+    mibReq.Param.AdrEnable = false;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_CHANNELS_DATARATE;
+    mibReq.Param.ChannelsDatarate = UPLINK_DATARATE;
+    MibSet( &mibReq );
+
+    LoRaMacStart( );
+
+    mlmeReq.Type = MLME_JOIN;
+    mlmeReq.Req.Join.NetworkActivation = ACTIVATION_TYPE_ABP;
+    mlmeReq.Req.Join.Datarate = UPLINK_DATARATE;
+    if( LoRaMacMlmeRequest( &mlmeReq ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,activation\r\n" );
+        exit( EXIT_FAILURE );
+    }
+}
+
+/*!
+ * \brief Starts a class A cycle: resets the windows statistics, selects the
+ *        RX windows handling and sends the uplink
+ */
+static void CycleStart( void )
+{
+    MibRequestConfirm_t mibReq;
+    McpsReq_t mcpsReq;
+    LoRaMacStatus_t status;
+
+    mibReq.Type = MIB_RX_WINDOW_STATS;
+    memset1( ( uint8_t* )&mibReq.Param.RxWindowStats, 0, sizeof( mibReq.Param.RxWindowStats ) );
+    MibSet( &mibReq );
+
+    CycleMode = ( ( Cycle & 1 ) == 0 ) ? RX_MODE_EARLY : RX_MODE_TIMEOUT;
+    SimRadioSetSymbolTimeoutEnabled( CycleMode == RX_MODE_EARLY );
+
+    if( ( ( Cycle + 1 ) % DOWNLINK_CYCLES ) == 0 )
+    {
+        uint8_t downlink[DOWNLINK_SIZE];
+
+        memset1( downlink, ( uint8_t )Cycle, sizeof( downlink ) );
+        NetworkServerQueueDownlink( NETWORK_SERVER_WINDOW_RX1, DOWNLINK_PORT, downlink, sizeof( downlink ) );
+    }
+
+    memset1( UplinkBuffer, ( uint8_t )Cycle, sizeof( UplinkBuffer ) );
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = UPLINK_PORT;
+    mcpsReq.Req.Unconfirmed.fBuffer = UplinkBuffer;
+    mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( UplinkBuffer );
+    mcpsReq.Req.Unconfirmed.Datarate = UPLINK_DATARATE;
+    status = LoRaMacMcpsRequest( &mcpsReq );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,uplink %d\r\n", status );
+        exit( EXIT_FAILURE );
+    }
+    IsDownlinkReceived = false;
+    IsCycleRunning = true;
+}
+
+/*!
+ * \brief Ends a class A cycle: records its windows listen time
+ */
+static void CycleEnd( void )
+{
+    MibRequestConfirm_t mibReq;
+    LoRaMacRxWindowStats_t* stats = &mibReq.Param.RxWindowStats;
+
+    mibReq.Type = MIB_RX_WINDOW_STATS;
+    LoRaMacMibGetRequestConfirm( &mibReq );
+
+    printf( "CYCLE,%lu,%s,%lu,%lu,%lu,%lu,%u\r\n", ( unsigned long )Cycle, RxModeNames[CycleMode],
+            ( unsigned long )stats->LastRx1ListenTime, ( unsigned long )stats->LastRx2ListenTime,
+            ( unsigned long )stats->NbWindows, ( unsigned long )stats->NbExtendedWindows, IsDownlinkReceived );
+
+    RxModeStats[CycleMode].NbCycles++;
+    RxModeStats[CycleMode].ListenTime += stats->TotalListenTime;
+    IsCycleRunning = false;
+    Cycle++;
+}
+
+/*!
+ * \brief Prints the receive energy of both modes and ends the simulation
+ */
+static void SimulationEnd( void )
+{
+    uint32_t charge[RX_MODE_MAX] = { 0 };
+
+    for( uint8_t mode = 0; mode < RX_MODE_MAX; mode++ )
+    {
+        const RxModeStats_t* stats = &RxModeStats[mode];
+
+        // [ms] x [uA] / 1000 = [uC]
+        charge[mode] = ( uint32_t )( ( ( uint64_t )stats->ListenTime * RX_CURRENT ) / 1000 );
+        printf( "ENERGY,%s,%lu,%lu,%lu,%lu\r\n", RxModeNames[mode], ( unsigned long )stats->NbCycles,
+                ( unsigned long )stats->ListenTime, ( unsigned long )charge[mode],
+                ( unsigned long )( ( stats->NbCycles != 0 ) ? ( charge[mode] / stats->NbCycles ) : 0 ) );
+    }
+    printf( "DOWNLINKS,%lu,%lu\r\n", ( unsigned long )NetworkServerGetNbDownlinks( ),
+            ( unsigned long )NbDownlinksReceived );
+
+    // Per cycle charges, both modes run the same number of cycles or one more
+    if( ( RxModeStats[RX_MODE_EARLY].NbCycles != 0 ) && ( RxModeStats[RX_MODE_TIMEOUT].NbCycles != 0 ) &&
+        ( charge[RX_MODE_TIMEOUT] != 0 ) )
+    {
+        uint64_t early = ( uint64_t )charge[RX_MODE_EARLY] * RxModeStats[RX_MODE_TIMEOUT].NbCycles;
+        uint64_t timeout = ( uint64_t )charge[RX_MODE_TIMEOUT] * RxModeStats[RX_MODE_EARLY].NbCycles;
+
+        printf( "SAVING,%lu\r\n", ( unsigned long )( 100 - ( ( early * 100 ) / timeout ) ) );
+    }
+    HostBoardSetEndTime( SimMediumGetTime( ) );
+}
+
+static void NetworkSimProcess( void )
+{
+    if( IsCycleDone == true )
+    {
+        IsCycleDone = false;
+        CycleEnd( );
+        if( Cycle >= NbCycles )
+        {
+            TimerStop( &UplinkTimer );
+            SimulationEnd( );
+        }
+    }
+    if( ( IsUplinkDue == true ) && ( IsCycleRunning == false ) && ( LoRaMacIsBusy( ) == false ) )
+    {
+        IsUplinkDue = false;
+        CycleStart( );
+        TimerSetValue( &UplinkTimer, UPLINK_PERIOD );
+        TimerStart( &UplinkTimer );
+    }
+}
+
+/**
+ * Main application entry point.
+ */
+int main( int argc, char* argv[] )
+{
+    NetworkServerParams_t networkServerParams =
+    {
+        .DevAddr = DEVICE_ADDRESS,
+        .NwkSKey = NwkSKey,
+        .AppSKey = AppSKey,
+        .Distance = GATEWAY_DISTANCE,
+    };
+
+    if( argc > 1 )
+    {
+        NbCycles = strtoul( argv[1], NULL, 10 );
+    }
+
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# NETWORK-SIM,host\r\n" );
+
+    NetworkServerInit( &networkServerParams );
+
+    MacPrimitives.MacMcpsConfirm = McpsConfirm;
+    MacPrimitives.MacMcpsIndication = McpsIndication;
+    MacPrimitives.MacMlmeConfirm = MlmeConfirm;
+    MacPrimitives.MacMlmeIndication = MlmeIndication;
+    MacCallbacks.GetBatteryLevel = BoardGetBatteryLevel;
+    MacCallbacks.MacProcessNotify = OnMacProcessNotify;
+    if( LoRaMacInitialization( &MacPrimitives, &MacCallbacks, ACTIVE_REGION ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,initialization\r\n" );
+        return EXIT_FAILURE;
+    }
+    DeviceActivate( );
+
+    TimerInit( &UplinkTimer, OnUplinkTimerEvent );
+    TimerSetValue( &UplinkTimer, UPLINK_PERIOD );
+    TimerStart( &UplinkTimer );
+
+    while( 1 )
+    {
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+
+        LoRaMacProcess( );
+
+        NetworkSimProcess( );
+
+        CRITICAL_SECTION_BEGIN( );
+        if( IsMacProcessPending == true )
+        {
+            // Clear flag and prevent MCU to go into low power modes.
+            IsMacProcessPending = false;
+        }
+        else
+        {
+            // The MCU wakes up through events
+            BoardLowPowerHandler( );
+        }
+        CRITICAL_SECTION_END( );
+    }
+}
@@ -0,0 +1,345 @@
+/*!
+ * \file      network-server.c
+ *
+ * \brief     Simulated gateway and network server of the network-sim project
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "radio.h"
+#include "aes.h"
+#include "cmac.h"
+#include "sim-medium.h"
+#include "network-server.h"
+
+/*!
+ * Delay between the uplink end and the RX1 window [us]
+ */
+#define NETWORK_SERVER_RECEIVE_DELAY1               1000000
+
+/*!
+ * Gateway transmission power [dBm]
+ */
+#define NETWORK_SERVER_TX_POWER                     14
+
+/*!
+ * LoRaWAN frame fields
+ */
+#define NETWORK_SERVER_MHDR_UNCONFIRMED_UP          0x40
+#define NETWORK_SERVER_MHDR_CONFIRMED_UP            0x80
+#define NETWORK_SERVER_MHDR_UNCONFIRMED_DOWN        0x60
+#define NETWORK_SERVER_FHDR_SIZE                    7
+#define NETWORK_SERVER_MIC_SIZE                     4
+#define NETWORK_SERVER_PREAMBLE_LENGTH              8
+#define NETWORK_SERVER_PUBLIC_SYNCWORD              0x34
+
+/*!
+ * Downlink queued for the next uplink, then scheduled
+ */
+typedef struct sNetworkServerDownlink
+{
+    NetworkServerWindow_t Window;
+    uint8_t Port;
+    uint8_t Payload[NETWORK_SERVER_MAX_PAYLOAD];
+    uint8_t Size;
+    /*!
+     * Set once the frame is built, sent at TxTime
+     */
+    bool IsScheduled;
+    SimTime_t TxTime;
+    SimModulation_t TxModulation;
+    uint8_t TxFrame[NETWORK_SERVER_FHDR_SIZE + 1 + NETWORK_SERVER_MAX_PAYLOAD + NETWORK_SERVER_MIC_SIZE];
+    uint8_t TxSize;
+}NetworkServerDownlink_t;
+
+/*!
+ * Gateway and network server context
+ */
+static struct
+{
+    SimNode_t Node;
+    NetworkServerParams_t Params;
+    uint32_t FCntUp;
+    uint32_t FCntDown;
+    uint32_t NbUplinks;
+    uint32_t NbDownlinks;
+    NetworkServerDownlink_t Downlinks[NETWORK_SERVER_MAX_DOWNLINKS];
+    uint8_t NbDownlinksQueued;
+}NetworkServer;
+
+/*!
+ * \brief Writes a 32 bits value LSB first
+ */
+static void NetworkServerWrite32( uint8_t* buffer, uint32_t value )
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = ( value >> 8 ) & 0xFF;
+    buffer[2] = ( value >> 16 ) & 0xFF;
+    buffer[3] = ( value >> 24 ) & 0xFF;
+}
+
+/*!
+ * \brief Computes the MIC of a frame
+ *
+ * \param [IN] frame  Frame without MIC
+ * \param [IN] size   Frame size
+ * \param [IN] dir    Direction [0: uplink, 1: downlink]
+ * \param [IN] fCnt   32 bits frame counter
+ * \param [OUT] mic   Frame MIC
+ */
+static void NetworkServerComputeMic( const uint8_t* frame, uint8_t size, uint8_t dir, uint32_t fCnt,
+                                     uint8_t mic[NETWORK_SERVER_MIC_SIZE] )
+{
+    AES_CMAC_CTX ctx;
+    uint8_t b0[16] = { 0x49 };
+    uint8_t cmac[AES_CMAC_DIGEST_LENGTH];
+
+    b0[5] = dir;
+    NetworkServerWrite32( &b0[6], NetworkServer.Params.DevAddr );
+    NetworkServerWrite32( &b0[10], fCnt );
+    b0[15] = size;
+
+    AES_CMAC_Init( &ctx );
+    AES_CMAC_SetKey( &ctx, NetworkServer.Params.NwkSKey );
+    AES_CMAC_Update( &ctx, b0, sizeof( b0 ) );
+    AES_CMAC_Update( &ctx, frame, size );
+    AES_CMAC_Final( cmac, &ctx );
+    memcpy( mic, cmac, NETWORK_SERVER_MIC_SIZE );
+}
+
+/*!
+ * \brief Encrypts a downlink FRMPayload in place with the AppSKey
+ */
+static void NetworkServerEncrypt( uint8_t* payload, uint8_t size, uint32_t fCnt )
+{
+    aes_context ctx;
+    uint8_t a[16] = { 0x01 };
+    uint8_t s[16];
+
+    a[5] = 1;
+    NetworkServerWrite32( &a[6], NetworkServer.Params.DevAddr );
+    NetworkServerWrite32( &a[10], fCnt );
+    aes_set_key( NetworkServer.Params.AppSKey, 16, &ctx );
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        if( ( i & 15 ) == 0 )
+        {
+            a[15] = ( i >> 4 ) + 1;
+            aes_encrypt( a, s, &ctx );
+        }
+        payload[i] ^= s[i & 15];
+    }
+}
+
+/*!
+ * \brief Builds a queued downlink
+ */
+static void NetworkServerBuildDownlink( NetworkServerDownlink_t* downlink )
+{
+    uint8_t* frame = downlink->TxFrame;
+    uint8_t size = 0;
+
+    frame[size++] = NETWORK_SERVER_MHDR_UNCONFIRMED_DOWN;
+    NetworkServerWrite32( &frame[size], NetworkServer.Params.DevAddr );
+    size += 4;
+    frame[size++] = 0; // FCtrl, no FOpts
+    frame[size++] = NetworkServer.FCntDown & 0xFF;
+    frame[size++] = ( NetworkServer.FCntDown >> 8 ) & 0xFF;
+    frame[size++] = downlink->Port;
+    memcpy( &frame[size], downlink->Payload, downlink->Size );
+    NetworkServerEncrypt( &frame[size], downlink->Size, NetworkServer.FCntDown );
+    size += downlink->Size;
+    NetworkServerComputeMic( frame, size, 1, NetworkServer.FCntDown, &frame[size] );
+    downlink->TxSize = size + NETWORK_SERVER_MIC_SIZE;
+
+    NetworkServer.FCntDown++;
+}
+
+/*!
+ * \brief Starts the gateway timer on the next scheduled downlink
+ */
+static void NetworkServerStartTimer( void )
+{
+    SimTime_t next = SIM_TIME_NEVER;
+
+    for( uint8_t i = 0; i < NetworkServer.NbDownlinksQueued; i++ )
+    {
+        if( ( NetworkServer.Downlinks[i].IsScheduled == true ) && ( NetworkServer.Downlinks[i].TxTime < next ) )
+        {
+            next = NetworkServer.Downlinks[i].TxTime;
+        }
+    }
+    if( next != SIM_TIME_NEVER )
+    {
+        SimMediumSetTimer( &NetworkServer.Node, next );
+    }
+}
+
+/*!
+ * \brief Gateway medium callback: checks the uplink and schedules the
+ *        queued downlinks in their windows
+ */
+static void NetworkServerOnRxDone( SimNode_t* node, const uint8_t* payload, uint8_t size, const SimRxInfo_t* info )
+{
+    uint8_t mic[NETWORK_SERVER_MIC_SIZE];
+    uint32_t devAddr;
+    uint32_t fCnt;
+
+    if( ( size < ( NETWORK_SERVER_FHDR_SIZE + 1 + NETWORK_SERVER_MIC_SIZE ) ) ||
+        ( ( payload[0] != NETWORK_SERVER_MHDR_UNCONFIRMED_UP ) && ( payload[0] != NETWORK_SERVER_MHDR_CONFIRMED_UP ) ) )
+    {
+        return;
+    }
+    devAddr = ( uint32_t )payload[1] | ( ( uint32_t )payload[2] << 8 ) | ( ( uint32_t )payload[3] << 16 ) |
+              ( ( uint32_t )payload[4] << 24 );
+    if( devAddr != NetworkServer.Params.DevAddr )
+    {
+        return;
+    }
+
+    // 32 bits counter from its 16 LSBs, the repetitions of an uplink keep its counter
+    fCnt = ( NetworkServer.FCntUp & 0xFFFF0000 ) | payload[6] | ( ( uint32_t )payload[7] << 8 );
+    if( ( fCnt + 1 ) < NetworkServer.FCntUp )
+    {
+        fCnt += 0x10000;
+    }
+    NetworkServerComputeMic( payload, size - NETWORK_SERVER_MIC_SIZE, 0, fCnt, mic );
+    if( memcmp( mic, &payload[size - NETWORK_SERVER_MIC_SIZE], NETWORK_SERVER_MIC_SIZE ) != 0 )
+    {
+        printf( "ERR,uplink mic,%lu\r\n", ( unsigned long )fCnt );
+        return;
+    }
+    if( ( fCnt + 1 ) == NetworkServer.FCntUp )
+    {
+        // Repetition, already received
+        return;
+    }
+    NetworkServer.FCntUp = fCnt + 1;
+    NetworkServer.NbUplinks++;
+
+    for( uint8_t i = 0; i < NetworkServer.NbDownlinksQueued; i++ )
+    {
+        NetworkServerDownlink_t* downlink = &NetworkServer.Downlinks[i];
+
+        if( downlink->IsScheduled == true )
+        {
+            continue;
+        }
+        NetworkServerBuildDownlink( downlink );
+        downlink->TxModulation = info->Modulation;
+        if( downlink->Window == NETWORK_SERVER_WINDOW_RX1 )
+        {
+            // Uplink channel and datarate
+            downlink->TxTime = info->EndTime + NETWORK_SERVER_RECEIVE_DELAY1;
+        }
+        else
+        {
+            downlink->TxModulation.Frequency = NetworkServer.Params.RxCFrequency;
+            downlink->TxModulation.Datarate = NetworkServer.Params.RxCSpreadingFactor;
+            downlink->TxModulation.Bandwidth = 125000;
+            downlink->TxTime = info->EndTime + ( ( SimTime_t )NETWORK_SERVER_RXC_DELAY * 1000 );
+        }
+        downlink->TxModulation.IqInverted = true;
+        downlink->TxModulation.SyncWord = NETWORK_SERVER_PUBLIC_SYNCWORD;
+        downlink->IsScheduled = true;
+    }
+    NetworkServerStartTimer( );
+}
+
+/*!
+ * \brief Sends a scheduled downlink
+ */
+static void NetworkServerSend( const NetworkServerDownlink_t* downlink )
+{
+    const SimModulation_t* modulation = &downlink->TxModulation;
+    uint32_t bandwidth = ( modulation->Bandwidth == 500000 ) ? 2 : ( ( modulation->Bandwidth == 250000 ) ? 1 : 0 );
+    uint32_t timeOnAir = Radio.TimeOnAir( MODEM_LORA, bandwidth, modulation->Datarate, 1, NETWORK_SERVER_PREAMBLE_LENGTH,
+                                          false, downlink->TxSize, false );
+    // Preamble plus the 4.25 symbols of the hardware
+    SimTime_t preambleTime = ( ( ( SimTime_t )NETWORK_SERVER_PREAMBLE_LENGTH * 4 + 17 ) *
+                               ( 1000000ULL << modulation->Datarate ) ) / ( 4 * modulation->Bandwidth );
+
+    if( SimMediumSend( &NetworkServer.Node, modulation, NETWORK_SERVER_TX_POWER, SimMediumGetTime( ), preambleTime,
+                       ( SimTime_t )timeOnAir * 1000, downlink->TxFrame, downlink->TxSize ) == true )
+    {
+        NetworkServer.NbDownlinks++;
+    }
+}
+
+/*!
+ * \brief Gateway medium callback: sends the downlinks due and removes them
+ *        from the queue
+ */
+static void NetworkServerOnTimer( SimNode_t* node )
+{
+    uint8_t nbKept = 0;
+
+    for( uint8_t i = 0; i < NetworkServer.NbDownlinksQueued; i++ )
+    {
+        NetworkServerDownlink_t* downlink = &NetworkServer.Downlinks[i];
+
+        if( ( downlink->IsScheduled == true ) && ( downlink->TxTime <= SimMediumGetTime( ) ) )
+        {
+            NetworkServerSend( downlink );
+        }
+        else
+        {
+            if( nbKept != i )
+            {
+                NetworkServer.Downlinks[nbKept] = *downlink;
+            }
+            nbKept++;
+        }
+    }
+    NetworkServer.NbDownlinksQueued = nbKept;
+    NetworkServerStartTimer( );
+}
+
+void NetworkServerInit( const NetworkServerParams_t* params )
+{
+    SimModulation_t modulation = { 0 };
+
+    memset( &NetworkServer, 0, sizeof( NetworkServer ) );
+    NetworkServer.Params = *params;
+
+    NetworkServer.Node.X = params->Distance;
+    NetworkServer.Node.IsGateway = true;
+    NetworkServer.Node.RxDone = NetworkServerOnRxDone;
+    NetworkServer.Node.Timer = NetworkServerOnTimer;
+    SimMediumAddNode( &NetworkServer.Node );
+
+    // A gateway only checks the sync word
+    modulation.Modem = MODEM_LORA;
+    modulation.SyncWord = NETWORK_SERVER_PUBLIC_SYNCWORD;
+    SimMediumStartRx( &NetworkServer.Node, &modulation );
+}
+
+bool NetworkServerQueueDownlink( NetworkServerWindow_t window, uint8_t fPort, const uint8_t* payload, uint8_t size )
+{
+    NetworkServerDownlink_t* downlink = &NetworkServer.Downlinks[NetworkServer.NbDownlinksQueued];
+
+    if( ( fPort == 0 ) || ( fPort > 223 ) || ( size > NETWORK_SERVER_MAX_PAYLOAD ) ||
+        ( NetworkServer.NbDownlinksQueued >= NETWORK_SERVER_MAX_DOWNLINKS ) )
+    {
+        return false;
+    }
+    downlink->Window = window;
+    downlink->Port = fPort;
+    memcpy( downlink->Payload, payload, size );
+    downlink->Size = size;
+    downlink->IsScheduled = false;
+    NetworkServer.NbDownlinksQueued++;
+    return true;
+}
+
+uint32_t NetworkServerGetNbUplinks( void )
+{
+    return NetworkServer.NbUplinks;
+}
+
+uint32_t NetworkServerGetNbDownlinks( void )
+{
+    return NetworkServer.NbDownlinks;
+}
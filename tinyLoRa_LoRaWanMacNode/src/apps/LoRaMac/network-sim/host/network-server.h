@@ -0,0 +1,123 @@
+/*!
+ * \file      network-server.h
+ *
+ * \brief     Simulated gateway and network server of the network-sim project
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The gateway node receives the LoRaWAN 1.0.x uplinks of a single
+ *            ABP end-device on every channel and spreading factor of the
+ *            public network. The network server checks their MIC and sends
+ *            the downlinks queued for the next uplink:
+ *            RX1 window  Uplink channel and datarate, RECEIVE_DELAY1 after
+ *                        the uplink end
+ *            RxC window  Class C channel, NETWORK_SERVER_RXC_DELAY after the
+ *                        uplink end, before the RX1 window
+ *            The downlinks are unconfirmed data frames, FRMPayload encrypted
+ *            with the AppSKey and MIC computed with the NwkSKey, numbered in
+ *            the queuing order.
+ */
+#ifndef __NETWORK_SERVER_H__
+#define __NETWORK_SERVER_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * Maximum FRMPayload size of a downlink
+ */
+#define NETWORK_SERVER_MAX_PAYLOAD                  51
+
+/*!
+ * Maximum number of downlinks queued for an uplink
+ */
+#define NETWORK_SERVER_MAX_DOWNLINKS                2
+
+/*!
+ * Delay between the uplink end and a class C downlink [ms]
+ */
+#define NETWORK_SERVER_RXC_DELAY                    100
+
+/*!
+ * Downlink window
+ */
+typedef enum eNetworkServerWindow
+{
+    NETWORK_SERVER_WINDOW_RX1,
+    NETWORK_SERVER_WINDOW_RXC,
+}NetworkServerWindow_t;
+
+/*!
+ * End-device session of the network server
+ */
+typedef struct sNetworkServerParams
+{
+    /*!
+     * End-device address
+     */
+    uint32_t DevAddr;
+    /*!
+     * Network session key ( LoRaWAN 1.0.x )
+     */
+    const uint8_t* NwkSKey;
+    /*!
+     * Application session key
+     */
+    const uint8_t* AppSKey;
+    /*!
+     * Distance between the gateway and the end-device [m]
+     */
+    int32_t Distance;
+    /*!
+     * Class C window frequency [Hz]
+     */
+    uint32_t RxCFrequency;
+    /*!
+     * Class C window spreading factor, 125 kHz bandwidth
+     */
+    uint8_t RxCSpreadingFactor;
+}NetworkServerParams_t;
+
+/*!
+ * \brief Adds the gateway node to the medium and starts its reception
+ *
+ * \param [IN] params End-device session, copied
+ */
+void NetworkServerInit( const NetworkServerParams_t* params );
+
+/*!
+ * \brief Queues a downlink for a window of the next uplink
+ *
+ * \param [IN] window  Downlink window
+ * \param [IN] fPort   Frame port [1..223]
+ * \param [IN] payload Frame payload
+ * \param [IN] size    Frame payload size [0..NETWORK_SERVER_MAX_PAYLOAD]
+ *
+ * \retval status [true: queued, false: invalid parameters or queue full]
+ */
+bool NetworkServerQueueDownlink( NetworkServerWindow_t window, uint8_t fPort, const uint8_t* payload, uint8_t size );
+
+/*!
+ * \brief Gets the number of uplinks received with a valid MIC
+ *
+ * \retval count Uplinks received
+ */
+uint32_t NetworkServerGetNbUplinks( void );
+
+/*!
+ * \brief Gets the number of downlinks sent
+ *
+ * \retval count Downlinks sent
+ */
+uint32_t NetworkServerGetNbDownlinks( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __NETWORK_SERVER_H__
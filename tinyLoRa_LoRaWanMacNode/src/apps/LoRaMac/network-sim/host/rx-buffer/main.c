@@ -0,0 +1,473 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     LoRaMac receive buffer test on the host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs a class C ABP device against the network server of
+ *            network-server.c. For each uplink the network server sends a
+ *            downlink in the class C window, NETWORK_SERVER_RXC_DELAY after
+ *            the uplink end, then a downlink in RX1. The application holds
+ *            the class C indication for HOLD_TIME, the RX1 window is opened
+ *            meanwhile and receives the second downlink. The program
+ *            argument is the number of uplinks [default NB_UPLINKS].
+ *
+ *            The memcpy1 calls are logged ( linked with --wrap=memcpy1 ).
+ *            At each indication the copies reading or writing the received
+ *            frame since the previous indication are counted, the radio
+ *            read of the frame is not a memcpy1 call.
+ *
+ *            Records:
+ *            COPIES,fcnt,slot,count,bytes  memcpy1 calls on the frame
+ *            HOLD,fcnt,intact|overwritten  Class C payload after HOLD_TIME
+ *            DOWNLINKS,sent,received
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+#include "board.h"
+#include "sx-delay.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "LoRaMac.h"
+#include "host-board.h"
+#include "network-server.h"
+
+#ifndef ACTIVE_REGION
+
+#warning "No active region defined, LORAMAC_REGION_EU868 will be used as default."
+
+#define ACTIVE_REGION LORAMAC_REGION_EU868
+
+#endif
+
+/*!
+ * Default number of uplinks
+ */
+#define NB_UPLINKS                                  2
+
+/*!
+ * Uplink period [ms]
+ */
+#define UPLINK_PERIOD                               10000
+
+/*!
+ * Uplink datarate, ADR off
+ */
+#define UPLINK_DATARATE                             DR_5
+
+/*!
+ * Uplink port and size
+ */
+#define UPLINK_PORT                                 2
+#define UPLINK_SIZE                                 12
+
+/*!
+ * Downlink port and size
+ */
+#define DOWNLINK_PORT                               10
+#define DOWNLINK_SIZE                               8
+
+/*!
+ * Class C and RX2 window channel
+ */
+#define RXC_FREQUENCY                               869525000
+#define RXC_DATARATE                                DR_5
+#define RXC_SPREADING_FACTOR                        7
+
+/*!
+ * Time the class C indication is held [ms], past the RX1 downlink
+ */
+#define HOLD_TIME                                   1500
+
+/*!
+ * Frame header before FRMPayload, without FOpts: MHDR, DevAddr, FCtrl, FCnt
+ * and FPort
+ */
+#define FRAME_HEADER_SIZE                           9
+#define FRAME_MIC_SIZE                              4
+
+/*!
+ * Distance between the gateway and the device [m]
+ */
+#define GATEWAY_DISTANCE                            100
+
+/*!
+ * ABP session
+ */
+#define DEVICE_ADDRESS                              0x260B1A2C
+
+static uint8_t NwkSKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+static uint8_t AppSKey[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+
+/*!
+ * memcpy1 calls since the last indication
+ */
+#define COPY_LOG_SIZE                               64
+
+typedef struct sCopyLogEntry
+{
+    uint8_t* Dst;
+    const uint8_t* Src;
+    uint16_t Size;
+}CopyLogEntry_t;
+
+static CopyLogEntry_t CopyLog[COPY_LOG_SIZE];
+static uint32_t CopyLogCount = 0;
+
+static uint32_t NbUplinks = NB_UPLINKS;
+static uint32_t Uplink = 0;
+static bool IsUplinkRunning = false;
+static bool IsUplinkDone = false;
+static uint32_t NbDownlinksReceived = 0;
+
+static volatile bool IsUplinkDue = false;
+static volatile bool IsMacProcessPending = false;
+
+static uint8_t UplinkBuffer[UPLINK_SIZE];
+
+static LoRaMacPrimitives_t MacPrimitives;
+static LoRaMacCallback_t MacCallbacks;
+
+/*!
+ * Timer starting the uplinks
+ */
+static TimerEvent_t UplinkTimer;
+
+void __real_memcpy1( uint8_t *dst, const uint8_t *src, uint16_t size );
+
+/*!
+ * \brief Logs the memcpy1 calls of the MAC
+ */
+void __wrap_memcpy1( uint8_t *dst, const uint8_t *src, uint16_t size )
+{
+    if( CopyLogCount < COPY_LOG_SIZE )
+    {
+        CopyLog[CopyLogCount].Dst = dst;
+        CopyLog[CopyLogCount].Src = src;
+        CopyLog[CopyLogCount].Size = size;
+    }
+    CopyLogCount++;
+    __real_memcpy1( dst, src, size );
+}
+
+/*!
+ * \brief Checks if a memory range overlaps the frame, empty ranges do not
+ */
+static bool IsInFrame( const uint8_t* start, uint16_t size, const uint8_t* frame, uint16_t frameSize )
+{
+    return ( size != 0 ) && ( start < ( frame + frameSize ) ) && ( frame < ( start + size ) );
+}
+
+/*!
+ * \brief Counts the logged copies reading or writing the frame
+ */
+static void CopiesPrint( const McpsIndication_t* mcpsIndication )
+{
+    const uint8_t* frame = mcpsIndication->Buffer - FRAME_HEADER_SIZE;
+    uint16_t frameSize = FRAME_HEADER_SIZE + mcpsIndication->BufferSize + FRAME_MIC_SIZE;
+    uint32_t count = 0;
+    uint32_t bytes = 0;
+
+    if( CopyLogCount > COPY_LOG_SIZE )
+    {
+        printf( "ERR,copy log full,%lu\r\n", ( unsigned long )CopyLogCount );
+        exit( EXIT_FAILURE );
+    }
+    for( uint32_t i = 0; i < CopyLogCount; i++ )
+    {
+        if( ( IsInFrame( CopyLog[i].Src, CopyLog[i].Size, frame, frameSize ) == true ) ||
+            ( IsInFrame( CopyLog[i].Dst, CopyLog[i].Size, frame, frameSize ) == true ) )
+        {
+            count++;
+            bytes += CopyLog[i].Size;
+        }
+    }
+    printf( "COPIES,%lu,%u,%lu,%lu\r\n", ( unsigned long )mcpsIndication->DownLinkCounter, mcpsIndication->RxSlot,
+            ( unsigned long )count, ( unsigned long )bytes );
+}
+
+/*!
+ * \brief MCPS-Confirm primitive, end of the uplink
+ */
+static void McpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    IsUplinkDone = true;
+}
+
+/*!
+ * \brief MCPS-Indication primitive
+ */
+static void McpsIndication( McpsIndication_t* mcpsIndication )
+{
+    uint8_t expected[DOWNLINK_SIZE];
+    uint8_t held[DOWNLINK_SIZE];
+
+    if( ( mcpsIndication->Status != LORAMAC_EVENT_INFO_STATUS_OK ) || ( mcpsIndication->RxData == false ) )
+    {
+        return;
+    }
+    if( ( mcpsIndication->Port != DOWNLINK_PORT ) || ( mcpsIndication->BufferSize != DOWNLINK_SIZE ) )
+    {
+        printf( "ERR,downlink,%lu\r\n", ( unsigned long )mcpsIndication->DownLinkCounter );
+        exit( EXIT_FAILURE );
+    }
+    NbDownlinksReceived++;
+
+    CopiesPrint( mcpsIndication );
+
+    // The network server numbers the downlinks in the queuing order
+    memset( expected, ( uint8_t )mcpsIndication->DownLinkCounter, sizeof( expected ) );
+    if( memcmp( mcpsIndication->Buffer, expected, sizeof( expected ) ) != 0 )
+    {
+        printf( "ERR,payload,%lu\r\n", ( unsigned long )mcpsIndication->DownLinkCounter );
+        exit( EXIT_FAILURE );
+    }
+
+    if( mcpsIndication->RxSlot == RX_SLOT_WIN_CLASS_C )
+    {
+        // The application is still reading when the RX1 downlink is received
+        memcpy( held, mcpsIndication->Buffer, sizeof( held ) );
+        DelayMs( HOLD_TIME );
+        printf( "HOLD,%lu,%s\r\n", ( unsigned long )mcpsIndication->DownLinkCounter,
+                ( memcmp( mcpsIndication->Buffer, held, sizeof( held ) ) == 0 ) ? "intact" : "overwritten" );
+    }
+    CopyLogCount = 0;
+}
+
+/*!
+ * \brief MLME-Confirm primitive
+ */
+static void MlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+}
+
+/*!
+ * \brief MLME-Indication primitive
+ */
+static void MlmeIndication( MlmeIndication_t* mlmeIndication )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    IsMacProcessPending = true;
+}
+
+static void OnUplinkTimerEvent( void* context )
+{
+    IsUplinkDue = true;
+}
+
+/*!
+ * \brief Sets a MIB attribute, the test fails on error
+ */
+static void MibSet( MibRequestConfirm_t* mibReq )
+{
+    if( LoRaMacMibSetRequestConfirm( mibReq ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,mib %d\r\n", mibReq->Type );
+        exit( EXIT_FAILURE );
+    }
+}
+
+/*!
+ * \brief Activates the device by personalization and switches it to class C
+ */
+static void DeviceActivate( void )
+{
+    MibRequestConfirm_t mibReq;
+    MlmeReq_t mlmeReq;
+
+    mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+    mibReq.Param.AbpLrWanVersion.Value = 0x01000400; // 1.0.4.0
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_NET_ID;
+    mibReq.Param.NetID = 0;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_DEV_ADDR;
+    mibReq.Param.DevAddr = DEVICE_ADDRESS;
+    MibSet( &mibReq );
+
+    // LoRaWAN 1.0.x: a single network session key
+    mibReq.Type = MIB_F_NWK_S_INT_KEY;
+    mibReq.Param.FNwkSIntKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_S_NWK_S_INT_KEY;
+    mibReq.Param.SNwkSIntKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_NWK_S_ENC_KEY;
+    mibReq.Param.NwkSEncKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_APP_S_KEY;
+    mibReq.Param.AppSKey = AppSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_PUBLIC_NETWORK;
+    mibReq.Param.EnablePublicNetwork = true;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_ADR;
+    mibReq.Param.AdrEnable = false;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_CHANNELS_DATARATE;
+    mibReq.Param.ChannelsDatarate = UPLINK_DATARATE;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_RX2_CHANNEL;
+    mibReq.Param.Rx2Channel = ( RxChannelParams_t ){ RXC_FREQUENCY, RXC_DATARATE };
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_RXC_CHANNEL;
+    mibReq.Param.RxCChannel = ( RxChannelParams_t ){ RXC_FREQUENCY, RXC_DATARATE };
+    MibSet( &mibReq );
+
+    LoRaMacStart( );
+
+    mlmeReq.Type = MLME_JOIN;
+    mlmeReq.Req.Join.NetworkActivation = ACTIVATION_TYPE_ABP;
+    mlmeReq.Req.Join.Datarate = UPLINK_DATARATE;
+    if( LoRaMacMlmeRequest( &mlmeReq ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,activation\r\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    mibReq.Type = MIB_DEVICE_CLASS;
+    mibReq.Param.Class = CLASS_C;
+    MibSet( &mibReq );
+}
+
+/*!
+ * \brief Queues the class C and RX1 downlinks and sends the uplink
+ */
+static void UplinkStart( void )
+{
+    uint8_t downlink[DOWNLINK_SIZE];
+    McpsReq_t mcpsReq;
+    LoRaMacStatus_t status;
+
+    // Payloads filled with their downlink counter
+    memset( downlink, ( uint8_t )( Uplink * 2 ), sizeof( downlink ) );
+    NetworkServerQueueDownlink( NETWORK_SERVER_WINDOW_RXC, DOWNLINK_PORT, downlink, sizeof( downlink ) );
+    memset( downlink, ( uint8_t )( Uplink * 2 + 1 ), sizeof( downlink ) );
+    NetworkServerQueueDownlink( NETWORK_SERVER_WINDOW_RX1, DOWNLINK_PORT, downlink, sizeof( downlink ) );
+
+    memset1( UplinkBuffer, ( uint8_t )Uplink, sizeof( UplinkBuffer ) );
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = UPLINK_PORT;
+    mcpsReq.Req.Unconfirmed.fBuffer = UplinkBuffer;
+    mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( UplinkBuffer );
+    mcpsReq.Req.Unconfirmed.Datarate = UPLINK_DATARATE;
+    CopyLogCount = 0;
+    status = LoRaMacMcpsRequest( &mcpsReq );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,uplink %d\r\n", status );
+        exit( EXIT_FAILURE );
+    }
+    IsUplinkRunning = true;
+}
+
+static void RxBufferTestProcess( void )
+{
+    if( IsUplinkDone == true )
+    {
+        IsUplinkDone = false;
+        IsUplinkRunning = false;
+        Uplink++;
+        if( Uplink >= NbUplinks )
+        {
+            TimerStop( &UplinkTimer );
+            printf( "DOWNLINKS,%lu,%lu\r\n", ( unsigned long )NetworkServerGetNbDownlinks( ),
+                    ( unsigned long )NbDownlinksReceived );
+            HostBoardSetEndTime( SimMediumGetTime( ) );
+        }
+    }
+    if( ( IsUplinkDue == true ) && ( IsUplinkRunning == false ) && ( LoRaMacIsBusy( ) == false ) )
+    {
+        IsUplinkDue = false;
+        UplinkStart( );
+        TimerSetValue( &UplinkTimer, UPLINK_PERIOD );
+        TimerStart( &UplinkTimer );
+    }
+}
+
+/**
+ * Main application entry point.
+ */
+int main( int argc, char* argv[] )
+{
+    NetworkServerParams_t networkServerParams =
+    {
+        .DevAddr = DEVICE_ADDRESS,
+        .NwkSKey = NwkSKey,
+        .AppSKey = AppSKey,
+        .Distance = GATEWAY_DISTANCE,
+        .RxCFrequency = RXC_FREQUENCY,
+        .RxCSpreadingFactor = RXC_SPREADING_FACTOR,
+    };
+
+    if( argc > 1 )
+    {
+        NbUplinks = strtoul( argv[1], NULL, 10 );
+    }
+
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# RX-BUFFER,host\r\n" );
+
+    NetworkServerInit( &networkServerParams );
+
+    MacPrimitives.MacMcpsConfirm = McpsConfirm;
+    MacPrimitives.MacMcpsIndication = McpsIndication;
+    MacPrimitives.MacMlmeConfirm = MlmeConfirm;
+    MacPrimitives.MacMlmeIndication = MlmeIndication;
+    MacCallbacks.GetBatteryLevel = BoardGetBatteryLevel;
+    MacCallbacks.MacProcessNotify = OnMacProcessNotify;
+    if( LoRaMacInitialization( &MacPrimitives, &MacCallbacks, ACTIVE_REGION ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,initialization\r\n" );
+        return EXIT_FAILURE;
+    }
+    DeviceActivate( );
+
+    TimerInit( &UplinkTimer, OnUplinkTimerEvent );
+    TimerSetValue( &UplinkTimer, UPLINK_PERIOD );
+    TimerStart( &UplinkTimer );
+
+    while( 1 )
+    {
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+
+        LoRaMacProcess( );
+
+        RxBufferTestProcess( );
+
+        CRITICAL_SECTION_BEGIN( );
+        if( IsMacProcessPending == true )
+        {
+            // Clear flag and prevent MCU to go into low power modes.
+            IsMacProcessPending = false;
+        }
+        else
+        {
+            // The MCU wakes up through events
+            BoardLowPowerHandler( );
+        }
+        CRITICAL_SECTION_END( );
+    }
+}
@@ -0,0 +1,419 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     LoRaMac duty cycle delayed uplink preload test on the host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs a class A ABP device against the network server of
+ *            network-server.c, sending each uplink twice at DR_0 until the
+ *            band duty cycle delays the transmissions. After NB_DELAYED
+ *            delayed transmissions the device switches to class C, where the
+ *            delayed transmissions must not be uploaded ahead of time.
+ *
+ *            The region channel selection and Tx configuration, the frame
+ *            securing and the medium transmissions are logged ( linked with
+ *            --wrap ). For each transmission delayed by the duty cycle the
+ *            time between the frame securing and the transmission start and
+ *            the MAC calls in between are printed.
+ *
+ *            Records:
+ *            DELAYED,class,ms,calls  Delayed transmission
+ *            UPLINKS,sent,received
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+#include "board.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "LoRaMac.h"
+#include "LoRaMacCrypto.h"
+#include "Region.h"
+#include "sim-medium.h"
+#include "host-board.h"
+#include "network-server.h"
+
+#ifndef ACTIVE_REGION
+
+#warning "No active region defined, LORAMAC_REGION_EU868 will be used as default."
+
+#define ACTIVE_REGION LORAMAC_REGION_EU868
+
+#endif
+
+/*!
+ * Uplink period [ms]
+ */
+#define UPLINK_PERIOD                               10000
+
+/*!
+ * Uplink datarate, ADR off, and transmissions per uplink
+ */
+#define UPLINK_DATARATE                             DR_0
+#define UPLINK_NB_TRANS                             2
+
+/*!
+ * Uplink port and size
+ */
+#define UPLINK_PORT                                 2
+#define UPLINK_SIZE                                 51
+
+/*!
+ * Delayed transmissions checked in each class
+ */
+#define NB_DELAYED                                  2
+
+/*!
+ * Bound of the number of uplinks
+ */
+#define MAX_UPLINKS                                 100
+
+/*!
+ * Distance between the gateway and the device [m]
+ */
+#define GATEWAY_DISTANCE                            100
+
+/*!
+ * ABP session
+ */
+#define DEVICE_ADDRESS                              0x260B1A2C
+
+static uint8_t NwkSKey[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+static uint8_t AppSKey[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+
+/*!
+ * MAC calls since the last frame securing
+ */
+static uint32_t CallsSinceSecure = 0;
+static SimTime_t SecureTime = 0;
+static bool IsTxDelayed = false;
+
+static uint32_t NbDelayed = 0;
+static uint32_t NbUplinks = 0;
+static bool IsUplinkRunning = false;
+static bool IsUplinkDone = false;
+static bool IsClassC = false;
+
+static volatile bool IsUplinkDue = false;
+static volatile bool IsMacProcessPending = false;
+
+static uint8_t UplinkBuffer[UPLINK_SIZE];
+
+static LoRaMacPrimitives_t MacPrimitives;
+static LoRaMacCallback_t MacCallbacks;
+
+/*!
+ * Timer starting the uplinks
+ */
+static TimerEvent_t UplinkTimer;
+
+LoRaMacStatus_t __real_RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nextChanParams, uint8_t* channel,
+                                          TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
+bool __real_RegionTxConfig( LoRaMacRegion_t region, TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir );
+LoRaMacCryptoStatus_t __real_LoRaMacCryptoSecureMessage( uint32_t fCntUp, uint8_t txDr, uint8_t txCh,
+                                                         LoRaMacMessageData_t* macMsg );
+bool __real_SimMediumSend( SimNode_t* node, const SimModulation_t* modulation, int8_t power, SimTime_t startTime,
+                           SimTime_t preambleTime, SimTime_t timeOnAir, const uint8_t* payload, uint8_t size );
+
+/*!
+ * \brief Logs the channel selections, a duty cycle restriction delays the
+ *        next transmission
+ */
+LoRaMacStatus_t __wrap_RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nextChanParams, uint8_t* channel,
+                                          TimerTime_t* time, TimerTime_t* aggregatedTimeOff )
+{
+    LoRaMacStatus_t status = __real_RegionNextChannel( region, nextChanParams, channel, time, aggregatedTimeOff );
+
+    if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
+    {
+        IsTxDelayed = true;
+    }
+    CallsSinceSecure++;
+    return status;
+}
+
+/*!
+ * \brief Logs the Tx configurations
+ */
+bool __wrap_RegionTxConfig( LoRaMacRegion_t region, TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir )
+{
+    CallsSinceSecure++;
+    return __real_RegionTxConfig( region, txConfig, txPower, txTimeOnAir );
+}
+
+/*!
+ * \brief Logs the frame securing, the last MAC step before the transmission
+ */
+LoRaMacCryptoStatus_t __wrap_LoRaMacCryptoSecureMessage( uint32_t fCntUp, uint8_t txDr, uint8_t txCh,
+                                                         LoRaMacMessageData_t* macMsg )
+{
+    CallsSinceSecure = 0;
+    SecureTime = SimMediumGetTime( );
+    return __real_LoRaMacCryptoSecureMessage( fCntUp, txDr, txCh, macMsg );
+}
+
+/*!
+ * \brief Logs the transmissions, the network server does not send downlinks
+ */
+bool __wrap_SimMediumSend( SimNode_t* node, const SimModulation_t* modulation, int8_t power, SimTime_t startTime,
+                           SimTime_t preambleTime, SimTime_t timeOnAir, const uint8_t* payload, uint8_t size )
+{
+    MibRequestConfirm_t mibReq;
+
+    if( IsTxDelayed == true )
+    {
+        IsTxDelayed = false;
+        mibReq.Type = MIB_DEVICE_CLASS;
+        LoRaMacMibGetRequestConfirm( &mibReq );
+        printf( "DELAYED,%c,%lu,%lu\r\n", ( mibReq.Param.Class == CLASS_C ) ? 'C' : 'A',
+                ( unsigned long )( ( startTime - SecureTime ) / 1000 ), ( unsigned long )CallsSinceSecure );
+        NbDelayed++;
+    }
+    return __real_SimMediumSend( node, modulation, power, startTime, preambleTime, timeOnAir, payload, size );
+}
+
+/*!
+ * \brief MCPS-Confirm primitive, end of the uplink
+ */
+static void McpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    IsUplinkDone = true;
+}
+
+/*!
+ * \brief MCPS-Indication primitive
+ */
+static void McpsIndication( McpsIndication_t* mcpsIndication )
+{
+}
+
+/*!
+ * \brief MLME-Confirm primitive
+ */
+static void MlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+}
+
+/*!
+ * \brief MLME-Indication primitive
+ */
+static void MlmeIndication( MlmeIndication_t* mlmeIndication )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    IsMacProcessPending = true;
+}
+
+static void OnUplinkTimerEvent( void* context )
+{
+    IsUplinkDue = true;
+}
+
+/*!
+ * \brief Sets a MIB attribute, the test fails on error
+ */
+static void MibSet( MibRequestConfirm_t* mibReq )
+{
+    if( LoRaMacMibSetRequestConfirm( mibReq ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,mib %d\r\n", mibReq->Type );
+        exit( EXIT_FAILURE );
+    }
+}
+
+/*!
+ * \brief Activates the device by personalization
+ */
+static void DeviceActivate( void )
+{
+    MibRequestConfirm_t mibReq;
+    MlmeReq_t mlmeReq;
+
+    mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+    mibReq.Param.AbpLrWanVersion.Value = 0x01000400; // 1.0.4.0
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_NET_ID;
+    mibReq.Param.NetID = 0;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_DEV_ADDR;
+    mibReq.Param.DevAddr = DEVICE_ADDRESS;
+    MibSet( &mibReq );
+
+    // LoRaWAN 1.0.x: a single network session key
+    mibReq.Type = MIB_F_NWK_S_INT_KEY;
+    mibReq.Param.FNwkSIntKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_S_NWK_S_INT_KEY;
+    mibReq.Param.SNwkSIntKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_NWK_S_ENC_KEY;
+    mibReq.Param.NwkSEncKey = NwkSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_APP_S_KEY;
+    mibReq.Param.AppSKey = AppSKey;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_PUBLIC_NETWORK;
+    mibReq.Param.EnablePublicNetwork = true;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_ADR;
+    mibReq.Param.AdrEnable = false;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_CHANNELS_DATARATE;
+    mibReq.Param.ChannelsDatarate = UPLINK_DATARATE;
+    MibSet( &mibReq );
+
+    mibReq.Type = MIB_CHANNELS_NB_TRANS;
+    mibReq.Param.ChannelsNbTrans = UPLINK_NB_TRANS;
+    MibSet( &mibReq );
+
+    LoRaMacStart( );
+
+    mlmeReq.Type = MLME_JOIN;
+    mlmeReq.Req.Join.NetworkActivation = ACTIVATION_TYPE_ABP;
+    mlmeReq.Req.Join.Datarate = UPLINK_DATARATE;
+    if( LoRaMacMlmeRequest( &mlmeReq ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,activation\r\n" );
+        exit( EXIT_FAILURE );
+    }
+}
+
+/*!
+ * \brief Sends the uplink, a duty cycle restricted request is retried on
+ *        the next period
+ */
+static void UplinkStart( void )
+{
+    McpsReq_t mcpsReq;
+    LoRaMacStatus_t status;
+
+    memset1( UplinkBuffer, ( uint8_t )NbUplinks, sizeof( UplinkBuffer ) );
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = UPLINK_PORT;
+    mcpsReq.Req.Unconfirmed.fBuffer = UplinkBuffer;
+    mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( UplinkBuffer );
+    mcpsReq.Req.Unconfirmed.Datarate = UPLINK_DATARATE;
+    status = LoRaMacMcpsRequest( &mcpsReq );
+    // The request itself is not delayed
+    IsTxDelayed = false;
+    if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
+    {
+        return;
+    }
+    if( status != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,uplink %d\r\n", status );
+        exit( EXIT_FAILURE );
+    }
+    IsUplinkRunning = true;
+}
+
+static void TxPreloadTestProcess( void )
+{
+    MibRequestConfirm_t mibReq;
+
+    if( IsUplinkDone == true )
+    {
+        IsUplinkDone = false;
+        IsUplinkRunning = false;
+        NbUplinks++;
+        if( ( NbDelayed >= ( 2 * NB_DELAYED ) ) || ( NbUplinks >= MAX_UPLINKS ) )
+        {
+            TimerStop( &UplinkTimer );
+            printf( "UPLINKS,%lu,%lu\r\n", ( unsigned long )NbUplinks, ( unsigned long )NetworkServerGetNbUplinks( ) );
+            HostBoardSetEndTime( SimMediumGetTime( ) );
+        }
+        else if( ( NbDelayed >= NB_DELAYED ) && ( IsClassC == false ) )
+        {
+            IsClassC = true;
+            mibReq.Type = MIB_DEVICE_CLASS;
+            mibReq.Param.Class = CLASS_C;
+            MibSet( &mibReq );
+        }
+    }
+    if( ( IsUplinkDue == true ) && ( IsUplinkRunning == false ) && ( LoRaMacIsBusy( ) == false ) )
+    {
+        IsUplinkDue = false;
+        UplinkStart( );
+        TimerSetValue( &UplinkTimer, UPLINK_PERIOD );
+        TimerStart( &UplinkTimer );
+    }
+}
+
+/**
+ * Main application entry point.
+ */
+int main( void )
+{
+    NetworkServerParams_t networkServerParams =
+    {
+        .DevAddr = DEVICE_ADDRESS,
+        .NwkSKey = NwkSKey,
+        .AppSKey = AppSKey,
+        .Distance = GATEWAY_DISTANCE,
+        .RxCFrequency = 869525000,
+        .RxCSpreadingFactor = 12,
+    };
+
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# TX-PRELOAD,host\r\n" );
+
+    NetworkServerInit( &networkServerParams );
+
+    MacPrimitives.MacMcpsConfirm = McpsConfirm;
+    MacPrimitives.MacMcpsIndication = McpsIndication;
+    MacPrimitives.MacMlmeConfirm = MlmeConfirm;
+    MacPrimitives.MacMlmeIndication = MlmeIndication;
+    MacCallbacks.GetBatteryLevel = BoardGetBatteryLevel;
+    MacCallbacks.MacProcessNotify = OnMacProcessNotify;
+    if( LoRaMacInitialization( &MacPrimitives, &MacCallbacks, ACTIVE_REGION ) != LORAMAC_STATUS_OK )
+    {
+        printf( "ERR,initialization\r\n" );
+        return EXIT_FAILURE;
+    }
+    DeviceActivate( );
+
+    TimerInit( &UplinkTimer, OnUplinkTimerEvent );
+    TimerSetValue( &UplinkTimer, UPLINK_PERIOD );
+    TimerStart( &UplinkTimer );
+
+    while( 1 )
+    {
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+
+        LoRaMacProcess( );
+
+        TxPreloadTestProcess( );
+
+        CRITICAL_SECTION_BEGIN( );
+        if( IsMacProcessPending == true )
+        {
+            // Clear flag and prevent MCU to go into low power modes.
+            IsMacProcessPending = false;
+        }
+        else
+        {
+            // The MCU wakes up through events
+            BoardLowPowerHandler( );
+        }
+        CRITICAL_SECTION_END( );
+    }
+}
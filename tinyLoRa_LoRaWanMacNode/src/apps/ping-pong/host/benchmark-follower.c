@@ -0,0 +1,233 @@
+/*!
+ * \file      benchmark-follower.c
+ *
+ * \brief     Ping-Pong benchmark follower node of the host simulation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#if defined( PING_PONG_BENCHMARK )
+
+#include <string.h>
+#include "radio.h"
+#include "sim-medium.h"
+#include "benchmark.h"
+#include "benchmark-follower.h"
+
+/*!
+ * Protocol constants of tinyLoRa/benchmark.c
+ */
+#define FOLLOWER_NB_PACKETS                         20
+#define FOLLOWER_CODINGRATE                         1
+#define FOLLOWER_PREAMBLE_LENGTH                    8
+#define FOLLOWER_TURNAROUND_DELAY                   5         // ms
+#define FOLLOWER_RX_MARGIN                          50        // ms
+#define FOLLOWER_IDLE_PERIODS                       3
+#define FOLLOWER_HEADER_SIZE                        17
+#define FOLLOWER_FRAME_SETUP                        0
+#define FOLLOWER_FRAME_DATA                         1
+
+/*!
+ * LoRa sync word of the private networks
+ */
+#define FOLLOWER_SYNCWORD                           0x12
+
+typedef enum
+{
+    /*!
+     * Waiting for a step announcement on the base configuration
+     */
+    FOLLOWER_STATE_BASE,
+    /*!
+     * Answering the PINGs of a step
+     */
+    FOLLOWER_STATE_DATA,
+}FollowerStates_t;
+
+static struct
+{
+    SimNode_t Node;
+    uint32_t Frequency;
+    FollowerStates_t State;
+    BenchmarkSettings_t Base;
+    BenchmarkSettings_t Step;
+    uint8_t StepIndex;
+    uint16_t Seq;
+    uint16_t Received;
+    /*!
+     * Set while the node timer runs the turnaround of a PONG, otherwise it
+     * runs the idle timeout of the step
+     */
+    bool IsTxPending;
+    uint8_t Buffer[255];
+    uint8_t Size;
+}Follower;
+
+/*!
+ * \brief Gets the time on air of a frame [ms]
+ */
+static uint32_t FollowerGetTimeOnAir( const BenchmarkSettings_t* settings, uint8_t size )
+{
+    return Radio.TimeOnAir( MODEM_LORA, settings->Bandwidth, settings->SpreadingFactor, FOLLOWER_CODINGRATE,
+                            FOLLOWER_PREAMBLE_LENGTH, false, size, true );
+}
+
+/*!
+ * \brief Builds the medium modulation of the given settings
+ */
+static void FollowerGetModulation( const BenchmarkSettings_t* settings, SimModulation_t* modulation )
+{
+    modulation->Modem = MODEM_LORA;
+    modulation->Frequency = Follower.Frequency;
+    modulation->Bandwidth = 125000UL << settings->Bandwidth;
+    modulation->Datarate = settings->SpreadingFactor;
+    modulation->IqInverted = false;
+    modulation->SyncWord = FOLLOWER_SYNCWORD;
+}
+
+/*!
+ * \brief Listens with the given settings
+ */
+static void FollowerListen( const BenchmarkSettings_t* settings )
+{
+    SimModulation_t modulation;
+
+    FollowerGetModulation( settings, &modulation );
+    SimMediumStopRx( &Follower.Node );
+    SimMediumStartRx( &Follower.Node, &modulation );
+}
+
+/*!
+ * \brief Returns to the base configuration
+ */
+static void FollowerBase( void )
+{
+    Follower.State = FOLLOWER_STATE_BASE;
+    SimMediumStopTimer( &Follower.Node );
+    FollowerListen( &Follower.Base );
+}
+
+/*!
+ * \brief Starts the idle timeout of the step, as the Radio.Rx of the
+ *        benchmark follower
+ */
+static void FollowerStartIdleTimer( void )
+{
+    uint32_t timeOnAir = FollowerGetTimeOnAir( &Follower.Step, Follower.Step.PayloadSize );
+    uint32_t timeout = FOLLOWER_IDLE_PERIODS * ( timeOnAir + timeOnAir + FOLLOWER_TURNAROUND_DELAY +
+                                                 FOLLOWER_RX_MARGIN + FOLLOWER_TURNAROUND_DELAY );
+
+    Follower.IsTxPending = false;
+    SimMediumSetTimer( &Follower.Node, SimMediumGetTime( ) + ( ( SimTime_t )timeout * 1000 ) );
+}
+
+/*!
+ * \brief Schedules the PONG in the buffer after the turnaround
+ */
+static void FollowerReply( const SimRxInfo_t* info )
+{
+    memcpy( Follower.Buffer, "PONG", 4 );
+    Follower.IsTxPending = true;
+    SimMediumSetTimer( &Follower.Node, info->EndTime + ( FOLLOWER_TURNAROUND_DELAY * 1000 ) );
+}
+
+/*!
+ * \brief Medium callback: frame received
+ */
+static void FollowerOnRxDone( SimNode_t* node, const uint8_t* payload, uint8_t size, const SimRxInfo_t* info )
+{
+    uint8_t type;
+    uint8_t step;
+
+    if( ( Follower.IsTxPending == true ) || ( size < FOLLOWER_HEADER_SIZE ) || ( memcmp( payload, "PING", 4 ) != 0 ) )
+    {
+        return;
+    }
+    type = payload[4];
+    step = payload[5];
+    memcpy( Follower.Buffer, payload, size );
+    Follower.Size = size;
+
+    if( ( Follower.State == FOLLOWER_STATE_BASE ) && ( type == FOLLOWER_FRAME_SETUP ) )
+    {
+        Follower.StepIndex = step;
+        BenchmarkGetSettings( step, &Follower.Step );
+        FollowerReply( info );
+    }
+    else if( ( Follower.State == FOLLOWER_STATE_DATA ) && ( type == FOLLOWER_FRAME_DATA ) &&
+             ( step == Follower.StepIndex ) )
+    {
+        Follower.Seq = payload[6] | ( payload[7] << 8 );
+        Follower.Received++;
+        Follower.Buffer[12] = Follower.Received & 0xFF;
+        Follower.Buffer[13] = Follower.Received >> 8;
+        Follower.Buffer[14] = ( uint16_t )info->Rssi & 0xFF;
+        Follower.Buffer[15] = ( uint16_t )info->Rssi >> 8;
+        Follower.Buffer[16] = ( uint8_t )info->Snr;
+        FollowerReply( info );
+    }
+}
+
+/*!
+ * \brief Medium callback: PONG sent
+ */
+static void FollowerOnTxDone( SimNode_t* node )
+{
+    if( Follower.State == FOLLOWER_STATE_BASE )
+    {
+        // Step announcement acknowledged
+        Follower.State = FOLLOWER_STATE_DATA;
+        Follower.Received = 0;
+        Follower.Seq = 0;
+        FollowerListen( &Follower.Step );
+        FollowerStartIdleTimer( );
+    }
+    else if( Follower.Seq >= ( FOLLOWER_NB_PACKETS - 1 ) )
+    {
+        FollowerBase( );
+    }
+    else
+    {
+        FollowerStartIdleTimer( );
+    }
+}
+
+/*!
+ * \brief Medium callback: turnaround over or step idle
+ */
+static void FollowerOnTimer( SimNode_t* node )
+{
+    const BenchmarkSettings_t* settings = ( Follower.State == FOLLOWER_STATE_BASE ) ? &Follower.Base : &Follower.Step;
+    SimModulation_t modulation;
+    SimTime_t symbolTime;
+
+    if( Follower.IsTxPending == false )
+    {
+        // The leader has moved on
+        FollowerBase( );
+        return;
+    }
+    Follower.IsTxPending = false;
+
+    // Preamble plus the 4.25 symbols added by the hardware
+    FollowerGetModulation( settings, &modulation );
+    symbolTime = ( 1000000ULL << settings->SpreadingFactor ) / modulation.Bandwidth;
+    SimMediumSend( node, &modulation, settings->TxPower, SimMediumGetTime( ),
+                   ( ( ( SimTime_t )FOLLOWER_PREAMBLE_LENGTH * 4 ) + 17 ) * symbolTime / 4,
+                   ( SimTime_t )FollowerGetTimeOnAir( settings, Follower.Size ) * 1000, Follower.Buffer, Follower.Size );
+}
+
+void BenchmarkFollowerInit( uint32_t frequency, int32_t distance )
+{
+    memset( &Follower, 0, sizeof( Follower ) );
+    Follower.Frequency = frequency;
+    Follower.Node.X = distance;
+    Follower.Node.RxDone = FollowerOnRxDone;
+    Follower.Node.TxDone = FollowerOnTxDone;
+    Follower.Node.Timer = FollowerOnTimer;
+    BenchmarkGetSettings( BENCHMARK_BASE_STEP, &Follower.Base );
+
+    SimMediumAddNode( &Follower.Node );
+    FollowerBase( );
+}
+
+#endif // PING_PONG_BENCHMARK
@@ -0,0 +1,38 @@
+/*!
+ * \file      benchmark-follower.h
+ *
+ * \brief     Ping-Pong benchmark follower node of the host simulation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The simulated radio drives the leader, the benchmark of
+ *            tinyLoRa/benchmark.c. The follower node answers it on the
+ *            medium with the follower side of the protocol: it acknowledges
+ *            the step announcements, switches to the step settings and
+ *            answers each PING with a PONG carrying its reception count,
+ *            RSSI and SNR.
+ */
+#ifndef __BENCHMARK_FOLLOWER_H__
+#define __BENCHMARK_FOLLOWER_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/*!
+ * \brief Adds the follower node to the medium and starts its reception on
+ *        the base configuration
+ *
+ * \param [IN] frequency RF frequency [Hz]
+ * \param [IN] distance  Distance to the leader [m]
+ */
+void BenchmarkFollowerInit( uint32_t frequency, int32_t distance );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BENCHMARK_FOLLOWER_H__
@@ -0,0 +1,472 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Ping-Pong implementation on the host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs the Ping-Pong of the tinyLoRa board over the simulated
+ *            radio medium, against a follower node answering each PING with
+ *            a PONG. With PING_PONG_BENCHMARK, runs the benchmark leader
+ *            against the follower of benchmark-follower.c. The program
+ *            argument is the virtual run time in ms.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "board-config.h"
+#include "board.h"
+#include "sx-delay.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "sim-radio.h"
+#include "host-board.h"
+
+#if defined( PING_PONG_BENCHMARK )
+#include "benchmark.h"
+#include "benchmark-follower.h"
+#endif
+
+#if defined( REGION_AS923 )
+
+#define RF_FREQUENCY                                923000000 // Hz
+
+#elif defined( REGION_AU915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_CN470 )
+
+#define RF_FREQUENCY                                470000000 // Hz
+
+#elif defined( REGION_CN779 )
+
+#define RF_FREQUENCY                                779000000 // Hz
+
+#elif defined( REGION_EU433 )
+
+#define RF_FREQUENCY                                433000000 // Hz
+
+#elif defined( REGION_EU868 )
+
+#define RF_FREQUENCY                                868000000 // Hz
+
+#elif defined( REGION_KR920 )
+
+#define RF_FREQUENCY                                920000000 // Hz
+
+#elif defined( REGION_IN865 )
+
+#define RF_FREQUENCY                                865000000 // Hz
+
+#elif defined( REGION_US915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_RU864 )
+
+#define RF_FREQUENCY                                864000000 // Hz
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+#define TX_OUTPUT_POWER                             14        // dBm
+
+#if defined( USE_MODEM_LORA )
+
+#define LORA_BANDWIDTH                              0         // [0: 125 kHz,
+                                                              //  1: 250 kHz,
+                                                              //  2: 500 kHz,
+                                                              //  3: Reserved]
+#define LORA_SPREADING_FACTOR                       7         // [SF7..SF12]
+#define LORA_CODINGRATE                             1         // [1: 4/5,
+                                                              //  2: 4/6,
+                                                              //  3: 4/7,
+                                                              //  4: 4/8]
+#define LORA_PREAMBLE_LENGTH                        8         // Same for Tx and Rx
+#define LORA_SYMBOL_TIMEOUT                         5         // Symbols
+#define LORA_FIX_LENGTH_PAYLOAD_ON                  false
+#define LORA_IQ_INVERSION_ON                        false
+
+#elif defined( USE_MODEM_FSK )
+
+#define FSK_FDEV                                    25000     // Hz
+#define FSK_DATARATE                                50000     // bps
+#define FSK_BANDWIDTH                               50000     // Hz
+#define FSK_AFC_BANDWIDTH                           83333     // Hz
+#define FSK_PREAMBLE_LENGTH                         5         // Same for Tx and Rx
+#define FSK_FIX_LENGTH_PAYLOAD_ON                   false
+
+#else
+    #error "Please define a modem in the compiler options."
+#endif
+
+typedef enum
+{
+    LOWPOWER,
+    RX,
+    RX_TIMEOUT,
+    RX_ERROR,
+    TX,
+    TX_TIMEOUT,
+}States_t;
+
+#define RX_TIMEOUT_VALUE                            1000
+#define BUFFER_SIZE                                 64 // Define the payload size here
+
+/*!
+ * Follower position [m]
+ */
+#define FOLLOWER_DISTANCE                           10
+
+/*!
+ * Follower time between the end of a PING and the start of its PONG [us],
+ * the DelayMs( 1 ) of the application
+ */
+#define FOLLOWER_TURNAROUND                         1000
+
+const uint8_t PingMsg[] = "PING";
+const uint8_t PongMsg[] = "PONG";
+
+uint16_t BufferSize = BUFFER_SIZE;
+uint8_t Buffer[BUFFER_SIZE];
+
+States_t State = LOWPOWER;
+
+int8_t RssiValue = 0;
+int8_t SnrValue = 0;
+
+/*!
+ * Radio events function pointer
+ */
+static RadioEvents_t RadioEvents;
+
+/*!
+ * Follower node context
+ */
+static struct
+{
+    SimNode_t Node;
+    SimModulation_t Modulation;
+    SimTime_t PreambleTime;
+    uint8_t Buffer[BUFFER_SIZE];
+    uint8_t Size;
+}Follower;
+
+/*!
+ * \brief Function to be executed on Radio Tx Done event
+ */
+void OnTxDone( void );
+
+/*!
+ * \brief Function to be executed on Radio Rx Done event
+ */
+void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * \brief Function executed on Radio Tx Timeout event
+ */
+void OnTxTimeout( void );
+
+/*!
+ * \brief Function executed on Radio Rx Timeout event
+ */
+void OnRxTimeout( void );
+
+/*!
+ * \brief Function executed on Radio Rx Error event
+ */
+void OnRxError( void );
+
+/*!
+ * \brief Adds the follower node to the medium and starts its reception
+ */
+static void FollowerInit( void );
+
+/**
+ * Main application entry point.
+ */
+int main( int argc, char* argv[] )
+{
+    bool isMaster = true;
+    uint8_t i = 0;
+
+    HostBoardParseArgs( argc, argv );
+
+    // Target board initialization
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "Hello from host\r\n" );
+
+#if defined( PING_PONG_BENCHMARK )
+    // Never returns
+    BenchmarkFollowerInit( RF_FREQUENCY, FOLLOWER_DISTANCE );
+    BenchmarkRun( RF_FREQUENCY );
+#endif
+
+    FollowerInit( );
+
+    // Radio initialization
+    RadioEvents.TxDone = OnTxDone;
+    RadioEvents.RxDone = OnRxDone;
+    RadioEvents.TxTimeout = OnTxTimeout;
+    RadioEvents.RxTimeout = OnRxTimeout;
+    RadioEvents.RxError = OnRxError;
+
+    Radio.Init( &RadioEvents );
+
+    Radio.SetChannel( RF_FREQUENCY );
+
+#if defined( USE_MODEM_LORA )
+
+    Radio.SetTxConfig( MODEM_LORA, TX_OUTPUT_POWER, 0, LORA_BANDWIDTH,
+                                   LORA_SPREADING_FACTOR, LORA_CODINGRATE,
+                                   LORA_PREAMBLE_LENGTH, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                   true, 0, 0, LORA_IQ_INVERSION_ON, 3000 );
+
+    Radio.SetRxConfig( MODEM_LORA, LORA_BANDWIDTH, LORA_SPREADING_FACTOR,
+                                   LORA_CODINGRATE, 0, LORA_PREAMBLE_LENGTH,
+                                   LORA_SYMBOL_TIMEOUT, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                   0, true, 0, 0, LORA_IQ_INVERSION_ON, true );
+
+    Radio.SetMaxPayloadLength( MODEM_LORA, BUFFER_SIZE );
+
+#elif defined( USE_MODEM_FSK )
+
+    Radio.SetTxConfig( MODEM_FSK, TX_OUTPUT_POWER, FSK_FDEV, 0,
+                                  FSK_DATARATE, 0,
+                                  FSK_PREAMBLE_LENGTH, FSK_FIX_LENGTH_PAYLOAD_ON,
+                                  true, 0, 0, 0, 3000 );
+
+    Radio.SetRxConfig( MODEM_FSK, FSK_BANDWIDTH, FSK_DATARATE,
+                                  0, FSK_AFC_BANDWIDTH, FSK_PREAMBLE_LENGTH,
+                                  0, FSK_FIX_LENGTH_PAYLOAD_ON, 0, true,
+                                  0, 0,false, true );
+
+    Radio.SetMaxPayloadLength( MODEM_FSK, BUFFER_SIZE );
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+    Radio.Rx( RX_TIMEOUT_VALUE );
+
+    while( 1 )
+    {
+        switch( State )
+        {
+        case RX:
+            if( isMaster == true )
+            {
+                if( BufferSize > 0 )
+                {
+                    if( strncmp( ( const char* )Buffer, ( const char* )PongMsg, 4 ) == 0 )
+                    {
+                        // Indicates on a LED that the received frame is a PONG
+                        printf("Received a Pong! From follower.\r\n");
+
+                        // Send the next PING frame
+                        Buffer[0] = 'P';
+                        Buffer[1] = 'I';
+                        Buffer[2] = 'N';
+                        Buffer[3] = 'G';
+                        // We fill the buffer with numbers for the payload
+                        for( i = 4; i < BufferSize; i++ )
+                        {
+                            Buffer[i] = i - 4;
+                        }
+                        DelayMs( 1 );
+                        Radio.Send( Buffer, BufferSize );
+                    }
+                    else if( strncmp( ( const char* )Buffer, ( const char* )PingMsg, 4 ) == 0 )
+                    { // A master already exists then become a slave
+                        isMaster = false;
+                        Radio.Rx( RX_TIMEOUT_VALUE );
+                    }
+                    else // valid reception but neither a PING or a PONG message
+                    {    // Set device as master ans start again
+                        isMaster = true;
+                        Radio.Rx( RX_TIMEOUT_VALUE );
+                    }
+                }
+            }
+            else
+            {
+                if( BufferSize > 0 )
+                {
+                    if( strncmp( ( const char* )Buffer, ( const char* )PingMsg, 4 ) == 0 )
+                    {
+                        // Indicates on a LED that the received frame is a PING
+                        printf("Received a Ping! From leader.\r\n");
+
+                        // Send the reply to the PONG string
+                        Buffer[0] = 'P';
+                        Buffer[1] = 'O';
+                        Buffer[2] = 'N';
+                        Buffer[3] = 'G';
+                        // We fill the buffer with numbers for the payload
+                        for( i = 4; i < BufferSize; i++ )
+                        {
+                            Buffer[i] = i - 4;
+                        }
+                        DelayMs( 1 );
+                        Radio.Send( Buffer, BufferSize );
+                    }
+                    else // valid reception but not a PING as expected
+                    {    // Set device as master and start again
+                        isMaster = true;
+                        Radio.Rx( RX_TIMEOUT_VALUE );
+                    }
+                }
+            }
+            State = LOWPOWER;
+            break;
+        case TX:
+            // Indicates on a LED that we have sent a PING [Master]
+            // Indicates on a LED that we have sent a PONG [Slave]
+            printf("Sent a ping or pong!\r\n");
+
+            Radio.Rx( RX_TIMEOUT_VALUE );
+            State = LOWPOWER;
+            break;
+        case RX_TIMEOUT:
+        case RX_ERROR:
+            if( isMaster == true )
+            {
+                // Send the next PING frame
+                Buffer[0] = 'P';
+                Buffer[1] = 'I';
+                Buffer[2] = 'N';
+                Buffer[3] = 'G';
+                for( i = 4; i < BufferSize; i++ )
+                {
+                    Buffer[i] = i - 4;
+                }
+                DelayMs( 1 );
+                Radio.Send( Buffer, BufferSize );
+            }
+            else
+            {
+                Radio.Rx( RX_TIMEOUT_VALUE );
+            }
+            State = LOWPOWER;
+            break;
+        case TX_TIMEOUT:
+            Radio.Rx( RX_TIMEOUT_VALUE );
+            State = LOWPOWER;
+            break;
+        case LOWPOWER:
+        default:
+            // Set low power
+            break;
+        }
+#if BOARD_CONFIG_ENTER_LOW_POWER
+        BoardLowPowerHandler( );
+#endif
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+
+
+void OnTxDone( void )
+{
+    Radio.Sleep( );
+    State = TX;
+}
+
+void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    printf("rx done\r\n");
+    Radio.Sleep( );
+    BufferSize = size;
+    memcpy( Buffer, payload, BufferSize );
+    RssiValue = rssi;
+    SnrValue = snr;
+    State = RX;
+}
+
+void OnTxTimeout( void )
+{
+  printf("tx timeout\r\n");
+    Radio.Sleep( );
+    State = TX_TIMEOUT;
+}
+
+void OnRxTimeout( void )
+{
+  printf("rx timeout\r\n");
+    Radio.Sleep( );
+    State = RX_TIMEOUT;
+}
+
+void OnRxError( void )
+{
+  printf("rx error\r\n");
+    Radio.Sleep( );
+    State = RX_ERROR;
+}
+
+/*!
+ * \brief Follower medium callback: sends the PONG after the turnaround
+ */
+static void FollowerOnRxDone( SimNode_t* node, const uint8_t* payload, uint8_t size, const SimRxInfo_t* info )
+{
+    if( ( size < 4 ) || ( size > BUFFER_SIZE ) || ( strncmp( ( const char* )payload, ( const char* )PingMsg, 4 ) != 0 ) )
+    {
+        return;
+    }
+    memcpy( Follower.Buffer, payload, size );
+    memcpy( Follower.Buffer, PongMsg, 4 );
+    Follower.Size = size;
+    SimMediumSetTimer( node, info->EndTime + FOLLOWER_TURNAROUND );
+}
+
+/*!
+ * \brief Follower medium callback: turnaround over
+ */
+static void FollowerOnTimer( SimNode_t* node )
+{
+#if defined( USE_MODEM_LORA )
+    uint32_t timeOnAir = Radio.TimeOnAir( MODEM_LORA, LORA_BANDWIDTH, LORA_SPREADING_FACTOR, LORA_CODINGRATE,
+                                          LORA_PREAMBLE_LENGTH, LORA_FIX_LENGTH_PAYLOAD_ON, Follower.Size, true );
+#elif defined( USE_MODEM_FSK )
+    uint32_t timeOnAir = Radio.TimeOnAir( MODEM_FSK, FSK_BANDWIDTH, FSK_DATARATE, 0,
+                                          FSK_PREAMBLE_LENGTH, FSK_FIX_LENGTH_PAYLOAD_ON, Follower.Size, true );
+#endif
+
+    SimMediumSend( node, &Follower.Modulation, TX_OUTPUT_POWER, SimMediumGetTime( ), Follower.PreambleTime,
+                   ( SimTime_t )timeOnAir * 1000, Follower.Buffer, Follower.Size );
+}
+
+static void FollowerInit( void )
+{
+    Follower.Node.X = FOLLOWER_DISTANCE;
+    Follower.Node.RxDone = FollowerOnRxDone;
+    Follower.Node.Timer = FollowerOnTimer;
+
+    Follower.Modulation.Frequency = RF_FREQUENCY;
+#if defined( USE_MODEM_LORA )
+    // Private network sync word, preamble plus the 4.25 symbols of the hardware
+    Follower.Modulation.Modem = MODEM_LORA;
+    Follower.Modulation.Bandwidth = 125000UL << LORA_BANDWIDTH;
+    Follower.Modulation.Datarate = LORA_SPREADING_FACTOR;
+    Follower.Modulation.IqInverted = LORA_IQ_INVERSION_ON;
+    Follower.Modulation.SyncWord = 0x12;
+    Follower.PreambleTime = ( ( ( SimTime_t )LORA_PREAMBLE_LENGTH * 4 + 17 ) * ( 1000000UL << LORA_SPREADING_FACTOR ) ) /
+                            ( 4 * Follower.Modulation.Bandwidth );
+#elif defined( USE_MODEM_FSK )
+    Follower.Modulation.Modem = MODEM_FSK;
+    Follower.Modulation.Bandwidth = ( FSK_FDEV << 1 ) + FSK_DATARATE;
+    Follower.Modulation.Datarate = FSK_DATARATE;
+    Follower.PreambleTime = ( ( SimTime_t )FSK_PREAMBLE_LENGTH * 8000000 ) / FSK_DATARATE;
+#endif
+
+    SimMediumAddNode( &Follower.Node );
+    SimMediumStartRx( &Follower.Node, &Follower.Modulation );
+}
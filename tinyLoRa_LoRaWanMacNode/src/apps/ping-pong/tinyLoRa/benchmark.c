@@ -0,0 +1,751 @@
+/*!
+ * \file      benchmark.c
+ *
+ * \brief     Ping-Pong radio link benchmark implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#if defined( PING_PONG_BENCHMARK )
+
+#include <stdio.h>
+#include <string.h>
+#include "board.h"
+#include "board-config.h"
+#include "sx-delay.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "benchmark.h"
+
+#if !defined( USE_MODEM_LORA )
+    #error "The benchmark requires the LoRa modem."
+#endif
+
+/*!
+ * Number of PING frames sent per step
+ */
+#define BENCH_NB_PACKETS                            20
+
+/*!
+ * Settings common to every step
+ */
+#define BENCH_CODINGRATE                            1         // 4/5
+#define BENCH_PREAMBLE_LENGTH                       8
+#define BENCH_SYMBOL_TIMEOUT                        0         // The window lasts until its timeout
+
+/*!
+ * Base configuration, on which the steps are announced
+ */
+#define BENCH_BASE_SPREADING_FACTOR                 7
+#define BENCH_BASE_BANDWIDTH                        0
+#define BENCH_BASE_TX_POWER                         14
+
+/*!
+ * Delay before each transmission, leaving the peer time to open its
+ * reception window [ms]
+ */
+#define BENCH_TURNAROUND_DELAY                      5
+
+/*!
+ * Margin added to the reception windows [ms]
+ */
+#define BENCH_RX_MARGIN                             50
+
+/*!
+ * Time listened for a leader before becoming leader [ms]. A random time up
+ * to the same value is added.
+ */
+#define BENCH_LISTEN_TIMEOUT                        1000
+
+/*!
+ * Number of step announcements sent before the step is skipped
+ */
+#define BENCH_SETUP_RETRIES                         20
+
+/*!
+ * Number of PING periods without reception after which the follower returns
+ * to the base configuration
+ */
+#define BENCH_FOLLOWER_IDLE_PERIODS                 3
+
+/*!
+ * Frame header: "PING" / "PONG", type, step, sequence number, leader
+ * timestamp, PINGs received by the follower, PING RSSI and SNR
+ */
+#define BENCH_HEADER_SIZE                           17
+
+#define BENCH_BUFFER_SIZE                           255
+
+/*!
+ * Frame types
+ */
+#define BENCH_FRAME_SETUP                           0
+#define BENCH_FRAME_DATA                            1
+
+/*!
+ * Sweep, the payload size varies first
+ */
+static const uint8_t BenchSpreadingFactors[] = { 7, 9, 12 };
+static const uint8_t BenchBandwidths[] = { 0, 1, 2 };       // [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+static const int8_t BenchTxPowers[] = { 14, 2 };            // dBm
+static const uint8_t BenchPayloadSizes[] = { 24, 64, 128 };
+
+#define BENCH_NB_STEPS                              ( sizeof( BenchSpreadingFactors ) * sizeof( BenchBandwidths ) * \
+                                                      sizeof( BenchTxPowers ) * sizeof( BenchPayloadSizes ) )
+
+typedef enum
+{
+    BENCH_EVENT_NONE,
+    BENCH_EVENT_TX_DONE,
+    BENCH_EVENT_TX_TIMEOUT,
+    BENCH_EVENT_RX_DONE,
+    BENCH_EVENT_RX_TIMEOUT,
+    BENCH_EVENT_RX_ERROR,
+}BenchEvents_t;
+
+typedef enum
+{
+    /*!
+     * Listening for a leader on the base configuration
+     */
+    BENCH_STATE_LISTEN,
+    /*!
+     * Leader announcing a step
+     */
+    BENCH_STATE_SETUP,
+    /*!
+     * Leader or follower exchanging the frames of a step
+     */
+    BENCH_STATE_DATA,
+    /*!
+     * Follower waiting for the next step announcement
+     */
+    BENCH_STATE_BASE,
+}BenchStates_t;
+
+/*!
+ * Step parameters
+ */
+typedef struct sBenchStep
+{
+    uint8_t SpreadingFactor;
+    uint8_t Bandwidth;
+    int8_t TxPower;
+    uint8_t PayloadSize;
+    /*!
+     * Time on air of a frame [ms]
+     */
+    uint32_t TimeOnAir;
+}BenchStep_t;
+
+/*!
+ * Step statistics of the leader
+ */
+typedef struct sBenchStats
+{
+    uint16_t Sent;
+    uint16_t Acked;
+    uint16_t PeerReceived;
+    int16_t RssiMin;
+    int16_t RssiMax;
+    int32_t RssiSum;
+    int8_t SnrMin;
+    int8_t SnrMax;
+    int32_t SnrSum;
+    uint32_t RttMin;
+    uint32_t RttMax;
+    uint32_t RttSum;
+    TimerTime_t StartTime;
+}BenchStats_t;
+
+/*!
+ * Frame fields
+ */
+typedef struct sBenchFrame
+{
+    bool IsPing;
+    uint8_t Type;
+    uint8_t Step;
+    uint16_t Seq;
+    uint32_t Timestamp;
+    uint16_t PeerReceived;
+    int16_t PeerRssi;
+    int8_t PeerSnr;
+}BenchFrame_t;
+
+static RadioEvents_t RadioEvents;
+
+static volatile BenchEvents_t Event = BENCH_EVENT_NONE;
+static BenchStates_t State = BENCH_STATE_LISTEN;
+static bool IsLeader = false;
+
+static uint8_t Buffer[BENCH_BUFFER_SIZE];
+static uint8_t RxSize = 0;
+static int16_t RxRssi = 0;
+static int8_t RxSnr = 0;
+
+static uint32_t Run = 0;
+static uint8_t StepIndex = 0;
+static BenchStep_t Step;
+static BenchStep_t BaseStep;
+static uint16_t Seq = 0;
+static TimerTime_t TxTime = 0;
+static uint8_t SetupRetries = 0;
+static BenchStats_t Stats;
+
+/*!
+ * \brief Function to be executed on Radio Tx Done event
+ */
+static void OnTxDone( void );
+
+/*!
+ * \brief Function to be executed on Radio Rx Done event
+ */
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * \brief Function executed on Radio Tx Timeout event
+ */
+static void OnTxTimeout( void );
+
+/*!
+ * \brief Function executed on Radio Rx Timeout event
+ */
+static void OnRxTimeout( void );
+
+/*!
+ * \brief Function executed on Radio Rx Error event
+ */
+static void OnRxError( void );
+
+/*!
+ * \brief Follower: processes a radio event
+ *
+ * \param [IN] event Radio event
+ */
+static void BenchFollowerProcess( BenchEvents_t event );
+
+/*!
+ * \brief Builds the parameters of a step
+ *
+ * \param [IN]  index Step index [BENCH_NB_STEPS: base configuration]
+ * \param [OUT] step  Step parameters
+ */
+static void BenchGetStep( uint8_t index, BenchStep_t* step )
+{
+    if( index >= BENCH_NB_STEPS )
+    {
+        step->SpreadingFactor = BENCH_BASE_SPREADING_FACTOR;
+        step->Bandwidth = BENCH_BASE_BANDWIDTH;
+        step->TxPower = BENCH_BASE_TX_POWER;
+        step->PayloadSize = BENCH_HEADER_SIZE;
+    }
+    else
+    {
+        step->PayloadSize = BenchPayloadSizes[index % sizeof( BenchPayloadSizes )];
+        index /= sizeof( BenchPayloadSizes );
+        step->TxPower = BenchTxPowers[index % sizeof( BenchTxPowers )];
+        index /= sizeof( BenchTxPowers );
+        step->Bandwidth = BenchBandwidths[index % sizeof( BenchBandwidths )];
+        index /= sizeof( BenchBandwidths );
+        step->SpreadingFactor = BenchSpreadingFactors[index];
+    }
+    if( step->PayloadSize < BENCH_HEADER_SIZE )
+    {
+        step->PayloadSize = BENCH_HEADER_SIZE;
+    }
+    step->TimeOnAir = Radio.TimeOnAir( MODEM_LORA, step->Bandwidth, step->SpreadingFactor, BENCH_CODINGRATE,
+                                       BENCH_PREAMBLE_LENGTH, false, step->PayloadSize, true );
+}
+
+/*!
+ * \brief Configures the radio for a step
+ *
+ * \param [IN] step Step parameters
+ */
+static void BenchConfigure( const BenchStep_t* step )
+{
+    Radio.SetTxConfig( MODEM_LORA, step->TxPower, 0, step->Bandwidth,
+                                   step->SpreadingFactor, BENCH_CODINGRATE,
+                                   BENCH_PREAMBLE_LENGTH, false,
+                                   true, 0, 0, false, step->TimeOnAir + 1000 );
+
+    Radio.SetRxConfig( MODEM_LORA, step->Bandwidth, step->SpreadingFactor,
+                                   BENCH_CODINGRATE, 0, BENCH_PREAMBLE_LENGTH,
+                                   BENCH_SYMBOL_TIMEOUT, false,
+                                   0, true, 0, 0, false, false );
+
+    Radio.SetMaxPayloadLength( MODEM_LORA, BENCH_BUFFER_SIZE );
+}
+
+/*!
+ * \brief Computes the time the leader waits for a PONG [ms]
+ *
+ * \param [IN] step Step parameters
+ */
+static uint32_t BenchGetRxTimeout( const BenchStep_t* step )
+{
+    return step->TimeOnAir + BENCH_TURNAROUND_DELAY + BENCH_RX_MARGIN;
+}
+
+/*!
+ * \brief Computes the time after which the follower gives up a step [ms]
+ *
+ * \param [IN] step Step parameters
+ */
+static uint32_t BenchGetIdleTimeout( const BenchStep_t* step )
+{
+    return BENCH_FOLLOWER_IDLE_PERIODS * ( step->TimeOnAir + BenchGetRxTimeout( step ) + BENCH_TURNAROUND_DELAY );
+}
+
+/*!
+ * \brief Builds a frame in the buffer and sends it
+ *
+ * \param [IN] frame Frame fields
+ * \param [IN] size  Frame size
+ */
+static void BenchSend( const BenchFrame_t* frame, uint8_t size )
+{
+    memcpy( Buffer, ( frame->IsPing == true ) ? "PING" : "PONG", 4 );
+    Buffer[4] = frame->Type;
+    Buffer[5] = frame->Step;
+    Buffer[6] = frame->Seq & 0xFF;
+    Buffer[7] = frame->Seq >> 8;
+    Buffer[8] = frame->Timestamp & 0xFF;
+    Buffer[9] = ( frame->Timestamp >> 8 ) & 0xFF;
+    Buffer[10] = ( frame->Timestamp >> 16 ) & 0xFF;
+    Buffer[11] = ( frame->Timestamp >> 24 ) & 0xFF;
+    Buffer[12] = frame->PeerReceived & 0xFF;
+    Buffer[13] = frame->PeerReceived >> 8;
+    Buffer[14] = ( uint16_t )frame->PeerRssi & 0xFF;
+    Buffer[15] = ( uint16_t )frame->PeerRssi >> 8;
+    Buffer[16] = ( uint8_t )frame->PeerSnr;
+    for( uint16_t i = BENCH_HEADER_SIZE; i < size; i++ )
+    {
+        Buffer[i] = i - BENCH_HEADER_SIZE;
+    }
+
+    DelayMs( BENCH_TURNAROUND_DELAY );
+    Radio.Send( Buffer, size );
+}
+
+/*!
+ * \brief Parses the received frame
+ *
+ * \param [OUT] frame Frame fields
+ *
+ * \retval status [true: benchmark frame, false: other frame]
+ */
+static bool BenchParse( BenchFrame_t* frame )
+{
+    if( RxSize < BENCH_HEADER_SIZE )
+    {
+        return false;
+    }
+    if( strncmp( ( const char* )Buffer, "PING", 4 ) == 0 )
+    {
+        frame->IsPing = true;
+    }
+    else if( strncmp( ( const char* )Buffer, "PONG", 4 ) == 0 )
+    {
+        frame->IsPing = false;
+    }
+    else
+    {
+        return false;
+    }
+    frame->Type = Buffer[4];
+    frame->Step = Buffer[5];
+    frame->Seq = Buffer[6] | ( Buffer[7] << 8 );
+    frame->Timestamp = ( uint32_t )Buffer[8] | ( ( uint32_t )Buffer[9] << 8 ) |
+                       ( ( uint32_t )Buffer[10] << 16 ) | ( ( uint32_t )Buffer[11] << 24 );
+    frame->PeerReceived = Buffer[12] | ( Buffer[13] << 8 );
+    frame->PeerRssi = ( int16_t )( Buffer[14] | ( Buffer[15] << 8 ) );
+    frame->PeerSnr = ( int8_t )Buffer[16];
+    return frame->Step < BENCH_NB_STEPS;
+}
+
+/*!
+ * \brief Leader: announces the current step on the base configuration
+ */
+static void BenchLeaderSetup( void )
+{
+    BenchFrame_t frame = { .IsPing = true, .Type = BENCH_FRAME_SETUP, .Step = StepIndex };
+
+    State = BENCH_STATE_SETUP;
+    BenchConfigure( &BaseStep );
+    BenchSend( &frame, BaseStep.PayloadSize );
+}
+
+/*!
+ * \brief Leader: sends the next PING of the step
+ */
+static void BenchLeaderSendData( void )
+{
+    BenchFrame_t frame = { .IsPing = true, .Type = BENCH_FRAME_DATA, .Step = StepIndex, .Seq = Seq };
+
+    TxTime = TimerGetCurrentTime( );
+    frame.Timestamp = TxTime;
+    Stats.Sent++;
+    BenchSend( &frame, Step.PayloadSize );
+}
+
+/*!
+ * \brief Leader: prints the step summary and announces the next step
+ */
+static void BenchLeaderEndStep( void )
+{
+    uint32_t duration = TimerGetElapsedTime( Stats.StartTime );
+    uint32_t airtime = ( ( uint32_t )Stats.Sent + Stats.PeerReceived ) * Step.TimeOnAir;
+    uint16_t acked = ( Stats.Acked > 0 ) ? Stats.Acked : 1;
+
+    if( duration == 0 )
+    {
+        duration = 1;
+    }
+    if( Stats.Acked == 0 )
+    {
+        Stats.RssiMin = Stats.RssiMax = 0;
+        Stats.SnrMin = Stats.SnrMax = 0;
+        Stats.RttMin = 0;
+    }
+    printf( "STEP,%lu,%u,%u,%u,%d,%u,%u,%u,%u,%lu,%lu,%d,%ld,%d,%d,%ld,%d,%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+            ( unsigned long )Run, StepIndex, Step.SpreadingFactor, Step.Bandwidth, Step.TxPower, Step.PayloadSize,
+            Stats.Sent, Stats.Acked, Stats.PeerReceived,
+            ( unsigned long )( ( 1000UL * ( Stats.Sent - Stats.Acked ) ) / Stats.Sent ),
+            ( unsigned long )( ( Stats.PeerReceived < Stats.Sent ) ? ( ( 1000UL * ( Stats.Sent - Stats.PeerReceived ) ) / Stats.Sent ) : 0 ),
+            Stats.RssiMin, ( long )( Stats.RssiSum / acked ), Stats.RssiMax,
+            Stats.SnrMin, ( long )( Stats.SnrSum / acked ), Stats.SnrMax,
+            ( unsigned long )Stats.RttMin, ( unsigned long )( Stats.RttSum / acked ), ( unsigned long )Stats.RttMax,
+            ( unsigned long )( ( ( uint64_t )Stats.Acked * Step.PayloadSize * 1000 ) / duration ),
+            ( unsigned long )( ( ( uint64_t )airtime * 1000 ) / duration ),
+            ( unsigned long )duration );
+
+    StepIndex++;
+    if( StepIndex >= BENCH_NB_STEPS )
+    {
+        StepIndex = 0;
+        Run++;
+    }
+    SetupRetries = 0;
+    BenchLeaderSetup( );
+}
+
+/*!
+ * \brief Leader: records the outcome of the current PING and sends the next
+ *
+ * \param [IN] frame PONG received [NULL: no PONG]
+ */
+static void BenchLeaderNextData( const BenchFrame_t* frame )
+{
+    if( frame != NULL )
+    {
+        uint32_t rtt = TimerGetElapsedTime( frame->Timestamp );
+
+        Stats.Acked++;
+        if( frame->PeerReceived > Stats.PeerReceived )
+        {
+            Stats.PeerReceived = frame->PeerReceived;
+        }
+        Stats.RssiMin = ( RxRssi < Stats.RssiMin ) ? RxRssi : Stats.RssiMin;
+        Stats.RssiMax = ( RxRssi > Stats.RssiMax ) ? RxRssi : Stats.RssiMax;
+        Stats.RssiSum += RxRssi;
+        Stats.SnrMin = ( RxSnr < Stats.SnrMin ) ? RxSnr : Stats.SnrMin;
+        Stats.SnrMax = ( RxSnr > Stats.SnrMax ) ? RxSnr : Stats.SnrMax;
+        Stats.SnrSum += RxSnr;
+        Stats.RttMin = ( rtt < Stats.RttMin ) ? rtt : Stats.RttMin;
+        Stats.RttMax = ( rtt > Stats.RttMax ) ? rtt : Stats.RttMax;
+        Stats.RttSum += rtt;
+        printf( "PKT,%lu,%u,%u,%lu,1,%lu,%d,%d,%d,%d\r\n", ( unsigned long )Run, StepIndex, Seq, ( unsigned long )TxTime,
+                ( unsigned long )rtt, RxRssi, RxSnr, frame->PeerRssi, frame->PeerSnr );
+    }
+    else
+    {
+        printf( "PKT,%lu,%u,%u,%lu,0,0,0,0,0,0\r\n", ( unsigned long )Run, StepIndex, Seq, ( unsigned long )TxTime );
+    }
+
+    Seq++;
+    if( Seq >= BENCH_NB_PACKETS )
+    {
+        BenchLeaderEndStep( );
+    }
+    else
+    {
+        BenchLeaderSendData( );
+    }
+}
+
+/*!
+ * \brief Leader: processes a radio event
+ *
+ * \param [IN] event Radio event
+ */
+static void BenchLeaderProcess( BenchEvents_t event )
+{
+    BenchFrame_t frame;
+    bool isValid = ( event == BENCH_EVENT_RX_DONE ) && ( BenchParse( &frame ) == true );
+
+    if( State == BENCH_STATE_SETUP )
+    {
+        if( event == BENCH_EVENT_TX_DONE )
+        {
+            Radio.Rx( BenchGetRxTimeout( &BaseStep ) );
+        }
+        else if( ( isValid == true ) && ( frame.IsPing == true ) && ( frame.Type == BENCH_FRAME_SETUP ) )
+        {
+            // Another leader announces its steps, follow it
+            IsLeader = false;
+            State = BENCH_STATE_BASE;
+            printf( "# ROLE,follower\r\n" );
+            BenchFollowerProcess( event );
+        }
+        else if( ( isValid == true ) && ( frame.IsPing == false ) && ( frame.Type == BENCH_FRAME_SETUP ) &&
+                 ( frame.Step == StepIndex ) )
+        {
+            BenchGetStep( StepIndex, &Step );
+            BenchConfigure( &Step );
+            memset( &Stats, 0, sizeof( Stats ) );
+            Stats.RssiMin = INT16_MAX;
+            Stats.RssiMax = INT16_MIN;
+            Stats.SnrMin = INT8_MAX;
+            Stats.SnrMax = INT8_MIN;
+            Stats.RttMin = UINT32_MAX;
+            Stats.StartTime = TimerGetCurrentTime( );
+            State = BENCH_STATE_DATA;
+            Seq = 0;
+            BenchLeaderSendData( );
+        }
+        else if( ++SetupRetries > BENCH_SETUP_RETRIES )
+        {
+            printf( "SKIP,%lu,%u\r\n", ( unsigned long )Run, StepIndex );
+            StepIndex++;
+            if( StepIndex >= BENCH_NB_STEPS )
+            {
+                StepIndex = 0;
+                Run++;
+            }
+            SetupRetries = 0;
+            BenchLeaderSetup( );
+        }
+        else
+        {
+            BenchLeaderSetup( );
+        }
+    }
+    else if( State == BENCH_STATE_DATA )
+    {
+        if( event == BENCH_EVENT_TX_DONE )
+        {
+            Radio.Rx( BenchGetRxTimeout( &Step ) );
+        }
+        else if( ( isValid == true ) && ( frame.IsPing == false ) && ( frame.Type == BENCH_FRAME_DATA ) &&
+                 ( frame.Step == StepIndex ) && ( frame.Seq == Seq ) )
+        {
+            BenchLeaderNextData( &frame );
+        }
+        else
+        {
+            BenchLeaderNextData( NULL );
+        }
+    }
+}
+
+/*!
+ * \brief Follower: returns to the base configuration and waits for the next
+ *        step announcement
+ */
+static void BenchFollowerBase( void )
+{
+    State = BENCH_STATE_BASE;
+    BenchConfigure( &BaseStep );
+    Radio.Rx( 0 );
+}
+
+/*!
+ * \brief Follower: processes a radio event
+ *
+ * \param [IN] event Radio event
+ */
+static void BenchFollowerProcess( BenchEvents_t event )
+{
+    BenchFrame_t frame;
+    bool isValid = ( event == BENCH_EVENT_RX_DONE ) && ( BenchParse( &frame ) == true ) && ( frame.IsPing == true );
+
+    if( State == BENCH_STATE_BASE )
+    {
+        if( event == BENCH_EVENT_TX_DONE )
+        {
+            // Step announcement acknowledged
+            BenchConfigure( &Step );
+            Stats.PeerReceived = 0;
+            State = BENCH_STATE_DATA;
+            Radio.Rx( BenchGetIdleTimeout( &Step ) );
+        }
+        else if( ( isValid == true ) && ( frame.Type == BENCH_FRAME_SETUP ) )
+        {
+            StepIndex = frame.Step;
+            BenchGetStep( StepIndex, &Step );
+            frame.IsPing = false;
+            BenchSend( &frame, BaseStep.PayloadSize );
+        }
+        else
+        {
+            Radio.Rx( 0 );
+        }
+    }
+    else if( State == BENCH_STATE_DATA )
+    {
+        if( event == BENCH_EVENT_TX_DONE )
+        {
+            if( Seq >= ( BENCH_NB_PACKETS - 1 ) )
+            {
+                BenchFollowerBase( );
+            }
+            else
+            {
+                Radio.Rx( BenchGetIdleTimeout( &Step ) );
+            }
+        }
+        else if( ( isValid == true ) && ( frame.Type == BENCH_FRAME_DATA ) && ( frame.Step == StepIndex ) )
+        {
+            Seq = frame.Seq;
+            Stats.PeerReceived++;
+            frame.IsPing = false;
+            frame.PeerReceived = Stats.PeerReceived;
+            frame.PeerRssi = RxRssi;
+            frame.PeerSnr = RxSnr;
+            BenchSend( &frame, Step.PayloadSize );
+        }
+        else if( ( event == BENCH_EVENT_RX_TIMEOUT ) || ( event == BENCH_EVENT_TX_TIMEOUT ) )
+        {
+            // The leader has moved on
+            BenchFollowerBase( );
+        }
+        else
+        {
+            Radio.Rx( BenchGetIdleTimeout( &Step ) );
+        }
+    }
+}
+
+/*!
+ * \brief Processes the pending radio event
+ */
+static void BenchProcess( void )
+{
+    BenchEvents_t event;
+
+    CRITICAL_SECTION_BEGIN( );
+    event = Event;
+    Event = BENCH_EVENT_NONE;
+    CRITICAL_SECTION_END( );
+
+    if( event == BENCH_EVENT_NONE )
+    {
+        return;
+    }
+
+    if( State == BENCH_STATE_LISTEN )
+    {
+        if( event == BENCH_EVENT_RX_DONE )
+        {
+            IsLeader = false;
+            State = BENCH_STATE_BASE;
+            printf( "# ROLE,follower\r\n" );
+        }
+        else
+        {
+            IsLeader = true;
+            printf( "# ROLE,leader\r\n" );
+            BenchLeaderSetup( );
+            return;
+        }
+    }
+
+    if( IsLeader == true )
+    {
+        BenchLeaderProcess( event );
+    }
+    else
+    {
+        BenchFollowerProcess( event );
+    }
+}
+
+void BenchmarkRun( uint32_t frequency )
+{
+    RadioEvents.TxDone = OnTxDone;
+    RadioEvents.RxDone = OnRxDone;
+    RadioEvents.TxTimeout = OnTxTimeout;
+    RadioEvents.RxTimeout = OnRxTimeout;
+    RadioEvents.RxError = OnRxError;
+
+    Radio.Init( &RadioEvents );
+    Radio.SetChannel( frequency );
+
+    printf( "# BENCH,%u,%u\r\n", ( unsigned int )BENCH_NB_STEPS, BENCH_NB_PACKETS );
+    printf( "# PKT,run,step,seq,tx_time_ms,acked,rtt_ms,rssi,snr,peer_rssi,peer_snr\r\n" );
+    printf( "# STEP,run,step,sf,bw,power,size,sent,acked,peer_received,per_rt_permil,per_down_permil,"
+            "rssi_min,rssi_avg,rssi_max,snr_min,snr_avg,snr_max,rtt_min,rtt_avg,rtt_max,goodput_Bps,"
+            "airtime_permil,duration_ms\r\n" );
+    printf( "# SKIP,run,step\r\n" );
+
+    BenchGetStep( BENCH_NB_STEPS, &BaseStep );
+    BenchConfigure( &BaseStep );
+    State = BENCH_STATE_LISTEN;
+    Radio.Rx( BENCH_LISTEN_TIMEOUT + ( Radio.Random( ) % BENCH_LISTEN_TIMEOUT ) );
+
+    while( 1 )
+    {
+        BenchProcess( );
+#if BOARD_CONFIG_ENTER_LOW_POWER
+        BoardLowPowerHandler( );
+#endif
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+void BenchmarkGetSettings( uint8_t step, BenchmarkSettings_t* settings )
+{
+    BenchStep_t params;
+
+    BenchGetStep( step, &params );
+    settings->SpreadingFactor = params.SpreadingFactor;
+    settings->Bandwidth = params.Bandwidth;
+    settings->TxPower = params.TxPower;
+    settings->PayloadSize = params.PayloadSize;
+}
+
+static void OnTxDone( void )
+{
+    Event = BENCH_EVENT_TX_DONE;
+}
+
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    RxSize = ( size < BENCH_BUFFER_SIZE ) ? size : BENCH_BUFFER_SIZE;
+    memcpy( Buffer, payload, RxSize );
+    RxRssi = rssi;
+    RxSnr = snr;
+    Event = BENCH_EVENT_RX_DONE;
+}
+
+static void OnTxTimeout( void )
+{
+    Event = BENCH_EVENT_TX_TIMEOUT;
+}
+
+static void OnRxTimeout( void )
+{
+    Event = BENCH_EVENT_RX_TIMEOUT;
+}
+
+static void OnRxError( void )
+{
+    Event = BENCH_EVENT_RX_ERROR;
+}
+
+#endif // PING_PONG_BENCHMARK
@@ -0,0 +1,79 @@
+/*!
+ * \file      benchmark.h
+ *
+ * \brief     Ping-Pong radio link benchmark
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Enabled by the PING_PONG_BENCHMARK build option.
+ *            Two devices running the benchmark elect a leader the same way
+ *            as the Ping-Pong application. The leader sweeps the spreading
+ *            factors, bandwidths, Tx powers and payload sizes, announcing
+ *            each step to the follower on the base configuration ( SF7,
+ *            125 kHz ), then exchanges BENCH_NB_PACKETS PING / PONG frames
+ *            with it. The sweep is repeated until the device is reset.
+ *
+ *            The leader prints comma separated records:
+ *            PKT,run,step,seq,tx_time_ms,acked,rtt_ms,rssi,snr,peer_rssi,peer_snr
+ *            STEP,run,step,sf,bw,power,size,sent,acked,peer_received,
+ *                 per_rt_permil,per_down_permil,rssi_min,rssi_avg,rssi_max,
+ *                 snr_min,snr_avg,snr_max,rtt_min,rtt_avg,rtt_max,
+ *                 goodput_Bps,airtime_permil,duration_ms
+ *            SKIP,run,step
+ *            Lines starting with '#' are comments.
+ *
+ *            The benchmark only uses the Radio and timer interfaces.
+ */
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Index of the base configuration for BenchmarkGetSettings
+ */
+#define BENCHMARK_BASE_STEP                         0xFF
+
+/*!
+ * Radio settings of a step
+ */
+typedef struct sBenchmarkSettings
+{
+    uint8_t SpreadingFactor;
+    /*!
+     * Bandwidth [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+     */
+    uint8_t Bandwidth;
+    /*!
+     * Tx power [dBm]
+     */
+    int8_t TxPower;
+    uint8_t PayloadSize;
+}BenchmarkSettings_t;
+
+/*!
+ * \brief Runs the benchmark. Never returns.
+ *
+ * \param [IN] frequency RF frequency [Hz]
+ */
+void BenchmarkRun( uint32_t frequency );
+
+/*!
+ * \brief Gets the radio settings of a step, for a follower that does not run
+ *        the benchmark itself ( host simulation )
+ *
+ * \param [IN]  step     Step index [BENCHMARK_BASE_STEP: base configuration]
+ * \param [OUT] settings Radio settings
+ */
+void BenchmarkGetSettings( uint8_t step, BenchmarkSettings_t* settings );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BENCHMARK_H__
@@ -24,6 +24,10 @@
 
 #include "RP2040-platform.h"
 
+#if defined( PING_PONG_BENCHMARK )
+#include "benchmark.h"
+#endif
+
 
 #if defined( REGION_AS923 )
 
@@ -195,6 +199,11 @@ int main(void)
       default: printf("Illegal device id '%d'!\r\n", id); break;
     }
 
+#if defined( PING_PONG_BENCHMARK )
+    // Never returns
+    BenchmarkRun( RF_FREQUENCY );
+#endif
+
     // Radio initialization
     RadioEvents.TxDone = OnTxDone;
     RadioEvents.RxDone = OnRxDone;
@@ -0,0 +1,556 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Rx sensitivity test implementation on the host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs the Rx sensitivity test of the tinyLoRa board over the
+ *            simulated radio medium. The commands are read from the script
+ *            given as program argument ( see HostBoardGetCommand ), which
+ *            also drives a generator node 1 m away from the device, standing
+ *            for the generator and the step attenuator of the bench:
+ *
+ *            gen <level dBm> <count> [size] [gap ms]
+ *                                       Sends <count> test frames received
+ *                                       at <level> with the configuration
+ *                                       of "freq" and "cfg"
+ *
+ * \remark    The device receives in continuous mode and counts the test frames
+ *            sent by a generator ( a signal generator or a board running the
+ *            tx-cw application "pkt" command ) behind a step attenuator. The
+ *            test script sets the generator level, announces it with "step",
+ *            lets the generator send its frames and closes the step with
+ *            "end". The steps of a SF / BW pair form the PER curve printed by
+ *            "curve".
+ *
+ *            Commands, one per line:
+ *            freq <Hz>                  Sets the RF frequency
+ *            cfg <sf> <bw>              Sets the LoRa configuration, clears the curve
+ *            step <level dBm> [count]   Starts counting at the given level
+ *                                       [count: frames sent, 0: from the sequence numbers]
+ *            end                        Ends the step and adds it to the curve
+ *            curve                      Prints the curve and the sensitivity
+ *            clear                      Clears the curve
+ *            help                       Prints the commands
+ *
+ *            Every command is answered by "OK" or "ERR,<reason>". Records:
+ *            STEP,sf,bw,level_dbm,expected,received,crc_errors,per_permil,rssi_avg,snr_avg
+ *            SENSI,sf,bw,level_dbm     Lowest level with PER <= SENSI_PER_THRESHOLD
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board-config.h"
+#include "board.h"
+#include "sx-delay.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "sim-radio.h"
+#include "host-board.h"
+
+#if defined( REGION_AS923 )
+
+#define RF_FREQUENCY                                923000000 // Hz
+
+#elif defined( REGION_AU915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_CN470 )
+
+#define RF_FREQUENCY                                470000000 // Hz
+
+#elif defined( REGION_CN779 )
+
+#define RF_FREQUENCY                                779000000 // Hz
+
+#elif defined( REGION_EU433 )
+
+#define RF_FREQUENCY                                433000000 // Hz
+
+#elif defined( REGION_EU868 )
+
+#define RF_FREQUENCY                                868000000 // Hz
+
+#elif defined( REGION_KR920 )
+
+#define RF_FREQUENCY                                920000000 // Hz
+
+#elif defined( REGION_IN865 )
+
+#define RF_FREQUENCY                                865000000 // Hz
+
+#elif defined( REGION_US915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_RU864 )
+
+#define RF_FREQUENCY                                864000000 // Hz
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+#define LORA_BANDWIDTH                              0         // [0: 125 kHz,
+                                                              //  1: 250 kHz,
+                                                              //  2: 500 kHz,
+                                                              //  3: Reserved]
+#define LORA_SPREADING_FACTOR                       7         // [SF7..SF12]
+#define LORA_CODINGRATE                             1         // [1: 4/5,
+                                                              //  2: 4/6,
+                                                              //  3: 4/7,
+                                                              //  4: 4/8]
+#define LORA_PREAMBLE_LENGTH                        8         // Same for Tx and Rx
+#define LORA_SYMBOL_TIMEOUT                         0         // Symbols
+#define LORA_FIX_LENGTH_PAYLOAD_ON                  false
+#define LORA_IQ_INVERSION_ON                        false
+
+/*!
+ * Test frame: "SENS", 16 bits sequence number ( LSB first ), padding.
+ * Same layout as the tx-cw application.
+ */
+#define SENSI_HEADER_SIZE                           6
+
+/*!
+ * Maximum number of steps in a curve
+ */
+#define SENSI_MAX_STEPS                             32
+
+/*!
+ * Sensitivity criterion [per mil]
+ */
+#define SENSI_PER_THRESHOLD                         100
+
+/*!
+ * Default generator frame size and gap between the frames [ms]
+ */
+#define GEN_DEFAULT_SIZE                            16
+#define GEN_DEFAULT_GAP                             100
+
+typedef struct sSensiStep
+{
+    int16_t Level;
+    uint16_t Expected;
+    uint16_t Received;
+    uint16_t CrcErrors;
+    uint16_t FirstSeq;
+    uint16_t LastSeq;
+    int32_t RssiSum;
+    int32_t SnrSum;
+}SensiStep_t;
+
+const uint8_t SensiMsg[] = "SENS";
+
+static uint32_t Frequency = RF_FREQUENCY;
+static uint8_t SpreadingFactor = LORA_SPREADING_FACTOR;
+static uint8_t Bandwidth = LORA_BANDWIDTH;
+
+static SensiStep_t Steps[SENSI_MAX_STEPS];
+static uint8_t NbSteps = 0;
+
+/*!
+ * Step being counted
+ */
+static SensiStep_t Step;
+static bool IsCounting = false;
+
+/*!
+ * Generator node context
+ */
+static struct
+{
+    SimNode_t Node;
+    SimModulation_t Modulation;
+    SimTime_t PreambleTime;
+    SimTime_t TimeOnAir;
+    int8_t Power;
+    uint16_t Count;
+    uint16_t Sent;
+    uint32_t Gap;
+    uint8_t Buffer[255];
+    uint8_t Size;
+}Generator;
+
+/*!
+ * Radio events function pointer
+ */
+static RadioEvents_t RadioEvents;
+
+/*!
+ * \brief Function to be executed on Radio Rx Done event
+ */
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * \brief Function executed on Radio Rx Error event
+ */
+static void OnRxError( void );
+
+/*!
+ * \brief Adds the generator node to the medium
+ */
+static void GeneratorInit( void );
+
+/*!
+ * \brief Starts sending the test frames of the generator
+ *
+ * \retval error Error reason [NULL: success]
+ */
+static const char* GeneratorStart( int16_t level, uint16_t count, uint32_t size, uint32_t gap );
+
+/*!
+ * \brief Applies the configuration and starts the continuous reception
+ */
+static void SensiConfigure( void )
+{
+    Radio.Standby( );
+    Radio.SetChannel( Frequency );
+    Radio.SetRxConfig( MODEM_LORA, Bandwidth, SpreadingFactor,
+                                   LORA_CODINGRATE, 0, LORA_PREAMBLE_LENGTH,
+                                   LORA_SYMBOL_TIMEOUT, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                   0, true, 0, 0, LORA_IQ_INVERSION_ON, true );
+    Radio.SetMaxPayloadLength( MODEM_LORA, 255 );
+    Radio.Rx( 0 );
+}
+
+/*!
+ * \brief Computes the number of frames sent during a step
+ */
+static uint16_t SensiGetExpected( const SensiStep_t* step )
+{
+    if( step->Expected != 0 )
+    {
+        return step->Expected;
+    }
+    if( step->Received == 0 )
+    {
+        return 0;
+    }
+    return ( uint16_t )( step->LastSeq - step->FirstSeq + 1 );
+}
+
+static uint16_t SensiGetPer( const SensiStep_t* step )
+{
+    uint16_t expected = SensiGetExpected( step );
+
+    if( ( expected == 0 ) || ( step->Received >= expected ) )
+    {
+        return ( expected == 0 ) ? 1000 : 0;
+    }
+    return ( uint16_t )( ( ( uint32_t )( expected - step->Received ) * 1000 ) / expected );
+}
+
+static void SensiPrintStep( const SensiStep_t* step )
+{
+    int32_t rssiAvg = 0;
+    int32_t snrAvg = 0;
+
+    if( step->Received > 0 )
+    {
+        rssiAvg = step->RssiSum / step->Received;
+        snrAvg = step->SnrSum / step->Received;
+    }
+    printf( "STEP,%u,%u,%d,%u,%u,%u,%u,%ld,%ld\r\n", SpreadingFactor, Bandwidth, step->Level,
+            SensiGetExpected( step ), step->Received, step->CrcErrors, SensiGetPer( step ),
+            ( long )rssiAvg, ( long )snrAvg );
+}
+
+static void SensiPrintCurve( void )
+{
+    bool found = false;
+    int16_t sensitivity = 0;
+
+    for( uint8_t i = 0; i < NbSteps; i++ )
+    {
+        SensiPrintStep( &Steps[i] );
+        if( ( SensiGetPer( &Steps[i] ) <= SENSI_PER_THRESHOLD ) &&
+            ( ( found == false ) || ( Steps[i].Level < sensitivity ) ) )
+        {
+            sensitivity = Steps[i].Level;
+            found = true;
+        }
+    }
+    if( found == true )
+    {
+        printf( "SENSI,%u,%u,%d\r\n", SpreadingFactor, Bandwidth, sensitivity );
+    }
+    else
+    {
+        printf( "SENSI,%u,%u,none\r\n", SpreadingFactor, Bandwidth );
+    }
+}
+
+static void CmdHelp( void )
+{
+    printf( "# freq <Hz>\r\n" );
+    printf( "# cfg <sf> <bw>\r\n" );
+    printf( "# step <level dBm> [count]\r\n" );
+    printf( "# end\r\n" );
+    printf( "# curve\r\n" );
+    printf( "# clear\r\n" );
+    printf( "# gen <level dBm> <count> [size] [gap ms]\r\n" );
+}
+
+/*!
+ * \brief Executes a command line
+ *
+ * \retval error Error reason [NULL: success]
+ */
+static const char* CmdExecute( char* line )
+{
+    char* cmd = strtok( line, " " );
+    char* arg1 = strtok( NULL, " " );
+    char* arg2 = strtok( NULL, " " );
+    char* arg3 = strtok( NULL, " " );
+    char* arg4 = strtok( NULL, " " );
+
+    if( cmd == NULL )
+    {
+        return "empty";
+    }
+
+    if( strcmp( cmd, "freq" ) == 0 )
+    {
+        uint32_t frequency;
+
+        if( arg1 == NULL )
+        {
+            return "args";
+        }
+        frequency = strtoul( arg1, NULL, 10 );
+        if( Radio.CheckRfFrequency( frequency ) == false )
+        {
+            return "frequency";
+        }
+        Frequency = frequency;
+        SensiConfigure( );
+    }
+    else if( strcmp( cmd, "cfg" ) == 0 )
+    {
+        uint32_t sf;
+        uint32_t bw;
+
+        if( ( arg1 == NULL ) || ( arg2 == NULL ) )
+        {
+            return "args";
+        }
+        sf = strtoul( arg1, NULL, 10 );
+        bw = strtoul( arg2, NULL, 10 );
+        if( ( sf < 5 ) || ( sf > 12 ) || ( bw > 2 ) )
+        {
+            return "range";
+        }
+        SpreadingFactor = sf;
+        Bandwidth = bw;
+        NbSteps = 0;
+        IsCounting = false;
+        SensiConfigure( );
+    }
+    else if( strcmp( cmd, "step" ) == 0 )
+    {
+        if( arg1 == NULL )
+        {
+            return "args";
+        }
+        memset( &Step, 0, sizeof( Step ) );
+        Step.Level = ( int16_t )strtol( arg1, NULL, 10 );
+        Step.Expected = ( arg2 != NULL ) ? ( uint16_t )strtoul( arg2, NULL, 10 ) : 0;
+        IsCounting = true;
+    }
+    else if( strcmp( cmd, "end" ) == 0 )
+    {
+        if( IsCounting == false )
+        {
+            return "no step";
+        }
+        IsCounting = false;
+        SensiPrintStep( &Step );
+        if( NbSteps < SENSI_MAX_STEPS )
+        {
+            Steps[NbSteps++] = Step;
+        }
+    }
+    else if( strcmp( cmd, "curve" ) == 0 )
+    {
+        SensiPrintCurve( );
+    }
+    else if( strcmp( cmd, "clear" ) == 0 )
+    {
+        NbSteps = 0;
+    }
+    else if( strcmp( cmd, "gen" ) == 0 )
+    {
+        if( ( arg1 == NULL ) || ( arg2 == NULL ) )
+        {
+            return "args";
+        }
+        return GeneratorStart( ( int16_t )strtol( arg1, NULL, 10 ), ( uint16_t )strtoul( arg2, NULL, 10 ),
+                               ( arg3 != NULL ) ? strtoul( arg3, NULL, 10 ) : GEN_DEFAULT_SIZE,
+                               ( arg4 != NULL ) ? strtoul( arg4, NULL, 10 ) : GEN_DEFAULT_GAP );
+    }
+    else if( strcmp( cmd, "help" ) == 0 )
+    {
+        CmdHelp( );
+    }
+    else
+    {
+        return "unknown";
+    }
+    return NULL;
+}
+
+/*!
+ * \brief Executes the command lines of the script due at the virtual time
+ */
+static void CmdProcess( void )
+{
+    char* line;
+
+    while( ( line = HostBoardGetCommand( ) ) != NULL )
+    {
+        const char* error = CmdExecute( line );
+
+        if( error == NULL )
+        {
+            printf( "OK\r\n" );
+        }
+        else
+        {
+            printf( "ERR,%s\r\n", error );
+        }
+    }
+}
+
+/**
+ * Main application entry point.
+ */
+int main( int argc, char* argv[] )
+{
+    HostBoardOpenScript( argc, argv );
+
+    // Target board initialization
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# RX-SENSI,host\r\n" );
+
+    GeneratorInit( );
+
+    // Radio initialization
+    RadioEvents.RxDone = OnRxDone;
+    RadioEvents.RxError = OnRxError;
+
+    Radio.Init( &RadioEvents );
+
+    SensiConfigure( );
+
+    while( 1 )
+    {
+        CmdProcess( );
+
+#if BOARD_CONFIG_ENTER_LOW_POWER
+        BoardLowPowerHandler( );
+#endif
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    uint16_t seq;
+
+    if( ( IsCounting == false ) || ( size < SENSI_HEADER_SIZE ) ||
+        ( memcmp( payload, SensiMsg, 4 ) != 0 ) )
+    {
+        return;
+    }
+
+    seq = ( uint16_t )payload[4] | ( ( uint16_t )payload[5] << 8 );
+    if( Step.Received == 0 )
+    {
+        Step.FirstSeq = seq;
+    }
+    Step.LastSeq = seq;
+    Step.Received++;
+    Step.RssiSum += rssi;
+    Step.SnrSum += snr;
+}
+
+static void OnRxError( void )
+{
+    if( IsCounting == true )
+    {
+        Step.CrcErrors++;
+    }
+}
+
+/*!
+ * \brief Generator medium callback: sends the next test frame
+ */
+static void GeneratorOnTimer( SimNode_t* node )
+{
+    memset( Generator.Buffer, 0, Generator.Size );
+    memcpy( Generator.Buffer, SensiMsg, 4 );
+    Generator.Buffer[4] = Generator.Sent & 0xFF;
+    Generator.Buffer[5] = Generator.Sent >> 8;
+    SimMediumSend( node, &Generator.Modulation, Generator.Power, SimMediumGetTime( ), Generator.PreambleTime,
+                   Generator.TimeOnAir, Generator.Buffer, Generator.Size );
+}
+
+/*!
+ * \brief Generator medium callback: test frame sent
+ */
+static void GeneratorOnTxDone( SimNode_t* node )
+{
+    Generator.Sent++;
+    if( Generator.Sent < Generator.Count )
+    {
+        SimMediumSetTimer( node, SimMediumGetTime( ) + ( SimTime_t )Generator.Gap * 1000 );
+    }
+}
+
+static void GeneratorInit( void )
+{
+    Generator.Node.X = 1;
+    Generator.Node.TxDone = GeneratorOnTxDone;
+    Generator.Node.Timer = GeneratorOnTimer;
+    SimMediumAddNode( &Generator.Node );
+}
+
+static const char* GeneratorStart( int16_t level, uint16_t count, uint32_t size, uint32_t gap )
+{
+    // At 1 m the path loss is the reference path loss of the channel model
+    int32_t power = level + ( int32_t )HostBoardChannelModel.RefPathLoss;
+
+    if( ( count == 0 ) || ( size < SENSI_HEADER_SIZE ) || ( size > sizeof( Generator.Buffer ) ) ||
+        ( power < INT8_MIN ) || ( power > INT8_MAX ) )
+    {
+        return "range";
+    }
+
+    // Private network sync word, preamble plus the 4.25 symbols of the hardware
+    Generator.Modulation.Modem = MODEM_LORA;
+    Generator.Modulation.Frequency = Frequency;
+    Generator.Modulation.Bandwidth = 125000UL << Bandwidth;
+    Generator.Modulation.Datarate = SpreadingFactor;
+    Generator.Modulation.IqInverted = LORA_IQ_INVERSION_ON;
+    Generator.Modulation.SyncWord = 0x12;
+    Generator.PreambleTime = ( ( ( SimTime_t )LORA_PREAMBLE_LENGTH * 4 + 17 ) * ( 1000000UL << SpreadingFactor ) ) /
+                             ( 4 * Generator.Modulation.Bandwidth );
+    Generator.TimeOnAir = ( SimTime_t )Radio.TimeOnAir( MODEM_LORA, Bandwidth, SpreadingFactor, LORA_CODINGRATE,
+                                                        LORA_PREAMBLE_LENGTH, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                                        size, true ) * 1000;
+    Generator.Power = ( int8_t )power;
+    Generator.Count = count;
+    Generator.Sent = 0;
+    Generator.Gap = gap;
+    Generator.Size = ( uint8_t )size;
+    SimMediumSetTimer( &Generator.Node, SimMediumGetTime( ) );
+    return NULL;
+}
@@ -0,0 +1,447 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Rx sensitivity test implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The device receives in continuous mode and counts the test frames
+ *            sent by a generator ( a signal generator or a board running the
+ *            tx-cw application "pkt" command ) behind a step attenuator. The
+ *            test script sets the generator level, announces it with "step",
+ *            lets the generator send its frames and closes the step with
+ *            "end". The steps of a SF / BW pair form the PER curve printed by
+ *            "curve".
+ *
+ *            Commands, one per line:
+ *            freq <Hz>                  Sets the RF frequency
+ *            cfg <sf> <bw>              Sets the LoRa configuration, clears the curve
+ *            step <level dBm> [count]   Starts counting at the given level
+ *                                       [count: frames sent, 0: from the sequence numbers]
+ *            end                        Ends the step and adds it to the curve
+ *            curve                      Prints the curve and the sensitivity
+ *            clear                      Clears the curve
+ *            help                       Prints the commands
+ *
+ *            Every command is answered by "OK" or "ERR,<reason>". Records:
+ *            STEP,sf,bw,level_dbm,expected,received,crc_errors,per_permil,rssi_avg,snr_avg
+ *            SENSI,sf,bw,level_dbm     Lowest level with PER <= SENSI_PER_THRESHOLD
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "board.h"
+#include "sx-gpio.h"
+#include "sx-delay.h"
+#include "sx-timer.h"
+#include "radio.h"
+
+#include "sx126x-board.h"
+
+#include "RP2040-platform.h"
+
+#if defined( REGION_AS923 )
+
+#define RF_FREQUENCY                                923000000 // Hz
+
+#elif defined( REGION_AU915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_CN470 )
+
+#define RF_FREQUENCY                                470000000 // Hz
+
+#elif defined( REGION_CN779 )
+
+#define RF_FREQUENCY                                779000000 // Hz
+
+#elif defined( REGION_EU433 )
+
+#define RF_FREQUENCY                                433000000 // Hz
+
+#elif defined( REGION_EU868 )
+
+#define RF_FREQUENCY                                868000000 // Hz
+
+#elif defined( REGION_KR920 )
+
+#define RF_FREQUENCY                                920000000 // Hz
+
+#elif defined( REGION_IN865 )
+
+#define RF_FREQUENCY                                865000000 // Hz
+
+#elif defined( REGION_US915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_RU864 )
+
+#define RF_FREQUENCY                                864000000 // Hz
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+#define LORA_BANDWIDTH                              0         // [0: 125 kHz,
+                                                              //  1: 250 kHz,
+                                                              //  2: 500 kHz,
+                                                              //  3: Reserved]
+#define LORA_SPREADING_FACTOR                       7         // [SF7..SF12]
+#define LORA_CODINGRATE                             1         // [1: 4/5,
+                                                              //  2: 4/6,
+                                                              //  3: 4/7,
+                                                              //  4: 4/8]
+#define LORA_PREAMBLE_LENGTH                        8         // Same for Tx and Rx
+#define LORA_SYMBOL_TIMEOUT                         0         // Symbols
+#define LORA_FIX_LENGTH_PAYLOAD_ON                  false
+#define LORA_IQ_INVERSION_ON                        false
+
+/*!
+ * Test frame: "SENS", 16 bits sequence number ( LSB first ), padding.
+ * Same layout as the tx-cw application.
+ */
+#define SENSI_HEADER_SIZE                           6
+
+/*!
+ * Maximum number of steps in a curve
+ */
+#define SENSI_MAX_STEPS                             32
+
+/*!
+ * Sensitivity criterion [per mil]
+ */
+#define SENSI_PER_THRESHOLD                         100
+
+#define CMD_LINE_SIZE                               64
+
+typedef struct sSensiStep
+{
+    int16_t Level;
+    uint16_t Expected;
+    uint16_t Received;
+    uint16_t CrcErrors;
+    uint16_t FirstSeq;
+    uint16_t LastSeq;
+    int32_t RssiSum;
+    int32_t SnrSum;
+}SensiStep_t;
+
+const uint8_t SensiMsg[] = "SENS";
+
+static uint32_t Frequency = RF_FREQUENCY;
+static uint8_t SpreadingFactor = LORA_SPREADING_FACTOR;
+static uint8_t Bandwidth = LORA_BANDWIDTH;
+
+static SensiStep_t Steps[SENSI_MAX_STEPS];
+static uint8_t NbSteps = 0;
+
+/*!
+ * Step being counted
+ */
+static SensiStep_t Step;
+static bool IsCounting = false;
+
+static char CmdLine[CMD_LINE_SIZE];
+static uint8_t CmdLength = 0;
+
+/*!
+ * Radio events function pointer
+ */
+static RadioEvents_t RadioEvents;
+
+/*!
+ * \brief Function to be executed on Radio Rx Done event
+ */
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * \brief Function executed on Radio Rx Error event
+ */
+static void OnRxError( void );
+
+/*!
+ * \brief Applies the configuration and starts the continuous reception
+ */
+static void SensiConfigure( void )
+{
+    Radio.Standby( );
+    Radio.SetChannel( Frequency );
+    Radio.SetRxConfig( MODEM_LORA, Bandwidth, SpreadingFactor,
+                                   LORA_CODINGRATE, 0, LORA_PREAMBLE_LENGTH,
+                                   LORA_SYMBOL_TIMEOUT, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                   0, true, 0, 0, LORA_IQ_INVERSION_ON, true );
+    Radio.SetMaxPayloadLength( MODEM_LORA, 255 );
+    Radio.Rx( 0 );
+}
+
+/*!
+ * \brief Computes the number of frames sent during a step
+ */
+static uint16_t SensiGetExpected( const SensiStep_t* step )
+{
+    if( step->Expected != 0 )
+    {
+        return step->Expected;
+    }
+    if( step->Received == 0 )
+    {
+        return 0;
+    }
+    return ( uint16_t )( step->LastSeq - step->FirstSeq + 1 );
+}
+
+static uint16_t SensiGetPer( const SensiStep_t* step )
+{
+    uint16_t expected = SensiGetExpected( step );
+
+    if( ( expected == 0 ) || ( step->Received >= expected ) )
+    {
+        return ( expected == 0 ) ? 1000 : 0;
+    }
+    return ( uint16_t )( ( ( uint32_t )( expected - step->Received ) * 1000 ) / expected );
+}
+
+static void SensiPrintStep( const SensiStep_t* step )
+{
+    int32_t rssiAvg = 0;
+    int32_t snrAvg = 0;
+
+    if( step->Received > 0 )
+    {
+        rssiAvg = step->RssiSum / step->Received;
+        snrAvg = step->SnrSum / step->Received;
+    }
+    printf( "STEP,%u,%u,%d,%u,%u,%u,%u,%ld,%ld\r\n", SpreadingFactor, Bandwidth, step->Level,
+            SensiGetExpected( step ), step->Received, step->CrcErrors, SensiGetPer( step ),
+            ( long )rssiAvg, ( long )snrAvg );
+}
+
+static void SensiPrintCurve( void )
+{
+    bool found = false;
+    int16_t sensitivity = 0;
+
+    for( uint8_t i = 0; i < NbSteps; i++ )
+    {
+        SensiPrintStep( &Steps[i] );
+        if( ( SensiGetPer( &Steps[i] ) <= SENSI_PER_THRESHOLD ) &&
+            ( ( found == false ) || ( Steps[i].Level < sensitivity ) ) )
+        {
+            sensitivity = Steps[i].Level;
+            found = true;
+        }
+    }
+    if( found == true )
+    {
+        printf( "SENSI,%u,%u,%d\r\n", SpreadingFactor, Bandwidth, sensitivity );
+    }
+    else
+    {
+        printf( "SENSI,%u,%u,none\r\n", SpreadingFactor, Bandwidth );
+    }
+}
+
+static void CmdHelp( void )
+{
+    printf( "# freq <Hz>\r\n" );
+    printf( "# cfg <sf> <bw>\r\n" );
+    printf( "# step <level dBm> [count]\r\n" );
+    printf( "# end\r\n" );
+    printf( "# curve\r\n" );
+    printf( "# clear\r\n" );
+}
+
+/*!
+ * \brief Executes a command line
+ *
+ * \retval error Error reason [NULL: success]
+ */
+static const char* CmdExecute( char* line )
+{
+    char* cmd = strtok( line, " " );
+    char* arg1 = strtok( NULL, " " );
+    char* arg2 = strtok( NULL, " " );
+
+    if( cmd == NULL )
+    {
+        return "empty";
+    }
+
+    if( strcmp( cmd, "freq" ) == 0 )
+    {
+        uint32_t frequency;
+
+        if( arg1 == NULL )
+        {
+            return "args";
+        }
+        frequency = strtoul( arg1, NULL, 10 );
+        if( Radio.CheckRfFrequency( frequency ) == false )
+        {
+            return "frequency";
+        }
+        Frequency = frequency;
+        SensiConfigure( );
+    }
+    else if( strcmp( cmd, "cfg" ) == 0 )
+    {
+        uint32_t sf;
+        uint32_t bw;
+
+        if( ( arg1 == NULL ) || ( arg2 == NULL ) )
+        {
+            return "args";
+        }
+        sf = strtoul( arg1, NULL, 10 );
+        bw = strtoul( arg2, NULL, 10 );
+        if( ( sf < 5 ) || ( sf > 12 ) || ( bw > 2 ) )
+        {
+            return "range";
+        }
+        SpreadingFactor = sf;
+        Bandwidth = bw;
+        NbSteps = 0;
+        IsCounting = false;
+        SensiConfigure( );
+    }
+    else if( strcmp( cmd, "step" ) == 0 )
+    {
+        if( arg1 == NULL )
+        {
+            return "args";
+        }
+        memset( &Step, 0, sizeof( Step ) );
+        Step.Level = ( int16_t )strtol( arg1, NULL, 10 );
+        Step.Expected = ( arg2 != NULL ) ? ( uint16_t )strtoul( arg2, NULL, 10 ) : 0;
+        IsCounting = true;
+    }
+    else if( strcmp( cmd, "end" ) == 0 )
+    {
+        if( IsCounting == false )
+        {
+            return "no step";
+        }
+        IsCounting = false;
+        SensiPrintStep( &Step );
+        if( NbSteps < SENSI_MAX_STEPS )
+        {
+            Steps[NbSteps++] = Step;
+        }
+    }
+    else if( strcmp( cmd, "curve" ) == 0 )
+    {
+        SensiPrintCurve( );
+    }
+    else if( strcmp( cmd, "clear" ) == 0 )
+    {
+        NbSteps = 0;
+    }
+    else if( strcmp( cmd, "help" ) == 0 )
+    {
+        CmdHelp( );
+    }
+    else
+    {
+        return "unknown";
+    }
+    return NULL;
+}
+
+/*!
+ * \brief Reads the characters received on stdio and executes the command
+ *        once a line is complete
+ */
+static void CmdProcess( void )
+{
+    int c;
+
+    while( ( c = getchar_timeout_us( 0 ) ) != PICO_ERROR_TIMEOUT )
+    {
+        if( ( c == '\r' ) || ( c == '\n' ) )
+        {
+            if( CmdLength > 0 )
+            {
+                const char* error;
+
+                CmdLine[CmdLength] = '\0';
+                CmdLength = 0;
+                error = CmdExecute( CmdLine );
+                if( error == NULL )
+                {
+                    printf( "OK\r\n" );
+                }
+                else
+                {
+                    printf( "ERR,%s\r\n", error );
+                }
+            }
+        }
+        else if( CmdLength < ( CMD_LINE_SIZE - 1 ) )
+        {
+            CmdLine[CmdLength++] = ( char )c;
+        }
+    }
+}
+
+/**
+ * Main application entry point.
+ */
+int main( void )
+{
+    // Target board initialization
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# RX-SENSI,%u\r\n", SX126xGetDeviceId( ) );
+
+    // Radio initialization
+    RadioEvents.RxDone = OnRxDone;
+    RadioEvents.RxError = OnRxError;
+
+    Radio.Init( &RadioEvents );
+
+    SensiConfigure( );
+
+    while( 1 )
+    {
+        CmdProcess( );
+
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    uint16_t seq;
+
+    if( ( IsCounting == false ) || ( size < SENSI_HEADER_SIZE ) ||
+        ( memcmp( payload, SensiMsg, 4 ) != 0 ) )
+    {
+        return;
+    }
+
+    seq = ( uint16_t )payload[4] | ( ( uint16_t )payload[5] << 8 );
+    if( Step.Received == 0 )
+    {
+        Step.FirstSeq = seq;
+    }
+    Step.LastSeq = seq;
+    Step.Received++;
+    Step.RssiSum += rssi;
+    Step.SnrSum += snr;
+}
+
+static void OnRxError( void )
+{
+    if( IsCounting == true )
+    {
+        Step.CrcErrors++;
+    }
+}
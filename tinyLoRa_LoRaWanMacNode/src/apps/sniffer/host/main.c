@@ -0,0 +1,497 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Single channel sniffer implementation on the host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs the sniffer of the tinyLoRa board over the simulated radio
+ *            medium. The stream goes to the file given as program argument,
+ *            each record taking the UART transfer time of the tinyLoRa board,
+ *            and is traced on stdout:
+ *            REC,size,flags,timestamp_ms,rssi,snr,dropped
+ *
+ *            A device node sends TRAFFIC_FRAMES uplinks, an interferer
+ *            collides with one of them and a node of a private network sends
+ *            on the same channel in between. The run ends with the traffic.
+ *
+ * \remark    The radio receives in continuous mode on one channel and
+ *            spreading factor. Every frame is pushed by the Rx done event into
+ *            a single producer / single consumer ring and streamed out of the
+ *            UART by DMA, so that the reception never waits for the UART.
+ *
+ *            Record format, little endian:
+ *            Offset Size
+ *            0      2    Sync 0xA5 0x5A
+ *            2      1    Payload size
+ *            3      1    Flags [SNIFFER_FLAG_CRC_ERROR, SNIFFER_FLAG_DROPPED]
+ *            4      4    Timestamp [ms]
+ *            8      4    Frequency [Hz]
+ *            12     1    Spreading factor
+ *            13     1    Bandwidth [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+ *            14     2    RSSI [dBm]
+ *            16     1    SNR [dB]
+ *            17     1    Frames dropped since the previous record ( saturated )
+ *            18     n    Payload
+ *            18 + n 2    CRC-16/CCITT of the bytes from offset 2 to 18 + n - 1
+ *
+ *            A frame received with a CRC error is reported as a record
+ *            without payload and with SNIFFER_FLAG_CRC_ERROR set.
+ *            tools/sniffer2pcap.py converts the stream for Wireshark.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board-config.h"
+#include "board.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "sim-radio.h"
+#include "host-board.h"
+
+#if defined( REGION_AS923 )
+
+#define RF_FREQUENCY                                923200000 // Hz
+
+#elif defined( REGION_AU915 )
+
+#define RF_FREQUENCY                                915200000 // Hz
+
+#elif defined( REGION_CN470 )
+
+#define RF_FREQUENCY                                470300000 // Hz
+
+#elif defined( REGION_CN779 )
+
+#define RF_FREQUENCY                                779500000 // Hz
+
+#elif defined( REGION_EU433 )
+
+#define RF_FREQUENCY                                433175000 // Hz
+
+#elif defined( REGION_EU868 )
+
+#define RF_FREQUENCY                                868100000 // Hz
+
+#elif defined( REGION_KR920 )
+
+#define RF_FREQUENCY                                922100000 // Hz
+
+#elif defined( REGION_IN865 )
+
+#define RF_FREQUENCY                                865062500 // Hz
+
+#elif defined( REGION_US915 )
+
+#define RF_FREQUENCY                                902300000 // Hz
+
+#elif defined( REGION_RU864 )
+
+#define RF_FREQUENCY                                868900000 // Hz
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+#define LORA_BANDWIDTH                              0         // [0: 125 kHz,
+                                                              //  1: 250 kHz,
+                                                              //  2: 500 kHz,
+                                                              //  3: Reserved]
+#define LORA_SPREADING_FACTOR                       7         // [SF7..SF12]
+#define LORA_CODINGRATE                             1         // [1: 4/5,
+                                                              //  2: 4/6,
+                                                              //  3: 4/7,
+                                                              //  4: 4/8]
+#define LORA_PREAMBLE_LENGTH                        8         // Same for Tx and Rx
+#define LORA_SYMBOL_TIMEOUT                         0         // Symbols
+#define LORA_FIX_LENGTH_PAYLOAD_ON                  false
+#define LORA_IQ_INVERSION_ON                        false     // [false: uplinks, true: downlinks]
+#define LORA_PUBLIC_NETWORK                         true
+
+/*!
+ * Stream UART
+ */
+#define SNIFFER_UART_BAUDRATE                       921600
+
+/*!
+ * Number of records held by the ring. Must be a power of 2.
+ */
+#define SNIFFER_RING_SIZE                           16
+
+#define SNIFFER_HEADER_SIZE                         18
+#define SNIFFER_CRC_SIZE                            2
+#define SNIFFER_MAX_PAYLOAD_SIZE                    255
+
+/*!
+ * Record flags
+ */
+#define SNIFFER_FLAG_CRC_ERROR                      0x01
+#define SNIFFER_FLAG_DROPPED                        0x02
+
+/*!
+ * Simulated traffic: device position [m], uplinks and period [ms]
+ */
+#define TRAFFIC_DEVICE_DISTANCE                     10
+#define TRAFFIC_FRAMES                              20
+#define TRAFFIC_PERIOD                              200
+#define TRAFFIC_SIZE                                23
+
+/*!
+ * Uplink collided by the interferer, interferer position [m] and start
+ * offset into the uplink [us]
+ */
+#define TRAFFIC_COLLIDED_FRAME                      10
+#define TRAFFIC_INTERFERER_DISTANCE                 12
+#define TRAFFIC_INTERFERER_OFFSET                   10000
+
+/*!
+ * Uplink after which the private network node sends, start offset after
+ * the end of the uplink [us]
+ */
+#define TRAFFIC_PRIVATE_FRAME                       5
+#define TRAFFIC_PRIVATE_OFFSET                      50000
+
+typedef struct sSnifferRecord
+{
+    uint16_t Size;
+    uint8_t Data[SNIFFER_HEADER_SIZE + SNIFFER_MAX_PAYLOAD_SIZE + SNIFFER_CRC_SIZE];
+}SnifferRecord_t;
+
+/*!
+ * Ring of records. Head is only written by the producer ( radio events ),
+ * Tail only by the consumer ( stream ).
+ */
+static SnifferRecord_t Ring[SNIFFER_RING_SIZE];
+static volatile uint32_t RingHead = 0;
+static volatile uint32_t RingTail = 0;
+
+/*!
+ * Frames dropped because the ring was full, not yet reported
+ */
+static uint32_t Dropped = 0;
+
+/*!
+ * Stream file and UART transfer of the record being sent
+ */
+static FILE* Stream = NULL;
+static TimerEvent_t StreamTimer;
+static bool IsStreaming = false;
+static bool IsStreamBusy = false;
+
+/*!
+ * Simulated traffic nodes
+ */
+static struct
+{
+    SimNode_t Device;
+    SimNode_t Interferer;
+    SimNode_t Private;
+    SimModulation_t Modulation;
+    SimTime_t PreambleTime;
+    SimTime_t TimeOnAir;
+    uint16_t Sent;
+    uint8_t Buffer[TRAFFIC_SIZE];
+}Traffic;
+
+/*!
+ * Radio events function pointer
+ */
+static RadioEvents_t RadioEvents;
+
+/*!
+ * \brief Function to be executed on Radio Rx Done event
+ */
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * \brief Function executed on Radio Rx Error event
+ */
+static void OnRxError( void );
+
+/*!
+ * \brief Function executed on stream UART transfer timer event
+ */
+static void OnStreamTimerEvent( void* context );
+
+/*!
+ * \brief Adds the traffic nodes to the medium and schedules the first uplink
+ */
+static void TrafficInit( void );
+
+static uint16_t SnifferCrc16( const uint8_t* data, uint16_t size )
+{
+    uint16_t crc = 0xFFFF;
+
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        crc ^= ( uint16_t )data[i] << 8;
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( ( crc << 1 ) ^ 0x1021 ) : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Writes a record into the ring
+ *
+ * \param [IN] payload Payload [NULL: none]
+ * \param [IN] size    Payload size
+ * \param [IN] rssi    Packet RSSI
+ * \param [IN] snr     Packet SNR
+ * \param [IN] flags   Record flags
+ */
+static void SnifferPush( const uint8_t* payload, uint8_t size, int16_t rssi, int8_t snr, uint8_t flags )
+{
+    uint32_t head = RingHead;
+    SnifferRecord_t* record;
+    uint32_t timestamp;
+    uint16_t crc;
+
+    if( ( head - RingTail ) >= SNIFFER_RING_SIZE )
+    {
+        Dropped++;
+        return;
+    }
+
+    record = &Ring[head & ( SNIFFER_RING_SIZE - 1 )];
+    timestamp = TimerGetCurrentTime( );
+    if( Dropped > 0 )
+    {
+        flags |= SNIFFER_FLAG_DROPPED;
+    }
+
+    record->Data[0] = 0xA5;
+    record->Data[1] = 0x5A;
+    record->Data[2] = size;
+    record->Data[3] = flags;
+    record->Data[4] = timestamp & 0xFF;
+    record->Data[5] = ( timestamp >> 8 ) & 0xFF;
+    record->Data[6] = ( timestamp >> 16 ) & 0xFF;
+    record->Data[7] = ( timestamp >> 24 ) & 0xFF;
+    record->Data[8] = RF_FREQUENCY & 0xFF;
+    record->Data[9] = ( RF_FREQUENCY >> 8 ) & 0xFF;
+    record->Data[10] = ( RF_FREQUENCY >> 16 ) & 0xFF;
+    record->Data[11] = ( RF_FREQUENCY >> 24 ) & 0xFF;
+    record->Data[12] = LORA_SPREADING_FACTOR;
+    record->Data[13] = LORA_BANDWIDTH;
+    record->Data[14] = ( uint16_t )rssi & 0xFF;
+    record->Data[15] = ( ( uint16_t )rssi >> 8 ) & 0xFF;
+    record->Data[16] = ( uint8_t )snr;
+    record->Data[17] = ( Dropped > 0xFF ) ? 0xFF : Dropped;
+    if( size > 0 )
+    {
+        memcpy( record->Data + SNIFFER_HEADER_SIZE, payload, size );
+    }
+    crc = SnifferCrc16( record->Data + 2, SNIFFER_HEADER_SIZE - 2 + size );
+    record->Data[SNIFFER_HEADER_SIZE + size] = crc & 0xFF;
+    record->Data[SNIFFER_HEADER_SIZE + size + 1] = crc >> 8;
+    record->Size = SNIFFER_HEADER_SIZE + size + SNIFFER_CRC_SIZE;
+    Dropped = 0;
+
+    // Publish the record once it is complete
+    __sync_synchronize( );
+    RingHead = head + 1;
+}
+
+static void SnifferStreamInit( const char* path )
+{
+    Stream = fopen( path, "wb" );
+    if( Stream == NULL )
+    {
+        perror( path );
+        exit( EXIT_FAILURE );
+    }
+    TimerInit( &StreamTimer, OnStreamTimerEvent );
+}
+
+/*!
+ * \brief Releases the record sent by the UART and starts sending the next one
+ */
+static void SnifferStreamProcess( void )
+{
+    uint32_t tail = RingTail;
+    SnifferRecord_t* record;
+
+    if( IsStreaming == true )
+    {
+        if( IsStreamBusy == true )
+        {
+            return;
+        }
+        IsStreaming = false;
+        RingTail = ++tail;
+    }
+
+    if( tail == RingHead )
+    {
+        return;
+    }
+    __sync_synchronize( );
+
+    record = &Ring[tail & ( SNIFFER_RING_SIZE - 1 )];
+    IsStreaming = true;
+    IsStreamBusy = true;
+    fwrite( record->Data, 1, record->Size, Stream );
+    printf( "REC,%u,%u,%lu,%d,%d,%u\r\n", record->Data[2], record->Data[3],
+            ( unsigned long )( record->Data[4] | ( record->Data[5] << 8 ) | ( record->Data[6] << 16 ) |
+                               ( ( uint32_t )record->Data[7] << 24 ) ),
+            ( int16_t )( record->Data[14] | ( record->Data[15] << 8 ) ), ( int8_t )record->Data[16],
+            record->Data[17] );
+
+    // 10 bits per byte, rounded up to the 1 ms timer resolution
+    TimerSetValue( &StreamTimer, ( ( uint32_t )record->Size * 10000 + SNIFFER_UART_BAUDRATE - 1 ) / SNIFFER_UART_BAUDRATE );
+    TimerStart( &StreamTimer );
+}
+
+/**
+ * Main application entry point.
+ */
+int main( int argc, char* argv[] )
+{
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <stream file>\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    // Target board initialization
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# SNIFFER,host\r\n" );
+
+    SnifferStreamInit( argv[1] );
+    TrafficInit( );
+
+    // Radio initialization
+    RadioEvents.RxDone = OnRxDone;
+    RadioEvents.RxError = OnRxError;
+
+    Radio.Init( &RadioEvents );
+
+    Radio.SetChannel( RF_FREQUENCY );
+    Radio.SetPublicNetwork( LORA_PUBLIC_NETWORK );
+
+    Radio.SetRxConfig( MODEM_LORA, LORA_BANDWIDTH, LORA_SPREADING_FACTOR,
+                                   LORA_CODINGRATE, 0, LORA_PREAMBLE_LENGTH,
+                                   LORA_SYMBOL_TIMEOUT, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                   0, true, 0, 0, LORA_IQ_INVERSION_ON, true );
+
+    Radio.SetMaxPayloadLength( MODEM_LORA, SNIFFER_MAX_PAYLOAD_SIZE );
+
+    // Continuous reception, the radio stays in Rx after each frame
+    Radio.Rx( 0 );
+
+    while( 1 )
+    {
+        SnifferStreamProcess( );
+
+#if BOARD_CONFIG_ENTER_LOW_POWER
+        BoardLowPowerHandler( );
+#endif
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    SnifferPush( payload, ( size > SNIFFER_MAX_PAYLOAD_SIZE ) ? SNIFFER_MAX_PAYLOAD_SIZE : size, rssi, snr, 0 );
+}
+
+static void OnRxError( void )
+{
+    SnifferPush( NULL, 0, 0, 0, SNIFFER_FLAG_CRC_ERROR );
+}
+
+static void OnStreamTimerEvent( void* context )
+{
+    TimerStop( &StreamTimer );
+    IsStreamBusy = false;
+}
+
+/*!
+ * \brief Sends a traffic frame now
+ */
+static void TrafficSend( SimNode_t* node, const SimModulation_t* modulation, uint16_t seq )
+{
+    memset( Traffic.Buffer, 0, sizeof( Traffic.Buffer ) );
+    // Unconfirmed data up header, device address, sequence number
+    Traffic.Buffer[0] = 0x40;
+    Traffic.Buffer[1] = ( node == &Traffic.Device ) ? 0x01 : 0x02;
+    Traffic.Buffer[4] = 0x26;
+    Traffic.Buffer[6] = seq & 0xFF;
+    Traffic.Buffer[7] = seq >> 8;
+    SimMediumSend( node, modulation, 14, SimMediumGetTime( ), Traffic.PreambleTime, Traffic.TimeOnAir,
+                   Traffic.Buffer, sizeof( Traffic.Buffer ) );
+}
+
+/*!
+ * \brief Device medium callback: sends the next uplink and schedules the
+ *        interferer and the private network node around it
+ */
+static void TrafficOnDeviceTimer( SimNode_t* node )
+{
+    SimTime_t now = SimMediumGetTime( );
+
+    TrafficSend( node, &Traffic.Modulation, Traffic.Sent );
+    if( Traffic.Sent == TRAFFIC_COLLIDED_FRAME )
+    {
+        SimMediumSetTimer( &Traffic.Interferer, now + TRAFFIC_INTERFERER_OFFSET );
+    }
+    if( Traffic.Sent == TRAFFIC_PRIVATE_FRAME )
+    {
+        SimMediumSetTimer( &Traffic.Private, now + Traffic.TimeOnAir + TRAFFIC_PRIVATE_OFFSET );
+    }
+    Traffic.Sent++;
+    if( Traffic.Sent < TRAFFIC_FRAMES )
+    {
+        SimMediumSetTimer( node, now + ( SimTime_t )TRAFFIC_PERIOD * 1000 );
+    }
+}
+
+static void TrafficOnInterfererTimer( SimNode_t* node )
+{
+    TrafficSend( node, &Traffic.Modulation, 0 );
+}
+
+static void TrafficOnPrivateTimer( SimNode_t* node )
+{
+    SimModulation_t modulation = Traffic.Modulation;
+
+    modulation.SyncWord = 0x12;
+    TrafficSend( node, &modulation, 0 );
+}
+
+static void TrafficInit( void )
+{
+    // Public network uplinks, preamble plus the 4.25 symbols of the hardware
+    Traffic.Modulation.Modem = MODEM_LORA;
+    Traffic.Modulation.Frequency = RF_FREQUENCY;
+    Traffic.Modulation.Bandwidth = 125000UL << LORA_BANDWIDTH;
+    Traffic.Modulation.Datarate = LORA_SPREADING_FACTOR;
+    Traffic.Modulation.IqInverted = LORA_IQ_INVERSION_ON;
+    Traffic.Modulation.SyncWord = 0x34;
+    Traffic.PreambleTime = ( ( ( SimTime_t )LORA_PREAMBLE_LENGTH * 4 + 17 ) * ( 1000000UL << LORA_SPREADING_FACTOR ) ) /
+                           ( 4 * Traffic.Modulation.Bandwidth );
+    Traffic.TimeOnAir = ( SimTime_t )Radio.TimeOnAir( MODEM_LORA, LORA_BANDWIDTH, LORA_SPREADING_FACTOR, LORA_CODINGRATE,
+                                                      LORA_PREAMBLE_LENGTH, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                                      TRAFFIC_SIZE, true ) * 1000;
+
+    Traffic.Device.X = TRAFFIC_DEVICE_DISTANCE;
+    Traffic.Device.Timer = TrafficOnDeviceTimer;
+    Traffic.Interferer.X = TRAFFIC_INTERFERER_DISTANCE;
+    Traffic.Interferer.Timer = TrafficOnInterfererTimer;
+    Traffic.Private.X = TRAFFIC_DEVICE_DISTANCE;
+    Traffic.Private.Timer = TrafficOnPrivateTimer;
+    SimMediumAddNode( &Traffic.Device );
+    SimMediumAddNode( &Traffic.Interferer );
+    SimMediumAddNode( &Traffic.Private );
+
+    SimMediumSetTimer( &Traffic.Device, SimMediumGetTime( ) + ( SimTime_t )TRAFFIC_PERIOD * 1000 );
+}
@@ -0,0 +1,338 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Single channel sniffer implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The radio receives in continuous mode on one channel and
+ *            spreading factor. Every frame is pushed by the Rx done event into
+ *            a single producer / single consumer ring and streamed out of the
+ *            UART by DMA, so that the reception never waits for the UART.
+ *
+ *            Record format, little endian:
+ *            Offset Size
+ *            0      2    Sync 0xA5 0x5A
+ *            2      1    Payload size
+ *            3      1    Flags [SNIFFER_FLAG_CRC_ERROR, SNIFFER_FLAG_DROPPED]
+ *            4      4    Timestamp [ms]
+ *            8      4    Frequency [Hz]
+ *            12     1    Spreading factor
+ *            13     1    Bandwidth [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+ *            14     2    RSSI [dBm]
+ *            16     1    SNR [dB]
+ *            17     1    Frames dropped since the previous record ( saturated )
+ *            18     n    Payload
+ *            18 + n 2    CRC-16/CCITT of the bytes from offset 2 to 18 + n - 1
+ *
+ *            A frame received with a CRC error is reported as a record
+ *            without payload and with SNIFFER_FLAG_CRC_ERROR set.
+ *            tools/sniffer2pcap.py converts the stream for Wireshark.
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+#include "board.h"
+#include "sx-gpio.h"
+#include "sx-timer.h"
+#include "radio.h"
+
+#include "RP2040-platform.h"
+
+#if defined( REGION_AS923 )
+
+#define RF_FREQUENCY                                923200000 // Hz
+
+#elif defined( REGION_AU915 )
+
+#define RF_FREQUENCY                                915200000 // Hz
+
+#elif defined( REGION_CN470 )
+
+#define RF_FREQUENCY                                470300000 // Hz
+
+#elif defined( REGION_CN779 )
+
+#define RF_FREQUENCY                                779500000 // Hz
+
+#elif defined( REGION_EU433 )
+
+#define RF_FREQUENCY                                433175000 // Hz
+
+#elif defined( REGION_EU868 )
+
+#define RF_FREQUENCY                                868100000 // Hz
+
+#elif defined( REGION_KR920 )
+
+#define RF_FREQUENCY                                922100000 // Hz
+
+#elif defined( REGION_IN865 )
+
+#define RF_FREQUENCY                                865062500 // Hz
+
+#elif defined( REGION_US915 )
+
+#define RF_FREQUENCY                                902300000 // Hz
+
+#elif defined( REGION_RU864 )
+
+#define RF_FREQUENCY                                868900000 // Hz
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+#define LORA_BANDWIDTH                              0         // [0: 125 kHz,
+                                                              //  1: 250 kHz,
+                                                              //  2: 500 kHz,
+                                                              //  3: Reserved]
+#define LORA_SPREADING_FACTOR                       7         // [SF7..SF12]
+#define LORA_CODINGRATE                             1         // [1: 4/5,
+                                                              //  2: 4/6,
+                                                              //  3: 4/7,
+                                                              //  4: 4/8]
+#define LORA_PREAMBLE_LENGTH                        8         // Same for Tx and Rx
+#define LORA_SYMBOL_TIMEOUT                         0         // Symbols
+#define LORA_FIX_LENGTH_PAYLOAD_ON                  false
+#define LORA_IQ_INVERSION_ON                        false     // [false: uplinks, true: downlinks]
+#define LORA_PUBLIC_NETWORK                         true
+
+/*!
+ * Stream UART
+ */
+#define SNIFFER_UART                                uart0
+#define SNIFFER_UART_TX_PIN                         PICO_DEFAULT_UART_TX_PIN
+#define SNIFFER_UART_BAUDRATE                       921600
+
+/*!
+ * Number of records held by the ring. Must be a power of 2.
+ */
+#define SNIFFER_RING_SIZE                           16
+
+#define SNIFFER_HEADER_SIZE                         18
+#define SNIFFER_CRC_SIZE                            2
+#define SNIFFER_MAX_PAYLOAD_SIZE                    255
+
+/*!
+ * Record flags
+ */
+#define SNIFFER_FLAG_CRC_ERROR                      0x01
+#define SNIFFER_FLAG_DROPPED                        0x02
+
+typedef struct sSnifferRecord
+{
+    uint16_t Size;
+    uint8_t Data[SNIFFER_HEADER_SIZE + SNIFFER_MAX_PAYLOAD_SIZE + SNIFFER_CRC_SIZE];
+}SnifferRecord_t;
+
+/*!
+ * Ring of records. Head is only written by the producer ( radio events ),
+ * Tail only by the consumer ( stream ).
+ */
+static SnifferRecord_t Ring[SNIFFER_RING_SIZE];
+static volatile uint32_t RingHead = 0;
+static volatile uint32_t RingTail = 0;
+
+/*!
+ * Frames dropped because the ring was full, not yet reported
+ */
+static uint32_t Dropped = 0;
+
+/*!
+ * DMA channel feeding the UART
+ */
+static int DmaChannel = -1;
+static bool IsStreaming = false;
+
+/*!
+ * Radio events function pointer
+ */
+static RadioEvents_t RadioEvents;
+
+/*!
+ * \brief Function to be executed on Radio Rx Done event
+ */
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*!
+ * \brief Function executed on Radio Rx Error event
+ */
+static void OnRxError( void );
+
+static uint16_t SnifferCrc16( const uint8_t* data, uint16_t size )
+{
+    uint16_t crc = 0xFFFF;
+
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        crc ^= ( uint16_t )data[i] << 8;
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( ( crc << 1 ) ^ 0x1021 ) : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Writes a record into the ring
+ *
+ * \param [IN] payload Payload [NULL: none]
+ * \param [IN] size    Payload size
+ * \param [IN] rssi    Packet RSSI
+ * \param [IN] snr     Packet SNR
+ * \param [IN] flags   Record flags
+ */
+static void SnifferPush( const uint8_t* payload, uint8_t size, int16_t rssi, int8_t snr, uint8_t flags )
+{
+    uint32_t head = RingHead;
+    SnifferRecord_t* record;
+    uint32_t timestamp;
+    uint16_t crc;
+
+    if( ( head - RingTail ) >= SNIFFER_RING_SIZE )
+    {
+        Dropped++;
+        return;
+    }
+
+    record = &Ring[head & ( SNIFFER_RING_SIZE - 1 )];
+    timestamp = TimerGetCurrentTime( );
+    if( Dropped > 0 )
+    {
+        flags |= SNIFFER_FLAG_DROPPED;
+    }
+
+    record->Data[0] = 0xA5;
+    record->Data[1] = 0x5A;
+    record->Data[2] = size;
+    record->Data[3] = flags;
+    record->Data[4] = timestamp & 0xFF;
+    record->Data[5] = ( timestamp >> 8 ) & 0xFF;
+    record->Data[6] = ( timestamp >> 16 ) & 0xFF;
+    record->Data[7] = ( timestamp >> 24 ) & 0xFF;
+    record->Data[8] = RF_FREQUENCY & 0xFF;
+    record->Data[9] = ( RF_FREQUENCY >> 8 ) & 0xFF;
+    record->Data[10] = ( RF_FREQUENCY >> 16 ) & 0xFF;
+    record->Data[11] = ( RF_FREQUENCY >> 24 ) & 0xFF;
+    record->Data[12] = LORA_SPREADING_FACTOR;
+    record->Data[13] = LORA_BANDWIDTH;
+    record->Data[14] = ( uint16_t )rssi & 0xFF;
+    record->Data[15] = ( ( uint16_t )rssi >> 8 ) & 0xFF;
+    record->Data[16] = ( uint8_t )snr;
+    record->Data[17] = ( Dropped > 0xFF ) ? 0xFF : Dropped;
+    if( size > 0 )
+    {
+        memcpy( record->Data + SNIFFER_HEADER_SIZE, payload, size );
+    }
+    crc = SnifferCrc16( record->Data + 2, SNIFFER_HEADER_SIZE - 2 + size );
+    record->Data[SNIFFER_HEADER_SIZE + size] = crc & 0xFF;
+    record->Data[SNIFFER_HEADER_SIZE + size + 1] = crc >> 8;
+    record->Size = SNIFFER_HEADER_SIZE + size + SNIFFER_CRC_SIZE;
+    Dropped = 0;
+
+    // Publish the record once it is complete
+    __dmb( );
+    RingHead = head + 1;
+}
+
+static void SnifferStreamInit( void )
+{
+    dma_channel_config config;
+
+    uart_init( SNIFFER_UART, SNIFFER_UART_BAUDRATE );
+    gpio_set_function( SNIFFER_UART_TX_PIN, GPIO_FUNC_UART );
+
+    DmaChannel = dma_claim_unused_channel( true );
+    config = dma_channel_get_default_config( DmaChannel );
+    channel_config_set_transfer_data_size( &config, DMA_SIZE_8 );
+    channel_config_set_read_increment( &config, true );
+    channel_config_set_write_increment( &config, false );
+    channel_config_set_dreq( &config, uart_get_dreq( SNIFFER_UART, true ) );
+    dma_channel_set_config( DmaChannel, &config, false );
+    dma_channel_set_write_addr( DmaChannel, &uart_get_hw( SNIFFER_UART )->dr, false );
+}
+
+/*!
+ * \brief Releases the record sent by the DMA and starts sending the next one
+ */
+static void SnifferStreamProcess( void )
+{
+    uint32_t tail = RingTail;
+    SnifferRecord_t* record;
+
+    if( IsStreaming == true )
+    {
+        if( dma_channel_is_busy( DmaChannel ) == true )
+        {
+            return;
+        }
+        IsStreaming = false;
+        RingTail = ++tail;
+    }
+
+    if( tail == RingHead )
+    {
+        return;
+    }
+    __dmb( );
+
+    record = &Ring[tail & ( SNIFFER_RING_SIZE - 1 )];
+    IsStreaming = true;
+    dma_channel_transfer_from_buffer_now( DmaChannel, record->Data, record->Size );
+}
+
+/**
+ * Main application entry point.
+ */
+int main( void )
+{
+    // Target board initialization
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    SnifferStreamInit( );
+
+    // Radio initialization
+    RadioEvents.RxDone = OnRxDone;
+    RadioEvents.RxError = OnRxError;
+
+    Radio.Init( &RadioEvents );
+
+    Radio.SetChannel( RF_FREQUENCY );
+    Radio.SetPublicNetwork( LORA_PUBLIC_NETWORK );
+
+    Radio.SetRxConfig( MODEM_LORA, LORA_BANDWIDTH, LORA_SPREADING_FACTOR,
+                                   LORA_CODINGRATE, 0, LORA_PREAMBLE_LENGTH,
+                                   LORA_SYMBOL_TIMEOUT, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                   0, true, 0, 0, LORA_IQ_INVERSION_ON, true );
+
+    Radio.SetMaxPayloadLength( MODEM_LORA, SNIFFER_MAX_PAYLOAD_SIZE );
+
+    // Continuous reception, the radio stays in Rx after each frame
+    Radio.Rx( 0 );
+
+    while( 1 )
+    {
+        SnifferStreamProcess( );
+
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+static void OnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    SnifferPush( payload, ( size > SNIFFER_MAX_PAYLOAD_SIZE ) ? SNIFFER_MAX_PAYLOAD_SIZE : size, rssi, snr, 0 );
+}
+
+static void OnRxError( void )
+{
+    SnifferPush( NULL, 0, 0, 0, SNIFFER_FLAG_CRC_ERROR );
+}
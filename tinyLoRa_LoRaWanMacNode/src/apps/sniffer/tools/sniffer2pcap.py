@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+##
+## Converts the sniffer application frame stream to a PCAP file with LoRaTap
+## headers ( LINKTYPE_LORATAP ), decoded by the Wireshark LoRaTap and LoRaWAN
+## dissectors.
+##
+## Usage:
+##   stty -F /dev/ttyUSB0 921600 raw
+##   sniffer2pcap.py /dev/ttyUSB0 capture.pcap
+##   sniffer2pcap.py /dev/ttyUSB0 - | wireshark -k -i -
+##
+## Records with a CRC error are counted but not written. Dropped frames
+## reported by the device are counted.
+##
+
+import struct
+import sys
+import time
+
+SYNC = b"\xA5\x5A"
+HEADER_SIZE = 18
+CRC_SIZE = 2
+
+FLAG_CRC_ERROR = 0x01
+
+LINKTYPE_LORATAP = 270
+
+LORAWAN_PUBLIC_SYNC_WORD = 0x34
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def records(stream):
+    """Yields the valid records of the stream, resynchronizing on errors."""
+    buffer = b""
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+        if not chunk:
+            return
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                buffer = buffer[-1:]
+                break
+            buffer = buffer[start:]
+            if len(buffer) < HEADER_SIZE:
+                break
+            size = HEADER_SIZE + buffer[2] + CRC_SIZE
+            if len(buffer) < size:
+                break
+            record = buffer[:size]
+            (crc,) = struct.unpack_from("<H", record, size - CRC_SIZE)
+            if crc != crc16(record[2:size - CRC_SIZE]):
+                # Not a record start, skip the sync bytes
+                buffer = buffer[1:]
+                continue
+            buffer = buffer[size:]
+            yield record
+
+
+def loratap_header(frequency, bandwidth, sf, rssi, snr):
+    rssi_field = max(0, min(255, rssi + 139))
+    return struct.pack(">BBHIBBBBBbB", 0, 0, 15, frequency, 1 << bandwidth, sf,
+                       rssi_field, rssi_field, 255, max(-128, min(127, snr * 4)),
+                       LORAWAN_PUBLIC_SYNC_WORD)
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write("usage: %s <stream> <pcap | ->\n" % argv[0])
+        return 1
+
+    source = open(argv[1], "rb", buffering=0)
+    output = sys.stdout.buffer if argv[2] == "-" else open(argv[2], "wb")
+
+    # PCAP global header
+    output.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, LINKTYPE_LORATAP))
+    output.flush()
+
+    origin = None
+    frames = 0
+    crc_errors = 0
+    dropped = 0
+    try:
+        for record in records(source):
+            size, flags, timestamp, frequency, sf, bandwidth, rssi, snr, lost = \
+                struct.unpack_from("<BBIIBBhbB", record, 2)
+            dropped += lost
+            if flags & FLAG_CRC_ERROR:
+                crc_errors += 1
+                continue
+            if origin is None:
+                origin = time.time() - timestamp / 1000.0
+            packet = loratap_header(frequency, bandwidth, sf, rssi, snr) + \
+                record[HEADER_SIZE:HEADER_SIZE + size]
+            seconds = origin + timestamp / 1000.0
+            output.write(struct.pack("<IIII", int(seconds), int((seconds % 1) * 1000000),
+                                     len(packet), len(packet)))
+            output.write(packet)
+            output.flush()
+            frames += 1
+    except KeyboardInterrupt:
+        pass
+
+    sys.stderr.write("frames %d, crc errors %d, dropped %d\n" % (frames, crc_errors, dropped))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
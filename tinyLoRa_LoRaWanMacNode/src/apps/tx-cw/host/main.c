@@ -0,0 +1,612 @@
+/*!
+ * \file      main.c
+ *
+ * \brief     Tx continuous wave and Tx power sweep implementation on the
+ *            host board
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs the Tx continuous wave test of the tinyLoRa board over the
+ *            simulated radio medium. The commands are read from the script
+ *            given as program argument ( see HostBoardGetCommand ), which
+ *            also drives a bench node 1 m away from the device, standing for
+ *            the power meter and the receiver of the bench:
+ *
+ *            meter                      Prints the output power seen by the bench
+ *            listen <sf> <bw>           Counts the test frames of the configuration
+ *            count                      Prints the test frames counted
+ *
+ *            Records of the bench:
+ *            METER,power                Output power [dBm, noise floor when off]
+ *            COUNT,received,last_seq    Test frames counted since "listen"
+ *
+ * \remark    The device emits a continuous wave at the requested power, or
+ *            sweeps the Tx power, while the test bench measures the output
+ *            power and the supply current. The measured current is given back
+ *            with "cur" and is reported with the step. The "pkt" command sends
+ *            the test frames counted by the rx-sensi application.
+ *
+ *            Commands, one per line:
+ *            freq <Hz>                        Sets the RF frequency
+ *            cw <power> <s>                   Continuous wave at <power> dBm for <s> seconds
+ *            sweep <from> <to> <step> <s>     Continuous wave from <from> to <to> dBm,
+ *                                             <s> seconds per step
+ *            cur <mA>                         Annotates the running step with the
+ *                                             measured supply current
+ *            stop                             Stops the emission
+ *            pkt <sf> <bw> <power> <count> [size] [gap ms]
+ *                                             Sends <count> test frames
+ *            help                             Prints the commands
+ *
+ *            Every command is answered by "OK" or "ERR,<reason>". Records:
+ *            CW,step,freq,power,time_s       Step started
+ *            CWEND,step,power,current_ma     Step ended [current_ma: '-' when not annotated]
+ *            PKTEND,sf,bw,power,sent,size    Test frames sent
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board-config.h"
+#include "board.h"
+#include "sx-delay.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "sim-radio.h"
+#include "host-board.h"
+
+#if defined( REGION_AS923 )
+
+#define RF_FREQUENCY                                923000000 // Hz
+
+#elif defined( REGION_AU915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_CN470 )
+
+#define RF_FREQUENCY                                470000000 // Hz
+
+#elif defined( REGION_CN779 )
+
+#define RF_FREQUENCY                                779000000 // Hz
+
+#elif defined( REGION_EU433 )
+
+#define RF_FREQUENCY                                433000000 // Hz
+
+#elif defined( REGION_EU868 )
+
+#define RF_FREQUENCY                                868000000 // Hz
+
+#elif defined( REGION_KR920 )
+
+#define RF_FREQUENCY                                920000000 // Hz
+
+#elif defined( REGION_IN865 )
+
+#define RF_FREQUENCY                                865000000 // Hz
+
+#elif defined( REGION_US915 )
+
+#define RF_FREQUENCY                                915000000 // Hz
+
+#elif defined( REGION_RU864 )
+
+#define RF_FREQUENCY                                864000000 // Hz
+
+#else
+    #error "Please define a frequency band in the compiler options."
+#endif
+
+#define LORA_CODINGRATE                             1         // [1: 4/5,
+                                                              //  2: 4/6,
+                                                              //  3: 4/7,
+                                                              //  4: 4/8]
+#define LORA_PREAMBLE_LENGTH                        8         // Same for Tx and Rx
+#define LORA_FIX_LENGTH_PAYLOAD_ON                  false
+#define LORA_IQ_INVERSION_ON                        false
+
+/*!
+ * Test frame: "SENS", 16 bits sequence number ( LSB first ), padding.
+ * Same layout as the rx-sensi application.
+ */
+#define PKT_HEADER_SIZE                             6
+#define PKT_DEFAULT_SIZE                            16
+#define PKT_DEFAULT_GAP                             100       // ms
+
+/*!
+ * Bandwidth of the bench power meter [Hz]
+ */
+#define METER_BANDWIDTH                             125000
+
+typedef enum
+{
+    TXCW_STATE_IDLE,
+    TXCW_STATE_CW,
+    TXCW_STATE_PKT,
+}TxCwStates_t;
+
+typedef enum
+{
+    TXCW_EVENT_NONE,
+    TXCW_EVENT_TX_DONE,
+    TXCW_EVENT_TX_TIMEOUT,
+    TXCW_EVENT_GAP,
+}TxCwEvents_t;
+
+const uint8_t SensiMsg[] = "SENS";
+
+static uint32_t Frequency = RF_FREQUENCY;
+
+static volatile TxCwEvents_t Event = TXCW_EVENT_NONE;
+static TxCwStates_t State = TXCW_STATE_IDLE;
+
+/*!
+ * Continuous wave steps
+ */
+static uint16_t CwStep = 0;
+static int8_t CwPower = 0;
+static int8_t CwLastPower = 0;
+static int8_t CwPowerStep = 0;
+static uint16_t CwTime = 0;
+static int32_t CwCurrent = -1; // Measured current [0.1 mA, -1: not annotated]
+
+/*!
+ * Test frames
+ */
+static uint8_t PktSf = 0;
+static uint8_t PktBw = 0;
+static int8_t PktPower = 0;
+static uint16_t PktCount = 0;
+static uint16_t PktSent = 0;
+static uint8_t PktSize = PKT_DEFAULT_SIZE;
+static uint32_t PktGap = PKT_DEFAULT_GAP;
+static uint8_t Buffer[255];
+
+/*!
+ * Bench node context
+ */
+static struct
+{
+    SimNode_t Node;
+    uint16_t Received;
+    uint16_t LastSeq;
+}Bench;
+
+/*!
+ * Radio events function pointer
+ */
+static RadioEvents_t RadioEvents;
+
+/*!
+ * Timer spacing the test frames
+ */
+static TimerEvent_t GapTimer;
+
+/*!
+ * \brief Function to be executed on Radio Tx Done event
+ */
+static void OnTxDone( void );
+
+/*!
+ * \brief Function executed on Radio Tx Timeout event
+ */
+static void OnTxTimeout( void );
+
+/*!
+ * \brief Function executed on test frame gap timer event
+ */
+static void OnGapTimerEvent( void* context );
+
+/*!
+ * \brief Adds the bench node to the medium
+ */
+static void BenchInit( void );
+
+/*!
+ * \brief Starts counting the test frames of the given configuration
+ */
+static void BenchListen( uint8_t sf, uint8_t bw );
+
+static void CwStart( void )
+{
+    CwCurrent = -1;
+    State = TXCW_STATE_CW;
+    printf( "CW,%u,%lu,%d,%u\r\n", CwStep, ( unsigned long )Frequency, CwPower, CwTime );
+    Radio.SetTxContinuousWave( Frequency, CwPower, CwTime );
+}
+
+static void CwEnd( void )
+{
+    Radio.Standby( );
+    if( CwCurrent < 0 )
+    {
+        printf( "CWEND,%u,%d,-\r\n", CwStep, CwPower );
+    }
+    else
+    {
+        printf( "CWEND,%u,%d,%ld.%ld\r\n", CwStep, CwPower, ( long )( CwCurrent / 10 ), ( long )( CwCurrent % 10 ) );
+    }
+    CwStep++;
+}
+
+static void PktSend( void )
+{
+    memset( Buffer, 0, PktSize );
+    memcpy( Buffer, SensiMsg, 4 );
+    Buffer[4] = PktSent & 0xFF;
+    Buffer[5] = PktSent >> 8;
+    Radio.Send( Buffer, PktSize );
+}
+
+static void PktEnd( void )
+{
+    TimerStop( &GapTimer );
+    Radio.Standby( );
+    State = TXCW_STATE_IDLE;
+    printf( "PKTEND,%u,%u,%d,%u,%u\r\n", PktSf, PktBw, PktPower, PktSent, PktSize );
+}
+
+static void TxCwProcess( void )
+{
+    TxCwEvents_t event;
+
+    CRITICAL_SECTION_BEGIN( );
+    event = Event;
+    Event = TXCW_EVENT_NONE;
+    CRITICAL_SECTION_END( );
+
+    switch( State )
+    {
+    case TXCW_STATE_CW:
+        if( event == TXCW_EVENT_TX_TIMEOUT )
+        {
+            CwEnd( );
+            if( ( CwPowerStep > 0 ) && ( ( CwPower + CwPowerStep ) <= CwLastPower ) )
+            {
+                CwPower += CwPowerStep;
+                CwStart( );
+            }
+            else
+            {
+                State = TXCW_STATE_IDLE;
+            }
+        }
+        break;
+    case TXCW_STATE_PKT:
+        if( ( event == TXCW_EVENT_TX_DONE ) || ( event == TXCW_EVENT_TX_TIMEOUT ) )
+        {
+            if( event == TXCW_EVENT_TX_DONE )
+            {
+                PktSent++;
+            }
+            if( PktSent >= PktCount )
+            {
+                PktEnd( );
+            }
+            else
+            {
+                TimerSetValue( &GapTimer, PktGap );
+                TimerStart( &GapTimer );
+            }
+        }
+        else if( event == TXCW_EVENT_GAP )
+        {
+            PktSend( );
+        }
+        break;
+    case TXCW_STATE_IDLE:
+    default:
+        break;
+    }
+}
+
+static void CmdHelp( void )
+{
+    printf( "# freq <Hz>\r\n" );
+    printf( "# cw <power> <s>\r\n" );
+    printf( "# sweep <from> <to> <step> <s>\r\n" );
+    printf( "# cur <mA>\r\n" );
+    printf( "# stop\r\n" );
+    printf( "# pkt <sf> <bw> <power> <count> [size] [gap ms]\r\n" );
+    printf( "# meter\r\n" );
+    printf( "# listen <sf> <bw>\r\n" );
+    printf( "# count\r\n" );
+}
+
+/*!
+ * \brief Stops the running emission
+ */
+static void CmdStop( void )
+{
+    if( State == TXCW_STATE_CW )
+    {
+        CwEnd( );
+        State = TXCW_STATE_IDLE;
+    }
+    else if( State == TXCW_STATE_PKT )
+    {
+        PktEnd( );
+    }
+}
+
+/*!
+ * \brief Executes a command line
+ *
+ * \retval error Error reason [NULL: success]
+ */
+static const char* CmdExecute( char* line )
+{
+    char* args[6] = { NULL };
+    char* cmd = strtok( line, " " );
+    uint8_t nbArgs = 0;
+
+    if( cmd == NULL )
+    {
+        return "empty";
+    }
+    while( ( nbArgs < 6 ) && ( ( args[nbArgs] = strtok( NULL, " " ) ) != NULL ) )
+    {
+        nbArgs++;
+    }
+
+    if( strcmp( cmd, "freq" ) == 0 )
+    {
+        uint32_t frequency;
+
+        if( nbArgs < 1 )
+        {
+            return "args";
+        }
+        frequency = strtoul( args[0], NULL, 10 );
+        if( Radio.CheckRfFrequency( frequency ) == false )
+        {
+            return "frequency";
+        }
+        Frequency = frequency;
+    }
+    else if( ( strcmp( cmd, "cw" ) == 0 ) || ( strcmp( cmd, "sweep" ) == 0 ) )
+    {
+        bool isSweep = ( cmd[0] == 's' );
+
+        if( nbArgs < ( isSweep ? 4 : 2 ) )
+        {
+            return "args";
+        }
+        CmdStop( );
+        CwPower = ( int8_t )strtol( args[0], NULL, 10 );
+        if( isSweep == true )
+        {
+            CwLastPower = ( int8_t )strtol( args[1], NULL, 10 );
+            CwPowerStep = ( int8_t )strtol( args[2], NULL, 10 );
+            CwTime = ( uint16_t )strtoul( args[3], NULL, 10 );
+            if( ( CwPowerStep <= 0 ) || ( CwLastPower < CwPower ) )
+            {
+                return "range";
+            }
+        }
+        else
+        {
+            CwLastPower = CwPower;
+            CwPowerStep = 0;
+            CwTime = ( uint16_t )strtoul( args[1], NULL, 10 );
+        }
+        if( CwTime == 0 )
+        {
+            return "range";
+        }
+        CwStart( );
+    }
+    else if( strcmp( cmd, "cur" ) == 0 )
+    {
+        if( nbArgs < 1 )
+        {
+            return "args";
+        }
+        if( State != TXCW_STATE_CW )
+        {
+            return "no step";
+        }
+        CwCurrent = ( int32_t )( strtod( args[0], NULL ) * 10.0 + 0.5 );
+    }
+    else if( strcmp( cmd, "stop" ) == 0 )
+    {
+        CmdStop( );
+    }
+    else if( strcmp( cmd, "pkt" ) == 0 )
+    {
+        uint32_t sf;
+        uint32_t bw;
+        uint32_t size = PKT_DEFAULT_SIZE;
+
+        if( nbArgs < 4 )
+        {
+            return "args";
+        }
+        sf = strtoul( args[0], NULL, 10 );
+        bw = strtoul( args[1], NULL, 10 );
+        if( nbArgs > 4 )
+        {
+            size = strtoul( args[4], NULL, 10 );
+        }
+        if( ( sf < 5 ) || ( sf > 12 ) || ( bw > 2 ) || ( size < PKT_HEADER_SIZE ) || ( size > sizeof( Buffer ) ) )
+        {
+            return "range";
+        }
+        CmdStop( );
+        PktSf = sf;
+        PktBw = bw;
+        PktPower = ( int8_t )strtol( args[2], NULL, 10 );
+        PktCount = ( uint16_t )strtoul( args[3], NULL, 10 );
+        PktSize = size;
+        PktGap = ( nbArgs > 5 ) ? strtoul( args[5], NULL, 10 ) : PKT_DEFAULT_GAP;
+        PktSent = 0;
+        if( PktCount == 0 )
+        {
+            return "range";
+        }
+
+        Radio.Standby( );
+        Radio.SetChannel( Frequency );
+        Radio.SetTxConfig( MODEM_LORA, PktPower, 0, PktBw,
+                                       PktSf, LORA_CODINGRATE,
+                                       LORA_PREAMBLE_LENGTH, LORA_FIX_LENGTH_PAYLOAD_ON,
+                                       true, 0, 0, LORA_IQ_INVERSION_ON, 3000 );
+        Radio.SetMaxPayloadLength( MODEM_LORA, PktSize );
+        State = TXCW_STATE_PKT;
+        PktSend( );
+    }
+    else if( strcmp( cmd, "meter" ) == 0 )
+    {
+        SimTime_t now = SimMediumGetTime( );
+        int16_t rssi = SimMediumGetRssi( &Bench.Node, Frequency, METER_BANDWIDTH, now, now );
+
+        // At 1 m the path loss is the reference path loss of the channel model
+        printf( "METER,%d\r\n", rssi + ( int16_t )HostBoardChannelModel.RefPathLoss );
+    }
+    else if( strcmp( cmd, "listen" ) == 0 )
+    {
+        uint32_t sf;
+        uint32_t bw;
+
+        if( nbArgs < 2 )
+        {
+            return "args";
+        }
+        sf = strtoul( args[0], NULL, 10 );
+        bw = strtoul( args[1], NULL, 10 );
+        if( ( sf < 5 ) || ( sf > 12 ) || ( bw > 2 ) )
+        {
+            return "range";
+        }
+        BenchListen( sf, bw );
+    }
+    else if( strcmp( cmd, "count" ) == 0 )
+    {
+        printf( "COUNT,%u,%u\r\n", Bench.Received, Bench.LastSeq );
+    }
+    else if( strcmp( cmd, "help" ) == 0 )
+    {
+        CmdHelp( );
+    }
+    else
+    {
+        return "unknown";
+    }
+    return NULL;
+}
+
+/*!
+ * \brief Executes the command lines of the script due at the virtual time
+ */
+static void CmdProcess( void )
+{
+    char* line;
+
+    while( ( line = HostBoardGetCommand( ) ) != NULL )
+    {
+        const char* error = CmdExecute( line );
+
+        if( error == NULL )
+        {
+            printf( "OK\r\n" );
+        }
+        else
+        {
+            printf( "ERR,%s\r\n", error );
+        }
+    }
+}
+
+/**
+ * Main application entry point.
+ */
+int main( int argc, char* argv[] )
+{
+    HostBoardOpenScript( argc, argv );
+
+    // Target board initialization
+    BoardInitMcu( );
+    BoardInitPeriph( );
+
+    printf( "# TX-CW,host\r\n" );
+
+    BenchInit( );
+
+    TimerInit( &GapTimer, OnGapTimerEvent );
+
+    // Radio initialization
+    RadioEvents.TxDone = OnTxDone;
+    RadioEvents.TxTimeout = OnTxTimeout;
+
+    Radio.Init( &RadioEvents );
+    Radio.Standby( );
+
+    while( 1 )
+    {
+        CmdProcess( );
+        TxCwProcess( );
+
+#if BOARD_CONFIG_ENTER_LOW_POWER
+        BoardLowPowerHandler( );
+#endif
+        // Process Radio IRQ
+        if( Radio.IrqProcess != NULL )
+        {
+            Radio.IrqProcess( );
+        }
+    }
+}
+
+static void OnTxDone( void )
+{
+    Event = TXCW_EVENT_TX_DONE;
+}
+
+static void OnTxTimeout( void )
+{
+    Event = TXCW_EVENT_TX_TIMEOUT;
+}
+
+static void OnGapTimerEvent( void* context )
+{
+    TimerStop( &GapTimer );
+    Event = TXCW_EVENT_GAP;
+}
+
+/*!
+ * \brief Bench medium callback: counts the test frames
+ */
+static void BenchOnRxDone( SimNode_t* node, const uint8_t* payload, uint8_t size, const SimRxInfo_t* info )
+{
+    if( ( size < PKT_HEADER_SIZE ) || ( memcmp( payload, SensiMsg, 4 ) != 0 ) )
+    {
+        return;
+    }
+    Bench.LastSeq = ( uint16_t )payload[4] | ( ( uint16_t )payload[5] << 8 );
+    Bench.Received++;
+}
+
+static void BenchInit( void )
+{
+    Bench.Node.X = 1;
+    Bench.Node.RxDone = BenchOnRxDone;
+    SimMediumAddNode( &Bench.Node );
+}
+
+static void BenchListen( uint8_t sf, uint8_t bw )
+{
+    SimModulation_t modulation;
+
+    // Private network sync word of the radio
+    modulation.Modem = MODEM_LORA;
+    modulation.Frequency = Frequency;
+    modulation.Bandwidth = 125000UL << bw;
+    modulation.Datarate = sf;
+    modulation.IqInverted = LORA_IQ_INVERSION_ON;
+    modulation.SyncWord = 0x12;
+
+    Bench.Received = 0;
+    Bench.LastSeq = 0;
+    SimMediumStartRx( &Bench.Node, &modulation );
+}
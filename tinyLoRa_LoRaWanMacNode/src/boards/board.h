@@ -101,6 +101,13 @@ int16_t BoardGetTemperature( void );
  */
 uint32_t BoardGetRandomSeed( void );
 
+/*!
+ * \brief Gets 32 bits from the board hardware entropy source
+ *
+ * \retval bits Raw entropy bits
+ */
+uint32_t BoardGetEntropy( void );
+
 /*!
  * \brief Gets the board 64 bits unique ID
  *
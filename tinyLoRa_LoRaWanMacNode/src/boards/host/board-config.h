@@ -0,0 +1,30 @@
+/*!
+ * \file      board-config.h
+ *
+ * \brief     Board configuration
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+
+#ifndef __BOARD_CONFIG_H__
+#define __BOARD_CONFIG_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define BOARD_CONFIG_HAS_GNSS             (0)
+  /*!< if board has a GNSS (GPS) or not */
+
+#define BOARD_CONFIG_HAS_SECURE_ELEMENT   (0)
+  /*!< if board has a secure element or not */
+
+#define BOARD_CONFIG_ENTER_LOW_POWER      (1)
+  /*!< if we enter low power mode, advances the virtual time on the host */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BOARD_CONFIG_H__
@@ -0,0 +1,186 @@
+/*!
+ * \file      board.c
+ *
+ * \brief     Target board general functions implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+#include "board-config.h"
+#include "board.h"
+#include "rtc-board.h"
+#include "eeprom-board.h"
+#include "sim-radio.h"
+#include "host-board.h"
+
+const SimChannelModel_t HostBoardChannelModel =
+{
+    .RefPathLoss = 40.0f,
+    .PathLossExponent = 2.7f,
+    .NoiseFigure = 6.0f,
+    .CaptureThreshold = 6.0f,
+    .PacketErrorRate = 0,
+    .Seed = 0,
+};
+
+/*!
+ * Virtual time at which BoardLowPowerHandler ends the process
+ */
+static SimTime_t HostBoardEndTime = SIM_TIME_NEVER;
+
+/*!
+ * Command script, see HostBoardGetCommand
+ */
+static FILE* HostBoardScript = NULL;
+
+/*!
+ * Virtual time at which the next script line is due
+ */
+static SimTime_t HostBoardScriptTime = SIM_TIME_NEVER;
+
+/*!
+ * \brief Initializes the EEPROM emulation
+ *
+ * \remark This function is defined in eeprom-board.c file
+ */
+void EepromMcuInit( void );
+
+void BoardCriticalSectionBegin( uint32_t *mask )
+{
+    // Single threaded, the events are only processed from the main loop
+    *mask = 0;
+}
+
+void BoardCriticalSectionEnd( uint32_t *mask )
+{
+}
+
+void BoardInitPeriph( void )
+{
+}
+
+void BoardInitMcu( void )
+{
+    // Line buffered, the output of a run is read by the test scripts
+    setvbuf( stdout, NULL, _IOLBF, 0 );
+
+    SimMediumInit( &HostBoardChannelModel );
+    RtcInit( );
+    EepromMcuInit( );
+}
+
+void BoardResetMcu( void )
+{
+    // No reset on the host, the run fails
+    exit( EXIT_FAILURE );
+}
+
+void BoardDeInitMcu( void )
+{
+}
+
+uint8_t BoardGetBatteryLevel( void )
+{
+    return 0;
+}
+
+void BoardGetUniqueId( uint8_t *id )
+{
+    static const uint8_t uniqueId[8] = { 0x48, 0x4F, 0x53, 0x54, 0x00, 0x00, 0x00, 0x01 };
+
+    memcpy1( id, uniqueId, sizeof( uniqueId ) );
+}
+
+uint32_t BoardGetRandomSeed( void )
+{
+    return SimMediumRandom( );
+}
+
+uint32_t BoardGetEntropy( void )
+{
+    return SimMediumRandom( );
+}
+
+void HostBoardSetEndTime( SimTime_t time )
+{
+    HostBoardEndTime = time;
+}
+
+void HostBoardParseArgs( int argc, char* argv[] )
+{
+    if( argc > 1 )
+    {
+        HostBoardSetEndTime( strtoull( argv[1], NULL, 10 ) * 1000 );
+    }
+}
+
+void HostBoardOpenScript( int argc, char* argv[] )
+{
+    HostBoardScript = stdin;
+    if( argc > 1 )
+    {
+        HostBoardScript = fopen( argv[1], "r" );
+        if( HostBoardScript == NULL )
+        {
+            perror( argv[1] );
+            exit( EXIT_FAILURE );
+        }
+    }
+    HostBoardScriptTime = 0;
+}
+
+char* HostBoardGetCommand( void )
+{
+    static char line[HOST_BOARD_COMMAND_SIZE];
+
+    while( ( HostBoardScript != NULL ) && ( HostBoardScriptTime <= SimMediumGetTime( ) ) )
+    {
+        if( fgets( line, sizeof( line ), HostBoardScript ) == NULL )
+        {
+            // The run ends once the events due now are processed
+            HostBoardScript = NULL;
+            HostBoardScriptTime = SIM_TIME_NEVER;
+            HostBoardSetEndTime( SimMediumGetTime( ) );
+            break;
+        }
+        line[strcspn( line, "\r\n" )] = '\0';
+        if( strncmp( line, "wait ", 5 ) == 0 )
+        {
+            HostBoardScriptTime = SimMediumGetTime( ) + strtoull( &line[5], NULL, 10 ) * 1000;
+        }
+        else if( ( line[0] != '\0' ) && ( line[0] != '#' ) )
+        {
+            return line;
+        }
+    }
+    return NULL;
+}
+
+void BoardLowPowerHandler( void )
+{
+    SimTime_t next = SimMediumGetNextEventTime( );
+
+    // A pending interrupt wakes the core up at once
+    if( SimRadioIsIrqPending( ) == true )
+    {
+        return;
+    }
+
+    if( RtcGetAlarmTime( ) < next )
+    {
+        next = RtcGetAlarmTime( );
+    }
+    if( HostBoardScriptTime < next )
+    {
+        next = HostBoardScriptTime;
+    }
+    if( ( next == SIM_TIME_NEVER ) || ( next > HostBoardEndTime ) )
+    {
+        fflush( stdout );
+        exit( EXIT_SUCCESS );
+    }
+    RtcRunUntil( next );
+}
@@ -0,0 +1,15 @@
+/*!
+ * \file      delay-board.c
+ *
+ * \brief     Target board delay implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include "delay-board.h"
+#include "rtc-board.h"
+
+void DelayMsMcu( uint32_t ms )
+{
+    // The medium keeps running, as the radio does during a busy wait
+    RtcDelayMs( ms );
+}
@@ -0,0 +1,59 @@
+/*!
+ * \file      eeprom-board.c
+ *
+ * \brief     Target board EEPROM driver implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The EEPROM is kept in RAM and lost at the end of the run.
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "utilities.h"
+#include "eeprom-board.h"
+
+/*!
+ * EEPROM size, the 16 bits address range
+ */
+#define EEPROM_SIZE                                 0x10000
+
+static uint8_t Eeprom[EEPROM_SIZE];
+
+void EepromMcuInit( void )
+{
+    memset( Eeprom, 0xFF, sizeof( Eeprom ) );
+}
+
+bool EepromMcuIsErasingOnGoing( void )
+{
+    return false;
+}
+
+LmnStatus_t EepromMcuWriteBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    if( ( ( uint32_t )addr + size ) > EEPROM_SIZE )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memcpy1( &Eeprom[addr], buffer, size );
+    return LMN_STATUS_OK;
+}
+
+LmnStatus_t EepromMcuReadBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+{
+    if( ( ( uint32_t )addr + size ) > EEPROM_SIZE )
+    {
+        return LMN_STATUS_ERROR;
+    }
+    memcpy1( buffer, &Eeprom[addr], size );
+    return LMN_STATUS_OK;
+}
+
+void EepromMcuSetDeviceAddr( uint8_t addr )
+{
+}
+
+LmnStatus_t EepromMcuGetDeviceAddr( void )
+{
+    return LMN_STATUS_OK;
+}
@@ -0,0 +1,47 @@
+/*!
+ * \file      gpio-board.c
+ *
+ * \brief     Target board GPIO driver implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The host has no pins: writes are ignored, reads return 0 and
+ *            no interrupt is raised.
+ */
+#include <stddef.h>
+#include "utilities.h"
+#include "gpio-board.h"
+
+void GpioMcuInit( Gpio_t *obj, PinNames pin, PinModes mode, PinConfigs config, PinTypes type, uint32_t value )
+{
+    obj->pin = pin;
+    obj->pull = type;
+}
+
+void GpioMcuSetContext( Gpio_t *obj, void* context )
+{
+    obj->Context = context;
+}
+
+void GpioMcuSetInterrupt( Gpio_t *obj, IrqModes irqMode, IrqPriorities irqPriority, GpioIrqHandler *irqHandler )
+{
+    obj->IrqHandler = irqHandler;
+}
+
+void GpioMcuRemoveInterrupt( Gpio_t *obj )
+{
+    obj->IrqHandler = NULL;
+}
+
+void GpioMcuWrite( Gpio_t *obj, uint32_t value )
+{
+}
+
+void GpioMcuToggle( Gpio_t *obj )
+{
+}
+
+uint32_t GpioMcuRead( Gpio_t *obj )
+{
+    return 0;
+}
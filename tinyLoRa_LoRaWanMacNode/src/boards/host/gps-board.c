@@ -0,0 +1,39 @@
+/*!
+ * \file      gps-board.c
+ *
+ * \brief     Target board GPS driver implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The host has no GNSS receiver, no position is ever fixed.
+ */
+#include "utilities.h"
+#include "gps-board.h"
+
+void GpsMcuOnPpsSignal( void* context )
+{
+}
+
+void GpsMcuInvertPpsTrigger( void )
+{
+}
+
+void GpsMcuInit( void )
+{
+}
+
+void GpsMcuStart( void )
+{
+}
+
+void GpsMcuStop( void )
+{
+}
+
+void GpsMcuProcess( void )
+{
+}
+
+void GpsMcuIrqNotify( UartNotifyId_t id )
+{
+}
@@ -0,0 +1,94 @@
+/*!
+ * \file      host-board.h
+ *
+ * \brief     Host board running the stack over the simulated radio medium
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The board builds with -DBOARD=host -DRADIO=sim. The RTC, the
+ *            delays and the low power handler run on the virtual clock of
+ *            the medium, so an application runs as fast as the host can
+ *            process the events. BoardInitMcu initializes the medium with
+ *            HostBoardChannelModel: the application adds its peer nodes
+ *            after it. BoardLowPowerHandler runs the medium up to the next
+ *            event and ends the process once the virtual time reaches the
+ *            end time.
+ */
+#ifndef __HOST_BOARD_H__
+#define __HOST_BOARD_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "sim-medium.h"
+
+/*!
+ * Maximum length of a command script line
+ */
+#define HOST_BOARD_COMMAND_SIZE                     128
+
+/*!
+ * Channel model of the medium, a few meters indoor
+ */
+extern const SimChannelModel_t HostBoardChannelModel;
+
+/*!
+ * \brief Sets the virtual time at which BoardLowPowerHandler ends the
+ *        process with exit status 0
+ *
+ * \param [IN] time End time [SIM_TIME_NEVER: when no event is left]
+ */
+void HostBoardSetEndTime( SimTime_t time );
+
+/*!
+ * \brief Parses the end time given as first program argument
+ *
+ * \param [IN] argc Number of program arguments
+ * \param [IN] argv Program arguments, argv[1]: virtual run time [ms]
+ */
+void HostBoardParseArgs( int argc, char* argv[] );
+
+/*!
+ * \brief Opens the command script of the application, the file given as
+ *        first program argument or stdin. The script stands for the commands
+ *        a test bench sends to the UART of the board.
+ *
+ * \param [IN] argc Number of program arguments
+ * \param [IN] argv Program arguments, argv[1]: script file
+ */
+void HostBoardOpenScript( int argc, char* argv[] );
+
+/*!
+ * \brief Gets the next command line of the script due at the virtual time.
+ *        Empty lines and lines starting with '#' are skipped. The board
+ *        consumes the "wait <ms>" lines: the following line is due once the
+ *        virtual clock has advanced by <ms>, BoardLowPowerHandler wakes up
+ *        for it. At the end of the script, BoardLowPowerHandler ends the
+ *        process once the events due are processed.
+ *
+ * \retval line Command line, modifiable up to the next call [NULL: no line due]
+ */
+char* HostBoardGetCommand( void );
+
+/*!
+ * \brief Gets the time of the pending RTC alarm
+ *
+ * \retval time Alarm time [SIM_TIME_NEVER: no alarm]
+ */
+SimTime_t RtcGetAlarmTime( void );
+
+/*!
+ * \brief Runs the medium up to the given time. The RTC alarms on the way
+ *        call TimerIrqHandler.
+ *
+ * \param [IN] time Time to run to
+ */
+void RtcRunUntil( SimTime_t time );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_BOARD_H__
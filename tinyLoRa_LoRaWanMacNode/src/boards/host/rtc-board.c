@@ -0,0 +1,168 @@
+/*!
+ * \file      rtc-board.c
+ *
+ * \brief     Target board RTC timer on the virtual clock of the medium
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    One tick is one millisecond of virtual time.
+ */
+#include "utilities.h"
+#include "rtc-board.h"
+#include "sx-timer.h"
+#include "host-board.h"
+
+/*!
+ * Virtual time in ms
+ */
+#define RTC_NOW_MS( )                               ( ( uint32_t )( SimMediumGetTime( ) / 1000 ) )
+
+/*!
+ * RTC timer context
+ */
+static struct
+{
+    /*!
+     * Reference time
+     */
+    uint32_t Time;
+    /*!
+     * Reference time in virtual time
+     */
+    SimTime_t SimTime;
+}RtcTimerContext;
+
+/*!
+ * Time of the pending alarm
+ */
+static SimTime_t RtcAlarmTime = SIM_TIME_NEVER;
+
+/*!
+ * Set while RtcRunUntil fires alarms. A delay in a timer callback only runs
+ * the medium, as the alarm interrupt of a target would be masked.
+ */
+static bool RtcIsRunning = false;
+
+/*!
+ * Backup registers
+ */
+static uint32_t RtcBkup[2];
+
+void RtcInit( void )
+{
+    RtcAlarmTime = SIM_TIME_NEVER;
+    RtcSetTimerContext( );
+}
+
+uint32_t RtcGetMinimumTimeout( void )
+{
+    return 1;
+}
+
+uint32_t RtcMs2Tick( TimerTime_t milliseconds )
+{
+    return ( uint32_t )milliseconds;
+}
+
+TimerTime_t RtcTick2Ms( uint32_t tick )
+{
+    return ( TimerTime_t )tick;
+}
+
+void RtcDelayMs( TimerTime_t milliseconds )
+{
+    RtcRunUntil( SimMediumGetTime( ) + ( ( SimTime_t )milliseconds * 1000 ) );
+}
+
+void RtcSetAlarm( uint32_t timeout )
+{
+    RtcStartAlarm( timeout );
+}
+
+void RtcStopAlarm( void )
+{
+    RtcAlarmTime = SIM_TIME_NEVER;
+}
+
+void RtcStartAlarm( uint32_t timeout )
+{
+    RtcAlarmTime = RtcTimerContext.SimTime + ( ( SimTime_t )timeout * 1000 );
+}
+
+uint32_t RtcSetTimerContext( void )
+{
+    RtcTimerContext.Time = RTC_NOW_MS( );
+    RtcTimerContext.SimTime = ( SimTime_t )RtcTimerContext.Time * 1000;
+    return RtcTimerContext.Time;
+}
+
+uint32_t RtcGetTimerContext( void )
+{
+    return RtcTimerContext.Time;
+}
+
+/*!
+ * Seconds since the start, as on the tinyLoRa board
+ */
+uint32_t RtcGetCalendarTime( uint16_t *milliseconds )
+{
+    SimTime_t now = SimMediumGetTime( );
+
+    *milliseconds = ( uint16_t )( ( now / 1000 ) % 1000 );
+    return ( uint32_t )( now / 1000000 );
+}
+
+uint32_t RtcGetTimerValue( void )
+{
+    return RTC_NOW_MS( );
+}
+
+uint32_t RtcGetTimerElapsedTime( void )
+{
+    return RTC_NOW_MS( ) - RtcTimerContext.Time;
+}
+
+void RtcBkupWrite( uint32_t data0, uint32_t data1 )
+{
+    RtcBkup[0] = data0;
+    RtcBkup[1] = data1;
+}
+
+void RtcBkupRead( uint32_t *data0, uint32_t *data1 )
+{
+    *data0 = RtcBkup[0];
+    *data1 = RtcBkup[1];
+}
+
+void RtcProcess( void )
+{
+    // Not used on this board
+}
+
+TimerTime_t RtcTempCompensation( TimerTime_t period, float temperature )
+{
+    return period;
+}
+
+SimTime_t RtcGetAlarmTime( void )
+{
+    return RtcAlarmTime;
+}
+
+void RtcRunUntil( SimTime_t time )
+{
+    if( RtcIsRunning == true )
+    {
+        SimMediumRunUntil( time );
+        return;
+    }
+    RtcIsRunning = true;
+    while( RtcAlarmTime <= time )
+    {
+        SimMediumRunUntil( RtcAlarmTime );
+        RtcStopAlarm( );
+        TimerIrqHandler( );
+    }
+    SimMediumRunUntil( time );
+    RtcIsRunning = false;
+}
@@ -0,0 +1,46 @@
+/*!
+ * \file      uart-board.c
+ *
+ * \brief     Target board UART driver implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Every UART writes to the standard output and never receives.
+ */
+#include <stdio.h>
+#include "utilities.h"
+#include "uart-board.h"
+
+void UartMcuInit( Uart_t *obj, UartId_t uartId, PinNames tx, PinNames rx )
+{
+    obj->UartId = uartId;
+}
+
+void UartMcuConfig( Uart_t *obj, UartMode_t mode, uint32_t baudrate, WordLength_t wordLength, StopBits_t stopBits, Parity_t parity, FlowCtrl_t flowCtrl )
+{
+}
+
+void UartMcuDeInit( Uart_t *obj )
+{
+}
+
+uint8_t UartMcuPutChar( Uart_t *obj, uint8_t data )
+{
+    return ( putchar( data ) == EOF ) ? 1 : 0;
+}
+
+uint8_t UartMcuPutBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size )
+{
+    return ( fwrite( buffer, 1, size, stdout ) == size ) ? 0 : 1;
+}
+
+uint8_t UartMcuGetChar( Uart_t *obj, uint8_t *data )
+{
+    return 1;
+}
+
+uint8_t UartMcuGetBuffer( Uart_t *obj, uint8_t *buffer, uint16_t size, uint16_t *nbReadBytes )
+{
+    *nbReadBytes = 0;
+    return 1;
+}
@@ -23,6 +23,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "utilities.h"
+#if defined( USE_ENTROPY_POOL )
+#include "sx-entropy.h"
+#endif
 
 /*!
  * Redefinition of rand() and srand() standard C functions.
@@ -32,6 +35,18 @@
 // Standard random functions redefinition start
 #define RAND_LOCAL_MAX 2147483647L
 
+#if defined( USE_ENTROPY_POOL )
+int32_t rand1( void )
+{
+    return ( int32_t )( EntropyGetRandom( ) % RAND_LOCAL_MAX );
+}
+
+void srand1( uint32_t seed )
+{
+    // The seed is mixed into the entropy pool, sequences are not reproducible
+    EntropyAddSeed( ( uint8_t* )&seed, sizeof( seed ) );
+}
+#else
 static uint32_t next = 1;
 
 int32_t rand1( void )
@@ -43,6 +58,7 @@ void srand1( uint32_t seed )
 {
     next = seed;
 }
+#endif
 // Standard random functions redefinition end
 
 int32_t randr( int32_t min, int32_t max )
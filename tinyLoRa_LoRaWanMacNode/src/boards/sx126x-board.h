@@ -184,6 +184,39 @@ RadioOperatingModes_t SX126xGetOperatingMode( void );
  */
 void SX126xSetOperatingMode( RadioOperatingModes_t mode );
 
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/*!
+ * \brief Initializes the radio software interrupt used to process the radio
+ *        IRQs outside of the DIO1 GPIO handler.
+ *
+ * \param [IN] handler Handler executed from the software interrupt
+ */
+void SX126xIoSwIrqInit( void ( *handler )( void ) );
+
+/*!
+ * \brief Pends the radio software interrupt.
+ *
+ * \remark While the software interrupt is held back the request is recorded
+ *         and the software interrupt is pended on the last release.
+ */
+void SX126xIoSwIrqTrigger( void );
+
+/*!
+ * \brief Holds the radio software interrupt back. Calls nest.
+ *
+ * \remark Held by each SPI transaction and by each radio driver API call,
+ *         RadioIrqProcess is not re-entrant and may not run between the
+ *         transactions of an operation.
+ */
+void SX126xIoSwIrqHold( void );
+
+/*!
+ * \brief Releases the radio software interrupt, pends it on the last
+ *        release if it has been requested meanwhile.
+ */
+void SX126xIoSwIrqRelease( void );
+#endif
+
 /*!
  * Radio hardware and global parameters
  */
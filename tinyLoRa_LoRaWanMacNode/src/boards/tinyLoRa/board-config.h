@@ -121,6 +121,8 @@ extern "C"
 #define RADIO_SPI_CLK_PIN			RPIO_14  /* MCU pin 17 */
 /* device selebt not available on tinyLoRa */
 #define RADIO_DEVICE_SEL_PIN		NC
+/* software IRQ used with RADIO_IRQ_DIRECT_DISPATCH, preempts the GPIO and alarm IRQs (PICO_DEFAULT_IRQ_PRIORITY) */
+#define RADIO_SW_IRQ_PRIORITY		0x40
 
 /**
  * LED pins
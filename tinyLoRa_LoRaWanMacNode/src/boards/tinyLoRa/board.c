@@ -30,6 +30,7 @@
 #include "pico/sync.h"
 #include "hardware/flash.h"
 #include "hardware/clocks.h"
+#include "hardware/structs/rosc.h"
 
 #include "RP2040-platform.h"
 
@@ -225,6 +226,18 @@ uint32_t BoardGetRandomSeed( void )
   return seed[0] ^ seed[1] ^ seed[2] ^ seed[3];
 }
 
+uint32_t BoardGetEntropy( void )
+{
+    uint32_t bits = 0;
+
+    // The ring oscillator random bit is sampled once per read
+    for( uint8_t i = 0; i < 32; i++ )
+    {
+        bits = ( bits << 1 ) | ( rosc_hw->randombit & 0x01 );
+    }
+    return bits;
+}
+
 /**
   * NOT IMPLEMENTED ON THIS PLATFORM
   */
@@ -32,6 +32,19 @@
 #include "radio.h"
 #include "sx126x-board.h"
 
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/* pico specific libraries */
+#include "hardware/irq.h"
+
+/*!
+ * \brief Software interrupt handler
+ */
+static void SX126xIoSwIrqHandler( void );
+#else
+#define SX126xIoSwIrqHold( )
+#define SX126xIoSwIrqRelease( )
+#endif
+
 #if defined( USE_RADIO_DEBUG )
 /*!
  * \brief Writes new Tx debug pin state
@@ -59,6 +72,21 @@ static RadioOperatingModes_t OperatingMode;
 Gpio_t AntPow;
 Gpio_t DeviceSel;
 
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/*!
+ * Software interrupt used to process the radio IRQs
+ */
+static int SwIrqNum = -1;
+static void ( *SwIrqHandler )( void ) = NULL;
+
+/*!
+ * Nesting depth of the ongoing radio API calls and SPI transactions, and
+ * pending software interrupt request held back by them
+ */
+static volatile uint8_t HoldDepth = 0;
+static volatile bool SwIrqDeferred = false;
+#endif
+
 /*!
  * Debug GPIO pins objects
  */
@@ -173,6 +201,7 @@ void SX126xWakeup( void )
 
 void SX126xWriteCommand( RadioCommands_t command, uint8_t *buffer, uint16_t size )
 {
+    SX126xIoSwIrqHold( );
     SX126xCheckDeviceReady( );
 
     GpioWrite( &SX126x.Spi.Nss, 0 );
@@ -190,12 +219,15 @@ void SX126xWriteCommand( RadioCommands_t command, uint8_t *buffer, uint16_t size
     {
         SX126xWaitOnBusy( );
     }
+
+    SX126xIoSwIrqRelease( );
 }
 
 uint8_t SX126xReadCommand( RadioCommands_t command, uint8_t *buffer, uint16_t size )
 {
     uint8_t status = 0;
 
+    SX126xIoSwIrqHold( );
     SX126xCheckDeviceReady( );
 
     GpioWrite( &SX126x.Spi.Nss, 0 );
@@ -211,11 +243,14 @@ uint8_t SX126xReadCommand( RadioCommands_t command, uint8_t *buffer, uint16_t si
 
     SX126xWaitOnBusy( );
 
+    SX126xIoSwIrqRelease( );
+
     return status;
 }
 
 void SX126xWriteRegisters( uint16_t address, uint8_t *buffer, uint16_t size )
 {
+    SX126xIoSwIrqHold( );
     SX126xCheckDeviceReady( );
 
     GpioWrite( &SX126x.Spi.Nss, 0 );
@@ -232,6 +267,8 @@ void SX126xWriteRegisters( uint16_t address, uint8_t *buffer, uint16_t size )
     GpioWrite( &SX126x.Spi.Nss, 1 );
 
     SX126xWaitOnBusy( );
+
+    SX126xIoSwIrqRelease( );
 }
 
 void SX126xWriteRegister( uint16_t address, uint8_t value )
@@ -241,6 +278,7 @@ void SX126xWriteRegister( uint16_t address, uint8_t value )
 
 void SX126xReadRegisters( uint16_t address, uint8_t *buffer, uint16_t size )
 {
+    SX126xIoSwIrqHold( );
     SX126xCheckDeviceReady( );
 
     GpioWrite( &SX126x.Spi.Nss, 0 );
@@ -256,6 +294,8 @@ void SX126xReadRegisters( uint16_t address, uint8_t *buffer, uint16_t size )
     GpioWrite( &SX126x.Spi.Nss, 1 );
 
     SX126xWaitOnBusy( );
+
+    SX126xIoSwIrqRelease( );
 }
 
 uint8_t SX126xReadRegister( uint16_t address )
@@ -267,6 +307,7 @@ uint8_t SX126xReadRegister( uint16_t address )
 
 void SX126xWriteBuffer( uint8_t offset, uint8_t *buffer, uint8_t size )
 {
+    SX126xIoSwIrqHold( );
     SX126xCheckDeviceReady( );
 
     GpioWrite( &SX126x.Spi.Nss, 0 );
@@ -280,10 +321,13 @@ void SX126xWriteBuffer( uint8_t offset, uint8_t *buffer, uint8_t size )
     GpioWrite( &SX126x.Spi.Nss, 1 );
 
     SX126xWaitOnBusy( );
+
+    SX126xIoSwIrqRelease( );
 }
 
 void SX126xReadBuffer( uint8_t offset, uint8_t *buffer, uint8_t size )
 {
+    SX126xIoSwIrqHold( );
     SX126xCheckDeviceReady( );
 
     GpioWrite( &SX126x.Spi.Nss, 0 );
@@ -298,6 +342,8 @@ void SX126xReadBuffer( uint8_t offset, uint8_t *buffer, uint8_t size )
     GpioWrite( &SX126x.Spi.Nss, 1 );
 
     SX126xWaitOnBusy( );
+
+    SX126xIoSwIrqRelease( );
 }
 
 void SX126xSetRfTxPower( int8_t power )
@@ -332,6 +378,65 @@ uint32_t SX126xGetDio1PinState( void )
     return GpioRead( &SX126x.DIO1 );
 }
 
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+void SX126xIoSwIrqInit( void ( *handler )( void ) )
+{
+    SwIrqHandler = handler;
+
+    if( SwIrqNum < 0 )
+    {
+        SwIrqNum = user_irq_claim_unused( true );
+        irq_set_exclusive_handler( SwIrqNum, SX126xIoSwIrqHandler );
+        irq_set_priority( SwIrqNum, RADIO_SW_IRQ_PRIORITY );
+        irq_set_enabled( SwIrqNum, true );
+    }
+}
+
+void SX126xIoSwIrqTrigger( void )
+{
+    if( SwIrqNum < 0 )
+    {
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    if( HoldDepth > 0 )
+    {
+        // The software interrupt would preempt the ongoing radio access.
+        SwIrqDeferred = true;
+    }
+    else
+    {
+        irq_set_pending( SwIrqNum );
+    }
+    CRITICAL_SECTION_END( );
+}
+
+void SX126xIoSwIrqHold( void )
+{
+    HoldDepth++;
+}
+
+void SX126xIoSwIrqRelease( void )
+{
+    HoldDepth--;
+
+    if( ( HoldDepth == 0 ) && ( SwIrqDeferred == true ) )
+    {
+        SwIrqDeferred = false;
+        irq_set_pending( SwIrqNum );
+    }
+}
+
+static void SX126xIoSwIrqHandler( void )
+{
+    if( SwIrqHandler != NULL )
+    {
+        SwIrqHandler( );
+    }
+}
+#endif
+
 #if defined( USE_RADIO_DEBUG )
 static void SX126xDbgPinTxWrite( uint8_t state )
 {
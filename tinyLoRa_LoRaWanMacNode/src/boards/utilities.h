@@ -87,6 +87,9 @@ typedef union Version_u
 /*!
  * \brief Initializes the pseudo random generator initial value
  *
+ * \remark When USE_ENTROPY_POOL is defined the seed is mixed into the
+ *         entropy pool instead.
+ *
  * \param [IN] seed Pseudo random generator initial value
  */
 void srand1( uint32_t seed );
@@ -45,6 +45,9 @@
 #include "LoRaMacAdr.h"
 #include "LoRaMacSerializer.h"
 #include "radio.h"
+#if defined( USE_ENTROPY_POOL )
+#include "sx-entropy.h"
+#endif
 
 #include "LoRaMac.h"
 
@@ -70,6 +73,16 @@
  */
 #define LORA_MAC_COMMAND_MAX_FOPTS_LENGTH           15
 
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+#ifndef LORAMAC_TX_PRELOAD_LEAD_TIME
+/*!
+ * Time between the upload of a duty cycle delayed frame to the radio and
+ * the start of its transmission [ms]
+ */
+#define LORAMAC_TX_PRELOAD_LEAD_TIME                50
+#endif
+#endif
+
 /*!
  * LoRaMac duty cycle for the back-off procedure during the first hour.
  */
@@ -137,9 +150,16 @@ typedef struct sLoRaMacCtx
     */
     uint8_t AppDataSize;
     /*
-    * Buffer containing the upper layer data.
+    * Buffers the radio reads the received frames into. Frames are parsed
+    * and decrypted in place. The radio switches buffer on each reception:
+    * a window re-armed from a timer or radio IRQ before the indication has
+    * been handled receives into the other buffer.
+    */
+    uint8_t RxPayload[2][LORAMAC_PHY_MAXPAYLOAD];
+    /*
+    * Index of the RxPayload buffer the radio receives into
     */
-    uint8_t RxPayload[LORAMAC_PHY_MAXPAYLOAD];
+    uint8_t RxPayloadIndex;
     SysTime_t LastTxSysTime;
     /*
     * LoRaMac internal state
@@ -161,6 +181,21 @@ typedef struct sLoRaMacCtx
     * LoRaMac duty cycle delayed Tx timer
     */
     TimerEvent_t TxDelayedTimer;
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+    /*
+    * LoRaMac uploaded frame Tx start timer
+    */
+    TimerEvent_t TxPreloadTimer;
+    /*
+    * Set when the next frame sent on a channel is to be uploaded only
+    */
+    bool TxPreloadRequested;
+    /*
+    * Set when PktBuffer holds the secured frame uploaded to the radio,
+    * which is configured for its channel
+    */
+    bool TxPreloaded;
+#endif
     /*
     * LoRaMac reception windows timers
     */
@@ -273,6 +308,30 @@ typedef struct sLoRaMacCtx
     * Duty cycle wait time
     */
     TimerTime_t DutyCycleWaitTime;
+    /*
+    * Result of the listen before talk channel sense
+    */
+    ChannelSenseResult_t ChannelSenseResult;
+    /*
+    * Class C GFSK bulk reception parameters
+    */
+    LoRaMacBulkRxParams_t RxCBulkParams;
+    /*
+    * Class C RX duty cycle ( sniff ) parameters
+    */
+    LoRaMacRxSniffParams_t RxCSniffParams;
+    /*
+    * RX1 and RX2 windows listen statistics
+    */
+    LoRaMacRxWindowStats_t RxWindowStats;
+    /*
+    * Time the listened RX1 or RX2 window has been opened
+    */
+    TimerTime_t RxWindowOpenTime;
+    /*
+    * Set while a RX1 or RX2 window is listening
+    */
+    bool IsRxWindowListening;
     /*
      * Start time of the response timeout
      */
@@ -306,6 +365,8 @@ typedef union uLoRaMacRadioEvents
         uint32_t TxTimeout        : 1;
         uint32_t RxDone           : 1;
         uint32_t TxDone           : 1;
+        uint32_t ChannelSenseDone : 1;
+        uint32_t ChannelFree      : 1;
     }Events;
 }LoRaMacRadioEvents_t;
 
@@ -345,11 +406,29 @@ static void OnRadioRxError( void );
  */
 static void OnRadioRxTimeout( void );
 
+/*!
+ * \brief Function executed on Radio channel sense done event
+ */
+static void OnRadioChannelSenseDone( bool channelFree );
+
 /*!
  * \brief Function executed on duty cycle delayed Tx  timer event
  */
 static void OnTxDelayedTimerEvent( void* context );
 
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+/*!
+ * \brief Function executed on uploaded frame Tx start timer event. Only
+ *        starts the transmission of the uploaded frame.
+ */
+static void OnTxPreloadTimerEvent( void* context );
+
+/*!
+ * \brief Stops the Tx start timer and discards the uploaded frame
+ */
+static void ResetTxPreload( void );
+#endif
+
 /*!
  * \brief Function executed on first Rx window timer event
  */
@@ -568,12 +647,30 @@ static bool IsReJoin0Required( void );
  */
 static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig );
 
+/*!
+ * \brief Records the listen time of the RX1 or RX2 window being closed
+ *
+ * \param [IN] extended Set when the window has been extended by a preamble detection
+ */
+static void RxWindowStatsRecord( bool extended );
+
 /*!
  * \brief Opens up a continuous RX C window. This is used for
  *        class c devices.
  */
 static void OpenContinuousRxCWindow( void );
 
+/*!
+ * \brief Computes the RX duty cycle periods of the RX C window for the given
+ *        datarate
+ *
+ * \param [IN]  datarate    RX C window datarate
+ * \param [OUT] sniffParams Computed periods and model estimates
+ *
+ * \retval Returns true when the RX C window can be duty cycled
+ */
+static bool ComputeRxCSniffParams( int8_t datarate, RegionCommonRxSniffParams_t* sniffParams );
+
 /*!
  * \brief   Returns a pointer to the internal contexts structure.
  *
@@ -720,6 +817,16 @@ static void LoRaMacHandleIndicationEvents( void );
  */
 static void LoRaMacHandleNvm( LoRaMacNvmData_t* nvmData );
 
+#if defined( USE_ENTROPY_POOL )
+/*!
+ * \brief Mixes a batch of radio random numbers into the entropy pool
+ *
+ * \remark The radio RNG runs the receiver, the caller has to make sure the
+ *         radio is not used by the MAC.
+ */
+static void LoRaMacHarvestRadioEntropy( void );
+#endif
+
 /*!
  * \brief This function verifies if the response timeout has been elapsed. If
  *        this is the case, the status of Nvm.MacGroup1.SrvAckRequested will be
@@ -771,11 +878,19 @@ static void OnRadioTxDone( void )
 static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
 {
     RxDoneParams.LastRxDone = TimerGetCurrentTime( );
+    RxWindowStatsRecord( true );
     RxDoneParams.Payload = payload;
     RxDoneParams.Size = size;
     RxDoneParams.Rssi = rssi;
     RxDoneParams.Snr = snr;
 
+    // The next reception must not overwrite the frame until it is indicated
+    if( Radio.SetRxBuffer != NULL )
+    {
+        MacCtx.RxPayloadIndex ^= 1;
+        Radio.SetRxBuffer( MacCtx.RxPayload[MacCtx.RxPayloadIndex] );
+    }
+
     LoRaMacRadioEvents.Events.RxDone = 1;
     LoRaMacRadioEvents.Events.RxProcessPending = 1;
 
@@ -797,6 +912,7 @@ static void OnRadioTxTimeout( void )
 
 static void OnRadioRxError( void )
 {
+    RxWindowStatsRecord( true );
     LoRaMacRadioEvents.Events.RxError = 1;
 
     if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->MacProcessNotify != NULL ) )
@@ -807,6 +923,7 @@ static void OnRadioRxError( void )
 
 static void OnRadioRxTimeout( void )
 {
+    RxWindowStatsRecord( false );
     LoRaMacRadioEvents.Events.RxTimeout = 1;
 
     if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->MacProcessNotify != NULL ) )
@@ -815,6 +932,17 @@ static void OnRadioRxTimeout( void )
     }
 }
 
+static void OnRadioChannelSenseDone( bool channelFree )
+{
+    LoRaMacRadioEvents.Events.ChannelFree = ( channelFree == true ) ? 1 : 0;
+    LoRaMacRadioEvents.Events.ChannelSenseDone = 1;
+
+    if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->MacProcessNotify != NULL ) )
+    {
+        MacCtx.MacCallbacks->MacProcessNotify( );
+    }
+}
+
 static void UpdateRxSlotIdleState( void )
 {
     if( Nvm.MacGroup2.DeviceClass != CLASS_C )
@@ -1080,6 +1208,11 @@ static void ProcessRadioRxDone( void )
             getPhy.Datarate = MacCtx.McpsIndication.RxDatarate;
             getPhy.Attribute = PHY_MAX_PAYLOAD;
             phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+            if( ( MacCtx.RxSlot == RX_SLOT_WIN_CLASS_C ) && ( MacCtx.RxCBulkParams.Enabled == true ) )
+            {
+                // GFSK bulk frames are only limited by the radio packet length
+                phyParam.Value = LORAMAC_PHY_MAXPAYLOAD - LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE;
+            }
             if( ( MAX( 0, ( int16_t )( ( int16_t ) size - ( int16_t ) LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE ) ) > ( int16_t )phyParam.Value ) ||
                 ( size < LORAMAC_FRAME_PAYLOAD_MIN_SIZE ) )
             {
@@ -1089,8 +1222,6 @@ static void ProcessRadioRxDone( void )
             }
             macMsgData.Buffer = payload;
             macMsgData.BufSize = size;
-            macMsgData.FRMPayload = MacCtx.RxPayload;
-            macMsgData.FRMPayloadSize = LORAMAC_PHY_MAXPAYLOAD;
 
             if( LORAMAC_PARSER_SUCCESS != LoRaMacParserData( &macMsgData ) )
             {
@@ -1344,11 +1475,9 @@ static void ProcessRadioRxDone( void )
 
             break;
         case FRAME_TYPE_PROPRIETARY:
-            memcpy1( MacCtx.RxPayload, &payload[pktHeaderLen], size - pktHeaderLen );
-
             MacCtx.McpsIndication.McpsIndication = MCPS_PROPRIETARY;
             MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_OK;
-            MacCtx.McpsIndication.Buffer = MacCtx.RxPayload;
+            MacCtx.McpsIndication.Buffer = &payload[pktHeaderLen];
             MacCtx.McpsIndication.BufferSize = size - pktHeaderLen;
 
             MacCtx.MacFlags.Bits.McpsInd = 1;
@@ -1398,6 +1527,17 @@ static void ProcessRadioTxTimeout( void )
     MacCtx.MacFlags.Bits.MacDone = 1;
 }
 
+static void ProcessRadioChannelSenseDone( bool channelFree )
+{
+    MacCtx.ChannelSenseResult = ( channelFree == true ) ? CHANNEL_SENSE_FREE : CHANNEL_SENSE_BUSY;
+
+    if( ( MacCtx.MacState & LORAMAC_TX_DELAYED ) == LORAMAC_TX_DELAYED )
+    {
+        // Resume the uplink scheduling without waiting for the Tx delayed timer
+        OnTxDelayedTimerEvent( NULL );
+    }
+}
+
 static void HandleRadioRxErrorTimeout( LoRaMacEventInfoStatus_t rx1EventInfoStatus, LoRaMacEventInfoStatus_t rx2EventInfoStatus )
 {
     bool classBRx = false;
@@ -1500,6 +1640,10 @@ static void LoRaMacHandleIrqEvents( void )
         {
             ProcessRadioRxTimeout( );
         }
+        if( events.Events.ChannelSenseDone == 1 )
+        {
+            ProcessRadioChannelSenseDone( events.Events.ChannelFree == 1 );
+        }
     }
 }
 
@@ -1638,6 +1782,9 @@ static void LoRaMacHandleMcpsRequest( void )
         if( stopRetransmission == true )
         {// Stop retransmission
             TimerStop( &MacCtx.TxDelayedTimer );
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+            ResetTxPreload( );
+#endif
             MacCtx.MacState &= ~LORAMAC_TX_DELAYED;
             StopRetransmission( );
 
@@ -1787,6 +1934,17 @@ static void LoRaMacHandleNvm( LoRaMacNvmData_t* nvmData )
     CallNvmDataChangeCallback( notifyFlags );
 }
 
+#if defined( USE_ENTROPY_POOL )
+static void LoRaMacHarvestRadioEntropy( void )
+{
+    for( uint8_t i = 0; i < ENTROPY_RADIO_SEED_NB_WORDS; i++ )
+    {
+        uint32_t rnd = Radio.Random( );
+        EntropyAddSeed( ( uint8_t* )&rnd, sizeof( rnd ) );
+    }
+}
+#endif
+
 static bool LoRaMacHandleResponseTimeout( TimerTime_t timeoutInMs, TimerTime_t startTimeInMs )
 {
     if( startTimeInMs != 0 )
@@ -1829,6 +1987,13 @@ void LoRaMacProcess( void )
         LoRaMacHandleScheduleUplinkEvent( );
         LoRaMacEnableRequests( LORAMAC_REQUEST_HANDLING_ON );
         MacCtx.MacFlags.Bits.NvmHandle = 1;
+
+        // Compute the keystream of the next uplink while the MAC is idle
+        if( ( MacCtx.MacState == LORAMAC_IDLE ) &&
+            ( Nvm.MacGroup2.NetworkActivation != ACTIVATION_TYPE_NONE ) )
+        {
+            LoRaMacCryptoPrecomputeKeystream( Nvm.MacGroup2.DevAddr );
+        }
     }
     LoRaMacHandleIndicationEvents( );
     if( MacCtx.RxSlot == RX_SLOT_WIN_CLASS_C )
@@ -1840,11 +2005,24 @@ void LoRaMacProcess( void )
         MacCtx.MacFlags.Bits.NvmHandle = 0;
         LoRaMacHandleNvm( &Nvm );
     }
+#if defined( USE_ENTROPY_POOL )
+    // Provide the seeds of the next reseed while the MAC and the radio are idle
+    if( ( EntropyIsSeedDue( ) == true ) && ( LoRaMacIsBusy( ) == false ) &&
+        ( Radio.GetStatus( ) == RF_IDLE ) )
+    {
+        LoRaMacHarvestRadioEntropy( );
+        Radio.Sleep( );
+    }
+#endif
 }
 
 static void OnTxDelayedTimerEvent( void* context )
 {
     TimerStop( &MacCtx.TxDelayedTimer );
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+    TimerStop( &MacCtx.TxPreloadTimer );
+    MacCtx.TxPreloaded = false;
+#endif
     MacCtx.MacState &= ~LORAMAC_TX_DELAYED;
 
     if( LoRaMacHandleResponseTimeout( REGION_COMMON_CLASS_B_C_RESP_TIMEOUT,
@@ -1862,6 +2040,16 @@ static void OnTxDelayedTimerEvent( void* context )
         {
             break;
         }
+        case LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND:
+        {
+            // Listen before talk found every channel busy
+            MacCtx.McpsConfirm.Datarate = Nvm.MacGroup1.ChannelsDatarate;
+            MacCtx.McpsConfirm.NbTrans = MacCtx.ChannelsNbTransCounter;
+            MacCtx.McpsConfirm.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
+            LoRaMacConfirmQueueSetStatusCmn( LORAMAC_EVENT_INFO_STATUS_ERROR );
+            StopRetransmission( );
+            break;
+        }
         default:
         {
             // Stop retransmission attempt
@@ -1875,6 +2063,41 @@ static void OnTxDelayedTimerEvent( void* context )
     }
 }
 
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+static void OnTxPreloadTimerEvent( void* context )
+{
+    TimerStop( &MacCtx.TxPreloadTimer );
+
+    if( MacCtx.TxPreloaded == false )
+    {
+        return;
+    }
+    MacCtx.TxPreloaded = false;
+    MacCtx.MacState &= ~LORAMAC_TX_DELAYED;
+
+    // The channel was selected and the radio configured on upload
+    if( Radio.SendPrepared( ) == true )
+    {
+        MacCtx.MacState |= LORAMAC_TX_RUNNING;
+
+        MacCtx.ChannelsNbTransCounter++;
+        MacCtx.McpsConfirm.NbTrans = MacCtx.ChannelsNbTransCounter;
+        MacCtx.ResponseTimeoutStartTime = 0;
+    }
+    else
+    {// The radio discarded the frame, configure it again for the channel
+        SendFrameOnChannel( MacCtx.Channel );
+    }
+}
+
+static void ResetTxPreload( void )
+{
+    TimerStop( &MacCtx.TxPreloadTimer );
+    MacCtx.TxPreloadRequested = false;
+    MacCtx.TxPreloaded = false;
+}
+#endif
+
 static void OnRxWindow1TimerEvent( void* context )
 {
     MacCtx.RxWindow1Config.Channel = MacCtx.Channel;
@@ -2928,6 +3151,8 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     nextChan.LastTxIsJoinRequest = false;
     nextChan.Joined = true;
     nextChan.PktLen = MacCtx.PktBufferLen;
+    nextChan.ChannelSense = MacCtx.ChannelSenseResult;
+    MacCtx.ChannelSenseResult = CHANNEL_SENSE_NONE;
 
     // Setup the parameters based on the join status
     if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
@@ -2939,7 +3164,19 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     // Select channel
     status = RegionNextChannel( Nvm.MacGroup2.Region, &nextChan, &MacCtx.Channel, &MacCtx.DutyCycleWaitTime, &Nvm.MacGroup1.AggregatedTimeOff );
 
-    if( status != LORAMAC_STATUS_OK )
+    if( status == LORAMAC_STATUS_CHANNEL_SENSE_PENDING )
+    {// Listen before talk - resume on the channel sense result, the timer
+     // only covers a missing result
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+        // The frame must start right after the channel sense
+        MacCtx.TxPreloadRequested = false;
+#endif
+        MacCtx.MacState |= LORAMAC_TX_DELAYED;
+        TimerSetValue( &MacCtx.TxDelayedTimer, MacCtx.DutyCycleWaitTime );
+        TimerStart( &MacCtx.TxDelayedTimer );
+        return LORAMAC_STATUS_OK;
+    }
+    else if( status != LORAMAC_STATUS_OK )
     {
         if( ( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) &&
             ( allowDelayedTx == true ) )
@@ -2951,6 +3188,13 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
                 MacCtx.MacState |= LORAMAC_TX_DELAYED;
                 TimerSetValue( &MacCtx.TxDelayedTimer, MacCtx.DutyCycleWaitTime );
                 TimerStart( &MacCtx.TxDelayedTimer );
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+                // Once the duty cycle allows it, upload the frame for the
+                // selected channel and only start it on the Tx start timer.
+                // The radio leaves the class C continuous reception meanwhile.
+                MacCtx.TxPreloadRequested = ( Nvm.MacGroup2.DeviceClass != CLASS_C ) &&
+                                            ( Radio.PrepareTx != NULL );
+#endif
             }
             return LORAMAC_STATUS_OK;
         }
@@ -3078,6 +3322,7 @@ static void ResetMacParameters( void )
     MacCtx.ChannelsNbTransCounter = 0;
     MacCtx.RetransmitTimeoutRetry = false;
     MacCtx.ResponseTimeoutStartTime = 0;
+    MacCtx.RxCBulkParams.Enabled = false;
 
     Nvm.MacGroup2.MaxDCycle = 0;
     Nvm.MacGroup2.AggregatedDCycle = 1;
@@ -3171,10 +3416,43 @@ static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig )
     // Ensure the radio is Idle
     Radio.Standby( );
 
+    // A window still listening at this point is receiving a frame
+    RxWindowStatsRecord( true );
+
     if( RegionRxConfig( Nvm.MacGroup2.Region, rxConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
     {
         Radio.Rx( Nvm.MacGroup2.MacParams.MaxRxWindow );
         MacCtx.RxSlot = rxConfig->RxSlot;
+
+        MacCtx.RxWindowOpenTime = TimerGetCurrentTime( );
+        MacCtx.IsRxWindowListening = true;
+    }
+}
+
+static void RxWindowStatsRecord( bool extended )
+{
+    uint32_t listenTime = 0;
+
+    if( MacCtx.IsRxWindowListening == false )
+    {
+        return;
+    }
+    MacCtx.IsRxWindowListening = false;
+
+    listenTime = TimerGetElapsedTime( MacCtx.RxWindowOpenTime );
+    if( MacCtx.RxSlot == RX_SLOT_WIN_1 )
+    {
+        MacCtx.RxWindowStats.LastRx1ListenTime = listenTime;
+    }
+    else
+    {
+        MacCtx.RxWindowStats.LastRx2ListenTime = listenTime;
+    }
+    MacCtx.RxWindowStats.TotalListenTime += listenTime;
+    MacCtx.RxWindowStats.NbWindows++;
+    if( extended == true )
+    {
+        MacCtx.RxWindowStats.NbExtendedWindows++;
     }
 }
 
@@ -3192,15 +3470,60 @@ static void OpenContinuousRxCWindow( void )
     // Setup continuous listening
     MacCtx.RxWindowCConfig.RxContinuous = true;
 
+    if( MacCtx.RxCBulkParams.Enabled == true )
+    {
+        // The frames are reported with the RxC channel datarate
+        MacCtx.McpsIndication.RxDatarate = Nvm.MacGroup2.MacParams.RxCChannel.Datarate;
+        RegionCommonRxBulkSetup( MacCtx.RxCBulkParams.Frequency, MacCtx.RxCBulkParams.Bitrate );
+        MacCtx.RxSlot = RX_SLOT_WIN_CLASS_C;
+        return;
+    }
+
     // At this point the Radio should be idle.
     // Thus, there is no need to set the radio in standby mode.
     if( RegionRxConfig( Nvm.MacGroup2.Region, &MacCtx.RxWindowCConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
     {
-        Radio.Rx( 0 ); // Continuous mode
+        RegionCommonRxSniffParams_t sniffParams;
+
+        if( ( MacCtx.RxCSniffParams.Enabled == true ) && ( Radio.SetRxDutyCycle != NULL ) &&
+            ( ComputeRxCSniffParams( MacCtx.RxWindowCConfig.Datarate, &sniffParams ) == true ) )
+        {
+            Radio.SetRxDutyCycle( sniffParams.RxTime, sniffParams.SleepTime );
+        }
+        else
+        {
+            Radio.Rx( 0 ); // Continuous mode
+        }
         MacCtx.RxSlot = MacCtx.RxWindowCConfig.RxSlot;
     }
 }
 
+static bool ComputeRxCSniffParams( int8_t datarate, RegionCommonRxSniffParams_t* sniffParams )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    uint8_t spreadingFactor = 0;
+    uint8_t bandwidth = 0;
+
+    getPhy.Attribute = PHY_SF_FROM_DR;
+    getPhy.Datarate = datarate;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    spreadingFactor = phyParam.Value;
+
+    getPhy.Attribute = PHY_BW_FROM_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    bandwidth = phyParam.Value;
+
+    if( ( spreadingFactor < 5 ) || ( spreadingFactor > 12 ) || ( bandwidth > 2 ) )
+    { // FSK datarates are not duty cycled
+        return false;
+    }
+
+    return RegionCommonComputeRxSniffParams( RegionCommonComputeSymbolTimeLoRa( spreadingFactor, 125000 << bandwidth ),
+                                             MacCtx.RxCSniffParams.PreambleLength, MacCtx.RxCSniffParams.MaxMissRate,
+                                             sniffParams );
+}
+
 LoRaMacStatus_t PrepareFrame( LoRaMacHeader_t* macHdr, LoRaMacFrameCtrl_t* fCtrl, uint8_t fPort, void* fBuffer, uint16_t fBufferSize )
 {
     MacCtx.PktBufferLen = 0;
@@ -3209,6 +3532,10 @@ LoRaMacStatus_t PrepareFrame( LoRaMacHeader_t* macHdr, LoRaMacFrameCtrl_t* fCtrl
     size_t macCmdsSize = 0;
     uint8_t availableSize = 0;
 
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+    ResetTxPreload( );
+#endif
+
     if( fBuffer == NULL )
     {
         fBufferSize = 0;
@@ -3334,7 +3661,14 @@ LoRaMacStatus_t SendFrameOnChannel( uint8_t channel )
     {
         // Currently, the Time-On-Air can only be computed when the radio is configured with
         // the TX configuration
-        TimerTime_t collisionTime = LoRaMacClassBIsUplinkCollision( MacCtx.TxTimeOnAir );
+        TimerTime_t txDuration = MacCtx.TxTimeOnAir;
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+        if( MacCtx.TxPreloadRequested == true )
+        {
+            txDuration += LORAMAC_TX_PRELOAD_LEAD_TIME;
+        }
+#endif
+        TimerTime_t collisionTime = LoRaMacClassBIsUplinkCollision( txDuration );
 
         if( collisionTime > 0 )
         {
@@ -3357,6 +3691,19 @@ LoRaMacStatus_t SendFrameOnChannel( uint8_t channel )
         return status;
     }
 
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+    if( MacCtx.TxPreloadRequested == true )
+    {// Upload now, the Tx start timer only starts the transmission
+        MacCtx.TxPreloadRequested = false;
+        Radio.PrepareTx( MacCtx.PktBuffer, MacCtx.PktBufferLen );
+        MacCtx.TxPreloaded = true;
+        MacCtx.MacState |= LORAMAC_TX_DELAYED;
+        TimerSetValue( &MacCtx.TxPreloadTimer, LORAMAC_TX_PRELOAD_LEAD_TIME );
+        TimerStart( &MacCtx.TxPreloadTimer );
+        return LORAMAC_STATUS_OK;
+    }
+#endif
+
     MacCtx.MacState |= LORAMAC_TX_RUNNING;
 
     MacCtx.ChannelsNbTransCounter++;
@@ -3397,6 +3744,9 @@ LoRaMacStatus_t RestoreNvmData( LoRaMacNvmData_t* nvm )
         return LORAMAC_STATUS_BUSY;
     }
 
+    // The restored keys replace the keys of the keystream computed ahead of time
+    LoRaMacCryptoResetKeystream( );
+
     // Crypto
     crc = Crc32( ( uint8_t* ) &nvm->Crypto, sizeof( nvm->Crypto ) -
                                             sizeof( nvm->Crypto.Crc32 ) );
@@ -3672,6 +4022,7 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     // Set non zero variables to its default value
     Nvm.MacGroup2.Region = region;
     Nvm.MacGroup2.DeviceClass = CLASS_A;
+    MacCtx.RxCSniffParams.PreambleLength = LORAMAC_RXC_SNIFF_MIN_PREAMBLE_LENGTH;
 
     // Setup version
     Nvm.MacGroup2.Version.Value = LORAMAC_VERSION;
@@ -3786,6 +4137,9 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
 
     // Initialize timers
     TimerInit( &MacCtx.TxDelayedTimer, OnTxDelayedTimerEvent );
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+    TimerInit( &MacCtx.TxPreloadTimer, OnTxPreloadTimerEvent );
+#endif
     TimerInit( &MacCtx.RxWindowTimer1, OnRxWindow1TimerEvent );
     TimerInit( &MacCtx.RxWindowTimer2, OnRxWindow2TimerEvent );
     TimerInit( &MacCtx.RetransmitTimeoutTimer, OnRetransmitTimeoutTimerEvent );
@@ -3806,8 +4160,16 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     MacCtx.RadioEvents.RxError = OnRadioRxError;
     MacCtx.RadioEvents.TxTimeout = OnRadioTxTimeout;
     MacCtx.RadioEvents.RxTimeout = OnRadioRxTimeout;
+    MacCtx.RadioEvents.ChannelSenseDone = OnRadioChannelSenseDone;
     Radio.Init( &MacCtx.RadioEvents );
 
+    // Received frames are read directly into the MAC buffers
+    if( Radio.SetRxBuffer != NULL )
+    {
+        MacCtx.RxPayloadIndex = 0;
+        Radio.SetRxBuffer( MacCtx.RxPayload[MacCtx.RxPayloadIndex] );
+    }
+
     // Initialize the Secure Element driver
     if( SecureElementInit( &Nvm.SecureElement ) != SECURE_ELEMENT_SUCCESS )
     {
@@ -3832,8 +4194,14 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
         return LORAMAC_STATUS_CRYPTO_ERROR;
     }
 
+#if defined( USE_ENTROPY_POOL )
+    // Feed the entropy pool with a batch of radio random numbers, the next
+    // batches are harvested by LoRaMacProcess when a reseed is due
+    LoRaMacHarvestRadioEntropy( );
+#else
     // Random seed initialization
     srand1( Radio.Random( ) );
+#endif
 
     Radio.SetPublicNetwork( Nvm.MacGroup2.PublicNetwork );
     Radio.Sleep( );
@@ -3922,6 +4290,43 @@ LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
     }
 }
 
+LoRaMacStatus_t LoRaMacQueryNextTxDelay( uint8_t size, int8_t datarate, TimerTime_t* delay )
+{
+    NextChanParams_t nextChan;
+    size_t macCmdsSize = 0;
+
+    if( delay == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
+    {
+        return LORAMAC_STATUS_NO_NETWORK_JOINED;
+    }
+
+    if( LoRaMacCommandsGetSizeSerializedCmds( &macCmdsSize ) != LORAMAC_COMMANDS_SUCCESS )
+    {
+        return LORAMAC_STATUS_MAC_COMMAD_ERROR;
+    }
+
+    nextChan.AggrTimeOff = Nvm.MacGroup1.AggregatedTimeOff;
+    nextChan.Datarate = datarate;
+    nextChan.DutyCycleEnabled = Nvm.MacGroup2.DutyCycleOn;
+    nextChan.ElapsedTimeSinceStartUp = SysTimeSub( SysTimeGetMcuTime( ), Nvm.MacGroup2.InitializationTime );
+    nextChan.LastAggrTx = Nvm.MacGroup1.LastTxDoneTime;
+    nextChan.LastTxIsJoinRequest = false;
+    nextChan.Joined = true;
+    nextChan.PktLen = LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE + MIN( macCmdsSize, LORA_MAC_COMMAND_MAX_FOPTS_LENGTH ) + size;
+    nextChan.ChannelSense = CHANNEL_SENSE_NONE;
+
+    *delay = RegionGetNextTxDelay( Nvm.MacGroup2.Region, &nextChan );
+    if( *delay == TIMERTIME_T_MAX )
+    {
+        return LORAMAC_STATUS_NO_CHANNEL_FOUND;
+    }
+    return LORAMAC_STATUS_OK;
+}
+
 LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
 {
     LoRaMacStatus_t status = LORAMAC_STATUS_OK;
@@ -4134,6 +4539,36 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
             mibGet->Param.Rejoin2CycleInSec = Nvm.MacGroup2.Rejoin2CycleInSec;
             break;
         }
+        case MIB_RXC_BULK_PARAMS:
+        {
+            mibGet->Param.RxCBulkParams = MacCtx.RxCBulkParams;
+            break;
+        }
+        case MIB_RX_WINDOW_STATS:
+        {
+            CRITICAL_SECTION_BEGIN( );
+            mibGet->Param.RxWindowStats = MacCtx.RxWindowStats;
+            CRITICAL_SECTION_END( );
+            break;
+        }
+        case MIB_RXC_SNIFF_PARAMS:
+        {
+            RegionCommonRxSniffParams_t sniffParams;
+
+            mibGet->Param.RxCSniffParams = MacCtx.RxCSniffParams;
+
+            if( ComputeRxCSniffParams( Nvm.MacGroup2.MacParams.RxCChannel.Datarate, &sniffParams ) == true )
+            {
+                mibGet->Param.RxCSniffParams.AvgCurrent = sniffParams.AvgCurrent;
+                mibGet->Param.RxCSniffParams.MissRate = sniffParams.MissRate;
+            }
+            else
+            { // Continuous reception
+                mibGet->Param.RxCSniffParams.AvgCurrent = REGION_COMMON_RX_SNIFF_RX_CURRENT / 1000;
+                mibGet->Param.RxCSniffParams.MissRate = 0;
+            }
+            break;
+        }
         default:
         {
             status = LoRaMacClassBMibGetRequestConfirm( mibGet );
@@ -4805,6 +5240,62 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             }
             break;
         }
+        case MIB_RXC_BULK_PARAMS:
+        {
+            if( mibSet->Param.RxCBulkParams.Enabled == true )
+            {
+                verify.Frequency = mibSet->Param.RxCBulkParams.Frequency;
+
+                if( ( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_FREQUENCY ) == false ) ||
+                    ( mibSet->Param.RxCBulkParams.Bitrate < LORAMAC_BULK_RX_MIN_BITRATE ) ||
+                    ( mibSet->Param.RxCBulkParams.Bitrate > LORAMAC_BULK_RX_MAX_BITRATE ) )
+                {
+                    status = LORAMAC_STATUS_PARAMETER_INVALID;
+                    break;
+                }
+            }
+            MacCtx.RxCBulkParams = mibSet->Param.RxCBulkParams;
+
+            if( ( Nvm.MacGroup2.DeviceClass == CLASS_C ) && ( Nvm.MacGroup2.NetworkActivation != ACTIVATION_TYPE_NONE ) &&
+                ( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) != LORAMAC_TX_RUNNING ) )
+            {
+                // Reopen the RxC window with the new modem. A running uplink
+                // reopens it on its own once its RX windows are done.
+                Radio.Sleep( );
+
+                OpenContinuousRxCWindow( );
+            }
+            break;
+        }
+        case MIB_RX_WINDOW_STATS:
+        {
+            CRITICAL_SECTION_BEGIN( );
+            MacCtx.RxWindowStats = mibSet->Param.RxWindowStats;
+            CRITICAL_SECTION_END( );
+            break;
+        }
+        case MIB_RXC_SNIFF_PARAMS:
+        {
+            if( ( mibSet->Param.RxCSniffParams.PreambleLength < LORAMAC_RXC_SNIFF_MIN_PREAMBLE_LENGTH ) ||
+                ( mibSet->Param.RxCSniffParams.MaxMissRate > LORAMAC_RXC_SNIFF_MAX_MISS_RATE ) )
+            {
+                status = LORAMAC_STATUS_PARAMETER_INVALID;
+                break;
+            }
+            MacCtx.RxCSniffParams.Enabled = mibSet->Param.RxCSniffParams.Enabled;
+            MacCtx.RxCSniffParams.PreambleLength = mibSet->Param.RxCSniffParams.PreambleLength;
+            MacCtx.RxCSniffParams.MaxMissRate = mibSet->Param.RxCSniffParams.MaxMissRate;
+
+            if( ( Nvm.MacGroup2.DeviceClass == CLASS_C ) && ( Nvm.MacGroup2.NetworkActivation != ACTIVATION_TYPE_NONE ) &&
+                ( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) != LORAMAC_TX_RUNNING ) )
+            {
+                // Reopen the RxC window with the new reception mode
+                Radio.Sleep( );
+
+                OpenContinuousRxCWindow( );
+            }
+            break;
+        }
         default:
         {
             status = LoRaMacMibClassBSetRequestConfirm( mibSet );
@@ -5419,6 +5910,9 @@ LoRaMacStatus_t LoRaMacDeInitialization( void )
     {
         // Stop Timers
         TimerStop( &MacCtx.TxDelayedTimer );
+#if defined( LORAMAC_TX_PRELOAD_ENABLED )
+        ResetTxPreload( );
+#endif
         TimerStop( &MacCtx.RxWindowTimer1 );
         TimerStop( &MacCtx.RxWindowTimer2 );
 
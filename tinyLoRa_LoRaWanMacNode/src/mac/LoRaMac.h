@@ -199,6 +199,120 @@ typedef struct sRxChannelParams
     uint8_t  Datarate;
 }RxChannelParams_t;
 
+/*!
+ * Minimum GFSK bulk transfer bit rate [bits/s]
+ */
+#define LORAMAC_BULK_RX_MIN_BITRATE                 50000
+
+/*!
+ * Maximum GFSK bulk transfer bit rate [bits/s]
+ */
+#define LORAMAC_BULK_RX_MAX_BITRATE                 300000
+
+/*!
+ * LoRaMAC class C GFSK bulk reception parameters
+ *
+ * \remark While enabled, the receive window C is opened with the GFSK modem
+ *         instead of the RxC channel datarate. The frames keep the LoRaWAN
+ *         format and are received with up to 255 bytes PHY payloads.
+ *         Uplinks and the RX1/RX2 windows are not affected.
+ */
+typedef struct sLoRaMacBulkRxParams
+{
+    /*!
+     * Enables the GFSK bulk reception
+     */
+    bool Enabled;
+    /*!
+     * Frequency in Hz
+     */
+    uint32_t Frequency;
+    /*!
+     * Bit rate [\ref LORAMAC_BULK_RX_MIN_BITRATE : \ref LORAMAC_BULK_RX_MAX_BITRATE] bits/s
+     */
+    uint32_t Bitrate;
+}LoRaMacBulkRxParams_t;
+
+/*!
+ * Minimum downlink preamble length handled by the class C RX duty cycle [symbols]
+ */
+#define LORAMAC_RXC_SNIFF_MIN_PREAMBLE_LENGTH       8
+
+/*!
+ * Maximum accepted downlink miss rate of the class C RX duty cycle [1/1000]
+ */
+#define LORAMAC_RXC_SNIFF_MAX_MISS_RATE             500
+
+/*!
+ * LoRaMAC class C RX duty cycle ( sniff ) parameters
+ *
+ * \remark While enabled, the receive window C is duty cycled by the radio
+ *         instead of listening continuously. The periods are derived from the
+ *         RxC channel datarate and the downlink preamble length. MaxMissRate
+ *         trades the average current against the probability to miss a
+ *         downlink. The RxC window stays continuous when the RxC datarate
+ *         does not allow to save current ( FSK, MaxMissRate too low ).
+ */
+typedef struct sLoRaMacRxSniffParams
+{
+    /*!
+     * Enables the RX duty cycle
+     */
+    bool Enabled;
+    /*!
+     * Downlink preamble length [\ref LORAMAC_RXC_SNIFF_MIN_PREAMBLE_LENGTH : 65535] symbols
+     */
+    uint16_t PreambleLength;
+    /*!
+     * Accepted probability to miss a downlink [0 : \ref LORAMAC_RXC_SNIFF_MAX_MISS_RATE] 1/1000.
+     * 0 guarantees each downlink preamble is caught.
+     */
+    uint16_t MaxMissRate;
+    /*!
+     * Estimated average radio current for the RxC channel datarate [uA].
+     * Read only, updated on \ref LoRaMacMibGetRequestConfirm.
+     */
+    uint32_t AvgCurrent;
+    /*!
+     * Estimated probability to miss a downlink [1/1000].
+     * Read only, updated on \ref LoRaMacMibGetRequestConfirm.
+     */
+    uint16_t MissRate;
+}LoRaMacRxSniffParams_t;
+
+/*!
+ * LoRaMAC RX1 and RX2 windows listen statistics
+ *
+ * \remark A window is closed by the radio when no frame is detected within
+ *         the window timeout. A LoRa window is extended on preamble detection,
+ *         an FSK window on sync word detection. The listen time multiplied by
+ *         the radio RX current gives the energy spent receiving per class A
+ *         cycle.
+ */
+typedef struct sLoRaMacRxWindowStats
+{
+    /*!
+     * Listen time of the last RX1 window [ms]
+     */
+    uint32_t LastRx1ListenTime;
+    /*!
+     * Listen time of the last RX2 window [ms]
+     */
+    uint32_t LastRx2ListenTime;
+    /*!
+     * Accumulated listen time of the RX1 and RX2 windows [ms]
+     */
+    uint32_t TotalListenTime;
+    /*!
+     * Number of RX1 and RX2 windows opened
+     */
+    uint32_t NbWindows;
+    /*!
+     * Number of windows extended by a frame detection
+     */
+    uint32_t NbExtendedWindows;
+}LoRaMacRxWindowStats_t;
+
 /*!
  * LoRaMAC receive window enumeration
  */
@@ -552,6 +666,10 @@ typedef enum eLoRaMacRegion
      * Russia band on 864MHz
      */
     LORAMAC_REGION_RU864,
+    /*!
+     * Private network PHY profile on the European 868MHz band
+     */
+    LORAMAC_REGION_PRIV868,
 }LoRaMacRegion_t;
 
 typedef struct sLoRaMacNvmDataGroup1
@@ -1010,6 +1128,11 @@ typedef struct sMcpsIndication
     uint8_t FramePending;
     /*!
      * Pointer to the received data stream
+     *
+     * \remark Points into a MAC receive buffer. Only valid until the
+     *         MacMcpsIndication callback returns. The MAC receives into its
+     *         other buffer meanwhile, so a window re-armed before the
+     *         indication does not overwrite it.
      */
     uint8_t* Buffer;
     /*!
@@ -1437,6 +1560,9 @@ typedef struct sMlmeIndication
  * \ref MIB_REJOIN_0_CYCLE                       | YES | YES
  * \ref MIB_REJOIN_1_CYCLE                       | YES | YES
  * \ref MIB_REJOIN_2_CYCLE                       | YES | NO
+ * \ref MIB_RXC_BULK_PARAMS                      | YES | YES
+ * \ref MIB_RXC_SNIFF_PARAMS                     | YES | YES
+ * \ref MIB_RX_WINDOW_STATS                      | YES | YES
  *
  * The following table provides links to the function implementations of the
  * related MIB primitives:
@@ -1869,6 +1995,19 @@ typedef enum eMib
       * LoRaWAN certification FPort handling state (ON/OFF)
       */
      MIB_IS_CERT_FPORT_ON,
+     /*!
+      * Class C GFSK bulk reception parameters
+      */
+     MIB_RXC_BULK_PARAMS,
+     /*!
+      * Class C RX duty cycle ( sniff ) parameters
+      */
+     MIB_RXC_SNIFF_PARAMS,
+     /*!
+      * RX1 and RX2 windows listen statistics. Setting it resets the statistics
+      * to the given values.
+      */
+     MIB_RX_WINDOW_STATS,
 }Mib_t;
 
 /*!
@@ -2061,7 +2200,7 @@ typedef union uMibParam
      *
      * Related MIB type: \ref MIB_CHANNELS
      */
-    ChannelParams_t* ChannelList;
+    const ChannelParams_t* ChannelList;
     /*!
      * Channel for the receive window 2
      *
@@ -2315,6 +2454,24 @@ typedef union uMibParam
      * Related MIB type: \ref MIB_IS_CERT_FPORT_ON
      */
     bool IsCertPortOn;
+    /*!
+     * Class C GFSK bulk reception parameters
+     *
+     * Related MIB type: \ref MIB_RXC_BULK_PARAMS
+     */
+    LoRaMacBulkRxParams_t RxCBulkParams;
+    /*!
+     * Class C RX duty cycle ( sniff ) parameters
+     *
+     * Related MIB type: \ref MIB_RXC_SNIFF_PARAMS
+     */
+    LoRaMacRxSniffParams_t RxCSniffParams;
+    /*!
+     * RX1 and RX2 windows listen statistics
+     *
+     * Related MIB type: \ref MIB_RX_WINDOW_STATS
+     */
+    LoRaMacRxWindowStats_t RxWindowStats;
 }MibParam_t;
 
 /*!
@@ -2422,6 +2579,11 @@ typedef enum eLoRaMacStatus
      *
      */
     LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND,
+    /*!
+     * The listen before talk channel sense is running. The MAC resumes
+     * the transmission when it completes.
+     */
+    LORAMAC_STATUS_CHANNEL_SENSE_PENDING,
      /*!
       * ToDo
       */
@@ -2621,6 +2783,30 @@ void LoRaMacProcess( void );
  */
 LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo );
 
+/*!
+ * \brief   Queries the LoRaMAC for the earliest time at which a frame with a
+ *          given application data payload size can be sent on a given datarate.
+ *          The LoRaMAC takes the scheduled MAC commands, the band duty cycles
+ *          and the aggregated time-off into account.
+ *
+ * \remark  The query does not change the MAC state. Its cost is one pass over
+ *          the enabled channels and the bands. The application may sleep for
+ *          the returned delay instead of retrying a restricted request.
+ *
+ * \param   [IN] size - Size of application data payload to be send next
+ *
+ * \param   [IN] datarate - Datarate of the frame
+ *
+ * \param   [OUT] delay - Time to wait before the frame can be sent [ms, 0: now]
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_NO_NETWORK_JOINED,
+ *          \ref LORAMAC_STATUS_NO_CHANNEL_FOUND.
+ */
+LoRaMacStatus_t LoRaMacQueryNextTxDelay( uint8_t size, int8_t datarate, TimerTime_t* delay );
+
 /*!
  * \brief   LoRaMAC channel add service
  *
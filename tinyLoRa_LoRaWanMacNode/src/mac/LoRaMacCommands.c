@@ -35,6 +35,11 @@ Maintainer: Miguel Luis ( Semtech ), Daniel Jaeckle ( STACKFORCE ), Johannes Bru
  */
 #define CID_FIELD_SIZE 1
 
+/*!
+ * Number of 32 bit words of the MAC command slots bitmap
+ */
+#define NUM_OF_SLOT_WORDS ( ( NUM_OF_MAC_COMMANDS + 31 ) / 32 )
+
 /*!
  *  Mac Commands list structure
  */
@@ -63,10 +68,23 @@ typedef struct sLoRaMacCommandsCtx
      * Buffer to store MAC command elements
      */
     MacCommand_t MacCommandSlots[NUM_OF_MAC_COMMANDS];
+    /*
+     * Bitmap of the MAC command slots in use, bit n of word n / 32 is set
+     * when slot n is in use
+     */
+    uint32_t SlotsInUse[NUM_OF_SLOT_WORDS];
     /*
      * Size of all MAC commands serialized as buffer
      */
     size_t SerializedCmdsSize;
+    /*
+     * Number of MAC commands in the list
+     */
+    uint8_t NbCmds;
+    /*
+     * Number of sticky MAC commands in the list
+     */
+    uint8_t NbStickyCmds;
 } LoRaMacCommandsCtx_t;
 
 /*!
@@ -77,23 +95,46 @@ static LoRaMacCommandsCtx_t CommandsCtx;
 /* Memory management functions */
 
 /*!
- * \brief Determines if a MAC command slot is free
+ * Position of the lowest set bit of a 32 bit word, indexed by the de Bruijn
+ * sequence 0x077CB531 multiplied by the isolated bit.
+ */
+static const uint8_t SlotBitPosition[32] =
+{
+     0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+    31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
+
+/*!
+ * \brief Determines the slot index of a MAC command slot
+ *
+ * \param[IN]     slot           - Slot to check
+ * \retval                       - Slot index, NUM_OF_MAC_COMMANDS if the
+ *                                 slot is not part of the slots buffer
+ */
+static uint8_t GetSlotIndex( const MacCommand_t* slot )
+{
+    if( ( slot < &CommandsCtx.MacCommandSlots[0] ) || ( slot >= &CommandsCtx.MacCommandSlots[NUM_OF_MAC_COMMANDS] ) )
+    {
+        return NUM_OF_MAC_COMMANDS;
+    }
+    return ( uint8_t )( slot - &CommandsCtx.MacCommandSlots[0] );
+}
+
+/*!
+ * \brief Determines if a MAC command slot is in use
  *
  * \param[IN]     slot           - Slot to check
  * \retval                       - Status of the operation
  */
-static bool IsSlotFree( const MacCommand_t* slot )
+static bool IsSlotInUse( const MacCommand_t* slot )
 {
-    uint8_t* mem = ( uint8_t* )slot;
+    uint8_t itr = GetSlotIndex( slot );
 
-    for( uint16_t size = 0; size < sizeof( MacCommand_t ); size++ )
+    if( itr == NUM_OF_MAC_COMMANDS )
     {
-        if( mem[size] != 0x00 )
-        {
-            return false;
-        }
+        return false;
     }
-    return true;
+    return ( CommandsCtx.SlotsInUse[itr / 32] & ( 1UL << ( itr % 32 ) ) ) != 0;
 }
 
 /*!
@@ -103,18 +144,24 @@ static bool IsSlotFree( const MacCommand_t* slot )
  */
 static MacCommand_t* MallocNewMacCommandSlot( void )
 {
-    uint8_t itr = 0;
-
-    while( IsSlotFree( ( const MacCommand_t* )&CommandsCtx.MacCommandSlots[itr] ) == false )
+    for( uint8_t k = 0; k < NUM_OF_SLOT_WORDS; k++ )
     {
-        itr++;
-        if( itr == NUM_OF_MAC_COMMANDS )
+        // Isolate the lowest free slot of the word
+        uint32_t freeSlot = ~CommandsCtx.SlotsInUse[k] & ( CommandsCtx.SlotsInUse[k] + 1 );
+
+        if( freeSlot != 0 )
         {
-            return NULL;
+            uint8_t itr = k * 32 + SlotBitPosition[( uint32_t )( freeSlot * 0x077CB531UL ) >> 27];
+
+            if( itr >= NUM_OF_MAC_COMMANDS )
+            {
+                return NULL;
+            }
+            CommandsCtx.SlotsInUse[k] |= freeSlot;
+            return &CommandsCtx.MacCommandSlots[itr];
         }
     }
-
-    return &CommandsCtx.MacCommandSlots[itr];
+    return NULL;
 }
 
 /*!
@@ -126,12 +173,14 @@ static MacCommand_t* MallocNewMacCommandSlot( void )
  */
 static bool FreeMacCommandSlot( MacCommand_t* slot )
 {
-    if( slot == NULL )
+    uint8_t itr = GetSlotIndex( slot );
+
+    if( itr == NUM_OF_MAC_COMMANDS )
     {
         return false;
     }
 
-    memset1( ( uint8_t* )slot, 0x00, sizeof( MacCommand_t ) );
+    CommandsCtx.SlotsInUse[itr / 32] &= ~( 1UL << ( itr % 32 ) );
 
     return true;
 }
@@ -183,8 +232,9 @@ static bool LinkedListAdd( MacCommandsList_t* list, MacCommand_t* element )
         list->Last->Next = element;
     }
 
-    // Update the next point of this entry.
+    // Update the next and previous points of this entry.
     element->Next = NULL;
+    element->Prev = list->Last;
 
     // Update the last entry of the list.
     list->Last = element;
@@ -192,42 +242,6 @@ static bool LinkedListAdd( MacCommandsList_t* list, MacCommand_t* element )
     return true;
 }
 
-/*!
- * \brief Return the previous element in the list.
- *
- * \param[IN]     list           - List
- * \param[IN]     element        - Element where the previous element shall be searched
- * \retval                       - Status of the operation
- */
-static MacCommand_t* LinkedListGetPrevious( MacCommandsList_t* list, MacCommand_t* element )
-{
-    if( ( list == NULL ) || ( element == NULL ) )
-    {
-        return NULL;
-    }
-
-    MacCommand_t* curElement;
-
-    // Start at the head of the list
-    curElement = list->First;
-
-    // When current element is the first of the list, there's no previous element so we can return NULL immediately.
-    if( element != curElement )
-    {
-        // Loop through all elements until the end is reached or the next of current is the current element.
-        while( ( curElement != NULL ) && ( curElement->Next != element ) )
-        {
-            curElement = curElement->Next;
-        }
-    }
-    else
-    {
-        curElement = NULL;
-    }
-
-    return curElement;
-}
-
 /*!
  * \brief Remove an element from the list
  *
@@ -242,24 +256,26 @@ static bool LinkedListRemove( MacCommandsList_t* list, MacCommand_t* element )
         return false;
     }
 
-    MacCommand_t* PrevElement = LinkedListGetPrevious( list, element );
-
-    if( list->First == element )
+    if( element->Prev != NULL )
+    {
+        element->Prev->Next = element->Next;
+    }
+    else
     {
         list->First = element->Next;
     }
 
-    if( list->Last == element )
+    if( element->Next != NULL )
     {
-        list->Last = PrevElement;
+        element->Next->Prev = element->Prev;
     }
-
-    if( PrevElement != NULL )
+    else
     {
-        PrevElement->Next = element->Next;
+        list->Last = element->Prev;
     }
 
     element->Next = NULL;
+    element->Prev = NULL;
 
     return true;
 }
@@ -328,6 +344,11 @@ LoRaMacCommandStatus_t LoRaMacCommandsAddCmd( uint8_t cid, uint8_t* payload, siz
     newCmd->IsSticky = IsSticky( cid );
 
     CommandsCtx.SerializedCmdsSize += ( CID_FIELD_SIZE + payloadSize );
+    CommandsCtx.NbCmds++;
+    if( newCmd->IsSticky == true )
+    {
+        CommandsCtx.NbStickyCmds++;
+    }
 
     return LORAMAC_COMMANDS_SUCCESS;
 }
@@ -339,6 +360,12 @@ LoRaMacCommandStatus_t LoRaMacCommandsRemoveCmd( MacCommand_t* macCmd )
         return LORAMAC_COMMANDS_ERROR_NPE;
     }
 
+    // Only a MAC command of the list can be unlinked in place
+    if( IsSlotInUse( macCmd ) == false )
+    {
+        return LORAMAC_COMMANDS_ERROR_CMD_NOT_FOUND;
+    }
+
     // Remove the Mac command element from MacCommandList
     if( LinkedListRemove( &CommandsCtx.MacCommandList, macCmd ) == false )
     {
@@ -346,6 +373,11 @@ LoRaMacCommandStatus_t LoRaMacCommandsRemoveCmd( MacCommand_t* macCmd )
     }
 
     CommandsCtx.SerializedCmdsSize -= ( CID_FIELD_SIZE + macCmd->PayloadSize );
+    CommandsCtx.NbCmds--;
+    if( macCmd->IsSticky == true )
+    {
+        CommandsCtx.NbStickyCmds--;
+    }
 
     // Free the MacCommand Slot
     if( FreeMacCommandSlot( macCmd ) == false )
@@ -388,8 +420,8 @@ LoRaMacCommandStatus_t LoRaMacCommandsRemoveNoneStickyCmds( void )
     // Start at the head of the list
     curElement = CommandsCtx.MacCommandList.First;
 
-    // Loop through all elements
-    while( curElement != NULL )
+    // Loop until all none sticky elements are removed
+    while( ( curElement != NULL ) && ( CommandsCtx.NbCmds > CommandsCtx.NbStickyCmds ) )
     {
         if( curElement->IsSticky == false )
         {
@@ -414,8 +446,8 @@ LoRaMacCommandStatus_t LoRaMacCommandsRemoveStickyAnsCmds( void )
     // Start at the head of the list
     curElement = CommandsCtx.MacCommandList.First;
 
-    // Loop through all elements
-    while( curElement != NULL )
+    // Loop until all sticky elements are removed
+    while( ( curElement != NULL ) && ( CommandsCtx.NbStickyCmds > 0 ) )
     {
         nexElement = curElement->Next;
         if( IsSticky( curElement->CID ) == true )
@@ -487,22 +519,7 @@ LoRaMacCommandStatus_t LoRaMacCommandsStickyCmdsPending( bool* cmdsPending )
     {
         return LORAMAC_COMMANDS_ERROR_NPE;
     }
-    MacCommand_t* curElement;
-    curElement = CommandsCtx.MacCommandList.First;
-
-    *cmdsPending = false;
-
-    // Loop through all elements
-    while( curElement != NULL )
-    {
-        if( curElement->IsSticky == true )
-        {
-            // Found one sticky MAC command
-            *cmdsPending = true;
-            return LORAMAC_COMMANDS_SUCCESS;
-        }
-        curElement = curElement->Next;
-    }
+    *cmdsPending = ( CommandsCtx.NbStickyCmds > 0 );
 
     return LORAMAC_COMMANDS_SUCCESS;
 }
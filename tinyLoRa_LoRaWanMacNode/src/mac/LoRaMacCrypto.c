@@ -33,6 +33,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "utilities.h"
 #include "secure-element.h"
@@ -71,6 +72,21 @@
  */
 #define CRYPTO_BUFFER_SIZE              CRYPTO_MAXMESSAGE_SIZE + MIC_BLOCK_BX_SIZE
 
+#if defined( LORAMAC_KEYSTREAM_CACHE_ENABLED )
+#ifndef CRYPTO_KEYSTREAM_PAYLOAD_BLOCKS
+/*
+ * Number of FRMPayload keystream blocks computed ahead of the next uplink,
+ * a block covers 16 bytes of FRMPayload
+ */
+#define CRYPTO_KEYSTREAM_PAYLOAD_BLOCKS 4
+#endif
+
+/*
+ * Number of keystream blocks, the FRMPayload blocks and the FOpts block
+ */
+#define CRYPTO_KEYSTREAM_NB_BLOCKS      ( CRYPTO_KEYSTREAM_PAYLOAD_BLOCKS + 1 )
+#endif
+
 /*
  * Key-Address item
  */
@@ -94,6 +110,27 @@ typedef struct sKeyAddr
     KeyIdentifier_t RootKey;
 }KeyAddr_t;
 
+#if defined( LORAMAC_KEYSTREAM_CACHE_ENABLED )
+/*
+ * Keystream block computed ahead of time
+ */
+typedef struct sKeystreamBlock
+{
+    /*
+     * Key identifier, NO_KEY for an empty block
+     */
+    KeyIdentifier_t KeyID;
+    /*
+     * Counter block A_i, holds the direction, the address and the frame counter
+     */
+    uint8_t ABlock[16];
+    /*
+     * Keystream block S_i = aes128_encrypt( Key, A_i )
+     */
+    uint8_t SBlock[16];
+}KeystreamBlock_t;
+#endif
+
 #if( USE_LRWAN_1_1_X_CRYPTO == 1 )
 /*
  * RJcount0 is a counter incremented with every Type 0 or 2 Rejoin frame transmitted.
@@ -118,6 +155,62 @@ static KeyAddr_t KeyAddrList[NUM_OF_SEC_CTX] =
         { UNICAST_DEV_ADDR, APP_S_KEY, S_NWK_S_INT_KEY, NO_KEY }
     };
 
+#if defined( LORAMAC_KEYSTREAM_CACHE_ENABLED )
+/*
+ * Keystream of the next uplink, computed by LoRaMacCryptoPrecomputeKeystream
+ */
+static KeystreamBlock_t Keystream[CRYPTO_KEYSTREAM_NB_BLOCKS];
+#endif
+
+/*
+ * Prepares the counter block A_i of the encryption, without the counter
+ *
+ * \param[IN]  address          - Address
+ * \param[IN]  dir              - Frame direction ( Uplink or Downlink )
+ * \param[IN]  frameCounter     - Frame counter
+ * \param[OUT] aBlock           - Counter block
+ */
+static void PrepareABlock( uint32_t address, uint8_t dir, uint32_t frameCounter, uint8_t* aBlock )
+{
+    aBlock[0] = 0x01;
+
+    aBlock[5] = dir;
+
+    aBlock[6] = address & 0xFF;
+    aBlock[7] = ( address >> 8 ) & 0xFF;
+    aBlock[8] = ( address >> 16 ) & 0xFF;
+    aBlock[9] = ( address >> 24 ) & 0xFF;
+
+    aBlock[10] = frameCounter & 0xFF;
+    aBlock[11] = ( frameCounter >> 8 ) & 0xFF;
+    aBlock[12] = ( frameCounter >> 16 ) & 0xFF;
+    aBlock[13] = ( frameCounter >> 24 ) & 0xFF;
+}
+
+/*
+ * Computes the keystream block of a counter block. Uses the keystream computed
+ * ahead of time when it holds the block.
+ *
+ * \param[IN]  keyID            - Key identifier
+ * \param[IN]  aBlock           - Counter block A_i
+ * \param[OUT] sBlock           - Keystream block S_i
+ * \retval                      - Status of the secure element operation
+ */
+static SecureElementStatus_t ComputeKeystreamBlock( KeyIdentifier_t keyID, uint8_t* aBlock, uint8_t* sBlock )
+{
+#if defined( LORAMAC_KEYSTREAM_CACHE_ENABLED )
+    for( uint8_t i = 0; i < CRYPTO_KEYSTREAM_NB_BLOCKS; i++ )
+    {
+        if( ( Keystream[i].KeyID == keyID ) && ( memcmp( Keystream[i].ABlock, aBlock, 16 ) == 0 ) )
+        {
+            memcpy1( sBlock, Keystream[i].SBlock, 16 );
+            return SECURE_ELEMENT_SUCCESS;
+        }
+    }
+#endif
+    return SecureElementAesEncrypt( aBlock, 16, keyID, sBlock );
+}
+
 /*
  * Encrypts the payload
  *
@@ -141,25 +234,13 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, int16_t size, KeyI
     uint8_t sBlock[16] = { 0 };
     uint8_t aBlock[16] = { 0 };
 
-    aBlock[0] = 0x01;
-
-    aBlock[5] = dir;
-
-    aBlock[6] = address & 0xFF;
-    aBlock[7] = ( address >> 8 ) & 0xFF;
-    aBlock[8] = ( address >> 16 ) & 0xFF;
-    aBlock[9] = ( address >> 24 ) & 0xFF;
-
-    aBlock[10] = frameCounter & 0xFF;
-    aBlock[11] = ( frameCounter >> 8 ) & 0xFF;
-    aBlock[12] = ( frameCounter >> 16 ) & 0xFF;
-    aBlock[13] = ( frameCounter >> 24 ) & 0xFF;
+    PrepareABlock( address, dir, frameCounter, aBlock );
 
     while( size > 0 )
     {
         aBlock[15] = ctr & 0xFF;
         ctr++;
-        if( SecureElementAesEncrypt( aBlock, 16, keyID, sBlock ) != SECURE_ELEMENT_SUCCESS )
+        if( ComputeKeystreamBlock( keyID, aBlock, sBlock ) != SECURE_ELEMENT_SUCCESS )
         {
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
@@ -177,28 +258,18 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, int16_t size, KeyI
 
 #if( USE_LRWAN_1_1_X_CRYPTO == 1 )
 /*
- * Encrypts the FOpts
+ * Prepares the counter block of the FOpts encryption
  *
  * \param[IN]  address          - Address
  * \param[IN]  dir              - Frame direction ( Uplink or Downlink )
  * \param[IN]  fCntID           - Frame counter identifier
  * \param[IN]  frameCounter     - Frame counter
- * \param[IN]  size             - Size of data
- * \param[IN/OUT]  buffer       - Data buffer
+ * \param[OUT] aBlock           - Counter block
  * \retval                      - Status of the operation
  */
-static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint8_t dir, FCntIdentifier_t fCntID, uint32_t frameCounter, uint8_t* buffer )
+static LoRaMacCryptoStatus_t PrepareFOptsABlock( uint32_t address, uint8_t dir, FCntIdentifier_t fCntID, uint32_t frameCounter, uint8_t* aBlock )
 {
-    if( buffer == 0 )
-    {
-        return LORAMAC_CRYPTO_ERROR_NPE;
-    }
-
-    uint8_t bufferIndex = 0;
-    uint8_t sBlock[16] = { 0 };
-    uint8_t aBlock[16] = { 0 };
-
-    aBlock[0] = 0x01;
+    PrepareABlock( address, dir, frameCounter, aBlock );
 
     if( CryptoNvm->LrWanVersion.Value > 0x01010000 )
     {
@@ -223,29 +294,42 @@ static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint
             default:
                 return LORAMAC_CRYPTO_FAIL_PARAM;
         }
-    }
 
-    aBlock[5] = dir;
+        aBlock[15] = 0x01;
+    }
+    return LORAMAC_CRYPTO_SUCCESS;
+}
 
-    aBlock[6] = address & 0xFF;
-    aBlock[7] = ( address >> 8 ) & 0xFF;
-    aBlock[8] = ( address >> 16 ) & 0xFF;
-    aBlock[9] = ( address >> 24 ) & 0xFF;
+/*
+ * Encrypts the FOpts
+ *
+ * \param[IN]  address          - Address
+ * \param[IN]  dir              - Frame direction ( Uplink or Downlink )
+ * \param[IN]  fCntID           - Frame counter identifier
+ * \param[IN]  frameCounter     - Frame counter
+ * \param[IN]  size             - Size of data
+ * \param[IN/OUT]  buffer       - Data buffer
+ * \retval                      - Status of the operation
+ */
+static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint8_t dir, FCntIdentifier_t fCntID, uint32_t frameCounter, uint8_t* buffer )
+{
+    if( buffer == 0 )
+    {
+        return LORAMAC_CRYPTO_ERROR_NPE;
+    }
 
-    aBlock[10] = frameCounter & 0xFF;
-    aBlock[11] = ( frameCounter >> 8 ) & 0xFF;
-    aBlock[12] = ( frameCounter >> 16 ) & 0xFF;
-    aBlock[13] = ( frameCounter >> 24 ) & 0xFF;
+    uint8_t bufferIndex = 0;
+    uint8_t sBlock[16] = { 0 };
+    uint8_t aBlock[16] = { 0 };
 
-    if( CryptoNvm->LrWanVersion.Value > 0x01010000 )
+    if( PrepareFOptsABlock( address, dir, fCntID, frameCounter, aBlock ) != LORAMAC_CRYPTO_SUCCESS )
     {
-        // Introduced in LoRaWAN 1.1.1 specification
-        aBlock[15] = 0x01;
+        return LORAMAC_CRYPTO_FAIL_PARAM;
     }
 
     if( size > 0 )
     {
-        if( SecureElementAesEncrypt( aBlock, 16, NWK_S_ENC_KEY, sBlock ) != SECURE_ELEMENT_SUCCESS )
+        if( ComputeKeystreamBlock( NWK_S_ENC_KEY, aBlock, sBlock ) != SECURE_ELEMENT_SUCCESS )
         {
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
@@ -851,6 +935,8 @@ LoRaMacCryptoStatus_t LoRaMacCryptoInit( LoRaMacCryptoNvmData_t* nvm )
     // Reset frame counters
     ResetFCnts( );
 
+    LoRaMacCryptoResetKeystream( );
+
     return LORAMAC_CRYPTO_SUCCESS;
 }
 
@@ -958,6 +1044,8 @@ LoRaMacCryptoStatus_t LoRaMacCryptoSetMulticastReference( MulticastCtx_t* multic
 
 LoRaMacCryptoStatus_t LoRaMacCryptoSetKey( KeyIdentifier_t keyID, uint8_t* key )
 {
+    LoRaMacCryptoResetKeystream( );
+
     if( SecureElementSetKey( keyID, key ) != SECURE_ELEMENT_SUCCESS )
     {
         return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
@@ -1124,6 +1212,9 @@ LoRaMacCryptoStatus_t LoRaMacCryptoHandleJoinAccept( JoinReqIdentifier_t joinReq
     uint8_t versionMinor         = 0;
     uint16_t nonce               = CryptoNvm->DevNonce;
 
+    // The session keys are derived again
+    LoRaMacCryptoResetKeystream( );
+
     // Nonce selection depending on JoinReqType
     // JOIN_REQ     : CryptoNvm->DevNonce
     // REJOIN_REQ_0 : RJcount0
@@ -1378,6 +1469,67 @@ LoRaMacCryptoStatus_t LoRaMacCryptoSecureMessage( uint32_t fCntUp, uint8_t txDr,
     return LORAMAC_CRYPTO_SUCCESS;
 }
 
+LoRaMacCryptoStatus_t LoRaMacCryptoPrecomputeKeystream( uint32_t devAddr )
+{
+#if defined( LORAMAC_KEYSTREAM_CACHE_ENABLED )
+    uint32_t fCntUp = CryptoNvm->FCntList.FCntUp + 1;
+    uint8_t aBlock[16] = { 0 };
+
+    PrepareABlock( devAddr, UPLINK, fCntUp, aBlock );
+    aBlock[15] = 0x01;
+
+    // Already computed for the next uplink
+    if( ( Keystream[0].KeyID == APP_S_KEY ) && ( memcmp( Keystream[0].ABlock, aBlock, 16 ) == 0 ) )
+    {
+        return LORAMAC_CRYPTO_SUCCESS;
+    }
+    LoRaMacCryptoResetKeystream( );
+
+    // FRMPayload of an application port
+    for( uint8_t i = 0; i < CRYPTO_KEYSTREAM_PAYLOAD_BLOCKS; i++ )
+    {
+        aBlock[15] = i + 1;
+        if( SecureElementAesEncrypt( aBlock, 16, APP_S_KEY, Keystream[i].SBlock ) != SECURE_ELEMENT_SUCCESS )
+        {
+            LoRaMacCryptoResetKeystream( );
+            return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
+        }
+        memcpy1( Keystream[i].ABlock, aBlock, 16 );
+        Keystream[i].KeyID = APP_S_KEY;
+    }
+
+#if( USE_LRWAN_1_1_X_CRYPTO == 1 )
+    if( CryptoNvm->LrWanVersion.Fields.Minor == 1 )
+    {
+        KeystreamBlock_t* fOptsBlock = &Keystream[CRYPTO_KEYSTREAM_PAYLOAD_BLOCKS];
+
+        // FOpts
+        memset1( aBlock, 0, 16 );
+        PrepareFOptsABlock( devAddr, UPLINK, FCNT_UP, fCntUp, aBlock );
+        if( SecureElementAesEncrypt( aBlock, 16, NWK_S_ENC_KEY, fOptsBlock->SBlock ) != SECURE_ELEMENT_SUCCESS )
+        {
+            LoRaMacCryptoResetKeystream( );
+            return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
+        }
+        memcpy1( fOptsBlock->ABlock, aBlock, 16 );
+        fOptsBlock->KeyID = NWK_S_ENC_KEY;
+    }
+#endif
+#endif
+    return LORAMAC_CRYPTO_SUCCESS;
+}
+
+void LoRaMacCryptoResetKeystream( void )
+{
+#if defined( LORAMAC_KEYSTREAM_CACHE_ENABLED )
+    memset1( ( uint8_t* )Keystream, 0, sizeof( Keystream ) );
+    for( uint8_t i = 0; i < CRYPTO_KEYSTREAM_NB_BLOCKS; i++ )
+    {
+        Keystream[i].KeyID = NO_KEY;
+    }
+#endif
+}
+
 LoRaMacCryptoStatus_t LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID, uint32_t address, FCntIdentifier_t fCntID, uint32_t fCntDown, LoRaMacMessageData_t* macMsg )
 {
     if( macMsg == 0 )
@@ -281,6 +281,24 @@ LoRaMacCryptoStatus_t LoRaMacCryptoHandleJoinAccept( JoinReqIdentifier_t joinReq
  */
 LoRaMacCryptoStatus_t LoRaMacCryptoSecureMessage( uint32_t fCntUp, uint8_t txDr, uint8_t txCh, LoRaMacMessageData_t* macMsg );
 
+/*!
+ * Computes the keystream of the FRMPayload and of the FOpts of the next uplink
+ * ahead of time. LoRaMacCryptoSecureMessage uses it instead of encrypting the
+ * counter blocks when the uplink matches. Does nothing unless
+ * LORAMAC_KEYSTREAM_CACHE_ENABLED is defined.
+ *
+ * \param[IN]     devAddr         - Device address of the next uplink
+ * \retval                        - Status of the operation
+ */
+LoRaMacCryptoStatus_t LoRaMacCryptoPrecomputeKeystream( uint32_t devAddr );
+
+/*!
+ * Discards the keystream computed ahead of time. Must be called when the
+ * session keys change without LoRaMacCryptoSetKey, e.g. on a restore of the
+ * secure element NVM data.
+ */
+void LoRaMacCryptoResetKeystream( void );
+
 /*!
  * Unsecures a message (decryption + integrity verification).
  *
@@ -98,14 +98,16 @@ LoRaMacParserStatus_t LoRaMacParserData( LoRaMacMessageData_t* macMsg )
 
     // Initialize anyway with zero.
     macMsg->FPort = 0;
+    macMsg->FRMPayload = &macMsg->Buffer[bufItr];
     macMsg->FRMPayloadSize = 0;
 
     if( ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE ) > 0 )
     {
         macMsg->FPort = macMsg->Buffer[bufItr++];
 
+        // FRMPayload is a view into the message buffer. It is decrypted in place.
         macMsg->FRMPayloadSize = ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE );
-        memcpy1( macMsg->FRMPayload, &macMsg->Buffer[bufItr], macMsg->FRMPayloadSize );
+        macMsg->FRMPayload = &macMsg->Buffer[bufItr];
         bufItr = bufItr + macMsg->FRMPayloadSize;
     }
 
@@ -80,6 +80,9 @@ LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t *macMs
 /*!
  * Parse a serialized data message and fills the structured object.
  *
+ * \remark FRMPayload is set to point into the serialized message buffer,
+ *         no payload data is copied.
+ *
  * \param[IN/OUT] macMsg       - Data message object
  * \retval                     - Status of the operation
  */
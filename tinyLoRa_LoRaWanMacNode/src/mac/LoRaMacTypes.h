@@ -73,6 +73,7 @@ extern "C"
  * KR920        | SF12 - BW125
  * US915        | SF10 - BW125
  * RU864        | SF12 - BW125
+ * PRIV868      | SF12 - BW125
  */
 #define DR_0                                        0
 
@@ -89,6 +90,7 @@ extern "C"
  * KR920        | SF11 - BW125
  * US915        | SF9  - BW125
  * RU864        | SF11 - BW125
+ * PRIV868      | SF11 - BW125
  */
 #define DR_1                                        1
 
@@ -105,6 +107,7 @@ extern "C"
  * KR920        | SF10 - BW125
  * US915        | SF8  - BW125
  * RU864        | SF10 - BW125
+ * PRIV868      | SF10 - BW125
  */
 #define DR_2                                        2
 
@@ -121,6 +124,7 @@ extern "C"
  * KR920        | SF9  - BW125
  * US915        | SF7  - BW125
  * RU864        | SF9  - BW125
+ * PRIV868      | SF9  - BW125
  */
 #define DR_3                                        3
 
@@ -137,6 +141,7 @@ extern "C"
  * KR920        | SF8  - BW125
  * US915        | SF8  - BW500
  * RU864        | SF8  - BW125
+ * PRIV868      | SF8  - BW125
  */
 #define DR_4                                        4
 
@@ -151,8 +156,9 @@ extern "C"
  * EU868        | SF7  - BW125
  * IN865        | SF7  - BW125
  * KR920        | SF7  - BW125
- * US915        | RFU
+ * US915        | LR-FHSS CR1/3 - OCW1523
  * RU864        | SF7  - BW125
+ * PRIV868      | SF7  - BW125
  */
 #define DR_5                                        5
 
@@ -167,8 +173,9 @@ extern "C"
  * EU868        | SF7  - BW250
  * IN865        | SF7  - BW250
  * KR920        | RFU
- * US915        | RFU
+ * US915        | LR-FHSS CR2/3 - OCW1523
  * RU864        | SF7  - BW250
+ * PRIV868      | SF6  - BW125
  */
 #define DR_6                                        6
 
@@ -185,6 +192,7 @@ extern "C"
  * KR920        | RFU
  * US915        | RFU
  * RU864        | FSK
+ * PRIV868      | SF7  - BW250
  */
 #define DR_7                                        7
 
@@ -196,11 +204,12 @@ extern "C"
  * CN470        | RFU
  * CN779        | RFU
  * EU433        | RFU
- * EU868        | RFU
+ * EU868        | LR-FHSS CR1/3 - OCW137
  * IN865        | RFU
  * KR920        | RFU
  * US915        | SF12 - BW500
  * RU864        | RFU
+ * PRIV868      | SF5  - BW125
  */
 #define DR_8                                        8
 
@@ -212,11 +221,12 @@ extern "C"
  * CN470        | RFU
  * CN779        | RFU
  * EU433        | RFU
- * EU868        | RFU
+ * EU868        | LR-FHSS CR2/3 - OCW137
  * IN865        | RFU
  * KR920        | RFU
  * US915        | SF11 - BW500
  * RU864        | RFU
+ * PRIV868      | SF6  - BW250
  */
 #define DR_9                                        9
 
@@ -228,11 +238,12 @@ extern "C"
  * CN470        | RFU
  * CN779        | RFU
  * EU433        | RFU
- * EU868        | RFU
+ * EU868        | LR-FHSS CR1/3 - OCW336
  * IN865        | RFU
  * KR920        | RFU
  * US915        | SF10 - BW500
  * RU864        | RFU
+ * PRIV868      | SF7  - BW500
  */
 #define DR_10                                       10
 
@@ -244,11 +255,12 @@ extern "C"
  * CN470        | RFU
  * CN779        | RFU
  * EU433        | RFU
- * EU868        | RFU
+ * EU868        | LR-FHSS CR2/3 - OCW336
  * IN865        | RFU
  * KR920        | RFU
  * US915        | SF9  - BW500
  * RU864        | RFU
+ * PRIV868      | SF5  - BW250
  */
 #define DR_11                                       11
 
@@ -265,6 +277,7 @@ extern "C"
  * KR920        | RFU
  * US915        | SF8  - BW500
  * RU864        | RFU
+ * PRIV868      | SF6  - BW500
  */
 #define DR_12                                       12
 
@@ -281,6 +294,7 @@ extern "C"
  * KR920        | RFU
  * US915        | SF7  - BW500
  * RU864        | RFU
+ * PRIV868      | SF5  - BW500
  */
 #define DR_13                                       13
 
@@ -297,6 +311,7 @@ extern "C"
  * KR920        | RFU
  * US915        | RFU
  * RU864        | RFU
+ * PRIV868      | RFU
  */
 #define DR_14                                       14
 
@@ -313,6 +328,7 @@ extern "C"
  * KR920        | RFU
  * US915        | RFU
  * RU864        | RFU
+ * PRIV868      | RFU
  */
 #define DR_15                                       15
 
@@ -331,6 +347,7 @@ extern "C"
  * KR920        | Max EIRP
  * US915        | Max ERP
  * RU864        | Max EIRP
+ * PRIV868      | Max EIRP
  */
 #define TX_POWER_0                                  0
 
@@ -347,6 +364,7 @@ extern "C"
  * KR920        | Max EIRP - 2
  * US915        | Max ERP - 2
  * RU864        | Max EIRP - 2
+ * PRIV868      | Max EIRP - 2
  */
 #define TX_POWER_1                                  1
 
@@ -363,6 +381,7 @@ extern "C"
  * KR920        | Max EIRP - 4
  * US915        | Max ERP - 4
  * RU864        | Max EIRP - 4
+ * PRIV868      | Max EIRP - 4
  */
 #define TX_POWER_2                                  2
 
@@ -379,6 +398,7 @@ extern "C"
  * KR920        | Max EIRP - 6
  * US915        | Max ERP - 6
  * RU864        | Max EIRP - 6
+ * PRIV868      | Max EIRP - 6
  */
 #define TX_POWER_3                                  3
 
@@ -395,6 +415,7 @@ extern "C"
  * KR920        | Max EIRP - 8
  * US915        | Max ERP - 8
  * RU864        | Max EIRP - 8
+ * PRIV868      | Max EIRP - 8
  */
 #define TX_POWER_4                                  4
 
@@ -411,6 +432,7 @@ extern "C"
  * KR920        | Max EIRP - 10
  * US915        | Max ERP - 10
  * RU864        | Max EIRP - 10
+ * PRIV868      | Max EIRP - 10
  */
 #define TX_POWER_5                                  5
 
@@ -427,6 +449,7 @@ extern "C"
  * KR920        | Max EIRP - 12
  * US915        | Max ERP - 12
  * RU864        | Max EIRP - 12
+ * PRIV868      | Max EIRP - 12
  */
 #define TX_POWER_6                                  6
 
@@ -443,6 +466,7 @@ extern "C"
  * KR920        | Max EIRP - 14
  * US915        | Max ERP - 14
  * RU864        | Max EIRP - 14
+ * PRIV868      | Max EIRP - 14
  */
 #define TX_POWER_7                                  7
 
@@ -459,6 +483,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 16
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_8                                  8
 
@@ -475,6 +500,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 18
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_9                                  9
 
@@ -491,6 +517,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 20
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_10                                 10
 
@@ -507,6 +534,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 22
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_11                                 11
 
@@ -523,6 +551,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 24
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_12                                 12
 
@@ -539,6 +568,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 26
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_13                                 13
 
@@ -555,6 +585,7 @@ extern "C"
  * KR920        | -
  * US915        | Max ERP - 28
  * RU864        | -
+ * PRIV868      | -
  */
 #define TX_POWER_14                                 14
 
@@ -1176,6 +1207,11 @@ typedef struct sBand
      * Set to true when the band is ready for use.
      */
     bool ReadyForTransmission;
+    /*!
+     * The time at which the band had no credits left. The band
+     * is ready for an uplink of credit costs C after ReadyTime + C.
+     */
+    TimerTime_t ReadyTime;
 }Band_t;
 
 /*!
@@ -1199,7 +1235,7 @@ typedef union uDrRange
          *
          * The allowed ranges are region specific. Please refer to \ref DR_0 to \ref DR_15 for details.
          */
-        int8_t Min : 4;
+        uint8_t Min : 4;
         /*!
          * Maximum data rate
          *
@@ -1207,7 +1243,7 @@ typedef union uDrRange
          *
          * The allowed ranges are region specific. Please refer to \ref DR_0 to \ref DR_15 for details.
          */
-        int8_t Max : 4;
+        uint8_t Max : 4;
     }Fields;
 }DrRange_t;
 
@@ -1298,6 +1334,25 @@ typedef enum eLoRaMacBatteryLevel
     BAT_LEVEL_NO_MEASURE             = 0xFF,
 }LoRaMacBatteryLevel_t;
 
+/*!
+ * Listen before talk channel sense result
+ */
+typedef enum eChannelSenseResult
+{
+    /*!
+     * No channel sense result available
+     */
+    CHANNEL_SENSE_NONE,
+    /*!
+     * The sensed channel is free
+     */
+    CHANNEL_SENSE_FREE,
+    /*!
+     * The sensed channel is busy
+     */
+    CHANNEL_SENSE_BUSY,
+}ChannelSenseResult_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,263 @@
+/*!
+ * \file      mac-commands-bench.c
+ *
+ * \brief     Host stress benchmark of the MAC commands list
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs uplink cycles on LoRaMacCommands.c as the MAC does:
+ *            - answers to a downlink, with a burst of LinkAdrAns;
+ *            - the frame preparation, which queries the size, serializes the
+ *              commands into the FOpts or the FRMPayload and checks for
+ *              sticky commands;
+ *            - the RemoveMacCommands cycle after the Rx windows.
+ *            Sticky answers are only acknowledged every 16th cycle, so the
+ *            list holds many sticky commands most of the time. After every
+ *            operation the list, the serialized size and the sticky pending
+ *            state are checked against a walk of the list.
+ *
+ *            A list inconsistency fails the mac-commands-bench test of the
+ *            host board. From the src directory:
+ *
+ *            S="boards/mcu/utilities.c"
+ *            I="-Imac -Imac/region -Isystem -Iradio -Iboards -Iperipherals"
+ *            gcc -O2 $I mac/bench/mac-commands-bench.c mac/LoRaMacCommands.c $S -o mac-commands-bench
+ *            ./mac-commands-bench
+ *
+ *            To compare with an earlier implementation without the previous
+ *            element link, build the same file against it with
+ *            -DBENCH_NO_PREV_LINK, e.g. from git show <rev>:./mac/LoRaMacCommands.c.
+ */
+#include <stdio.h>
+#include <time.h>
+#include "utilities.h"
+#include "LoRaMacCommands.h"
+
+/*!
+ * Number of timed uplink cycles
+ */
+#define BENCH_CYCLES                                200000
+
+/*!
+ * Number of uplink cycles with the list checked after every operation
+ */
+#define BENCH_CHECKED_CYCLES                        20000
+
+/*!
+ * LinkAdrReq blocks of a downlink, each answered by a LinkAdrAns
+ */
+#define BENCH_LINK_ADR_BURST                        6
+
+/*!
+ * Size of the FOpts field and of the largest FRMPayload
+ */
+#define BENCH_FOPTS_SIZE                            15
+#define BENCH_FRM_PAYLOAD_SIZE                      242
+
+static uint32_t BenchRandomState = 0x12345678;
+
+static bool BenchCheckEnabled = false;
+
+static uint32_t BenchErrors = 0;
+
+static uint32_t BenchRandom( void )
+{
+    BenchRandomState ^= BenchRandomState << 13;
+    BenchRandomState ^= BenchRandomState >> 17;
+    BenchRandomState ^= BenchRandomState << 5;
+    return BenchRandomState;
+}
+
+static double BenchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*!
+ * \brief Checks the list against the module counters. The head of the list
+ *        is the first command of a CID which follows no other command.
+ */
+static void BenchCheck( void )
+{
+    MacCommand_t* firstOfCid[0x20] = { NULL };
+    MacCommand_t* first = NULL;
+    MacCommand_t* cur;
+#if !defined( BENCH_NO_PREV_LINK )
+    MacCommand_t* prev = NULL;
+#endif
+    size_t size = 0;
+    size_t moduleSize = 0;
+    bool sticky = false;
+    bool moduleSticky = false;
+    uint32_t nbCmds = 0;
+
+    if( BenchCheckEnabled == false )
+    {
+        return;
+    }
+
+    for( uint8_t cid = 0; cid < 0x20; cid++ )
+    {
+        LoRaMacCommandsGetCmd( cid, &firstOfCid[cid] );
+    }
+    for( uint8_t cid = 0; cid < 0x20; cid++ )
+    {
+        bool isNext = false;
+
+        for( uint8_t i = 0; ( i < 0x20 ) && ( firstOfCid[cid] != NULL ); i++ )
+        {
+            for( cur = firstOfCid[i]; cur != NULL; cur = cur->Next )
+            {
+                isNext |= ( cur->Next == firstOfCid[cid] );
+            }
+        }
+        if( ( firstOfCid[cid] != NULL ) && ( isNext == false ) )
+        {
+            first = firstOfCid[cid];
+        }
+    }
+    for( cur = first; cur != NULL; cur = cur->Next )
+    {
+#if !defined( BENCH_NO_PREV_LINK )
+        if( cur->Prev != prev )
+        {
+            BenchErrors++;
+            break;
+        }
+        prev = cur;
+#endif
+        if( nbCmds > 64 )
+        {
+            BenchErrors++;
+            break;
+        }
+        size += 1 + cur->PayloadSize;
+        sticky |= cur->IsSticky;
+        nbCmds++;
+    }
+    LoRaMacCommandsGetSizeSerializedCmds( &moduleSize );
+    LoRaMacCommandsStickyCmdsPending( &moduleSticky );
+    if( ( size != moduleSize ) || ( sticky != moduleSticky ) || ( ( first == NULL ) && ( moduleSize != 0 ) ) )
+    {
+        BenchErrors++;
+    }
+}
+
+static void BenchAddCmd( uint8_t cid, size_t payloadSize )
+{
+    uint8_t payload[LORAMAC_COMMADS_MAX_NUM_OF_PARAMS] = { cid };
+
+    LoRaMacCommandsAddCmd( cid, payload, payloadSize );
+    BenchCheck( );
+}
+
+/*!
+ * \brief Runs one uplink cycle.
+ *
+ * \retval Serialized MAC commands size of the uplink.
+ */
+static size_t BenchCycle( uint32_t cycle )
+{
+    uint8_t buffer[BENCH_FRM_PAYLOAD_SIZE];
+    MacCommand_t* macCmd;
+    size_t macCmdsSize = 0;
+    bool stickyPending = false;
+
+    // Answers to the last downlink
+    switch( cycle % 4 )
+    {
+        case 0:
+        {
+            for( uint8_t i = 0; i < BENCH_LINK_ADR_BURST; i++ )
+            {
+                BenchAddCmd( MOTE_MAC_LINK_ADR_ANS, 1 );
+            }
+            break;
+        }
+        case 1:
+        {
+            BenchAddCmd( MOTE_MAC_RX_PARAM_SETUP_ANS, 1 );
+            BenchAddCmd( MOTE_MAC_DL_CHANNEL_ANS, 1 );
+            BenchAddCmd( MOTE_MAC_DEV_STATUS_ANS, 2 );
+            break;
+        }
+        case 2:
+        {
+            BenchAddCmd( MOTE_MAC_RX_TIMING_SETUP_ANS, 0 );
+            BenchAddCmd( MOTE_MAC_TX_PARAM_SETUP_ANS, 0 );
+            for( uint8_t i = 0; i < BENCH_LINK_ADR_BURST; i++ )
+            {
+                BenchAddCmd( MOTE_MAC_LINK_ADR_ANS, 1 );
+            }
+            break;
+        }
+        default:
+        {
+            BenchAddCmd( MOTE_MAC_NEW_CHANNEL_ANS, 1 );
+            BenchAddCmd( MOTE_MAC_RESET_IND, 1 );
+            break;
+        }
+    }
+
+    // Frame preparation
+    LoRaMacCommandsGetSizeSerializedCmds( &macCmdsSize );
+    if( macCmdsSize > 0 )
+    {
+        if( ( ( BenchRandom( ) % 2 ) == 0 ) && ( macCmdsSize <= BENCH_FOPTS_SIZE ) )
+        {
+            LoRaMacCommandsSerializeCmds( BENCH_FOPTS_SIZE, &macCmdsSize, buffer );
+        }
+        else
+        {
+            LoRaMacCommandsSerializeCmds( BENCH_FRM_PAYLOAD_SIZE, &macCmdsSize, buffer );
+        }
+        BenchCheck( );
+    }
+    LoRaMacCommandsStickyCmdsPending( &stickyPending );
+
+    // ResetConf of the server
+    if( LoRaMacCommandsGetCmd( MOTE_MAC_RESET_IND, &macCmd ) == LORAMAC_COMMANDS_SUCCESS )
+    {
+        LoRaMacCommandsRemoveCmd( macCmd );
+        BenchCheck( );
+    }
+
+    // RemoveMacCommands cycle, sticky answers acknowledged every 16th cycle
+    LoRaMacCommandsRemoveNoneStickyCmds( );
+    BenchCheck( );
+    if( ( cycle % 16 ) == 15 )
+    {
+        LoRaMacCommandsRemoveStickyAnsCmds( );
+        BenchCheck( );
+    }
+    return macCmdsSize + ( stickyPending ? 1 : 0 );
+}
+
+int main( void )
+{
+    volatile size_t sink = 0;
+    double t0;
+
+    LoRaMacCommandsInit( );
+    BenchCheckEnabled = true;
+    for( uint32_t i = 0; i < BENCH_CHECKED_CYCLES; i++ )
+    {
+        sink += BenchCycle( i );
+    }
+    BenchCheckEnabled = false;
+
+    LoRaMacCommandsInit( );
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_CYCLES; i++ )
+    {
+        sink += BenchCycle( i );
+    }
+    t0 = BenchNow( ) - t0;
+
+    printf( "%u checked cycles, %u errors, %7.1f ns/uplink cycle\n",
+            BENCH_CHECKED_CYCLES, ( unsigned )BenchErrors, t0 / BENCH_CYCLES );
+    return ( BenchErrors == 0 ) ? 0 : 1;
+}
@@ -51,6 +51,7 @@
 #define AS923_DL_CHANNEL_REQ( )                    AS923_CASE { return RegionAS923DlChannelReq( dlChannelReq ); }
 #define AS923_ALTERNATE_DR( )                      AS923_CASE { return RegionAS923AlternateDr( currentDr, type ); }
 #define AS923_NEXT_CHANNEL( )                      AS923_CASE { return RegionAS923NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define AS923_GET_NEXT_TX_DELAY( )                 AS923_CASE { return RegionAS923GetNextTxDelay( nextChanParams ); }
 #define AS923_CHANNEL_ADD( )                       AS923_CASE { return RegionAS923ChannelAdd( channelAdd ); }
 #define AS923_CHANNEL_REMOVE( )                    AS923_CASE { return RegionAS923ChannelsRemove( channelRemove ); }
 #define AS923_APPLY_DR_OFFSET( )                   AS923_CASE { return RegionAS923ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -74,6 +75,7 @@
 #define AS923_DL_CHANNEL_REQ( )
 #define AS923_ALTERNATE_DR( )
 #define AS923_NEXT_CHANNEL( )
+#define AS923_GET_NEXT_TX_DELAY( )
 #define AS923_CHANNEL_ADD( )
 #define AS923_CHANNEL_REMOVE( )
 #define AS923_APPLY_DR_OFFSET( )
@@ -100,6 +102,7 @@
 #define AU915_DL_CHANNEL_REQ( )                    AU915_CASE { return RegionAU915DlChannelReq( dlChannelReq ); }
 #define AU915_ALTERNATE_DR( )                      AU915_CASE { return RegionAU915AlternateDr( currentDr, type ); }
 #define AU915_NEXT_CHANNEL( )                      AU915_CASE { return RegionAU915NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define AU915_GET_NEXT_TX_DELAY( )                 AU915_CASE { return RegionAU915GetNextTxDelay( nextChanParams ); }
 #define AU915_CHANNEL_ADD( )                       AU915_CASE { return RegionAU915ChannelAdd( channelAdd ); }
 #define AU915_CHANNEL_REMOVE( )                    AU915_CASE { return RegionAU915ChannelsRemove( channelRemove ); }
 #define AU915_APPLY_DR_OFFSET( )                   AU915_CASE { return RegionAU915ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -123,6 +126,7 @@
 #define AU915_DL_CHANNEL_REQ( )
 #define AU915_ALTERNATE_DR( )
 #define AU915_NEXT_CHANNEL( )
+#define AU915_GET_NEXT_TX_DELAY( )
 #define AU915_CHANNEL_ADD( )
 #define AU915_CHANNEL_REMOVE( )
 #define AU915_APPLY_DR_OFFSET( )
@@ -149,6 +153,7 @@
 #define CN470_DL_CHANNEL_REQ( )                    CN470_CASE { return RegionCN470DlChannelReq( dlChannelReq ); }
 #define CN470_ALTERNATE_DR( )                      CN470_CASE { return RegionCN470AlternateDr( currentDr, type ); }
 #define CN470_NEXT_CHANNEL( )                      CN470_CASE { return RegionCN470NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define CN470_GET_NEXT_TX_DELAY( )                 CN470_CASE { return RegionCN470GetNextTxDelay( nextChanParams ); }
 #define CN470_CHANNEL_ADD( )                       CN470_CASE { return RegionCN470ChannelAdd( channelAdd ); }
 #define CN470_CHANNEL_REMOVE( )                    CN470_CASE { return RegionCN470ChannelsRemove( channelRemove ); }
 #define CN470_APPLY_DR_OFFSET( )                   CN470_CASE { return RegionCN470ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -172,6 +177,7 @@
 #define CN470_DL_CHANNEL_REQ( )
 #define CN470_ALTERNATE_DR( )
 #define CN470_NEXT_CHANNEL( )
+#define CN470_GET_NEXT_TX_DELAY( )
 #define CN470_CHANNEL_ADD( )
 #define CN470_CHANNEL_REMOVE( )
 #define CN470_APPLY_DR_OFFSET( )
@@ -198,6 +204,7 @@
 #define CN779_DL_CHANNEL_REQ( )                    CN779_CASE { return RegionCN779DlChannelReq( dlChannelReq ); }
 #define CN779_ALTERNATE_DR( )                      CN779_CASE { return RegionCN779AlternateDr( currentDr, type ); }
 #define CN779_NEXT_CHANNEL( )                      CN779_CASE { return RegionCN779NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define CN779_GET_NEXT_TX_DELAY( )                 CN779_CASE { return RegionCN779GetNextTxDelay( nextChanParams ); }
 #define CN779_CHANNEL_ADD( )                       CN779_CASE { return RegionCN779ChannelAdd( channelAdd ); }
 #define CN779_CHANNEL_REMOVE( )                    CN779_CASE { return RegionCN779ChannelsRemove( channelRemove ); }
 #define CN779_APPLY_DR_OFFSET( )                   CN779_CASE { return RegionCN779ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -221,6 +228,7 @@
 #define CN779_DL_CHANNEL_REQ( )
 #define CN779_ALTERNATE_DR( )
 #define CN779_NEXT_CHANNEL( )
+#define CN779_GET_NEXT_TX_DELAY( )
 #define CN779_CHANNEL_ADD( )
 #define CN779_CHANNEL_REMOVE( )
 #define CN779_APPLY_DR_OFFSET( )
@@ -247,6 +255,7 @@
 #define EU433_DL_CHANNEL_REQ( )                    EU433_CASE { return RegionEU433DlChannelReq( dlChannelReq ); }
 #define EU433_ALTERNATE_DR( )                      EU433_CASE { return RegionEU433AlternateDr( currentDr, type ); }
 #define EU433_NEXT_CHANNEL( )                      EU433_CASE { return RegionEU433NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define EU433_GET_NEXT_TX_DELAY( )                 EU433_CASE { return RegionEU433GetNextTxDelay( nextChanParams ); }
 #define EU433_CHANNEL_ADD( )                       EU433_CASE { return RegionEU433ChannelAdd( channelAdd ); }
 #define EU433_CHANNEL_REMOVE( )                    EU433_CASE { return RegionEU433ChannelsRemove( channelRemove ); }
 #define EU433_APPLY_DR_OFFSET( )                   EU433_CASE { return RegionEU433ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -270,6 +279,7 @@
 #define EU433_DL_CHANNEL_REQ( )
 #define EU433_ALTERNATE_DR( )
 #define EU433_NEXT_CHANNEL( )
+#define EU433_GET_NEXT_TX_DELAY( )
 #define EU433_CHANNEL_ADD( )
 #define EU433_CHANNEL_REMOVE( )
 #define EU433_APPLY_DR_OFFSET( )
@@ -296,6 +306,7 @@
 #define EU868_DL_CHANNEL_REQ( )                    EU868_CASE { return RegionEU868DlChannelReq( dlChannelReq ); }
 #define EU868_ALTERNATE_DR( )                      EU868_CASE { return RegionEU868AlternateDr( currentDr, type ); }
 #define EU868_NEXT_CHANNEL( )                      EU868_CASE { return RegionEU868NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define EU868_GET_NEXT_TX_DELAY( )                 EU868_CASE { return RegionEU868GetNextTxDelay( nextChanParams ); }
 #define EU868_CHANNEL_ADD( )                       EU868_CASE { return RegionEU868ChannelAdd( channelAdd ); }
 #define EU868_CHANNEL_REMOVE( )                    EU868_CASE { return RegionEU868ChannelsRemove( channelRemove ); }
 #define EU868_APPLY_DR_OFFSET( )                   EU868_CASE { return RegionEU868ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -319,6 +330,7 @@
 #define EU868_DL_CHANNEL_REQ( )
 #define EU868_ALTERNATE_DR( )
 #define EU868_NEXT_CHANNEL( )
+#define EU868_GET_NEXT_TX_DELAY( )
 #define EU868_CHANNEL_ADD( )
 #define EU868_CHANNEL_REMOVE( )
 #define EU868_APPLY_DR_OFFSET( )
@@ -345,6 +357,7 @@
 #define KR920_DL_CHANNEL_REQ( )                    KR920_CASE { return RegionKR920DlChannelReq( dlChannelReq ); }
 #define KR920_ALTERNATE_DR( )                      KR920_CASE { return RegionKR920AlternateDr( currentDr, type ); }
 #define KR920_NEXT_CHANNEL( )                      KR920_CASE { return RegionKR920NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define KR920_GET_NEXT_TX_DELAY( )                 KR920_CASE { return RegionKR920GetNextTxDelay( nextChanParams ); }
 #define KR920_CHANNEL_ADD( )                       KR920_CASE { return RegionKR920ChannelAdd( channelAdd ); }
 #define KR920_CHANNEL_REMOVE( )                    KR920_CASE { return RegionKR920ChannelsRemove( channelRemove ); }
 #define KR920_APPLY_DR_OFFSET( )                   KR920_CASE { return RegionKR920ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -368,6 +381,7 @@
 #define KR920_DL_CHANNEL_REQ( )
 #define KR920_ALTERNATE_DR( )
 #define KR920_NEXT_CHANNEL( )
+#define KR920_GET_NEXT_TX_DELAY( )
 #define KR920_CHANNEL_ADD( )
 #define KR920_CHANNEL_REMOVE( )
 #define KR920_APPLY_DR_OFFSET( )
@@ -394,6 +408,7 @@
 #define IN865_DL_CHANNEL_REQ( )                    IN865_CASE { return RegionIN865DlChannelReq( dlChannelReq ); }
 #define IN865_ALTERNATE_DR( )                      IN865_CASE { return RegionIN865AlternateDr( currentDr, type ); }
 #define IN865_NEXT_CHANNEL( )                      IN865_CASE { return RegionIN865NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define IN865_GET_NEXT_TX_DELAY( )                 IN865_CASE { return RegionIN865GetNextTxDelay( nextChanParams ); }
 #define IN865_CHANNEL_ADD( )                       IN865_CASE { return RegionIN865ChannelAdd( channelAdd ); }
 #define IN865_CHANNEL_REMOVE( )                    IN865_CASE { return RegionIN865ChannelsRemove( channelRemove ); }
 #define IN865_APPLY_DR_OFFSET( )                   IN865_CASE { return RegionIN865ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -417,6 +432,7 @@
 #define IN865_DL_CHANNEL_REQ( )
 #define IN865_ALTERNATE_DR( )
 #define IN865_NEXT_CHANNEL( )
+#define IN865_GET_NEXT_TX_DELAY( )
 #define IN865_CHANNEL_ADD( )
 #define IN865_CHANNEL_REMOVE( )
 #define IN865_APPLY_DR_OFFSET( )
@@ -443,6 +459,7 @@
 #define US915_DL_CHANNEL_REQ( )                    US915_CASE { return RegionUS915DlChannelReq( dlChannelReq ); }
 #define US915_ALTERNATE_DR( )                      US915_CASE { return RegionUS915AlternateDr( currentDr, type ); }
 #define US915_NEXT_CHANNEL( )                      US915_CASE { return RegionUS915NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define US915_GET_NEXT_TX_DELAY( )                 US915_CASE { return RegionUS915GetNextTxDelay( nextChanParams ); }
 #define US915_CHANNEL_ADD( )                       US915_CASE { return RegionUS915ChannelAdd( channelAdd ); }
 #define US915_CHANNEL_REMOVE( )                    US915_CASE { return RegionUS915ChannelsRemove( channelRemove ); }
 #define US915_APPLY_DR_OFFSET( )                   US915_CASE { return RegionUS915ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -466,6 +483,7 @@
 #define US915_DL_CHANNEL_REQ( )
 #define US915_ALTERNATE_DR( )
 #define US915_NEXT_CHANNEL( )
+#define US915_GET_NEXT_TX_DELAY( )
 #define US915_CHANNEL_ADD( )
 #define US915_CHANNEL_REMOVE( )
 #define US915_APPLY_DR_OFFSET( )
@@ -492,6 +510,7 @@
 #define RU864_DL_CHANNEL_REQ( )                    RU864_CASE { return RegionRU864DlChannelReq( dlChannelReq ); }
 #define RU864_ALTERNATE_DR( )                      RU864_CASE { return RegionRU864AlternateDr( currentDr, type ); }
 #define RU864_NEXT_CHANNEL( )                      RU864_CASE { return RegionRU864NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define RU864_GET_NEXT_TX_DELAY( )                 RU864_CASE { return RegionRU864GetNextTxDelay( nextChanParams ); }
 #define RU864_CHANNEL_ADD( )                       RU864_CASE { return RegionRU864ChannelAdd( channelAdd ); }
 #define RU864_CHANNEL_REMOVE( )                    RU864_CASE { return RegionRU864ChannelsRemove( channelRemove ); }
 #define RU864_APPLY_DR_OFFSET( )                   RU864_CASE { return RegionRU864ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
@@ -515,12 +534,64 @@
 #define RU864_DL_CHANNEL_REQ( )
 #define RU864_ALTERNATE_DR( )
 #define RU864_NEXT_CHANNEL( )
+#define RU864_GET_NEXT_TX_DELAY( )
 #define RU864_CHANNEL_ADD( )
 #define RU864_CHANNEL_REMOVE( )
 #define RU864_APPLY_DR_OFFSET( )
 #define RU864_RX_BEACON_SETUP( )
 #endif
 
+#ifdef REGION_PRIV868
+#include "RegionPRIV868.h"
+#define PRIV868_CASE                               case LORAMAC_REGION_PRIV868:
+#define PRIV868_IS_ACTIVE( )                       PRIV868_CASE { return true; }
+#define PRIV868_GET_PHY_PARAM( )                   PRIV868_CASE { return RegionPRIV868GetPhyParam( getPhy ); }
+#define PRIV868_SET_BAND_TX_DONE( )                PRIV868_CASE { RegionPRIV868SetBandTxDone( txDone ); break; }
+#define PRIV868_INIT_DEFAULTS( )                   PRIV868_CASE { RegionPRIV868InitDefaults( params ); break; }
+#define PRIV868_VERIFY( )                          PRIV868_CASE { return RegionPRIV868Verify( verify, phyAttribute ); }
+#define PRIV868_APPLY_CF_LIST( )                   PRIV868_CASE { RegionPRIV868ApplyCFList( applyCFList ); break; }
+#define PRIV868_CHAN_MASK_SET( )                   PRIV868_CASE { return RegionPRIV868ChanMaskSet( chanMaskSet ); }
+#define PRIV868_COMPUTE_RX_WINDOW_PARAMETERS( )    PRIV868_CASE { RegionPRIV868ComputeRxWindowParameters( datarate, minRxSymbols, rxError, rxConfigParams ); break; }
+#define PRIV868_RX_CONFIG( )                       PRIV868_CASE { return RegionPRIV868RxConfig( rxConfig, datarate ); }
+#define PRIV868_TX_CONFIG( )                       PRIV868_CASE { return RegionPRIV868TxConfig( txConfig, txPower, txTimeOnAir ); }
+#define PRIV868_LINK_ADR_REQ( )                    PRIV868_CASE { return RegionPRIV868LinkAdrReq( linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed ); }
+#define PRIV868_RX_PARAM_SETUP_REQ( )              PRIV868_CASE { return RegionPRIV868RxParamSetupReq( rxParamSetupReq ); }
+#define PRIV868_NEW_CHANNEL_REQ( )                 PRIV868_CASE { return RegionPRIV868NewChannelReq( newChannelReq ); }
+#define PRIV868_TX_PARAM_SETUP_REQ( )              PRIV868_CASE { return RegionPRIV868TxParamSetupReq( txParamSetupReq ); }
+#define PRIV868_DL_CHANNEL_REQ( )                  PRIV868_CASE { return RegionPRIV868DlChannelReq( dlChannelReq ); }
+#define PRIV868_ALTERNATE_DR( )                    PRIV868_CASE { return RegionPRIV868AlternateDr( currentDr, type ); }
+#define PRIV868_NEXT_CHANNEL( )                    PRIV868_CASE { return RegionPRIV868NextChannel( nextChanParams, channel, time, aggregatedTimeOff ); }
+#define PRIV868_GET_NEXT_TX_DELAY( )               PRIV868_CASE { return RegionPRIV868GetNextTxDelay( nextChanParams ); }
+#define PRIV868_CHANNEL_ADD( )                     PRIV868_CASE { return RegionPRIV868ChannelAdd( channelAdd ); }
+#define PRIV868_CHANNEL_REMOVE( )                  PRIV868_CASE { return RegionPRIV868ChannelsRemove( channelRemove ); }
+#define PRIV868_APPLY_DR_OFFSET( )                 PRIV868_CASE { return RegionPRIV868ApplyDrOffset( downlinkDwellTime, dr, drOffset ); }
+#define PRIV868_RX_BEACON_SETUP( )                 PRIV868_CASE { RegionPRIV868RxBeaconSetup( rxBeaconSetup, outDr ); break; }
+#else
+#define PRIV868_IS_ACTIVE( )
+#define PRIV868_GET_PHY_PARAM( )
+#define PRIV868_SET_BAND_TX_DONE( )
+#define PRIV868_INIT_DEFAULTS( )
+#define PRIV868_VERIFY( )
+#define PRIV868_APPLY_CF_LIST( )
+#define PRIV868_CHAN_MASK_SET( )
+#define PRIV868_COMPUTE_RX_WINDOW_PARAMETERS( )
+#define PRIV868_RX_CONFIG( )
+#define PRIV868_TX_CONFIG( )
+#define PRIV868_LINK_ADR_REQ( )
+#define PRIV868_RX_PARAM_SETUP_REQ( )
+#define PRIV868_NEW_CHANNEL_REQ( )
+#define PRIV868_TX_PARAM_SETUP_REQ( )
+#define PRIV868_DL_CHANNEL_REQ( )
+#define PRIV868_ALTERNATE_DR( )
+#define PRIV868_NEXT_CHANNEL( )
+#define PRIV868_GET_NEXT_TX_DELAY( )
+#define PRIV868_CHANNEL_ADD( )
+#define PRIV868_CHANNEL_REMOVE( )
+#define PRIV868_APPLY_DR_OFFSET( )
+#define PRIV868_RX_BEACON_SETUP( )
+#endif
+
+#ifndef REGION_SINGLE
 bool RegionIsActive( LoRaMacRegion_t region )
 {
     switch( region )
@@ -535,6 +606,7 @@ bool RegionIsActive( LoRaMacRegion_t region )
         IN865_IS_ACTIVE( );
         US915_IS_ACTIVE( );
         RU864_IS_ACTIVE( );
+        PRIV868_IS_ACTIVE( );
         default:
         {
             return false;
@@ -557,6 +629,7 @@ PhyParam_t RegionGetPhyParam( LoRaMacRegion_t region, GetPhyParams_t* getPhy )
         IN865_GET_PHY_PARAM( );
         US915_GET_PHY_PARAM( );
         RU864_GET_PHY_PARAM( );
+        PRIV868_GET_PHY_PARAM( );
         default:
         {
             return phyParam;
@@ -578,6 +651,7 @@ void RegionSetBandTxDone( LoRaMacRegion_t region, SetBandTxDoneParams_t* txDone
         IN865_SET_BAND_TX_DONE( );
         US915_SET_BAND_TX_DONE( );
         RU864_SET_BAND_TX_DONE( );
+        PRIV868_SET_BAND_TX_DONE( );
         default:
         {
             return;
@@ -599,6 +673,7 @@ void RegionInitDefaults( LoRaMacRegion_t region, InitDefaultsParams_t* params )
         IN865_INIT_DEFAULTS( );
         US915_INIT_DEFAULTS( );
         RU864_INIT_DEFAULTS( );
+        PRIV868_INIT_DEFAULTS( );
         default:
         {
             break;
@@ -620,6 +695,7 @@ bool RegionVerify( LoRaMacRegion_t region, VerifyParams_t* verify, PhyAttribute_
         IN865_VERIFY( );
         US915_VERIFY( );
         RU864_VERIFY( );
+        PRIV868_VERIFY( );
         default:
         {
             return false;
@@ -641,6 +717,7 @@ void RegionApplyCFList( LoRaMacRegion_t region, ApplyCFListParams_t* applyCFList
         IN865_APPLY_CF_LIST( );
         US915_APPLY_CF_LIST( );
         RU864_APPLY_CF_LIST( );
+        PRIV868_APPLY_CF_LIST( );
         default:
         {
             break;
@@ -662,6 +739,7 @@ bool RegionChanMaskSet( LoRaMacRegion_t region, ChanMaskSetParams_t* chanMaskSet
         IN865_CHAN_MASK_SET( );
         US915_CHAN_MASK_SET( );
         RU864_CHAN_MASK_SET( );
+        PRIV868_CHAN_MASK_SET( );
         default:
         {
             return false;
@@ -683,6 +761,7 @@ void RegionComputeRxWindowParameters( LoRaMacRegion_t region, int8_t datarate, u
         IN865_COMPUTE_RX_WINDOW_PARAMETERS( );
         US915_COMPUTE_RX_WINDOW_PARAMETERS( );
         RU864_COMPUTE_RX_WINDOW_PARAMETERS( );
+        PRIV868_COMPUTE_RX_WINDOW_PARAMETERS( );
         default:
         {
             break;
@@ -704,6 +783,7 @@ bool RegionRxConfig( LoRaMacRegion_t region, RxConfigParams_t* rxConfig, int8_t*
         IN865_RX_CONFIG( );
         US915_RX_CONFIG( );
         RU864_RX_CONFIG( );
+        PRIV868_RX_CONFIG( );
         default:
         {
             return false;
@@ -725,6 +805,7 @@ bool RegionTxConfig( LoRaMacRegion_t region, TxConfigParams_t* txConfig, int8_t*
         IN865_TX_CONFIG( );
         US915_TX_CONFIG( );
         RU864_TX_CONFIG( );
+        PRIV868_TX_CONFIG( );
         default:
         {
             return false;
@@ -746,6 +827,7 @@ uint8_t RegionLinkAdrReq( LoRaMacRegion_t region, LinkAdrReqParams_t* linkAdrReq
         IN865_LINK_ADR_REQ( );
         US915_LINK_ADR_REQ( );
         RU864_LINK_ADR_REQ( );
+        PRIV868_LINK_ADR_REQ( );
         default:
         {
             return 0;
@@ -767,6 +849,7 @@ uint8_t RegionRxParamSetupReq( LoRaMacRegion_t region, RxParamSetupReqParams_t*
         IN865_RX_PARAM_SETUP_REQ( );
         US915_RX_PARAM_SETUP_REQ( );
         RU864_RX_PARAM_SETUP_REQ( );
+        PRIV868_RX_PARAM_SETUP_REQ( );
         default:
         {
             return 0;
@@ -788,6 +871,7 @@ int8_t RegionNewChannelReq( LoRaMacRegion_t region, NewChannelReqParams_t* newCh
         IN865_NEW_CHANNEL_REQ( );
         US915_NEW_CHANNEL_REQ( );
         RU864_NEW_CHANNEL_REQ( );
+        PRIV868_NEW_CHANNEL_REQ( );
         default:
         {
             return 0;
@@ -809,6 +893,7 @@ int8_t RegionTxParamSetupReq( LoRaMacRegion_t region, TxParamSetupReqParams_t* t
         IN865_TX_PARAM_SETUP_REQ( );
         US915_TX_PARAM_SETUP_REQ( );
         RU864_TX_PARAM_SETUP_REQ( );
+        PRIV868_TX_PARAM_SETUP_REQ( );
         default:
         {
             return 0;
@@ -830,6 +915,7 @@ int8_t RegionDlChannelReq( LoRaMacRegion_t region, DlChannelReqParams_t* dlChann
         IN865_DL_CHANNEL_REQ( );
         US915_DL_CHANNEL_REQ( );
         RU864_DL_CHANNEL_REQ( );
+        PRIV868_DL_CHANNEL_REQ( );
         default:
         {
             return 0;
@@ -851,6 +937,7 @@ int8_t RegionAlternateDr( LoRaMacRegion_t region, int8_t currentDr, AlternateDrT
         IN865_ALTERNATE_DR( );
         US915_ALTERNATE_DR( );
         RU864_ALTERNATE_DR( );
+        PRIV868_ALTERNATE_DR( );
         default:
         {
             return 0;
@@ -872,6 +959,7 @@ LoRaMacStatus_t RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nex
         IN865_NEXT_CHANNEL( );
         US915_NEXT_CHANNEL( );
         RU864_NEXT_CHANNEL( );
+        PRIV868_NEXT_CHANNEL( );
         default:
         {
             return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
@@ -879,6 +967,28 @@ LoRaMacStatus_t RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nex
     }
 }
 
+TimerTime_t RegionGetNextTxDelay( LoRaMacRegion_t region, NextChanParams_t* nextChanParams )
+{
+    switch( region )
+    {
+        AS923_GET_NEXT_TX_DELAY( );
+        AU915_GET_NEXT_TX_DELAY( );
+        CN470_GET_NEXT_TX_DELAY( );
+        CN779_GET_NEXT_TX_DELAY( );
+        EU433_GET_NEXT_TX_DELAY( );
+        EU868_GET_NEXT_TX_DELAY( );
+        IN865_GET_NEXT_TX_DELAY( );
+        KR920_GET_NEXT_TX_DELAY( );
+        RU864_GET_NEXT_TX_DELAY( );
+        US915_GET_NEXT_TX_DELAY( );
+        PRIV868_GET_NEXT_TX_DELAY( );
+        default:
+        {
+            return TIMERTIME_T_MAX;
+        }
+    }
+}
+
 LoRaMacStatus_t RegionChannelAdd( LoRaMacRegion_t region, ChannelAddParams_t* channelAdd )
 {
     switch( region )
@@ -893,6 +1003,7 @@ LoRaMacStatus_t RegionChannelAdd( LoRaMacRegion_t region, ChannelAddParams_t* ch
         IN865_CHANNEL_ADD( );
         US915_CHANNEL_ADD( );
         RU864_CHANNEL_ADD( );
+        PRIV868_CHANNEL_ADD( );
         default:
         {
             return LORAMAC_STATUS_PARAMETER_INVALID;
@@ -914,6 +1025,7 @@ bool RegionChannelsRemove( LoRaMacRegion_t region, ChannelRemoveParams_t* channe
         IN865_CHANNEL_REMOVE( );
         US915_CHANNEL_REMOVE( );
         RU864_CHANNEL_REMOVE( );
+        PRIV868_CHANNEL_REMOVE( );
         default:
         {
             return false;
@@ -935,6 +1047,7 @@ uint8_t RegionApplyDrOffset( LoRaMacRegion_t region, uint8_t downlinkDwellTime,
         IN865_APPLY_DR_OFFSET( );
         US915_APPLY_DR_OFFSET( );
         RU864_APPLY_DR_OFFSET( );
+        PRIV868_APPLY_DR_OFFSET( );
         default:
         {
             return dr;
@@ -956,12 +1069,14 @@ void RegionRxBeaconSetup( LoRaMacRegion_t region, RxBeaconSetup_t* rxBeaconSetup
         IN865_RX_BEACON_SETUP( );
         US915_RX_BEACON_SETUP( );
         RU864_RX_BEACON_SETUP( );
+        PRIV868_RX_BEACON_SETUP( );
         default:
         {
             break;
         }
     }
 }
+#endif // REGION_SINGLE
 
 Version_t RegionGetVersion( void )
 {
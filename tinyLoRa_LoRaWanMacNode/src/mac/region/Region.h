@@ -46,6 +46,7 @@
  *              - #define REGION_IN865
  *              - #define REGION_US915
  *              - #define REGION_RU864
+ *              - #define REGION_PRIV868
  *
  * \{
  */
@@ -392,7 +393,7 @@ typedef union uPhyParam
     /*!
      * Pointer to the channels.
      */
-    ChannelParams_t* Channels;
+    const ChannelParams_t* Channels;
     /*!
      * Beacon format
      */
@@ -802,6 +803,10 @@ typedef struct sNextChanParams
      * Payload length of the next frame
      */
     uint16_t PktLen;
+    /*!
+     * Result of the channel sense started by the previous call
+     */
+    ChannelSenseResult_t ChannelSense;
 }NextChanParams_t;
 
 /*!
@@ -1101,6 +1106,20 @@ int8_t RegionAlternateDr( LoRaMacRegion_t region, int8_t currentDr, AlternateDrT
  */
 LoRaMacStatus_t RegionNextChannel( LoRaMacRegion_t region, NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *        and the aggregated time-off, without updating the bands
+ *
+ * \param [IN] region LoRaWAN region.
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink, PktLen being the
+ *                            PHY payload size.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown, not joined or
+ *         no channel supports the datarate].
+ */
+TimerTime_t RegionGetNextTxDelay( LoRaMacRegion_t region, NextChanParams_t* nextChanParams );
+
 /*!
  * \brief Adds a channel.
  *
@@ -1152,6 +1171,103 @@ void RegionRxBeaconSetup( LoRaMacRegion_t region, RxBeaconSetup_t* rxBeaconSetup
  */
 Version_t RegionGetVersion( void );
 
+#ifdef REGION_SINGLE
+/*
+ * Single region build. The dispatch functions of Region.c are not built, each
+ * call goes straight to the region functions. This saves the dispatch code in
+ * flash. The region functions live in their own translation units, so the calls
+ * are only inlined with link time optimization ( -flto ), which also folds the
+ * Region.c switch when a single region is enabled: the speed gain comes from
+ * -flto, not from this mode.
+ * The region argument is not evaluated, LoRaMacInitialization rejects any other
+ * region through RegionIsActive.
+ */
+#if ( defined( REGION_AS923 ) + \
+       defined( REGION_AU915 ) + \
+       defined( REGION_CN470 ) + \
+       defined( REGION_CN779 ) + \
+       defined( REGION_EU433 ) + \
+       defined( REGION_EU868 ) + \
+       defined( REGION_KR920 ) + \
+       defined( REGION_IN865 ) + \
+       defined( REGION_US915 ) + \
+       defined( REGION_RU864 ) + \
+       defined( REGION_PRIV868 ) ) != 1
+#error "REGION_SINGLE requires exactly one enabled region."
+#endif
+
+#if defined( REGION_AS923 )
+#include "RegionAS923.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_AS923
+#define REGION_SINGLE_CALL( name )                  RegionAS923##name
+#elif defined( REGION_AU915 )
+#include "RegionAU915.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_AU915
+#define REGION_SINGLE_CALL( name )                  RegionAU915##name
+#elif defined( REGION_CN470 )
+#include "RegionCN470.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_CN470
+#define REGION_SINGLE_CALL( name )                  RegionCN470##name
+#elif defined( REGION_CN779 )
+#include "RegionCN779.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_CN779
+#define REGION_SINGLE_CALL( name )                  RegionCN779##name
+#elif defined( REGION_EU433 )
+#include "RegionEU433.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_EU433
+#define REGION_SINGLE_CALL( name )                  RegionEU433##name
+#elif defined( REGION_EU868 )
+#include "RegionEU868.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_EU868
+#define REGION_SINGLE_CALL( name )                  RegionEU868##name
+#elif defined( REGION_KR920 )
+#include "RegionKR920.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_KR920
+#define REGION_SINGLE_CALL( name )                  RegionKR920##name
+#elif defined( REGION_IN865 )
+#include "RegionIN865.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_IN865
+#define REGION_SINGLE_CALL( name )                  RegionIN865##name
+#elif defined( REGION_US915 )
+#include "RegionUS915.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_US915
+#define REGION_SINGLE_CALL( name )                  RegionUS915##name
+#elif defined( REGION_RU864 )
+#include "RegionRU864.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_RU864
+#define REGION_SINGLE_CALL( name )                  RegionRU864##name
+#elif defined( REGION_PRIV868 )
+#include "RegionPRIV868.h"
+#define REGION_SINGLE_ID                            LORAMAC_REGION_PRIV868
+#define REGION_SINGLE_CALL( name )                  RegionPRIV868##name
+#endif
+
+#define RegionIsActive( region )                                                        ( ( region ) == REGION_SINGLE_ID )
+#define RegionGetPhyParam( region, getPhy )                                             REGION_SINGLE_CALL( GetPhyParam )( getPhy )
+#define RegionSetBandTxDone( region, txDone )                                           REGION_SINGLE_CALL( SetBandTxDone )( txDone )
+#define RegionInitDefaults( region, params )                                            REGION_SINGLE_CALL( InitDefaults )( params )
+#define RegionVerify( region, verify, phyAttribute )                                    REGION_SINGLE_CALL( Verify )( verify, phyAttribute )
+#define RegionApplyCFList( region, applyCFList )                                        REGION_SINGLE_CALL( ApplyCFList )( applyCFList )
+#define RegionChanMaskSet( region, chanMaskSet )                                        REGION_SINGLE_CALL( ChanMaskSet )( chanMaskSet )
+#define RegionComputeRxWindowParameters( region, datarate, minRxSymbols, rxError, rxConfigParams ) \
+    REGION_SINGLE_CALL( ComputeRxWindowParameters )( datarate, minRxSymbols, rxError, rxConfigParams )
+#define RegionRxConfig( region, rxConfig, datarate )                                    REGION_SINGLE_CALL( RxConfig )( rxConfig, datarate )
+#define RegionTxConfig( region, txConfig, txPower, txTimeOnAir )                        REGION_SINGLE_CALL( TxConfig )( txConfig, txPower, txTimeOnAir )
+#define RegionLinkAdrReq( region, linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed ) \
+    REGION_SINGLE_CALL( LinkAdrReq )( linkAdrReq, drOut, txPowOut, nbRepOut, nbBytesParsed )
+#define RegionRxParamSetupReq( region, rxParamSetupReq )                                REGION_SINGLE_CALL( RxParamSetupReq )( rxParamSetupReq )
+#define RegionNewChannelReq( region, newChannelReq )                                    REGION_SINGLE_CALL( NewChannelReq )( newChannelReq )
+#define RegionTxParamSetupReq( region, txParamSetupReq )                                REGION_SINGLE_CALL( TxParamSetupReq )( txParamSetupReq )
+#define RegionDlChannelReq( region, dlChannelReq )                                      REGION_SINGLE_CALL( DlChannelReq )( dlChannelReq )
+#define RegionAlternateDr( region, currentDr, type )                                    REGION_SINGLE_CALL( AlternateDr )( currentDr, type )
+#define RegionNextChannel( region, nextChanParams, channel, time, aggregatedTimeOff )   REGION_SINGLE_CALL( NextChannel )( nextChanParams, channel, time, aggregatedTimeOff )
+#define RegionGetNextTxDelay( region, nextChanParams )                                  REGION_SINGLE_CALL( GetNextTxDelay )( nextChanParams )
+#define RegionChannelAdd( region, channelAdd )                                          REGION_SINGLE_CALL( ChannelAdd )( channelAdd )
+#define RegionChannelsRemove( region, channelRemove )                                   REGION_SINGLE_CALL( ChannelsRemove )( channelRemove )
+#define RegionApplyDrOffset( region, downlinkDwellTime, dr, drOffset )                  REGION_SINGLE_CALL( ApplyDrOffset )( downlinkDwellTime, dr, drOffset )
+#define RegionRxBeaconSetup( region, rxBeaconSetup, outDr )                             REGION_SINGLE_CALL( RxBeaconSetup )( rxBeaconSetup, outDr )
+#endif // REGION_SINGLE
+
 /*! \} defgroup REGION */
 
 #ifdef __cplusplus
@@ -46,6 +46,12 @@ static RegionNvmDataGroup1_t* RegionNvmGroup1;
 static RegionNvmDataGroup2_t* RegionNvmGroup2;
 static Band_t* RegionBands;
 
+/*
+ * Channels of the fixed channel plan. They never change, only the channels
+ * mask in the NVM data selects the ones in use.
+ */
+static const ChannelParams_t ChannelsAU915[AU915_MAX_NB_CHANNELS] = AU915_CHANNELS;
+
 static bool VerifyRfFreq( uint32_t freq )
 {
     // Check radio driver support
@@ -123,7 +129,7 @@ PhyParam_t RegionAU915GetPhyParam( GetPhyParams_t* getPhy )
                 .MinDr = ( int8_t )( ( getPhy->UplinkDwellTime == 0 ) ? AU915_TX_MIN_DATARATE : AU915_DWELL_LIMIT_DATARATE ),
                 .NbChannels = AU915_MAX_NB_CHANNELS,
                 .ChannelsMask = RegionNvmGroup2->ChannelsMask,
-                .Channels = RegionNvmGroup2->Channels,
+                .Channels = ChannelsAU915,
             };
             phyParam.Value = RegionCommonGetNextLowerTxDr( &nextLowerTxDrParams );
             break;
@@ -227,7 +233,7 @@ PhyParam_t RegionAU915GetPhyParam( GetPhyParams_t* getPhy )
         }
         case PHY_CHANNELS:
         {
-            phyParam.Channels = RegionNvmGroup2->Channels;
+            phyParam.Channels = ChannelsAU915;
             break;
         }
         case PHY_DEF_UPLINK_DWELL_TIME:
@@ -312,7 +318,7 @@ PhyParam_t RegionAU915GetPhyParam( GetPhyParams_t* getPhy )
 
 void RegionAU915SetBandTxDone( SetBandTxDoneParams_t* txDone )
 {
-    RegionCommonSetBandTxDone( &RegionBands[RegionNvmGroup2->Channels[txDone->Channel].Band],
+    RegionCommonSetBandTxDone( &RegionBands[ChannelsAU915[txDone->Channel].Band],
                                txDone->LastTxAirTime, txDone->Joined, txDone->ElapsedTimeSinceStartUp );
 }
 
@@ -345,22 +351,6 @@ void RegionAU915InitDefaults( InitDefaultsParams_t* params )
             // Default bands
             memcpy1( ( uint8_t* )RegionBands, ( uint8_t* )bands, sizeof( Band_t ) * AU915_MAX_NB_BANDS );
 
-            // Channels
-            for( uint8_t i = 0; i < AU915_MAX_NB_CHANNELS - 8; i++ )
-            {
-                // 125 kHz channels
-                RegionNvmGroup2->Channels[i].Frequency = 915200000 + i * 200000;
-                RegionNvmGroup2->Channels[i].DrRange.Value = ( DR_5 << 4 ) | DR_0;
-                RegionNvmGroup2->Channels[i].Band = 0;
-            }
-            for( uint8_t i = AU915_MAX_NB_CHANNELS - 8; i < AU915_MAX_NB_CHANNELS; i++ )
-            {
-                // 500 kHz channels
-                RegionNvmGroup2->Channels[i].Frequency = 915900000 + ( i - ( AU915_MAX_NB_CHANNELS - 8 ) ) * 1600000;
-                RegionNvmGroup2->Channels[i].DrRange.Value = ( DR_6 << 4 ) | DR_6;
-                RegionNvmGroup2->Channels[i].Band = 0;
-            }
-
             // Initialize channels default mask
             RegionNvmGroup2->ChannelsDefaultMask[0] = 0xFFFF;
             RegionNvmGroup2->ChannelsDefaultMask[1] = 0xFFFF;
@@ -547,7 +537,7 @@ bool RegionAU915RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
 bool RegionAU915TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir )
 {
     int8_t phyDr = DataratesAU915[txConfig->Datarate];
-    int8_t txPowerLimited = RegionCommonLimitTxPower( txConfig->TxPower, RegionBands[RegionNvmGroup2->Channels[txConfig->Channel].Band].TxMaxPower );
+    int8_t txPowerLimited = RegionCommonLimitTxPower( txConfig->TxPower, RegionBands[ChannelsAU915[txConfig->Channel].Band].TxMaxPower );
     uint32_t bandwidth = RegionCommonGetBandwidth( txConfig->Datarate, BandwidthsAU915 );
     int8_t phyTxPower = 0;
 
@@ -555,7 +545,7 @@ bool RegionAU915TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    Radio.SetChannel( ChannelsAU915[txConfig->Channel].Frequency );
 
     Radio.SetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
 
@@ -617,57 +607,15 @@ uint8_t RegionAU915LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
         }
         else if( linkAdrParams.ChMaskCtrl == 5 )
         {
-            // Start value for comparision
-            uint8_t bitMask = 1;
+            // 8 MSBs of ChMask are RFU. Bit i enables the bank i of 8 125kHz
+            // channels and the 500kHz channel 64 + i.
+            uint8_t banks = linkAdrParams.ChMask & 0x00FF;
 
-            // cntChannelMask for channelsMask[0] until channelsMask[3]
-            uint8_t cntChannelMask = 0;
-
-            // i will be 1, 2, 3, ..., 7
-            for( uint8_t i = 0; i <= 7; i++ )
+            for( uint8_t i = 0; i < 4; i++, banks >>= 2 )
             {
-                // 8 MSBs of ChMask are RFU
-                // Checking if the ChMask is set, then true
-                if( ( ( linkAdrParams.ChMask & 0x00FF ) & ( bitMask << i ) ) != 0 )
-                {
-                    if( ( i % 2 ) == 0 )
-                    {
-                        // Enable a bank of 8 125kHz channels, 8 LSBs
-                        channelsMask[cntChannelMask] |= 0x00FF;
-                        // Enable the corresponding 500kHz channel
-                        channelsMask[4] |= ( bitMask << i );
-                    }
-                    else
-                    {
-                        // Enable a bank of 8 125kHz channels, 8 MSBs
-                        channelsMask[cntChannelMask] |= 0xFF00;
-                        // Enable the corresponding 500kHz channel
-                        channelsMask[4] |= ( bitMask << i );
-                        // cntChannelMask increment for uneven i
-                        cntChannelMask++;
-                    }
-                }
-                // ChMask is not set
-                else
-                {
-                    if( ( i % 2 ) == 0 )
-                    {
-                        // Disable a bank of 8 125kHz channels, 8 LSBs
-                        channelsMask[cntChannelMask] &= 0xFF00;
-                        // Disable the corresponding 500kHz channel
-                        channelsMask[4] &= ~( bitMask << i );
-                    }
-                    else
-                    {
-                        // Enable a bank of 8 125kHz channels, 8 MSBs
-                        channelsMask[cntChannelMask] &= 0x00FF;
-                        // Disable the corresponding 500kHz channel
-                        channelsMask[4] &= ~( bitMask << i );
-                        // cntChannelMask increment for uneven i
-                        cntChannelMask++;
-                    }
-                }
+                channelsMask[i] = ( 0x00FF * ( banks & 0x01 ) ) | ( 0xFF00 * ( ( banks >> 1 ) & 0x01 ) );
             }
+            channelsMask[4] = ( channelsMask[4] & 0xFF00 ) | ( linkAdrParams.ChMask & 0x00FF );
         }
         else
         {
@@ -698,7 +646,7 @@ uint8_t RegionAU915LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
     linkAdrVerifyParams.ChannelsMask = channelsMask;
     linkAdrVerifyParams.MinDatarate = ( int8_t )phyParam.Value;
     linkAdrVerifyParams.MaxDatarate = AU915_TX_MAX_DATARATE;
-    linkAdrVerifyParams.Channels = RegionNvmGroup2->Channels;
+    linkAdrVerifyParams.Channels = ChannelsAU915;
     linkAdrVerifyParams.MinTxPower = AU915_MIN_TX_POWER;
     linkAdrVerifyParams.MaxTxPower = AU915_MAX_TX_POWER;
     linkAdrVerifyParams.Version = linkAdrReq->Version;
@@ -712,10 +660,7 @@ uint8_t RegionAU915LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
         // Copy Mask
         RegionCommonChanMaskCopy( RegionNvmGroup2->ChannelsMask, channelsMask, 6 );
 
-        RegionNvmGroup1->ChannelsMaskRemaining[0] &= RegionNvmGroup2->ChannelsMask[0];
-        RegionNvmGroup1->ChannelsMaskRemaining[1] &= RegionNvmGroup2->ChannelsMask[1];
-        RegionNvmGroup1->ChannelsMaskRemaining[2] &= RegionNvmGroup2->ChannelsMask[2];
-        RegionNvmGroup1->ChannelsMaskRemaining[3] &= RegionNvmGroup2->ChannelsMask[3];
+        RegionCommonChanMaskAnd( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, 4 );
         RegionNvmGroup1->ChannelsMaskRemaining[4] = RegionNvmGroup2->ChannelsMask[4];
         RegionNvmGroup1->ChannelsMaskRemaining[5] = RegionNvmGroup2->ChannelsMask[5];
     }
@@ -831,7 +776,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
     countChannelsParams.ChannelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
-    countChannelsParams.Channels = RegionNvmGroup2->Channels;
+    countChannelsParams.Channels = ChannelsAU915;
     countChannelsParams.Bands = RegionBands;
     countChannelsParams.MaxNbChannels = AU915_MAX_NB_CHANNELS;
     countChannelsParams.JoinChannels = NULL;
@@ -877,12 +822,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
             else
             {
                 // Choose the next available channel
-                uint8_t i = 0;
-                while( ( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) & ( 1 << i ) ) == 0 )
-                {
-                    i++;
-                }
-                *channel = 64 + i;
+                *channel = 64 + RegionCommonChanMaskFirst( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK );
             }
         }
 
@@ -892,6 +832,33 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     return status;
 }
 
+TimerTime_t RegionAU915GetNextTxDelay( NextChanParams_t* nextChanParams )
+{
+    RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
+    RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
+
+    countChannelsParams.Joined = nextChanParams->Joined;
+    countChannelsParams.Datarate = nextChanParams->Datarate;
+    countChannelsParams.ChannelsMask = RegionNvmGroup2->ChannelsMask;
+    countChannelsParams.Channels = ChannelsAU915;
+    countChannelsParams.Bands = RegionBands;
+    countChannelsParams.MaxNbChannels = AU915_MAX_NB_CHANNELS;
+    countChannelsParams.JoinChannels = NULL;
+
+    identifyChannelsParam.AggrTimeOff = nextChanParams->AggrTimeOff;
+    identifyChannelsParam.LastAggrTx = nextChanParams->LastAggrTx;
+    identifyChannelsParam.DutyCycleEnabled = nextChanParams->DutyCycleEnabled;
+    identifyChannelsParam.MaxBands = AU915_MAX_NB_BANDS;
+
+    identifyChannelsParam.ElapsedTimeSinceStartUp = nextChanParams->ElapsedTimeSinceStartUp;
+    identifyChannelsParam.LastTxIsJoinRequest = nextChanParams->LastTxIsJoinRequest;
+    identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
+
+    identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+
+    return RegionCommonGetNextTxDelay( &identifyChannelsParam );
+}
+
 LoRaMacStatus_t RegionAU915ChannelAdd( ChannelAddParams_t* channelAdd )
 {
     return LORAMAC_STATUS_PARAMETER_INVALID;
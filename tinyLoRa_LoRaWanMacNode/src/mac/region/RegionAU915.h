@@ -200,10 +200,36 @@ extern "C"
 
 /*!
  * Band 0 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define AU915_BAND0                                 { 1, AU915_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  100.0 %
 
+/*!
+ * 125 kHz upstream channel i of the channel plan, i = 0 to 63
+ */
+#define AU915_125KHZ_CHANNEL( i )                   { 915200000 + ( i ) * 200000, 0, { ( ( DR_5 << 4 ) | DR_0 ) }, 0 }
+
+/*!
+ * 500 kHz upstream channel i of the channel plan, i = 0 to 7
+ */
+#define AU915_500KHZ_CHANNEL( i )                   { 915900000 + ( i ) * 1600000, 0, { ( ( DR_6 << 4 ) | DR_6 ) }, 0 }
+
+/*!
+ * Channels of the fixed channel plan, selected by the channels mask only
+ */
+#define AU915_CHANNELS                              \
+{                                                   \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 24 ), \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 32 ), \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 40 ), \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 48 ), \
+    REGION_COMMON_CHANNELS_8( AU915_125KHZ_CHANNEL, 56 ), \
+    REGION_COMMON_CHANNELS_8( AU915_500KHZ_CHANNEL, 0 ),  \
+}
+
 /*!
  * Defines the first channel for RX window 1 for US band
  */
@@ -415,6 +441,15 @@ int8_t RegionAU915AlternateDr( int8_t currentDr, AlternateDrType_t type );
  */
 LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown or no channel].
+ */
+TimerTime_t RegionAU915GetNextTxDelay( NextChanParams_t* nextChanParams );
+
 /*!
  * \brief Adds a channel.
  *
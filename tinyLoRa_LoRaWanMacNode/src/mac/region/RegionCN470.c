@@ -49,7 +49,7 @@
 #endif
 
 
-ChannelParams_t CommonJoinChannels[] = CN470_COMMON_JOIN_CHANNELS;
+const ChannelParams_t CommonJoinChannels[] = CN470_COMMON_JOIN_CHANNELS;
 
 /*!
  * Definition of the regional channel plan.
@@ -107,7 +107,7 @@ typedef struct sRegionCN470ChannelPlanCtx
      * \retval Status of the operation. Return 0x07 if the channels mask is valid.
      */
     uint8_t ( *LinkAdrChMaskUpdate )( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                      uint16_t chanMask, ChannelParams_t* channels );
+                                      uint16_t chanMask, const ChannelParams_t* channels );
     /*!
      * \brief Verifies if the frequency provided is valid.
      *
@@ -117,11 +117,10 @@ typedef struct sRegionCN470ChannelPlanCtx
      */
     bool ( *VerifyRfFreq )( uint32_t frequency );
     /*!
-     * \brief Initializes all channels, datarates, frequencies and bands.
-     *
-     * \param [IN] channels A pointer to the available channels.
+     * Channels of the channel plan, a const table of CN470_PLAN_NB_CHANNELS
+     * channels.
      */
-    void ( *InitializeChannels )( ChannelParams_t* channels );
+    const ChannelParams_t* Channels;
     /*!
      * \brief Initializes the channels mask and the channels default mask.
      *
@@ -175,7 +174,7 @@ static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, Region
             ctx->GetBeaconChannelOffset = RegionCN470A20GetBeaconChannelOffset;
             ctx->LinkAdrChMaskUpdate = RegionCN470A20LinkAdrChMaskUpdate;
             ctx->VerifyRfFreq = RegionCN470A20VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470A20InitializeChannels;
+            ctx->Channels = RegionCN470A20Channels;
             ctx->InitializeChannelsMask = RegionCN470A20InitializeChannelsMask;
             ctx->GetRx1Frequency = RegionCN470A20GetRx1Frequency;
             ctx->GetRx2Frequency = RegionCN470A20GetRx2Frequency;
@@ -191,7 +190,7 @@ static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, Region
             ctx->GetBeaconChannelOffset = RegionCN470B20GetBeaconChannelOffset;
             ctx->LinkAdrChMaskUpdate = RegionCN470B20LinkAdrChMaskUpdate;
             ctx->VerifyRfFreq = RegionCN470B20VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470B20InitializeChannels;
+            ctx->Channels = RegionCN470B20Channels;
             ctx->InitializeChannelsMask = RegionCN470B20InitializeChannelsMask;
             ctx->GetRx1Frequency = RegionCN470B20GetRx1Frequency;
             ctx->GetRx2Frequency = RegionCN470B20GetRx2Frequency;
@@ -207,7 +206,7 @@ static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, Region
             ctx->GetBeaconChannelOffset = RegionCN470A26GetBeaconChannelOffset;
             ctx->LinkAdrChMaskUpdate = RegionCN470A26LinkAdrChMaskUpdate;
             ctx->VerifyRfFreq = RegionCN470A26VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470A26InitializeChannels;
+            ctx->Channels = RegionCN470A26Channels;
             ctx->InitializeChannelsMask = RegionCN470A26InitializeChannelsMask;
             ctx->GetRx1Frequency = RegionCN470A26GetRx1Frequency;
             ctx->GetRx2Frequency = RegionCN470A26GetRx2Frequency;
@@ -223,7 +222,7 @@ static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, Region
             ctx->GetBeaconChannelOffset = RegionCN470B26GetBeaconChannelOffset;
             ctx->LinkAdrChMaskUpdate = RegionCN470B26LinkAdrChMaskUpdate;
             ctx->VerifyRfFreq = RegionCN470B26VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470B26InitializeChannels;
+            ctx->Channels = RegionCN470B26Channels;
             ctx->InitializeChannelsMask = RegionCN470B26InitializeChannelsMask;
             ctx->GetRx1Frequency = RegionCN470B26GetRx1Frequency;
             ctx->GetRx2Frequency = RegionCN470B26GetRx2Frequency;
@@ -240,7 +239,7 @@ static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, Region
             ctx->GetBeaconChannelOffset = RegionCN470A20GetBeaconChannelOffset;
             ctx->LinkAdrChMaskUpdate = RegionCN470A20LinkAdrChMaskUpdate;
             ctx->VerifyRfFreq = RegionCN470A20VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470A20InitializeChannels;
+            ctx->Channels = RegionCN470A20Channels;
             ctx->InitializeChannelsMask = RegionCN470A20InitializeChannelsMask;
             ctx->GetRx1Frequency = RegionCN470A20GetRx1Frequency;
             ctx->GetRx2Frequency = RegionCN470A20GetRx2Frequency;
@@ -319,9 +318,9 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
                 .CurrentDr = getPhy->Datarate,
                 .MaxDr = ( int8_t )CN470_TX_MAX_DATARATE,
                 .MinDr = ( int8_t )CN470_TX_MIN_DATARATE,
-                .NbChannels = CN470_MAX_NB_CHANNELS,
+                .NbChannels = CN470_PLAN_NB_CHANNELS,
                 .ChannelsMask = RegionNvmGroup2->ChannelsMask,
-                .Channels = RegionNvmGroup2->Channels,
+                .Channels = ChannelPlanCtx.Channels,
             };
             phyParam.Value = RegionCommonGetNextLowerTxDr( &nextLowerTxDrParams );
             break;
@@ -418,12 +417,12 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
         }
         case PHY_MAX_NB_CHANNELS:
         {
-            phyParam.Value = CN470_MAX_NB_CHANNELS;
+            phyParam.Value = CN470_PLAN_NB_CHANNELS;
             break;
         }
         case PHY_CHANNELS:
         {
-            phyParam.Channels = RegionNvmGroup2->Channels;
+            phyParam.Channels = ChannelPlanCtx.Channels;
             break;
         }
         case PHY_DEF_UPLINK_DWELL_TIME:
@@ -537,7 +536,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
 
 void RegionCN470SetBandTxDone( SetBandTxDoneParams_t* txDone )
 {
-    RegionCommonSetBandTxDone( &RegionBands[RegionNvmGroup2->Channels[txDone->Channel].Band],
+    RegionCommonSetBandTxDone( &RegionBands[ChannelPlanCtx.Channels[txDone->Channel].Band],
                                txDone->LastTxAirTime, txDone->Joined, txDone->ElapsedTimeSinceStartUp );
 }
 
@@ -572,9 +571,6 @@ void RegionCN470InitDefaults( InitDefaultsParams_t* params )
             // Apply the channel plan configuration
             ApplyChannelPlanConfig( RegionNvmGroup2->ChannelPlan, &ChannelPlanCtx );
 
-            // Default channels
-            ChannelPlanCtx.InitializeChannels( RegionNvmGroup2->Channels );
-
             // Default ChannelsMask
             ChannelPlanCtx.InitializeChannelsMask( RegionNvmGroup2->ChannelsDefaultMask );
 
@@ -767,7 +763,7 @@ bool RegionCN470TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
 {
     RadioModems_t modem;
     int8_t phyDr = DataratesCN470[txConfig->Datarate];
-    int8_t txPowerLimited = RegionCommonLimitTxPower( txConfig->TxPower, RegionBands[RegionNvmGroup2->Channels[txConfig->Channel].Band].TxMaxPower );
+    int8_t txPowerLimited = RegionCommonLimitTxPower( txConfig->TxPower, RegionBands[ChannelPlanCtx.Channels[txConfig->Channel].Band].TxMaxPower );
     uint32_t bandwidth = RegionCommonGetBandwidth( txConfig->Datarate, BandwidthsCN470 );
     int8_t phyTxPower = 0;
 
@@ -775,7 +771,7 @@ bool RegionCN470TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    Radio.SetChannel( ChannelPlanCtx.Channels[txConfig->Channel].Frequency );
 
     if( txConfig->Datarate == DR_7 )
     { // High Speed FSK channel
@@ -825,7 +821,7 @@ uint8_t RegionCN470LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
 
         // Update the channel plan
         status = ChannelPlanCtx.LinkAdrChMaskUpdate( channelsMask, linkAdrParams.ChMaskCtrl,
-                                                     linkAdrParams.ChMask, RegionNvmGroup2->Channels );
+                                                     linkAdrParams.ChMask, ChannelPlanCtx.Channels );
     }
 
     // Make sure at least one channel is active
@@ -847,11 +843,11 @@ uint8_t RegionCN470LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
     linkAdrVerifyParams.CurrentDatarate = linkAdrReq->CurrentDatarate;
     linkAdrVerifyParams.CurrentTxPower = linkAdrReq->CurrentTxPower;
     linkAdrVerifyParams.CurrentNbRep = linkAdrReq->CurrentNbRep;
-    linkAdrVerifyParams.NbChannels = CN470_MAX_NB_CHANNELS;
+    linkAdrVerifyParams.NbChannels = CN470_PLAN_NB_CHANNELS;
     linkAdrVerifyParams.ChannelsMask = channelsMask;
     linkAdrVerifyParams.MinDatarate = ( int8_t )phyParam.Value;
     linkAdrVerifyParams.MaxDatarate = CN470_TX_MAX_DATARATE;
-    linkAdrVerifyParams.Channels = RegionNvmGroup2->Channels;
+    linkAdrVerifyParams.Channels = ChannelPlanCtx.Channels;
     linkAdrVerifyParams.MinTxPower = CN470_MIN_TX_POWER;
     linkAdrVerifyParams.MaxTxPower = CN470_MAX_TX_POWER;
     linkAdrVerifyParams.Version = linkAdrReq->Version;
@@ -865,10 +861,7 @@ uint8_t RegionCN470LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
         // Copy Mask
         RegionCommonChanMaskCopy( RegionNvmGroup2->ChannelsMask, channelsMask, CHANNELS_MASK_SIZE );
 
-        RegionNvmGroup1->ChannelsMaskRemaining[0] &= RegionNvmGroup2->ChannelsMask[0];
-        RegionNvmGroup1->ChannelsMaskRemaining[1] &= RegionNvmGroup2->ChannelsMask[1];
-        RegionNvmGroup1->ChannelsMaskRemaining[2] &= RegionNvmGroup2->ChannelsMask[2];
-        RegionNvmGroup1->ChannelsMaskRemaining[3] &= RegionNvmGroup2->ChannelsMask[3];
+        RegionCommonChanMaskAnd( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, 4 );
         RegionNvmGroup1->ChannelsMaskRemaining[4] = RegionNvmGroup2->ChannelsMask[4];
         RegionNvmGroup1->ChannelsMaskRemaining[5] = RegionNvmGroup2->ChannelsMask[5];
     }
@@ -956,9 +949,9 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
     countChannelsParams.ChannelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
-    countChannelsParams.Channels = RegionNvmGroup2->Channels;
+    countChannelsParams.Channels = ChannelPlanCtx.Channels;
     countChannelsParams.Bands = RegionBands;
-    countChannelsParams.MaxNbChannels = CN470_MAX_NB_CHANNELS;
+    countChannelsParams.MaxNbChannels = CN470_PLAN_NB_CHANNELS;
     countChannelsParams.JoinChannels = NULL;
 
     // Apply a different channel selection if the device is not joined yet
@@ -992,11 +985,38 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
         *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
 
         // Disable the channel in the mask
-        RegionCommonChanDisable( RegionNvmGroup1->ChannelsMaskRemaining, *channel, ChannelPlanCtx.ChannelsMaskSize );
+        RegionCommonChanDisable( RegionNvmGroup1->ChannelsMaskRemaining, *channel, CN470_MAX_NB_CHANNELS );
     }
     return status;
 }
 
+TimerTime_t RegionCN470GetNextTxDelay( NextChanParams_t* nextChanParams )
+{
+    RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
+    RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
+
+    countChannelsParams.Joined = nextChanParams->Joined;
+    countChannelsParams.Datarate = nextChanParams->Datarate;
+    countChannelsParams.ChannelsMask = RegionNvmGroup2->ChannelsMask;
+    countChannelsParams.Channels = ChannelPlanCtx.Channels;
+    countChannelsParams.Bands = RegionBands;
+    countChannelsParams.MaxNbChannels = CN470_PLAN_NB_CHANNELS;
+    countChannelsParams.JoinChannels = NULL;
+
+    identifyChannelsParam.AggrTimeOff = nextChanParams->AggrTimeOff;
+    identifyChannelsParam.LastAggrTx = nextChanParams->LastAggrTx;
+    identifyChannelsParam.DutyCycleEnabled = nextChanParams->DutyCycleEnabled;
+    identifyChannelsParam.MaxBands = CN470_MAX_NB_BANDS;
+
+    identifyChannelsParam.ElapsedTimeSinceStartUp = nextChanParams->ElapsedTimeSinceStartUp;
+    identifyChannelsParam.LastTxIsJoinRequest = nextChanParams->LastTxIsJoinRequest;
+    identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
+
+    identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+
+    return RegionCommonGetNextTxDelay( &identifyChannelsParam );
+}
+
 LoRaMacStatus_t RegionCN470ChannelAdd( ChannelAddParams_t* channelAdd )
 {
     return LORAMAC_STATUS_PARAMETER_INVALID;
@@ -49,6 +49,12 @@ extern "C"
  */
 #define CN470_MAX_NB_CHANNELS                        96
 
+/*!
+ * Number of channels of the const channel plan tables. The channel plans use
+ * the channels 0 to 63 only.
+ */
+#define CN470_PLAN_NB_CHANNELS                       64
+
 /*!
  * Minimal datarate that can be used by the node
  */
@@ -170,7 +176,7 @@ extern "C"
 
 /*!
  * Band 0 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define CN470_BAND0                                 { 1, CN470_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  100.0 %
 
@@ -412,6 +418,15 @@ int8_t RegionCN470AlternateDr( int8_t currentDr, AlternateDrType_t type );
  */
 LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown or no channel].
+ */
+TimerTime_t RegionCN470GetNextTxDelay( NextChanParams_t* nextChanParams );
+
 /*!
  * \brief Adds a channel.
  *
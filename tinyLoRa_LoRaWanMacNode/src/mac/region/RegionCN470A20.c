@@ -32,6 +32,11 @@
 #include "RegionBaseUS.h"
 #include "RegionCN470A20.h"
 
+/*
+ * Channels of the channel plan.
+ */
+const ChannelParams_t RegionCN470A20Channels[CN470_PLAN_NB_CHANNELS] = CN470_A20_CHANNELS;
+
 uint32_t RegionCN470A20GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     return RegionCN470A20GetRx1Frequency( channel );
@@ -43,7 +48,7 @@ uint8_t RegionCN470A20GetBeaconChannelOffset( uint8_t joinChannelIndex )
 }
 
 uint8_t RegionCN470A20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                           uint16_t chanMask, ChannelParams_t* channels )
+                                           uint16_t chanMask, const ChannelParams_t* channels )
 {
     uint8_t status = 0x07;
 
@@ -74,11 +79,10 @@ uint8_t RegionCN470A20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMas
     }
     else
     {
-        // chMaskCntl 0 to 3
-        for( uint8_t i = 0; i < 16; i++ )
+        // chMaskCntl 0 to 3, only visit the channels to enable
+        for( uint16_t mask = chanMask; mask != 0; mask &= mask - 1 )
         {
-            if( ( ( chanMask & ( 1 << i ) ) != 0 ) &&
-                ( channels[chMaskCntl * 16 + i].Frequency == 0 ) )
+            if( channels[chMaskCntl * 16 + RegionCommonChanMaskFirst( mask )].Frequency == 0 )
             {// Trying to enable an undefined channel
                 status &= 0xFE; // Channel mask KO
             }
@@ -100,24 +104,6 @@ bool RegionCN470A20VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-void RegionCN470A20InitializeChannels( ChannelParams_t* channels )
-{
-    // Upstream group 1
-    for( uint8_t i = 0; i < 32; i++ )
-    {
-        channels[i].Frequency = CN470_A20_FIRST_TX1_CHANNEL + i * CN470_A20_STEPWIDTH_RX_CHANNEL;
-        channels[i].DrRange.Value = ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE;
-        channels[i].Band = 0;
-    }
-    // Upstream group 2
-    for( uint8_t i = 32; i < 64; i++ )
-    {
-        channels[i].Frequency = CN470_A20_FIRST_TX2_CHANNEL + ( i - 32 ) * CN470_A20_STEPWIDTH_RX_CHANNEL;
-        channels[i].DrRange.Value = ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE;
-        channels[i].Band = 0;
-    }
-}
-
 void RegionCN470A20InitializeChannelsMask(  uint16_t* channelsDefaultMask )
 {
     // Enable all possible channels
@@ -117,6 +117,34 @@ extern "C"
  */
 #define CN470_A20_STEPWIDTH_TX2_CHANNEL     200000
 
+/*!
+ * Upstream channel i of group 1, i = 0 to 31.
+ * Channel plan type A, 20MHz.
+ */
+#define CN470_A20_TX1_CHANNEL( i )          { CN470_A20_FIRST_TX1_CHANNEL + ( i ) * CN470_A20_STEPWIDTH_TX1_CHANNEL, 0, CN470_DEFAULT_DR_RANGE, 0 }
+
+/*!
+ * Upstream channel i of group 2, i = 0 to 31.
+ * Channel plan type A, 20MHz.
+ */
+#define CN470_A20_TX2_CHANNEL( i )          { CN470_A20_FIRST_TX2_CHANNEL + ( i ) * CN470_A20_STEPWIDTH_TX2_CHANNEL, 0, CN470_DEFAULT_DR_RANGE, 0 }
+
+/*!
+ * Channels of upstream group 1 and 2.
+ * Channel plan type A, 20MHz.
+ */
+#define CN470_A20_CHANNELS                                 \
+{                                                          \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX1_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX1_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX1_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX1_CHANNEL, 24 ), \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX2_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX2_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX2_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( CN470_A20_TX2_CHANNEL, 24 ), \
+}
+
 /*!
  * The default frequency for RX window 2, when its
  * an ABP device.
@@ -170,7 +198,7 @@ uint8_t RegionCN470A20GetBeaconChannelOffset( uint8_t joinChannelIndex );
  * \retval Status of the operation. Return 0x07 if the channels mask is valid.
  */
 uint8_t RegionCN470A20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                           uint16_t chanMask, ChannelParams_t* channels );
+                                           uint16_t chanMask, const ChannelParams_t* channels );
 
 /*!
  * \brief Verifies if the frequency provided is valid
@@ -183,12 +211,10 @@ uint8_t RegionCN470A20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMas
 bool RegionCN470A20VerifyRfFreq( uint32_t frequency );
 
 /*!
- * \brief Initializes all channels, datarates, frequencies and bands
- *        for the channel plan type A, 20MHz.
- *
- * \param [IN] channels A pointer to the available channels.
+ * Channels of the channel plan type A, 20MHz, a const table of
+ * CN470_PLAN_NB_CHANNELS channels. The channels mask selects the ones in use.
  */
-void RegionCN470A20InitializeChannels( ChannelParams_t* channels );
+extern const ChannelParams_t RegionCN470A20Channels[];
 
 /*!
  * \brief Initializes the channels default mask
@@ -32,6 +32,12 @@
 #include "RegionBaseUS.h"
 #include "RegionCN470A26.h"
 
+/*
+ * Channels of the channel plan. The channels 48 to 63
+ * are not part of the plan and zero.
+ */
+const ChannelParams_t RegionCN470A26Channels[CN470_PLAN_NB_CHANNELS] = CN470_A26_CHANNELS;
+
 uint32_t RegionCN470A26GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     return CN470_A26_BEACON_FREQ;
@@ -43,7 +49,7 @@ uint8_t RegionCN470A26GetBeaconChannelOffset( uint8_t joinChannelIndex )
 }
 
 uint8_t RegionCN470A26LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                              uint16_t chanMask, ChannelParams_t* channels )
+                                              uint16_t chanMask, const ChannelParams_t* channels )
 {
     uint8_t status = 0x07;
 
@@ -74,11 +80,10 @@ uint8_t RegionCN470A26LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMas
     }
     else
     {
-        // chMaskCntl 0 to 2
-        for( uint8_t i = 0; i < 16; i++ )
+        // chMaskCntl 0 to 2, only visit the channels to enable
+        for( uint16_t mask = chanMask; mask != 0; mask &= mask - 1 )
         {
-            if( ( ( chanMask & ( 1 << i ) ) != 0 ) &&
-                ( channels[chMaskCntl * 16 + i].Frequency == 0 ) )
+            if( channels[chMaskCntl * 16 + RegionCommonChanMaskFirst( mask )].Frequency == 0 )
             {// Trying to enable an undefined channel
                 status &= 0xFE; // Channel mask KO
             }
@@ -100,17 +105,6 @@ bool RegionCN470A26VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-void RegionCN470A26InitializeChannels( ChannelParams_t* channels )
-{
-    // Upstream group 1
-    for( uint8_t i = 0; i < 48; i++ )
-    {
-        channels[i].Frequency = CN470_A26_FIRST_TX_CHANNEL + i * CN470_A26_STEPWIDTH_RX_CHANNEL;
-        channels[i].DrRange.Value = ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE;
-        channels[i].Band = 0;
-    }
-}
-
 void RegionCN470A26InitializeChannelsMask( uint16_t* channelsDefaultMask )
 {
     // Enable all possible channels
@@ -102,6 +102,26 @@ extern "C"
  */
 #define CN470_A26_STEPWIDTH_TX_CHANNEL      200000
 
+/*!
+ * Upstream channel i, i = 0 to 47.
+ * Channel plan type A, 26MHz.
+ */
+#define CN470_A26_TX_CHANNEL( i )           { CN470_A26_FIRST_TX_CHANNEL + ( i ) * CN470_A26_STEPWIDTH_TX_CHANNEL, 0, CN470_DEFAULT_DR_RANGE, 0 }
+
+/*!
+ * Channels of upstream group 1.
+ * Channel plan type A, 26MHz.
+ */
+#define CN470_A26_CHANNELS                                \
+{                                                         \
+    REGION_COMMON_CHANNELS_8( CN470_A26_TX_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_A26_TX_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_A26_TX_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( CN470_A26_TX_CHANNEL, 24 ), \
+    REGION_COMMON_CHANNELS_8( CN470_A26_TX_CHANNEL, 32 ), \
+    REGION_COMMON_CHANNELS_8( CN470_A26_TX_CHANNEL, 40 ), \
+}
+
 /*!
  * The default frequency for RX window 2
  * Channel plan type A, 26MHz.
@@ -152,7 +172,7 @@ uint8_t RegionCN470A26GetBeaconChannelOffset( uint8_t joinChannelIndex );
  * \retval Status of the operation. Return 0x07 if the channels mask is valid.
  */
 uint8_t RegionCN470A26LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                           uint16_t chanMask, ChannelParams_t* channels );
+                                           uint16_t chanMask, const ChannelParams_t* channels );
 
 /*!
  * \brief Verifies if the frequency provided is valid
@@ -165,12 +185,10 @@ uint8_t RegionCN470A26LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMas
 bool RegionCN470A26VerifyRfFreq( uint32_t frequency );
 
 /*!
- * \brief Initializes all channels, datarates, frequencies and bands
- *        for the Channel plan type A, 26MHz.
- *
- * \param [IN] channels A pointer to the available channels.
+ * Channels of the channel plan type A, 26MHz, a const table of
+ * CN470_PLAN_NB_CHANNELS channels. The channels mask selects the ones in use.
  */
-void RegionCN470A26InitializeChannels( ChannelParams_t* channels );
+extern const ChannelParams_t RegionCN470A26Channels[];
 
 /*!
  * \brief Initializes the channels default mask
@@ -31,6 +31,11 @@
 #include "RegionCN470.h"
 #include "RegionBaseUS.h"
 #include "RegionCN470B20.h"
+
+/*
+ * Channels of the channel plan.
+ */
+const ChannelParams_t RegionCN470B20Channels[CN470_PLAN_NB_CHANNELS] = CN470_B20_CHANNELS;
 #include "RegionCN470A20.h"
 
 uint32_t RegionCN470B20GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
@@ -58,7 +63,7 @@ uint8_t RegionCN470B20GetBeaconChannelOffset( uint8_t joinChannelIndex )
 }
 
 uint8_t RegionCN470B20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                              uint16_t chanMask, ChannelParams_t* channels )
+                                              uint16_t chanMask, const ChannelParams_t* channels )
 {
     // It follows the same implementation as type A
     return RegionCN470A20LinkAdrChMaskUpdate( channelsMask, chMaskCntl,
@@ -87,24 +92,6 @@ bool RegionCN470B20VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-void RegionCN470B20InitializeChannels( ChannelParams_t* channels )
-{
-    // Upstream group 1
-    for( uint8_t i = 0; i < 32; i++ )
-    {
-        channels[i].Frequency = CN470_B20_FIRST_TX1_CHANNEL + i * CN470_B20_STEPWIDTH_TX1_CHANNEL;
-        channels[i].DrRange.Value = ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE;
-        channels[i].Band = 0;
-    }
-    // Upstream group 2
-    for( uint8_t i = 32; i < 64; i++ )
-    {
-        channels[i].Frequency = CN470_B20_FIRST_TX2_CHANNEL + ( i - 32 ) * CN470_B20_STEPWIDTH_TX2_CHANNEL;
-        channels[i].DrRange.Value = ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE;
-        channels[i].Band = 0;
-    }
-}
-
 void RegionCN470B20InitializeChannelsMask( uint16_t* channelsDefaultMask )
 {
     RegionCN470A20InitializeChannelsMask( channelsDefaultMask );
@@ -142,6 +142,34 @@ extern "C"
  */
 #define CN470_B20_STEPWIDTH_TX2_CHANNEL     CN470_B20_STEPWIDTH_RX2_CHANNEL
 
+/*!
+ * Upstream channel i of group 1, i = 0 to 31.
+ * Channel plan type B, 20MHz.
+ */
+#define CN470_B20_TX1_CHANNEL( i )          { CN470_B20_FIRST_TX1_CHANNEL + ( i ) * CN470_B20_STEPWIDTH_TX1_CHANNEL, 0, CN470_DEFAULT_DR_RANGE, 0 }
+
+/*!
+ * Upstream channel i of group 2, i = 0 to 31.
+ * Channel plan type B, 20MHz.
+ */
+#define CN470_B20_TX2_CHANNEL( i )          { CN470_B20_FIRST_TX2_CHANNEL + ( i ) * CN470_B20_STEPWIDTH_TX2_CHANNEL, 0, CN470_DEFAULT_DR_RANGE, 0 }
+
+/*!
+ * Channels of upstream group 1 and 2.
+ * Channel plan type B, 20MHz.
+ */
+#define CN470_B20_CHANNELS                                 \
+{                                                          \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX1_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX1_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX1_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX1_CHANNEL, 24 ), \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX2_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX2_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX2_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( CN470_B20_TX2_CHANNEL, 24 ), \
+}
+
 /*!
  * The default frequency for RX window 2, when its
  * an ABP device.
@@ -194,7 +222,7 @@ uint8_t RegionCN470B20GetBeaconChannelOffset( uint8_t joinChannelIndex );
  * \retval Status of the operation. Return 0x07 if the channels mask is valid.
  */
 uint8_t RegionCN470B20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                              uint16_t chanMask, ChannelParams_t* channels );
+                                              uint16_t chanMask, const ChannelParams_t* channels );
 
 /*!
  * \brief Verifies if the frequency provided is valid
@@ -207,12 +235,10 @@ uint8_t RegionCN470B20LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMas
 bool RegionCN470B20VerifyRfFreq( uint32_t frequency );
 
 /*!
- * \brief Initializes all channels, datarates, frequencies and bands
- *        for the Channel plan type B, 20MHz.
- *
- * \param [IN] channels A pointer to the available channels.
+ * Channels of the channel plan type B, 20MHz, a const table of
+ * CN470_PLAN_NB_CHANNELS channels. The channels mask selects the ones in use.
  */
-void RegionCN470B20InitializeChannels( ChannelParams_t* channels );
+extern const ChannelParams_t RegionCN470B20Channels[];
 
 /*!
  * \brief Initializes the channels default mask
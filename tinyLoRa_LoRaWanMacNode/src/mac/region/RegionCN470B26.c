@@ -33,6 +33,12 @@
 #include "RegionCN470A26.h"
 #include "RegionCN470B26.h"
 
+/*
+ * Channels of the channel plan. The channels 48 to 63
+ * are not part of the plan and zero.
+ */
+const ChannelParams_t RegionCN470B26Channels[CN470_PLAN_NB_CHANNELS] = CN470_B26_CHANNELS;
+
 uint32_t RegionCN470B26GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     return CN470_B26_BEACON_FREQ;
@@ -44,7 +50,7 @@ uint8_t RegionCN470B26GetBeaconChannelOffset( uint8_t joinChannelIndex )
 }
 
 uint8_t RegionCN470B26LinkAdrChMaskUpdate( uint16_t* channelsMask, uint8_t chMaskCntl,
-                                           uint16_t chanMask, ChannelParams_t* channels )
+                                           uint16_t chanMask, const ChannelParams_t* channels )
 {
     return RegionCN470A26LinkAdrChMaskUpdate( channelsMask, chMaskCntl,
                                                  chanMask, channels );
@@ -62,17 +68,6 @@ bool RegionCN470B26VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-void RegionCN470B26InitializeChannels( ChannelParams_t* channels )
-{
-    // Upstream group 1
-    for( uint8_t i = 0; i < 48; i++ )
-    {
-        channels[i].Frequency = CN470_B26_FIRST_TX_CHANNEL + i * CN470_B26_STEPWIDTH_RX_CHANNEL;
-        channels[i].DrRange.Value = ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE;
-        channels[i].Band = 0;
-    }
-}
-
 void RegionCN470B26InitializeChannelsMask( uint16_t* channelsDefaultMask )
 {
     RegionCN470A26InitializeChannelsMask( channelsDefaultMask );
@@ -201,7 +201,7 @@ extern "C"
 
 /*!
  * Band 0 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define CN779_BAND0                                 { 100, CN779_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
 
@@ -402,6 +402,15 @@ int8_t RegionCN779AlternateDr( int8_t currentDr, AlternateDrType_t type );
  */
 LoRaMacStatus_t RegionCN779NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown or no channel].
+ */
+TimerTime_t RegionCN779GetNextTxDelay( NextChanParams_t* nextChanParams );
+
 /*!
  * \brief Adds a channel.
  *
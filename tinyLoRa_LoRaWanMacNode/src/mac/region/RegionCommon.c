@@ -198,25 +198,77 @@ static uint16_t UpdateTimeCredits( Band_t* band, bool joined, bool dutyCycleEnab
 
     // Synchronize update time
     band->LastBandUpdateTime = currentTime;
+    band->ReadyTime = currentTime - band->TimeCredits;
 
     return dutyCycle;
 }
 
-static uint8_t CountChannels( uint16_t mask, uint8_t nbBits )
+/*!
+ * Position of the bit isolated by x & -x, indexed by the top 5 bits of its
+ * product with the de Bruijn sequence 0x077CB531. The RP2040 core has no
+ * count trailing zeros instruction but a single cycle multiplier.
+ */
+static const uint8_t ChanMaskBitPosition[32] =
+{
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+uint8_t RegionCommonChanMaskPopCount( uint16_t mask )
+{
+    mask = mask - ( ( mask >> 1 ) & 0x5555 );
+    mask = ( mask & 0x3333 ) + ( ( mask >> 2 ) & 0x3333 );
+    mask = ( mask + ( mask >> 4 ) ) & 0x0F0F;
+    return ( mask + ( mask >> 8 ) ) & 0x1F;
+}
+
+uint8_t RegionCommonChanMaskFirst( uint16_t mask )
+{
+    uint32_t lowest = mask & ( ~( uint32_t )mask + 1 );
+
+    if( mask == 0 )
+    {
+        return 16;
+    }
+    return ChanMaskBitPosition[( uint32_t )( lowest * 0x077CB531UL ) >> 27];
+}
+
+bool RegionCommonChanMaskSelect( uint16_t* channelsMask, uint8_t len, uint8_t n, uint8_t* channel )
 {
-    uint8_t nbActiveBits = 0;
+    for( uint8_t k = 0; k < len; k++ )
+    {
+        uint16_t mask = channelsMask[k];
+        uint8_t nbChannels = RegionCommonChanMaskPopCount( mask );
+
+        if( n >= nbChannels )
+        {
+            // Skip the whole word
+            n -= nbChannels;
+            continue;
+        }
+        while( n-- > 0 )
+        {
+            // Clear the lowest channel
+            mask &= mask - 1;
+        }
+        *channel = ( k * 16 ) + RegionCommonChanMaskFirst( mask );
+        return true;
+    }
+    return false;
+}
 
-    for( uint8_t j = 0; j < nbBits; j++ )
+void RegionCommonChanMaskAnd( uint16_t* channelsMaskDest, uint16_t* channelsMaskSrc, uint8_t len )
+{
+    if( ( channelsMaskDest != NULL ) && ( channelsMaskSrc != NULL ) )
     {
-        if( ( mask & ( 1 << j ) ) == ( 1 << j ) )
+        for( uint8_t i = 0; i < len; i++ )
         {
-            nbActiveBits++;
+            channelsMaskDest[i] &= channelsMaskSrc[i];
         }
     }
-    return nbActiveBits;
 }
 
-bool RegionCommonChanVerifyDr( uint8_t nbChannels, uint16_t* channelsMask, int8_t dr, int8_t minDr, int8_t maxDr, ChannelParams_t* channels )
+bool RegionCommonChanVerifyDr( uint8_t nbChannels, uint16_t* channelsMask, int8_t dr, int8_t minDr, int8_t maxDr, const ChannelParams_t* channels )
 {
     if( RegionCommonValueInRange( dr, minDr, maxDr ) == 0 )
     {
@@ -225,16 +277,17 @@ bool RegionCommonChanVerifyDr( uint8_t nbChannels, uint16_t* channelsMask, int8_
 
     for( uint8_t i = 0, k = 0; i < nbChannels; i += 16, k++ )
     {
-        for( uint8_t j = 0; j < 16; j++ )
+        // Only visit the enabled channels
+        for( uint16_t mask = channelsMask[k]; mask != 0; mask &= mask - 1 )
         {
-            if( ( ( channelsMask[k] & ( 1 << j ) ) != 0 ) )
-            {// Check datarate validity for enabled channels
-                if( RegionCommonValueInRange( dr, ( channels[i + j].DrRange.Fields.Min & 0x0F ),
-                                                  ( channels[i + j].DrRange.Fields.Max & 0x0F ) ) == 1 )
-                {
-                    // At least 1 channel has been found we can return OK.
-                    return true;
-                }
+            uint8_t j = RegionCommonChanMaskFirst( mask );
+
+            // Check datarate validity for enabled channels
+            if( RegionCommonValueInRange( dr, ( channels[i + j].DrRange.Fields.Min & 0x0F ),
+                                              ( channels[i + j].DrRange.Fields.Max & 0x0F ) ) == 1 )
+            {
+                // At least 1 channel has been found we can return OK.
+                return true;
             }
         }
     }
@@ -276,7 +329,7 @@ uint8_t RegionCommonCountChannels( uint16_t* channelsMask, uint8_t startIdx, uin
 
     for( uint8_t i = startIdx; i < stopIdx; i++ )
     {
-        nbChannels += CountChannels( channelsMask[i], 16 );
+        nbChannels += RegionCommonChanMaskPopCount( channelsMask[i] );
     }
 
     return nbChannels;
@@ -309,6 +362,7 @@ void RegionCommonSetBandTxDone( Band_t* band, TimerTime_t lastTxAirTime, bool jo
     {
         band->TimeCredits = 0;
     }
+    band->ReadyTime = band->LastBandUpdateTime - band->TimeCredits;
 }
 
 TimerTime_t RegionCommonUpdateBandTimeOff( bool joined, Band_t* bands,
@@ -550,6 +604,78 @@ void RegionCommonRxBeaconSetup( RegionCommonRxBeaconSetupParams_t* rxBeaconSetup
     Radio.Rx( rxBeaconSetupParams->RxTime );
 }
 
+void RegionCommonRxBulkSetup( uint32_t frequency, uint32_t bitrate )
+{
+    uint32_t fdev = bitrate >> 1;
+
+    if( bitrate > REGION_COMMON_BULK_RX_WIDE_FDEV_MAX_BITRATE )
+    {
+        fdev = bitrate >> 2;
+    }
+
+    Radio.SetChannel( frequency );
+
+    // Single sided bandwidth, Carson's rule
+    Radio.SetRxConfig( MODEM_FSK, fdev + ( bitrate >> 1 ), bitrate, 0, fdev + ( bitrate >> 1 ),
+                       REGION_COMMON_BULK_RX_PREAMBLE_LENGTH, 0, false, 0, true, 0, 0, false, true );
+
+    Radio.SetMaxPayloadLength( MODEM_FSK, 255 );
+
+    Radio.Rx( 0 );
+}
+
+bool RegionCommonComputeRxSniffParams( uint32_t tSymbolInUs, uint16_t preambleLen, uint16_t maxMissRate, RegionCommonRxSniffParams_t* sniffParams )
+{
+    uint32_t detectTime = tSymbolInUs * REGION_COMMON_RX_SNIFF_DETECT_SYMBOLS;
+    uint32_t preambleTime = tSymbolInUs * preambleLen;
+    uint64_t maxOffTime = 0;
+    uint64_t sleepTime = 0;
+    uint32_t offTime = 0;
+    uint32_t rxTimeInUs = 0;
+    uint32_t sleepTimeInUs = 0;
+    uint32_t periodInUs = 0;
+    uint32_t missTime = 0;
+
+    if( ( sniffParams == NULL ) || ( maxMissRate >= 1000 ) || ( preambleTime <= ( 2 * detectTime ) ) )
+    {
+        return false;
+    }
+
+    // Longest time off air meeting the miss rate with the shortest reception
+    // period. It exceeds 32 bits for long preambles at high miss rates.
+    maxOffTime = ( ( ( uint64_t )( preambleTime - ( 2 * detectTime ) ) * 1000 ) +
+                   ( ( uint64_t )maxMissRate * detectTime ) ) / ( 1000 - maxMissRate );
+    if( maxOffTime <= REGION_COMMON_RX_SNIFF_WAKEUP_TIME )
+    {
+        return false;
+    }
+
+    // Round the reception period up and the sleep period down to RTC steps
+    sniffParams->RxTime = ( ( detectTime * 64 ) + 999 ) / 1000;
+    sleepTime = ( ( maxOffTime - REGION_COMMON_RX_SNIFF_WAKEUP_TIME ) * 64 ) / 1000;
+    sniffParams->SleepTime = ( uint32_t )MIN( sleepTime, REGION_COMMON_RX_SNIFF_MAX_PERIOD );
+    if( ( sniffParams->SleepTime == 0 ) || ( sniffParams->RxTime > REGION_COMMON_RX_SNIFF_MAX_PERIOD ) )
+    {
+        return false;
+    }
+
+    // Evaluate the model with the programmed periods
+    rxTimeInUs = ( uint32_t )( ( ( uint64_t )sniffParams->RxTime * 15625 ) / 1000 );
+    sleepTimeInUs = ( uint32_t )( ( ( uint64_t )sniffParams->SleepTime * 15625 ) / 1000 );
+    offTime = sleepTimeInUs + REGION_COMMON_RX_SNIFF_WAKEUP_TIME;
+    periodInUs = rxTimeInUs + offTime;
+
+    if( ( offTime + ( 2 * detectTime ) ) > preambleTime )
+    {
+        missTime = offTime + ( 2 * detectTime ) - preambleTime;
+    }
+    sniffParams->MissRate = ( uint16_t )( ( ( uint64_t )missTime * 1000 ) / periodInUs );
+
+    sniffParams->AvgCurrent = ( uint32_t )( ( ( uint64_t )REGION_COMMON_RX_SNIFF_RX_CURRENT * ( rxTimeInUs + REGION_COMMON_RX_SNIFF_WAKEUP_TIME ) +
+                                              ( uint64_t )REGION_COMMON_RX_SNIFF_SLEEP_CURRENT * sleepTimeInUs ) / periodInUs / 1000 );
+    return true;
+}
+
 void RegionCommonCountNbOfEnabledChannels( RegionCommonCountNbOfEnabledChannelsParams_t* countNbOfEnabledChannelsParams,
                                            uint8_t* enabledChannels, uint8_t* nbEnabledChannels, uint8_t* nbRestrictedChannels )
 {
@@ -558,51 +684,153 @@ void RegionCommonCountNbOfEnabledChannels( RegionCommonCountNbOfEnabledChannelsP
 
     for( uint8_t i = 0, k = 0; i < countNbOfEnabledChannelsParams->MaxNbChannels; i += 16, k++ )
     {
-        for( uint8_t j = 0; j < 16; j++ )
+        uint16_t mask = countNbOfEnabledChannelsParams->ChannelsMask[k];
+
+        if( ( countNbOfEnabledChannelsParams->Joined == false ) &&
+            ( countNbOfEnabledChannelsParams->JoinChannels != NULL ) )
         {
-            if( ( countNbOfEnabledChannelsParams->ChannelsMask[k] & ( 1 << j ) ) != 0 )
-            {
-                if( countNbOfEnabledChannelsParams->Channels[i + j].Frequency == 0 )
-                { // Check if the channel is enabled
-                    continue;
-                }
-                if( ( countNbOfEnabledChannelsParams->Joined == false ) &&
-                    ( countNbOfEnabledChannelsParams->JoinChannels != NULL ) )
-                {
-                    if( ( countNbOfEnabledChannelsParams->JoinChannels[k] & ( 1 << j ) ) == 0 )
-                    {
-                        continue;
-                    }
-                }
-                if( RegionCommonValueInRange( countNbOfEnabledChannelsParams->Datarate,
-                                              countNbOfEnabledChannelsParams->Channels[i + j].DrRange.Fields.Min,
-                                              countNbOfEnabledChannelsParams->Channels[i + j].DrRange.Fields.Max ) == false )
-                { // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if( countNbOfEnabledChannelsParams->Bands[countNbOfEnabledChannelsParams->Channels[i + j].Band].ReadyForTransmission == false )
-                { // Check if the band is available for transmission
-                    nbRestrictedChannelsCount++;
-                    continue;
-                }
-                enabledChannels[nbChannelCount++] = i + j;
+            mask &= countNbOfEnabledChannelsParams->JoinChannels[k];
+        }
+
+        // Only visit the enabled channels
+        for( ; mask != 0; mask &= mask - 1 )
+        {
+            uint8_t j = RegionCommonChanMaskFirst( mask );
+
+            if( countNbOfEnabledChannelsParams->Channels[i + j].Frequency == 0 )
+            { // Check if the channel is enabled
+                continue;
+            }
+            if( RegionCommonValueInRange( countNbOfEnabledChannelsParams->Datarate,
+                                          countNbOfEnabledChannelsParams->Channels[i + j].DrRange.Fields.Min,
+                                          countNbOfEnabledChannelsParams->Channels[i + j].DrRange.Fields.Max ) == false )
+            { // Check if the current channel selection supports the given datarate
+                continue;
+            }
+            if( countNbOfEnabledChannelsParams->Bands[countNbOfEnabledChannelsParams->Channels[i + j].Band].ReadyForTransmission == false )
+            { // Check if the band is available for transmission
+                nbRestrictedChannelsCount++;
+                continue;
             }
+            enabledChannels[nbChannelCount++] = i + j;
         }
     }
     *nbEnabledChannels = nbChannelCount;
     *nbRestrictedChannels = nbRestrictedChannelsCount;
 }
 
+TimerTime_t RegionCommonGetNextTxDelay( RegionCommonIdentifyChannelsParam_t* identifyChannelsParam )
+{
+    RegionCommonCountNbOfEnabledChannelsParams_t* countParams = identifyChannelsParam->CountNbOfEnabledChannelsParam;
+    TimerTime_t currentTime = TimerGetCurrentTime( );
+    TimerTime_t elapsed = TimerGetElapsedTime( identifyChannelsParam->LastAggrTx );
+    TimerTime_t aggrTimeOffDelay = 0;
+    TimerTime_t bandDelay = TIMERTIME_T_MAX;
+    uint32_t usableBands = 0;
+
+    if( countParams->Joined == false )
+    {
+        return TIMERTIME_T_MAX;
+    }
+
+    if( ( identifyChannelsParam->LastAggrTx != 0 ) &&
+        ( identifyChannelsParam->AggrTimeOff > elapsed ) )
+    {
+        aggrTimeOffDelay = identifyChannelsParam->AggrTimeOff - elapsed;
+    }
+
+    // Bands holding at least one enabled channel of the datarate
+    for( uint8_t k = 0; ( k * 16 ) < countParams->MaxNbChannels; k++ )
+    {
+        // Only visit the enabled channels
+        for( uint16_t mask = countParams->ChannelsMask[k]; mask != 0; mask &= mask - 1 )
+        {
+            uint8_t i = ( k * 16 ) + RegionCommonChanMaskFirst( mask );
+
+            if( ( i >= countParams->MaxNbChannels ) || ( countParams->Channels[i].Frequency == 0 ) )
+            {
+                continue;
+            }
+            if( RegionCommonValueInRange( countParams->Datarate,
+                                          countParams->Channels[i].DrRange.Fields.Min,
+                                          countParams->Channels[i].DrRange.Fields.Max ) == 1 )
+            {
+                usableBands |= 1UL << countParams->Channels[i].Band;
+            }
+        }
+    }
+
+    if( usableBands == 0 )
+    {
+        return TIMERTIME_T_MAX;
+    }
+
+    if( identifyChannelsParam->DutyCycleEnabled == false )
+    {
+        return aggrTimeOffDelay;
+    }
+
+    for( uint8_t i = 0; i < identifyChannelsParam->MaxBands; i++ )
+    {
+        Band_t* band = &countParams->Bands[i];
+        TimerTime_t creditCosts;
+
+        if( ( usableBands & ( 1UL << i ) ) == 0 )
+        {
+            continue;
+        }
+
+        creditCosts = identifyChannelsParam->ExpectedTimeOnAir * ( ( band->DCycle == 0 ) ? 1 : band->DCycle );
+        if( creditCosts >= DUTY_CYCLE_TIME_PERIOD )
+        {
+            // The band never collects enough credits for this uplink
+            continue;
+        }
+
+        // The band is ready once the credits collected since its ready
+        // time exceed the costs
+        if( ( band->LastBandUpdateTime == 0 ) ||
+            ( ( currentTime - band->ReadyTime ) > creditCosts ) )
+        {
+            bandDelay = 0;
+            break;
+        }
+        bandDelay = MIN( bandDelay, ( band->ReadyTime + creditCosts + 1 ) - currentTime );
+    }
+
+    if( bandDelay == TIMERTIME_T_MAX )
+    {
+        return TIMERTIME_T_MAX;
+    }
+    return MAX( aggrTimeOffDelay, bandDelay );
+}
+
 LoRaMacStatus_t RegionCommonIdentifyChannels( RegionCommonIdentifyChannelsParam_t* identifyChannelsParam,
                                               TimerTime_t* aggregatedTimeOff, uint8_t* enabledChannels,
                                               uint8_t* nbEnabledChannels, uint8_t* nbRestrictedChannels,
                                               TimerTime_t* nextTxDelay )
 {
     TimerTime_t elapsed = TimerGetElapsedTime( identifyChannelsParam->LastAggrTx );
-    *nextTxDelay = identifyChannelsParam->AggrTimeOff - elapsed;
+    TimerTime_t delay = RegionCommonGetNextTxDelay( identifyChannelsParam );
+
     *nbRestrictedChannels = 1;
     *nbEnabledChannels = 0;
 
+    if( ( delay != 0 ) && ( delay != TIMERTIME_T_MAX ) )
+    {
+        // No band can carry the uplink yet. The credits are collected lazily,
+        // the bands are synchronized once the uplink is possible.
+        if( ( identifyChannelsParam->LastAggrTx == 0 ) ||
+            ( identifyChannelsParam->AggrTimeOff <= elapsed ) )
+        {
+            *aggregatedTimeOff = 0;
+        }
+        *nextTxDelay = delay;
+        return LORAMAC_STATUS_DUTYCYCLE_RESTRICTED;
+    }
+
+    *nextTxDelay = identifyChannelsParam->AggrTimeOff - elapsed;
+
     if( ( identifyChannelsParam->LastAggrTx == 0 ) ||
         ( identifyChannelsParam->AggrTimeOff <= elapsed ) )
     {
@@ -637,6 +865,129 @@ LoRaMacStatus_t RegionCommonIdentifyChannels( RegionCommonIdentifyChannelsParam_
     }
 }
 
+static void LbtUpdateBusyRatio( RegionCommonLbtCtx_t* ctx, const ChannelParams_t* channels, uint8_t channel, bool busy )
+{
+    int32_t target = ( busy == true ) ? 0xFFFF : 0;
+    int32_t delta = 0;
+
+    if( ctx->Frequencies[channel] != channels[channel].Frequency )
+    {// Statistics of another frequency
+        ctx->Frequencies[channel] = channels[channel].Frequency;
+        ctx->BusyRatios[channel] = 0;
+    }
+    // Moving average with a weight of 1/8. The step is rounded away from zero
+    // so that the ratio reaches 0 and 0xFFFF instead of stalling 7 steps short.
+    delta = target - ( int32_t )ctx->BusyRatios[channel];
+    ctx->BusyRatios[channel] += ( delta + ( ( delta > 0 ) ? 7 : -7 ) ) / 8;
+
+    if( busy == true )
+    {
+        ctx->BusyChannels |= 1 << channel;
+    }
+}
+
+static bool LbtSelectChannel( RegionCommonLbtCtx_t* ctx, RegionCommonLbtParams_t* lbtParams, uint8_t* channel )
+{
+    bool found = false;
+    uint16_t busyRatio = 0;
+
+    // Channels with the same busy probability are sensed in a random order
+    for( uint8_t i = 0, j = randr( 0, lbtParams->NbEnabledChannels - 1 ); i < lbtParams->NbEnabledChannels; i++ )
+    {
+        uint8_t channelNext = lbtParams->EnabledChannels[j];
+        j = ( j + 1 ) % lbtParams->NbEnabledChannels;
+
+        if( ( channelNext >= REGION_COMMON_LBT_MAX_NB_CHANNELS ) ||
+            ( ( ctx->BusyChannels & ( 1 << channelNext ) ) != 0 ) )
+        {
+            continue;
+        }
+        if( ctx->Frequencies[channelNext] != lbtParams->Channels[channelNext].Frequency )
+        {// Unknown frequency
+            ctx->Frequencies[channelNext] = lbtParams->Channels[channelNext].Frequency;
+            ctx->BusyRatios[channelNext] = 0;
+        }
+        if( ( found == false ) || ( ctx->BusyRatios[channelNext] < busyRatio ) )
+        {
+            found = true;
+            busyRatio = ctx->BusyRatios[channelNext];
+            *channel = channelNext;
+        }
+    }
+    return found;
+}
+
+LoRaMacStatus_t RegionCommonLbtNextChannel( RegionCommonLbtCtx_t* ctx, RegionCommonLbtParams_t* lbtParams,
+                                            uint8_t* channel, TimerTime_t* time )
+{
+    uint8_t channelNext = 0;
+
+    if( ctx->Sensing == true )
+    {
+        ctx->Sensing = false;
+
+        if( TimerGetElapsedTime( ctx->SenseStartTime ) > ( lbtParams->CarrierSenseTime + REGION_COMMON_LBT_RESULT_MARGIN ) )
+        {// The procedure was abandoned, start a new one
+            ctx->BusyChannels = 0;
+        }
+        else if( lbtParams->ChannelSense == CHANNEL_SENSE_FREE )
+        {
+            LbtUpdateBusyRatio( ctx, lbtParams->Channels, ctx->Channel, false );
+            for( uint8_t i = 0; i < lbtParams->NbEnabledChannels; i++ )
+            {
+                if( lbtParams->EnabledChannels[i] == ctx->Channel )
+                {
+                    // Free channel found
+                    ctx->BusyChannels = 0;
+                    *channel = ctx->Channel;
+                    return LORAMAC_STATUS_OK;
+                }
+            }
+        }
+        else
+        {// Busy channel or channel sense aborted
+            LbtUpdateBusyRatio( ctx, lbtParams->Channels, ctx->Channel, true );
+        }
+    }
+    else
+    {
+        ctx->BusyChannels = 0;
+    }
+
+    while( LbtSelectChannel( ctx, lbtParams, &channelNext ) == true )
+    {
+        if( Radio.StartChannelSense != NULL )
+        {
+            // Perform carrier sense without blocking, the result is given
+            // to the next call
+            ctx->Channel = channelNext;
+            ctx->Sensing = true;
+            ctx->SenseStartTime = TimerGetCurrentTime( );
+            Radio.StartChannelSense( lbtParams->Channels[channelNext].Frequency, lbtParams->RxBandwidth,
+                                     lbtParams->RssiThresh, lbtParams->CarrierSenseTime );
+            *time = lbtParams->CarrierSenseTime + REGION_COMMON_LBT_RESULT_MARGIN;
+            return LORAMAC_STATUS_CHANNEL_SENSE_PENDING;
+        }
+
+        // Perform carrier sense for CarrierSenseTime
+        // If the channel is free, we can stop the LBT mechanism
+        if( Radio.IsChannelFree( lbtParams->Channels[channelNext].Frequency, lbtParams->RxBandwidth,
+                                 lbtParams->RssiThresh, lbtParams->CarrierSenseTime ) == true )
+        {
+            LbtUpdateBusyRatio( ctx, lbtParams->Channels, channelNext, false );
+            ctx->BusyChannels = 0;
+            *channel = channelNext;
+            return LORAMAC_STATUS_OK;
+        }
+        LbtUpdateBusyRatio( ctx, lbtParams->Channels, channelNext, true );
+    }
+    ctx->BusyChannels = 0;
+
+    // Even if one or more channels are available according to the channel plan, no free channel
+    // was found during the LBT procedure.
+    return LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND;
+}
+
 int8_t RegionCommonGetNextLowerTxDr( RegionCommonGetNextLowerTxDrParams_t *params )
 {
     int8_t drLocal = params->CurrentDr;
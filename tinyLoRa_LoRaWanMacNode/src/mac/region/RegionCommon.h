@@ -116,6 +116,75 @@ extern "C"
  */
 #define REGION_COMMON_CLASS_B_C_RESP_TIMEOUT            8000
 
+/*!
+ * Maximum number of channels handled by the listen before talk procedure.
+ */
+#define REGION_COMMON_LBT_MAX_NB_CHANNELS               16
+
+/*!
+ * Time in ms the channel sense result is waited for on top of the
+ * carrier sense time.
+ */
+#define REGION_COMMON_LBT_RESULT_MARGIN                 10
+
+/*!
+ * GFSK bulk reception preamble length [bytes]
+ */
+#define REGION_COMMON_BULK_RX_PREAMBLE_LENGTH           5
+
+/*!
+ * Expands channel( i ) for the 8 channel indexes starting at first, as a
+ * part of the initializer of a const channel table.
+ *
+ * The regions with a fixed channel plan build their channels in flash with
+ * this macro instead of computing them into the NVM data at start up.
+ */
+#define REGION_COMMON_CHANNELS_8( channel, first )                             \
+    channel( ( first ) + 0 ), channel( ( first ) + 1 ), channel( ( first ) + 2 ), \
+    channel( ( first ) + 3 ), channel( ( first ) + 4 ), channel( ( first ) + 5 ), \
+    channel( ( first ) + 6 ), channel( ( first ) + 7 )
+
+/*!
+ * Highest GFSK bulk reception bit rate using a modulation index of 1. Higher
+ * bit rates use a modulation index of 0.5 to fit the receiver bandwidth.
+ */
+#define REGION_COMMON_BULK_RX_WIDE_FDEV_MAX_BITRATE     100000
+
+/*!
+ * Number of preamble symbols the receiver needs to detect a LoRa preamble
+ * during an RX duty cycle ( sniff ) window
+ */
+#define REGION_COMMON_RX_SNIFF_DETECT_SYMBOLS           2
+
+/*!
+ * Longest RX duty cycle ( sniff ) period in RTC steps of 15.625 us. The radio
+ * takes the periods as 24-bit values ( 262 s ).
+ */
+#define REGION_COMMON_RX_SNIFF_MAX_PERIOD               0xFFFFFF
+
+/*!
+ * Time in us the radio needs to go from sleep to reception during an RX duty
+ * cycle ( sniff ) period
+ */
+#ifndef REGION_COMMON_RX_SNIFF_WAKEUP_TIME
+#define REGION_COMMON_RX_SNIFF_WAKEUP_TIME              400
+#endif
+
+/*!
+ * Radio current in nA while receiving. Used by the RX duty cycle ( sniff ) model.
+ */
+#ifndef REGION_COMMON_RX_SNIFF_RX_CURRENT
+#define REGION_COMMON_RX_SNIFF_RX_CURRENT               4600000
+#endif
+
+/*!
+ * Radio current in nA while sleeping with the RTC running. Used by the
+ * RX duty cycle ( sniff ) model.
+ */
+#ifndef REGION_COMMON_RX_SNIFF_SLEEP_CURRENT
+#define REGION_COMMON_RX_SNIFF_SLEEP_CURRENT            1200
+#endif
+
 
 typedef struct sRegionCommonLinkAdrParams
 {
@@ -198,7 +267,7 @@ typedef struct sRegionCommonLinkAdrReqVerifyParams
     /*!
      * Pointer to the channels.
      */
-    ChannelParams_t* Channels;
+    const ChannelParams_t* Channels;
     /*!
      * The minimum possible TX power.
      */
@@ -241,6 +310,26 @@ typedef struct sRegionCommonRxBeaconSetupParams
     uint16_t SymbolTimeout;
 }RegionCommonRxBeaconSetupParams_t;
 
+typedef struct sRegionCommonRxSniffParams
+{
+    /*!
+     * Reception period in RTC steps of 15.625 us
+     */
+    uint32_t RxTime;
+    /*!
+     * Sleep period in RTC steps of 15.625 us
+     */
+    uint32_t SleepTime;
+    /*!
+     * Estimated average radio current [uA]
+     */
+    uint32_t AvgCurrent;
+    /*!
+     * Estimated probability to miss a downlink [1/1000]
+     */
+    uint16_t MissRate;
+}RegionCommonRxSniffParams_t;
+
 typedef struct sRegionCommonCountNbOfEnabledChannelsParams
 {
     /*!
@@ -258,7 +347,7 @@ typedef struct sRegionCommonCountNbOfEnabledChannelsParams
     /*!
      * A pointer to the channels.
      */
-    ChannelParams_t* Channels;
+    const ChannelParams_t* Channels;
     /*!
      * A pointer to the bands.
      */
@@ -327,6 +416,70 @@ typedef struct sRegionCommonSetDutyCycleParams
     Band_t* Bands;
 }RegionCommonSetDutyCycleParams_t;
 
+/*!
+ * Listen before talk context of a region
+ */
+typedef struct sRegionCommonLbtCtx
+{
+    /*!
+     * Frequency the busy ratio of each channel was measured on.
+     */
+    uint32_t Frequencies[REGION_COMMON_LBT_MAX_NB_CHANNELS];
+    /*!
+     * Moving average of the channel busy probability of each channel.
+     * [0: always free, 0xFFFF: always busy]
+     */
+    uint16_t BusyRatios[REGION_COMMON_LBT_MAX_NB_CHANNELS];
+    /*!
+     * Bitmask of the channels found busy during the current procedure.
+     */
+    uint16_t BusyChannels;
+    /*!
+     * Channel being sensed.
+     */
+    uint8_t Channel;
+    /*!
+     * Set to true, while a channel sense is running.
+     */
+    bool Sensing;
+    /*!
+     * Time the running channel sense was started.
+     */
+    TimerTime_t SenseStartTime;
+}RegionCommonLbtCtx_t;
+
+typedef struct sRegionCommonLbtParams
+{
+    /*!
+     * A pointer to the channels.
+     */
+    const ChannelParams_t* Channels;
+    /*!
+     * A pointer to the channels available for the next transmission.
+     */
+    uint8_t* EnabledChannels;
+    /*!
+     * Number of channels available for the next transmission.
+     */
+    uint8_t NbEnabledChannels;
+    /*!
+     * Rx bandwidth in Hertz used for the channel sense.
+     */
+    uint32_t RxBandwidth;
+    /*!
+     * RSSI threshold in dBm.
+     */
+    int16_t RssiThresh;
+    /*!
+     * Carrier sense time in ms.
+     */
+    uint32_t CarrierSenseTime;
+    /*!
+     * Result of the last asynchronous channel sense.
+     */
+    ChannelSenseResult_t ChannelSense;
+}RegionCommonLbtParams_t;
+
 typedef struct sRegionCommonGetNextLowerTxDrParams
 {
     int8_t CurrentDr;
@@ -334,7 +487,7 @@ typedef struct sRegionCommonGetNextLowerTxDrParams
     int8_t MinDr;
     uint8_t NbChannels;
     uint16_t* ChannelsMask;
-    ChannelParams_t* Channels;
+    const ChannelParams_t* Channels;
 }RegionCommonGetNextLowerTxDrParams_t;
 
 /*!
@@ -370,7 +523,7 @@ uint8_t RegionCommonValueInRange( int8_t value, int8_t min, int8_t max );
  * \retval Returns true if the datarate is supported, false if not.
  */
 bool RegionCommonChanVerifyDr( uint8_t nbChannels, uint16_t* channelsMask, int8_t dr,
-                            int8_t minDr, int8_t maxDr, ChannelParams_t* channels );
+                            int8_t minDr, int8_t maxDr, const ChannelParams_t* channels );
 
 /*!
  * \brief Disables a channel in a given channels mask.
@@ -412,6 +565,56 @@ uint8_t RegionCommonCountChannels( uint16_t* channelsMask, uint8_t startIdx, uin
  */
 void RegionCommonChanMaskCopy( uint16_t* channelsMaskDest, uint16_t* channelsMaskSrc, uint8_t len );
 
+/*!
+ * \brief Counts the channels set in one word of a channels mask.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] mask Channels mask word.
+ *
+ * \retval Returns the number of channels set.
+ */
+uint8_t RegionCommonChanMaskPopCount( uint16_t mask );
+
+/*!
+ * \brief Finds the first channel set in one word of a channels mask.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] mask Channels mask word.
+ *
+ * \retval Returns the index of the lowest channel set [16: none].
+ */
+uint8_t RegionCommonChanMaskFirst( uint16_t mask );
+
+/*!
+ * \brief Finds the n-th channel set in a channels mask, in ascending channel
+ *        order. Used to pick a random channel of a mask without building the
+ *        list of its channels.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] channelsMask The channels mask.
+ *
+ * \param [IN] len The number of words of the channels mask.
+ *
+ * \param [IN] n Rank of the channel, starting at 0.
+ *
+ * \param [OUT] channel Channel index.
+ *
+ * \retval Returns true if the mask holds more than n channels, false if not.
+ */
+bool RegionCommonChanMaskSelect( uint16_t* channelsMask, uint8_t len, uint8_t n, uint8_t* channel );
+
+/*!
+ * \brief Keeps in a channels mask only the channels also set in a second one.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN/OUT] channelsMaskDest The channels mask to update.
+ *
+ * \param [IN] channelsMaskSrc The channels mask to apply.
+ *
+ * \param [IN] len The number of words to update.
+ */
+void RegionCommonChanMaskAnd( uint16_t* channelsMaskDest, uint16_t* channelsMaskSrc, uint8_t len );
+
 /*!
  * \brief Sets the last tx done property.
  *        This is a generic function and valid for all regions.
@@ -543,6 +746,47 @@ int8_t RegionCommonComputeTxPower( int8_t txPowerIndex, float maxEirp, float ant
  */
 void RegionCommonRxBeaconSetup( RegionCommonRxBeaconSetupParams_t* rxBeaconSetupParams );
 
+/*!
+ * \brief Sets up the radio into continuous GFSK bulk reception.
+ *
+ * \remark The receiver bandwidth follows Carson's rule and is rounded up to
+ *         the next SX126x GFSK filter by the radio driver. Frames use the
+ *         variable length format with whitening and a 2 bytes CCITT CRC.
+ *
+ * \param [IN] frequency Reception frequency [Hz].
+ *
+ * \param [IN] bitrate   Bit rate [bits/s].
+ */
+void RegionCommonRxBulkSetup( uint32_t frequency, uint32_t bitrate );
+
+/*!
+ * \brief Computes the RX duty cycle ( sniff ) periods catching a downlink
+ *        preamble with the given miss probability.
+ *
+ * \remark The radio listens during RxTime and is off air during SleepTime
+ *         plus its wake up time. A preamble of Tp starting at a random time
+ *         is caught when a reception period overlaps at least
+ *         REGION_COMMON_RX_SNIFF_DETECT_SYMBOLS ( D ) of it. With Toff the
+ *         time off air and T the whole period, the miss probability is
+ *         max( 0, Toff + 2 * D - Tp ) / T. The reception period is set to D
+ *         and the longest Toff meeting maxMissRate is used, the sleep
+ *         period being limited to REGION_COMMON_RX_SNIFF_MAX_PERIOD. The average
+ *         current weights the RX current over the reception and wake up
+ *         times and the sleep current over the sleep time.
+ *
+ * \param [IN] tSymbolInUs  LoRa symbol time [us].
+ *
+ * \param [IN] preambleLen  Downlink preamble length [symbols].
+ *
+ * \param [IN] maxMissRate  Accepted probability to miss a downlink [1/1000].
+ *                          0 guarantees each preamble is caught.
+ *
+ * \param [OUT] sniffParams Computed periods and model estimates.
+ *
+ * \retval Returns true when duty cycling saves current over continuous reception.
+ */
+bool RegionCommonComputeRxSniffParams( uint32_t tSymbolInUs, uint16_t preambleLen, uint16_t maxMissRate, RegionCommonRxSniffParams_t* sniffParams );
+
 /*!
  * \brief Counts the number of enabled channels.
  *
@@ -585,6 +829,50 @@ LoRaMacStatus_t RegionCommonIdentifyChannels( RegionCommonIdentifyChannelsParam_
                                               uint8_t* nbEnabledChannels, uint8_t* nbRestrictedChannels,
                                               TimerTime_t* nextTxDelay );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed, without updating
+ *        the bands.
+ *
+ * \details Each band stores its ReadyTime whenever its credits change, in
+ *          \ref RegionCommonUpdateBandTimeOff and \ref RegionCommonSetBandTxDone.
+ *          A band can carry an uplink of credit costs C after ReadyTime + C,
+ *          so the query is a minimum over the bands owning an enabled channel
+ *          of the datarate, with no SysTime arithmetic. The aggregated
+ *          time-off is taken into account.
+ *
+ * \remark Only the joined state is handled. The join back-off depends on the
+ *         time since startup and is left to \ref RegionCommonIdentifyChannels.
+ *
+ * \param [IN] identifyChannelsParam A pointer to the input parameters.
+ *
+ * \retval Time to wait for the next uplink [ms, 0: now, TIMERTIME_T_MAX: unknown,
+ *         not joined or no channel supports the datarate].
+ */
+TimerTime_t RegionCommonGetNextTxDelay( RegionCommonIdentifyChannelsParam_t* identifyChannelsParam );
+
+/*!
+ * \brief Runs the listen before talk procedure over the available channels.
+ *
+ * \details The channels are sensed by increasing busy probability. When the
+ *          radio supports it, the channel sense runs asynchronously: the
+ *          function starts it and returns LORAMAC_STATUS_CHANNEL_SENSE_PENDING.
+ *          It shall be called again with the channel sense result.
+ *
+ * \param [IN] ctx Listen before talk context of the region.
+ *
+ * \param [IN] lbtParams A pointer to the input parameters.
+ *
+ * \param [OUT] channel The free channel found.
+ *
+ * \param [OUT] time Time to wait for the channel sense result.
+ *
+ * \retval Status of the operation [LORAMAC_STATUS_OK,
+ *                                  LORAMAC_STATUS_CHANNEL_SENSE_PENDING,
+ *                                  LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND].
+ */
+LoRaMacStatus_t RegionCommonLbtNextChannel( RegionCommonLbtCtx_t* ctx, RegionCommonLbtParams_t* lbtParams,
+                                            uint8_t* channel, TimerTime_t* time );
+
 /*!
  * \brief Selects the next lower datarate.
  *
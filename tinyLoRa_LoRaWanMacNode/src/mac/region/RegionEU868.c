@@ -93,6 +93,12 @@ static TimerTime_t GetTimeOnAir( int8_t datarate, uint16_t pktLen )
     { // High Speed FSK channel
         timeOnAir = Radio.TimeOnAir( MODEM_FSK, bandwidth, phyDr * 1000, 0, 5, false, pktLen, true );
     }
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+    else if( datarate >= EU868_LR_FHSS_MIN_DATARATE )
+    { // LR-FHSS channel
+        timeOnAir = Radio.TimeOnAir( MODEM_LR_FHSS, LrFhssBandwidthsEU868[datarate - EU868_LR_FHSS_MIN_DATARATE], 0, phyDr, 0, false, pktLen, true );
+    }
+#endif
     else
     {
         timeOnAir = Radio.TimeOnAir( MODEM_LORA, bandwidth, phyDr, 1, 8, false, pktLen, true );
@@ -565,6 +571,13 @@ bool RegionEU868TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
         modem = MODEM_FSK;
         Radio.SetTxConfig( modem, phyTxPower, 25000, bandwidth, phyDr * 1000, 0, 5, false, true, 0, 0, false, 4000 );
     }
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+    else if( txConfig->Datarate >= EU868_LR_FHSS_MIN_DATARATE )
+    { // LR-FHSS channel, 3.9 kHz hopping grid
+        modem = MODEM_LR_FHSS;
+        Radio.SetTxConfig( modem, phyTxPower, 0, LrFhssBandwidthsEU868[txConfig->Datarate - EU868_LR_FHSS_MIN_DATARATE], 0, phyDr, 0, false, true, false, 0, false, 8000 );
+    }
+#endif
     else
     {
         modem = MODEM_LORA;
@@ -853,6 +866,33 @@ LoRaMacStatus_t RegionEU868NextChannel( NextChanParams_t* nextChanParams, uint8_
     return status;
 }
 
+TimerTime_t RegionEU868GetNextTxDelay( NextChanParams_t* nextChanParams )
+{
+    RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
+    RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
+
+    countChannelsParams.Joined = nextChanParams->Joined;
+    countChannelsParams.Datarate = nextChanParams->Datarate;
+    countChannelsParams.ChannelsMask = RegionNvmGroup2->ChannelsMask;
+    countChannelsParams.Channels = RegionNvmGroup2->Channels;
+    countChannelsParams.Bands = RegionBands;
+    countChannelsParams.MaxNbChannels = EU868_MAX_NB_CHANNELS;
+    countChannelsParams.JoinChannels = NULL;
+
+    identifyChannelsParam.AggrTimeOff = nextChanParams->AggrTimeOff;
+    identifyChannelsParam.LastAggrTx = nextChanParams->LastAggrTx;
+    identifyChannelsParam.DutyCycleEnabled = nextChanParams->DutyCycleEnabled;
+    identifyChannelsParam.MaxBands = EU868_MAX_NB_BANDS;
+
+    identifyChannelsParam.ElapsedTimeSinceStartUp = nextChanParams->ElapsedTimeSinceStartUp;
+    identifyChannelsParam.LastTxIsJoinRequest = nextChanParams->LastTxIsJoinRequest;
+    identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
+
+    identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+
+    return RegionCommonGetNextTxDelay( &identifyChannelsParam );
+}
+
 LoRaMacStatus_t RegionEU868ChannelAdd( ChannelAddParams_t* channelAdd )
 {
     uint8_t band = 0;
@@ -930,7 +970,15 @@ bool RegionEU868ChannelsRemove( ChannelRemoveParams_t* channelRemove  )
 
 uint8_t RegionEU868ApplyDrOffset( uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset )
 {
-    int8_t datarate = dr - drOffset;
+    int8_t datarate = 0;
+
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+    if( dr >= EU868_LR_FHSS_MIN_DATARATE )
+    { // LR-FHSS uplinks are answered as DR_1 ( coding rate 1/3 ) or DR_2 ( coding rate 2/3 ) uplinks
+        dr = ( ( dr - EU868_LR_FHSS_MIN_DATARATE ) % 2 ) + DR_1;
+    }
+#endif
+    datarate = dr - drOffset;
 
     if( datarate < 0 )
     {
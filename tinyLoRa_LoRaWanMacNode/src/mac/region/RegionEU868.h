@@ -66,8 +66,15 @@ extern "C"
 
 /*!
  * Maximal datarate that can be used by the node
+ *
+ * \remark The LR-FHSS datarates DR_8 to DR_11 are only enabled with
+ *         LORAMAC_LR_FHSS_ENABLED, see radio/sx126x/bench/lr-fhss-bench.c
  */
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+#define EU868_TX_MAX_DATARATE                       DR_11
+#else
 #define EU868_TX_MAX_DATARATE                       DR_7
+#endif
 
 /*!
  * Minimal datarate that can be used by the node
@@ -198,31 +205,31 @@ extern "C"
 
 /*!
  * Band 0 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define EU868_BAND0                                 { 100 , EU868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
 
 /*!
  * Band 1 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define EU868_BAND1                                 { 100 , EU868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
 
 /*!
  * Band 2 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define EU868_BAND2                                 { 1000, EU868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  0.1 %
 
 /*!
  * Band 3 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define EU868_BAND3                                 { 10  , EU868_MAX_TX_POWER, 0, 0, 0, 0, 0 } // 10.0 %
 
 /*!
  * Band 4 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define EU868_BAND4                                 { 100 , EU868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
 
@@ -256,6 +263,34 @@ extern "C"
  */
 #define EU868_JOIN_CHANNELS                         ( uint16_t )( LC( 1 ) | LC( 2 ) | LC( 3 ) )
 
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+/*!
+ * Data rates table definition
+ */
+static const uint8_t DataratesEU868[]  = { 12, 11, 10,  9,  8,  7,  7, 50, 3, 1, 3, 1 };
+
+/*!
+ * Bandwidths table definition in Hz
+ */
+static const uint32_t BandwidthsEU868[] = { 125000, 125000, 125000, 125000, 125000, 125000, 250000, 0, 137000, 137000, 336000, 336000 };
+
+/*!
+ * Maximum payload with respect to the datarate index.
+ */
+static const uint8_t MaxPayloadOfDatarateEU868[] = { 51, 51, 51, 115, 242, 242, 242, 242, 58, 123, 58, 123 };
+
+/*!
+ * First LR-FHSS datarate. The datarates table holds the LR-FHSS coding rate
+ * [1: 2/3, 3: 1/3] of these datarates.
+ */
+#define EU868_LR_FHSS_MIN_DATARATE                  DR_8
+
+/*!
+ * LR-FHSS operating channel widths [2: 136.72 kHz, 4: 335.94 kHz] with
+ * respect to the datarate index starting at EU868_LR_FHSS_MIN_DATARATE
+ */
+static const uint8_t LrFhssBandwidthsEU868[] = { 2, 2, 4, 4 };
+#else
 /*!
  * Data rates table definition
  */
@@ -270,6 +305,7 @@ static const uint32_t BandwidthsEU868[] = { 125000, 125000, 125000, 125000, 1250
  * Maximum payload with respect to the datarate index.
  */
 static const uint8_t MaxPayloadOfDatarateEU868[] = { 51, 51, 51, 115, 242, 242, 242, 242 };
+#endif
 
 /*!
  * \brief The function gets a value of a specific phy attribute.
@@ -431,6 +467,15 @@ int8_t RegionEU868AlternateDr( int8_t currentDr, AlternateDrType_t type );
  */
 LoRaMacStatus_t RegionEU868NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown or no channel].
+ */
+TimerTime_t RegionEU868GetNextTxDelay( NextChanParams_t* nextChanParams );
+
 /*!
  * \brief Adds a channel.
  *
@@ -53,21 +53,23 @@ typedef enum eRegionCN470ChannelPlan
 }RegionCN470ChannelPlan_t;
 
 // Selection of REGION_NVM_MAX_NB_CHANNELS
-#if defined( REGION_CN470 )
-    #define REGION_NVM_MAX_NB_CHANNELS                 96
-#elif defined( REGION_US915 ) || defined( REGION_AU915 )
-    #define REGION_NVM_MAX_NB_CHANNELS                 72
-#elif defined( REGION_AS923 ) || defined( REGION_CN779 ) || \
-      defined( REGION_EU433 ) || defined( REGION_EU868 ) || \
-      defined( REGION_IN865 ) || defined( REGION_KR920 )
+// The fixed channel plans of CN470, US915 and AU915 are const tables in
+// flash, only the regions with a channel list changed by NewChannelReq keep
+// their channels in the NVM data.
+#if defined( REGION_AS923 ) || defined( REGION_CN779 ) || \
+    defined( REGION_EU433 ) || defined( REGION_EU868 ) || \
+    defined( REGION_IN865 ) || defined( REGION_KR920 ) || \
+    defined( REGION_PRIV868 )
     #define REGION_NVM_MAX_NB_CHANNELS                 16
-#else
-    // Region_RU864
+#elif defined( REGION_RU864 )
     #define REGION_NVM_MAX_NB_CHANNELS                 8
+#else
+    // Region_CN470, Region_US915 and Region_AU915 only
+    #define REGION_NVM_MAX_NB_CHANNELS                 0
 #endif
 
 // Selection of REGION_NVM_MAX_NB_BANDS
-#if defined( REGION_EU868 )
+#if defined( REGION_EU868 ) || defined( REGION_PRIV868 )
     #define REGION_NVM_MAX_NB_BANDS                    6
 #else
     // All others
@@ -117,10 +119,12 @@ typedef struct sRegionNvmDataGroup1
  */
 typedef struct sRegionNvmDataGroup2
 {
+#if ( REGION_NVM_MAX_NB_CHANNELS > 0 )
     /*!
      * LoRaMAC channels
      */
     ChannelParams_t Channels[ REGION_NVM_MAX_NB_CHANNELS ];
+#endif
     /*!
      * LoRaMac channels mask
      */
@@ -0,0 +1,520 @@
+/*!
+ * \file      RegionPRIV868.h
+ *
+ * \brief     Region definition for PRIV868, private network PHY profile on the
+ *            EU868 band
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2017 Semtech
+ *
+ *               ___ _____ _   ___ _  _____ ___  ___  ___ ___
+ *              / __|_   _/_\ / __| |/ / __/ _ \| _ \/ __| __|
+ *              \__ \ | |/ _ \ (__| ' <| _| (_) |   / (__| _|
+ *              |___/ |_/_/ \_\___|_|\_\_| \___/|_|_\\___|___|
+ *              embedded.connectivity.solutions===============
+ *
+ * \endcode
+ *
+ * \author    Miguel Luis ( Semtech )
+ *
+ * \author    Gregory Cristian ( Semtech )
+ *
+ * \author    Daniel Jaeckle ( STACKFORCE )
+ *
+ * \author    Johannes Bruder ( STACKFORCE )
+ *
+ * \defgroup  REGIONPRIV868 Region PRIV868
+ *            Private network profile derived from EU868. The channel plan,
+ *            bands and duty cycle rules are the EU868 ones while the datarate
+ *            table is extended with SF5/SF6 and 250/500 kHz LoRa datarates
+ *            available on SX126x based gateways and end-devices.
+ *            Not interoperable with LoRaWAN network servers.
+ * \{
+ */
+#ifndef __REGION_PRIV868_H__
+#define __REGION_PRIV868_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "region/Region.h"
+
+/*!
+ * LoRaMac maximum number of channels
+ */
+#define PRIV868_MAX_NB_CHANNELS                     16
+
+/*!
+ * Number of default channels
+ */
+#define PRIV868_NUMB_DEFAULT_CHANNELS               3
+
+/*!
+ * Number of channels to apply for the CF list
+ */
+#define PRIV868_NUMB_CHANNELS_CF_LIST               5
+
+/*!
+ * Minimal datarate that can be used by the node
+ */
+#define PRIV868_TX_MIN_DATARATE                     DR_0
+
+/*!
+ * Maximal datarate that can be used by the node
+ */
+#define PRIV868_TX_MAX_DATARATE                     DR_13
+
+/*!
+ * Minimal datarate that can be used by the node
+ */
+#define PRIV868_RX_MIN_DATARATE                     DR_0
+
+/*!
+ * Maximal datarate that can be used by the node
+ */
+#define PRIV868_RX_MAX_DATARATE                     DR_13
+
+/*!
+ * Default datarate used by the node
+ */
+#define PRIV868_DEFAULT_DATARATE                    DR_0
+
+/*!
+ * Minimal Rx1 receive datarate offset
+ */
+#define PRIV868_MIN_RX1_DR_OFFSET                   0
+
+/*!
+ * Maximal Rx1 receive datarate offset
+ */
+#define PRIV868_MAX_RX1_DR_OFFSET                   5
+
+/*!
+ * Minimal Tx output power that can be used by the node
+ */
+#define PRIV868_MIN_TX_POWER                        TX_POWER_7
+
+/*!
+ * Maximal Tx output power that can be used by the node
+ */
+#define PRIV868_MAX_TX_POWER                        TX_POWER_0
+
+/*!
+ * Default Tx output power used by the node
+ */
+#define PRIV868_DEFAULT_TX_POWER                    TX_POWER_0
+
+/*!
+ * Default Max EIRP
+ */
+#define PRIV868_DEFAULT_MAX_EIRP                    16.0f
+
+/*!
+ * Default antenna gain
+ */
+#define PRIV868_DEFAULT_ANTENNA_GAIN                2.15f
+
+/*!
+ * Enabled or disabled the duty cycle
+ */
+#define PRIV868_DUTY_CYCLE_ENABLED                  1
+
+/*!
+ * Maximum RX window duration
+ */
+#define PRIV868_MAX_RX_WINDOW                       3000
+
+#if ( PRIV868_DEFAULT_DATARATE > DR_5 )
+#error "A default DR higher than DR_5 may lead to connectivity loss."
+#endif
+
+/*!
+ * Second reception window channel frequency definition.
+ */
+#define PRIV868_RX_WND_2_FREQ                       869525000
+
+/*!
+ * Second reception window channel datarate definition.
+ */
+#define PRIV868_RX_WND_2_DR                         DR_0
+
+/*!
+ * Default uplink dwell time configuration
+ */
+#define PRIV868_DEFAULT_UPLINK_DWELL_TIME           0
+
+/*
+ * CLASS B
+ */
+/*!
+ * Beacon frequency
+ */
+#define PRIV868_BEACON_CHANNEL_FREQ                 869525000
+
+/*!
+ * Ping slot channel frequency
+ */
+#define PRIV868_PING_SLOT_CHANNEL_FREQ              869525000
+
+/*!
+ * Payload size of a beacon frame
+ */
+#define PRIV868_BEACON_SIZE                         17
+
+/*!
+ * Size of RFU 1 field
+ */
+#define PRIV868_RFU1_SIZE                           1
+
+/*!
+ * Size of RFU 2 field
+ */
+#define PRIV868_RFU2_SIZE                           0
+
+/*!
+ * Datarate of the beacon channel
+ */
+#define PRIV868_BEACON_CHANNEL_DR                   DR_3
+
+/*!
+ * Bandwith of the beacon channel
+ */
+#define PRIV868_BEACON_CHANNEL_BW                   0
+
+/*!
+ * Ping slot channel datarate
+ */
+#define PRIV868_PING_SLOT_CHANNEL_DR                DR_3
+
+/*!
+ * Maximum number of bands
+ */
+#define PRIV868_MAX_NB_BANDS                        6
+
+/*!
+ * Band 0 definition
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
+ */
+#define PRIV868_BAND0                               { 100 , PRIV868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
+
+/*!
+ * Band 1 definition
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
+ */
+#define PRIV868_BAND1                               { 100 , PRIV868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
+
+/*!
+ * Band 2 definition
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
+ */
+#define PRIV868_BAND2                               { 1000, PRIV868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  0.1 %
+
+/*!
+ * Band 3 definition
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
+ */
+#define PRIV868_BAND3                               { 10  , PRIV868_MAX_TX_POWER, 0, 0, 0, 0, 0 } // 10.0 %
+
+/*!
+ * Band 4 definition
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
+ */
+#define PRIV868_BAND4                               { 100 , PRIV868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  1.0 %
+
+/*!
+ * Band 5 definition
+ * Band = { DutyCycle, TxMaxPower, LastJoinTxDoneTime, LastTxDoneTime, TimeOff,
+ *          DutyCycleTimePeriod, MaxAllowedTimeOnAir, AggregatedTimeOnAir, StartTimeOfPeriod }
+ */
+#define PRIV868_BAND5                               { 1000, PRIV868_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  0.1 %
+
+/*!
+ * Highest datarate of the 868.1 and 868.5 MHz default channels and of the
+ * CFList channels, the last 125 kHz datarate before the first 250 kHz one.
+ * Datarates above are only enabled on the 868.3 MHz channel, the only one on
+ * which a 250 kHz or 500 kHz signal fits in the 868.0 - 868.6 MHz sub-band.
+ */
+#define PRIV868_NARROW_CHANNEL_MAX_DATARATE         DR_6
+
+/*!
+ * LoRaMac default channel 1
+ * Channel = { Frequency [Hz], RX1 Frequency [Hz], { ( ( DrMax << 4 ) | DrMin ) }, Band }
+ */
+#define PRIV868_LC1                                 { 868100000, 0, { ( ( PRIV868_NARROW_CHANNEL_MAX_DATARATE << 4 ) | DR_0 ) }, 1 }
+
+/*!
+ * LoRaMac default channel 2
+ * Channel = { Frequency [Hz], RX1 Frequency [Hz], { ( ( DrMax << 4 ) | DrMin ) }, Band }
+ */
+#define PRIV868_LC2                                 { 868300000, 0, { ( ( PRIV868_TX_MAX_DATARATE << 4 ) | DR_0 ) }, 1 }
+
+/*!
+ * LoRaMac default channel 3
+ * Channel = { Frequency [Hz], RX1 Frequency [Hz], { ( ( DrMax << 4 ) | DrMin ) }, Band }
+ */
+#define PRIV868_LC3                                 { 868500000, 0, { ( ( PRIV868_NARROW_CHANNEL_MAX_DATARATE << 4 ) | DR_0 ) }, 1 }
+
+/*!
+ * LoRaMac channels which are allowed for the join procedure
+ */
+#define PRIV868_JOIN_CHANNELS                       ( uint16_t )( LC( 1 ) | LC( 2 ) | LC( 3 ) )
+
+/*!
+ * Data rates table definition
+ *
+ * DR   | 0    | 1    | 2    | 3   | 4   | 5   | 6   | 7   | 8   | 9   | 10  | 11  | 12  | 13
+ * ---- | :--: | :--: | :--: | :-: | :-: | :-: | :-: | :-: | :-: | :-: | :-: | :-: | :-: | :-:
+ * SF   | 12   | 11   | 10   | 9   | 8   | 7   | 6   | 7   | 5   | 6   | 7   | 5   | 6   | 5
+ * BW   | 125  | 125  | 125  | 125 | 125 | 125 | 125 | 250 | 125 | 250 | 500 | 250 | 500 | 500
+ *
+ * Datarates are sorted by increasing PHY bit rate. The low datarate
+ * optimization and the 12 symbols SF5/SF6 preamble are applied by the radio
+ * driver.
+ */
+static const uint8_t DataratesPRIV868[]  = { 12, 11, 10,  9,  8,  7,  6,  7,  5,  6,  7,  5,  6,  5 };
+
+/*!
+ * Bandwidths table definition in Hz
+ */
+static const uint32_t BandwidthsPRIV868[] = { 125000, 125000, 125000, 125000, 125000, 125000, 125000, 250000, 125000, 250000, 500000, 250000, 500000, 500000 };
+
+/*!
+ * Maximum payload with respect to the datarate index.
+ */
+static const uint8_t MaxPayloadOfDataratePRIV868[] = { 51, 51, 51, 115, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242 };
+
+/*!
+ * \brief The function gets a value of a specific phy attribute.
+ *
+ * \param [IN] getPhy Pointer to the function parameters.
+ *
+ * \retval Returns a structure containing the PHY parameter.
+ */
+PhyParam_t RegionPRIV868GetPhyParam( GetPhyParams_t* getPhy );
+
+/*!
+ * \brief Updates the last TX done parameters of the current channel.
+ *
+ * \param [IN] txDone Pointer to the function parameters.
+ */
+void RegionPRIV868SetBandTxDone( SetBandTxDoneParams_t* txDone );
+
+/*!
+ * \brief Initializes the channels masks and the channels.
+ *
+ * \param [IN] type Sets the initialization type.
+ */
+void RegionPRIV868InitDefaults( InitDefaultsParams_t* params );
+
+/*!
+ * \brief Verifies a parameter.
+ *
+ * \param [IN] verify Pointer to the function parameters.
+ *
+ * \param [IN] type Sets the initialization type.
+ *
+ * \retval Returns true, if the parameter is valid.
+ */
+bool RegionPRIV868Verify( VerifyParams_t* verify, PhyAttribute_t phyAttribute );
+
+/*!
+ * \brief The function parses the input buffer and sets up the channels of the
+ *        CF list.
+ *
+ * \param [IN] applyCFList Pointer to the function parameters.
+ */
+void RegionPRIV868ApplyCFList( ApplyCFListParams_t* applyCFList );
+
+/*!
+ * \brief Sets a channels mask.
+ *
+ * \param [IN] chanMaskSet Pointer to the function parameters.
+ *
+ * \retval Returns true, if the channels mask could be set.
+ */
+bool RegionPRIV868ChanMaskSet( ChanMaskSetParams_t* chanMaskSet );
+
+/*!
+ * Computes the Rx window timeout and offset.
+ *
+ * \param [IN] datarate     Rx window datarate index to be used
+ *
+ * \param [IN] minRxSymbols Minimum required number of symbols to detect an Rx frame.
+ *
+ * \param [IN] rxError      System maximum timing error of the receiver. In milliseconds
+ *                          The receiver will turn on in a [-rxError : +rxError] ms
+ *                          interval around RxOffset
+ *
+ * \param [OUT]rxConfigParams Returns updated WindowTimeout and WindowOffset fields.
+ */
+void RegionPRIV868ComputeRxWindowParameters( int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams );
+
+/*!
+ * \brief Configuration of the RX windows.
+ *
+ * \param [IN] rxConfig Pointer to the function parameters.
+ *
+ * \param [OUT] datarate The datarate index which was set.
+ *
+ * \retval Returns true, if the configuration was applied successfully.
+ */
+bool RegionPRIV868RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate );
+
+/*!
+ * \brief TX configuration.
+ *
+ * \param [IN] txConfig Pointer to the function parameters.
+ *
+ * \param [OUT] txPower The tx power index which was set.
+ *
+ * \param [OUT] txTimeOnAir The time-on-air of the frame.
+ *
+ * \retval Returns true, if the configuration was applied successfully.
+ */
+bool RegionPRIV868TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir );
+
+/*!
+ * \brief The function processes a Link ADR Request.
+ *
+ * \param [IN] linkAdrReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionPRIV868LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, int8_t* txPowOut, uint8_t* nbRepOut, uint8_t* nbBytesParsed );
+
+/*!
+ * \brief The function processes a RX Parameter Setup Request.
+ *
+ * \param [IN] rxParamSetupReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+uint8_t RegionPRIV868RxParamSetupReq( RxParamSetupReqParams_t* rxParamSetupReq );
+
+/*!
+ * \brief The function processes a Channel Request.
+ *
+ * \param [IN] newChannelReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+int8_t RegionPRIV868NewChannelReq( NewChannelReqParams_t* newChannelReq );
+
+/*!
+ * \brief The function processes a TX ParamSetup Request.
+ *
+ * \param [IN] txParamSetupReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ *         Returns -1, if the functionality is not implemented. In this case, the end node
+ *         shall not process the command.
+ */
+int8_t RegionPRIV868TxParamSetupReq( TxParamSetupReqParams_t* txParamSetupReq );
+
+/*!
+ * \brief The function processes a DlChannel Request.
+ *
+ * \param [IN] dlChannelReq Pointer to the function parameters.
+ *
+ * \retval Returns the status of the operation, according to the LoRaMAC specification.
+ */
+int8_t RegionPRIV868DlChannelReq( DlChannelReqParams_t* dlChannelReq );
+
+/*!
+ * \brief Alternates the datarate of the channel for the join request.
+ *
+ * \param [IN] currentDr Current datarate.
+ *
+ * \retval Datarate to apply.
+ */
+int8_t RegionPRIV868AlternateDr( int8_t currentDr, AlternateDrType_t type );
+
+/*!
+ * \brief Searches and set the next random available channel
+ *
+ * \param [OUT] channel Next channel to use for TX.
+ *
+ * \param [OUT] time Time to wait for the next transmission according to the duty
+ *              cycle.
+ *
+ * \param [OUT] aggregatedTimeOff Updates the aggregated time off.
+ *
+ * \retval Function status [1: OK, 0: Unable to find a channel on the current datarate]
+ */
+LoRaMacStatus_t RegionPRIV868NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
+
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown or no channel].
+ */
+TimerTime_t RegionPRIV868GetNextTxDelay( NextChanParams_t* nextChanParams );
+
+/*!
+ * \brief Adds a channel.
+ *
+ * \param [IN] channelAdd Pointer to the function parameters.
+ *
+ * \retval Status of the operation.
+ */
+LoRaMacStatus_t RegionPRIV868ChannelAdd( ChannelAddParams_t* channelAdd );
+
+/*!
+ * \brief Removes a channel.
+ *
+ * \param [IN] channelRemove Pointer to the function parameters.
+ *
+ * \retval Returns true, if the channel was removed successfully.
+ */
+bool RegionPRIV868ChannelsRemove( ChannelRemoveParams_t* channelRemove  );
+
+/*!
+ * \brief Computes the time-on-air of a frame sent with the profile parameters.
+ *
+ * \param [IN] datarate Datarate index.
+ *
+ * \param [IN] pktLen   PHY payload length.
+ *
+ * \retval timeOnAir Time-on-air in milliseconds.
+ */
+TimerTime_t RegionPRIV868GetTimeOnAir( int8_t datarate, uint16_t pktLen );
+
+/*!
+ * \brief Computes new datarate according to the given offset
+ *
+ * \param [IN] downlinkDwellTime Downlink dwell time configuration. 0: No limit, 1: 400ms
+ *
+ * \param [IN] dr Current datarate
+ *
+ * \param [IN] drOffset Offset to be applied
+ *
+ * \retval newDr Computed datarate.
+ */
+uint8_t RegionPRIV868ApplyDrOffset( uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset );
+
+/*!
+ * \brief Sets the radio into beacon reception mode
+ *
+ * \param [IN] rxBeaconSetup Pointer to the function parameters
+ */
+void RegionPRIV868RxBeaconSetup( RxBeaconSetup_t* rxBeaconSetup, uint8_t* outDr );
+
+/*! \} defgroup REGIONPRIV868 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __REGION_PRIV868_H__
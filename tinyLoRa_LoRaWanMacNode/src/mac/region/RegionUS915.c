@@ -46,6 +46,12 @@ static RegionNvmDataGroup1_t* RegionNvmGroup1;
 static RegionNvmDataGroup2_t* RegionNvmGroup2;
 static Band_t* RegionBands;
 
+/*
+ * Channels of the fixed channel plan. They never change, only the channels
+ * mask in the NVM data selects the ones in use.
+ */
+static const ChannelParams_t ChannelsUS915[US915_MAX_NB_CHANNELS] = US915_CHANNELS;
+
 static int8_t LimitTxPower( int8_t txPower, int8_t maxBandTxPower, int8_t datarate, uint16_t* channelsMask )
 {
     int8_t txPowerResult = txPower;
@@ -96,6 +102,12 @@ static TimerTime_t GetTimeOnAir( int8_t datarate, uint16_t pktLen )
     int8_t phyDr = DataratesUS915[datarate];
     uint32_t bandwidth = RegionCommonGetBandwidth( datarate, BandwidthsUS915 );
 
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+    if( RegionCommonValueInRange( datarate, US915_LR_FHSS_MIN_DATARATE, US915_LR_FHSS_MAX_DATARATE ) == true )
+    { // LR-FHSS channel
+        return Radio.TimeOnAir( MODEM_LR_FHSS, US915_LR_FHSS_BANDWIDTH, 0, phyDr, 0, false, pktLen, true );
+    }
+#endif
     return Radio.TimeOnAir( MODEM_LORA, bandwidth, phyDr, 1, 8, false, pktLen, true );
 }
 
@@ -129,7 +141,7 @@ PhyParam_t RegionUS915GetPhyParam( GetPhyParams_t* getPhy )
                 .MinDr = ( int8_t )US915_TX_MIN_DATARATE,
                 .NbChannels = US915_MAX_NB_CHANNELS,
                 .ChannelsMask = RegionNvmGroup2->ChannelsMask,
-                .Channels = RegionNvmGroup2->Channels,
+                .Channels = ChannelsUS915,
             };
             phyParam.Value = RegionCommonGetNextLowerTxDr( &nextLowerTxDrParams );
             break;
@@ -226,7 +238,7 @@ PhyParam_t RegionUS915GetPhyParam( GetPhyParams_t* getPhy )
         }
         case PHY_CHANNELS:
         {
-            phyParam.Channels = RegionNvmGroup2->Channels;
+            phyParam.Channels = ChannelsUS915;
             break;
         }
         case PHY_DEF_UPLINK_DWELL_TIME:
@@ -311,7 +323,7 @@ PhyParam_t RegionUS915GetPhyParam( GetPhyParams_t* getPhy )
 
 void RegionUS915SetBandTxDone( SetBandTxDoneParams_t* txDone )
 {
-    RegionCommonSetBandTxDone( &RegionBands[RegionNvmGroup2->Channels[txDone->Channel].Band],
+    RegionCommonSetBandTxDone( &RegionBands[ChannelsUS915[txDone->Channel].Band],
                                txDone->LastTxAirTime, txDone->Joined, txDone->ElapsedTimeSinceStartUp );
 }
 
@@ -344,22 +356,6 @@ void RegionUS915InitDefaults( InitDefaultsParams_t* params )
             // Default bands
             memcpy1( ( uint8_t* )RegionBands, ( uint8_t* )bands, sizeof( Band_t ) * US915_MAX_NB_BANDS );
 
-            // Default channels
-            for( uint8_t i = 0; i < US915_MAX_NB_CHANNELS - 8; i++ )
-            {
-                // 125 kHz channels
-                RegionNvmGroup2->Channels[i].Frequency = 902300000 + i * 200000;
-                RegionNvmGroup2->Channels[i].DrRange.Value = ( DR_3 << 4 ) | DR_0;
-                RegionNvmGroup2->Channels[i].Band = 0;
-            }
-            for( uint8_t i = US915_MAX_NB_CHANNELS - 8; i < US915_MAX_NB_CHANNELS; i++ )
-            {
-                // 500 kHz channels
-                RegionNvmGroup2->Channels[i].Frequency = 903000000 + ( i - ( US915_MAX_NB_CHANNELS - 8 ) ) * 1600000;
-                RegionNvmGroup2->Channels[i].DrRange.Value = ( DR_4 << 4 ) | DR_4;
-                RegionNvmGroup2->Channels[i].Band = 0;
-            }
-
             // Default ChannelsMask
             RegionNvmGroup2->ChannelsDefaultMask[0] = 0xFFFF;
             RegionNvmGroup2->ChannelsDefaultMask[1] = 0xFFFF;
@@ -544,7 +540,7 @@ bool RegionUS915RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
 bool RegionUS915TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir )
 {
     int8_t phyDr = DataratesUS915[txConfig->Datarate];
-    int8_t txPowerLimited = LimitTxPower( txConfig->TxPower, RegionBands[RegionNvmGroup2->Channels[txConfig->Channel].Band].TxMaxPower, txConfig->Datarate, RegionNvmGroup2->ChannelsMask );
+    int8_t txPowerLimited = LimitTxPower( txConfig->TxPower, RegionBands[ChannelsUS915[txConfig->Channel].Band].TxMaxPower, txConfig->Datarate, RegionNvmGroup2->ChannelsMask );
     uint32_t bandwidth = RegionCommonGetBandwidth( txConfig->Datarate, BandwidthsUS915 );
     int8_t phyTxPower = 0;
 
@@ -552,12 +548,24 @@ bool RegionUS915TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, US915_DEFAULT_MAX_ERP, 0 );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    Radio.SetChannel( ChannelsUS915[txConfig->Channel].Frequency );
 
-    Radio.SetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+    if( RegionCommonValueInRange( txConfig->Datarate, US915_LR_FHSS_MIN_DATARATE, US915_LR_FHSS_MAX_DATARATE ) == true )
+    { // LR-FHSS channel, 25.4 kHz hopping grid
+        Radio.SetTxConfig( MODEM_LR_FHSS, phyTxPower, 0, US915_LR_FHSS_BANDWIDTH, 0, phyDr, 0, false, true, true, 0, false, 8000 );
+
+        // Setup maximum payload lenght of the radio driver
+        Radio.SetMaxPayloadLength( MODEM_LR_FHSS, txConfig->PktLen );
+    }
+    else
+#endif
+    {
+        Radio.SetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
 
-    // Setup maximum payload lenght of the radio driver
-    Radio.SetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
+        // Setup maximum payload lenght of the radio driver
+        Radio.SetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
+    }
 
     // Update time-on-air
     *txTimeOnAir = GetTimeOnAir( txConfig->Datarate, txConfig->PktLen );
@@ -615,57 +623,15 @@ uint8_t RegionUS915LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
         }
         else if( linkAdrParams.ChMaskCtrl == 5 )
         {
-            // Start value for comparision
-            uint8_t bitMask = 1;
+            // 8 MSBs of ChMask are RFU. Bit i enables the bank i of 8 125kHz
+            // channels and the 500kHz channel 64 + i.
+            uint8_t banks = linkAdrParams.ChMask & 0x00FF;
 
-            // cntChannelMask for channelsMask[0] until channelsMask[3]
-            uint8_t cntChannelMask = 0;
-
-            // i will be 1, 2, 3, ..., 7
-            for( uint8_t i = 0; i <= 7; i++ )
+            for( uint8_t i = 0; i < 4; i++, banks >>= 2 )
             {
-                // 8 MSBs of ChMask are RFU
-                // Checking if the ChMask is set, then true
-                if( ( ( linkAdrParams.ChMask & 0x00FF ) & ( bitMask << i ) ) != 0 )
-                {
-                    if( ( i % 2 ) == 0 )
-                    {
-                        // Enable a bank of 8 125kHz channels, 8 LSBs
-                        channelsMask[cntChannelMask] |= 0x00FF;
-                        // Enable the corresponding 500kHz channel
-                        channelsMask[4] |= ( bitMask << i );
-                    }
-                    else
-                    {
-                        // Enable a bank of 8 125kHz channels, 8 MSBs
-                        channelsMask[cntChannelMask] |= 0xFF00;
-                        // Enable the corresponding 500kHz channel
-                        channelsMask[4] |= ( bitMask << i );
-                        // cntChannelMask increment for uneven i
-                        cntChannelMask++;
-                    }
-                }
-                // ChMask is not set
-                else
-                {
-                    if( ( i % 2 ) == 0 )
-                    {
-                        // Disable a bank of 8 125kHz channels, 8 LSBs
-                        channelsMask[cntChannelMask] &= 0xFF00;
-                        // Disable the corresponding 500kHz channel
-                        channelsMask[4] &= ~( bitMask << i );
-                    }
-                    else
-                    {
-                        // Enable a bank of 8 125kHz channels, 8 MSBs
-                        channelsMask[cntChannelMask] &= 0x00FF;
-                        // Disable the corresponding 500kHz channel
-                        channelsMask[4] &= ~( bitMask << i );
-                        // cntChannelMask increment for uneven i
-                        cntChannelMask++;
-                    }
-                }
+                channelsMask[i] = ( 0x00FF * ( banks & 0x01 ) ) | ( 0xFF00 * ( ( banks >> 1 ) & 0x01 ) );
             }
+            channelsMask[4] = ( channelsMask[4] & 0xFF00 ) | ( linkAdrParams.ChMask & 0x00FF );
         }
         else
         {
@@ -696,7 +662,7 @@ uint8_t RegionUS915LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
     linkAdrVerifyParams.ChannelsMask = channelsMask;
     linkAdrVerifyParams.MinDatarate = ( int8_t )phyParam.Value;
     linkAdrVerifyParams.MaxDatarate = US915_TX_MAX_DATARATE;
-    linkAdrVerifyParams.Channels = RegionNvmGroup2->Channels;
+    linkAdrVerifyParams.Channels = ChannelsUS915;
     linkAdrVerifyParams.MinTxPower = US915_MIN_TX_POWER;
     linkAdrVerifyParams.MaxTxPower = US915_MAX_TX_POWER;
     linkAdrVerifyParams.Version = linkAdrReq->Version;
@@ -710,10 +676,7 @@ uint8_t RegionUS915LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
         // Copy Mask
         RegionCommonChanMaskCopy( RegionNvmGroup2->ChannelsMask, channelsMask, 6 );
 
-        RegionNvmGroup1->ChannelsMaskRemaining[0] &= RegionNvmGroup2->ChannelsMask[0];
-        RegionNvmGroup1->ChannelsMaskRemaining[1] &= RegionNvmGroup2->ChannelsMask[1];
-        RegionNvmGroup1->ChannelsMaskRemaining[2] &= RegionNvmGroup2->ChannelsMask[2];
-        RegionNvmGroup1->ChannelsMaskRemaining[3] &= RegionNvmGroup2->ChannelsMask[3];
+        RegionCommonChanMaskAnd( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, 4 );
         RegionNvmGroup1->ChannelsMaskRemaining[4] = RegionNvmGroup2->ChannelsMask[4];
         RegionNvmGroup1->ChannelsMaskRemaining[5] = RegionNvmGroup2->ChannelsMask[5];
     }
@@ -829,7 +792,7 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
     countChannelsParams.ChannelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
-    countChannelsParams.Channels = RegionNvmGroup2->Channels;
+    countChannelsParams.Channels = ChannelsUS915;
     countChannelsParams.Bands = RegionBands;
     countChannelsParams.MaxNbChannels = US915_MAX_NB_CHANNELS;
     countChannelsParams.JoinChannels = NULL;
@@ -875,12 +838,7 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
             else
             {
                 // Choose the next available channel
-                uint8_t i = 0;
-                while( ( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) & ( 1 << i ) ) == 0 )
-                {
-                    i++;
-                }
-                *channel = 64 + i;
+                *channel = 64 + RegionCommonChanMaskFirst( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK );
             }
         }
 
@@ -890,6 +848,33 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
     return status;
 }
 
+TimerTime_t RegionUS915GetNextTxDelay( NextChanParams_t* nextChanParams )
+{
+    RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
+    RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
+
+    countChannelsParams.Joined = nextChanParams->Joined;
+    countChannelsParams.Datarate = nextChanParams->Datarate;
+    countChannelsParams.ChannelsMask = RegionNvmGroup2->ChannelsMask;
+    countChannelsParams.Channels = ChannelsUS915;
+    countChannelsParams.Bands = RegionBands;
+    countChannelsParams.MaxNbChannels = US915_MAX_NB_CHANNELS;
+    countChannelsParams.JoinChannels = NULL;
+
+    identifyChannelsParam.AggrTimeOff = nextChanParams->AggrTimeOff;
+    identifyChannelsParam.LastAggrTx = nextChanParams->LastAggrTx;
+    identifyChannelsParam.DutyCycleEnabled = nextChanParams->DutyCycleEnabled;
+    identifyChannelsParam.MaxBands = US915_MAX_NB_BANDS;
+
+    identifyChannelsParam.ElapsedTimeSinceStartUp = nextChanParams->ElapsedTimeSinceStartUp;
+    identifyChannelsParam.LastTxIsJoinRequest = nextChanParams->LastTxIsJoinRequest;
+    identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
+
+    identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+
+    return RegionCommonGetNextTxDelay( &identifyChannelsParam );
+}
+
 LoRaMacStatus_t RegionUS915ChannelAdd( ChannelAddParams_t* channelAdd )
 {
     return LORAMAC_STATUS_PARAMETER_INVALID;
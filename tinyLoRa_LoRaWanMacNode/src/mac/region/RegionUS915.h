@@ -56,8 +56,15 @@ extern "C"
 
 /*!
  * Maximal datarate that can be used by the node
+ *
+ * \remark The LR-FHSS datarates DR_5 and DR_6 are only enabled with
+ *         LORAMAC_LR_FHSS_ENABLED, see radio/sx126x/bench/lr-fhss-bench.c
  */
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+#define US915_TX_MAX_DATARATE                       DR_6
+#else
 #define US915_TX_MAX_DATARATE                       DR_4
+#endif
 
 /*!
  * Minimal datarate that can be used by the node
@@ -189,7 +196,7 @@ extern "C"
 
 /*!
  * Band 0 definition
- * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission }
+ * Band = { DutyCycle, TxMaxPower, LastBandUpdateTime, LastMaxCreditAssignTime, TimeCredits, MaxTimeCredits, ReadyForTransmission, ReadyTime }
  */
 #define US915_BAND0                                 { 1, US915_MAX_TX_POWER, 0, 0, 0, 0, 0 } //  100.0 %
 
@@ -208,6 +215,33 @@ extern "C"
  */
 #define US915_STEPWIDTH_RX1_CHANNEL                 ( (uint32_t) 600000 )
 
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+/*!
+ * Data rates table definition
+ */
+static const uint8_t DataratesUS915[]  = { 10, 9, 8,  7,  8,  3,  1, 0, 12, 11, 10, 9, 8, 7, 0, 0 };
+
+/*!
+ * Bandwidths table definition in Hz
+ */
+static const uint32_t BandwidthsUS915[] = { 125000, 125000, 125000, 125000, 500000, 1523000, 1523000, 0, 500000, 500000, 500000, 500000, 500000, 500000, 0, 0 };
+
+/*!
+ * First LR-FHSS datarate. The datarates table holds the LR-FHSS coding rate
+ * [1: 2/3, 3: 1/3] of these datarates.
+ */
+#define US915_LR_FHSS_MIN_DATARATE                  DR_5
+
+/*!
+ * Last LR-FHSS datarate
+ */
+#define US915_LR_FHSS_MAX_DATARATE                  DR_6
+
+/*!
+ * LR-FHSS operating channel width [8: 1523.4 kHz]
+ */
+#define US915_LR_FHSS_BANDWIDTH                     8
+#else
 /*!
  * Data rates table definition
  */
@@ -217,23 +251,61 @@ static const uint8_t DataratesUS915[]  = { 10, 9, 8,  7,  8,  0,  0, 0, 12, 11,
  * Bandwidths table definition in Hz
  */
 static const uint32_t BandwidthsUS915[] = { 125000, 125000, 125000, 125000, 500000, 0, 0, 0, 500000, 500000, 500000, 500000, 500000, 500000, 0, 0 };
+#endif
+
+/*!
+ * Maximal datarate of the 500 kHz upstream channels
+ */
+#define US915_500KHZ_MAX_DATARATE                   US915_TX_MAX_DATARATE
+
+/*!
+ * 125 kHz upstream channel i of the channel plan, i = 0 to 63
+ */
+#define US915_125KHZ_CHANNEL( i )                   { 902300000 + ( i ) * 200000, 0, { ( ( DR_3 << 4 ) | DR_0 ) }, 0 }
+
+/*!
+ * 500 kHz upstream channel i of the channel plan, i = 0 to 7
+ */
+#define US915_500KHZ_CHANNEL( i )                   { 903000000 + ( i ) * 1600000, 0, { ( ( US915_500KHZ_MAX_DATARATE << 4 ) | DR_4 ) }, 0 }
+
+/*!
+ * Channels of the fixed channel plan, selected by the channels mask only
+ */
+#define US915_CHANNELS                              \
+{                                                   \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 0 ),  \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 8 ),  \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 16 ), \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 24 ), \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 32 ), \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 40 ), \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 48 ), \
+    REGION_COMMON_CHANNELS_8( US915_125KHZ_CHANNEL, 56 ), \
+    REGION_COMMON_CHANNELS_8( US915_500KHZ_CHANNEL, 0 ),  \
+}
 
 /*!
  * Up/Down link data rates offset definition
  */
-static const int8_t DatarateOffsetsUS915[5][4] =
+static const int8_t DatarateOffsetsUS915[7][4] =
 {
     { DR_10, DR_9 , DR_8 , DR_8  }, // DR_0
     { DR_11, DR_10, DR_9 , DR_8  }, // DR_1
     { DR_12, DR_11, DR_10, DR_9  }, // DR_2
     { DR_13, DR_12, DR_11, DR_10 }, // DR_3
     { DR_13, DR_13, DR_12, DR_11 }, // DR_4
+    { DR_10, DR_9 , DR_8 , DR_8  }, // DR_5
+    { DR_11, DR_10, DR_9 , DR_8  }, // DR_6
 };
 
 /*!
  * Maximum payload with respect to the datarate index.
  */
+#if defined( LORAMAC_LR_FHSS_ENABLED )
+static const uint8_t MaxPayloadOfDatarateUS915[] = { 11, 53, 125, 242, 242, 58, 133, 0, 53, 129, 242, 242, 242, 242, 0, 0 };
+#else
 static const uint8_t MaxPayloadOfDatarateUS915[] = { 11, 53, 125, 242, 242, 0, 0, 0, 53, 129, 242, 242, 242, 242, 0, 0 };
+#endif
 
 /*!
  * \brief The function gets a value of a specific phy attribute.
@@ -397,6 +469,15 @@ int8_t RegionUS915AlternateDr( int8_t currentDr, AlternateDrType_t type );
  */
 LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
 
+/*!
+ * \brief Computes the time until the next uplink is allowed by the duty cycle
+ *
+ * \param [IN] nextChanParams Parameters of the next uplink.
+ *
+ * \retval Time to wait [ms, 0: now, TIMERTIME_T_MAX: unknown or no channel].
+ */
+TimerTime_t RegionUS915GetNextTxDelay( NextChanParams_t* nextChanParams );
+
 /*!
  * \brief Adds a channel.
  *
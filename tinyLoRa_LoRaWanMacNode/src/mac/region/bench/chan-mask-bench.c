@@ -0,0 +1,474 @@
+/*!
+ * \file      chan-mask-bench.c
+ *
+ * \brief     Host benchmark and equivalence check of the channel mask helpers
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs the word wide channel mask helpers of RegionCommon.c and
+ *            RegionBaseUS.c against the bit by bit implementations they
+ *            replace, kept below, on random masks and channel plans. Then
+ *            times the channel count of a US915 / AU915 sized plan ( 72
+ *            channels ) and of a CN470 sized plan ( 96 channels ), with every
+ *            channel enabled and with a single sub-band enabled.
+ *
+ *            A helper differing from its bit by bit version fails the
+ *            chan-mask-bench test of the host board. From the src directory:
+ *
+ *            gcc -O2 -Imac -Imac/region -Isystem -Iradio -Iboards -Iperipherals \
+ *                mac/region/bench/chan-mask-bench.c mac/region/RegionCommon.c \
+ *                mac/region/RegionBaseUS.c boards/mcu/utilities.c -o chan-mask-bench
+ *            ./chan-mask-bench
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "utilities.h"
+#include "radio.h"
+#include "sx-timer.h"
+#include "sx-systime.h"
+#include "RegionCommon.h"
+#include "RegionBaseUS.h"
+
+/*!
+ * Number of random cases of the equivalence check
+ */
+#define BENCH_CASES                                 100000
+
+/*!
+ * Number of timed calls per measurement
+ */
+#define BENCH_ITERATIONS                            1000000
+
+/*!
+ * Largest channel plan, CN470
+ */
+#define BENCH_MAX_NB_CHANNELS                       96
+#define BENCH_MASK_SIZE                             ( BENCH_MAX_NB_CHANNELS / 16 )
+#define BENCH_NB_BANDS                              4
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return 1;
+}
+
+TimerTime_t TimerGetElapsedTime( TimerTime_t past )
+{
+    return 0;
+}
+
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
+{
+    return a;
+}
+
+SysTime_t SysTimeFromMs( uint32_t timeMs )
+{
+    SysTime_t t = { 0 };
+
+    return t;
+}
+
+uint32_t SysTimeToMs( SysTime_t t )
+{
+    return 0;
+}
+
+const struct Radio_s Radio = { 0 };
+
+static uint32_t BenchRandomState = 0x12345678;
+
+/*!
+ * Test data generator, independent of randr which the join channel selection
+ * consumes
+ */
+static uint32_t BenchRandom( void )
+{
+    BenchRandomState ^= BenchRandomState << 13;
+    BenchRandomState ^= BenchRandomState >> 17;
+    BenchRandomState ^= BenchRandomState << 5;
+    return BenchRandomState;
+}
+
+/*!
+ * Random mask word, sparse, dense or uniform
+ */
+static uint16_t BenchRandomMask( void )
+{
+    switch( BenchRandom( ) % 4 )
+    {
+        case 0:
+            return BenchRandom( ) & BenchRandom( ) & BenchRandom( );
+        case 1:
+            return BenchRandom( ) | BenchRandom( );
+        case 2:
+            return ( BenchRandom( ) % 2 ) ? 0xFFFF : 0x0000;
+        default:
+            return BenchRandom( );
+    }
+}
+
+static double BenchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*
+ * Bit by bit implementations replaced by the channel mask helpers
+ */
+
+static uint8_t RefCountChannels( uint16_t* channelsMask, uint8_t startIdx, uint8_t stopIdx )
+{
+    uint8_t nbChannels = 0;
+
+    for( uint8_t i = startIdx; i < stopIdx; i++ )
+    {
+        for( uint8_t j = 0; j < 16; j++ )
+        {
+            if( ( channelsMask[i] & ( 1 << j ) ) == ( 1 << j ) )
+            {
+                nbChannels++;
+            }
+        }
+    }
+    return nbChannels;
+}
+
+static bool RefChanVerifyDr( uint8_t nbChannels, uint16_t* channelsMask, int8_t dr, int8_t minDr, int8_t maxDr, ChannelParams_t* channels )
+{
+    if( RegionCommonValueInRange( dr, minDr, maxDr ) == 0 )
+    {
+        return false;
+    }
+
+    for( uint8_t i = 0, k = 0; i < nbChannels; i += 16, k++ )
+    {
+        for( uint8_t j = 0; j < 16; j++ )
+        {
+            if( ( ( channelsMask[k] & ( 1 << j ) ) != 0 ) )
+            {
+                if( RegionCommonValueInRange( dr, ( channels[i + j].DrRange.Fields.Min & 0x0F ),
+                                                  ( channels[i + j].DrRange.Fields.Max & 0x0F ) ) == 1 )
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+static void RefCountNbOfEnabledChannels( RegionCommonCountNbOfEnabledChannelsParams_t* params,
+                                         uint8_t* enabledChannels, uint8_t* nbEnabledChannels, uint8_t* nbRestrictedChannels )
+{
+    uint8_t nbChannelCount = 0;
+    uint8_t nbRestrictedChannelsCount = 0;
+
+    for( uint8_t i = 0, k = 0; i < params->MaxNbChannels; i += 16, k++ )
+    {
+        for( uint8_t j = 0; j < 16; j++ )
+        {
+            if( ( params->ChannelsMask[k] & ( 1 << j ) ) != 0 )
+            {
+                if( params->Channels[i + j].Frequency == 0 )
+                {
+                    continue;
+                }
+                if( ( params->Joined == false ) && ( params->JoinChannels != NULL ) )
+                {
+                    if( ( params->JoinChannels[k] & ( 1 << j ) ) == 0 )
+                    {
+                        continue;
+                    }
+                }
+                if( RegionCommonValueInRange( params->Datarate, params->Channels[i + j].DrRange.Fields.Min,
+                                              params->Channels[i + j].DrRange.Fields.Max ) == false )
+                {
+                    continue;
+                }
+                if( params->Bands[params->Channels[i + j].Band].ReadyForTransmission == false )
+                {
+                    nbRestrictedChannelsCount++;
+                    continue;
+                }
+                enabledChannels[nbChannelCount++] = i + j;
+            }
+        }
+    }
+    *nbEnabledChannels = nbChannelCount;
+    *nbRestrictedChannels = nbRestrictedChannelsCount;
+}
+
+static LoRaMacStatus_t RefComputeNext125kHzJoinChannel( uint16_t* channelsMaskRemaining,
+                                                        uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex )
+{
+    uint16_t currentChannelMaskLeft;
+    uint8_t findAvailableChannelsIndex[8] = { 0 };
+    uint8_t availableChannels = 0;
+    uint8_t startIndex = *groupsCurrentIndex;
+
+    do
+    {
+        if( ( startIndex % 2 ) == 0 )
+        {
+            currentChannelMaskLeft = ( channelsMaskRemaining[startIndex / 2] & 0x00FF );
+        }
+        else
+        {
+            currentChannelMaskLeft = ( ( channelsMaskRemaining[startIndex / 2] >> 8 ) & 0x00FF );
+        }
+
+        availableChannels = 0;
+        for( uint8_t i = 0; i < 8; i++ )
+        {
+            if( ( currentChannelMaskLeft & ( 1 << i ) ) != 0 )
+            {
+                findAvailableChannelsIndex[availableChannels++] = i;
+            }
+        }
+
+        if( availableChannels > 0 )
+        {
+            *newChannelIndex = ( startIndex * 8 ) + findAvailableChannelsIndex[randr( 0, ( availableChannels - 1 ) )];
+        }
+
+        startIndex++;
+        if( startIndex > 7 )
+        {
+            startIndex = 0;
+        }
+    } while( ( availableChannels == 0 ) && ( startIndex != *groupsCurrentIndex ) );
+
+    if( availableChannels > 0 )
+    {
+        *groupsCurrentIndex = startIndex;
+        return LORAMAC_STATUS_OK;
+    }
+    return LORAMAC_STATUS_PARAMETER_INVALID;
+}
+
+/*!
+ * Random channel plan of BENCH_MAX_NB_CHANNELS channels
+ */
+static void BenchRandomPlan( ChannelParams_t* channels, Band_t* bands )
+{
+    for( uint8_t i = 0; i < BENCH_MAX_NB_CHANNELS; i++ )
+    {
+        uint8_t min = BenchRandom( ) % 8;
+
+        channels[i].Frequency = ( ( BenchRandom( ) % 8 ) == 0 ) ? 0 : 902300000 + i * 200000;
+        channels[i].DrRange.Fields.Min = min;
+        channels[i].DrRange.Fields.Max = min + BenchRandom( ) % ( 8 - min );
+        channels[i].Band = BenchRandom( ) % BENCH_NB_BANDS;
+    }
+    for( uint8_t i = 0; i < BENCH_NB_BANDS; i++ )
+    {
+        bands[i].ReadyForTransmission = ( ( BenchRandom( ) % 4 ) != 0 );
+    }
+}
+
+static uint32_t BenchCheck( void )
+{
+    ChannelParams_t channels[BENCH_MAX_NB_CHANNELS];
+    Band_t bands[BENCH_NB_BANDS];
+    uint16_t mask[BENCH_MASK_SIZE];
+    uint16_t joinMask[BENCH_MASK_SIZE];
+    uint32_t nbErrors = 0;
+
+    for( uint32_t n = 0; n < BENCH_CASES; n++ )
+    {
+        RegionCommonCountNbOfEnabledChannelsParams_t params;
+        uint8_t enabled[BENCH_MAX_NB_CHANNELS];
+        uint8_t refEnabled[BENCH_MAX_NB_CHANNELS];
+        uint8_t nbEnabled, nbRestricted, refNbEnabled, refNbRestricted;
+        uint8_t nbChannels = ( ( BenchRandom( ) % 2 ) == 0 ) ? 72 : 96;
+        uint8_t len = nbChannels / 16;
+        int8_t dr = BenchRandom( ) % 8;
+        uint8_t channel;
+
+        BenchRandomPlan( channels, bands );
+        for( uint8_t k = 0; k < BENCH_MASK_SIZE; k++ )
+        {
+            mask[k] = BenchRandomMask( );
+            joinMask[k] = BenchRandomMask( );
+        }
+        // The 72 channel plans stop at channel 71
+        if( nbChannels == 72 )
+        {
+            mask[4] &= 0x00FF;
+            joinMask[4] &= 0x00FF;
+            mask[5] = 0;
+        }
+
+        // Popcount, first and n-th channel
+        for( uint8_t k = 0; k < BENCH_MASK_SIZE; k++ )
+        {
+            if( RegionCommonCountChannels( mask, k, BENCH_MASK_SIZE ) != RefCountChannels( mask, k, BENCH_MASK_SIZE ) )
+            {
+                nbErrors++;
+            }
+            if( ( mask[k] != 0 ) && ( ( mask[k] & ( 1 << RegionCommonChanMaskFirst( mask[k] ) ) ) == 0 ) )
+            {
+                nbErrors++;
+            }
+            if( ( mask[k] != 0 ) && ( ( mask[k] & ( ( 1 << RegionCommonChanMaskFirst( mask[k] ) ) - 1 ) ) != 0 ) )
+            {
+                nbErrors++;
+            }
+        }
+        if( RegionCommonChanMaskFirst( 0 ) != 16 )
+        {
+            nbErrors++;
+        }
+
+        // Enabled channels, joined and not joined with a join channels mask
+        params.Joined = ( BenchRandom( ) % 2 ) == 0;
+        params.Datarate = dr;
+        params.ChannelsMask = mask;
+        params.Channels = channels;
+        params.Bands = bands;
+        params.MaxNbChannels = nbChannels;
+        params.JoinChannels = ( ( BenchRandom( ) % 2 ) == 0 ) ? joinMask : NULL;
+        RegionCommonCountNbOfEnabledChannels( &params, enabled, &nbEnabled, &nbRestricted );
+        RefCountNbOfEnabledChannels( &params, refEnabled, &refNbEnabled, &refNbRestricted );
+        if( ( nbEnabled != refNbEnabled ) || ( nbRestricted != refNbRestricted ) ||
+            ( memcmp( enabled, refEnabled, nbEnabled ) != 0 ) )
+        {
+            nbErrors++;
+        }
+
+        // Random choice, the n-th channel of the mask is the n-th of the list
+        for( uint8_t i = 0; i < RefCountChannels( mask, 0, len ); i++ )
+        {
+            uint8_t list[BENCH_MAX_NB_CHANNELS];
+            uint8_t nbList = 0;
+
+            for( uint8_t c = 0; c < nbChannels; c++ )
+            {
+                if( ( mask[c / 16] & ( 1 << ( c % 16 ) ) ) != 0 )
+                {
+                    list[nbList++] = c;
+                }
+            }
+            if( ( RegionCommonChanMaskSelect( mask, len, i, &channel ) == false ) || ( channel != list[i] ) )
+            {
+                nbErrors++;
+            }
+        }
+        if( RegionCommonChanMaskSelect( mask, len, RefCountChannels( mask, 0, len ), &channel ) == true )
+        {
+            nbErrors++;
+        }
+
+        if( RegionCommonChanVerifyDr( nbChannels, mask, dr, 0, 7, channels ) !=
+            RefChanVerifyDr( nbChannels, mask, dr, 0, 7, channels ) )
+        {
+            nbErrors++;
+        }
+
+        // US915 / AU915 join channel selection, same random sequence
+        {
+            uint8_t groupIndex = BenchRandom( ) % 8;
+            uint8_t refGroupIndex = groupIndex;
+            uint8_t newChannel = 0xFF;
+            uint8_t refNewChannel = 0xFF;
+            uint32_t seed = BenchRandom( );
+            LoRaMacStatus_t status;
+            LoRaMacStatus_t refStatus;
+
+            srand1( seed );
+            status = RegionBaseUSComputeNext125kHzJoinChannel( mask, &groupIndex, &newChannel );
+            srand1( seed );
+            refStatus = RefComputeNext125kHzJoinChannel( mask, &refGroupIndex, &refNewChannel );
+            if( ( status != refStatus ) || ( groupIndex != refGroupIndex ) || ( newChannel != refNewChannel ) )
+            {
+                nbErrors++;
+            }
+        }
+    }
+    return nbErrors;
+}
+
+static void BenchTime( const char* name, uint8_t nbChannels, uint16_t* mask )
+{
+    ChannelParams_t channels[BENCH_MAX_NB_CHANNELS];
+    Band_t bands[BENCH_NB_BANDS] = { { .ReadyForTransmission = true } };
+    RegionCommonCountNbOfEnabledChannelsParams_t params;
+    uint8_t enabled[BENCH_MAX_NB_CHANNELS];
+    uint8_t nbEnabled, nbRestricted;
+    volatile uint32_t sink = 0;
+    double countNs, refCountNs, enabledNs, refEnabledNs;
+    double t0;
+
+    for( uint8_t i = 0; i < BENCH_MAX_NB_CHANNELS; i++ )
+    {
+        channels[i].Frequency = 902300000 + i * 200000;
+        channels[i].DrRange.Value = ( DR_3 << 4 ) | DR_0;
+        channels[i].Band = 0;
+    }
+    params.Joined = true;
+    params.Datarate = DR_0;
+    params.ChannelsMask = mask;
+    params.Channels = channels;
+    params.Bands = bands;
+    params.MaxNbChannels = nbChannels;
+    params.JoinChannels = NULL;
+
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+    {
+        sink += RefCountChannels( mask, 0, nbChannels / 16 );
+        __asm__ volatile( "" ::: "memory" );
+    }
+    refCountNs = ( BenchNow( ) - t0 ) / BENCH_ITERATIONS;
+
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+    {
+        sink += RegionCommonCountChannels( mask, 0, nbChannels / 16 );
+        __asm__ volatile( "" ::: "memory" );
+    }
+    countNs = ( BenchNow( ) - t0 ) / BENCH_ITERATIONS;
+
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+    {
+        RefCountNbOfEnabledChannels( &params, enabled, &nbEnabled, &nbRestricted );
+        sink += nbEnabled;
+        __asm__ volatile( "" ::: "memory" );
+    }
+    refEnabledNs = ( BenchNow( ) - t0 ) / BENCH_ITERATIONS;
+
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+    {
+        RegionCommonCountNbOfEnabledChannels( &params, enabled, &nbEnabled, &nbRestricted );
+        sink += nbEnabled;
+        __asm__ volatile( "" ::: "memory" );
+    }
+    enabledNs = ( BenchNow( ) - t0 ) / BENCH_ITERATIONS;
+
+    printf( "%-22s %2u/%2u channels  count %6.1f -> %5.1f ns  enabled channels %6.1f -> %5.1f ns\n",
+            name, RegionCommonCountChannels( mask, 0, nbChannels / 16 ), nbChannels,
+            refCountNs, countNs, refEnabledNs, enabledNs );
+}
+
+int main( void )
+{
+    uint16_t us915All[BENCH_MASK_SIZE] = { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x00FF, 0x0000 };
+    // Sub-band 2, channels 8 to 15 and 65
+    uint16_t us915SubBand[BENCH_MASK_SIZE] = { 0xFF00, 0x0000, 0x0000, 0x0000, 0x0002, 0x0000 };
+    uint16_t cn470All[BENCH_MASK_SIZE] = { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF };
+    uint16_t cn470SubBand[BENCH_MASK_SIZE] = { 0x0000, 0x0000, 0x0000, 0x0000, 0x00FF, 0x0000 };
+    uint32_t nbErrors = BenchCheck( );
+
+    printf( "equivalence: %u random cases, %u errors\n", BENCH_CASES, ( unsigned )nbErrors );
+    BenchTime( "US915 all channels", 72, us915All );
+    BenchTime( "US915 sub-band 2", 72, us915SubBand );
+    BenchTime( "CN470 all channels", 96, cn470All );
+    BenchTime( "CN470 one group of 8", 96, cn470SubBand );
+    return ( nbErrors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+/*!
+ * \file      priv868-toa-bench.c
+ *
+ * \brief     Host time on air and throughput table of the PRIV868 datarates
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Checks the PRIV868 channel plan and prints, per datarate, the
+ *            time on air and the throughput next to those of EU868.
+ *
+ *            - Every datarate allowed on a channel of the default plan, and on
+ *              5 channels added by a CFList, must keep the signal inside the
+ *              sub-band of the channel frequency.
+ *            - The PHY bit rate must increase with the datarate index, as the
+ *              ADR and the datarate back-off expect.
+ *            - RegionPRIV868GetTimeOnAir must pass the radio the modulation
+ *              giving the SX126x datasheet time on air, evaluated here in
+ *              floating point with the 12 symbols SF5/SF6 preamble, for every
+ *              frame size up to the maximum payload.
+ *
+ *            The throughput is the application payload rate during the
+ *            transmission. The hourly figure is the application payload sent
+ *            in one hour at the 1 % duty cycle of the 868.0 - 868.6 MHz band.
+ *
+ *            A frequency, datarate order or time on air error fails the
+ *            priv868-toa-bench test of the host board. From the src directory:
+ *
+ *            gcc -O2 -DREGION_PRIV868 -Imac -Imac/region -Isystem -Iradio \
+ *                -Iboards -Iperipherals mac/region/bench/priv868-toa-bench.c \
+ *                mac/region/RegionCommon.c mac/region/RegionPRIV868.c \
+ *                boards/mcu/utilities.c -lm -o priv868-toa-bench
+ *            ./priv868-toa-bench
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "radio.h"
+#include "sx-timer.h"
+#include "sx-systime.h"
+#include "RegionCommon.h"
+#include "RegionPRIV868.h"
+
+/*!
+ * LoRaWAN frame overhead: MHDR, FHDR without FOpts, FPort and MIC
+ */
+#define BENCH_FRAME_OVERHEAD                        13
+
+/*!
+ * Application payload of the middle column
+ */
+#define BENCH_PAYLOAD_SIZE                          51
+
+/*!
+ * Transmission time per hour allowed by a 1 % duty cycle [ms]
+ */
+#define BENCH_DUTY_CYCLE_TIME                       36000
+
+/*!
+ * Sub-band edges [Hz], they follow the band selection of the region
+ */
+typedef struct sBenchSubBand
+{
+    uint32_t Low;
+    uint32_t High;
+}BenchSubBand_t;
+
+static const BenchSubBand_t BenchSubBands[] =
+{
+    { 863000000, 865000000 },
+    { 865000000, 868000000 },
+    { 868000000, 868600000 },
+    { 868700000, 869200000 },
+    { 869400000, 869650000 },
+    { 869700000, 870000000 },
+};
+
+/*!
+ * EU868 LoRa datarates, for comparison
+ */
+static const uint8_t BenchEU868Sf[] = { 12, 11, 10, 9, 8, 7, 7 };
+static const uint32_t BenchEU868Bw[] = { 125000, 125000, 125000, 125000, 125000, 125000, 250000 };
+
+static RegionNvmDataGroup1_t NvmGroup1;
+static RegionNvmDataGroup2_t NvmGroup2;
+static Band_t Bands[REGION_NVM_MAX_NB_BANDS];
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return 1;
+}
+
+TimerTime_t TimerGetElapsedTime( TimerTime_t past )
+{
+    return 0;
+}
+
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
+{
+    return a;
+}
+
+SysTime_t SysTimeFromMs( uint32_t timeMs )
+{
+    SysTime_t t = { .Seconds = timeMs / 1000, .SubSeconds = timeMs % 1000 };
+
+    return t;
+}
+
+uint32_t SysTimeToMs( SysTime_t t )
+{
+    return t.Seconds * 1000 + t.SubSeconds;
+}
+
+/*!
+ * \brief LoRa time on air of the SX126x datasheet, section 6.1.4 [ms]
+ */
+static double BenchLoRaTimeOnAir( uint8_t sf, uint32_t bandwidth, uint8_t coderate, uint16_t preambleLen,
+                                  bool fixLen, uint16_t payloadLen, bool crcOn )
+{
+    double symbol = ( double )( 1 << sf ) / bandwidth;
+    bool lowDatarateOptimize = ( symbol * 1000 ) >= 16.0;
+    double nbBits = 8.0 * payloadLen + ( crcOn ? 16 : 0 ) - 4 * sf + ( fixLen ? 0 : 20 );
+    double nbSymbols = 0;
+
+    if( sf <= 6 )
+    {
+        preambleLen = ( preambleLen < 12 ) ? 12 : preambleLen;
+        nbSymbols = preambleLen + 6.25 + 8 + ceil( fmax( nbBits, 0 ) / ( 4 * sf ) ) * ( coderate + 4 );
+    }
+    else
+    {
+        nbSymbols = preambleLen + 4.25 + 8 + ceil( fmax( nbBits + 8, 0 ) / ( 4 * ( sf - ( lowDatarateOptimize ? 2 : 0 ) ) ) ) * ( coderate + 4 );
+    }
+    return nbSymbols * symbol * 1000;
+}
+
+static uint32_t BenchTimeOnAir( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                                uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    static const uint32_t bandwidths[] = { 125000, 250000, 500000 };
+
+    return ( uint32_t )ceil( BenchLoRaTimeOnAir( datarate, bandwidths[( bandwidth < 3 ) ? bandwidth : 0], coderate,
+                                                 preambleLen, fixLen, payloadLen, crcOn ) );
+}
+
+static bool BenchCheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+const struct Radio_s Radio = { .TimeOnAir = BenchTimeOnAir, .CheckRfFrequency = BenchCheckRfFrequency };
+
+/*!
+ * \brief Application payload rate during the transmission [kbit/s]
+ */
+static double BenchThroughput( uint16_t payloadSize, double timeOnAir )
+{
+    return ( 8.0 * payloadSize ) / timeOnAir;
+}
+
+/*!
+ * \brief Checks that every allowed datarate of every enabled channel fits
+ *        the sub-band of the channel.
+ *
+ * \retval Number of errors.
+ */
+static uint32_t BenchCheckChannels( void )
+{
+    GetPhyParams_t getPhy = { .Attribute = PHY_CHANNELS };
+    const ChannelParams_t* channels = RegionPRIV868GetPhyParam( &getPhy ).Channels;
+    uint32_t errors = 0;
+
+    for( uint8_t i = 0; i < PRIV868_MAX_NB_CHANNELS; i++ )
+    {
+        const BenchSubBand_t* subBand = NULL;
+        uint32_t frequency = channels[i].Frequency;
+
+        if( ( frequency == 0 ) || ( ( NvmGroup2.ChannelsMask[0] & ( 1 << i ) ) == 0 ) )
+        {
+            continue;
+        }
+        for( uint8_t j = 0; j < sizeof( BenchSubBands ) / sizeof( BenchSubBands[0] ); j++ )
+        {
+            if( ( frequency > BenchSubBands[j].Low ) && ( frequency < BenchSubBands[j].High ) )
+            {
+                subBand = &BenchSubBands[j];
+            }
+        }
+        printf( "channel %u %9lu Hz DR%u..DR%u\n", i, ( unsigned long )frequency,
+                channels[i].DrRange.Fields.Min, channels[i].DrRange.Fields.Max );
+        for( int8_t dr = channels[i].DrRange.Fields.Min; dr <= channels[i].DrRange.Fields.Max; dr++ )
+        {
+            uint32_t halfBandwidth = BandwidthsPRIV868[dr] / 2;
+
+            if( ( subBand == NULL ) || ( ( frequency - halfBandwidth ) < subBand->Low ) ||
+                ( ( frequency + halfBandwidth ) > subBand->High ) )
+            {
+                printf( "  DR%d %3lu kHz leaves the sub-band\n", dr, ( unsigned long )( BandwidthsPRIV868[dr] / 1000 ) );
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+/*!
+ * \brief Checks the datarate order and the region time on air.
+ *
+ * \retval Number of errors.
+ */
+static uint32_t BenchCheckDatarates( void )
+{
+    uint32_t errors = 0;
+    double lastBitRate = 0;
+
+    for( int8_t dr = PRIV868_TX_MIN_DATARATE; dr <= PRIV868_TX_MAX_DATARATE; dr++ )
+    {
+        uint8_t sf = DataratesPRIV868[dr];
+        double bitRate = ( sf * ( 4.0 / 5.0 ) * BandwidthsPRIV868[dr] ) / ( 1 << sf );
+
+        if( bitRate <= lastBitRate )
+        {
+            printf( "DR%d bit rate %.0f bit/s is not above DR%d\n", dr, bitRate, dr - 1 );
+            errors++;
+        }
+        lastBitRate = bitRate;
+
+        for( uint16_t size = 0; size <= MaxPayloadOfDataratePRIV868[dr]; size++ )
+        {
+            uint16_t pktLen = BENCH_FRAME_OVERHEAD + size;
+            double reference = BenchLoRaTimeOnAir( sf, BandwidthsPRIV868[dr], 1, 8, false, pktLen, true );
+
+            if( RegionPRIV868GetTimeOnAir( dr, pktLen ) != ( TimerTime_t )ceil( reference ) )
+            {
+                printf( "DR%d %u bytes time on air %lu ms, expected %.3f ms\n", dr, pktLen,
+                        ( unsigned long )RegionPRIV868GetTimeOnAir( dr, pktLen ), reference );
+                errors++;
+                break;
+            }
+        }
+    }
+    return errors;
+}
+
+static void BenchPrintRow( const char* region, int8_t dr, uint8_t sf, uint32_t bandwidth, uint8_t maxPayload )
+{
+    double emptyToA = BenchLoRaTimeOnAir( sf, bandwidth, 1, 8, false, BENCH_FRAME_OVERHEAD, true );
+    double payloadToA = BenchLoRaTimeOnAir( sf, bandwidth, 1, 8, false, BENCH_FRAME_OVERHEAD + BENCH_PAYLOAD_SIZE, true );
+    double maxToA = BenchLoRaTimeOnAir( sf, bandwidth, 1, 8, false, BENCH_FRAME_OVERHEAD + maxPayload, true );
+    double hourly = floor( BENCH_DUTY_CYCLE_TIME / maxToA ) * maxPayload / 1000.0;
+
+    printf( "%-7s DR%-2d SF%-2u %3lu kHz %8.1f %8.1f %8.1f %3u %6.2f %6.2f %7.1f\n", region, dr, sf,
+            ( unsigned long )( bandwidth / 1000 ), emptyToA, payloadToA, maxToA, maxPayload,
+            BenchThroughput( BENCH_PAYLOAD_SIZE, payloadToA ), BenchThroughput( maxPayload, maxToA ), hourly );
+}
+
+int main( void )
+{
+    // 867.1 to 867.9 MHz
+    uint8_t cfList[16] = { 0x18, 0x4F, 0x84, 0xE8, 0x56, 0x84, 0xB8, 0x5E, 0x84, 0x88, 0x66, 0x84, 0x58, 0x6E, 0x84, 0x00 };
+    ApplyCFListParams_t applyCFList = { .JoinChannel = 0, .Payload = cfList, .Size = sizeof( cfList ) };
+    InitDefaultsParams_t params = { .NvmGroup1 = &NvmGroup1, .NvmGroup2 = &NvmGroup2, .Bands = Bands, .Type = INIT_TYPE_DEFAULTS };
+    uint32_t errors = 0;
+
+    RegionPRIV868InitDefaults( &params );
+    RegionPRIV868ApplyCFList( &applyCFList );
+
+    errors += BenchCheckChannels( );
+    errors += BenchCheckDatarates( );
+
+    printf( "\n                          time on air [ms]        max   kbit/s        kB/h\n" );
+    printf( "                        %3u B    %3u B      max   B    %3u B    max  at 1 %%\n",
+            0, BENCH_PAYLOAD_SIZE, BENCH_PAYLOAD_SIZE );
+    for( int8_t dr = 0; dr < ( int8_t )sizeof( BenchEU868Sf ); dr++ )
+    {
+        BenchPrintRow( "EU868", dr, BenchEU868Sf[dr], BenchEU868Bw[dr], ( dr < 3 ) ? 51 : ( ( dr == 3 ) ? 115 : 242 ) );
+    }
+    for( int8_t dr = PRIV868_TX_MIN_DATARATE; dr <= PRIV868_TX_MAX_DATARATE; dr++ )
+    {
+        BenchPrintRow( "PRIV868", dr, DataratesPRIV868[dr], BandwidthsPRIV868[dr], MaxPayloadOfDataratePRIV868[dr] );
+    }
+    printf( "\n%u errors\n", ( unsigned )errors );
+    return ( errors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,301 @@
+/*!
+ * \file      region-dispatch-bench.c
+ *
+ * \brief     Host benchmark of the region dispatch
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Times the region calls the MAC makes for one uplink with its RX
+ *            windows: 6 RegionGetPhyParam, RegionVerify, RegionNextChannel,
+ *            RegionApplyDrOffset, 2 RegionComputeRxWindowParameters,
+ *            RegionTxConfig, RegionSetBandTxDone and 2 RegionRxConfig. The
+ *            radio is stubbed, so only the MAC side is measured.
+ *
+ *            The host board runs the builds without link time optimization
+ *            as the region-dispatch-all, -eu868 and -single tests. Each
+ *            dispatch mode, with and without -flto, from the src directory:
+ *
+ *            R="-DREGION_AS923 -DREGION_AU915 -DREGION_CN470 -DREGION_CN779 \
+ *               -DREGION_EU433 -DREGION_KR920 -DREGION_IN865 -DREGION_US915 \
+ *               -DREGION_RU864 -DREGION_PRIV868 \
+ *               -DREGION_AS923_DEFAULT_CHANNEL_PLAN=CHANNEL_PLAN_GROUP_AS923_1 \
+ *               -DREGION_CN470_DEFAULT_CHANNEL_PLAN=CHANNEL_PLAN_20MHZ_TYPE_A"
+ *            B="mac/region/bench/region-dispatch-bench.c mac/region/Region.c \
+ *               boards/mcu/utilities.c"
+ *            S="$B mac/region/RegionCommon.c mac/region/RegionEU868.c"
+ *            I="-Imac -Imac/region -Isystem -Iradio -Iboards -Iperipherals"
+ *            gcc -O2 $I -DREGION_EU868 $R $B mac/region/Region[A-Z]*.c -o region-dispatch-all
+ *            gcc -O2 $I -DREGION_EU868 $S -o region-dispatch-eu868
+ *            gcc -O2 $I -DREGION_EU868 -DREGION_SINGLE $S -o region-dispatch-single
+ *            gcc -O2 -flto $I -DREGION_EU868 $S -o region-dispatch-eu868-lto
+ *            gcc -O2 -flto $I -DREGION_EU868 -DREGION_SINGLE $S -o region-dispatch-single-lto
+ *
+ *            REGION_SINGLE saves the dispatch code but is not faster by itself:
+ *            the region functions are in other translation units and stay
+ *            calls. With -flto both the EU868 only switch and the direct calls
+ *            are inlined and run in about the same time.
+ *
+ *            The flash cost of the dispatch is the text size of Region.o,
+ *            given by size( 1 ) on the object built with -Os and the same
+ *            options.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+#include "utilities.h"
+#include "radio.h"
+#include "sx-timer.h"
+#include "sx-systime.h"
+#include "LoRaMac.h"
+#include "region/Region.h"
+
+/*!
+ * Number of timed uplinks
+ */
+#define BENCH_UPLINKS                               1000000
+
+/*!
+ * Region calls per uplink
+ */
+#define BENCH_CALLS_PER_UPLINK                      15
+
+#if defined( REGION_SINGLE )
+#define BENCH_MODE                                  "REGION_SINGLE direct calls"
+#elif defined( REGION_US915 )
+#define BENCH_MODE                                  "Region.c switch, all regions"
+#else
+#define BENCH_MODE                                  "Region.c switch, EU868 only"
+#endif
+
+/*!
+ * Region of the MAC, read from memory as Nvm.MacGroup2.Region
+ */
+static LoRaMacRegion_t BenchRegion = LORAMAC_REGION_EU868;
+
+/*!
+ * Virtual time [ms]
+ */
+static TimerTime_t Now = 1;
+
+static RegionNvmDataGroup1_t NvmGroup1;
+static RegionNvmDataGroup2_t NvmGroup2;
+static Band_t Bands[REGION_NVM_MAX_NB_BANDS];
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return Now;
+}
+
+TimerTime_t TimerGetElapsedTime( TimerTime_t past )
+{
+    if( past == 0 )
+    {
+        return 0;
+    }
+    return Now - past;
+}
+
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
+{
+    SysTime_t c = { .Seconds = a.Seconds - b.Seconds, .SubSeconds = a.SubSeconds - b.SubSeconds };
+
+    if( c.SubSeconds < 0 )
+    {
+        c.Seconds--;
+        c.SubSeconds += 1000;
+    }
+    return c;
+}
+
+SysTime_t SysTimeFromMs( uint32_t timeMs )
+{
+    SysTime_t t = { .Seconds = timeMs / 1000, .SubSeconds = timeMs % 1000 };
+
+    return t;
+}
+
+uint32_t SysTimeToMs( SysTime_t t )
+{
+    return t.Seconds * 1000 + t.SubSeconds;
+}
+
+static RadioState_t BenchGetStatus( void )
+{
+    return RF_IDLE;
+}
+
+static void BenchSetChannel( uint32_t freq )
+{
+}
+
+static void BenchSetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                              uint32_t bandwidthAfc, uint16_t preambleLen, uint16_t symbTimeout, bool fixLen,
+                              uint8_t payloadLen, bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                              bool iqInverted, bool rxContinuous )
+{
+}
+
+static void BenchSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth,
+                              uint32_t datarate, uint8_t coderate, uint16_t preambleLen, bool fixLen,
+                              bool crcOn, bool freqHopOn, uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+}
+
+static bool BenchCheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+static uint32_t BenchTimeOnAir( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                                uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    // Constant, the time on air computation is not part of the dispatch
+    return 72;
+}
+
+static void BenchSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+}
+
+static uint32_t BenchGetWakeupTime( void )
+{
+    return 3;
+}
+
+const struct Radio_s Radio =
+{
+    .GetStatus = BenchGetStatus,
+    .SetChannel = BenchSetChannel,
+    .SetRxConfig = BenchSetRxConfig,
+    .SetTxConfig = BenchSetTxConfig,
+    .CheckRfFrequency = BenchCheckRfFrequency,
+    .TimeOnAir = BenchTimeOnAir,
+    .SetMaxPayloadLength = BenchSetMaxPayloadLength,
+    .GetWakeupTime = BenchGetWakeupTime,
+};
+
+static double BenchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t BenchCycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc( );
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * Region calls of one uplink, in the order of the MAC
+ */
+static uint32_t BenchUplink( void )
+{
+    GetPhyParams_t getPhy = { .UplinkDwellTime = 0, .DownlinkDwellTime = 0, .Datarate = DR_5 };
+    VerifyParams_t verify = { .DatarateParams = { .Datarate = DR_5, .UplinkDwellTime = 0 } };
+    NextChanParams_t nextChan = { 0 };
+    TxConfigParams_t txConfig = { 0 };
+    SetBandTxDoneParams_t txDone = { 0 };
+    RxConfigParams_t rxWindow1 = { 0 };
+    RxConfigParams_t rxWindow2 = { 0 };
+    TimerTime_t dutyCycleWaitTime = 0;
+    TimerTime_t aggregatedTimeOff = 0;
+    TimerTime_t txTimeOnAir = 0;
+    uint32_t sum = 0;
+    uint8_t channel = 0;
+    int8_t txPower = 0;
+    int8_t rxDatarate = 0;
+
+    // Payload size, ADR and Tx parameters
+    getPhy.Attribute = PHY_MAX_PAYLOAD;
+    sum += RegionGetPhyParam( BenchRegion, &getPhy ).Value;
+    getPhy.Attribute = PHY_MIN_TX_DR;
+    sum += RegionGetPhyParam( BenchRegion, &getPhy ).Value;
+    getPhy.Attribute = PHY_DEF_TX_POWER;
+    sum += RegionGetPhyParam( BenchRegion, &getPhy ).Value;
+    getPhy.Attribute = PHY_DEF_ADR_ACK_LIMIT;
+    sum += RegionGetPhyParam( BenchRegion, &getPhy ).Value;
+    sum += RegionVerify( BenchRegion, &verify, PHY_TX_DR );
+
+    // Channel selection and Rx windows
+    nextChan.Datarate = DR_5;
+    nextChan.Joined = true;
+    nextChan.PktLen = 33;
+    sum += RegionNextChannel( BenchRegion, &nextChan, &channel, &dutyCycleWaitTime, &aggregatedTimeOff );
+    RegionComputeRxWindowParameters( BenchRegion, RegionApplyDrOffset( BenchRegion, 0, DR_5, 0 ), 6, 10, &rxWindow1 );
+    RegionComputeRxWindowParameters( BenchRegion, DR_0, 6, 10, &rxWindow2 );
+
+    // Transmission
+    txConfig.Channel = channel;
+    txConfig.Datarate = DR_5;
+    txConfig.TxPower = 0;
+    txConfig.MaxEirp = 16;
+    txConfig.AntennaGain = 2.15f;
+    txConfig.PktLen = 33;
+    sum += RegionTxConfig( BenchRegion, &txConfig, &txPower, &txTimeOnAir );
+    getPhy.Attribute = PHY_RETRANSMIT_TIMEOUT;
+    sum += RegionGetPhyParam( BenchRegion, &getPhy ).Value;
+    txDone.Channel = channel;
+    txDone.Joined = true;
+    txDone.LastTxDoneTime = Now;
+    txDone.LastTxAirTime = txTimeOnAir;
+    txDone.ElapsedTimeSinceStartUp = SysTimeFromMs( Now );
+    RegionSetBandTxDone( BenchRegion, &txDone );
+
+    // Reception windows
+    rxWindow1.Channel = channel;
+    rxWindow1.RxSlot = RX_SLOT_WIN_1;
+    sum += RegionRxConfig( BenchRegion, &rxWindow1, &rxDatarate );
+    rxWindow2.Frequency = 869525000;
+    rxWindow2.RxSlot = RX_SLOT_WIN_2;
+    sum += RegionRxConfig( BenchRegion, &rxWindow2, &rxDatarate );
+    getPhy.Attribute = PHY_MAX_RX_WINDOW;
+    sum += RegionGetPhyParam( BenchRegion, &getPhy ).Value;
+
+    // Off the duty cycle restrictions for the next uplink
+    Now += 3600000;
+    return sum;
+}
+
+int main( void )
+{
+    InitDefaultsParams_t params = { .NvmGroup1 = &NvmGroup1, .NvmGroup2 = &NvmGroup2, .Bands = Bands };
+    volatile uint32_t sink = 0;
+    uint64_t cycles;
+    double t0;
+
+    if( RegionIsActive( BenchRegion ) == false )
+    {
+        printf( "EU868 not enabled\n" );
+        return 1;
+    }
+    params.Type = INIT_TYPE_DEFAULTS;
+    RegionInitDefaults( BenchRegion, &params );
+
+    // Warm up
+    for( uint32_t i = 0; i < BENCH_UPLINKS / 10; i++ )
+    {
+        sink += BenchUplink( );
+    }
+
+    t0 = BenchNow( );
+    cycles = BenchCycles( );
+    for( uint32_t i = 0; i < BENCH_UPLINKS; i++ )
+    {
+        sink += BenchUplink( );
+    }
+    cycles = BenchCycles( ) - cycles;
+    t0 = BenchNow( ) - t0;
+
+    printf( "%-30s %2d region calls/uplink, %7.1f ns/uplink, %7.1f cycles/uplink\n",
+            BENCH_MODE, BENCH_CALLS_PER_UPLINK, t0 / BENCH_UPLINKS, ( double )cycles / BENCH_UPLINKS );
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*!
+ * \file      region-nvm-budget.c
+ *
+ * \brief     Host report of the RAM, NVM and flash budget of a region
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Prints the size of the region NVM data groups, which are held in
+ *            RAM and written to the NVM on a LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP1
+ *            or LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP2 notification, the RAM of
+ *            the bands and the flash of the const channel tables. It also
+ *            checks the channel list returned by PHY_CHANNELS against the
+ *            channel plan.
+ *
+ *            The host board builds it for every region, as the
+ *            region-nvm-budget-<region> tests failing on a channel error.
+ *            From the src directory:
+ *
+ *            I="-Imac -Imac/region -Isystem -Iradio -Iboards -Iperipherals"
+ *            for r in AS923 AU915 CN470 CN779 EU433 EU868 IN865 KR920 RU864 US915 PRIV868; do
+ *                S="mac/region/RegionCommon.c mac/region/Region$r.c boards/mcu/utilities.c"
+ *                case $r in
+ *                    US915|AU915) S="$S mac/region/RegionBaseUS.c";;
+ *                    CN470) S="$S mac/region/RegionBaseUS.c mac/region/RegionCN470[AB]*.c";;
+ *                esac
+ *                gcc -O2 $I -DREGION_$r -DREGION_SINGLE \
+ *                    -DREGION_AS923_DEFAULT_CHANNEL_PLAN=CHANNEL_PLAN_GROUP_AS923_1 \
+ *                    -DREGION_CN470_DEFAULT_CHANNEL_PLAN=CHANNEL_PLAN_20MHZ_TYPE_A \
+ *                    mac/region/bench/region-nvm-budget.c $S -o region-nvm-budget && ./region-nvm-budget
+ *            done
+ */
+#include <stdio.h>
+#include "utilities.h"
+#include "radio.h"
+#include "sx-timer.h"
+#include "sx-systime.h"
+#include "LoRaMac.h"
+#include "region/Region.h"
+#include "region/RegionCommon.h"
+
+#if defined( REGION_US915 )
+/*!
+ * Channels of the fixed channel plan in flash
+ */
+#define BENCH_FLASH_CHANNELS                        US915_MAX_NB_CHANNELS
+#elif defined( REGION_AU915 )
+#define BENCH_FLASH_CHANNELS                        AU915_MAX_NB_CHANNELS
+#elif defined( REGION_CN470 )
+#define BENCH_FLASH_CHANNELS                        ( 4 * CN470_PLAN_NB_CHANNELS + CN470_COMMON_JOIN_CHANNELS_SIZE )
+#else
+#define BENCH_FLASH_CHANNELS                        0
+#endif
+
+/*!
+ * Name of the region, from REGION_SINGLE_ID
+ */
+#define BENCH_STR( x )                              #x
+#define BENCH_REGION_NAME( id )                     BENCH_STR( id )
+
+static RegionNvmDataGroup1_t NvmGroup1;
+static RegionNvmDataGroup2_t NvmGroup2;
+static Band_t Bands[REGION_NVM_MAX_NB_BANDS];
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return 1;
+}
+
+TimerTime_t TimerGetElapsedTime( TimerTime_t past )
+{
+    return 0;
+}
+
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
+{
+    SysTime_t c = { .Seconds = a.Seconds - b.Seconds, .SubSeconds = a.SubSeconds - b.SubSeconds };
+
+    return c;
+}
+
+SysTime_t SysTimeFromMs( uint32_t timeMs )
+{
+    SysTime_t t = { .Seconds = timeMs / 1000, .SubSeconds = timeMs % 1000 };
+
+    return t;
+}
+
+uint32_t SysTimeToMs( SysTime_t t )
+{
+    return t.Seconds * 1000 + t.SubSeconds;
+}
+
+const struct Radio_s Radio = { 0 };
+
+/*!
+ * \brief Checks the channels against the channel plan formula of the region.
+ *
+ * \retval Number of channels which do not match.
+ */
+static uint32_t BenchCheckChannels( const ChannelParams_t* channels )
+{
+    uint32_t errors = 0;
+
+#if defined( REGION_US915 ) || defined( REGION_AU915 )
+#if defined( REGION_US915 )
+    const uint32_t first125 = 902300000, first500 = 903000000;
+    const int8_t drRange125 = ( DR_3 << 4 ) | DR_0, drRange500 = ( US915_500KHZ_MAX_DATARATE << 4 ) | DR_4;
+#else
+    const uint32_t first125 = 915200000, first500 = 915900000;
+    const int8_t drRange125 = ( DR_5 << 4 ) | DR_0, drRange500 = ( DR_6 << 4 ) | DR_6;
+#endif
+    for( uint8_t i = 0; i < 72; i++ )
+    {
+        uint32_t frequency = ( i < 64 ) ? ( first125 + i * 200000 ) : ( first500 + ( i - 64 ) * 1600000 );
+        int8_t drRange = ( i < 64 ) ? drRange125 : drRange500;
+
+        if( ( channels[i].Frequency != frequency ) || ( channels[i].Rx1Frequency != 0 ) ||
+            ( channels[i].DrRange.Value != drRange ) || ( channels[i].Band != 0 ) )
+        {
+            errors++;
+        }
+    }
+#elif defined( REGION_CN470 )
+    // Default channel plan, type A 20MHz
+    for( uint8_t i = 0; i < CN470_PLAN_NB_CHANNELS; i++ )
+    {
+        uint32_t frequency = ( i < 32 ) ? ( 470300000 + i * 200000 ) : ( 503500000 + ( i - 32 ) * 200000 );
+
+        if( ( channels[i].Frequency != frequency ) || ( channels[i].Rx1Frequency != 0 ) ||
+            ( channels[i].DrRange.Value != ( ( CN470_TX_MAX_DATARATE << 4 ) | CN470_TX_MIN_DATARATE ) ) ||
+            ( channels[i].Band != 0 ) )
+        {
+            errors++;
+        }
+    }
+#else
+    // Channel list in the NVM data, set up by RegionInitDefaults
+    if( channels != NvmGroup2.Channels )
+    {
+        errors++;
+    }
+#endif
+    return errors;
+}
+
+int main( void )
+{
+    InitDefaultsParams_t params = { .NvmGroup1 = &NvmGroup1, .NvmGroup2 = &NvmGroup2, .Bands = Bands };
+    GetPhyParams_t getPhy = { .Attribute = PHY_CHANNELS };
+    uint32_t errors = 0;
+
+    params.Type = INIT_TYPE_DEFAULTS;
+    RegionInitDefaults( REGION_SINGLE_ID, &params );
+    errors = BenchCheckChannels( RegionGetPhyParam( REGION_SINGLE_ID, &getPhy ).Channels );
+
+    printf( "%-22s NVM group 1 %4u B, NVM group 2 %4u B, bands %3u B RAM, channels %4u B NVM %4u B flash, %u channel errors\n",
+            BENCH_REGION_NAME( REGION_SINGLE_ID ), ( unsigned )sizeof( RegionNvmDataGroup1_t ), ( unsigned )sizeof( RegionNvmDataGroup2_t ),
+            ( unsigned )sizeof( Bands ), ( unsigned )( REGION_NVM_MAX_NB_CHANNELS * sizeof( ChannelParams_t ) ),
+            ( unsigned )( BENCH_FLASH_CHANNELS * sizeof( ChannelParams_t ) ), ( unsigned )errors );
+    return ( errors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,418 @@
+/*!
+ * \file      tx-schedule-bench.c
+ *
+ * \brief     Host benchmark of the uplink scheduling cost
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Compares, for a device in duty-cycle time-off, the work done by
+ *            every restricted uplink attempt ( band time-off update and
+ *            channel count ) with RegionXXGetNextTxDelay. Runs on EU868 with
+ *            16 channels over 6 bands and on US915 with 72 channels. The
+ *            delays returned by the query are checked against the band update:
+ *            the uplink must be refused 1 ms before the delay and allowed at
+ *            the delay. The same traffic is then run with the band update
+ *            polled after each returned time-off, as the MAC did before, to
+ *            count the attempts needed per uplink.
+ *
+ *            The channels are those returned by PHY_CHANNELS: the NVM data of
+ *            EU868 and the const channel table of US915.
+ *
+ *            A delay error fails the tx-schedule-bench test of the host
+ *            board. From the src directory:
+ *
+ *            gcc -O2 -DREGION_EU868 -DREGION_US915 -Imac -Imac/region -Isystem \
+ *                -Iradio -Iboards -Iperipherals mac/region/bench/tx-schedule-bench.c \
+ *                mac/region/RegionCommon.c mac/region/RegionEU868.c \
+ *                mac/region/RegionUS915.c mac/region/RegionBaseUS.c \
+ *                boards/mcu/utilities.c -lm -o tx-schedule-bench
+ *            ./tx-schedule-bench
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "utilities.h"
+#include "radio.h"
+#include "sx-timer.h"
+#include "sx-systime.h"
+#include "RegionCommon.h"
+#include "RegionEU868.h"
+#include "RegionUS915.h"
+
+/*!
+ * Number of timed calls per measurement
+ */
+#define BENCH_ITERATIONS                            200000
+
+/*!
+ * Application payload size of the simulated uplinks
+ */
+#define BENCH_PAYLOAD_SIZE                          20
+
+/*!
+ * Simulated time of the correctness check [ms]
+ */
+#define BENCH_SIMULATION_TIME                       ( 6 * 3600 * 1000UL )
+
+/*!
+ * Largest number of channels of the benchmarked regions
+ */
+#define BENCH_MAX_NB_CHANNELS                       US915_MAX_NB_CHANNELS
+
+typedef TimerTime_t ( *GetNextTxDelay_t )( NextChanParams_t* nextChanParams );
+
+typedef struct sBenchRegion
+{
+    const char* Name;
+    uint16_t NbChannels;
+    uint8_t NbBands;
+    const ChannelParams_t* Channels;
+    PhyParam_t ( *GetPhyParam )( GetPhyParams_t* getPhy );
+    GetNextTxDelay_t GetNextTxDelay;
+    void ( *SetBandTxDone )( SetBandTxDoneParams_t* txDone );
+    TimerTime_t ( *TimeOnAir )( int8_t datarate, uint16_t pktLen );
+    int8_t Datarate;
+}BenchRegion_t;
+
+/*!
+ * Virtual time [ms]
+ */
+static TimerTime_t Now = 1;
+
+static RegionNvmDataGroup1_t NvmGroup1;
+static RegionNvmDataGroup2_t NvmGroup2;
+static Band_t Bands[REGION_NVM_MAX_NB_BANDS];
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return Now;
+}
+
+TimerTime_t TimerGetElapsedTime( TimerTime_t past )
+{
+    if( past == 0 )
+    {
+        return 0;
+    }
+    return Now - past;
+}
+
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
+{
+    SysTime_t c = { .Seconds = a.Seconds - b.Seconds, .SubSeconds = a.SubSeconds - b.SubSeconds };
+
+    if( c.SubSeconds < 0 )
+    {
+        c.Seconds--;
+        c.SubSeconds += 1000;
+    }
+    return c;
+}
+
+SysTime_t SysTimeFromMs( uint32_t timeMs )
+{
+    SysTime_t t = { .Seconds = timeMs / 1000, .SubSeconds = timeMs % 1000 };
+
+    return t;
+}
+
+uint32_t SysTimeToMs( SysTime_t t )
+{
+    return t.Seconds * 1000 + t.SubSeconds;
+}
+
+/*!
+ * LoRa time on air. The last result is kept so that the timings measure the
+ * scheduling and not the floating point computation.
+ */
+static uint32_t BenchTimeOnAir( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                                uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    static const uint32_t bandwidths[] = { 125000, 250000, 500000 };
+    static uint32_t lastKey = 0;
+    static uint32_t lastTimeOnAir = 0;
+    uint32_t key = ( datarate << 24 ) | ( bandwidth & 0x3 ) << 22 | ( coderate << 16 ) | ( preambleLen << 8 ) | payloadLen;
+
+    if( key == lastKey )
+    {
+        return lastTimeOnAir;
+    }
+    double symbol = ( double )( 1 << datarate ) / bandwidths[( bandwidth < 3 ) ? bandwidth : 0];
+    int lowDatarateOptimize = ( symbol > 0.016 ) ? 1 : 0;
+    double nbSymbols = 8 * payloadLen - 4 * ( int )datarate + 28 + ( crcOn ? 16 : 0 ) - ( fixLen ? 20 : 0 );
+    double payloadSymbols = 8 + fmax( ceil( nbSymbols / ( 4 * ( ( int )datarate - 2 * lowDatarateOptimize ) ) ) * ( coderate + 4 ), 0 );
+
+    lastKey = key;
+    lastTimeOnAir = ( uint32_t )ceil( ( preambleLen + 4.25 + payloadSymbols ) * symbol * 1000 );
+    return lastTimeOnAir;
+}
+
+static bool BenchCheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+const struct Radio_s Radio = { .TimeOnAir = BenchTimeOnAir, .CheckRfFrequency = BenchCheckRfFrequency };
+
+static double BenchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void BenchNextChanParams( NextChanParams_t* nextChan, int8_t datarate )
+{
+    memset( nextChan, 0, sizeof( NextChanParams_t ) );
+    nextChan->Datarate = datarate;
+    nextChan->Joined = true;
+    nextChan->DutyCycleEnabled = true;
+    nextChan->PktLen = 13 + BENCH_PAYLOAD_SIZE;
+}
+
+/*!
+ * Per attempt work of the band update path, as done by
+ * RegionCommonIdentifyChannels once the aggregated time-off has elapsed
+ *
+ * \remark The time-off returned by RegionCommonUpdateBandTimeOff is 0 when the
+ *         credits equal the costs, the band is only ready 1 ms later. The
+ *         channel count is the reference.
+ *
+ * \param [OUT] delay Time-off returned by the band update
+ *
+ * \retval Number of channels available for the uplink
+ */
+static uint8_t BenchBandUpdate( BenchRegion_t* region, NextChanParams_t* nextChan, TimerTime_t* delay )
+{
+    RegionCommonCountNbOfEnabledChannelsParams_t countParams;
+    uint8_t enabledChannels[BENCH_MAX_NB_CHANNELS];
+    uint8_t nbEnabledChannels = 0;
+    uint8_t nbRestrictedChannels = 0;
+
+    *delay = RegionCommonUpdateBandTimeOff( true, Bands, region->NbBands, true, false,
+                                            nextChan->ElapsedTimeSinceStartUp,
+                                            region->TimeOnAir( nextChan->Datarate, nextChan->PktLen ) );
+
+    countParams.Joined = true;
+    countParams.Datarate = nextChan->Datarate;
+    countParams.ChannelsMask = NvmGroup2.ChannelsMask;
+    countParams.Channels = region->Channels;
+    countParams.Bands = Bands;
+    countParams.MaxNbChannels = region->NbChannels;
+    countParams.JoinChannels = NULL;
+    RegionCommonCountNbOfEnabledChannels( &countParams, enabledChannels, &nbEnabledChannels, &nbRestrictedChannels );
+
+    return nbEnabledChannels;
+}
+
+/*!
+ * Checks if the band update path allows an uplink at the given time,
+ * without changing the bands
+ */
+static bool BenchIsAllowed( BenchRegion_t* region, NextChanParams_t* nextChan, TimerTime_t time )
+{
+    Band_t bands[REGION_NVM_MAX_NB_BANDS];
+    TimerTime_t now = Now;
+    TimerTime_t delay;
+    uint8_t nbEnabledChannels;
+
+    memcpy( bands, Bands, sizeof( bands ) );
+    Now = time;
+    nbEnabledChannels = BenchBandUpdate( region, nextChan, &delay );
+    Now = now;
+    memcpy( Bands, bands, sizeof( bands ) );
+    return nbEnabledChannels > 0;
+}
+
+/*!
+ * Transmits on the next enabled channel of a ready band
+ */
+static void BenchTransmit( BenchRegion_t* region, uint8_t* channel, TimerTime_t airTime )
+{
+    SetBandTxDoneParams_t txDone;
+
+    for( uint16_t i = 0; i < region->NbChannels; i++ )
+    {
+        *channel = ( *channel + 1 ) % region->NbChannels;
+        if( ( ( NvmGroup2.ChannelsMask[*channel / 16] & ( 1 << ( *channel % 16 ) ) ) != 0 ) &&
+            ( Bands[region->Channels[*channel].Band].ReadyForTransmission == true ) )
+        {
+            break;
+        }
+    }
+    txDone.Channel = *channel;
+    txDone.Joined = true;
+    txDone.LastTxDoneTime = Now + airTime;
+    txDone.LastTxAirTime = airTime;
+    txDone.ElapsedTimeSinceStartUp = SysTimeFromMs( Now );
+    region->SetBandTxDone( &txDone );
+    Now += airTime;
+}
+
+static void BenchRun( BenchRegion_t* region )
+{
+    NextChanParams_t nextChan;
+    TimerTime_t airTime;
+    TimerTime_t delay = 0;
+    TimerTime_t start = Now;
+    uint32_t nbUplinks = 0;
+    uint32_t nbLegacyUplinks = 0;
+    uint32_t nbLegacyAttempts = 0;
+    uint32_t nbErrors = 0;
+    uint8_t channel = 0;
+    double legacyNs;
+    double queryNs;
+    double t0;
+    volatile TimerTime_t sink = 0;
+    GetPhyParams_t getPhy = { .Attribute = PHY_CHANNELS };
+
+    region->Channels = region->GetPhyParam( &getPhy ).Channels;
+    BenchNextChanParams( &nextChan, region->Datarate );
+    airTime = region->TimeOnAir( nextChan.Datarate, nextChan.PktLen );
+
+    // Send as soon as allowed, sleeping for the queried delay, and check the
+    // delays against the band update path
+    while( ( Now - start ) < BENCH_SIMULATION_TIME )
+    {
+        delay = region->GetNextTxDelay( &nextChan );
+        if( delay == TIMERTIME_T_MAX )
+        {
+            nbErrors++;
+            break;
+        }
+        if( ( delay > 0 ) && ( BenchIsAllowed( region, &nextChan, Now + delay - 1 ) == true ) )
+        {
+            nbErrors++;
+        }
+        Now += delay;
+        if( BenchBandUpdate( region, &nextChan, &delay ) == 0 )
+        {
+            nbErrors++;
+            break;
+        }
+        BenchTransmit( region, &channel, airTime );
+        nbUplinks++;
+    }
+
+    // Same traffic, sleeping for the time-off of the band update path and
+    // retrying when refused
+    start = Now;
+    while( ( Now - start ) < BENCH_SIMULATION_TIME )
+    {
+        nbLegacyAttempts++;
+        if( BenchBandUpdate( region, &nextChan, &delay ) == 0 )
+        {
+            Now += ( delay > 0 ) ? delay : 1;
+            continue;
+        }
+        BenchTransmit( region, &channel, airTime );
+        nbLegacyUplinks++;
+    }
+
+    // Timing of a restricted attempt, the device being in time-off after its
+    // last uplink
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+    {
+        Band_t bands[REGION_NVM_MAX_NB_BANDS];
+
+        memcpy( bands, Bands, sizeof( bands ) );
+        sink += BenchBandUpdate( region, &nextChan, &delay );
+        memcpy( Bands, bands, sizeof( bands ) );
+    }
+    legacyNs = ( BenchNow( ) - t0 ) / BENCH_ITERATIONS;
+
+    t0 = BenchNow( );
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+    {
+        Band_t bands[REGION_NVM_MAX_NB_BANDS];
+
+        // Same copies as above so that only the computation differs
+        memcpy( bands, Bands, sizeof( bands ) );
+        sink += region->GetNextTxDelay( &nextChan );
+        memcpy( Bands, bands, sizeof( bands ) );
+    }
+    queryNs = ( BenchNow( ) - t0 ) / BENCH_ITERATIONS;
+
+    printf( "%-6s %2u channels %u band(s), DR%d %u ms airtime, %lu h per run\n",
+            region->Name, region->NbChannels, region->NbBands, region->Datarate, ( unsigned )airTime,
+            BENCH_SIMULATION_TIME / 3600000UL );
+    printf( "       next tx delay query: %6u uplinks, 1.00 attempt/uplink, %u delay errors, %7.1f ns/query\n",
+            ( unsigned )nbUplinks, ( unsigned )nbErrors, queryNs );
+    printf( "       band update retries: %6u uplinks, %4.2f attempt/uplink, %7.1f ns/attempt\n",
+            ( unsigned )nbLegacyUplinks, ( double )nbLegacyAttempts / nbLegacyUplinks, legacyNs );
+}
+
+static TimerTime_t BenchEU868TimeOnAir( int8_t datarate, uint16_t pktLen )
+{
+    static const uint8_t sf[] = { 12, 11, 10, 9, 8, 7 };
+
+    return BenchTimeOnAir( MODEM_LORA, 0, sf[datarate], 1, 8, false, pktLen, true );
+}
+
+static TimerTime_t BenchUS915TimeOnAir( int8_t datarate, uint16_t pktLen )
+{
+    static const uint8_t sf[] = { 10, 9, 8, 7 };
+
+    return BenchTimeOnAir( MODEM_LORA, 0, sf[datarate], 1, 8, false, pktLen, true );
+}
+
+static void BenchInit( InitDefaultsParams_t* params )
+{
+    memset( &NvmGroup1, 0, sizeof( NvmGroup1 ) );
+    memset( &NvmGroup2, 0, sizeof( NvmGroup2 ) );
+    memset( Bands, 0, sizeof( Bands ) );
+    params->NvmGroup1 = &NvmGroup1;
+    params->NvmGroup2 = &NvmGroup2;
+    params->Bands = Bands;
+    params->Type = INIT_TYPE_DEFAULTS;
+}
+
+int main( void )
+{
+    // 13 channels added to the 3 default ones, over the g, g1, g2 and g3 bands
+    static const uint32_t eu868Frequencies[] =
+    {
+        867100000, 867300000, 867500000, 867700000, 867900000, 865100000, 865300000,
+        865500000, 868700000, 868900000, 869100000, 869525000, 864900000,
+    };
+    InitDefaultsParams_t params;
+    BenchRegion_t eu868 =
+    {
+        .Name = "EU868", .NbChannels = EU868_MAX_NB_CHANNELS, .NbBands = EU868_MAX_NB_BANDS,
+        .GetPhyParam = RegionEU868GetPhyParam,
+        .GetNextTxDelay = RegionEU868GetNextTxDelay, .SetBandTxDone = RegionEU868SetBandTxDone,
+        .TimeOnAir = BenchEU868TimeOnAir, .Datarate = DR_5,
+    };
+    BenchRegion_t us915 =
+    {
+        .Name = "US915", .NbChannels = US915_MAX_NB_CHANNELS, .NbBands = US915_MAX_NB_BANDS,
+        .GetPhyParam = RegionUS915GetPhyParam,
+        .GetNextTxDelay = RegionUS915GetNextTxDelay, .SetBandTxDone = RegionUS915SetBandTxDone,
+        .TimeOnAir = BenchUS915TimeOnAir, .Datarate = DR_0,
+    };
+
+    BenchInit( &params );
+    RegionEU868InitDefaults( &params );
+    for( uint8_t i = 0; i < sizeof( eu868Frequencies ) / sizeof( eu868Frequencies[0] ); i++ )
+    {
+        ChannelParams_t channel = { .Frequency = eu868Frequencies[i], .DrRange.Value = ( DR_5 << 4 ) | DR_0 };
+        ChannelAddParams_t channelAdd = { .NewChannel = &channel, .ChannelId = 3 + i };
+
+        if( RegionEU868ChannelAdd( &channelAdd ) != LORAMAC_STATUS_OK )
+        {
+            printf( "EU868 channel %lu rejected\n", ( unsigned long )eu868Frequencies[i] );
+            return 1;
+        }
+    }
+    NvmGroup2.ChannelsMask[0] = 0xFFFF;
+    BenchRun( &eu868 );
+
+    Now = 1;
+    BenchInit( &params );
+    RegionUS915InitDefaults( &params );
+    BenchRun( &us915 );
+    return 0;
+}
@@ -0,0 +1,434 @@
+/*!
+ * \file      aes-fixsliced.c
+ *
+ * \brief     Constant time AES encryption with a fixsliced state
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Backend of aes_set_key and aes_encrypt selected by
+ *            SOFT_SE_AES_FIXSLICED. The state is bitsliced: word b holds bit
+ *            b of the 16 bytes, the byte of row r and column c at bit
+ *            8 r + 2 c. The odd bits are a second lane, unused by the single
+ *            block aes_encrypt. The S-box is the Boyar-Peralta circuit of 113
+ *            gates, so there are no data dependent table lookups or branches.
+ *
+ *            ShiftRows is never applied. In the bitsliced layout it is a
+ *            different rotation of each byte, while MixColumns only needs
+ *            whole word rotations. Round r instead works on a state whose row
+ *            j is rotated by j r columns, which MixColumns absorbs with a
+ *            rotation within the bytes ( Adomnicai and Peyrin, "Fixslicing
+ *            AES-like ciphers", TCHES 2021 ). The round keys are stored in the
+ *            same rotated layout, and the output bytes are put back in place
+ *            once, after the last round.
+ *
+ *            The key schedule is stored bitsliced in aes_context.ksch32, 4
+ *            words per round key: word j holds bit 2 j in the even bits and bit
+ *            2 j + 1 in the odd bits.
+ */
+#include <stdint.h>
+#include "aes.h"
+
+#if defined( SOFT_SE_AES_FIXSLICED )
+
+/*!
+ * Word rotation, towards the lower rows for a multiple of 8
+ */
+#define ROTR( x, n )                                ( ( ( x ) >> ( n ) ) | ( ( x ) << ( 32 - ( n ) ) ) )
+
+/*!
+ * Rotation of each byte towards the higher columns by n bits, 0 <= n < 8
+ */
+#define BYTE_ROTL( x, n )                           ( ( ( ( x ) << ( n ) ) & ( 0x01010101u * ( ( 0xFFu << ( n ) ) & 0xFF ) ) ) | \
+                                                      ( ( ( x ) >> ( 8 - ( n ) ) ) & ( 0x01010101u * ( 0xFFu >> ( 8 - ( n ) ) ) ) ) )
+
+/*!
+ * Exchanges the bits of a selected by mask << n with the bits of b selected by mask
+ */
+#define SWAPMOVE( a, b, mask, n )                   do                                                       \
+                                                    {                                                        \
+                                                        uint32_t tmp = ( ( ( a ) >> ( n ) ) ^ ( b ) ) & ( mask ); \
+                                                        ( b ) ^= tmp;                                        \
+                                                        ( a ) ^= tmp << ( n );                               \
+                                                    } while( 0 )
+
+/*!
+ * Little endian column load
+ */
+#define GET_COLUMN( p )                             ( ( uint32_t )( p )[0] | ( ( uint32_t )( p )[1] << 8 ) | \
+                                                      ( ( uint32_t )( p )[2] << 16 ) | ( ( uint32_t )( p )[3] << 24 ) )
+
+/*!
+ * \brief Converts between 8 column words, the columns of the 2 lanes
+ *        interleaved, and the 8 bitsliced words. The conversion is its own
+ *        inverse.
+ *
+ * \param [IN,OUT] q          Words
+ */
+static void Ortho( uint32_t q[8] )
+{
+    SWAPMOVE( q[0], q[1], 0x55555555, 1 );
+    SWAPMOVE( q[2], q[3], 0x55555555, 1 );
+    SWAPMOVE( q[4], q[5], 0x55555555, 1 );
+    SWAPMOVE( q[6], q[7], 0x55555555, 1 );
+
+    SWAPMOVE( q[0], q[2], 0x33333333, 2 );
+    SWAPMOVE( q[1], q[3], 0x33333333, 2 );
+    SWAPMOVE( q[4], q[6], 0x33333333, 2 );
+    SWAPMOVE( q[5], q[7], 0x33333333, 2 );
+
+    SWAPMOVE( q[0], q[4], 0x0F0F0F0F, 4 );
+    SWAPMOVE( q[1], q[5], 0x0F0F0F0F, 4 );
+    SWAPMOVE( q[2], q[6], 0x0F0F0F0F, 4 );
+    SWAPMOVE( q[3], q[7], 0x0F0F0F0F, 4 );
+}
+
+/*!
+ * \brief Applies the S-box to the bitsliced state, Boyar-Peralta circuit
+ *
+ * \param [IN,OUT] q          Bitsliced state
+ */
+static void SubBytes( uint32_t q[8] )
+{
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint32_t y20, y21;
+    uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    // Top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // Non-linear section
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // Bottom linear transformation
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/*!
+ * \brief MixColumns on a state whose row j is rotated by j m columns. The
+ *        output keeps the rotation.
+ *
+ * \param [IN,OUT] q          Bitsliced state
+ * \param [IN] m              Column rotation per row, 0 to 3, constant
+ */
+static inline void MixColumns( uint32_t q[8], const uint32_t m )
+{
+    uint32_t s[8];
+    uint32_t t[8];
+
+    for( uint8_t b = 0; b < 8; b++ )
+    {
+        // Rows r + 1, r + 2 and r + 3 of the same column, moved to row r
+        uint32_t r1 = BYTE_ROTL( ROTR( q[b], 8 ), ( 2 * m ) & 7 );
+        uint32_t r2 = BYTE_ROTL( ROTR( q[b], 16 ), ( 4 * m ) & 7 );
+        uint32_t r3 = BYTE_ROTL( ROTR( q[b], 24 ), ( 6 * m ) & 7 );
+
+        // 2 a0 + 3 a1 + a2 + a3 = 2 ( a0 + a1 ) + a1 + a2 + a3
+        s[b] = q[b] ^ r1;
+        t[b] = r1 ^ r2 ^ r3;
+    }
+    q[0] = s[7] ^ t[0];
+    q[1] = s[0] ^ s[7] ^ t[1];
+    q[2] = s[1] ^ t[2];
+    q[3] = s[2] ^ s[7] ^ t[3];
+    q[4] = s[3] ^ s[7] ^ t[4];
+    q[5] = s[4] ^ t[5];
+    q[6] = s[5] ^ t[6];
+    q[7] = s[6] ^ t[7];
+}
+
+/*!
+ * \brief Adds a round key to the even lane of the bitsliced state
+ *
+ * \param [IN,OUT] q          Bitsliced state
+ * \param [IN] rk             Round key, 4 words
+ */
+static void AddRoundKey( uint32_t q[8], const uint32_t rk[4] )
+{
+    q[0] ^= rk[0];
+    q[1] ^= rk[0] >> 1;
+    q[2] ^= rk[1];
+    q[3] ^= rk[1] >> 1;
+    q[4] ^= rk[2];
+    q[5] ^= rk[2] >> 1;
+    q[6] ^= rk[3];
+    q[7] ^= rk[3] >> 1;
+}
+
+/*!
+ * \brief Applies the S-box to each byte of a word
+ */
+static uint32_t SubWord( uint32_t x )
+{
+    uint32_t q[8] = { x, 0, 0, 0, 0, 0, 0, 0 };
+
+    Ortho( q );
+    SubBytes( q );
+    Ortho( q );
+    return q[0];
+}
+
+return_type aes_set_key( const uint8_t key[], length_type keylen, aes_context ctx[1] )
+{
+    uint32_t w[( N_MAX_ROUNDS + 1 ) * N_COL];
+    uint8_t nk = keylen / 4;
+    uint8_t nbWords;
+    uint32_t rc = 1;
+
+    switch( keylen )
+    {
+    case 16:
+    case 24:
+    case 32:
+        break;
+    default:
+        ctx->rnd = 0;
+        return ( uint8_t )-1;
+    }
+    ctx->rnd = nk + 6;
+    nbWords = ( ctx->rnd + 1 ) * N_COL;
+
+    // Key expansion on little endian column words
+    for( uint8_t i = 0; i < nk; i++ )
+    {
+        w[i] = GET_COLUMN( key + 4 * i );
+    }
+    for( uint8_t i = nk; i < nbWords; i++ )
+    {
+        uint32_t t = w[i - 1];
+
+        if( ( i % nk ) == 0 )
+        {
+            t = SubWord( ROTR( t, 8 ) ) ^ rc;
+            rc = ( rc << 1 ) ^ ( ( rc >> 7 ) * 0x11B );
+        }
+        else if( ( nk > 6 ) && ( ( i % nk ) == 4 ) )
+        {
+            t = SubWord( t );
+        }
+        w[i] = w[i - nk] ^ t;
+    }
+
+    // Round key r in the layout of the state of round r: column c of row j
+    // holds column c - j r of the round key
+    for( uint8_t r = 0; r <= ctx->rnd; r++ )
+    {
+        uint32_t q[8];
+
+        for( uint8_t c = 0; c < 4; c++ )
+        {
+            q[2 * c] = 0;
+            q[2 * c + 1] = 0;
+            for( uint8_t j = 0; j < 4; j++ )
+            {
+                q[2 * c] |= w[4 * r + ( ( c + 3 * j * r ) & 3 )] & ( 0xFFu << ( 8 * j ) );
+            }
+        }
+        Ortho( q );
+        for( uint8_t j = 0; j < 4; j++ )
+        {
+            ctx->ksch32[4 * r + j] = ( q[2 * j] & 0x55555555 ) | ( ( q[2 * j + 1] & 0x55555555 ) << 1 );
+        }
+    }
+    return 0;
+}
+
+return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t out[N_BLOCK], const aes_context ctx[1] )
+{
+    uint32_t q[8];
+    uint8_t r;
+    uint8_t shift;
+
+    if( ctx->rnd == 0 )
+    {
+        return ( uint8_t )-1;
+    }
+
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        q[2 * c] = GET_COLUMN( in + 4 * c );
+        q[2 * c + 1] = 0;
+    }
+    Ortho( q );
+    AddRoundKey( q, ctx->ksch32 );
+
+    for( r = 1; r < ctx->rnd; r++ )
+    {
+        SubBytes( q );
+        // Skipping ShiftRows rotates row j of the state by j columns more
+        switch( r & 3 )
+        {
+            case 1:
+                MixColumns( q, 3 );
+                break;
+            case 2:
+                MixColumns( q, 2 );
+                break;
+            case 3:
+                MixColumns( q, 1 );
+                break;
+            default:
+                MixColumns( q, 0 );
+                break;
+        }
+        AddRoundKey( q, ctx->ksch32 + 4 * r );
+    }
+    SubBytes( q );
+    AddRoundKey( q, ctx->ksch32 + 4 * r );
+    Ortho( q );
+
+    // Row j of output column c is in column c + j rnd of the state
+    shift = ctx->rnd & 3;
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        for( uint8_t j = 0; j < 4; j++ )
+        {
+            out[4 * c + j] = ( uint8_t )( q[2 * ( ( c + j * shift ) & 3 )] >> ( 8 * j ) );
+        }
+    }
+    return 0;
+}
+
+#endif
@@ -64,6 +64,13 @@
 
 #include "aes.h"
 
+/* byte oriented cipher rounds, used by the byte backend of the pre-keyed
+   encryption and by the 'on the fly' keying versions */
+#if defined( SOFT_SE_AES_BYTE ) || defined( AES_ENC_128_OTFK ) || defined( AES_DEC_128_OTFK ) || \
+    defined( AES_ENC_256_OTFK ) || defined( AES_DEC_256_OTFK )
+#  define AES_BYTE_ROUNDS
+#endif
+
 //#if defined( HAVE_UINT_32T )
 //  typedef unsigned long uint32_t;
 //#endif
@@ -87,6 +94,8 @@
 #define fd(x)   (f8(x) ^ f4(x) ^ x)
 #define fe(x)   (f8(x) ^ f4(x) ^ f2(x))
 
+#if defined( AES_BYTE_ROUNDS )
+
 #if defined( USE_TABLES )
 
 #define sb_data(w) {    /* S Box data values */                            \
@@ -304,6 +313,8 @@ uint8_t inv_affine(const uint8_t x)
 
 #endif
 
+#endif
+
 #if defined( HAVE_MEMCPY )
 #  define block_copy_nn(d, s, l)    memcpy(d, s, l)
 #  define block_copy(d, s)          memcpy(d, s, N_BLOCK)
@@ -339,6 +350,8 @@ static void copy_block( void *d, const void *s )
 #endif
 }
 
+#if defined( SOFT_SE_AES_BYTE )
+
 static void copy_block_nn( uint8_t * d, const uint8_t *s, uint8_t nn )
 {
     while( nn-- )
@@ -346,6 +359,8 @@ static void copy_block_nn( uint8_t * d, const uint8_t *s, uint8_t nn )
         *d++ = *s++;
 }
 
+#endif
+
 static void xor_block( void *d, const void *s )
 {
 #if defined( HAVE_UINT_32T )
@@ -373,6 +388,8 @@ static void xor_block( void *d, const void *s )
 #endif
 }
 
+#if defined( AES_BYTE_ROUNDS )
+
 static void copy_and_key( void *d, const void *s, const void *k )
 {
 #if defined( HAVE_UINT_32T )
@@ -473,6 +490,8 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
     dt[15] = gfm3_sb(st[12]) ^ s_box(st[1]) ^ s_box(st[6]) ^ gfm2_sb(st[11]);
   }
 
+#endif
+
 #if defined( AES_DEC_PREKEYED )
 
 #if defined( VERSION_1 )
@@ -506,7 +525,7 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
 
 #endif
 
-#if defined( AES_ENC_PREKEYED ) || defined( AES_DEC_PREKEYED )
+#if ( defined( AES_ENC_PREKEYED ) || defined( AES_DEC_PREKEYED ) ) && defined( SOFT_SE_AES_BYTE )
 
 /*  Set the cipher key for the pre-keyed version */
 
@@ -563,6 +582,8 @@ return_type aes_set_key( const uint8_t key[], length_type keylen, aes_context ct
 
 #if defined( AES_ENC_PREKEYED )
 
+#if defined( SOFT_SE_AES_BYTE )
+
 /*  Encrypt a single block of 16 bytes */
 
 return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
@@ -592,6 +613,8 @@ return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const
     return 0;
 }
 
+#endif
+
 /* CBC encrypt a number of blocks (input and return an IV) */
 
 return_type aes_cbc_encrypt( const uint8_t *in, uint8_t *out,
@@ -56,6 +56,23 @@ extern "C" {
 #  define AES_DEC_256_OTFK  /* AES decryption with 'on the fly' 256 bit keying */
 #endif
 
+/*  Backend of the pre-keyed encryption, aes_set_key and aes_encrypt, selected
+    by the build. The format of the key schedule in aes_context depends on the
+    backend, its size does not.
+
+    SOFT_SE_AES_BYTE       8-bit byte operations and tables (aes.c)
+    SOFT_SE_AES_TTABLE     32-bit column words and a 1 kB T-table (aes-ttable.c)
+    SOFT_SE_AES_FIXSLICED  constant time fixsliced, no data dependent table
+                           lookups or branches (aes-fixsliced.c)
+*/
+#if !defined( SOFT_SE_AES_BYTE ) && !defined( SOFT_SE_AES_TTABLE ) && !defined( SOFT_SE_AES_FIXSLICED )
+#  define SOFT_SE_AES_BYTE
+#endif
+
+#if defined( AES_DEC_PREKEYED ) && !defined( SOFT_SE_AES_BYTE )
+#  error "AES_DEC_PREKEYED needs the byte key schedule of SOFT_SE_AES_BYTE"
+#endif
+
 #define N_ROW                   4
 #define N_COL                   4
 #define N_BLOCK   (N_ROW * N_COL)
@@ -70,7 +87,10 @@ typedef uint8_t return_type;
 typedef uint8_t length_type;
 
 typedef struct
-{   uint8_t ksch[(N_MAX_ROUNDS + 1) * N_BLOCK];
+{   union
+    {   uint8_t  ksch[(N_MAX_ROUNDS + 1) * N_BLOCK];
+        uint32_t ksch32[(N_MAX_ROUNDS + 1) * N_COL];  /* word backends */
+    };
     uint8_t rnd;
 } aes_context;
 
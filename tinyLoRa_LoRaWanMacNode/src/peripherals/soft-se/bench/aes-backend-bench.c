@@ -0,0 +1,290 @@
+/*!
+ * \file      aes-backend-bench.c
+ *
+ * \brief     Host test vectors and benchmark of the AES backends
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Checks aes_set_key and aes_encrypt of the selected backend
+ *            against the known answers of FIPS-197 ( appendices B and C ) and
+ *            NIST SP 800-38A ( ECB-AES128, AES192 and AES256 ), and cmac.c on
+ *            top of it against RFC 4493, through AES_CMAC_SetKey and through
+ *            AES_CMAC_InitPrekeyed. The chained encryption of 100000 blocks
+ *            gives the same result with every backend. Then times the key
+ *            schedule and the encryption of a block with a 128 bit key.
+ *
+ *            The host board builds it for every backend, as the
+ *            aes-backend-bench-<backend> tests failing on a wrong answer.
+ *            From the src directory:
+ *
+ *            S="peripherals/soft-se/aes.c peripherals/soft-se/aes-ttable.c \
+ *               peripherals/soft-se/aes-fixsliced.c peripherals/soft-se/cmac.c \
+ *               boards/mcu/utilities.c"
+ *            I="-Iboards -Isystem -Iperipherals/soft-se"
+ *            for b in BYTE TTABLE FIXSLICED; do
+ *                gcc -O2 $I -DSOFT_SE_AES_$b peripherals/soft-se/bench/aes-backend-bench.c $S \
+ *                    -o aes-backend-bench && ./aes-backend-bench
+ *            done
+ *
+ *            The cycles are the time stamp counter of x86 hosts. On the target
+ *            a block costs much more cycles: the Cortex-M0+ has no barrel
+ *            shifter, 8 low registers and a cached XIP flash for the tables.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+#include "utilities.h"
+#include "aes.h"
+#include "cmac.h"
+
+#if defined( SOFT_SE_AES_TTABLE )
+#define BENCH_BACKEND                               "TTABLE"
+#elif defined( SOFT_SE_AES_FIXSLICED )
+#define BENCH_BACKEND                               "FIXSLICED"
+#else
+#define BENCH_BACKEND                               "BYTE"
+#endif
+
+/*!
+ * Number of timed blocks and key schedules
+ */
+#define BENCH_BLOCKS                                1000000
+#define BENCH_KEYS                                  100000
+
+/*!
+ * Number of chained blocks of the Monte Carlo check
+ */
+#define BENCH_CHAIN_BLOCKS                          100000
+
+/*!
+ * Block after BENCH_CHAIN_BLOCKS chained encryptions of a zero block with the
+ * FIPS-197 appendix C.1 key, given by OpenSSL
+ */
+static const char* const BenchChainResult = "6be20458e702f70e184289ee12e4d27b";
+
+/*!
+ * Encryption known answer
+ */
+typedef struct sBenchVector
+{
+    const char* Key;
+    const char* Plain;
+    const char* Cipher;
+}BenchVector_t;
+
+static const BenchVector_t BenchVectors[] =
+{
+    // FIPS-197 appendix B
+    { "2b7e151628aed2a6abf7158809cf4f3c", "3243f6a8885a308d313198a2e0370734", "3925841d02dc09fbdc118597196a0b32" },
+    // FIPS-197 appendix C.1, C.2 and C.3
+    { "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a" },
+    { "000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff", "dda97ca4864cdfe06eaf70a0ec0d7191" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff", "8ea2b7ca516745bfeafc49904b496089" },
+    // SP 800-38A F.1.1 ECB-AES128
+    { "2b7e151628aed2a6abf7158809cf4f3c", "6bc1bee22e409f96e93d7e117393172a", "3ad77bb40d7a3660a89ecaf32466ef97" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", "ae2d8a571e03ac9c9eb76fac45af8e51", "f5d3d58503b9699de785895a96fdbaaf" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", "30c81c46a35ce411e5fbc1191a0a52ef", "43b1cd7f598ece23881b00e3ed030688" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", "f69f2445df4f9b17ad2b417be66c3710", "7b0c785e27e8ad3f8223207104725dd4" },
+    // SP 800-38A F.1.3 ECB-AES192 and F.1.5 ECB-AES256
+    { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", "6bc1bee22e409f96e93d7e117393172a", "bd334f1d6e45f25ff712a214571fa5cc" },
+    { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", "6bc1bee22e409f96e93d7e117393172a", "f3eed1bdb5d2a03c064b5a7e3db181f8" },
+};
+
+/*!
+ * RFC 4493 AES-CMAC examples, the message is a prefix of the SP 800-38A
+ * plaintext
+ */
+typedef struct sBenchCmacVector
+{
+    uint8_t MsgSize;
+    const char* Mac;
+}BenchCmacVector_t;
+
+static const BenchCmacVector_t BenchCmacVectors[] =
+{
+    { 0, "bb1d6929e95937287fa37d129b756746" },
+    { 16, "070a16b46b4d4144f79bdd9dd04a287c" },
+    { 40, "dfa66747de9ae63030ca32611497c827" },
+    { 64, "51f0bebf7e3b9d92fc49741779363cfe" },
+};
+
+static const char* const BenchCmacKey = "2b7e151628aed2a6abf7158809cf4f3c";
+
+static const char* const BenchCmacMsg = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                                        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+static double BenchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t BenchCycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc( );
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * \brief Converts a hexadecimal string.
+ *
+ * \retval Number of bytes.
+ */
+static uint8_t BenchHex( const char* hex, uint8_t* out )
+{
+    uint8_t size = 0;
+
+    for( ; ( hex[0] != '\0' ) && ( hex[1] != '\0' ); hex += 2 )
+    {
+        unsigned value;
+
+        sscanf( hex, "%2x", &value );
+        out[size++] = ( uint8_t )value;
+    }
+    return size;
+}
+
+static uint32_t BenchCheckVectors( void )
+{
+    uint32_t errors = 0;
+
+    for( uint8_t i = 0; i < sizeof( BenchVectors ) / sizeof( BenchVectors[0] ); i++ )
+    {
+        aes_context ctx;
+        uint8_t key[32];
+        uint8_t plain[16];
+        uint8_t cipher[16];
+        uint8_t out[16];
+        uint8_t keySize = BenchHex( BenchVectors[i].Key, key );
+
+        BenchHex( BenchVectors[i].Plain, plain );
+        BenchHex( BenchVectors[i].Cipher, cipher );
+        if( ( aes_set_key( key, keySize, &ctx ) != 0 ) || ( aes_encrypt( plain, out, &ctx ) != 0 ) ||
+            ( memcmp( out, cipher, 16 ) != 0 ) )
+        {
+            printf( "AES-%u vector %u failed\n", keySize * 8, i );
+            errors++;
+        }
+        // In place
+        aes_encrypt( plain, plain, &ctx );
+        if( memcmp( plain, cipher, 16 ) != 0 )
+        {
+            printf( "AES-%u vector %u failed in place\n", keySize * 8, i );
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckCmac( void )
+{
+    uint32_t errors = 0;
+    aes_context schedule;
+    uint8_t subkeys[2 * AES_CMAC_KEY_LENGTH];
+    uint8_t key[16];
+    uint8_t msg[64];
+
+    BenchHex( BenchCmacKey, key );
+    BenchHex( BenchCmacMsg, msg );
+    aes_set_key( key, 16, &schedule );
+    AES_CMAC_Subkeys( &schedule, subkeys );
+
+    for( uint8_t i = 0; i < sizeof( BenchCmacVectors ) / sizeof( BenchCmacVectors[0] ); i++ )
+    {
+        AES_CMAC_CTX ctx;
+        uint8_t mac[16];
+        uint8_t out[16];
+
+        BenchHex( BenchCmacVectors[i].Mac, mac );
+
+        AES_CMAC_Init( &ctx );
+        AES_CMAC_SetKey( &ctx, key );
+        AES_CMAC_Update( &ctx, msg, BenchCmacVectors[i].MsgSize );
+        AES_CMAC_Final( out, &ctx );
+        if( memcmp( out, mac, 16 ) != 0 )
+        {
+            printf( "CMAC of %u bytes failed\n", BenchCmacVectors[i].MsgSize );
+            errors++;
+        }
+
+        AES_CMAC_InitPrekeyed( &ctx, &schedule, subkeys );
+        AES_CMAC_Update( &ctx, msg, BenchCmacVectors[i].MsgSize );
+        AES_CMAC_Final( out, &ctx );
+        if( memcmp( out, mac, 16 ) != 0 )
+        {
+            printf( "Prekeyed CMAC of %u bytes failed\n", BenchCmacVectors[i].MsgSize );
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckChain( void )
+{
+    aes_context ctx;
+    uint8_t key[16];
+    uint8_t block[16] = { 0 };
+    uint8_t result[16];
+
+    BenchHex( BenchVectors[1].Key, key );
+    BenchHex( BenchChainResult, result );
+    aes_set_key( key, 16, &ctx );
+    for( uint32_t i = 0; i < BENCH_CHAIN_BLOCKS; i++ )
+    {
+        aes_encrypt( block, block, &ctx );
+    }
+    if( memcmp( block, result, 16 ) != 0 )
+    {
+        printf( "Chained encryption failed\n" );
+        return 1;
+    }
+    return 0;
+}
+
+int main( void )
+{
+    aes_context ctx;
+    uint8_t key[16] = { 0 };
+    uint8_t block[16] = { 0 };
+    uint32_t errors = 0;
+    uint64_t keyCycles;
+    uint64_t blockCycles;
+    double keyTime;
+    double blockTime;
+
+    errors += BenchCheckVectors( );
+    errors += BenchCheckCmac( );
+    errors += BenchCheckChain( );
+
+    keyTime = BenchNow( );
+    keyCycles = BenchCycles( );
+    for( uint32_t i = 0; i < BENCH_KEYS; i++ )
+    {
+        key[i & 15] ^= ( uint8_t )i;
+        aes_set_key( key, 16, &ctx );
+    }
+    keyCycles = BenchCycles( ) - keyCycles;
+    keyTime = BenchNow( ) - keyTime;
+
+    blockTime = BenchNow( );
+    blockCycles = BenchCycles( );
+    for( uint32_t i = 0; i < BENCH_BLOCKS; i++ )
+    {
+        aes_encrypt( block, block, &ctx );
+    }
+    blockCycles = BenchCycles( ) - blockCycles;
+    blockTime = BenchNow( ) - blockTime;
+
+    printf( "%-9s key schedule %6.1f cycles, block %6.1f cycles %6.1f ns, %6.1f MB/s, %u errors\n", BENCH_BACKEND,
+            ( double )keyCycles / BENCH_KEYS, ( double )blockCycles / BENCH_BLOCKS, blockTime / BENCH_BLOCKS,
+            16e3 * BENCH_BLOCKS / blockTime, ( unsigned )errors );
+    return ( errors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/*!
+ * \file      se-crypto-bench.c
+ *
+ * \brief     Host benchmark of the frame security with the software secure element
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Times LoRaMacCryptoSecureMessage on a data uplink with 5 bytes of
+ *            FOpts and 51 bytes of FRMPayload, which is the MIC plus encrypt
+ *            work of one frame between the Tx decision and the radio start:
+ *            - LoRaWAN 1.0.x: FRMPayload encrypt with AppSKey and one CMAC
+ *              with NwkSKey;
+ *            - LoRaWAN 1.1.x: FOpts encrypt with NwkSEncKey, FRMPayload
+ *              encrypt with AppSKey and two CMACs, with SNwkSIntKey and
+ *              FNwkSIntKey.
+ *            Between the timed runs the session keys are changed with
+ *            LoRaMacCryptoSetKey and by a write of the key list, as a restore
+ *            of the secure element NVM data does. The digest of all the secured
+ *            frames must not depend on the secure element implementation.
+ *
+ *            Built with -DLORAMAC_KEYSTREAM_CACHE_ENABLED, the keystream of the
+ *            next uplink is computed after each frame, as LoRaMacProcess does
+ *            once the MAC is idle. This idle work is timed apart.
+ *
+ *            The host board runs it, with and without the keystream cache, as
+ *            the se-crypto-bench tests, which expect the digest of the secure
+ *            element before the key schedule cache. From the src directory:
+ *
+ *            S="mac/LoRaMacCrypto.c mac/LoRaMacSerializer.c mac/LoRaMacParser.c \
+ *               peripherals/soft-se/aes.c peripherals/soft-se/aes-ttable.c \
+ *               peripherals/soft-se/aes-fixsliced.c peripherals/soft-se/cmac.c \
+ *               boards/mcu/utilities.c"
+ *            I="-Imac -Isystem -Iradio -Iboards -Iperipherals -Iperipherals/soft-se"
+ *            gcc -O2 $I -DSOFT_SE peripherals/soft-se/bench/se-crypto-bench.c \
+ *                peripherals/soft-se/soft-se.c $S -o se-crypto-bench
+ *            ./se-crypto-bench
+ *
+ *            To compare with an earlier secure element implementation, build
+ *            the same file against it, e.g. from
+ *            git show <rev>:./peripherals/soft-se/soft-se.c. Add
+ *            -DSOFT_SE_AES_TTABLE or -DSOFT_SE_AES_FIXSLICED to time another
+ *            AES backend.
+ */
+#include <stdio.h>
+#include <time.h>
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+#include "utilities.h"
+#include "secure-element.h"
+#include "secure-element-nvm.h"
+#include "LoRaMacCrypto.h"
+
+/*!
+ * Number of timed frames per LoRaWAN version and key set
+ */
+#define BENCH_FRAMES                                100000
+
+/*!
+ * Frame layout
+ */
+#define BENCH_FOPTS_SIZE                            5
+#define BENCH_FRM_PAYLOAD_SIZE                      51
+
+static SecureElementNvmData_t SeNvmData;
+static LoRaMacCryptoNvmData_t CryptoNvmData;
+
+static uint32_t BenchDigest = 2166136261u;
+
+/*!
+ * Timed cycles and time of the frames and of the idle work after them
+ */
+static uint64_t BenchTxCycles;
+static uint64_t BenchIdleCycles;
+static double BenchTxTime;
+static double BenchIdleTime;
+
+void SoftSeHalGetUniqueId( uint8_t* id )
+{
+    memset1( id, 0x5A, SE_EUI_SIZE );
+}
+
+static double BenchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t BenchCycles( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc( );
+#else
+    return 0;
+#endif
+}
+
+static void BenchHash( const uint8_t* data, size_t size )
+{
+    for( size_t i = 0; i < size; i++ )
+    {
+        BenchDigest = ( BenchDigest ^ data[i] ) * 16777619u;
+    }
+}
+
+/*!
+ * \brief Sets the session keys, derived from the seed.
+ *
+ * \param [IN] seed           Key seed
+ * \param [IN] outOfBand      Writes the key list instead of calling LoRaMacCryptoSetKey
+ */
+static void BenchSetSessionKeys( uint8_t seed, bool outOfBand )
+{
+    const KeyIdentifier_t keyIDs[] = { F_NWK_S_INT_KEY, S_NWK_S_INT_KEY, NWK_S_ENC_KEY, APP_S_KEY };
+    uint8_t key[SE_KEY_SIZE];
+
+    for( uint8_t k = 0; k < sizeof( keyIDs ) / sizeof( keyIDs[0] ); k++ )
+    {
+        for( uint8_t i = 0; i < SE_KEY_SIZE; i++ )
+        {
+            key[i] = ( uint8_t )( seed * 31 + k * 17 + i );
+        }
+        if( outOfBand == false )
+        {
+            LoRaMacCryptoSetKey( keyIDs[k], key );
+            continue;
+        }
+        for( uint8_t i = 0; i < NUM_OF_KEYS; i++ )
+        {
+            if( SeNvmData.KeyList[i].KeyID == keyIDs[k] )
+            {
+                memcpy1( SeNvmData.KeyList[i].KeyValue, key, SE_KEY_SIZE );
+            }
+        }
+        // As RestoreNvmData does
+        LoRaMacCryptoResetKeystream( );
+    }
+}
+
+/*!
+ * \brief Secures the uplink frames.
+ *
+ * \param [IN] nbFrames       Number of frames
+ * \param [IN,OUT] fCntUp     Uplink frame counter
+ *
+ * \retval Number of frames which could not be secured.
+ */
+static uint32_t BenchFrames( uint32_t nbFrames, uint32_t* fCntUp )
+{
+    uint8_t buffer[255];
+    uint8_t payload[BENCH_FRM_PAYLOAD_SIZE];
+    LoRaMacMessageData_t macMsg;
+    uint32_t errors = 0;
+    uint64_t c;
+    double t;
+
+    for( uint32_t n = 0; n < nbFrames; n++ )
+    {
+        memset1( ( uint8_t* )&macMsg, 0, sizeof( macMsg ) );
+        macMsg.Buffer = buffer;
+        macMsg.BufSize = sizeof( buffer );
+        macMsg.MHDR.Bits.MType = FRAME_TYPE_DATA_UNCONFIRMED_UP;
+        macMsg.FHDR.DevAddr = 0x26011234;
+        macMsg.FHDR.FCtrl.Bits.FOptsLen = BENCH_FOPTS_SIZE;
+        macMsg.FHDR.FCnt = ( uint16_t )( *fCntUp + 1 );
+        for( uint8_t i = 0; i < BENCH_FOPTS_SIZE; i++ )
+        {
+            macMsg.FHDR.FOpts[i] = ( uint8_t )( n + i );
+        }
+        for( uint8_t i = 0; i < BENCH_FRM_PAYLOAD_SIZE; i++ )
+        {
+            payload[i] = ( uint8_t )( n * 7 + i );
+        }
+        macMsg.FPort = 2;
+        macMsg.FRMPayload = payload;
+        macMsg.FRMPayloadSize = BENCH_FRM_PAYLOAD_SIZE;
+
+        t = BenchNow( );
+        c = BenchCycles( );
+        if( LoRaMacCryptoSecureMessage( *fCntUp + 1, DR_5, 3, &macMsg ) != LORAMAC_CRYPTO_SUCCESS )
+        {
+            errors++;
+        }
+        BenchTxCycles += BenchCycles( ) - c;
+        BenchTxTime += BenchNow( ) - t;
+        *fCntUp += 1;
+        BenchHash( macMsg.Buffer, macMsg.BufSize );
+
+        t = BenchNow( );
+        c = BenchCycles( );
+        if( LoRaMacCryptoPrecomputeKeystream( macMsg.FHDR.DevAddr ) != LORAMAC_CRYPTO_SUCCESS )
+        {
+            errors++;
+        }
+        BenchIdleCycles += BenchCycles( ) - c;
+        BenchIdleTime += BenchNow( ) - t;
+    }
+    return errors;
+}
+
+int main( void )
+{
+    const Version_t versions[] = { { .Value = 0x01000400 }, { .Value = 0x01010100 } };
+    uint32_t errors = 0;
+
+    SecureElementInit( &SeNvmData );
+
+    for( uint8_t v = 0; v < sizeof( versions ) / sizeof( versions[0] ); v++ )
+    {
+        uint32_t fCntUp = 0;
+        uint64_t txCycles = 0;
+        uint64_t idleCycles = 0;
+        double txTime = 0;
+        double idleTime = 0;
+
+        LoRaMacCryptoInit( &CryptoNvmData );
+        LoRaMacCryptoSetLrWanVersion( versions[v] );
+
+        for( uint8_t seed = 0; seed < 4; seed++ )
+        {
+            BenchSetSessionKeys( seed, ( seed % 2 ) == 1 );
+            errors += BenchFrames( 1, &fCntUp );
+
+            BenchTxCycles = BenchIdleCycles = 0;
+            BenchTxTime = BenchIdleTime = 0;
+            errors += BenchFrames( BENCH_FRAMES, &fCntUp );
+            txCycles += BenchTxCycles;
+            idleCycles += BenchIdleCycles;
+            txTime += BenchTxTime;
+            idleTime += BenchIdleTime;
+        }
+        printf( "LoRaWAN 1.%u.x %7.1f ns/frame, %8.1f cycles/frame, idle %7.1f ns/frame, %8.1f cycles/frame\n",
+                versions[v].Fields.Minor, txTime / ( 4 * BENCH_FRAMES ), ( double )txCycles / ( 4 * BENCH_FRAMES ),
+                idleTime / ( 4 * BENCH_FRAMES ), ( double )idleCycles / ( 4 * BENCH_FRAMES ) );
+    }
+    printf( "digest %08X, %u errors\n", ( unsigned )BenchDigest, ( unsigned )errors );
+    return ( errors == 0 ) ? 0 : 1;
+}
@@ -32,6 +32,7 @@ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 DEALINGS WITH THE SOFTWARE
 
 *****************************************************************************/
+#include <stddef.h>
 #include <stdint.h>
 #include "aes.h"
 #include "cmac.h"
@@ -61,6 +62,45 @@ void AES_CMAC_Init( AES_CMAC_CTX* ctx )
     memset1( ctx->X, 0, sizeof ctx->X );
     ctx->M_n = 0;
     memset1( ctx->rijndael.ksch, '\0', 240 );
+    ctx->schedule = &ctx->rijndael;
+    ctx->subkeys  = NULL;
+}
+
+void AES_CMAC_InitPrekeyed( AES_CMAC_CTX* ctx, const aes_context* schedule,
+                            const uint8_t subkeys[2 * AES_CMAC_KEY_LENGTH] )
+{
+    memset1( ctx->X, 0, sizeof ctx->X );
+    ctx->M_n      = 0;
+    ctx->schedule = schedule;
+    ctx->subkeys  = subkeys;
+}
+
+void AES_CMAC_Subkeys( const aes_context* schedule, uint8_t subkeys[2 * AES_CMAC_KEY_LENGTH] )
+{
+    uint8_t* K1 = subkeys;
+    uint8_t* K2 = subkeys + 16;
+
+    /* generate subkey K1 */
+    memset1( K1, '\0', 16 );
+
+    aes_encrypt( K1, K1, schedule );
+
+    if( K1[0] & 0x80 )
+    {
+        LSHIFT( K1, K1 );
+        K1[15] ^= 0x87;
+    }
+    else
+        LSHIFT( K1, K1 );
+
+    /* generate subkey K2 */
+    if( K1[0] & 0x80 )
+    {
+        LSHIFT( K1, K2 );
+        K2[15] ^= 0x87;
+    }
+    else
+        LSHIFT( K1, K2 );
 }
 
 void AES_CMAC_SetKey( AES_CMAC_CTX* ctx, const uint8_t key[AES_CMAC_KEY_LENGTH] )
@@ -83,7 +123,7 @@ void AES_CMAC_Update( AES_CMAC_CTX* ctx, const uint8_t* data, uint32_t len )
         XOR( ctx->M_last, ctx->X );
 
         memcpy1( in, &ctx->X[0], 16 );  // Otherwise it does not look good
-        aes_encrypt( in, in, &ctx->rijndael );
+        aes_encrypt( in, in, ctx->schedule );
         memcpy1( &ctx->X[0], in, 16 );
 
         data += mlen;
@@ -95,7 +135,7 @@ void AES_CMAC_Update( AES_CMAC_CTX* ctx, const uint8_t* data, uint32_t len )
         XOR( data, ctx->X );
 
         memcpy1( in, &ctx->X[0], 16 );  // Otherwise it does not look good
-        aes_encrypt( in, in, &ctx->rijndael );
+        aes_encrypt( in, in, ctx->schedule );
         memcpy1( &ctx->X[0], in, 16 );
 
         data += 16;
@@ -108,47 +148,34 @@ void AES_CMAC_Update( AES_CMAC_CTX* ctx, const uint8_t* data, uint32_t len )
 
 void AES_CMAC_Final( uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX* ctx )
 {
-    uint8_t K[16];
+    uint8_t K[32];
     uint8_t in[16];
-    /* generate subkey K1 */
-    memset1( K, '\0', 16 );
-
-    aes_encrypt( K, K, &ctx->rijndael );
+    const uint8_t* subkeys = ctx->subkeys;
 
-    if( K[0] & 0x80 )
+    if( subkeys == NULL )
     {
-        LSHIFT( K, K );
-        K[15] ^= 0x87;
+        /* generate subkeys K1 and K2 */
+        AES_CMAC_Subkeys( ctx->schedule, K );
+        subkeys = K;
     }
-    else
-        LSHIFT( K, K );
 
     if( ctx->M_n == 16 )
     {
         /* last block was a complete block */
-        XOR( K, ctx->M_last );
+        XOR( subkeys, ctx->M_last );
     }
     else
     {
-        /* generate subkey K2 */
-        if( K[0] & 0x80 )
-        {
-            LSHIFT( K, K );
-            K[15] ^= 0x87;
-        }
-        else
-            LSHIFT( K, K );
-
         /* padding(M_last) */
         ctx->M_last[ctx->M_n] = 0x80;
         while( ++ctx->M_n < 16 )
             ctx->M_last[ctx->M_n] = 0;
 
-        XOR( K, ctx->M_last );
+        XOR( subkeys + 16, ctx->M_last );
     }
     XOR( ctx->M_last, ctx->X );
 
     memcpy1( in, &ctx->X[0], 16 );  // Otherwise it does not look good
-    aes_encrypt( in, digest, &ctx->rijndael );
+    aes_encrypt( in, digest, ctx->schedule );
     memset1( K, 0, sizeof K );
 }
@@ -50,6 +50,10 @@ typedef struct _AES_CMAC_CTX {
             uint8_t        X[16];
             uint8_t        M_last[16];
             uint32_t       M_n;
+            /* Key schedule in use, rijndael or an expanded key kept by the caller */
+            const aes_context * schedule;
+            /* K1 | K2 subkeys of the key schedule, NULL to compute them in Final */
+            const uint8_t *     subkeys;
     } AES_CMAC_CTX;
    
 //#include <sys/cdefs.h>
@@ -57,6 +61,10 @@ typedef struct _AES_CMAC_CTX {
 //__BEGIN_DECLS
 void     AES_CMAC_Init(AES_CMAC_CTX * ctx);
 void     AES_CMAC_SetKey(AES_CMAC_CTX * ctx, const uint8_t key[AES_CMAC_KEY_LENGTH]);
+/* Pre-expanded key schedule and subkeys, used in place of Init and SetKey */
+void     AES_CMAC_InitPrekeyed(AES_CMAC_CTX * ctx, const aes_context * schedule,
+                               const uint8_t subkeys[2 * AES_CMAC_KEY_LENGTH]);
+void     AES_CMAC_Subkeys(const aes_context * schedule, uint8_t subkeys[2 * AES_CMAC_KEY_LENGTH]);
 void     AES_CMAC_Update(AES_CMAC_CTX * ctx, const uint8_t * data, uint32_t len);
           //          __attribute__((__bounded__(__string__,2,3)));
 void     AES_CMAC_Final(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX  * ctx);
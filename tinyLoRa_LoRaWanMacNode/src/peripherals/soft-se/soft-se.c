@@ -25,6 +25,7 @@
  */
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "utilities.h"
 #include "aes.h"
@@ -37,8 +38,53 @@
 #include "se-identity.h"
 #include "soft-se-hal.h"
 
+/*!
+ * Number of expanded AES key schedules kept in RAM. A LoRaWAN 1.1 frame uses
+ * up to 4 session keys.
+ */
+#ifndef SOFT_SE_KEY_CACHE_SIZE
+#define SOFT_SE_KEY_CACHE_SIZE                      4
+#endif
+
+/*!
+ * Expanded AES key schedule of a key
+ */
+typedef struct sKeyCacheItem
+{
+    /*!
+     * Key identifier
+     */
+    KeyIdentifier_t KeyID;
+    /*!
+     * Key value the schedule was expanded from. Checked on every use, as the
+     * key list may be restored from the NVM behind the secure element.
+     */
+    uint8_t KeyValue[SE_KEY_SIZE];
+    /*!
+     * Last use of the item, for the replacement of the least recently used
+     * one. 0 if the item is free.
+     */
+    uint32_t LastUse;
+    /*!
+     * Set when the CMAC subkeys have been computed
+     */
+    bool HasCmacSubkeys;
+    /*!
+     * CMAC subkeys K1 | K2
+     */
+    uint8_t CmacSubkeys[2 * AES_CMAC_KEY_LENGTH];
+    /*!
+     * Expanded key schedule
+     */
+    aes_context Schedule;
+}KeyCacheItem_t;
+
 static SecureElementNvmData_t* SeNvm;
 
+static KeyCacheItem_t KeyCache[SOFT_SE_KEY_CACHE_SIZE];
+
+static uint32_t KeyCacheUseCounter;
+
 /*
  * Local functions
  */
@@ -63,6 +109,67 @@ static SecureElementStatus_t GetKeyByID( KeyIdentifier_t keyID, Key_t** keyItem
     return SECURE_ELEMENT_ERROR_INVALID_KEY_ID;
 }
 
+/*
+ * Removes the expanded key schedule of a key
+ *
+ * \param[IN]  keyID          - Key identifier
+ */
+static void KeyCacheInvalidate( KeyIdentifier_t keyID )
+{
+    for( uint8_t i = 0; i < SOFT_SE_KEY_CACHE_SIZE; i++ )
+    {
+        if( ( KeyCache[i].LastUse != 0 ) && ( KeyCache[i].KeyID == keyID ) )
+        {
+            memset1( ( uint8_t* )&KeyCache[i], 0, sizeof( KeyCacheItem_t ) );
+        }
+    }
+}
+
+/*
+ * Gets the expanded key schedule of a key. On a miss the least recently used
+ * item is replaced by the key expansion.
+ *
+ * \param[IN]  keyID          - Key identifier
+ * \param[OUT] cacheItem      - Key cache item reference
+ * \retval                    - Status of the operation
+ */
+static SecureElementStatus_t GetKeySchedule( KeyIdentifier_t keyID, KeyCacheItem_t** cacheItem )
+{
+    Key_t*                keyItem;
+    KeyCacheItem_t*       item   = &KeyCache[0];
+    SecureElementStatus_t retval = GetKeyByID( keyID, &keyItem );
+
+    if( retval != SECURE_ELEMENT_SUCCESS )
+    {
+        return retval;
+    }
+
+    for( uint8_t i = 0; i < SOFT_SE_KEY_CACHE_SIZE; i++ )
+    {
+        if( ( KeyCache[i].LastUse != 0 ) && ( KeyCache[i].KeyID == keyID ) &&
+            ( memcmp( KeyCache[i].KeyValue, keyItem->KeyValue, SE_KEY_SIZE ) == 0 ) )
+        {
+            item = &KeyCache[i];
+            item->LastUse = ++KeyCacheUseCounter;
+            *cacheItem = item;
+            return SECURE_ELEMENT_SUCCESS;
+        }
+        if( KeyCache[i].LastUse < item->LastUse )
+        {
+            item = &KeyCache[i];
+        }
+    }
+
+    item->KeyID = keyID;
+    memcpy1( item->KeyValue, keyItem->KeyValue, SE_KEY_SIZE );
+    item->LastUse = ++KeyCacheUseCounter;
+    item->HasCmacSubkeys = false;
+    aes_set_key( item->KeyValue, SE_KEY_SIZE, &item->Schedule );
+
+    *cacheItem = item;
+    return SECURE_ELEMENT_SUCCESS;
+}
+
 /*
  * Computes a CMAC of a message using provided initial Bx block
  *
@@ -86,14 +193,17 @@ static SecureElementStatus_t ComputeCmac( uint8_t* micBxBuffer, uint8_t* buffer,
     uint8_t Cmac[16];
     AES_CMAC_CTX aesCmacCtx[1];
 
-    AES_CMAC_Init( aesCmacCtx );
-
-    Key_t*                keyItem;
-    SecureElementStatus_t retval = GetKeyByID( keyID, &keyItem );
+    KeyCacheItem_t*       cacheItem;
+    SecureElementStatus_t retval = GetKeySchedule( keyID, &cacheItem );
 
     if( retval == SECURE_ELEMENT_SUCCESS )
     {
-        AES_CMAC_SetKey( aesCmacCtx, keyItem->KeyValue );
+        if( cacheItem->HasCmacSubkeys == false )
+        {
+            AES_CMAC_Subkeys( &cacheItem->Schedule, cacheItem->CmacSubkeys );
+            cacheItem->HasCmacSubkeys = true;
+        }
+        AES_CMAC_InitPrekeyed( aesCmacCtx, &cacheItem->Schedule, cacheItem->CmacSubkeys );
 
         if( micBxBuffer != NULL )
         {
@@ -152,6 +262,7 @@ SecureElementStatus_t SecureElementInit( SecureElementNvmData_t* nvm )
 
     // Initialize data
     memcpy1( ( uint8_t* )SeNvm, ( uint8_t* )&seNvmInit, sizeof( seNvmInit ) );
+    memset1( ( uint8_t* )KeyCache, 0, sizeof( KeyCache ) );
 
 #if !defined( SECURE_ELEMENT_PRE_PROVISIONED )
 #if( STATIC_DEVICE_EUI == 0 )
@@ -173,6 +284,8 @@ SecureElementStatus_t SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
     {
         if( SeNvm->KeyList[i].KeyID == keyID )
         {
+            KeyCacheInvalidate( keyID );
+
             if( ( keyID == MC_KEY_0 ) || ( keyID == MC_KEY_1 ) || ( keyID == MC_KEY_2 ) || ( keyID == MC_KEY_3 ) )
             {  // Decrypt the key if its a Mckey
                 SecureElementStatus_t retval           = SECURE_ELEMENT_ERROR;
@@ -244,21 +357,16 @@ SecureElementStatus_t SecureElementAesEncrypt( uint8_t* buffer, uint16_t size, K
         return SECURE_ELEMENT_ERROR_BUF_SIZE;
     }
 
-    aes_context aesContext;
-    memset1( aesContext.ksch, '\0', 240 );
-
-    Key_t*                pItem;
-    SecureElementStatus_t retval = GetKeyByID( keyID, &pItem );
+    KeyCacheItem_t*       cacheItem;
+    SecureElementStatus_t retval = GetKeySchedule( keyID, &cacheItem );
 
     if( retval == SECURE_ELEMENT_SUCCESS )
     {
-        aes_set_key( pItem->KeyValue, 16, &aesContext );
-
         uint8_t block = 0;
 
         while( size != 0 )
         {
-            aes_encrypt( &buffer[block], &encBuffer[block], &aesContext );
+            aes_encrypt( &buffer[block], &encBuffer[block], &cacheItem->Schedule );
             block = block + 16;
             size  = size - 16;
         }
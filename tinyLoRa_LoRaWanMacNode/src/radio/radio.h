@@ -38,6 +38,7 @@ typedef enum
 {
     MODEM_FSK = 0,
     MODEM_LORA,
+    MODEM_LR_FHSS,                                  // Tx only, SX126x radios only
 }RadioModems_t;
 
 /*!
@@ -106,6 +107,13 @@ typedef struct
      * \brief  Gnss Done Done callback prototype.
     */
     void    ( *WifiDone )( void );
+
+    /*!
+     * \brief Channel sense done callback prototype.
+     *
+     * \param [IN] channelFree    [true: Channel is free, false: Channel is not free]
+     */
+    void ( *ChannelSenseDone )( bool channelFree );
 }RadioEvents_t;
 
 /*!
@@ -219,13 +227,21 @@ struct Radio_s
      *                          FSK : 0
      *                          LoRa: [0: 125 kHz, 1: 250 kHz,
      *                                 2: 500 kHz, 3: Reserved]
+     *                          LR-FHSS: Operating channel width
+     *                                [0: 39.06 kHz, 1: 85.94 kHz,
+     *                                 2: 136.72 kHz, 3: 183.59 kHz,
+     *                                 4: 335.94 kHz, 5: 386.72 kHz,
+     *                                 6: 722.66 kHz, 7: 773.44 kHz,
+     *                                 8: 1523.4 kHz, 9: 1574.2 kHz]
      * \param [IN] datarate     Sets the Datarate
      *                          FSK : 600..300000 bits/s
      *                          LoRa: [6: 64, 7: 128, 8: 256, 9: 512,
      *                                10: 1024, 11: 2048, 12: 4096  chips]
+     *                          LR-FHSS: N/A ( set to 0 )
      * \param [IN] coderate     Sets the coding rate (LoRa only)
      *                          FSK : N/A ( set to 0 )
      *                          LoRa: [1: 4/5, 2: 4/6, 3: 4/7, 4: 4/8]
+     *                          LR-FHSS: [0: 5/6, 1: 2/3, 2: 1/2, 3: 1/3]
      * \param [IN] preambleLen  Sets the preamble length
      *                          FSK : Number of bytes
      *                          LoRa: Length in symbols (the hardware adds 4 more symbols)
@@ -234,6 +250,7 @@ struct Radio_s
      * \param [IN] freqHopOn    Enables disables the intra-packet frequency hopping
      *                          FSK : N/A ( set to 0 )
      *                          LoRa: [0: OFF, 1: ON]
+     *                          LR-FHSS: Hopping grid [0: 3.9 kHz, 1: 25.4 kHz]
      * \param [IN] hopPeriod    Number of symbols between each hop
      *                          FSK : N/A ( set to 0 )
      *                          LoRa: Number of symbols
@@ -271,6 +288,8 @@ struct Radio_s
      * \param [IN] coderate     Sets the coding rate (LoRa only)
      *                          FSK : N/A ( set to 0 )
      *                          LoRa: [1: 4/5, 2: 4/6, 3: 4/7, 4: 4/8]
+     *                          LR-FHSS: [0: 5/6, 1: 2/3, 2: 1/2, 3: 1/3]
+     *                          ( bandwidth gives the operating channel width )
      * \param [IN] preambleLen  Sets the Preamble length
      *                          FSK : Number of bytes
      *                          LoRa: Length in symbols (the hardware adds 4 more symbols)
@@ -400,6 +419,57 @@ struct Radio_s
      * \param [in]  sleepTime     Structure describing sleep timeout value
      */
     void ( *SetRxDutyCycle ) ( uint32_t rxTime, uint32_t sleepTime );
+    /*!
+     * \brief Sets the buffer the received payloads are read into. The RxDone
+     *        callback payload then points into this buffer.
+     *
+     * \remark Available on SX126x and simulated radios only. Can be called
+     *         from the RxDone callback to receive the next payload into
+     *         another buffer.
+     *
+     * \param [IN] buffer Caller owned buffer of at least 255 bytes
+     *                    [NULL: radio driver internal buffer]
+     */
+    void ( *SetRxBuffer )( uint8_t *buffer );
+    /*!
+     * \brief Uploads a packet to the radio ahead of its transmission. The
+     *        radio is left in standby until SendPrepared is called.
+     *
+     * \remark Available on SX126x radios only.
+     *          Any other radio operation ( Rx, Sleep, Cad, Send... ) discards
+     *          the prepared packet.
+     *
+     * \param [IN]: buffer     Buffer pointer
+     * \param [IN]: size       Buffer size
+     */
+    void ( *PrepareTx )( uint8_t *buffer, uint8_t size );
+    /*!
+     * \brief Starts the transmission of the packet uploaded by PrepareTx
+     *        using the current Tx configuration
+     *
+     * \remark Available on SX126x radios only.
+     *
+     * \retval status [true: transmission started,
+     *                 false: no prepared packet, Send must be used]
+     */
+    bool ( *SendPrepared )( void );
+    /*!
+     * \brief Starts checking if the channel is free for the given time
+     *        without blocking. The result is reported by the
+     *        ChannelSenseDone callback and the radio is put in sleep mode.
+     *
+     * \remark Available on SX126x radios only.
+     *          The FSK modem is used and the RSSI is sampled by IrqProcess
+     *          after each sampling timer event.
+     *          Any other radio operation aborts the channel sense without
+     *          calling ChannelSenseDone.
+     *
+     * \param [IN] freq                Channel RF frequency in Hertz
+     * \param [IN] rxBandwidth         Rx bandwidth in Hertz
+     * \param [IN] rssiThresh          RSSI threshold in dBm
+     * \param [IN] maxCarrierSenseTime Max time in milliseconds while the RSSI is measured
+     */
+    void ( *StartChannelSense )( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime );
 };
 
 /*!
@@ -0,0 +1,1157 @@
+/*!
+ * \file      radio.c
+ *
+ * \brief     Simulated radio driver implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include <string.h>
+#include <stddef.h>
+#include "radio.h"
+#include "sim-medium.h"
+#include "sim-radio.h"
+
+/*!
+ * LoRa sync word of public networks
+ */
+#define SIM_RADIO_LORA_SYNCWORD_PUBLIC              0x34
+
+/*!
+ * LoRa sync word of private networks
+ */
+#define SIM_RADIO_LORA_SYNCWORD_PRIVATE             0x12
+
+/*!
+ * FSK sync word length [bytes]
+ */
+#define SIM_RADIO_FSK_SYNCWORD_LENGTH               3
+
+/*!
+ * Number of symbols of a channel activity detection
+ */
+#define SIM_RADIO_CAD_SYMBOLS                       2
+
+/*!
+ * Radio IRQ flags
+ */
+#define SIM_RADIO_IRQ_TX_DONE                       0x01
+#define SIM_RADIO_IRQ_RX_DONE                       0x02
+#define SIM_RADIO_IRQ_RX_ERROR                      0x04
+#define SIM_RADIO_IRQ_RX_TIMEOUT                    0x08
+#define SIM_RADIO_IRQ_TX_TIMEOUT                    0x10
+#define SIM_RADIO_IRQ_CAD_DONE                      0x20
+#define SIM_RADIO_IRQ_CHANNEL_SENSE_DONE            0x40
+
+/*!
+ * Radio operating modes
+ */
+typedef enum
+{
+    SIM_RADIO_MODE_SLEEP = 0,
+    SIM_RADIO_MODE_STDBY,
+    SIM_RADIO_MODE_TX,
+    SIM_RADIO_MODE_RX,
+    SIM_RADIO_MODE_RX_DC,
+    SIM_RADIO_MODE_CAD,
+    SIM_RADIO_MODE_CHANNEL_SENSE,
+}SimRadioModes_t;
+
+/*!
+ * Radio settings of a direction
+ */
+typedef struct sSimRadioSettings
+{
+    RadioModems_t Modem;
+    int8_t Power;
+    uint32_t Fdev;
+    uint32_t Bandwidth;
+    uint32_t Datarate;
+    uint8_t Coderate;
+    uint16_t PreambleLen;
+    uint16_t SymbTimeout;
+    bool FixLen;
+    uint8_t PayloadLen;
+    bool CrcOn;
+    bool IqInverted;
+    bool RxContinuous;
+}SimRadioSettings_t;
+
+/*!
+ * \brief Initializes the radio
+ *
+ * \param [IN] events Structure containing the driver callback functions
+ */
+void RadioInit( RadioEvents_t *events );
+
+/*!
+ * Return current radio status
+ *
+ * \retval status Radio status.[RF_IDLE, RF_RX_RUNNING, RF_TX_RUNNING]
+ */
+RadioState_t RadioGetStatus( void );
+
+/*!
+ * \brief Configures the radio with the given modem
+ *
+ * \param [IN] modem Modem to be used [0: FSK, 1: LoRa]
+ */
+void RadioSetModem( RadioModems_t modem );
+
+/*!
+ * \brief Sets the channel frequency
+ *
+ * \param [IN] freq         Channel RF frequency
+ */
+void RadioSetChannel( uint32_t freq );
+
+/*!
+ * \brief Checks if the channel is free at the current time
+ *
+ * \param [IN] freq                Channel RF frequency in Hertz
+ * \param [IN] rxBandwidth         Rx bandwidth in Hertz
+ * \param [IN] rssiThresh          RSSI threshold in dBm
+ * \param [IN] maxCarrierSenseTime Max time in milliseconds while the RSSI is measured
+ *
+ * \retval isFree         [true: Channel is free, false: Channel is not free]
+ */
+bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime );
+
+/*!
+ * \brief Generates a 32 bits random value from the medium random generator
+ *
+ * \retval randomValue    32 bits random value
+ */
+uint32_t RadioRandom( void );
+
+/*!
+ * \brief Sets the reception parameters
+ */
+void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                         uint32_t datarate, uint8_t coderate,
+                         uint32_t bandwidthAfc, uint16_t preambleLen,
+                         uint16_t symbTimeout, bool fixLen,
+                         uint8_t payloadLen,
+                         bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                         bool iqInverted, bool rxContinuous );
+
+/*!
+ * \brief Sets the transmission parameters
+ */
+void RadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                        uint32_t bandwidth, uint32_t datarate,
+                        uint8_t coderate, uint16_t preambleLen,
+                        bool fixLen, bool crcOn, bool freqHopOn,
+                        uint8_t hopPeriod, bool iqInverted, uint32_t timeout );
+
+/*!
+ * \brief Checks if the given RF frequency is supported by the hardware
+ *
+ * \param [IN] frequency RF frequency to be checked
+ * \retval isSupported [true: supported, false: unsupported]
+ */
+bool RadioCheckRfFrequency( uint32_t frequency );
+
+/*!
+ * \brief Computes the packet time on air in ms for the given payload
+ */
+uint32_t RadioTimeOnAir( RadioModems_t modem, uint32_t bandwidth,
+                         uint32_t datarate, uint8_t coderate,
+                         uint16_t preambleLen, bool fixLen, uint8_t payloadLen,
+                         bool crcOn );
+
+/*!
+ * \brief Sends the buffer of size
+ *
+ * \param [IN]: buffer     Buffer pointer
+ * \param [IN]: size       Buffer size
+ */
+void RadioSend( uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Sets the radio in sleep mode
+ */
+void RadioSleep( void );
+
+/*!
+ * \brief Sets the radio in standby mode
+ */
+void RadioStandby( void );
+
+/*!
+ * \brief Sets the radio in reception mode for the given time
+ * \param [IN] timeout Reception timeout [ms]
+ *                     [0: continuous, others timeout]
+ */
+void RadioRx( uint32_t timeout );
+
+/*!
+ * \brief Start a Channel Activity Detection
+ */
+void RadioStartCad( void );
+
+/*!
+ * \brief Sets the radio in continuous wave transmission mode
+ *
+ * \param [IN]: freq       Channel RF frequency
+ * \param [IN]: power      Sets the output power [dBm]
+ * \param [IN]: time       Transmission mode timeout [s]
+ */
+void RadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time );
+
+/*!
+ * \brief Reads the current RSSI value
+ *
+ * \retval rssiValue Current RSSI value in [dBm]
+ */
+int16_t RadioRssi( RadioModems_t modem );
+
+/*!
+ * \brief Writes the radio register at the specified address
+ *
+ * \param [IN]: addr Register address
+ * \param [IN]: data New register value
+ */
+void RadioWrite( uint32_t addr, uint8_t data );
+
+/*!
+ * \brief Reads the radio register at the specified address
+ *
+ * \param [IN]: addr Register address
+ * \retval data Register value
+ */
+uint8_t RadioRead( uint32_t addr );
+
+/*!
+ * \brief Writes multiple radio registers starting at address
+ *
+ * \param [IN] addr   First Radio register address
+ * \param [IN] buffer Buffer containing the new register's values
+ * \param [IN] size   Number of registers to be written
+ */
+void RadioWriteBuffer( uint32_t addr, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Reads multiple radio registers starting at address
+ *
+ * \param [IN] addr First Radio register address
+ * \param [OUT] buffer Buffer where to copy the registers data
+ * \param [IN] size Number of registers to be read
+ */
+void RadioReadBuffer( uint32_t addr, uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Sets the maximum payload length.
+ *
+ * \param [IN] modem      Radio modem to be used [0: FSK, 1: LoRa]
+ * \param [IN] max        Maximum payload length in bytes
+ */
+void RadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max );
+
+/*!
+ * \brief Sets the network to public or private. Updates the sync byte.
+ *
+ * \param [IN] enable if true, it enables a public network
+ */
+void RadioSetPublicNetwork( bool enable );
+
+/*!
+ * \brief Gets the time required for the board plus radio to get out of sleep.[ms]
+ *
+ * \retval time Radio plus board wakeup time in ms.
+ */
+uint32_t RadioGetWakeupTime( void );
+
+/*!
+ * \brief Reports the radio events the medium has signaled
+ */
+void RadioIrqProcess( void );
+
+/*!
+ * \brief Sets the radio in reception mode for the given time. Same as RadioRx.
+ *
+ * \param [IN] timeout Reception timeout [ms]
+ *                     [0: continuous, others timeout]
+ */
+void RadioRxBoosted( uint32_t timeout );
+
+/*!
+ * \brief Sets the Rx duty cycle management parameters
+ *
+ * \param [in]  rxTime        Reception period in RTC steps of 15.625 us
+ * \param [in]  sleepTime     Sleep period in RTC steps of 15.625 us
+ */
+void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime );
+
+/*!
+ * \brief Sets the buffer the received payloads are read into
+ *
+ * \param [IN] buffer Caller owned buffer of at least 255 bytes
+ *                    [NULL: radio driver internal buffer]
+ */
+void RadioSetRxBuffer( uint8_t *buffer );
+
+/*!
+ * \brief Uploads a packet to the radio ahead of its transmission
+ *
+ * \param [IN]: buffer     Buffer pointer
+ * \param [IN]: size       Buffer size
+ */
+void RadioPrepareTx( uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Starts the transmission of the packet uploaded by RadioPrepareTx
+ *
+ * \retval status [true: transmission started, false: no prepared packet]
+ */
+bool RadioSendPrepared( void );
+
+/*!
+ * \brief Starts checking if the channel is free for the given time without
+ *        blocking
+ *
+ * \param [IN] freq                Channel RF frequency in Hertz
+ * \param [IN] rxBandwidth         Rx bandwidth in Hertz
+ * \param [IN] rssiThresh          RSSI threshold in dBm
+ * \param [IN] maxCarrierSenseTime Max time in milliseconds while the RSSI is measured
+ */
+void RadioStartChannelSense( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime );
+
+/*!
+ * Radio driver structure initialization
+ */
+const struct Radio_s Radio =
+{
+    RadioInit,
+    RadioGetStatus,
+    RadioSetModem,
+    RadioSetChannel,
+    RadioIsChannelFree,
+    RadioRandom,
+    RadioSetRxConfig,
+    RadioSetTxConfig,
+    RadioCheckRfFrequency,
+    RadioTimeOnAir,
+    RadioSend,
+    RadioSleep,
+    RadioStandby,
+    RadioRx,
+    RadioStartCad,
+    RadioSetTxContinuousWave,
+    RadioRssi,
+    RadioWrite,
+    RadioRead,
+    RadioWriteBuffer,
+    RadioReadBuffer,
+    RadioSetMaxPayloadLength,
+    RadioSetPublicNetwork,
+    RadioGetWakeupTime,
+    RadioIrqProcess,
+    RadioRxBoosted,
+    RadioSetRxDutyCycle,
+    RadioSetRxBuffer,
+    RadioPrepareTx,
+    RadioSendPrepared,
+    RadioStartChannelSense
+};
+
+/*!
+ * Simulated radio context
+ */
+static struct
+{
+    SimNode_t Node;
+    RadioEvents_t* Events;
+    SimRadioModes_t Mode;
+    RadioModems_t Modem;
+    uint32_t Frequency;
+    bool PublicNetwork;
+    uint8_t MaxPayloadLength;
+    SimRadioSettings_t Rx;
+    SimRadioSettings_t Tx;
+    /*!
+     * Reception closed when no LoRa preamble or FSK sync word is detected by
+     * then
+     */
+    SimTime_t PreambleDeadline;
+    /*!
+     * Reception closed by then
+     */
+    SimTime_t RxDeadline;
+    /*!
+     * Set when the single receptions ignore the symbol timeout
+     */
+    bool IsSymbolTimeoutDisabled;
+    SimTime_t DutyCycleRxTime;
+    SimTime_t DutyCycleSleepTime;
+    bool IsDutyCycleListening;
+    bool IsContinuousWave;
+    bool CadActivity;
+    uint32_t ChannelSenseFrequency;
+    uint32_t ChannelSenseBandwidth;
+    int16_t ChannelSenseThreshold;
+    SimTime_t ChannelSenseStart;
+    bool ChannelFree;
+    volatile uint8_t IrqFlags;
+    uint8_t* RxBuffer;
+    uint8_t RxPayload[255];
+    uint8_t RxSize;
+    int16_t RxRssi;
+    int8_t RxSnr;
+    bool IsTxPrepared;
+    uint8_t TxPrepared[255];
+    uint8_t TxPreparedSize;
+    uint8_t Registers[SIM_RADIO_NB_REGISTERS];
+}SimRadio;
+
+/*!
+ * \brief Gets the LoRa bandwidth in Hz
+ *
+ * \param [IN] bandwidth LoRa bandwidth [0: 125 kHz, 1: 250 kHz, 2: 500 kHz]
+ *
+ * \retval bandwidthInHz Bandwidth in Hz
+ */
+static uint32_t SimRadioGetLoRaBandwidthInHz( uint32_t bandwidth )
+{
+    return 125000UL << ( ( bandwidth > 2 ) ? 2 : bandwidth );
+}
+
+/*!
+ * \brief Computes the symbol time ( FSK: byte time )
+ *
+ * \param [IN] settings Radio settings
+ *
+ * \retval time Symbol time [us]
+ */
+static SimTime_t SimRadioGetSymbolTime( const SimRadioSettings_t* settings )
+{
+    if( settings->Modem == MODEM_LORA )
+    {
+        return ( ( SimTime_t )1000000 << settings->Datarate ) / SimRadioGetLoRaBandwidthInHz( settings->Bandwidth );
+    }
+    return ( SimTime_t )8000000 / ( ( settings->Datarate != 0 ) ? settings->Datarate : 1 );
+}
+
+static uint32_t SimRadioGetGfskTimeOnAirNumerator( uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    return ( preambleLen << 3 ) +
+           ( ( fixLen == false ) ? 8 : 0 ) +
+           ( SIM_RADIO_FSK_SYNCWORD_LENGTH << 3 ) +
+           ( ( payloadLen + ( ( crcOn == true ) ? 2 : 0 ) ) << 3 );
+}
+
+static uint32_t SimRadioGetLoRaTimeOnAirNumerator( uint32_t bandwidth,
+                              uint32_t datarate, uint8_t coderate,
+                              uint16_t preambleLen, bool fixLen, uint8_t payloadLen,
+                              bool crcOn )
+{
+    int32_t crDenom           = coderate + 4;
+    bool    lowDatareOptimize = false;
+
+    // Ensure that the preamble length is at least 12 symbols when using SF5 or
+    // SF6
+    if( ( datarate == 5 ) || ( datarate == 6 ) )
+    {
+        if( preambleLen < 12 )
+        {
+            preambleLen = 12;
+        }
+    }
+
+    if( ( ( bandwidth == 0 ) && ( ( datarate == 11 ) || ( datarate == 12 ) ) ) ||
+        ( ( bandwidth == 1 ) && ( datarate == 12 ) ) )
+    {
+        lowDatareOptimize = true;
+    }
+
+    int32_t ceilDenominator;
+    int32_t ceilNumerator = ( payloadLen << 3 ) +
+                            ( crcOn ? 16 : 0 ) -
+                            ( 4 * datarate ) +
+                            ( fixLen ? 0 : 20 );
+
+    if( datarate <= 6 )
+    {
+        ceilDenominator = 4 * datarate;
+    }
+    else
+    {
+        ceilNumerator += 8;
+
+        if( lowDatareOptimize == true )
+        {
+            ceilDenominator = 4 * ( datarate - 2 );
+        }
+        else
+        {
+            ceilDenominator = 4 * datarate;
+        }
+    }
+
+    if( ceilNumerator < 0 )
+    {
+        ceilNumerator = 0;
+    }
+
+    // Perform integral ceil()
+    int32_t intermediate =
+        ( ( ceilNumerator + ceilDenominator - 1 ) / ceilDenominator ) * crDenom + preambleLen + 12;
+
+    if( datarate <= 6 )
+    {
+        intermediate += 2;
+    }
+
+    return ( uint32_t )( ( 4 * intermediate + 1 ) * ( 1 << ( datarate - 2 ) ) );
+}
+
+/*!
+ * \brief Computes the time on air of a frame sent with the transmission
+ *        settings
+ *
+ * \param [IN] size Payload size
+ *
+ * \retval time Time on air [us]
+ */
+static SimTime_t SimRadioGetTxTimeOnAir( uint8_t size )
+{
+    const SimRadioSettings_t* tx = &SimRadio.Tx;
+
+    if( tx->Modem == MODEM_LORA )
+    {
+        return ( ( SimTime_t )SimRadioGetLoRaTimeOnAirNumerator( tx->Bandwidth, tx->Datarate, tx->Coderate, tx->PreambleLen,
+                                                                 tx->FixLen, size, tx->CrcOn ) * 1000000 ) /
+               SimRadioGetLoRaBandwidthInHz( tx->Bandwidth );
+    }
+    return ( ( SimTime_t )SimRadioGetGfskTimeOnAirNumerator( tx->PreambleLen, tx->FixLen, size, tx->CrcOn ) * 1000000 ) /
+           tx->Datarate;
+}
+
+/*!
+ * \brief Computes the preamble time of a frame sent with the transmission
+ *        settings
+ *
+ * \retval time Preamble time [us]
+ */
+static SimTime_t SimRadioGetTxPreambleTime( void )
+{
+    if( SimRadio.Tx.Modem == MODEM_LORA )
+    {
+        // The hardware adds 4.25 symbols
+        return ( ( ( SimTime_t )SimRadio.Tx.PreambleLen * 4 ) + 17 ) * SimRadioGetSymbolTime( &SimRadio.Tx ) / 4;
+    }
+    return ( SimTime_t )SimRadio.Tx.PreambleLen * SimRadioGetSymbolTime( &SimRadio.Tx );
+}
+
+/*!
+ * \brief Builds the medium modulation of the given settings
+ *
+ * \param [IN]  settings   Radio settings
+ * \param [OUT] modulation Medium modulation
+ */
+static void SimRadioGetModulation( const SimRadioSettings_t* settings, SimModulation_t* modulation )
+{
+    modulation->Modem = settings->Modem;
+    modulation->Frequency = SimRadio.Frequency;
+    modulation->Datarate = settings->Datarate;
+    modulation->IqInverted = settings->IqInverted;
+    modulation->SyncWord = ( SimRadio.PublicNetwork == true ) ? SIM_RADIO_LORA_SYNCWORD_PUBLIC : SIM_RADIO_LORA_SYNCWORD_PRIVATE;
+
+    if( settings->Modem == MODEM_LORA )
+    {
+        modulation->Bandwidth = SimRadioGetLoRaBandwidthInHz( settings->Bandwidth );
+    }
+    else if( settings == &SimRadio.Rx )
+    {
+        // Single sided reception bandwidth
+        modulation->Bandwidth = settings->Bandwidth << 1;
+    }
+    else
+    {
+        // Carson's rule
+        modulation->Bandwidth = ( settings->Fdev << 1 ) + settings->Datarate;
+    }
+}
+
+/*!
+ * \brief Stops the running operation. A frame on air is not recalled.
+ *
+ * \param [IN] mode Mode to enter [SIM_RADIO_MODE_SLEEP, SIM_RADIO_MODE_STDBY]
+ */
+static void SimRadioStop( SimRadioModes_t mode )
+{
+    SimMediumStopRx( &SimRadio.Node );
+    SimMediumStopTimer( &SimRadio.Node );
+    SimRadio.IsContinuousWave = false;
+    SimRadio.IsTxPrepared = false;
+    SimRadio.Mode = mode;
+}
+
+/*!
+ * \brief Starts the node timer on the earliest reception deadline
+ */
+static void SimRadioUpdateRxTimer( void )
+{
+    SimTime_t deadline = SimRadio.RxDeadline;
+
+    if( SimRadio.PreambleDeadline < deadline )
+    {
+        deadline = SimRadio.PreambleDeadline;
+    }
+    if( deadline == SIM_TIME_NEVER )
+    {
+        SimMediumStopTimer( &SimRadio.Node );
+    }
+    else
+    {
+        SimMediumSetTimer( &SimRadio.Node, deadline );
+    }
+}
+
+/*!
+ * \brief Starts the transmission of a frame with the transmission settings
+ *
+ * \param [IN] modulation Frame modulation
+ * \param [IN] timeOnAir  Frame duration
+ * \param [IN] buffer     Payload
+ * \param [IN] size       Payload size
+ */
+static void SimRadioTransmit( const SimModulation_t* modulation, SimTime_t timeOnAir, const uint8_t* buffer, uint8_t size )
+{
+    SimRadio.Mode = SIM_RADIO_MODE_TX;
+    if( SimMediumSend( &SimRadio.Node, modulation, SimRadio.Tx.Power, SimMediumGetTime( ),
+                       SimRadioGetTxPreambleTime( ), timeOnAir, buffer, size ) == false )
+    {
+        SimRadio.Mode = SIM_RADIO_MODE_STDBY;
+        SimRadio.IrqFlags |= SIM_RADIO_IRQ_TX_TIMEOUT;
+    }
+}
+
+/*!
+ * \brief Medium callback: frame sent by the radio is over
+ */
+static void SimRadioOnTxDone( SimNode_t* node )
+{
+    if( SimRadio.Mode != SIM_RADIO_MODE_TX )
+    {
+        return;
+    }
+    SimRadio.Mode = SIM_RADIO_MODE_STDBY;
+    if( SimRadio.IsContinuousWave == true )
+    {
+        SimRadio.IsContinuousWave = false;
+        SimRadio.IrqFlags |= SIM_RADIO_IRQ_TX_TIMEOUT;
+    }
+    else
+    {
+        SimRadio.IrqFlags |= SIM_RADIO_IRQ_TX_DONE;
+    }
+}
+
+/*!
+ * \brief Medium callback: the radio locked on a preamble
+ */
+static void SimRadioOnPreambleDetected( SimNode_t* node )
+{
+    if( SimRadio.Mode == SIM_RADIO_MODE_RX )
+    {
+        // The symbol timeout applies until a LoRa preamble is detected, or
+        // until the end of the FSK sync word
+        SimTime_t syncWordEnd = SimMediumGetTime( ) +
+                                ( ( SimTime_t )( SimRadio.Rx.PreambleLen + SIM_RADIO_FSK_SYNCWORD_LENGTH ) *
+                                  SimRadioGetSymbolTime( &SimRadio.Rx ) );
+
+        if( ( SimRadio.Rx.Modem == MODEM_LORA ) || ( syncWordEnd <= SimRadio.PreambleDeadline ) )
+        {
+            SimRadio.PreambleDeadline = SIM_TIME_NEVER;
+            SimRadioUpdateRxTimer( );
+        }
+    }
+    else if( SimRadio.Mode == SIM_RADIO_MODE_RX_DC )
+    {
+        // Stay in reception until the end of the frame
+        SimMediumStopTimer( &SimRadio.Node );
+    }
+}
+
+/*!
+ * \brief Ends a reception on frame end
+ */
+static void SimRadioOnRxEnd( void )
+{
+    SimMediumStopTimer( &SimRadio.Node );
+    if( ( SimRadio.Mode == SIM_RADIO_MODE_RX_DC ) || ( SimRadio.Rx.RxContinuous == false ) )
+    {
+        SimMediumStopRx( &SimRadio.Node );
+        SimRadio.Mode = SIM_RADIO_MODE_STDBY;
+    }
+}
+
+/*!
+ * \brief Medium callback: frame received
+ */
+static void SimRadioOnRxDone( SimNode_t* node, const uint8_t* payload, uint8_t size, const SimRxInfo_t* info )
+{
+    if( ( SimRadio.Mode != SIM_RADIO_MODE_RX ) && ( SimRadio.Mode != SIM_RADIO_MODE_RX_DC ) )
+    {
+        return;
+    }
+    SimRadioOnRxEnd( );
+
+    if( size > SimRadio.MaxPayloadLength )
+    {
+        SimRadio.IrqFlags |= SIM_RADIO_IRQ_RX_ERROR;
+        return;
+    }
+    memcpy( SimRadio.RxBuffer, payload, size );
+    SimRadio.RxSize = size;
+    SimRadio.RxRssi = info->Rssi;
+    SimRadio.RxSnr = ( info->Modulation.Modem == MODEM_LORA ) ? info->Snr : 0;
+    SimRadio.IrqFlags |= SIM_RADIO_IRQ_RX_DONE;
+}
+
+/*!
+ * \brief Medium callback: frame lost
+ */
+static void SimRadioOnRxError( SimNode_t* node, const SimRxInfo_t* info )
+{
+    if( ( SimRadio.Mode != SIM_RADIO_MODE_RX ) && ( SimRadio.Mode != SIM_RADIO_MODE_RX_DC ) )
+    {
+        return;
+    }
+    SimRadioOnRxEnd( );
+    SimRadio.IrqFlags |= SIM_RADIO_IRQ_RX_ERROR;
+}
+
+/*!
+ * \brief Medium callback: node timer expired
+ */
+static void SimRadioOnTimer( SimNode_t* node )
+{
+    SimModulation_t modulation;
+
+    switch( SimRadio.Mode )
+    {
+        case SIM_RADIO_MODE_RX:
+        {
+            SimRadioStop( SIM_RADIO_MODE_STDBY );
+            SimRadio.IrqFlags |= SIM_RADIO_IRQ_RX_TIMEOUT;
+            break;
+        }
+        case SIM_RADIO_MODE_RX_DC:
+        {
+            if( SimRadio.IsDutyCycleListening == true )
+            {
+                SimMediumStopRx( &SimRadio.Node );
+                SimRadio.IsDutyCycleListening = false;
+                SimMediumSetTimer( &SimRadio.Node, SimMediumGetTime( ) + SimRadio.DutyCycleSleepTime );
+            }
+            else
+            {
+                SimRadio.IsDutyCycleListening = true;
+                SimMediumSetTimer( &SimRadio.Node, SimMediumGetTime( ) + SimRadio.DutyCycleRxTime );
+                SimRadioGetModulation( &SimRadio.Rx, &modulation );
+                SimMediumStartRx( &SimRadio.Node, &modulation );
+            }
+            break;
+        }
+        case SIM_RADIO_MODE_CAD:
+        {
+            SimRadioGetModulation( &SimRadio.Rx, &modulation );
+            SimRadio.CadActivity = SimMediumDetectActivity( &SimRadio.Node, &modulation );
+            SimRadio.Mode = SIM_RADIO_MODE_STDBY;
+            SimRadio.IrqFlags |= SIM_RADIO_IRQ_CAD_DONE;
+            break;
+        }
+        case SIM_RADIO_MODE_CHANNEL_SENSE:
+        {
+            SimRadio.ChannelFree = SimMediumGetRssi( &SimRadio.Node, SimRadio.ChannelSenseFrequency, SimRadio.ChannelSenseBandwidth,
+                                                     SimRadio.ChannelSenseStart, SimMediumGetTime( ) ) < SimRadio.ChannelSenseThreshold;
+            SimRadio.Mode = SIM_RADIO_MODE_SLEEP;
+            SimRadio.IrqFlags |= SIM_RADIO_IRQ_CHANNEL_SENSE_DONE;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+SimNode_t* SimRadioGetNode( void )
+{
+    return &SimRadio.Node;
+}
+
+bool SimRadioIsIrqPending( void )
+{
+    return SimRadio.IrqFlags != 0;
+}
+
+void SimRadioSetSymbolTimeoutEnabled( bool enable )
+{
+    SimRadio.IsSymbolTimeoutDisabled = ( enable == false );
+}
+
+void RadioInit( RadioEvents_t *events )
+{
+    SimRadio.Events = events;
+
+    SimRadio.Node.TxDone = SimRadioOnTxDone;
+    SimRadio.Node.PreambleDetected = SimRadioOnPreambleDetected;
+    SimRadio.Node.RxDone = SimRadioOnRxDone;
+    SimRadio.Node.RxError = SimRadioOnRxError;
+    SimRadio.Node.Timer = SimRadioOnTimer;
+    SimRadio.Node.IsGateway = false;
+    SimMediumAddNode( &SimRadio.Node );
+
+    SimRadioStop( SIM_RADIO_MODE_STDBY );
+    SimRadio.IrqFlags = 0;
+    SimRadio.MaxPayloadLength = 0xFF;
+    if( SimRadio.RxBuffer == NULL )
+    {
+        SimRadio.RxBuffer = SimRadio.RxPayload;
+    }
+}
+
+RadioState_t RadioGetStatus( void )
+{
+    switch( SimRadio.Mode )
+    {
+        case SIM_RADIO_MODE_TX:
+            return RF_TX_RUNNING;
+        case SIM_RADIO_MODE_RX:
+        case SIM_RADIO_MODE_RX_DC:
+        case SIM_RADIO_MODE_CHANNEL_SENSE:
+            return RF_RX_RUNNING;
+        case SIM_RADIO_MODE_CAD:
+            return RF_CAD;
+        default:
+            return RF_IDLE;
+    }
+}
+
+void RadioSetModem( RadioModems_t modem )
+{
+    SimRadio.Modem = modem;
+}
+
+void RadioSetChannel( uint32_t freq )
+{
+    SimRadio.Frequency = freq;
+}
+
+bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+    SimTime_t now = SimMediumGetTime( );
+
+    SimRadioStop( SIM_RADIO_MODE_SLEEP );
+    // The virtual clock does not advance within a driver call
+    return SimMediumGetRssi( &SimRadio.Node, freq, rxBandwidth << 1, now, now ) < rssiThresh;
+}
+
+uint32_t RadioRandom( void )
+{
+    SimRadio.IsTxPrepared = false;
+    return SimMediumRandom( );
+}
+
+void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                         uint32_t datarate, uint8_t coderate,
+                         uint32_t bandwidthAfc, uint16_t preambleLen,
+                         uint16_t symbTimeout, bool fixLen,
+                         uint8_t payloadLen,
+                         bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                         bool iqInverted, bool rxContinuous )
+{
+    RadioStandby( );
+    RadioSetModem( modem );
+
+    SimRadio.Rx.Modem = modem;
+    SimRadio.Rx.Bandwidth = bandwidth;
+    SimRadio.Rx.Datarate = datarate;
+    SimRadio.Rx.Coderate = coderate;
+    SimRadio.Rx.PreambleLen = preambleLen;
+    SimRadio.Rx.SymbTimeout = ( rxContinuous == true ) ? 0 : symbTimeout;
+    SimRadio.Rx.FixLen = fixLen;
+    SimRadio.Rx.PayloadLen = payloadLen;
+    SimRadio.Rx.CrcOn = crcOn;
+    SimRadio.Rx.IqInverted = iqInverted;
+    SimRadio.Rx.RxContinuous = rxContinuous;
+
+    SimRadio.MaxPayloadLength = ( fixLen == true ) ? payloadLen : 0xFF;
+}
+
+void RadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                        uint32_t bandwidth, uint32_t datarate,
+                        uint8_t coderate, uint16_t preambleLen,
+                        bool fixLen, bool crcOn, bool freqHopOn,
+                        uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+    RadioStandby( );
+    RadioSetModem( modem );
+
+    SimRadio.Tx.Modem = modem;
+    SimRadio.Tx.Power = power;
+    SimRadio.Tx.Fdev = fdev;
+    SimRadio.Tx.Bandwidth = bandwidth;
+    SimRadio.Tx.Datarate = datarate;
+    SimRadio.Tx.Coderate = coderate;
+    SimRadio.Tx.PreambleLen = preambleLen;
+    SimRadio.Tx.FixLen = fixLen;
+    SimRadio.Tx.CrcOn = crcOn;
+    SimRadio.Tx.IqInverted = iqInverted;
+}
+
+bool RadioCheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+uint32_t RadioTimeOnAir( RadioModems_t modem, uint32_t bandwidth,
+                         uint32_t datarate, uint8_t coderate,
+                         uint16_t preambleLen, bool fixLen, uint8_t payloadLen,
+                         bool crcOn )
+{
+    uint32_t numerator = 0;
+    uint32_t denominator = 1;
+
+    switch( modem )
+    {
+    case MODEM_FSK:
+        {
+            numerator   = 1000U * SimRadioGetGfskTimeOnAirNumerator( preambleLen, fixLen, payloadLen, crcOn );
+            denominator = datarate;
+        }
+        break;
+    case MODEM_LORA:
+        {
+            numerator   = 1000U * SimRadioGetLoRaTimeOnAirNumerator( bandwidth, datarate,
+                                                                     coderate, preambleLen,
+                                                                     fixLen, payloadLen, crcOn );
+            denominator = SimRadioGetLoRaBandwidthInHz( bandwidth );
+        }
+        break;
+    default:
+        // LR-FHSS is not simulated
+        break;
+    }
+    // Perform integral ceil()
+    return ( numerator + denominator - 1 ) / denominator;
+}
+
+void RadioSend( uint8_t *buffer, uint8_t size )
+{
+    SimModulation_t modulation;
+
+    SimRadioStop( SIM_RADIO_MODE_STDBY );
+
+    if( ( SimRadio.Tx.Modem != MODEM_LORA ) && ( SimRadio.Tx.Modem != MODEM_FSK ) )
+    {
+        SimRadio.IrqFlags |= SIM_RADIO_IRQ_TX_TIMEOUT;
+        return;
+    }
+    SimRadioGetModulation( &SimRadio.Tx, &modulation );
+    SimRadioTransmit( &modulation, SimRadioGetTxTimeOnAir( size ), buffer, size );
+}
+
+void RadioSleep( void )
+{
+    SimRadioStop( SIM_RADIO_MODE_SLEEP );
+}
+
+void RadioStandby( void )
+{
+    SimRadioStop( SIM_RADIO_MODE_STDBY );
+}
+
+void RadioRx( uint32_t timeout )
+{
+    SimModulation_t modulation;
+    SimTime_t now = SimMediumGetTime( );
+
+    SimRadioStop( SIM_RADIO_MODE_STDBY );
+
+    SimRadio.RxDeadline = ( timeout != 0 ) ? ( now + ( ( SimTime_t )timeout * 1000 ) ) : SIM_TIME_NEVER;
+    SimRadio.PreambleDeadline = SIM_TIME_NEVER;
+    if( ( SimRadio.Rx.SymbTimeout != 0 ) && ( SimRadio.IsSymbolTimeoutDisabled == false ) )
+    {
+        SimRadio.PreambleDeadline = now + ( SimRadio.Rx.SymbTimeout * SimRadioGetSymbolTime( &SimRadio.Rx ) );
+    }
+    SimRadio.Mode = SIM_RADIO_MODE_RX;
+    SimRadioUpdateRxTimer( );
+
+    SimRadioGetModulation( &SimRadio.Rx, &modulation );
+    SimMediumStartRx( &SimRadio.Node, &modulation );
+}
+
+void RadioStartCad( void )
+{
+    SimRadioStop( SIM_RADIO_MODE_CAD );
+    SimMediumSetTimer( &SimRadio.Node, SimMediumGetTime( ) + ( SIM_RADIO_CAD_SYMBOLS * SimRadioGetSymbolTime( &SimRadio.Rx ) ) );
+}
+
+void RadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time )
+{
+    SimModulation_t modulation;
+
+    SimRadioStop( SIM_RADIO_MODE_STDBY );
+
+    // Unmodulated carrier no receiver locks on
+    modulation.Modem = MODEM_FSK;
+    modulation.Frequency = freq;
+    modulation.Bandwidth = 1000;
+    modulation.Datarate = 1;
+    modulation.IqInverted = false;
+    modulation.SyncWord = 0;
+
+    SimRadio.Frequency = freq;
+    SimRadio.Tx.Power = power;
+    SimRadio.IsContinuousWave = true;
+    SimRadioTransmit( &modulation, ( SimTime_t )time * 1000000, NULL, 0 );
+}
+
+int16_t RadioRssi( RadioModems_t modem )
+{
+    SimModulation_t modulation;
+    SimTime_t now = SimMediumGetTime( );
+
+    SimRadioGetModulation( &SimRadio.Rx, &modulation );
+    return SimMediumGetRssi( &SimRadio.Node, SimRadio.Frequency, modulation.Bandwidth, now, now );
+}
+
+void RadioWrite( uint32_t addr, uint8_t data )
+{
+    SimRadio.Registers[addr % SIM_RADIO_NB_REGISTERS] = data;
+}
+
+uint8_t RadioRead( uint32_t addr )
+{
+    return SimRadio.Registers[addr % SIM_RADIO_NB_REGISTERS];
+}
+
+void RadioWriteBuffer( uint32_t addr, uint8_t *buffer, uint8_t size )
+{
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        RadioWrite( addr + i, buffer[i] );
+    }
+}
+
+void RadioReadBuffer( uint32_t addr, uint8_t *buffer, uint8_t size )
+{
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        buffer[i] = RadioRead( addr + i );
+    }
+}
+
+void RadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+    SimRadio.MaxPayloadLength = max;
+}
+
+void RadioSetPublicNetwork( bool enable )
+{
+    SimRadio.PublicNetwork = enable;
+}
+
+uint32_t RadioGetWakeupTime( void )
+{
+    return SIM_RADIO_WAKEUP_TIME;
+}
+
+void RadioIrqProcess( void )
+{
+    uint8_t irqFlags = SimRadio.IrqFlags;
+    RadioEvents_t* events = SimRadio.Events;
+
+    SimRadio.IrqFlags = 0;
+
+    if( ( irqFlags == 0 ) || ( events == NULL ) )
+    {
+        return;
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_TX_DONE ) != 0 ) && ( events->TxDone != NULL ) )
+    {
+        events->TxDone( );
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_RX_DONE ) != 0 ) && ( events->RxDone != NULL ) )
+    {
+        events->RxDone( SimRadio.RxBuffer, SimRadio.RxSize, SimRadio.RxRssi, SimRadio.RxSnr );
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_RX_ERROR ) != 0 ) && ( events->RxError != NULL ) )
+    {
+        events->RxError( );
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_CAD_DONE ) != 0 ) && ( events->CadDone != NULL ) )
+    {
+        events->CadDone( SimRadio.CadActivity );
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_RX_TIMEOUT ) != 0 ) && ( events->RxTimeout != NULL ) )
+    {
+        events->RxTimeout( );
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_TX_TIMEOUT ) != 0 ) && ( events->TxTimeout != NULL ) )
+    {
+        events->TxTimeout( );
+    }
+    if( ( ( irqFlags & SIM_RADIO_IRQ_CHANNEL_SENSE_DONE ) != 0 ) && ( events->ChannelSenseDone != NULL ) )
+    {
+        events->ChannelSenseDone( SimRadio.ChannelFree );
+    }
+}
+
+void RadioRxBoosted( uint32_t timeout )
+{
+    RadioRx( timeout );
+}
+
+void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime )
+{
+    SimModulation_t modulation;
+
+    SimRadioStop( SIM_RADIO_MODE_RX_DC );
+
+    SimRadio.DutyCycleRxTime = ( ( SimTime_t )rxTime * 15625 ) / 1000;
+    SimRadio.DutyCycleSleepTime = ( ( SimTime_t )sleepTime * 15625 ) / 1000;
+    SimRadio.IsDutyCycleListening = true;
+    SimMediumSetTimer( &SimRadio.Node, SimMediumGetTime( ) + SimRadio.DutyCycleRxTime );
+
+    SimRadioGetModulation( &SimRadio.Rx, &modulation );
+    SimMediumStartRx( &SimRadio.Node, &modulation );
+}
+
+void RadioSetRxBuffer( uint8_t *buffer )
+{
+    SimRadio.RxBuffer = ( buffer != NULL ) ? buffer : SimRadio.RxPayload;
+}
+
+void RadioPrepareTx( uint8_t *buffer, uint8_t size )
+{
+    SimRadioStop( SIM_RADIO_MODE_STDBY );
+
+    memcpy( SimRadio.TxPrepared, buffer, size );
+    SimRadio.TxPreparedSize = size;
+    SimRadio.IsTxPrepared = true;
+}
+
+bool RadioSendPrepared( void )
+{
+    if( SimRadio.IsTxPrepared == false )
+    {
+        return false;
+    }
+    RadioSend( SimRadio.TxPrepared, SimRadio.TxPreparedSize );
+    return true;
+}
+
+void RadioStartChannelSense( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+    SimRadioStop( SIM_RADIO_MODE_CHANNEL_SENSE );
+
+    SimRadio.ChannelSenseFrequency = freq;
+    SimRadio.ChannelSenseBandwidth = rxBandwidth << 1;
+    SimRadio.ChannelSenseThreshold = rssiThresh;
+    SimRadio.ChannelSenseStart = SimMediumGetTime( );
+    SimMediumSetTimer( &SimRadio.Node, SimRadio.ChannelSenseStart + ( ( SimTime_t )maxCarrierSenseTime * 1000 ) );
+}
@@ -0,0 +1,619 @@
+/*!
+ * \file      sim-medium.c
+ *
+ * \brief     Simulated radio medium: virtual clock, nodes and channel model
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include <math.h>
+#include <string.h>
+#include <stddef.h>
+#include "sim-medium.h"
+
+/*!
+ * Default seed of the medium random generator
+ */
+#define SIM_MEDIUM_DEFAULT_SEED                     0x2545F491
+
+/*!
+ * Frame slot states
+ */
+typedef enum
+{
+    SIM_FRAME_FREE = 0,
+    SIM_FRAME_PENDING,                              // Scheduled, not yet started
+    SIM_FRAME_ON_AIR,
+    SIM_FRAME_DONE,                                 // Kept for collision checks
+}SimFrameState_t;
+
+/*!
+ * Frame sent on the medium
+ */
+typedef struct sSimFrame
+{
+    SimFrameState_t State;
+    SimNode_t* Sender;
+    SimModulation_t Modulation;
+    int8_t Power;
+    SimTime_t StartTime;
+    SimTime_t PreambleTime;
+    SimTime_t EndTime;
+    uint8_t Size;
+    uint8_t Payload[255];
+}SimFrame_t;
+
+/*!
+ * Receiver locked on a frame
+ */
+typedef struct sSimLock
+{
+    SimNode_t* Node;
+    SimFrame_t* Frame;
+}SimLock_t;
+
+/*!
+ * Medium context
+ */
+static struct
+{
+    SimChannelModel_t Model;
+    SimTime_t Now;
+    uint32_t RandomState;
+    SimNode_t* Nodes;
+    SimFrame_t Frames[SIM_MEDIUM_MAX_FRAMES];
+    SimLock_t Locks[SIM_MEDIUM_MAX_LOCKS];
+}SimMedium;
+
+/*!
+ * \brief Computes the power of a frame received by a node
+ *
+ * \param [IN] frame Frame
+ * \param [IN] node  Receiver
+ *
+ * \retval power Received power [dBm]
+ */
+static float SimMediumGetRxPower( const SimFrame_t* frame, const SimNode_t* node )
+{
+    float dx = ( float )frame->Sender->X - ( float )node->X;
+    float dy = ( float )frame->Sender->Y - ( float )node->Y;
+    float distance = sqrtf( ( dx * dx ) + ( dy * dy ) );
+
+    if( distance < 1.0f )
+    {
+        distance = 1.0f;
+    }
+    return ( float )frame->Power + frame->Sender->AntennaGain + node->AntennaGain -
+           ( SimMedium.Model.RefPathLoss + ( 10.0f * SimMedium.Model.PathLossExponent * log10f( distance ) ) );
+}
+
+/*!
+ * \brief Computes the receiver noise floor
+ *
+ * \param [IN] bandwidth Receiver bandwidth [Hz]
+ *
+ * \retval noise Noise floor [dBm]
+ */
+static float SimMediumGetNoise( uint32_t bandwidth )
+{
+    return -174.0f + ( 10.0f * log10f( ( float )bandwidth ) ) + SimMedium.Model.NoiseFigure;
+}
+
+/*!
+ * \brief Gets the SNR needed to demodulate the given modulation
+ *
+ * \param [IN] modulation Modulation
+ *
+ * \retval snr Minimum SNR [dB]
+ */
+static float SimMediumGetMinSnr( const SimModulation_t* modulation )
+{
+    if( modulation->Modem == MODEM_LORA )
+    {
+        // SF5: -2.5 dB ... SF12: -20 dB
+        return -2.5f * ( float )( ( int32_t )modulation->Datarate - 4 );
+    }
+    return SIM_MEDIUM_FSK_MIN_SNR;
+}
+
+/*!
+ * \brief Gets the time a receiver needs to lock on a frame preamble
+ *
+ * \param [IN] modulation Frame modulation
+ *
+ * \retval time Detection time
+ */
+static SimTime_t SimMediumGetDetectTime( const SimModulation_t* modulation )
+{
+    if( modulation->Modem == MODEM_LORA )
+    {
+        return ( ( SimTime_t )SIM_MEDIUM_DETECT_SYMBOLS << modulation->Datarate ) * 1000000 / modulation->Bandwidth;
+    }
+    // One byte
+    return ( SimTime_t )8000000 / modulation->Datarate;
+}
+
+/*!
+ * \brief Checks if a node can receive a frame
+ *
+ * \param [IN] node  Receiver
+ * \param [IN] frame Frame
+ *
+ * \retval match [true: modulation handled by the receiver]
+ */
+static bool SimMediumIsMatching( const SimNode_t* node, const SimFrame_t* frame )
+{
+    const SimModulation_t* rx = &node->RxModulation;
+    const SimModulation_t* tx = &frame->Modulation;
+
+    if( ( node->IsGateway == true ) && ( tx->Modem == MODEM_LORA ) )
+    {
+        return ( tx->IqInverted == false ) && ( tx->SyncWord == rx->SyncWord );
+    }
+    if( ( tx->Modem != rx->Modem ) || ( tx->Frequency != rx->Frequency ) || ( tx->Datarate != rx->Datarate ) )
+    {
+        return false;
+    }
+    if( tx->Modem == MODEM_LORA )
+    {
+        return ( tx->Bandwidth == rx->Bandwidth ) && ( tx->IqInverted == rx->IqInverted ) &&
+               ( tx->SyncWord == rx->SyncWord );
+    }
+    return true;
+}
+
+/*!
+ * \brief Locks a node on a frame when it can receive it
+ *
+ * \param [IN] node  Receiver
+ * \param [IN] frame Frame
+ */
+static void SimMediumTryLock( SimNode_t* node, SimFrame_t* frame )
+{
+    if( ( node->IsListening == false ) || ( node->IsTransmitting == true ) ||
+        ( ( node->IsGateway == false ) && ( node->NbLocks != 0 ) ) ||
+        ( SimMediumIsMatching( node, frame ) == false ) )
+    {
+        return;
+    }
+    if( SimMediumGetRxPower( frame, node ) < ( SimMediumGetNoise( frame->Modulation.Bandwidth ) +
+                                               SimMediumGetMinSnr( &frame->Modulation ) ) )
+    {
+        return;
+    }
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_LOCKS; i++ )
+    {
+        if( SimMedium.Locks[i].Node == NULL )
+        {
+            SimMedium.Locks[i].Node = node;
+            SimMedium.Locks[i].Frame = frame;
+            node->NbLocks++;
+            if( node->PreambleDetected != NULL )
+            {
+                node->PreambleDetected( node );
+            }
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Drops the frames a node is locked on
+ *
+ * \param [IN] node Receiver
+ */
+static void SimMediumDropLocks( SimNode_t* node )
+{
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_LOCKS; i++ )
+    {
+        if( SimMedium.Locks[i].Node == node )
+        {
+            SimMedium.Locks[i].Node = NULL;
+        }
+    }
+    node->NbLocks = 0;
+}
+
+/*!
+ * \brief Checks if a received frame survives the frames overlapping it
+ *
+ * \param [IN] node  Receiver
+ * \param [IN] frame Received frame
+ * \param [IN] power Received frame power [dBm]
+ *
+ * \retval survives [true: frame received, false: collision]
+ */
+static bool SimMediumSurvivesCollisions( const SimNode_t* node, const SimFrame_t* frame, float power )
+{
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        const SimFrame_t* other = &SimMedium.Frames[i];
+
+        if( ( other == frame ) || ( other->State == SIM_FRAME_FREE ) || ( other->State == SIM_FRAME_PENDING ) ||
+            ( other->Modulation.Frequency != frame->Modulation.Frequency ) ||
+            ( other->StartTime >= frame->EndTime ) || ( other->EndTime <= frame->StartTime ) )
+        {
+            continue;
+        }
+
+        float margin = power - SimMediumGetRxPower( other, node );
+
+        if( ( other->Modulation.Modem == MODEM_LORA ) && ( frame->Modulation.Modem == MODEM_LORA ) &&
+            ( ( other->Modulation.Datarate != frame->Modulation.Datarate ) ||
+              ( other->Modulation.Bandwidth != frame->Modulation.Bandwidth ) ) )
+        {
+            // Quasi orthogonal spreading factors
+            if( margin < -SIM_MEDIUM_INTER_SF_REJECTION )
+            {
+                return false;
+            }
+        }
+        else if( margin < SimMedium.Model.CaptureThreshold )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Processes a frame start
+ *
+ * \param [IN] frame Frame
+ */
+static void SimMediumOnFrameStart( SimFrame_t* frame )
+{
+    frame->State = SIM_FRAME_ON_AIR;
+
+    // Half-duplex sender
+    frame->Sender->IsTransmitting = true;
+    SimMediumDropLocks( frame->Sender );
+
+    for( SimNode_t* node = SimMedium.Nodes; node != NULL; node = node->Next )
+    {
+        SimMediumTryLock( node, frame );
+    }
+}
+
+/*!
+ * \brief Processes a frame end
+ *
+ * \param [IN] frame Frame
+ */
+static void SimMediumOnFrameEnd( SimFrame_t* frame )
+{
+    SimNode_t* sender = frame->Sender;
+
+    frame->State = SIM_FRAME_DONE;
+
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_LOCKS; i++ )
+    {
+        SimLock_t* lock = &SimMedium.Locks[i];
+        SimNode_t* node = lock->Node;
+        SimRxInfo_t info;
+
+        if( ( node == NULL ) || ( lock->Frame != frame ) )
+        {
+            continue;
+        }
+        lock->Node = NULL;
+        node->NbLocks--;
+
+        float power = SimMediumGetRxPower( frame, node );
+        float snr = power - SimMediumGetNoise( frame->Modulation.Bandwidth );
+
+        info.Modulation = frame->Modulation;
+        info.Rssi = ( int16_t )floorf( power + 0.5f );
+        info.Snr = ( int8_t )( ( snr > 127.0f ) ? 127 : floorf( snr + 0.5f ) );
+        info.StartTime = frame->StartTime;
+        info.EndTime = frame->EndTime;
+
+        if( ( SimMediumSurvivesCollisions( node, frame, power ) == true ) &&
+            ( ( SimMediumRandom( ) % 1000 ) >= SimMedium.Model.PacketErrorRate ) )
+        {
+            if( node->RxDone != NULL )
+            {
+                node->RxDone( node, frame->Payload, frame->Size, &info );
+            }
+        }
+        else if( node->RxError != NULL )
+        {
+            node->RxError( node, &info );
+        }
+    }
+
+    sender->IsTransmitting = false;
+    if( sender->TxDone != NULL )
+    {
+        sender->TxDone( sender );
+    }
+
+    // Free the frames no frame on air may still collide with
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        SimFrame_t* done = &SimMedium.Frames[i];
+        bool isOverlapped = false;
+
+        if( done->State != SIM_FRAME_DONE )
+        {
+            continue;
+        }
+        for( uint8_t j = 0; j < SIM_MEDIUM_MAX_FRAMES; j++ )
+        {
+            if( ( SimMedium.Frames[j].State == SIM_FRAME_ON_AIR ) &&
+                ( SimMedium.Frames[j].StartTime < done->EndTime ) )
+            {
+                isOverlapped = true;
+                break;
+            }
+        }
+        if( isOverlapped == false )
+        {
+            done->State = SIM_FRAME_FREE;
+        }
+    }
+}
+
+void SimMediumInit( const SimChannelModel_t* model )
+{
+    memset( &SimMedium, 0, sizeof( SimMedium ) );
+    SimMedium.Model = *model;
+    SimMedium.RandomState = ( model->Seed != 0 ) ? model->Seed : SIM_MEDIUM_DEFAULT_SEED;
+}
+
+void SimMediumAddNode( SimNode_t* node )
+{
+    for( SimNode_t* cur = SimMedium.Nodes; cur != NULL; cur = cur->Next )
+    {
+        if( cur == node )
+        {
+            return;
+        }
+    }
+    node->IsListening = false;
+    node->NbLocks = 0;
+    node->IsTransmitting = false;
+    node->TimerTime = SIM_TIME_NEVER;
+    node->Next = SimMedium.Nodes;
+    SimMedium.Nodes = node;
+}
+
+SimTime_t SimMediumGetTime( void )
+{
+    return SimMedium.Now;
+}
+
+SimTime_t SimMediumGetNextEventTime( void )
+{
+    SimTime_t next = SIM_TIME_NEVER;
+
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        const SimFrame_t* frame = &SimMedium.Frames[i];
+
+        if( ( frame->State == SIM_FRAME_PENDING ) && ( frame->StartTime < next ) )
+        {
+            next = frame->StartTime;
+        }
+        else if( ( frame->State == SIM_FRAME_ON_AIR ) && ( frame->EndTime < next ) )
+        {
+            next = frame->EndTime;
+        }
+    }
+    for( SimNode_t* node = SimMedium.Nodes; node != NULL; node = node->Next )
+    {
+        if( node->TimerTime < next )
+        {
+            next = node->TimerTime;
+        }
+    }
+    return next;
+}
+
+void SimMediumRunUntil( SimTime_t time )
+{
+    while( true )
+    {
+        SimFrame_t* frameEnd = NULL;
+        SimFrame_t* frameStart = NULL;
+        SimNode_t* timerNode = NULL;
+        SimTime_t next = SIM_TIME_NEVER;
+
+        // At equal times frames end first, then start, then timers expire
+        for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+        {
+            SimFrame_t* frame = &SimMedium.Frames[i];
+
+            if( ( frame->State == SIM_FRAME_ON_AIR ) && ( frame->EndTime < next ) )
+            {
+                next = frame->EndTime;
+                frameEnd = frame;
+            }
+        }
+        for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+        {
+            SimFrame_t* frame = &SimMedium.Frames[i];
+
+            if( ( frame->State == SIM_FRAME_PENDING ) && ( frame->StartTime < next ) )
+            {
+                next = frame->StartTime;
+                frameEnd = NULL;
+                frameStart = frame;
+            }
+        }
+        for( SimNode_t* node = SimMedium.Nodes; node != NULL; node = node->Next )
+        {
+            if( node->TimerTime < next )
+            {
+                next = node->TimerTime;
+                frameEnd = NULL;
+                frameStart = NULL;
+                timerNode = node;
+            }
+        }
+
+        if( next > time )
+        {
+            break;
+        }
+        SimMedium.Now = next;
+
+        if( frameEnd != NULL )
+        {
+            SimMediumOnFrameEnd( frameEnd );
+        }
+        else if( frameStart != NULL )
+        {
+            SimMediumOnFrameStart( frameStart );
+        }
+        else if( timerNode != NULL )
+        {
+            timerNode->TimerTime = SIM_TIME_NEVER;
+            if( timerNode->Timer != NULL )
+            {
+                timerNode->Timer( timerNode );
+            }
+        }
+    }
+    if( time > SimMedium.Now )
+    {
+        SimMedium.Now = time;
+    }
+}
+
+bool SimMediumSend( SimNode_t* node, const SimModulation_t* modulation, int8_t power, SimTime_t startTime,
+                    SimTime_t preambleTime, SimTime_t timeOnAir, const uint8_t* payload, uint8_t size )
+{
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        SimFrame_t* frame = &SimMedium.Frames[i];
+
+        if( frame->State != SIM_FRAME_FREE )
+        {
+            continue;
+        }
+        frame->State = SIM_FRAME_PENDING;
+        frame->Sender = node;
+        frame->Modulation = *modulation;
+        frame->Power = power;
+        frame->StartTime = ( startTime > SimMedium.Now ) ? startTime : SimMedium.Now;
+        frame->PreambleTime = preambleTime;
+        frame->EndTime = frame->StartTime + timeOnAir;
+        frame->Size = size;
+        if( ( payload != NULL ) && ( size != 0 ) )
+        {
+            memcpy( frame->Payload, payload, size );
+        }
+
+        if( frame->StartTime == SimMedium.Now )
+        {
+            SimMediumOnFrameStart( frame );
+        }
+        return true;
+    }
+    return false;
+}
+
+void SimMediumStartRx( SimNode_t* node, const SimModulation_t* modulation )
+{
+    node->RxModulation = *modulation;
+    node->IsListening = true;
+
+    if( node->IsTransmitting == true )
+    {
+        return;
+    }
+    // Frames still in their preamble
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        SimFrame_t* frame = &SimMedium.Frames[i];
+
+        if( ( frame->State == SIM_FRAME_ON_AIR ) &&
+            ( ( SimMedium.Now + SimMediumGetDetectTime( &frame->Modulation ) ) <= ( frame->StartTime + frame->PreambleTime ) ) )
+        {
+            SimMediumTryLock( node, frame );
+        }
+    }
+}
+
+void SimMediumStopRx( SimNode_t* node )
+{
+    node->IsListening = false;
+    SimMediumDropLocks( node );
+}
+
+bool SimMediumIsLocked( SimNode_t* node )
+{
+    return node->NbLocks != 0;
+}
+
+void SimMediumSetTimer( SimNode_t* node, SimTime_t time )
+{
+    node->TimerTime = ( time > SimMedium.Now ) ? time : SimMedium.Now;
+}
+
+void SimMediumStopTimer( SimNode_t* node )
+{
+    node->TimerTime = SIM_TIME_NEVER;
+}
+
+int16_t SimMediumGetRssi( SimNode_t* node, uint32_t frequency, uint32_t bandwidth, SimTime_t start, SimTime_t end )
+{
+    float rssi = SimMediumGetNoise( bandwidth );
+
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        const SimFrame_t* frame = &SimMedium.Frames[i];
+
+        if( ( frame->State != SIM_FRAME_ON_AIR ) && ( frame->State != SIM_FRAME_DONE ) )
+        {
+            continue;
+        }
+        if( ( frame->Sender == node ) || ( frame->Modulation.Frequency != frequency ) ||
+            ( frame->StartTime > end ) || ( frame->EndTime <= start ) )
+        {
+            continue;
+        }
+        float power = SimMediumGetRxPower( frame, node );
+
+        if( power > rssi )
+        {
+            rssi = power;
+        }
+    }
+    return ( int16_t )floorf( rssi + 0.5f );
+}
+
+bool SimMediumDetectActivity( SimNode_t* node, const SimModulation_t* modulation )
+{
+    for( uint8_t i = 0; i < SIM_MEDIUM_MAX_FRAMES; i++ )
+    {
+        const SimFrame_t* frame = &SimMedium.Frames[i];
+
+        if( ( frame->State != SIM_FRAME_ON_AIR ) || ( frame->Sender == node ) ||
+            ( frame->Modulation.Modem != modulation->Modem ) ||
+            ( frame->Modulation.Frequency != modulation->Frequency ) ||
+            ( frame->Modulation.Bandwidth != modulation->Bandwidth ) ||
+            ( frame->Modulation.Datarate != modulation->Datarate ) )
+        {
+            continue;
+        }
+        if( SimMediumGetRxPower( frame, node ) >= ( SimMediumGetNoise( frame->Modulation.Bandwidth ) +
+                                                    SimMediumGetMinSnr( &frame->Modulation ) ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t SimMediumRandom( void )
+{
+    // xorshift32
+    uint32_t x = SimMedium.RandomState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    SimMedium.RandomState = x;
+    return x;
+}
@@ -0,0 +1,361 @@
+/*!
+ * \file      sim-medium.h
+ *
+ * \brief     Simulated radio medium: virtual clock, nodes and channel model
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The medium connects any number of simulated nodes ( the radio
+ *            driven by LoRaMac, other end-devices, gateway endpoints ) in a
+ *            single process. Time only advances through SimMediumRunUntil,
+ *            which processes the frame start, frame end and node timer
+ *            events in time order and calls the node callbacks.
+ *            A host board RTC built on top of the medium returns
+ *            SimMediumGetTime and its main loop runs the medium until the
+ *            next RTC alarm or SimMediumGetNextEventTime, whichever comes
+ *            first.
+ *
+ *            Channel model:
+ *            - Log-distance path loss between the node positions.
+ *            - A frame is received when its power is above the receiver
+ *              sensitivity, noise floor plus the SNR limit of its spreading
+ *              factor ( FSK: SIM_MEDIUM_FSK_MIN_SNR ).
+ *            - Frames overlapping on the same frequency with the same
+ *              spreading factor and bandwidth collide. The receiver keeps
+ *              its frame when it is at least CaptureThreshold stronger than
+ *              each interferer ( capture effect ). Other spreading factors
+ *              only interfere when SIM_MEDIUM_INTER_SF_REJECTION stronger.
+ *            - Frames passing the above are lost with PacketErrorRate.
+ *            - Nodes are half-duplex.
+ */
+#ifndef __SIM_MEDIUM_H__
+#define __SIM_MEDIUM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "radio.h"
+
+/*!
+ * Virtual time [us]
+ */
+typedef uint64_t SimTime_t;
+
+/*!
+ * Time value of a stopped timer or of an event that never happens
+ */
+#define SIM_TIME_NEVER                              UINT64_MAX
+
+/*!
+ * Maximum number of frames on air or kept for collision checks
+ */
+#define SIM_MEDIUM_MAX_FRAMES                       64
+
+/*!
+ * Maximum number of receivers locked on frames at a time
+ */
+#define SIM_MEDIUM_MAX_LOCKS                        64
+
+/*!
+ * Number of preamble symbols needed by a receiver to lock on a LoRa frame
+ */
+#define SIM_MEDIUM_DETECT_SYMBOLS                   2
+
+/*!
+ * SNR needed by a receiver to demodulate a FSK frame [dB]
+ */
+#define SIM_MEDIUM_FSK_MIN_SNR                      10
+
+/*!
+ * Rejection of frames using another spreading factor [dB]
+ */
+#define SIM_MEDIUM_INTER_SF_REJECTION               16
+
+/*!
+ * Modulation of a frame or of a receiver
+ */
+typedef struct sSimModulation
+{
+    /*!
+     * Modem [MODEM_FSK, MODEM_LORA]
+     */
+    RadioModems_t Modem;
+    /*!
+     * Frequency [Hz]
+     */
+    uint32_t Frequency;
+    /*!
+     * Bandwidth [Hz]
+     */
+    uint32_t Bandwidth;
+    /*!
+     * LoRa: spreading factor, FSK: bit rate [bits/s]. FSK receivers only
+     * check the frequency and the bit rate.
+     */
+    uint32_t Datarate;
+    /*!
+     * LoRa IQ inversion ( downlinks are inverted )
+     */
+    bool IqInverted;
+    /*!
+     * LoRa sync word
+     */
+    uint8_t SyncWord;
+}SimModulation_t;
+
+/*!
+ * Channel model parameters
+ */
+typedef struct sSimChannelModel
+{
+    /*!
+     * Path loss at 1 m [dB]
+     */
+    float RefPathLoss;
+    /*!
+     * Path loss exponent
+     */
+    float PathLossExponent;
+    /*!
+     * Receivers noise figure [dB]
+     */
+    float NoiseFigure;
+    /*!
+     * Minimum power difference for a frame to survive a collision [dB]
+     */
+    float CaptureThreshold;
+    /*!
+     * Probability to lose a frame received above sensitivity without
+     * collision [1/1000]
+     */
+    uint16_t PacketErrorRate;
+    /*!
+     * Seed of the medium random generator [0: default seed]
+     */
+    uint32_t Seed;
+}SimChannelModel_t;
+
+/*!
+ * Reception information
+ */
+typedef struct sSimRxInfo
+{
+    /*!
+     * Frame modulation
+     */
+    SimModulation_t Modulation;
+    /*!
+     * Received power [dBm]
+     */
+    int16_t Rssi;
+    /*!
+     * Signal to noise ratio [dB]
+     */
+    int8_t Snr;
+    /*!
+     * Frame start time
+     */
+    SimTime_t StartTime;
+    /*!
+     * Frame end time
+     */
+    SimTime_t EndTime;
+}SimRxInfo_t;
+
+typedef struct sSimNode SimNode_t;
+
+/*!
+ * Simulated node. The owner sets the public fields and callbacks before
+ * adding the node to the medium. The callbacks are called from
+ * SimMediumRunUntil.
+ */
+struct sSimNode
+{
+    /*!
+     * Position [m]
+     */
+    int32_t X;
+    /*!
+     * Position [m]
+     */
+    int32_t Y;
+    /*!
+     * Antenna gain [dBi]
+     */
+    int8_t AntennaGain;
+    /*!
+     * Set for a gateway, which receives the LoRa uplinks of every
+     * frequency, spreading factor and bandwidth at once
+     */
+    bool IsGateway;
+    /*!
+     * \brief Frame sent by the node is over
+     */
+    void ( *TxDone )( SimNode_t* node );
+    /*!
+     * \brief The node locked on a frame preamble
+     */
+    void ( *PreambleDetected )( SimNode_t* node );
+    /*!
+     * \brief Frame received
+     */
+    void ( *RxDone )( SimNode_t* node, const uint8_t* payload, uint8_t size, const SimRxInfo_t* info );
+    /*!
+     * \brief Frame locked on has been lost ( collision, packet error )
+     */
+    void ( *RxError )( SimNode_t* node, const SimRxInfo_t* info );
+    /*!
+     * \brief Node timer expired
+     */
+    void ( *Timer )( SimNode_t* node );
+    /*!
+     * Owner context
+     */
+    void* Context;
+    /*!
+     * Medium private state
+     */
+    bool IsListening;
+    SimModulation_t RxModulation;
+    uint8_t NbLocks;
+    bool IsTransmitting;
+    SimTime_t TimerTime;
+    SimNode_t* Next;
+};
+
+/*!
+ * \brief Initializes the medium, resets the virtual clock to 0 and removes
+ *        all nodes
+ *
+ * \param [IN] model Channel model parameters
+ */
+void SimMediumInit( const SimChannelModel_t* model );
+
+/*!
+ * \brief Adds a node to the medium. Adding a node twice has no effect.
+ *
+ * \param [IN] node Node, owned by the caller
+ */
+void SimMediumAddNode( SimNode_t* node );
+
+/*!
+ * \brief Gets the virtual clock
+ *
+ * \retval time Current time
+ */
+SimTime_t SimMediumGetTime( void );
+
+/*!
+ * \brief Gets the time of the next medium event
+ *
+ * \retval time Next event time [SIM_TIME_NEVER: no event]
+ */
+SimTime_t SimMediumGetNextEventTime( void );
+
+/*!
+ * \brief Processes the events up to the given time and advances the virtual
+ *        clock to it
+ *
+ * \param [IN] time Time to run to
+ */
+void SimMediumRunUntil( SimTime_t time );
+
+/*!
+ * \brief Schedules the transmission of a frame. The sender stops receiving
+ *        from the frame start until its TxDone callback.
+ *
+ * \param [IN] node         Sender
+ * \param [IN] modulation   Frame modulation
+ * \param [IN] power        Transmission power [dBm]
+ * \param [IN] startTime    Frame start time [>= SimMediumGetTime]
+ * \param [IN] preambleTime Preamble duration
+ * \param [IN] timeOnAir    Frame duration
+ * \param [IN] payload      Payload
+ * \param [IN] size         Payload size
+ *
+ * \retval status [true: frame scheduled, false: no frame slot left]
+ */
+bool SimMediumSend( SimNode_t* node, const SimModulation_t* modulation, int8_t power, SimTime_t startTime,
+                    SimTime_t preambleTime, SimTime_t timeOnAir, const uint8_t* payload, uint8_t size );
+
+/*!
+ * \brief Starts receiving. The node locks on the frames still in their
+ *        preamble and on the frames starting while it listens.
+ *
+ * \param [IN] node       Receiver
+ * \param [IN] modulation Reception modulation ( gateways: sync word only )
+ */
+void SimMediumStartRx( SimNode_t* node, const SimModulation_t* modulation );
+
+/*!
+ * \brief Stops receiving and drops the frames the node is locked on
+ *
+ * \param [IN] node Receiver
+ */
+void SimMediumStopRx( SimNode_t* node );
+
+/*!
+ * \brief Checks if the node is locked on a frame
+ *
+ * \param [IN] node Receiver
+ *
+ * \retval locked [true: receiving a frame, false: searching a preamble]
+ */
+bool SimMediumIsLocked( SimNode_t* node );
+
+/*!
+ * \brief Starts the node timer. A running timer is restarted.
+ *
+ * \param [IN] node Node
+ * \param [IN] time Expiry time
+ */
+void SimMediumSetTimer( SimNode_t* node, SimTime_t time );
+
+/*!
+ * \brief Stops the node timer
+ *
+ * \param [IN] node Node
+ */
+void SimMediumStopTimer( SimNode_t* node );
+
+/*!
+ * \brief Gets the highest power received on the given channel during the
+ *        given time interval
+ *
+ * \param [IN] node      Receiver
+ * \param [IN] frequency Channel frequency [Hz]
+ * \param [IN] bandwidth Channel bandwidth [Hz]
+ * \param [IN] start     Interval start
+ * \param [IN] end       Interval end
+ *
+ * \retval rssi Highest received power, noise floor without frame [dBm]
+ */
+int16_t SimMediumGetRssi( SimNode_t* node, uint32_t frequency, uint32_t bandwidth, SimTime_t start, SimTime_t end );
+
+/*!
+ * \brief Checks for a frame of the given modulation on air above the node
+ *        sensitivity
+ *
+ * \param [IN] node       Receiver
+ * \param [IN] modulation Modulation to detect
+ *
+ * \retval activity [true: activity detected, false: channel free]
+ */
+bool SimMediumDetectActivity( SimNode_t* node, const SimModulation_t* modulation );
+
+/*!
+ * \brief Gets a value of the medium random generator
+ *
+ * \retval random 32 bits random value
+ */
+uint32_t SimMediumRandom( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_MEDIUM_H__
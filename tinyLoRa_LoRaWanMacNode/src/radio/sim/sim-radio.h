@@ -0,0 +1,67 @@
+/*!
+ * \file      sim-radio.h
+ *
+ * \brief     Simulated radio driver
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The driver implements the Radio_s interface on top of the
+ *            simulated medium. SimMediumInit must be called before
+ *            Radio.Init, which adds the radio node to the medium. The radio
+ *            events are reported by Radio.IrqProcess once the medium has
+ *            been run past them.
+ *            LR-FHSS transmissions are not simulated and end with a
+ *            TxTimeout.
+ */
+#ifndef __SIM_RADIO_H__
+#define __SIM_RADIO_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "sim-medium.h"
+
+/*!
+ * Radio plus board wake up time [ms]
+ */
+#define SIM_RADIO_WAKEUP_TIME                       1
+
+/*!
+ * Number of registers of the simulated register file
+ */
+#define SIM_RADIO_NB_REGISTERS                      0x1000
+
+/*!
+ * \brief Gets the medium node of the radio, to set its position and
+ *        antenna gain
+ *
+ * \retval node Radio node
+ */
+SimNode_t* SimRadioGetNode( void );
+
+/*!
+ * \brief Checks if radio events wait for Radio.IrqProcess. The host board
+ *        low power handler must not advance the virtual time then.
+ *
+ * \retval pending [true: events pending, false: no event]
+ */
+bool SimRadioIsIrqPending( void );
+
+/*!
+ * \brief Enables the symbol timeout of the single receptions. Disabled, a
+ *        single reception only ends on its Radio.Rx timeout, as a radio
+ *        without preamble timeout does. Simulations compare the listen time
+ *        of both. Enabled by default.
+ *
+ * \param [IN] enable [true: closed when no preamble is detected within the
+ *                    symbol timeout, false: closed on the Rx timeout]
+ */
+void SimRadioSetSymbolTimeoutEnabled( bool enable );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_RADIO_H__
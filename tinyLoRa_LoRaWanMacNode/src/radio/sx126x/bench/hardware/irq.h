@@ -0,0 +1,29 @@
+/*!
+ * \file      irq.h
+ *
+ * \brief     Pico SDK interrupt API used by the board layer, implemented by
+ *            radio-spi-bench.c on the host
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#ifndef __BENCH_HARDWARE_IRQ_H__
+#define __BENCH_HARDWARE_IRQ_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+typedef void ( *irq_handler_t )( void );
+
+int user_irq_claim_unused( bool required );
+
+void irq_set_exclusive_handler( uint num, irq_handler_t handler );
+
+void irq_set_priority( uint num, uint8_t hardware_priority );
+
+void irq_set_enabled( uint num, bool enabled );
+
+void irq_set_pending( uint num );
+
+#endif // __BENCH_HARDWARE_IRQ_H__
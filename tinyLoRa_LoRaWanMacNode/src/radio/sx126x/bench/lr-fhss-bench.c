@@ -0,0 +1,912 @@
+/*!
+ * \file      lr-fhss-bench.c
+ *
+ * \brief     Host checks of the LR-FHSS encoder against reference vectors
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Compares each stage of lr-fhss.c with a reference model written
+ *            after the Semtech lr_fhss encoder ( table driven CRCs, explicit
+ *            puncturing matrices, header interleaver table, hopping
+ *            parameters in PLL steps ) and with vectors pinned from it:
+ *            - CRC-8/AUTOSAR without the final xor and CRC-16/CMS check values
+ *            - header bytes, coded header and interleaved header block
+ *            - whitened payload with its CRC, coded payload and full frame
+ *            - first hop offsets of a sequence of each grid
+ *            Every coding rate, region channel width, payload length and
+ *            hopping sequence is then compared bit for bit with the model,
+ *            the frames decode back and the hop offsets stay in the channel.
+ *            Returns 1 on any mismatch, which fails the lr-fhss-bench test of
+ *            the host board.
+ *
+ *            gcc -O2 -Iboards -Iradio/sx126x radio/sx126x/bench/lr-fhss-bench.c \
+ *                boards/mcu/utilities.c -lm -o lr-fhss-bench
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The checks need the static encoder stages
+#include "lr-fhss.c"
+
+/*!
+ * Maximum payload checked against the model
+ */
+#define BENCH_MAX_PAYLOAD                           115
+
+/*!
+ * Number of pinned hop offsets
+ */
+#define BENCH_NB_HOPS                               8
+
+/*!
+ * Operating channel width and grid used by a region
+ */
+typedef struct sBenchChannel
+{
+    const char* Name;
+    LrFhssBandwidths_t Bandwidth;
+    LrFhssGrids_t Grid;
+}BenchChannel_t;
+
+static const BenchChannel_t BenchChannels[] =
+{
+    { "EU868 OCW 137 kHz", LR_FHSS_BW_136719_HZ, LR_FHSS_GRID_3906_HZ },
+    { "EU868 OCW 336 kHz", LR_FHSS_BW_335938_HZ, LR_FHSS_GRID_3906_HZ },
+    { "US915 OCW 1523 kHz", LR_FHSS_BW_1523438_HZ, LR_FHSS_GRID_25391_HZ },
+};
+
+/*
+ * Reference model
+ */
+
+/*!
+ * Puncturing matrices, 1 keeps the mother code output
+ */
+static const uint8_t RefMatrix56[] = { 1, 1, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0 };
+static const uint8_t RefMatrix23[] = { 1, 1, 0, 1, 0, 0 };
+static const uint8_t RefMatrix12[] = { 1, 1, 0 };
+static const uint8_t RefMatrix13[] = { 1, 1, 1 };
+
+static const struct
+{
+    const uint8_t* Matrix;
+    uint8_t Size;
+}RefPuncturing[] =
+{
+    { RefMatrix56, sizeof( RefMatrix56 ) },
+    { RefMatrix23, sizeof( RefMatrix23 ) },
+    { RefMatrix12, sizeof( RefMatrix12 ) },
+    { RefMatrix13, sizeof( RefMatrix13 ) },
+};
+
+/*!
+ * Generator taps on the input bit and the 3 previous ones
+ */
+static const uint8_t RefTaps[3][4] =
+{
+    { 1, 1, 0, 1 },
+    { 1, 0, 1, 1 },
+    { 1, 1, 1, 1 },
+};
+
+/*!
+ * Header interleaver
+ */
+static const uint8_t RefHeaderInterleaver[80] =
+{
+    0,  18, 36, 54, 72, 4,  22, 40, 58, 76, 8,  26, 44, 62, 12, 30, 48, 66, 16, 34,
+    52, 70, 1,  19, 37, 55, 73, 5,  23, 41, 59, 77, 9,  27, 45, 63, 13, 31, 49, 67,
+    17, 35, 53, 71, 2,  20, 38, 56, 74, 6,  24, 42, 60, 78, 10, 28, 46, 64, 14, 32,
+    50, 68, 3,  21, 39, 57, 75, 7,  25, 43, 61, 79, 11, 29, 47, 65, 15, 33, 51, 69,
+};
+
+/*!
+ * Grid positions and hopping sequences of the operating channel widths,
+ * indexed by grid then width. Grid steps [PLL steps].
+ */
+static const struct
+{
+    uint16_t NbGrid;
+    uint16_t NbSequences;
+}RefHopParams[2][10] =
+{
+    { { 1, 384 }, { 3, 384 }, { 5, 384 }, { 7, 384 }, { 13, 384 }, { 15, 384 }, { 28, 384 }, { 30, 384 }, { 60, 384 }, { 62, 384 } },
+    { { 10, 384 }, { 22, 384 }, { 35, 384 }, { 47, 384 }, { 86, 512 }, { 99, 512 }, { 185, 512 }, { 198, 512 }, { 390, 512 }, { 403, 512 } },
+};
+static const int32_t RefGridSteps[2] = { 26624, 4096 };
+static const uint16_t RefPolynomials[2][6] = { { 33, 45, 48, 51, 54, 57 }, { 65, 68, 71, 72 } };
+
+static uint8_t RefCrc8Table[256];
+static uint16_t RefCrc16Table[256];
+
+static void RefInitTables( void )
+{
+    for( uint16_t i = 0; i < 256; i++ )
+    {
+        uint8_t crc8 = ( uint8_t )i;
+        uint16_t crc16 = ( uint16_t )( i << 8 );
+
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc8 = ( crc8 & 0x80 ) ? ( uint8_t )( ( crc8 << 1 ) ^ 0x2F ) : ( uint8_t )( crc8 << 1 );
+            crc16 = ( crc16 & 0x8000 ) ? ( uint16_t )( ( crc16 << 1 ) ^ 0x8005 ) : ( uint16_t )( crc16 << 1 );
+        }
+        RefCrc8Table[i] = crc8;
+        RefCrc16Table[i] = crc16;
+    }
+}
+
+static uint8_t RefCrc8( const uint8_t* data, int size )
+{
+    uint8_t crc = 0xFF;
+
+    for( int i = 0; i < size; i++ )
+    {
+        crc = RefCrc8Table[crc ^ data[i]];
+    }
+    return crc;
+}
+
+static uint16_t RefCrc16( const uint8_t* data, int size )
+{
+    uint16_t crc = 0xFFFF;
+
+    for( int i = 0; i < size; i++ )
+    {
+        crc = ( uint16_t )( ( crc << 8 ) ^ RefCrc16Table[( crc >> 8 ) ^ data[i]] );
+    }
+    return crc;
+}
+
+/*!
+ * \brief Whitening sequence byte, 0xFF then the x^8 + x^6 + x^5 + x^4 + 1 LFSR
+ */
+static uint8_t RefWhiteningByte( int index )
+{
+    uint8_t lfsr = 0xFF;
+
+    for( int i = 0; i < index; i++ )
+    {
+        uint8_t b = ( ( lfsr >> 7 ) ^ ( lfsr >> 5 ) ^ ( lfsr >> 4 ) ^ ( lfsr >> 3 ) ) & 0x01;
+
+        lfsr = ( uint8_t )( ( lfsr << 1 ) | b );
+    }
+    return lfsr;
+}
+
+static uint8_t RefSwap( uint8_t value )
+{
+    return ( uint8_t )( ( value << 4 ) | ( value >> 4 ) );
+}
+
+/*!
+ * \brief Bit stream to one bit per byte
+ */
+static void RefUnpack( const uint8_t* bytes, int nbBits, uint8_t* bits )
+{
+    for( int i = 0; i < nbBits; i++ )
+    {
+        bits[i] = ( bytes[i / 8] >> ( 7 - ( i % 8 ) ) ) & 0x01;
+    }
+}
+
+static void RefPack( const uint8_t* bits, int nbBits, uint8_t* bytes )
+{
+    memset( bytes, 0, ( nbBits + 7 ) / 8 );
+    for( int i = 0; i < nbBits; i++ )
+    {
+        bytes[i / 8] |= bits[i] << ( 7 - ( i % 8 ) );
+    }
+}
+
+/*!
+ * \brief Punctured convolutional encoder, one bit per byte
+ *
+ * \retval Number of coded bits
+ */
+static int RefConvEncode( const uint8_t* in, int nbBits, const uint8_t* matrix, int matrixSize, uint8_t* out )
+{
+    uint8_t delay[3] = { 0 };
+    int nbOut = 0;
+    int m = 0;
+
+    for( int i = 0; i < nbBits; i++ )
+    {
+        uint8_t taps[4] = { in[i], delay[0], delay[1], delay[2] };
+
+        for( int k = 0; k < 3; k++ )
+        {
+            uint8_t bit = 0;
+
+            for( int d = 0; d < 4; d++ )
+            {
+                bit ^= RefTaps[k][d] & taps[d];
+            }
+            if( matrix[m] != 0 )
+            {
+                out[nbOut++] = bit;
+            }
+            m = ( m + 1 ) % matrixSize;
+        }
+        delay[2] = delay[1];
+        delay[1] = delay[0];
+        delay[0] = in[i];
+    }
+    return nbOut;
+}
+
+/*!
+ * \brief Payload interleaver, out[i] = in[permutation[i]]
+ */
+static void RefInterleaverPermutation( int nbBits, uint16_t* permutation )
+{
+    int step = ( int )ceil( sqrt( ( double )nbBits ) );
+    int stepV = step >> 1;
+    int pos = 0;
+    int stIdx = 0;
+    int stIdxInit = 0;
+
+    step <<= 1;
+    for( int i = 0; i < nbBits; i++ )
+    {
+        permutation[i] = ( uint16_t )pos;
+        pos += step;
+        if( pos >= nbBits )
+        {
+            stIdx += stepV;
+            if( stIdx >= step )
+            {
+                stIdxInit++;
+                stIdx = stIdxInit;
+            }
+            pos = stIdx;
+        }
+    }
+}
+
+static void RefHeader( const LrFhssParams_t* params, uint16_t hsid, uint8_t len, uint8_t replica, uint8_t* header )
+{
+    header[0] = len;
+    header[1] = ( uint8_t )( ( params->CodingRate << 3 ) | ( params->Grid << 2 ) | 0x02 | ( params->Bandwidth >> 3 ) );
+    header[2] = ( uint8_t )( ( ( params->Bandwidth & 0x07 ) << 5 ) | ( ( hsid >> 4 ) & 0x1F ) );
+    header[3] = ( uint8_t )( ( ( hsid & 0x0F ) << 4 ) | ( ( ( params->HeaderCount - 1 - replica ) & 0x03 ) << 2 ) );
+    header[4] = RefCrc8( header, 4 );
+}
+
+/*!
+ * \brief Rate 1/2 coded header, one bit per byte
+ */
+static void RefCodedHeader( const uint8_t* header, uint8_t* coded )
+{
+    uint8_t bits[40];
+
+    RefUnpack( header, 40, bits );
+    RefConvEncode( bits, 40, RefMatrix12, sizeof( RefMatrix12 ), coded );
+}
+
+/*!
+ * \brief Whitened payload, CRC and trellis termination byte
+ */
+static void RefPayload( const uint8_t* payload, uint8_t len, uint8_t* out )
+{
+    uint16_t crc = 0;
+
+    for( int i = 0; i < len; i++ )
+    {
+        out[i] = RefSwap( payload[i] ^ RefWhiteningByte( i ) );
+    }
+    crc = RefCrc16( out, len );
+    out[len] = crc >> 8;
+    out[len + 1] = crc & 0xFF;
+    out[len + 2] = 0;
+}
+
+/*!
+ * \brief Punctured coded payload, one bit per byte
+ *
+ * \retval Number of coded bits
+ */
+static int RefCodedPayload( LrFhssCodingRates_t cr, const uint8_t* whitened, uint8_t len, uint8_t* coded )
+{
+    static uint8_t bits[LR_FHSS_MAX_FRAME_SIZE * 8];
+    int nbBits = ( len + 2 ) * 8 + 6;
+
+    RefUnpack( whitened, nbBits, bits );
+    return RefConvEncode( bits, nbBits, RefPuncturing[cr].Matrix, RefPuncturing[cr].Size, coded );
+}
+
+/*!
+ * \brief Full frame
+ *
+ * \retval Number of bits
+ */
+static int RefFrame( const LrFhssParams_t* params, uint16_t hsid, const uint8_t* payload, uint8_t len, uint8_t* frame )
+{
+    static uint8_t bits[LR_FHSS_MAX_FRAME_SIZE * 16];
+    static uint8_t coded[LR_FHSS_MAX_FRAME_SIZE * 16];
+    static uint16_t permutation[LR_FHSS_MAX_FRAME_SIZE * 16];
+    const uint8_t syncWord[] = LR_FHSS_SYNC_WORD;
+    uint8_t sync[32];
+    uint8_t header[5];
+    uint8_t whitened[LR_FHSS_MAX_FRAME_SIZE + 3];
+    int nbCoded = 0;
+    int n = 0;
+
+    RefUnpack( syncWord, 32, sync );
+    for( uint8_t replica = 0; replica < params->HeaderCount; replica++ )
+    {
+        RefHeader( params, hsid, len, replica, header );
+        RefCodedHeader( header, coded );
+        bits[n++] = 0;
+        bits[n++] = 0;
+        for( int i = 0; i < 40; i++ )
+        {
+            bits[n++] = coded[RefHeaderInterleaver[i]];
+        }
+        memcpy( &bits[n], sync, 32 );
+        n += 32;
+        for( int i = 40; i < 80; i++ )
+        {
+            bits[n++] = coded[RefHeaderInterleaver[i]];
+        }
+    }
+    RefPayload( payload, len, whitened );
+    nbCoded = RefCodedPayload( params->CodingRate, whitened, len, coded );
+    RefInterleaverPermutation( nbCoded, permutation );
+    for( int i = 0; i < nbCoded; i++ )
+    {
+        if( ( i % 48 ) == 0 )
+        {
+            bits[n++] = 0;
+            bits[n++] = 0;
+        }
+        bits[n++] = coded[permutation[i]];
+    }
+    RefPack( bits, n, frame );
+    return n;
+}
+
+/*!
+ * \brief Hop offsets of a sequence [Hz]
+ */
+static void RefHops( const LrFhssParams_t* params, uint16_t hsid, int nbHops, int32_t* offsets )
+{
+    uint16_t nbGrid = RefHopParams[params->Grid][params->Bandwidth].NbGrid;
+    uint16_t poly = ( nbGrid <= 64 ) ? RefPolynomials[0][hsid >> 6] : RefPolynomials[1][hsid >> 7];
+    uint16_t seed = ( nbGrid <= 64 ) ? ( hsid & 0x3F ) : ( hsid & 0x7F );
+    uint16_t state = 6;
+
+    for( int h = 0; h < nbHops; h++ )
+    {
+        uint16_t hop = 0;
+        int32_t steps = 0;
+
+        do
+        {
+            state = ( state & 0x01 ) ? ( ( state >> 1 ) ^ poly ) : ( state >> 1 );
+            hop = ( seed == state ) ? seed : ( seed ^ state );
+        }while( hop > nbGrid );
+
+        steps = ( ( int32_t )hop - 1 - ( nbGrid / 2 ) ) * RefGridSteps[params->Grid];
+        // Every other header replica is shifted by half the bit rate, 256 PLL steps
+        if( ( h < params->HeaderCount ) && ( ( ( params->HeaderCount - h ) % 2 ) == 0 ) )
+        {
+            steps += 256;
+        }
+        offsets[h] = ( int32_t )trunc( steps * 15625.0 / 16384.0 );
+    }
+}
+
+/*
+ * Pinned vectors, EU868 OCW 137 kHz, CR 1/3, hopping sequence 85, payload
+ * 00 01 .. 07
+ */
+static const uint8_t VecHeader[] = { 0x08, 0x1E, 0x45, 0x58, 0xD5 };
+static const uint8_t VecCodedHeader[] = { 0x00, 0xE7, 0x03, 0x4C, 0x89, 0xFA, 0x66, 0xBB, 0xDD, 0x66 };
+static const uint8_t VecHeaderBlock[] =
+{
+    0x0C, 0xEB, 0x00, 0x0B, 0xE6, 0xCB, 0x03, 0xDE, 0x65, 0x4C, 0x67, 0xFF,
+    0x23, 0x16, 0x43,
+};
+static const uint8_t VecWhitened[] = { 0xFF, 0xFF, 0xEF, 0xBF, 0x4F, 0x4E, 0x4C, 0x28, 0xFF, 0xFA, 0x00 };
+static const uint8_t VecCodedPayload[] =
+{
+    0xE8, 0xED, 0xB6, 0xDB, 0x6D, 0xB6, 0xDB, 0x17, 0x4E, 0xC5, 0xD3, 0xB6,
+    0x2D, 0x30, 0x8E, 0x2D, 0x30, 0x89, 0x82, 0xB0, 0xB4, 0xE3, 0xD8, 0x9F,
+    0xE8, 0xED, 0xB6, 0xDB, 0x6C, 0x5A, 0x7C, 0x00, 0x00,
+};
+static const uint8_t VecFrame[] =
+{
+    0x0C, 0xEB, 0x00, 0x0B, 0xE6, 0xCB, 0x03, 0xDE, 0x65, 0x4C, 0x67, 0xFF,
+    0x23, 0x16, 0x43, 0x3E, 0x80, 0x00, 0xD9, 0xA2, 0xC0, 0xF7, 0x99, 0x53,
+    0x09, 0x3F, 0xCE, 0xE5, 0x90, 0xCD, 0xA1, 0x10, 0x3E, 0x28, 0xB0, 0x3D,
+    0xE6, 0x54, 0xC0, 0x7F, 0xE3, 0x39, 0x64, 0xEF, 0xC8, 0x9A, 0x8E, 0x5E,
+    0xCB, 0x26, 0x44, 0xF3, 0x53, 0x82, 0x5B, 0x8E, 0x2C, 0x86, 0xC1, 0x5D,
+    0x92, 0xF3, 0xE2, 0x75, 0xA1, 0xD6, 0x8B, 0x18, 0xB5, 0x1D, 0x72, 0xDD,
+    0x20, 0xFF, 0x08, 0xD6, 0x30,
+};
+
+/*
+ * Pinned vectors, US915 OCW 1523 kHz, CR 5/6, hopping sequence 300, same
+ * payload
+ */
+static const uint8_t VecFrameUs915[] =
+{
+    0x0C, 0x78, 0x36, 0x28, 0xA7, 0x0B, 0x03, 0xDE, 0x65, 0x4C, 0xC3, 0xEF,
+    0x31, 0x13, 0x03, 0x16, 0x09, 0xCA, 0x08, 0xC2, 0xC0, 0xF7, 0x99, 0x53,
+    0x38, 0x3B, 0x8E, 0x44, 0xC3, 0x70, 0x9E, 0xA6, 0xBA, 0xB7, 0xF8, 0x3E,
+    0xC2, 0x5B, 0x0D, 0x4E, 0xE7, 0x33, 0x40,
+};
+
+/*
+ * Pinned hop offsets [Hz]
+ */
+static const int32_t VecHopsEu868[BENCH_NB_HOPS] = { 15625, -58349, 46875, -66406, 50781, -7812, -39062, -27343 };
+static const int32_t VecHopsUs915[BENCH_NB_HOPS] = { 406494, -101562, -761718, -482421, 736328, 126953, 228515, 380859 };
+
+static void BenchPrintHex( const char* name, const uint8_t* data, int size )
+{
+    printf( "  %s:", name );
+    for( int i = 0; i < size; i++ )
+    {
+        printf( "%s0x%02X,", ( ( i % 12 ) == 0 ) ? "\n    " : " ", data[i] );
+    }
+    printf( "\n" );
+}
+
+static uint32_t BenchCompare( const char* stage, const uint8_t* encoder, const uint8_t* model, int size,
+                              const uint8_t* expected, int expectedSize )
+{
+    if( ( size == expectedSize ) && ( memcmp( encoder, expected, size ) == 0 ) && ( memcmp( model, expected, size ) == 0 ) )
+    {
+        return 0;
+    }
+    printf( "%s mismatch\n", stage );
+    BenchPrintHex( "encoder", encoder, size );
+    BenchPrintHex( "model", model, size );
+    BenchPrintHex( "expected", expected, expectedSize );
+    return 1;
+}
+
+static uint32_t BenchCompareHops( const char* name, const int32_t* encoder, const int32_t* model, const int32_t* expected )
+{
+    if( ( memcmp( encoder, expected, sizeof( int32_t ) * BENCH_NB_HOPS ) == 0 ) &&
+        ( memcmp( model, expected, sizeof( int32_t ) * BENCH_NB_HOPS ) == 0 ) )
+    {
+        return 0;
+    }
+    printf( "%s hop offsets mismatch\n  encoder/model:", name );
+    for( int i = 0; i < BENCH_NB_HOPS; i++ )
+    {
+        printf( " %d/%d", ( int )encoder[i], ( int )model[i] );
+    }
+    printf( "\n" );
+    return 1;
+}
+
+static uint32_t BenchCheckCrc( void )
+{
+    const uint8_t check[] = "123456789";
+    uint32_t errors = 0;
+
+    if( ( LrFhssHeaderCrc8( check, 9 ) != 0x20 ) || ( RefCrc8( check, 9 ) != 0x20 ) )
+    {
+        printf( "Header CRC-8 check value 0x%02X, expected 0x20\n", LrFhssHeaderCrc8( check, 9 ) );
+        errors++;
+    }
+    if( ( LrFhssPayloadCrc16( check, 9 ) != 0xAEE7 ) || ( RefCrc16( check, 9 ) != 0xAEE7 ) )
+    {
+        printf( "Payload CRC-16 check value 0x%04X, expected 0xAEE7\n", LrFhssPayloadCrc16( check, 9 ) );
+        errors++;
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckInterleaver( void )
+{
+    uint16_t permutation[LR_FHSS_MAX_FRAME_SIZE * 16];
+    LrFhssInterleaver_t interleaver;
+    uint32_t errors = 0;
+
+    LrFhssInterleaverInit( &interleaver, LR_FHSS_HEADER_CODED_BITS );
+    for( uint8_t i = 0; i < LR_FHSS_HEADER_CODED_BITS; i++ )
+    {
+        uint16_t pos = LrFhssInterleaverNext( &interleaver );
+
+        if( pos != RefHeaderInterleaver[i] )
+        {
+            printf( "Header interleaver output %u reads bit %u, expected %u\n", i, pos, RefHeaderInterleaver[i] );
+            return 1;
+        }
+    }
+    // Every payload size is a permutation matching the model
+    for( uint16_t nbBits = 1; nbBits <= ( LR_FHSS_MAX_FRAME_SIZE * 8 ); nbBits++ )
+    {
+        uint8_t used[LR_FHSS_MAX_FRAME_SIZE * 8] = { 0 };
+
+        RefInterleaverPermutation( nbBits, permutation );
+        LrFhssInterleaverInit( &interleaver, nbBits );
+        for( uint16_t i = 0; i < nbBits; i++ )
+        {
+            uint16_t pos = LrFhssInterleaverNext( &interleaver );
+
+            if( ( pos != permutation[i] ) || ( pos >= nbBits ) || ( used[pos]++ != 0 ) )
+            {
+                printf( "Interleaver of %u bits: output %u reads bit %u\n", nbBits, i, pos );
+                errors++;
+                break;
+            }
+        }
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckPinnedVectors( void )
+{
+    static uint8_t modelBits[LR_FHSS_MAX_FRAME_SIZE * 16];
+    LrFhssParams_t params =
+    {
+        .Bandwidth = LR_FHSS_BW_136719_HZ,
+        .CodingRate = LR_FHSS_CR_1_3,
+        .Grid = LR_FHSS_GRID_3906_HZ,
+        .HeaderCount = 3,
+    };
+    const uint8_t payload[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+    uint8_t len = sizeof( payload );
+    uint8_t encoder[LR_FHSS_MAX_FRAME_SIZE];
+    uint8_t model[LR_FHSS_MAX_FRAME_SIZE];
+    int32_t encoderHops[BENCH_NB_HOPS];
+    int32_t modelHops[BENCH_NB_HOPS];
+    LrFhssHopSequence_t sequence;
+    uint16_t inputBits = ( ( len + LR_FHSS_PAYLOAD_CRC_SIZE ) * 8 ) + LR_FHSS_TRELLIS_TAIL_BITS;
+    uint32_t errors = 0;
+    uint16_t crc = 0;
+    int nbBits = 0;
+    int size = 0;
+
+    LrFhssBuildHeader( &params, 85, len, 0, encoder );
+    RefHeader( &params, 85, len, 0, model );
+    errors += BenchCompare( "Header", encoder, model, LR_FHSS_HEADER_SIZE, VecHeader, sizeof( VecHeader ) );
+
+    LrFhssEncodeHeader( VecHeader, encoder );
+    RefCodedHeader( VecHeader, modelBits );
+    RefPack( modelBits, LR_FHSS_HEADER_CODED_BITS, model );
+    errors += BenchCompare( "Coded header", encoder, model, LR_FHSS_HEADER_CODED_BITS / 8, VecCodedHeader,
+                            sizeof( VecCodedHeader ) );
+
+    LrFhssWhitening( payload, len, encoder );
+    crc = LrFhssPayloadCrc16( encoder, len );
+    encoder[len] = crc >> 8;
+    encoder[len + 1] = crc & 0xFF;
+    encoder[len + 2] = 0;
+    RefPayload( payload, len, model );
+    errors += BenchCompare( "Whitened payload", encoder, model, len + 3, VecWhitened, sizeof( VecWhitened ) );
+
+    memcpy( model, encoder, len + 3 );
+    // The bits past the coded ones are left as they are
+    memset( encoder, 0, sizeof( encoder ) );
+    size = LrFhssEncodePayload( params.CodingRate, model, inputBits, encoder );
+    nbBits = RefCodedPayload( params.CodingRate, model, len, modelBits );
+    RefPack( modelBits, nbBits, model );
+    if( size != nbBits )
+    {
+        printf( "Coded payload of %d bits, model %d bits\n", size, nbBits );
+        errors++;
+    }
+    errors += BenchCompare( "Coded payload", encoder, model, ( nbBits + 7 ) / 8, VecCodedPayload, sizeof( VecCodedPayload ) );
+
+    size = LrFhssBuildFrame( &params, 85, payload, len, encoder );
+    nbBits = RefFrame( &params, 85, payload, len, model );
+    errors += BenchCompare( "Header block", encoder, model, ( LR_FHSS_HEADER_BITS + 7 ) / 8, VecHeaderBlock,
+                            sizeof( VecHeaderBlock ) );
+    if( size != ( ( nbBits + 7 ) / 8 ) )
+    {
+        printf( "Frame of %d bytes, model %d bits\n", size, nbBits );
+        errors++;
+    }
+    errors += BenchCompare( "Frame", encoder, model, size, VecFrame, sizeof( VecFrame ) );
+
+    LrFhssHopSequenceInit( &params, 85, &sequence );
+    for( uint8_t i = 0; i < BENCH_NB_HOPS; i++ )
+    {
+        encoderHops[i] = LrFhssGetNextHopOffset( &params, &sequence );
+    }
+    RefHops( &params, 85, BENCH_NB_HOPS, modelHops );
+    errors += BenchCompareHops( "EU868", encoderHops, modelHops, VecHopsEu868 );
+
+    params.Bandwidth = LR_FHSS_BW_1523438_HZ;
+    params.CodingRate = LR_FHSS_CR_5_6;
+    params.Grid = LR_FHSS_GRID_25391_HZ;
+    params.HeaderCount = 2;
+    size = LrFhssBuildFrame( &params, 300, payload, len, encoder );
+    nbBits = RefFrame( &params, 300, payload, len, model );
+    errors += BenchCompare( "US915 frame", encoder, model, size, VecFrameUs915, sizeof( VecFrameUs915 ) );
+
+    LrFhssHopSequenceInit( &params, 300, &sequence );
+    for( uint8_t i = 0; i < BENCH_NB_HOPS; i++ )
+    {
+        encoderHops[i] = LrFhssGetNextHopOffset( &params, &sequence );
+    }
+    RefHops( &params, 300, BENCH_NB_HOPS, modelHops );
+    errors += BenchCompareHops( "US915", encoderHops, modelHops, VecHopsUs915 );
+    return errors;
+}
+
+/*!
+ * \brief Recovers the encoder input from the first mother code output
+ *
+ * \remark The first generator ( 0x0B ) taps the current input bit, so
+ *         input = output ^ input[-1] ^ input[-3].
+ */
+static uint8_t BenchConvDecode( uint8_t* history, uint8_t output )
+{
+    uint8_t bit = output ^ ( ( *history >> 0 ) & 0x01 ) ^ ( ( *history >> 2 ) & 0x01 );
+
+    *history = ( ( *history << 1 ) | bit ) & 0x07;
+    return bit;
+}
+
+static uint32_t BenchCheckHeaders( const LrFhssParams_t* params, uint16_t hsid, uint8_t payloadLen, const uint8_t* frame )
+{
+    const uint8_t syncWord[] = LR_FHSS_SYNC_WORD;
+    uint32_t errors = 0;
+    uint16_t pos = 0;
+
+    for( uint8_t replica = 0; replica < params->HeaderCount; replica++ )
+    {
+        uint8_t coded[LR_FHSS_HEADER_CODED_BITS] = { 0 };
+        uint8_t header[LR_FHSS_HEADER_SIZE] = { 0 };
+        uint8_t history = 0;
+        uint8_t reg = 0;
+        uint8_t syncOk = 1;
+        uint16_t first = pos + LR_FHSS_BLOCK_PREAMBLE_BITS;
+
+        for( uint8_t i = 0; i < LR_FHSS_SYNC_WORD_BITS; i++ )
+        {
+            syncOk &= LrFhssGetBit( frame, first + LR_FHSS_HEADER_HALF_BITS + i ) == LrFhssGetBit( syncWord, i );
+        }
+        // De-interleaves around the sync word
+        for( uint8_t i = 0; i < LR_FHSS_HEADER_CODED_BITS; i++ )
+        {
+            uint16_t bitPos = first + i + ( ( i < LR_FHSS_HEADER_HALF_BITS ) ? 0 : LR_FHSS_SYNC_WORD_BITS );
+
+            coded[RefHeaderInterleaver[i]] = LrFhssGetBit( frame, bitPos );
+        }
+        for( uint8_t i = 0; i < ( LR_FHSS_HEADER_SIZE * 8 ); i++ )
+        {
+            uint8_t bit = BenchConvDecode( &history, coded[2 * i] );
+
+            LrFhssSetBit( header, i, bit );
+            // The second output must come from the same input
+            if( ( ( LrFhssConvEncode( &reg, bit ) >> 1 ) & 0x01 ) != coded[( 2 * i ) + 1] )
+            {
+                syncOk = 0;
+            }
+        }
+        if( ( syncOk == 0 ) || ( header[0] != payloadLen ) ||
+            ( ( ( header[1] >> 3 ) & 0x03 ) != params->CodingRate ) || ( ( ( header[1] >> 2 ) & 0x01 ) != params->Grid ) ||
+            ( ( ( ( header[1] & 0x01 ) << 3 ) | ( header[2] >> 5 ) ) != ( uint8_t )params->Bandwidth ) ||
+            ( ( ( ( header[2] & 0x1F ) << 4 ) | ( header[3] >> 4 ) ) != ( hsid & 0x1FF ) ) ||
+            ( ( ( header[3] >> 2 ) & 0x03 ) != ( ( params->HeaderCount - replica - 1 ) & 0x03 ) ) ||
+            ( RefCrc8( header, LR_FHSS_HEADER_SIZE - 1 ) != header[4] ) )
+        {
+            printf( "BW %u CR %u grid %u: header replica %u does not decode\n", params->Bandwidth, params->CodingRate,
+                    params->Grid, replica );
+            errors++;
+        }
+        pos += LR_FHSS_HEADER_BITS;
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckPayload( const LrFhssParams_t* params, const uint8_t* payload, uint8_t payloadLen, const uint8_t* frame )
+{
+    static uint8_t coded[LR_FHSS_MAX_FRAME_SIZE * 8];
+    static uint16_t permutation[LR_FHSS_MAX_FRAME_SIZE * 8];
+    uint16_t inputBits = ( ( payloadLen + LR_FHSS_PAYLOAD_CRC_SIZE ) * 8 ) + LR_FHSS_TRELLIS_TAIL_BITS;
+    uint16_t codedBits = LrFhssGetNbCodedBits( params->CodingRate, payloadLen );
+    uint16_t start = LR_FHSS_HEADER_BITS * params->HeaderCount;
+    const uint8_t* matrix = RefPuncturing[params->CodingRate].Matrix;
+    uint8_t decoded[LR_FHSS_MAX_FRAME_SIZE] = { 0 };
+    uint8_t history = 0;
+    uint16_t index = 0;
+    uint8_t m = 0;
+
+    // De-interleaves the fragments
+    RefInterleaverPermutation( codedBits, permutation );
+    for( uint16_t i = 0; i < codedBits; i++ )
+    {
+        uint16_t bitPos = start + ( ( i / LR_FHSS_FRAG_BITS ) * LR_FHSS_BLOCK_BITS ) + LR_FHSS_BLOCK_PREAMBLE_BITS +
+                          ( i % LR_FHSS_FRAG_BITS );
+
+        coded[permutation[i]] = LrFhssGetBit( frame, bitPos );
+    }
+    for( uint16_t i = 0; i < inputBits; i++ )
+    {
+        for( uint8_t k = 0; k < 3; k++ )
+        {
+            if( matrix[m] != 0 )
+            {
+                if( k == 0 )
+                {
+                    LrFhssSetBit( decoded, i, BenchConvDecode( &history, coded[index] ) );
+                }
+                index++;
+            }
+            else if( k == 0 )
+            {
+                // CR 5/6 drops some first outputs, the model comparison is all
+                return 0;
+            }
+            m = ( m + 1 ) % RefPuncturing[params->CodingRate].Size;
+        }
+    }
+
+    if( ( decoded[payloadLen] != ( RefCrc16( decoded, payloadLen ) >> 8 ) ) ||
+        ( decoded[payloadLen + 1] != ( RefCrc16( decoded, payloadLen ) & 0xFF ) ) )
+    {
+        printf( "CR %u, %u bytes: payload CRC does not decode\n", params->CodingRate, payloadLen );
+        return 1;
+    }
+    for( uint8_t i = 0; i < payloadLen; i++ )
+    {
+        if( ( RefSwap( decoded[i] ) ^ RefWhiteningByte( i ) ) != payload[i] )
+        {
+            printf( "CR %u, %u bytes: payload byte %u does not decode\n", params->CodingRate, payloadLen, i );
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t BenchCheckFrames( void )
+{
+    uint32_t errors = 0;
+    uint32_t nbFrames = 0;
+    uint8_t payload[BENCH_MAX_PAYLOAD];
+    uint8_t frame[LR_FHSS_MAX_FRAME_SIZE];
+    uint8_t model[LR_FHSS_MAX_FRAME_SIZE * 2];
+
+    srand( 1 );
+    for( uint8_t c = 0; c < sizeof( BenchChannels ) / sizeof( BenchChannels[0] ); c++ )
+    {
+        for( uint8_t cr = LR_FHSS_CR_5_6; cr <= LR_FHSS_CR_1_3; cr++ )
+        {
+            LrFhssParams_t params =
+            {
+                .Bandwidth = BenchChannels[c].Bandwidth,
+                .CodingRate = ( LrFhssCodingRates_t )cr,
+                .Grid = BenchChannels[c].Grid,
+                .HeaderCount = LrFhssGetHeaderCount( ( LrFhssCodingRates_t )cr ),
+            };
+
+            for( uint8_t len = 1; len <= BENCH_MAX_PAYLOAD; len++ )
+            {
+                uint16_t hsid = rand( ) % LrFhssGetHopSequenceCount( &params );
+                uint32_t hopBits = 0;
+                uint32_t toa = 0;
+                uint8_t size = 0;
+                int modelBits = 0;
+
+                for( uint8_t i = 0; i < len; i++ )
+                {
+                    payload[i] = ( uint8_t )rand( );
+                }
+                size = LrFhssBuildFrame( &params, hsid, payload, len, frame );
+                if( size == 0 )
+                {
+                    // Beyond the radio buffer, must be consistent with the bit count
+                    if( LrFhssGetNbBits( &params, len ) <= ( LR_FHSS_MAX_FRAME_SIZE * 8 ) )
+                    {
+                        printf( "CR %u, %u bytes: frame refused\n", cr, len );
+                        errors++;
+                    }
+                    continue;
+                }
+                nbFrames++;
+
+                modelBits = RefFrame( &params, hsid, payload, len, model );
+                if( ( modelBits != LrFhssGetNbBits( &params, len ) ) || ( memcmp( frame, model, size ) != 0 ) )
+                {
+                    uint16_t bit = 0;
+
+                    while( ( bit < ( size * 8 ) ) && ( LrFhssGetBit( frame, bit ) == LrFhssGetBit( model, bit ) ) )
+                    {
+                        bit++;
+                    }
+                    printf( "%s CR %u, %u bytes: frame differs from the model at bit %u\n", BenchChannels[c].Name, cr,
+                            len, bit );
+                    errors++;
+                }
+
+                for( uint16_t hop = 0; hop < LrFhssGetNbHops( &params, len ); hop++ )
+                {
+                    hopBits += LrFhssGetHopNbBits( &params, len, hop );
+                }
+                toa = ( uint32_t )ceil( LrFhssGetNbBits( &params, len ) * 1000.0 * LR_FHSS_BITRATE_DEN / LR_FHSS_BITRATE_NUM );
+                if( ( hopBits != LrFhssGetNbBits( &params, len ) ) || ( size != ( ( hopBits + 7 ) >> 3 ) ) ||
+                    ( toa != LrFhssGetTimeOnAir( &params, len ) ) )
+                {
+                    printf( "CR %u, %u bytes: %u hop bits, %u frame bits, %u bytes, %u ms time on air, %u ms expected\n", cr,
+                            len, ( unsigned )hopBits, LrFhssGetNbBits( &params, len ), size,
+                            ( unsigned )LrFhssGetTimeOnAir( &params, len ), ( unsigned )toa );
+                    errors++;
+                }
+                errors += BenchCheckHeaders( &params, hsid, len, frame );
+                errors += BenchCheckPayload( &params, payload, len, frame );
+            }
+        }
+    }
+    printf( "Frames: %u compared with the model\n", ( unsigned )nbFrames );
+    return errors;
+}
+
+static uint32_t BenchCheckHopSequences( void )
+{
+    static int32_t modelHops[512];
+    uint32_t errors = 0;
+
+    for( uint8_t grid = LR_FHSS_GRID_25391_HZ; grid <= LR_FHSS_GRID_3906_HZ; grid++ )
+    {
+        for( uint8_t bw = LR_FHSS_BW_39063_HZ; bw <= LR_FHSS_BW_1574219_HZ; bw++ )
+        {
+            LrFhssParams_t params =
+            {
+                .Bandwidth = ( LrFhssBandwidths_t )bw,
+                .CodingRate = LR_FHSS_CR_1_3,
+                .Grid = ( LrFhssGrids_t )grid,
+                .HeaderCount = 3,
+            };
+            uint16_t count = LrFhssGetHopSequenceCount( &params );
+            int32_t halfWidth = ( int32_t )( Bandwidths[bw] / 2 );
+            LrFhssHopSequence_t sequence;
+
+            LrFhssHopSequenceInit( &params, 0, &sequence );
+            if( ( sequence.NbGrid != RefHopParams[grid][bw].NbGrid ) || ( count != RefHopParams[grid][bw].NbSequences ) )
+            {
+                printf( "BW %u grid %u: %u grid positions, %u sequences, expected %u and %u\n", bw, grid, sequence.NbGrid,
+                        count, RefHopParams[grid][bw].NbGrid, RefHopParams[grid][bw].NbSequences );
+                errors++;
+                continue;
+            }
+
+            for( uint16_t hsid = 0; hsid < count; hsid++ )
+            {
+                // The sequences are only checked where they have positions to visit
+                uint16_t nbHops = ( sequence.NbGrid > 1 ) ? sequence.NbGrid : 1;
+
+                RefHops( &params, hsid, nbHops, modelHops );
+                LrFhssHopSequenceInit( &params, hsid, &sequence );
+                for( uint16_t hop = 0; hop < nbHops; hop++ )
+                {
+                    int32_t offset = LrFhssGetNextHopOffset( &params, &sequence );
+
+                    if( ( offset != modelHops[hop] ) || ( labs( offset ) > halfWidth ) )
+                    {
+                        printf( "BW %u grid %u sequence %u hop %u: offset %d Hz, model %d Hz\n", bw, grid, hsid, hop,
+                                ( int )offset, ( int )modelHops[hop] );
+                        errors++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+int main( void )
+{
+    uint32_t errors = 0;
+
+    RefInitTables( );
+    errors += BenchCheckCrc( );
+    errors += BenchCheckInterleaver( );
+    errors += BenchCheckPinnedVectors( );
+    errors += BenchCheckFrames( );
+    errors += BenchCheckHopSequences( );
+    printf( "LR-FHSS reference checks: %u errors\n", ( unsigned )errors );
+    return ( errors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,621 @@
+/*!
+ * \file      radio-spi-bench.c
+ *
+ * \brief     Host checks of the SX126x driver SPI traffic on the emulator
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Runs radio.c, sx126x.c and the sx1261mbxbas board layer,
+ *            unmodified, on the SX126x emulator ( emu/sx126x-emu.h ). The
+ *            GPIO, SPI, delay and timer calls of the board layer are forwarded
+ *            to the emulator below.
+ *
+ *            For each radio operation the transactions are printed with their
+ *            opcode and checked against the expected command sequence:
+ *            - Radio.Send of a LoRa frame, and its TxDone processing;
+ *            - Radio.Rx of a single LoRa window, a frame received and its
+ *              RxDone processing, the frame being checked;
+ *            - Radio.Rx of a window closed by the symbol timeout.
+ *            No transaction may be started while BUSY is high.
+ *
+ *            The chip is then reset and a LoRa SetTx is sent before any
+ *            SetModulationParams, as after a failed configuration. The
+ *            transmission must end with TxDone.
+ *
+ *            Built with RADIO_IRQ_DIRECT_DISPATCH the radio IRQs are processed
+ *            by the software interrupt of the board layer, emulated below
+ *            ( hardware/irq.h ): a pended software interrupt runs at once out
+ *            of a critical section. A DIO1 edge is also raised during the
+ *            first transaction of a Radio.Send, its IRQ processing must only
+ *            run once Radio.Send returns.
+ *
+ *            The program returns 1 on a failed check.
+ *
+ *            The host board runs both builds, as the radio-spi-bench and
+ *            radio-spi-bench-direct-dispatch tests. From the src directory, add
+ *            -DRADIO_IRQ_DIRECT_DISPATCH -Iradio/sx126x/bench for the second:
+ *
+ *            S="radio/sx126x/radio.c radio/sx126x/sx126x.c radio/sx126x/lr-fhss.c \
+ *               radio/sx126x/emu/sx126x-emu.c boards/tinyLoRa/sx1261mbxbas-board.c \
+ *               boards/mcu/utilities.c"
+ *            I="-Isystem -Iradio -Iradio/sx126x -Iradio/sx126x/emu -Iboards -Iboards/tinyLoRa"
+ *            gcc -O2 $I radio/sx126x/bench/radio-spi-bench.c $S -o radio-spi-bench
+ *            ./radio-spi-bench
+ */
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "board-config.h"
+#include "sx-delay.h"
+#include "sx-gpio.h"
+#include "sx-spi.h"
+#include "sx-timer.h"
+#include "radio.h"
+#include "sx126x.h"
+#include "sx126x-board.h"
+#include "sx126x-emu.h"
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+#include "hardware/irq.h"
+#endif
+
+/*!
+ * Bound of the emulated time waited for a radio event [ns]
+ */
+#define BENCH_EVENT_TIMEOUT                         1000000000ULL
+
+/*!
+ * Emulated time step while waiting for a radio event [ns]
+ */
+#define BENCH_EVENT_STEP                            100000ULL
+
+/*!
+ * Expected command sequence of a radio operation
+ */
+typedef struct sBenchSequence
+{
+    const char* Name;
+    uint8_t NbOpcodes;
+    uint8_t Opcodes[16];
+}BenchSequence_t;
+
+/*!
+ * Radio.Send of a LoRa frame: IRQ masks, payload length, payload upload and
+ * SetTx
+ */
+static const BenchSequence_t BenchSend =
+{
+    "Send", 4, { RADIO_CFG_DIOIRQ, RADIO_SET_PACKETPARAMS, RADIO_WRITE_BUFFER, RADIO_SET_TX }
+};
+
+/*!
+ * TxDone: IRQ status read and clear
+ */
+static const BenchSequence_t BenchTxDone =
+{
+    "TxDone", 2, { RADIO_GET_IRQSTATUS, RADIO_CLR_IRQSTATUS }
+};
+
+/*!
+ * Radio.Rx of a single window: IRQ masks, default Rx gain and SetRx
+ */
+static const BenchSequence_t BenchRx =
+{
+    "Rx", 3, { RADIO_CFG_DIOIRQ, RADIO_WRITE_REGISTER, RADIO_SET_RX }
+};
+
+/*!
+ * RxDone of a single window: IRQ status read and clear, implicit header
+ * timeout stop ( RTC control and event clear ), payload and packet status
+ * read
+ */
+static const BenchSequence_t BenchRxDone =
+{
+    "RxDone", 8, { RADIO_GET_IRQSTATUS, RADIO_CLR_IRQSTATUS, RADIO_WRITE_REGISTER, RADIO_READ_REGISTER,
+                   RADIO_WRITE_REGISTER, RADIO_GET_RXBUFFERSTATUS, RADIO_READ_BUFFER, RADIO_GET_PACKETSTATUS }
+};
+
+/*!
+ * RxTimeout of a single window: IRQ status read and clear
+ */
+static const BenchSequence_t BenchRxTimeout =
+{
+    "RxTimeout", 2, { RADIO_GET_IRQSTATUS, RADIO_CLR_IRQSTATUS }
+};
+
+
+/*!
+ * DIO1 handler of the driver, the emulator calls BenchOnDio1Edge
+ */
+static struct
+{
+    GpioIrqHandler* Handler;
+    void* Context;
+    bool IsEdgeArmed;
+}BenchDio1;
+
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/*!
+ * Radio.Send with a DIO1 edge raised during its first transaction: the IRQ
+ * status read and clear follow SetTx
+ */
+static const BenchSequence_t BenchSendHeld =
+{
+    "Send held", 6, { RADIO_CFG_DIOIRQ, RADIO_SET_PACKETPARAMS, RADIO_WRITE_BUFFER, RADIO_SET_TX,
+                      RADIO_GET_IRQSTATUS, RADIO_CLR_IRQSTATUS }
+};
+
+/*!
+ * Emulated software interrupt
+ */
+static struct
+{
+    irq_handler_t Handler;
+    bool IsPending;
+    bool IsActive;
+    uint32_t CriticalDepth;
+    uint32_t NbRuns;
+    uint32_t NbRunsWaited;
+}BenchSwIrq;
+#endif
+
+/*!
+ * Radio events seen by the callbacks
+ */
+static struct
+{
+    uint32_t NbTxDone;
+    uint32_t NbRxDone;
+    uint32_t NbRxTimeout;
+    uint32_t NbOthers;
+    uint8_t Payload[255];
+    uint16_t Size;
+}BenchEvents;
+
+static RadioEvents_t BenchRadioEvents;
+
+/*!
+ * \brief DIO1 edge reported by the emulator
+ */
+static void BenchOnDio1Edge( void* context )
+{
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+    // The software interrupt processes the edge at once
+    SX126xEmuResetStats( );
+#endif
+    BenchDio1.Handler( context );
+}
+
+/*
+ * Board layer forwarded to the emulator
+ */
+void GpioInit( Gpio_t *obj, PinNames pin, PinModes mode, PinConfigs config, PinTypes type, uint32_t value )
+{
+    obj->pin = pin;
+    if( pin == RADIO_NSS_PIN )
+    {
+        SX126xEmuSetNss( ( uint8_t )value );
+    }
+    else if( ( pin == RADIO_RESET_PIN ) && ( mode == PIN_OUTPUT ) && ( value == 0 ) )
+    {
+        SX126xEmuReset( );
+    }
+}
+
+void GpioSetInterrupt( Gpio_t *obj, IrqModes irqMode, IrqPriorities irqPriority, GpioIrqHandler *irqHandler )
+{
+    if( obj->pin == RADIO_DIO_1_PIN )
+    {
+        BenchDio1.Handler = irqHandler;
+        BenchDio1.Context = obj->Context;
+        SX126xEmuSetDio1Handler( BenchOnDio1Edge, obj->Context );
+    }
+}
+
+void GpioWrite( Gpio_t *obj, uint32_t value )
+{
+    if( obj->pin == RADIO_NSS_PIN )
+    {
+        SX126xEmuSetNss( ( uint8_t )value );
+        if( ( value != 0 ) && ( BenchDio1.IsEdgeArmed == true ) )
+        {
+            // GPIO interrupt at the end of the transaction
+            BenchDio1.IsEdgeArmed = false;
+            BenchDio1.Handler( BenchDio1.Context );
+        }
+    }
+}
+
+uint32_t GpioRead( Gpio_t *obj )
+{
+    if( obj->pin == RADIO_BUSY_PIN )
+    {
+        return SX126xEmuGetBusy( );
+    }
+    if( obj->pin == RADIO_DIO_1_PIN )
+    {
+        return SX126xEmuGetDio1( );
+    }
+    return 0;
+}
+
+uint16_t SpiInOut( Spi_t *obj, uint16_t outData )
+{
+    return SX126xEmuSpiInOut( ( uint8_t )outData );
+}
+
+void DelayMs( uint32_t ms )
+{
+    SX126xEmuAdvanceTime( ( uint64_t )ms * 1000000 );
+}
+
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/*!
+ * \brief Runs the pended software interrupt unless it is masked or running
+ */
+static void BenchSwIrqRun( void )
+{
+    if( ( BenchSwIrq.IsActive == true ) || ( BenchSwIrq.CriticalDepth > 0 ) )
+    {
+        return;
+    }
+    BenchSwIrq.IsActive = true;
+    while( BenchSwIrq.IsPending == true )
+    {
+        BenchSwIrq.IsPending = false;
+        BenchSwIrq.NbRuns++;
+        BenchSwIrq.Handler( );
+    }
+    BenchSwIrq.IsActive = false;
+}
+
+int user_irq_claim_unused( bool required )
+{
+    return 26;
+}
+
+void irq_set_exclusive_handler( uint num, irq_handler_t handler )
+{
+    BenchSwIrq.Handler = handler;
+}
+
+void irq_set_priority( uint num, uint8_t hardware_priority )
+{
+}
+
+void irq_set_enabled( uint num, bool enabled )
+{
+}
+
+void irq_set_pending( uint num )
+{
+    BenchSwIrq.IsPending = true;
+    BenchSwIrqRun( );
+}
+
+void BoardCriticalSectionBegin( uint32_t *mask )
+{
+    *mask = 0;
+    BenchSwIrq.CriticalDepth++;
+}
+
+void BoardCriticalSectionEnd( uint32_t *mask )
+{
+    BenchSwIrq.CriticalDepth--;
+    BenchSwIrqRun( );
+}
+#else
+void BoardCriticalSectionBegin( uint32_t *mask )
+{
+    *mask = 0;
+}
+
+void BoardCriticalSectionEnd( uint32_t *mask )
+{
+}
+#endif
+
+/*
+ * The driver timeout timers are not run: the checked windows end on the chip
+ * IRQs
+ */
+void TimerInit( TimerEvent_t *obj, void ( *callback )( void *context ) )
+{
+}
+
+void TimerStart( TimerEvent_t *obj )
+{
+}
+
+void TimerStop( TimerEvent_t *obj )
+{
+}
+
+void TimerSetValue( TimerEvent_t *obj, uint32_t value )
+{
+}
+
+TimerTime_t TimerGetCurrentTime( void )
+{
+    return ( TimerTime_t )( SX126xEmuGetTime( ) / 1000000 );
+}
+
+TimerTime_t TimerGetElapsedTime( TimerTime_t past )
+{
+    return TimerGetCurrentTime( ) - past;
+}
+
+static void BenchOnTxDone( void )
+{
+    BenchEvents.NbTxDone++;
+}
+
+static void BenchOnRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    BenchEvents.NbRxDone++;
+    BenchEvents.Size = size;
+    memcpy( BenchEvents.Payload, payload, size );
+}
+
+static void BenchOnRxTimeout( void )
+{
+    BenchEvents.NbRxTimeout++;
+}
+
+static void BenchOnOther( void )
+{
+    BenchEvents.NbOthers++;
+}
+
+static void BenchOnRxError( void )
+{
+    BenchEvents.NbOthers++;
+}
+
+/*!
+ * \brief Advances the emulated time until the chip raises DIO1 and processes
+ *        the radio IRQ
+ *
+ * \retval status [true: IRQ processed, false: no IRQ]
+ */
+static bool BenchWaitIrq( void )
+{
+    for( uint64_t time = 0; time < BENCH_EVENT_TIMEOUT; time += BENCH_EVENT_STEP )
+    {
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+        // Processed by the software interrupt on the DIO1 edge
+        if( BenchSwIrq.NbRuns != BenchSwIrq.NbRunsWaited )
+        {
+            BenchSwIrq.NbRunsWaited = BenchSwIrq.NbRuns;
+            return true;
+        }
+#endif
+        // Also reports the edges raised during the last driver access
+        SX126xEmuAdvanceTime( BENCH_EVENT_STEP );
+        if( SX126xEmuGetDio1( ) != 0 )
+        {
+            SX126xEmuResetStats( );
+            Radio.IrqProcess( );
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ * \brief Prints the transactions since the last SX126xEmuResetStats and
+ *        checks them against the expected sequence
+ *
+ * \retval Number of errors
+ */
+static uint32_t BenchCheckSequence( const BenchSequence_t* sequence )
+{
+    SX126xEmuStats_t stats;
+    uint32_t errors = 0;
+    uint16_t length = SX126xEmuGetTraceLength( );
+
+    SX126xEmuGetStats( &stats );
+    printf( "%-10s %2u transactions %3u bytes %3u busy polls, SPI %5.1f us, BUSY %6.1f us:", sequence->Name,
+            ( unsigned )stats.NbTransactions, ( unsigned )stats.NbBytes, ( unsigned )stats.NbBusyPolls,
+            stats.SpiTime / 1e3, stats.BusyTime / 1e3 );
+    for( uint16_t i = 0; i < length; i++ )
+    {
+        printf( " %02X", SX126xEmuGetTransaction( i )->Opcode );
+    }
+    printf( "\n" );
+
+    if( stats.NbTransactions != sequence->NbOpcodes )
+    {
+        printf( "%s: %u transactions, %u expected\n", sequence->Name, ( unsigned )stats.NbTransactions,
+                sequence->NbOpcodes );
+        errors++;
+    }
+    for( uint16_t i = 0; ( i < length ) && ( i < sequence->NbOpcodes ); i++ )
+    {
+        if( SX126xEmuGetTransaction( i )->Opcode != sequence->Opcodes[i] )
+        {
+            printf( "%s: transaction %u opcode %02X, %02X expected\n", sequence->Name, i,
+                    SX126xEmuGetTransaction( i )->Opcode, sequence->Opcodes[i] );
+            errors++;
+        }
+    }
+    if( ( stats.NbBusyViolations != 0 ) || ( stats.NbUnknownCommands != 0 ) )
+    {
+        printf( "%s: %u BUSY violations, %u unknown commands\n", sequence->Name, ( unsigned )stats.NbBusyViolations,
+                ( unsigned )stats.NbUnknownCommands );
+        errors++;
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckSend( void )
+{
+    uint32_t errors = 0;
+    uint8_t frame[16];
+
+    for( uint8_t i = 0; i < sizeof( frame ); i++ )
+    {
+        frame[i] = i;
+    }
+    Radio.SetTxConfig( MODEM_LORA, 14, 0, 0, 7, 1, 8, false, true, 0, 0, false, 4000 );
+
+    SX126xEmuResetStats( );
+    Radio.Send( frame, sizeof( frame ) );
+    errors += BenchCheckSequence( &BenchSend );
+
+    if( BenchWaitIrq( ) == false )
+    {
+        printf( "Send: no IRQ\n" );
+        return errors + 1;
+    }
+    errors += BenchCheckSequence( &BenchTxDone );
+    if( ( BenchEvents.NbTxDone != 1 ) || ( BenchEvents.NbOthers != 0 ) )
+    {
+        printf( "Send: %u TxDone, %u other events\n", ( unsigned )BenchEvents.NbTxDone,
+                ( unsigned )BenchEvents.NbOthers );
+        errors++;
+    }
+    return errors;
+}
+
+static uint32_t BenchCheckRx( void )
+{
+    uint32_t errors = 0;
+    uint8_t frame[32];
+
+    for( uint8_t i = 0; i < sizeof( frame ); i++ )
+    {
+        frame[i] = 0xA0 ^ i;
+    }
+    Radio.SetRxConfig( MODEM_LORA, 0, 7, 1, 0, 8, 12, false, 0, true, 0, 0, false, false );
+
+    // Frame received
+    SX126xEmuResetStats( );
+    Radio.Rx( 3000 );
+    errors += BenchCheckSequence( &BenchRx );
+
+    SX126xEmuAdvanceTime( 1000000 );
+    if( SX126xEmuReceive( frame, sizeof( frame ), -80, 8, true ) == false )
+    {
+        printf( "Rx: chip not receiving\n" );
+        return errors + 1;
+    }
+    if( BenchWaitIrq( ) == false )
+    {
+        printf( "Rx: no IRQ\n" );
+        return errors + 1;
+    }
+    errors += BenchCheckSequence( &BenchRxDone );
+    if( ( BenchEvents.NbRxDone != 1 ) || ( BenchEvents.Size != sizeof( frame ) ) ||
+        ( memcmp( BenchEvents.Payload, frame, sizeof( frame ) ) != 0 ) || ( BenchEvents.NbOthers != 0 ) )
+    {
+        printf( "Rx: %u RxDone of %u bytes, %u other events\n", ( unsigned )BenchEvents.NbRxDone,
+                BenchEvents.Size, ( unsigned )BenchEvents.NbOthers );
+        errors++;
+    }
+
+    // Window closed by the symbol timeout
+    SX126xEmuResetStats( );
+    Radio.Rx( 3000 );
+    errors += BenchCheckSequence( &BenchRx );
+    if( BenchWaitIrq( ) == false )
+    {
+        printf( "Rx timeout: no IRQ\n" );
+        return errors + 1;
+    }
+    errors += BenchCheckSequence( &BenchRxTimeout );
+    if( ( BenchEvents.NbRxTimeout != 1 ) || ( BenchEvents.NbOthers != 0 ) )
+    {
+        printf( "Rx timeout: %u RxTimeout, %u other events\n", ( unsigned )BenchEvents.NbRxTimeout,
+                ( unsigned )BenchEvents.NbOthers );
+        errors++;
+    }
+    return errors;
+}
+
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/*!
+ * \brief Radio.Send interrupted by a DIO1 edge
+ */
+static uint32_t BenchCheckSendHeld( void )
+{
+    uint32_t errors = 0;
+    uint8_t frame[16] = { 0 };
+
+    Radio.SetTxConfig( MODEM_LORA, 14, 0, 0, 7, 1, 8, false, true, 0, 0, false, 4000 );
+
+    SX126xEmuResetStats( );
+    BenchDio1.IsEdgeArmed = true;
+    Radio.Send( frame, sizeof( frame ) );
+    errors += BenchCheckSequence( &BenchSendHeld );
+    BenchSwIrq.NbRunsWaited = BenchSwIrq.NbRuns;
+
+    if( BenchWaitIrq( ) == false )
+    {
+        printf( "Send held: no IRQ\n" );
+        return errors + 1;
+    }
+    if( ( BenchEvents.NbTxDone != 1 ) || ( BenchEvents.NbOthers != 0 ) )
+    {
+        printf( "Send held: %u TxDone, %u other events\n", ( unsigned )BenchEvents.NbTxDone,
+                ( unsigned )BenchEvents.NbOthers );
+        errors++;
+    }
+    return errors;
+}
+#endif
+
+/*!
+ * \brief LoRa SetTx on the power on modulation parameters
+ */
+static uint32_t BenchCheckTxWithoutModulation( void )
+{
+    uint8_t frame[8] = { 0 };
+    SX126xEmuStats_t stats;
+
+    SX126xReset( );
+    SX126xWaitOnBusy( );
+    SX126xSetPacketType( PACKET_TYPE_LORA );
+    SX126xSetDioIrqParams( IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT, IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT, IRQ_RADIO_NONE,
+                           IRQ_RADIO_NONE );
+    SX126xSendPayload( frame, sizeof( frame ), 0 );
+    SX126xEmuGetStats( &stats );
+    if( ( BenchWaitIrq( ) == false ) || ( BenchEvents.NbTxDone != 1 ) || ( stats.NbBusyViolations != 0 ) )
+    {
+        printf( "Tx without modulation parameters: %u TxDone, %u BUSY violations\n",
+                ( unsigned )BenchEvents.NbTxDone, ( unsigned )stats.NbBusyViolations );
+        return 1;
+    }
+    printf( "Tx without modulation parameters: TxDone\n" );
+    return 0;
+}
+
+int main( void )
+{
+    uint32_t errors = 0;
+
+    BenchRadioEvents.TxDone = BenchOnTxDone;
+    BenchRadioEvents.RxDone = BenchOnRxDone;
+    BenchRadioEvents.TxTimeout = BenchOnOther;
+    BenchRadioEvents.RxTimeout = BenchOnRxTimeout;
+    BenchRadioEvents.RxError = BenchOnRxError;
+
+    SX126xEmuInit( NULL );
+    // Done by BoardInitMcu on the target
+    SX126xIoInit( );
+    Radio.Init( &BenchRadioEvents );
+    Radio.SetChannel( 868100000 );
+
+    memset( &BenchEvents, 0, sizeof( BenchEvents ) );
+    errors += BenchCheckSend( );
+    memset( &BenchEvents, 0, sizeof( BenchEvents ) );
+    errors += BenchCheckRx( );
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+    memset( &BenchEvents, 0, sizeof( BenchEvents ) );
+    errors += BenchCheckSendHeld( );
+#endif
+    memset( &BenchEvents, 0, sizeof( BenchEvents ) );
+    errors += BenchCheckTxWithoutModulation( );
+
+    printf( "%u errors\n", ( unsigned )errors );
+    return ( errors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,884 @@
+/*!
+ * \file      sx126x-emu.c
+ *
+ * \brief     SX126x SPI command emulator implementation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include <string.h>
+#include <stddef.h>
+#include "sx126x.h"
+#include "sx126x-emu.h"
+
+/*!
+ * Time of an event that never happens
+ */
+#define SX126X_EMU_TIME_NEVER                       UINT64_MAX
+
+/*!
+ * Duration of a timeout step of the SetRx / SetTx commands [ns]
+ */
+#define SX126X_EMU_TIMEOUT_STEP                     15625
+
+/*!
+ * SetRx timeout value of the continuous reception
+ */
+#define SX126X_EMU_RX_CONTINUOUS                    0xFFFFFF
+
+/*!
+ * Command status codes of the GetStatus byte
+ */
+#define SX126X_EMU_CMD_STATUS_NONE                  0x00
+#define SX126X_EMU_CMD_STATUS_DATA_AVAILABLE        0x02
+#define SX126X_EMU_CMD_STATUS_TIMEOUT               0x03
+#define SX126X_EMU_CMD_STATUS_PROCESSING_ERROR      0x04
+#define SX126X_EMU_CMD_STATUS_TX_DONE               0x06
+
+/*!
+ * SetTxFallbackMode parameter values
+ */
+#define SX126X_EMU_FALLBACK_FS                      0x40
+#define SX126X_EMU_FALLBACK_STDBY_XOSC              0x30
+
+/*!
+ * Typical timing of the datasheet. The SPI clock is the one of board-config.h
+ */
+static const SX126xEmuTiming_t SX126xEmuDefaultTiming =
+{
+    .SpiClock             = 500000,
+    .NssTime              = 500,
+    .BusyPollTime         = 100,
+    .CommandTime          = 2000,
+    .WarmStartTime        = 340000,
+    .ColdStartTime        = 3500000,
+    .StdbyXoscTime        = 31000,
+    .FsTime               = 50000,
+    .TxTime               = 126000,
+    .RxTime               = 83000,
+    .CalibrationTime      = 3500000,
+    .ImageCalibrationTime = 1000000,
+};
+
+/*!
+ * LoRa bandwidths in Hz indexed by RadioLoRaBandwidths_t
+ */
+static const uint32_t SX126xEmuLoRaBandwidths[] = { 7810, 15630, 31250, 62500, 125000, 250000, 500000, 0, 10420, 20830, 41670 };
+
+/*!
+ * Emulator context
+ */
+static struct
+{
+    SX126xEmuTiming_t Timing;
+    uint64_t Time;
+    /*!
+     * BUSY falling edge time
+     */
+    uint64_t BusyEnd;
+    RadioOperatingModes_t Mode;
+    bool ConfigRetained;
+    RadioOperatingModes_t TxFallbackMode;
+    uint8_t CommandStatus;
+    uint8_t PacketType;
+    uint8_t ModulationParams[8];
+    uint8_t PacketParams[9];
+    uint8_t CadSymbols;
+    uint8_t TxBaseAddress;
+    uint8_t RxBaseAddress;
+    uint16_t IrqMask;
+    uint16_t Dio1Mask;
+    uint16_t IrqStatus;
+    bool RxContinuous;
+    uint8_t RxPayloadLength;
+    uint8_t RxStartPointer;
+    uint8_t PacketStatus[3];
+    uint16_t NbPacketsReceived;
+    uint16_t NbCrcErrors;
+    uint16_t NbHeaderErrors;
+    int16_t RssiInst;
+    uint32_t Random;
+    /*!
+     * Pending chip event: IRQ raised and mode entered at EventTime
+     */
+    uint64_t EventTime;
+    uint16_t EventIrq;
+    RadioOperatingModes_t EventMode;
+    /*!
+     * Ongoing transaction
+     */
+    bool IsNssLow;
+    bool IsIgnored;
+    uint16_t Index;
+    uint8_t Opcode;
+    uint16_t Address;
+    uint8_t Params[16];
+    uint8_t Response[6];
+    /*!
+     * DIO1 rising edge handler
+     */
+    void ( *Dio1Handler )( void* context );
+    void* Dio1Context;
+    bool IsDio1EdgePending;
+    uint8_t Registers[SX126X_EMU_NB_REGISTERS];
+    uint8_t Buffer[256];
+    SX126xEmuStats_t Stats;
+    uint64_t StatsStartTime;
+    SX126xEmuTransaction_t Trace[SX126X_EMU_TRACE_SIZE];
+    uint16_t TraceLength;
+    SX126xEmuTransaction_t* LastTransaction;
+}SX126xEmu;
+
+/*!
+ * \brief Restores the power on configuration
+ */
+static void SX126xEmuResetConfig( void )
+{
+    memset( SX126xEmu.Registers, 0, sizeof( SX126xEmu.Registers ) );
+    memset( SX126xEmu.Buffer, 0, sizeof( SX126xEmu.Buffer ) );
+    SX126xEmu.Registers[REG_LR_SYNCWORD] = 0x14;
+    SX126xEmu.Registers[REG_LR_SYNCWORD + 1] = 0x24;
+    SX126xEmu.Registers[REG_OCP] = 0x18;
+
+    SX126xEmu.TxFallbackMode = MODE_STDBY_RC;
+    SX126xEmu.PacketType = PACKET_TYPE_GFSK;
+    memset( SX126xEmu.ModulationParams, 0, sizeof( SX126xEmu.ModulationParams ) );
+    memset( SX126xEmu.PacketParams, 0, sizeof( SX126xEmu.PacketParams ) );
+    SX126xEmu.CadSymbols = LORA_CAD_01_SYMBOL;
+    SX126xEmu.TxBaseAddress = 0;
+    SX126xEmu.RxBaseAddress = 0;
+    SX126xEmu.IrqMask = 0;
+    SX126xEmu.Dio1Mask = 0;
+    SX126xEmu.IrqStatus = 0;
+    SX126xEmu.RxPayloadLength = 0;
+    SX126xEmu.RxStartPointer = 0;
+    memset( SX126xEmu.PacketStatus, 0, sizeof( SX126xEmu.PacketStatus ) );
+}
+
+/*!
+ * \brief Cancels the pending chip event
+ */
+static void SX126xEmuStopEvent( void )
+{
+    SX126xEmu.EventTime = SX126X_EMU_TIME_NEVER;
+    SX126xEmu.EventIrq = IRQ_RADIO_NONE;
+}
+
+/*!
+ * \brief Schedules the chip event
+ *
+ * \param [IN] time Event time
+ * \param [IN] irq  IRQ raised
+ * \param [IN] mode Mode entered
+ */
+static void SX126xEmuStartEvent( uint64_t time, uint16_t irq, RadioOperatingModes_t mode )
+{
+    SX126xEmu.EventTime = time;
+    SX126xEmu.EventIrq = irq;
+    SX126xEmu.EventMode = mode;
+}
+
+/*!
+ * \brief Raises IRQs and latches the DIO1 rising edge
+ *
+ * \param [IN] irq IRQs raised, the ones out of the IRQ mask are dropped
+ */
+static void SX126xEmuSetIrq( uint16_t irq )
+{
+    uint8_t dio1 = SX126xEmuGetDio1( );
+
+    SX126xEmu.IrqStatus |= irq & SX126xEmu.IrqMask;
+    if( ( dio1 == 0 ) && ( SX126xEmuGetDio1( ) != 0 ) )
+    {
+        SX126xEmu.IsDio1EdgePending = true;
+    }
+}
+
+/*!
+ * \brief Advances the virtual clock and processes the due chip event
+ *
+ * \param [IN] time Time to advance by [ns]
+ */
+static void SX126xEmuElapse( uint64_t time )
+{
+    SX126xEmu.Time += time;
+
+    if( SX126xEmu.EventTime <= SX126xEmu.Time )
+    {
+        uint16_t irq = SX126xEmu.EventIrq;
+
+        SX126xEmu.Mode = SX126xEmu.EventMode;
+        SX126xEmuStopEvent( );
+
+        if( ( irq & IRQ_TX_DONE ) != 0 )
+        {
+            SX126xEmu.CommandStatus = SX126X_EMU_CMD_STATUS_TX_DONE;
+        }
+        else if( ( irq & IRQ_RX_TX_TIMEOUT ) != 0 )
+        {
+            SX126xEmu.CommandStatus = SX126X_EMU_CMD_STATUS_TIMEOUT;
+        }
+        SX126xEmuSetIrq( irq );
+    }
+}
+
+/*!
+ * \brief Calls the DIO1 handler on a latched rising edge
+ */
+static void SX126xEmuReportDio1Edge( void )
+{
+    if( ( SX126xEmu.IsDio1EdgePending == true ) && ( SX126xEmu.IsNssLow == false ) )
+    {
+        SX126xEmu.IsDio1EdgePending = false;
+        if( SX126xEmu.Dio1Handler != NULL )
+        {
+            SX126xEmu.Dio1Handler( SX126xEmu.Dio1Context );
+        }
+    }
+}
+
+/*!
+ * \brief Builds the GetStatus byte
+ *
+ * \retval status Status byte
+ */
+static uint8_t SX126xEmuGetStatus( void )
+{
+    uint8_t chipMode;
+
+    switch( SX126xEmu.Mode )
+    {
+        case MODE_STDBY_XOSC:
+            chipMode = 0x03;
+            break;
+        case MODE_FS:
+            chipMode = 0x04;
+            break;
+        case MODE_RX:
+        case MODE_RX_DC:
+        case MODE_CAD:
+            chipMode = 0x05;
+            break;
+        case MODE_TX:
+            chipMode = 0x06;
+            break;
+        default:
+            chipMode = 0x02;
+            break;
+    }
+    return ( chipMode << 4 ) | ( SX126xEmu.CommandStatus << 1 );
+}
+
+/*!
+ * \brief Reads a register
+ *
+ * \param [IN] address Register address
+ *
+ * \retval value Register value
+ */
+static uint8_t SX126xEmuReadRegister( uint16_t address )
+{
+    address %= SX126X_EMU_NB_REGISTERS;
+
+    if( ( address >= RANDOM_NUMBER_GENERATORBASEADDR ) && ( address < ( RANDOM_NUMBER_GENERATORBASEADDR + 4 ) ) )
+    {
+        // xorshift32
+        SX126xEmu.Random ^= SX126xEmu.Random << 13;
+        SX126xEmu.Random ^= SX126xEmu.Random >> 17;
+        SX126xEmu.Random ^= SX126xEmu.Random << 5;
+        return ( uint8_t )SX126xEmu.Random;
+    }
+    return SX126xEmu.Registers[address];
+}
+
+/*!
+ * \brief Computes the LoRa symbol time
+ *
+ * \retval time Symbol time [ns]
+ */
+static uint64_t SX126xEmuGetLoRaSymbolTime( void )
+{
+    uint8_t sf = SX126xEmu.ModulationParams[0];
+    uint8_t bw = SX126xEmu.ModulationParams[1];
+
+    if( ( sf > LORA_SF12 ) || ( bw >= ( sizeof( SX126xEmuLoRaBandwidths ) / sizeof( SX126xEmuLoRaBandwidths[0] ) ) ) ||
+        ( SX126xEmuLoRaBandwidths[bw] == 0 ) )
+    {
+        return 0;
+    }
+    return ( ( uint64_t )1000000000 << sf ) / SX126xEmuLoRaBandwidths[bw];
+}
+
+/*!
+ * \brief Computes the time on air of the packet configured by the modulation
+ *        and packet parameters
+ *
+ * \retval time Time on air [ns, 0: LR-FHSS or modulation not set]
+ */
+static uint64_t SX126xEmuGetTimeOnAir( void )
+{
+    if( SX126xEmu.PacketType == PACKET_TYPE_LORA )
+    {
+        uint8_t sf = SX126xEmu.ModulationParams[0];
+        uint8_t cr = SX126xEmu.ModulationParams[2];
+        bool ldro = SX126xEmu.ModulationParams[3] != 0;
+        uint16_t preambleLen = ( SX126xEmu.PacketParams[0] << 8 ) | SX126xEmu.PacketParams[1];
+        bool explicitHeader = SX126xEmu.PacketParams[2] == LORA_PACKET_EXPLICIT;
+        uint8_t payloadLen = SX126xEmu.PacketParams[3];
+        bool crcOn = SX126xEmu.PacketParams[4] == LORA_CRC_ON;
+        int32_t numerator = ( payloadLen << 3 ) + ( crcOn ? 16 : 0 ) - ( 4 * sf ) + ( explicitHeader ? 20 : 0 );
+        int32_t denominator = 4 * sf;
+        // Preamble in quarters of symbol: the hardware adds 4.25 symbols,
+        // 6.25 for SF5 and SF6
+        uint64_t quarters = ( 4 * ( uint64_t )preambleLen ) + ( ( sf <= LORA_SF6 ) ? 25 : 17 );
+
+        // SetTx before SetModulationParams: the parameters are those of the
+        // power on reset, without spreading factor
+        if( ( sf < LORA_SF5 ) || ( sf > LORA_SF12 ) )
+        {
+            return 0;
+        }
+        if( sf > LORA_SF6 )
+        {
+            numerator += 8;
+            if( ldro == true )
+            {
+                denominator = 4 * ( sf - 2 );
+            }
+        }
+        if( numerator < 0 )
+        {
+            numerator = 0;
+        }
+        quarters += 4 * ( 8 + ( ( ( numerator + denominator - 1 ) / denominator ) * ( cr + 4 ) ) );
+        return ( quarters * SX126xEmuGetLoRaSymbolTime( ) ) / 4;
+    }
+    if( SX126xEmu.PacketType == PACKET_TYPE_GFSK )
+    {
+        uint32_t bitrate = ( SX126xEmu.ModulationParams[0] << 16 ) | ( SX126xEmu.ModulationParams[1] << 8 ) |
+                           SX126xEmu.ModulationParams[2];
+        uint64_t bits = ( SX126xEmu.PacketParams[0] << 8 ) | SX126xEmu.PacketParams[1];
+
+        bits += SX126xEmu.PacketParams[3];
+        bits += ( SX126xEmu.PacketParams[4] != RADIO_ADDRESSCOMP_FILT_OFF ) ? 8 : 0;
+        bits += ( SX126xEmu.PacketParams[5] == RADIO_PACKET_VARIABLE_LENGTH ) ? 8 : 0;
+        bits += SX126xEmu.PacketParams[6] << 3;
+        switch( SX126xEmu.PacketParams[7] )
+        {
+            case RADIO_CRC_OFF:
+                break;
+            case RADIO_CRC_1_BYTES:
+            case RADIO_CRC_1_BYTES_INV:
+                bits += 8;
+                break;
+            default:
+                bits += 16;
+                break;
+        }
+        // The bit rate register holds 32 * Fxtal / bitrate
+        return ( bits * bitrate * 125 ) / 128;
+    }
+    return 0;
+}
+
+/*!
+ * \brief Prepares the response of a read command
+ */
+static void SX126xEmuPrepareResponse( void )
+{
+    uint8_t* response = SX126xEmu.Response;
+
+    memset( response, 0, sizeof( SX126xEmu.Response ) );
+    switch( SX126xEmu.Opcode )
+    {
+        case RADIO_GET_PACKETTYPE:
+            response[0] = SX126xEmu.PacketType;
+            break;
+        case RADIO_GET_RXBUFFERSTATUS:
+            response[0] = SX126xEmu.RxPayloadLength;
+            response[1] = SX126xEmu.RxStartPointer;
+            break;
+        case RADIO_GET_PACKETSTATUS:
+            memcpy( response, SX126xEmu.PacketStatus, sizeof( SX126xEmu.PacketStatus ) );
+            break;
+        case RADIO_GET_RSSIINST:
+            response[0] = ( uint8_t )( -2 * SX126xEmu.RssiInst );
+            break;
+        case RADIO_GET_STATS:
+            response[0] = SX126xEmu.NbPacketsReceived >> 8;
+            response[1] = ( uint8_t )SX126xEmu.NbPacketsReceived;
+            response[2] = SX126xEmu.NbCrcErrors >> 8;
+            response[3] = ( uint8_t )SX126xEmu.NbCrcErrors;
+            response[4] = SX126xEmu.NbHeaderErrors >> 8;
+            response[5] = ( uint8_t )SX126xEmu.NbHeaderErrors;
+            break;
+        case RADIO_GET_IRQSTATUS:
+            response[0] = SX126xEmu.IrqStatus >> 8;
+            response[1] = ( uint8_t )SX126xEmu.IrqStatus;
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+ * \brief Executes the command of the transaction on the NSS rising edge
+ */
+static void SX126xEmuExecute( void )
+{
+    const uint8_t* params = SX126xEmu.Params;
+    uint32_t busyTime = SX126xEmu.Timing.CommandTime;
+    uint64_t timeout;
+
+    switch( SX126xEmu.Opcode )
+    {
+        case RADIO_GET_STATUS:
+        case RADIO_GET_PACKETTYPE:
+        case RADIO_GET_RXBUFFERSTATUS:
+        case RADIO_GET_PACKETSTATUS:
+        case RADIO_GET_RSSIINST:
+        case RADIO_GET_STATS:
+        case RADIO_GET_IRQSTATUS:
+        case RADIO_GET_ERROR:
+        case RADIO_WRITE_REGISTER:
+        case RADIO_READ_REGISTER:
+        case RADIO_WRITE_BUFFER:
+        case RADIO_READ_BUFFER:
+        case RADIO_CLR_ERROR:
+        case RADIO_SET_RFFREQUENCY:
+        case RADIO_SET_TXPARAMS:
+        case RADIO_SET_PACONFIG:
+        case RADIO_SET_REGULATORMODE:
+        case RADIO_SET_TCXOMODE:
+        case RADIO_SET_RFSWITCHMODE:
+        case RADIO_SET_STOPRXTIMERONPREAMBLE:
+        case RADIO_SET_LORASYMBTIMEOUT:
+            break;
+        case RADIO_SET_SLEEP:
+            SX126xEmu.ConfigRetained = ( params[0] & 0x04 ) != 0;
+            SX126xEmu.Mode = MODE_SLEEP;
+            SX126xEmuStopEvent( );
+            // BUSY stays high until the wake up
+            return;
+        case RADIO_SET_STANDBY:
+            if( params[0] == STDBY_XOSC )
+            {
+                if( SX126xEmu.Mode == MODE_STDBY_RC )
+                {
+                    busyTime = SX126xEmu.Timing.StdbyXoscTime;
+                }
+                SX126xEmu.Mode = MODE_STDBY_XOSC;
+            }
+            else
+            {
+                SX126xEmu.Mode = MODE_STDBY_RC;
+            }
+            SX126xEmuStopEvent( );
+            break;
+        case RADIO_SET_FS:
+            busyTime = SX126xEmu.Timing.FsTime;
+            SX126xEmu.Mode = MODE_FS;
+            SX126xEmuStopEvent( );
+            break;
+        case RADIO_SET_TX:
+            busyTime = SX126xEmu.Timing.TxTime;
+            SX126xEmu.Mode = MODE_TX;
+            timeout = ( ( uint64_t )( ( params[0] << 16 ) | ( params[1] << 8 ) | params[2] ) ) * SX126X_EMU_TIMEOUT_STEP;
+            if( ( timeout != 0 ) && ( timeout < SX126xEmuGetTimeOnAir( ) ) )
+            {
+                SX126xEmuStartEvent( SX126xEmu.Time + busyTime + timeout, IRQ_RX_TX_TIMEOUT, SX126xEmu.TxFallbackMode );
+            }
+            else
+            {
+                SX126xEmuStartEvent( SX126xEmu.Time + busyTime + SX126xEmuGetTimeOnAir( ), IRQ_TX_DONE, SX126xEmu.TxFallbackMode );
+            }
+            break;
+        case RADIO_SET_RX:
+            busyTime = SX126xEmu.Timing.RxTime;
+            SX126xEmu.Mode = MODE_RX;
+            timeout = ( params[0] << 16 ) | ( params[1] << 8 ) | params[2];
+            SX126xEmu.RxContinuous = timeout == SX126X_EMU_RX_CONTINUOUS;
+            SX126xEmuStopEvent( );
+            if( ( timeout != 0 ) && ( SX126xEmu.RxContinuous == false ) )
+            {
+                SX126xEmuStartEvent( SX126xEmu.Time + busyTime + ( timeout * SX126X_EMU_TIMEOUT_STEP ), IRQ_RX_TX_TIMEOUT, MODE_STDBY_RC );
+            }
+            break;
+        case RADIO_SET_RXDUTYCYCLE:
+            busyTime = SX126xEmu.Timing.RxTime;
+            SX126xEmu.Mode = MODE_RX_DC;
+            SX126xEmuStopEvent( );
+            break;
+        case RADIO_SET_CAD:
+            busyTime = SX126xEmu.Timing.RxTime;
+            SX126xEmu.Mode = MODE_CAD;
+            SX126xEmuStartEvent( SX126xEmu.Time + busyTime + ( ( uint64_t )( 1 << SX126xEmu.CadSymbols ) * SX126xEmuGetLoRaSymbolTime( ) ),
+                                 IRQ_CAD_DONE, MODE_STDBY_RC );
+            break;
+        case RADIO_SET_TXCONTINUOUSWAVE:
+        case RADIO_SET_TXCONTINUOUSPREAMBLE:
+            busyTime = SX126xEmu.Timing.TxTime;
+            SX126xEmu.Mode = MODE_TX;
+            SX126xEmuStopEvent( );
+            break;
+        case RADIO_SET_PACKETTYPE:
+            SX126xEmu.PacketType = params[0];
+            break;
+        case RADIO_SET_MODULATIONPARAMS:
+            memcpy( SX126xEmu.ModulationParams, params, sizeof( SX126xEmu.ModulationParams ) );
+            break;
+        case RADIO_SET_PACKETPARAMS:
+            memcpy( SX126xEmu.PacketParams, params, sizeof( SX126xEmu.PacketParams ) );
+            break;
+        case RADIO_SET_CADPARAMS:
+            SX126xEmu.CadSymbols = ( params[0] <= LORA_CAD_16_SYMBOL ) ? params[0] : LORA_CAD_16_SYMBOL;
+            break;
+        case RADIO_SET_BUFFERBASEADDRESS:
+            SX126xEmu.TxBaseAddress = params[0];
+            SX126xEmu.RxBaseAddress = params[1];
+            break;
+        case RADIO_CFG_DIOIRQ:
+            SX126xEmu.IrqMask = ( params[0] << 8 ) | params[1];
+            SX126xEmu.Dio1Mask = ( params[2] << 8 ) | params[3];
+            break;
+        case RADIO_CLR_IRQSTATUS:
+            SX126xEmu.IrqStatus &= ~( ( params[0] << 8 ) | params[1] );
+            break;
+        case RADIO_RESET_STATS:
+            SX126xEmu.NbPacketsReceived = 0;
+            SX126xEmu.NbCrcErrors = 0;
+            SX126xEmu.NbHeaderErrors = 0;
+            break;
+        case RADIO_CALIBRATE:
+            busyTime = SX126xEmu.Timing.CalibrationTime;
+            break;
+        case RADIO_CALIBRATEIMAGE:
+            busyTime = SX126xEmu.Timing.ImageCalibrationTime;
+            break;
+        case RADIO_SET_TXFALLBACKMODE:
+            if( params[0] == SX126X_EMU_FALLBACK_FS )
+            {
+                SX126xEmu.TxFallbackMode = MODE_FS;
+            }
+            else if( params[0] == SX126X_EMU_FALLBACK_STDBY_XOSC )
+            {
+                SX126xEmu.TxFallbackMode = MODE_STDBY_XOSC;
+            }
+            else
+            {
+                SX126xEmu.TxFallbackMode = MODE_STDBY_RC;
+            }
+            break;
+        default:
+            SX126xEmu.Stats.NbUnknownCommands++;
+            SX126xEmu.CommandStatus = SX126X_EMU_CMD_STATUS_PROCESSING_ERROR;
+            break;
+    }
+    SX126xEmu.BusyEnd = SX126xEmu.Time + busyTime;
+}
+
+void SX126xEmuInit( const SX126xEmuTiming_t* timing )
+{
+    memset( &SX126xEmu, 0, sizeof( SX126xEmu ) );
+    SX126xEmu.Timing = ( timing != NULL ) ? *timing : SX126xEmuDefaultTiming;
+    if( SX126xEmu.Timing.SpiClock == 0 )
+    {
+        SX126xEmu.Timing.SpiClock = SX126xEmuDefaultTiming.SpiClock;
+    }
+    SX126xEmu.Random = 0x2545F491;
+
+    SX126xEmuReset( );
+    SX126xEmu.BusyEnd = 0;
+    SX126xEmuResetStats( );
+}
+
+void SX126xEmuReset( void )
+{
+    SX126xEmuResetConfig( );
+    SX126xEmuStopEvent( );
+    SX126xEmu.Mode = MODE_STDBY_RC;
+    SX126xEmu.CommandStatus = SX126X_EMU_CMD_STATUS_NONE;
+    SX126xEmu.IsNssLow = false;
+    SX126xEmu.IsDio1EdgePending = false;
+    SX126xEmu.BusyEnd = SX126xEmu.Time + SX126xEmu.Timing.ColdStartTime;
+}
+
+void SX126xEmuSetNss( uint8_t level )
+{
+    if( level == 0 )
+    {
+        if( SX126xEmu.IsNssLow == true )
+        {
+            return;
+        }
+        SX126xEmu.IsNssLow = true;
+        SX126xEmu.IsIgnored = false;
+        SX126xEmu.Index = 0;
+
+        SX126xEmu.LastTransaction = NULL;
+        if( SX126xEmu.TraceLength < SX126X_EMU_TRACE_SIZE )
+        {
+            SX126xEmu.LastTransaction = &SX126xEmu.Trace[SX126xEmu.TraceLength++];
+            memset( SX126xEmu.LastTransaction, 0, sizeof( SX126xEmuTransaction_t ) );
+            SX126xEmu.LastTransaction->StartTime = SX126xEmu.Time;
+        }
+        SX126xEmu.Stats.NbTransactions++;
+        SX126xEmu.Stats.SpiTime += SX126xEmu.Timing.NssTime;
+        SX126xEmuElapse( SX126xEmu.Timing.NssTime );
+
+        if( ( SX126xEmu.Mode == MODE_SLEEP ) || ( SX126xEmu.Mode == MODE_RX_DC ) )
+        {
+            // The falling edge wakes the chip up, the command is not executed
+            if( ( SX126xEmu.Mode == MODE_SLEEP ) && ( SX126xEmu.ConfigRetained == false ) )
+            {
+                SX126xEmuResetConfig( );
+                SX126xEmu.BusyEnd = SX126xEmu.Time + SX126xEmu.Timing.ColdStartTime;
+            }
+            else
+            {
+                SX126xEmu.BusyEnd = SX126xEmu.Time + SX126xEmu.Timing.WarmStartTime;
+            }
+            SX126xEmu.Mode = MODE_STDBY_RC;
+            SX126xEmu.IsIgnored = true;
+        }
+        else if( SX126xEmu.Time < SX126xEmu.BusyEnd )
+        {
+            SX126xEmu.Stats.NbBusyViolations++;
+            SX126xEmu.IsIgnored = true;
+        }
+    }
+    else if( SX126xEmu.IsNssLow == true )
+    {
+        SX126xEmu.IsNssLow = false;
+        if( ( SX126xEmu.IsIgnored == false ) && ( SX126xEmu.Index > 0 ) )
+        {
+            SX126xEmuExecute( );
+        }
+    }
+}
+
+uint8_t SX126xEmuSpiInOut( uint8_t data )
+{
+    uint64_t byteTime = 8000000000ULL / SX126xEmu.Timing.SpiClock;
+    uint16_t index = SX126xEmu.Index;
+    uint8_t status;
+
+    SX126xEmu.Stats.NbBytes++;
+    SX126xEmu.Stats.SpiTime += byteTime;
+    SX126xEmuElapse( byteTime );
+
+    if( ( SX126xEmu.IsNssLow == false ) || ( SX126xEmu.IsIgnored == true ) )
+    {
+        return 0x00;
+    }
+    if( SX126xEmu.LastTransaction != NULL )
+    {
+        SX126xEmu.LastTransaction->Size++;
+    }
+    SX126xEmu.Index++;
+    status = SX126xEmuGetStatus( );
+
+    if( index == 0 )
+    {
+        SX126xEmu.Opcode = data;
+        SX126xEmu.CommandStatus = SX126X_EMU_CMD_STATUS_NONE;
+        memset( SX126xEmu.Params, 0, sizeof( SX126xEmu.Params ) );
+        SX126xEmuPrepareResponse( );
+        if( SX126xEmu.LastTransaction != NULL )
+        {
+            SX126xEmu.LastTransaction->Opcode = data;
+        }
+        return status;
+    }
+
+    switch( SX126xEmu.Opcode )
+    {
+        case RADIO_WRITE_REGISTER:
+        case RADIO_READ_REGISTER:
+            if( index == 1 )
+            {
+                SX126xEmu.Address = data << 8;
+            }
+            else if( index == 2 )
+            {
+                SX126xEmu.Address |= data;
+            }
+            else if( SX126xEmu.Opcode == RADIO_WRITE_REGISTER )
+            {
+                SX126xEmu.Registers[( SX126xEmu.Address + index - 3 ) % SX126X_EMU_NB_REGISTERS] = data;
+            }
+            else if( index > 3 )
+            {
+                return SX126xEmuReadRegister( SX126xEmu.Address + index - 4 );
+            }
+            return status;
+        case RADIO_WRITE_BUFFER:
+        case RADIO_READ_BUFFER:
+            if( index == 1 )
+            {
+                SX126xEmu.Address = data;
+            }
+            else if( SX126xEmu.Opcode == RADIO_WRITE_BUFFER )
+            {
+                SX126xEmu.Buffer[( uint8_t )( SX126xEmu.Address + index - 2 )] = data;
+            }
+            else if( index > 2 )
+            {
+                return SX126xEmu.Buffer[( uint8_t )( SX126xEmu.Address + index - 3 )];
+            }
+            return status;
+        default:
+            if( ( size_t )( index - 1 ) < sizeof( SX126xEmu.Params ) )
+            {
+                SX126xEmu.Params[index - 1] = data;
+            }
+            if( ( index >= 2 ) && ( ( size_t )( index - 2 ) < sizeof( SX126xEmu.Response ) ) )
+            {
+                return SX126xEmu.Response[index - 2];
+            }
+            return status;
+    }
+}
+
+uint8_t SX126xEmuGetBusy( void )
+{
+    uint8_t busy = ( ( SX126xEmu.Mode == MODE_SLEEP ) || ( SX126xEmu.Time < SX126xEmu.BusyEnd ) ) ? 1 : 0;
+
+    SX126xEmu.Stats.NbBusyPolls++;
+    SX126xEmu.Stats.BusyTime += SX126xEmu.Timing.BusyPollTime;
+    if( SX126xEmu.LastTransaction != NULL )
+    {
+        SX126xEmu.LastTransaction->NbBusyPolls++;
+        SX126xEmu.LastTransaction->BusyTime += SX126xEmu.Timing.BusyPollTime;
+    }
+    SX126xEmuElapse( SX126xEmu.Timing.BusyPollTime );
+    return busy;
+}
+
+uint8_t SX126xEmuGetDio1( void )
+{
+    return ( ( SX126xEmu.IrqStatus & SX126xEmu.Dio1Mask ) != 0 ) ? 1 : 0;
+}
+
+void SX126xEmuSetDio1Handler( void ( *handler )( void* context ), void* context )
+{
+    SX126xEmu.Dio1Handler = handler;
+    SX126xEmu.Dio1Context = context;
+}
+
+uint64_t SX126xEmuGetTime( void )
+{
+    return SX126xEmu.Time;
+}
+
+void SX126xEmuAdvanceTime( uint64_t time )
+{
+    uint64_t end = SX126xEmu.Time + time;
+
+    do
+    {
+        uint64_t step = ( SX126xEmu.Time < end ) ? ( end - SX126xEmu.Time ) : 0;
+
+        if( ( SX126xEmu.EventTime > SX126xEmu.Time ) && ( SX126xEmu.EventTime < end ) )
+        {
+            step = SX126xEmu.EventTime - SX126xEmu.Time;
+        }
+        SX126xEmuElapse( step );
+        // The handler may access the chip and advance the clock
+        SX126xEmuReportDio1Edge( );
+    }while( SX126xEmu.Time < end );
+}
+
+bool SX126xEmuReceive( const uint8_t* payload, uint8_t size, int16_t rssi, int8_t snr, bool crcOk )
+{
+    uint16_t irq = IRQ_PREAMBLE_DETECTED | IRQ_RX_DONE;
+
+    if( ( SX126xEmu.Mode != MODE_RX ) && ( SX126xEmu.Mode != MODE_RX_DC ) )
+    {
+        return false;
+    }
+
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        SX126xEmu.Buffer[( uint8_t )( SX126xEmu.RxBaseAddress + i )] = payload[i];
+    }
+    SX126xEmu.RxPayloadLength = size;
+    SX126xEmu.RxStartPointer = SX126xEmu.RxBaseAddress;
+
+    if( SX126xEmu.PacketType == PACKET_TYPE_LORA )
+    {
+        irq |= IRQ_HEADER_VALID;
+        SX126xEmu.PacketStatus[0] = ( uint8_t )( -2 * rssi );
+        SX126xEmu.PacketStatus[1] = ( uint8_t )( snr * 4 );
+        SX126xEmu.PacketStatus[2] = ( uint8_t )( -2 * rssi );
+    }
+    else
+    {
+        irq |= IRQ_SYNCWORD_VALID;
+        SX126xEmu.PacketStatus[0] = ( crcOk == true ) ? 0x00 : IRQ_CRC_ERROR_CODE;
+        SX126xEmu.PacketStatus[1] = ( uint8_t )( -2 * rssi );
+        SX126xEmu.PacketStatus[2] = ( uint8_t )( -2 * rssi );
+    }
+
+    if( crcOk == true )
+    {
+        SX126xEmu.NbPacketsReceived++;
+    }
+    else
+    {
+        irq |= IRQ_CRC_ERROR;
+        SX126xEmu.NbCrcErrors++;
+    }
+
+    if( ( SX126xEmu.Mode == MODE_RX_DC ) || ( SX126xEmu.RxContinuous == false ) )
+    {
+        SX126xEmu.Mode = MODE_STDBY_RC;
+        SX126xEmuStopEvent( );
+    }
+    SX126xEmu.CommandStatus = SX126X_EMU_CMD_STATUS_DATA_AVAILABLE;
+    SX126xEmuSetIrq( irq );
+    SX126xEmuReportDio1Edge( );
+    return true;
+}
+
+void SX126xEmuSetRssiInst( int16_t rssi )
+{
+    SX126xEmu.RssiInst = rssi;
+}
+
+uint8_t SX126xEmuGetChipMode( void )
+{
+    return SX126xEmu.Mode;
+}
+
+uint8_t SX126xEmuGetRegister( uint16_t address )
+{
+    return SX126xEmu.Registers[address % SX126X_EMU_NB_REGISTERS];
+}
+
+void SX126xEmuResetStats( void )
+{
+    memset( &SX126xEmu.Stats, 0, sizeof( SX126xEmu.Stats ) );
+    SX126xEmu.StatsStartTime = SX126xEmu.Time;
+    SX126xEmu.TraceLength = 0;
+    SX126xEmu.LastTransaction = NULL;
+}
+
+void SX126xEmuGetStats( SX126xEmuStats_t* stats )
+{
+    *stats = SX126xEmu.Stats;
+    stats->ElapsedTime = SX126xEmu.Time - SX126xEmu.StatsStartTime;
+}
+
+uint16_t SX126xEmuGetTraceLength( void )
+{
+    return SX126xEmu.TraceLength;
+}
+
+const SX126xEmuTransaction_t* SX126xEmuGetTransaction( uint16_t index )
+{
+    if( index >= SX126xEmu.TraceLength )
+    {
+        return NULL;
+    }
+    return &SX126xEmu.Trace[index];
+}
@@ -0,0 +1,317 @@
+/*!
+ * \file      sx126x-emu.h
+ *
+ * \brief     SX126x SPI command emulator
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The emulator models the SX126x at its SPI and BUSY / DIO1 pins so
+ *            that the sx126x driver and the board layer run unmodified on a
+ *            host. It is not part of the firmware build. A host board
+ *            forwards the radio pins to it:
+ *            - SpiInOut on the radio SPI          -> SX126xEmuSpiInOut
+ *            - GpioWrite on RADIO_NSS_PIN         -> SX126xEmuSetNss
+ *            - GpioRead on RADIO_BUSY_PIN         -> SX126xEmuGetBusy
+ *            - GpioRead on RADIO_DIO_1_PIN        -> SX126xEmuGetDio1
+ *            - GpioSetInterrupt on RADIO_DIO_1_PIN -> SX126xEmuSetDio1Handler
+ *            - RADIO_RESET_PIN driven low         -> SX126xEmuReset
+ *            - DelayMs                            -> SX126xEmuAdvanceTime
+ *            bench/radio-spi-bench.c runs the radio driver this way.
+ *
+ *            The emulator keeps a virtual clock advanced by the SPI bytes,
+ *            the BUSY polls and SX126xEmuAdvanceTime. Commands keep BUSY high
+ *            for the time given by SX126xEmuTiming_t. Every NSS low period is
+ *            recorded as a transaction with its opcode, its size and the BUSY
+ *            polls that followed it, so that the SPI cost of a driver
+ *            operation is read back with SX126xEmuGetStats.
+ *
+ *            Modelled: register file, data buffer, packet type, modulation
+ *            and packet parameters, IRQ masks and status, Tx completion after
+ *            the LoRa / GFSK time on air, Rx / Tx timeouts, sleep with warm
+ *            or cold start, CAD completion ( never detects activity ).
+ *            Frames are given to the receiver with SX126xEmuReceive and are
+ *            reported at once. LR-FHSS transmissions end after the Tx
+ *            switching time.
+ */
+#ifndef __SX126X_EMU_H__
+#define __SX126X_EMU_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * Number of transactions kept in the trace
+ */
+#define SX126X_EMU_TRACE_SIZE                       256
+
+/*!
+ * Size of the register file
+ */
+#define SX126X_EMU_NB_REGISTERS                     0x1000
+
+/*!
+ * Emulator timing. All times in ns.
+ */
+typedef struct sSX126xEmuTiming
+{
+    /*!
+     * SPI clock [Hz]
+     */
+    uint32_t SpiClock;
+    /*!
+     * NSS setup and hold time of a transaction
+     */
+    uint32_t NssTime;
+    /*!
+     * Duration of a BUSY pin read
+     */
+    uint32_t BusyPollTime;
+    /*!
+     * BUSY time of a configuration or read command
+     */
+    uint32_t CommandTime;
+    /*!
+     * Sleep to STDBY_RC, configuration retained
+     */
+    uint32_t WarmStartTime;
+    /*!
+     * Sleep to STDBY_RC, configuration lost
+     */
+    uint32_t ColdStartTime;
+    /*!
+     * STDBY_RC to STDBY_XOSC
+     */
+    uint32_t StdbyXoscTime;
+    /*!
+     * STDBY_RC to FS
+     */
+    uint32_t FsTime;
+    /*!
+     * STDBY_RC to TX
+     */
+    uint32_t TxTime;
+    /*!
+     * STDBY_RC to RX
+     */
+    uint32_t RxTime;
+    /*!
+     * Calibration of all blocks
+     */
+    uint32_t CalibrationTime;
+    /*!
+     * Image calibration
+     */
+    uint32_t ImageCalibrationTime;
+}SX126xEmuTiming_t;
+
+/*!
+ * SPI transaction, NSS falling edge to NSS rising edge
+ */
+typedef struct sSX126xEmuTransaction
+{
+    /*!
+     * NSS falling edge time [ns]
+     */
+    uint64_t StartTime;
+    /*!
+     * Command opcode
+     */
+    uint8_t Opcode;
+    /*!
+     * Number of bytes exchanged, opcode included
+     */
+    uint16_t Size;
+    /*!
+     * Number of BUSY polls until the next transaction
+     */
+    uint16_t NbBusyPolls;
+    /*!
+     * Time spent polling BUSY until the next transaction [ns]
+     */
+    uint32_t BusyTime;
+}SX126xEmuTransaction_t;
+
+/*!
+ * SPI usage since the last SX126xEmuResetStats
+ */
+typedef struct sSX126xEmuStats
+{
+    /*!
+     * Number of transactions
+     */
+    uint32_t NbTransactions;
+    /*!
+     * Number of bytes exchanged
+     */
+    uint32_t NbBytes;
+    /*!
+     * Number of BUSY polls
+     */
+    uint32_t NbBusyPolls;
+    /*!
+     * Number of transactions started while BUSY was high. The chip ignores
+     * them.
+     */
+    uint32_t NbBusyViolations;
+    /*!
+     * Number of unknown opcodes
+     */
+    uint32_t NbUnknownCommands;
+    /*!
+     * Time spent exchanging bytes, NSS setup and hold included [ns]
+     */
+    uint64_t SpiTime;
+    /*!
+     * Time spent polling BUSY [ns]
+     */
+    uint64_t BusyTime;
+    /*!
+     * Virtual time elapsed [ns]
+     */
+    uint64_t ElapsedTime;
+}SX126xEmuStats_t;
+
+/*!
+ * \brief Initializes the emulator in STDBY_RC, clears the virtual clock,
+ *        the statistics and the trace
+ *
+ * \param [IN] timing Emulator timing [NULL: typical datasheet values]
+ */
+void SX126xEmuInit( const SX126xEmuTiming_t* timing );
+
+/*!
+ * \brief Resets the chip. The configuration is lost.
+ */
+void SX126xEmuReset( void );
+
+/*!
+ * \brief Drives the NSS pin
+ *
+ * \param [IN] level Pin level
+ */
+void SX126xEmuSetNss( uint8_t level );
+
+/*!
+ * \brief Exchanges a byte
+ *
+ * \param [IN] data MOSI byte
+ *
+ * \retval data MISO byte
+ */
+uint8_t SX126xEmuSpiInOut( uint8_t data );
+
+/*!
+ * \brief Reads the BUSY pin. Each read takes BusyPollTime.
+ *
+ * \retval level Pin level
+ */
+uint8_t SX126xEmuGetBusy( void );
+
+/*!
+ * \brief Reads the DIO1 pin
+ *
+ * \retval level Pin level
+ */
+uint8_t SX126xEmuGetDio1( void );
+
+/*!
+ * \brief Sets the handler called on DIO1 rising edges. The edges are
+ *        reported by SX126xEmuAdvanceTime and SX126xEmuReceive, never in the
+ *        middle of a driver SPI access.
+ *
+ * \param [IN] handler DIO1 handler [NULL: disabled]
+ * \param [IN] context Handler context
+ */
+void SX126xEmuSetDio1Handler( void ( *handler )( void* context ), void* context );
+
+/*!
+ * \brief Gets the virtual clock
+ *
+ * \retval time Current time [ns]
+ */
+uint64_t SX126xEmuGetTime( void );
+
+/*!
+ * \brief Advances the virtual clock, processes the chip events and reports
+ *        the DIO1 rising edges
+ *
+ * \param [IN] time Time to advance by [ns]
+ */
+void SX126xEmuAdvanceTime( uint64_t time );
+
+/*!
+ * \brief Gives a frame to the chip. The frame is received when the chip is
+ *        in RX or RX duty cycle mode.
+ *
+ * \param [IN] payload Payload
+ * \param [IN] size    Payload size
+ * \param [IN] rssi    Packet RSSI [dBm]
+ * \param [IN] snr     Packet SNR [dB]
+ * \param [IN] crcOk   Set to report a CRC error when false
+ *
+ * \retval status [true: frame received, false: chip not receiving]
+ */
+bool SX126xEmuReceive( const uint8_t* payload, uint8_t size, int16_t rssi, int8_t snr, bool crcOk );
+
+/*!
+ * \brief Sets the value returned by GetRssiInst
+ *
+ * \param [IN] rssi Instantaneous RSSI [dBm]
+ */
+void SX126xEmuSetRssiInst( int16_t rssi );
+
+/*!
+ * \brief Gets the chip mode
+ *
+ * \retval mode Chip mode [RadioOperatingModes_t]
+ */
+uint8_t SX126xEmuGetChipMode( void );
+
+/*!
+ * \brief Gets a register of the register file
+ *
+ * \param [IN] address Register address
+ *
+ * \retval value Register value
+ */
+uint8_t SX126xEmuGetRegister( uint16_t address );
+
+/*!
+ * \brief Clears the statistics and the trace
+ */
+void SX126xEmuResetStats( void );
+
+/*!
+ * \brief Gets the statistics since the last SX126xEmuResetStats
+ *
+ * \param [OUT] stats Statistics
+ */
+void SX126xEmuGetStats( SX126xEmuStats_t* stats );
+
+/*!
+ * \brief Gets the number of transactions kept in the trace. The trace keeps
+ *        the first SX126X_EMU_TRACE_SIZE transactions.
+ *
+ * \retval length Trace length
+ */
+uint16_t SX126xEmuGetTraceLength( void );
+
+/*!
+ * \brief Gets a transaction of the trace
+ *
+ * \param [IN] index Transaction index [0: first after SX126xEmuResetStats]
+ *
+ * \retval transaction Transaction [NULL: index out of the trace]
+ */
+const SX126xEmuTransaction_t* SX126xEmuGetTransaction( uint16_t index );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SX126X_EMU_H__
@@ -0,0 +1,566 @@
+/*!
+ * \file      lr-fhss.c
+ *
+ * \brief     LR-FHSS frame encoding, hopping sequence and time-on-air
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ */
+#include <stddef.h>
+#include "utilities.h"
+#include "lr-fhss.h"
+
+/*!
+ * Number of header bytes ( payload length, parameters, hopping sequence
+ * identifier, replica index and CRC )
+ */
+#define LR_FHSS_HEADER_SIZE                         5
+
+/*!
+ * Number of rate 1/2 coded header bits
+ */
+#define LR_FHSS_HEADER_CODED_BITS                   ( LR_FHSS_HEADER_SIZE * 8 * 2 )
+
+/*!
+ * Number of interleaved header bits sent before and after the sync word
+ */
+#define LR_FHSS_HEADER_HALF_BITS                    ( LR_FHSS_HEADER_CODED_BITS / 2 )
+
+/*!
+ * Number of sync word bits
+ */
+#define LR_FHSS_SYNC_WORD_BITS                      32
+
+/*!
+ * Number of payload CRC bytes
+ */
+#define LR_FHSS_PAYLOAD_CRC_SIZE                    2
+
+/*!
+ * Number of zero bits terminating the convolutional encoder trellis
+ */
+#define LR_FHSS_TRELLIS_TAIL_BITS                   6
+
+/*!
+ * Modulation type sent in the header ( GMSK 488 bps )
+ */
+#define LR_FHSS_MODULATION_TYPE_GMSK_488            0
+
+/*!
+ * Convolutional encoder constraint length
+ */
+#define LR_FHSS_CONV_REGISTER_MASK                  0x0F
+
+/*!
+ * Hopping sequence generators initial state
+ */
+#define LR_FHSS_LFSR_INITIAL_STATE                  6
+
+/*!
+ * Payload CRC polynomial and seed
+ */
+#define LR_FHSS_PAYLOAD_CRC_POLYNOMIAL              0x8005
+#define LR_FHSS_PAYLOAD_CRC_SEED                    0xFFFF
+
+/*!
+ * Header CRC polynomial and seed
+ */
+#define LR_FHSS_HEADER_CRC_POLYNOMIAL               0x2F
+#define LR_FHSS_HEADER_CRC_SEED                     0xFF
+
+/*!
+ * Payload whitening seed
+ */
+#define LR_FHSS_WHITENING_SEED                      0xFF
+
+/*!
+ * SX126x PLL step, 32 MHz / 2^25 [Hz]
+ */
+#define LR_FHSS_PLL_STEP_NUM                        15625
+#define LR_FHSS_PLL_STEP_DEN                        16384
+
+/*!
+ * Frequency correction of every other header replica, half the bit rate
+ * [PLL steps]
+ */
+#define LR_FHSS_HEADER_FREQ_CORRECTION              256
+
+/*!
+ * Convolutional code generator polynomials ( rate 1/3 mother code )
+ */
+static const uint8_t ConvPolynomials[3] = { 0x0B, 0x0D, 0x0F };
+
+/*!
+ * Puncturing of the mother code outputs. Bit i set keeps the ith output
+ * of the period.
+ */
+static const struct
+{
+    uint16_t Mask;
+    uint8_t Period;
+}Puncturing[] =
+{
+    { 0x228B, 15 }, // LR_FHSS_CR_5_6
+    { 0x000B,  6 }, // LR_FHSS_CR_2_3
+    { 0x0003,  3 }, // LR_FHSS_CR_1_2
+    { 0x0007,  3 }, // LR_FHSS_CR_1_3
+};
+
+/*!
+ * Operating channel widths [Hz]
+ */
+static const uint32_t Bandwidths[] = { 39063, 85938, 136719, 183594, 335938, 386719, 722656, 773438, 1523438, 1574219 };
+
+/*!
+ * Hopping grid steps [PLL steps]
+ */
+static const uint32_t GridSteps[] = { 26624, 4096 };
+
+/*!
+ * Hopping sequence LFSR polynomials for up to 64 grid positions and above
+ */
+static const uint16_t LfsrPolynomials6[] = { 33, 45, 48, 51, 54, 57 };
+static const uint16_t LfsrPolynomials7[] = { 65, 68, 71, 72 };
+
+/*!
+ * Interleaver state. The coded bits are read with a stride of twice the
+ * square root of their count, each pass past the end restarting further.
+ */
+typedef struct sLrFhssInterleaver
+{
+    uint16_t NbBits;
+    uint16_t Step;
+    uint16_t StepRestart;
+    uint16_t Start;
+    uint16_t StartInit;
+    uint16_t Pos;
+}LrFhssInterleaver_t;
+
+/*!
+ * \brief Writes a bit in a MSB first bit stream
+ *
+ * \param [IN] buffer Bit stream
+ * \param [IN] pos    Bit position
+ * \param [IN] bit    Bit value
+ */
+static void LrFhssSetBit( uint8_t* buffer, uint16_t pos, uint8_t bit )
+{
+    if( bit != 0 )
+    {
+        buffer[pos >> 3] |= 0x80 >> ( pos & 0x07 );
+    }
+    else
+    {
+        buffer[pos >> 3] &= ~( 0x80 >> ( pos & 0x07 ) );
+    }
+}
+
+/*!
+ * \brief Reads a bit from a MSB first bit stream
+ *
+ * \param [IN] buffer Bit stream
+ * \param [IN] pos    Bit position
+ *
+ * \retval bit Bit value
+ */
+static uint8_t LrFhssGetBit( const uint8_t* buffer, uint16_t pos )
+{
+    return ( buffer[pos >> 3] >> ( 7 - ( pos & 0x07 ) ) ) & 0x01;
+}
+
+/*!
+ * \brief Computes the parity of the given byte
+ */
+static uint8_t LrFhssParity( uint8_t value )
+{
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return value & 0x01;
+}
+
+/*!
+ * \brief Shifts a bit in the convolutional encoder
+ *
+ * \param [IN/OUT] reg Encoder shift register
+ * \param [IN]     bit Input bit
+ *
+ * \retval outputs Mother code outputs, output k on bit k
+ */
+static uint8_t LrFhssConvEncode( uint8_t* reg, uint8_t bit )
+{
+    uint8_t outputs = 0;
+
+    *reg = ( ( *reg << 1 ) | bit ) & LR_FHSS_CONV_REGISTER_MASK;
+    for( uint8_t k = 0; k < 3; k++ )
+    {
+        outputs |= LrFhssParity( *reg & ConvPolynomials[k] ) << k;
+    }
+    return outputs;
+}
+
+/*!
+ * \brief Computes the header CRC
+ */
+static uint8_t LrFhssHeaderCrc8( const uint8_t* data, uint8_t size )
+{
+    uint8_t crc = LR_FHSS_HEADER_CRC_SEED;
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        crc ^= data[i];
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( ( crc & 0x80 ) != 0 ) ? ( ( crc << 1 ) ^ LR_FHSS_HEADER_CRC_POLYNOMIAL ) : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Computes the payload CRC
+ */
+static uint16_t LrFhssPayloadCrc16( const uint8_t* data, uint8_t size )
+{
+    uint16_t crc = LR_FHSS_PAYLOAD_CRC_SEED;
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        crc ^= ( uint16_t )data[i] << 8;
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( ( crc & 0x8000 ) != 0 ) ? ( ( crc << 1 ) ^ LR_FHSS_PAYLOAD_CRC_POLYNOMIAL ) : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Whitens the payload with the x^8 + x^6 + x^5 + x^4 + 1 sequence,
+ *        the nibbles of each whitened byte are swapped
+ */
+static void LrFhssWhitening( const uint8_t* input, uint8_t size, uint8_t* output )
+{
+    uint8_t lfsr = LR_FHSS_WHITENING_SEED;
+
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        uint8_t value = input[i] ^ lfsr;
+
+        output[i] = ( uint8_t )( ( value << 4 ) | ( value >> 4 ) );
+        lfsr = ( uint8_t )( ( lfsr << 1 ) | ( ( ( lfsr >> 7 ) ^ ( lfsr >> 5 ) ^ ( lfsr >> 4 ) ^ ( lfsr >> 3 ) ) & 0x01 ) );
+    }
+}
+
+/*!
+ * \brief Initializes the interleaver of the given number of coded bits
+ */
+static void LrFhssInterleaverInit( LrFhssInterleaver_t* interleaver, uint16_t nbBits )
+{
+    uint16_t step = 0;
+
+    while( ( step * step ) < nbBits )
+    {
+        step++;
+    }
+    interleaver->NbBits = nbBits;
+    interleaver->Step = step << 1;
+    interleaver->StepRestart = step >> 1;
+    interleaver->Start = 0;
+    interleaver->StartInit = 0;
+    interleaver->Pos = 0;
+}
+
+/*!
+ * \brief Gets the position of the next coded bit to be sent
+ */
+static uint16_t LrFhssInterleaverNext( LrFhssInterleaver_t* interleaver )
+{
+    uint16_t pos = interleaver->Pos;
+
+    interleaver->Pos += interleaver->Step;
+    if( interleaver->Pos >= interleaver->NbBits )
+    {
+        interleaver->Start += interleaver->StepRestart;
+        if( interleaver->Start >= interleaver->Step )
+        {
+            interleaver->StartInit++;
+            interleaver->Start = interleaver->StartInit;
+        }
+        interleaver->Pos = interleaver->Start;
+    }
+    return pos;
+}
+
+/*!
+ * \brief Builds a header replica
+ *
+ * \param [IN]  params        LR-FHSS parameters
+ * \param [IN]  hopSequenceId Hopping sequence identifier
+ * \param [IN]  payloadLen    Payload length
+ * \param [IN]  replica       Replica index, the first replica is sent first
+ * \param [OUT] header        Header with its CRC
+ */
+static void LrFhssBuildHeader( const LrFhssParams_t* params, uint16_t hopSequenceId, uint8_t payloadLen, uint8_t replica,
+                               uint8_t* header )
+{
+    header[0] = payloadLen;
+    header[1] = ( LR_FHSS_MODULATION_TYPE_GMSK_488 << 5 ) | ( params->CodingRate << 3 ) |
+                ( params->Grid << 2 ) | ( 1 << 1 ) | ( ( params->Bandwidth >> 3 ) & 0x01 );
+    header[2] = ( ( params->Bandwidth & 0x07 ) << 5 ) | ( ( hopSequenceId >> 4 ) & 0x1F );
+    // The replica field counts down to the last replica
+    header[3] = ( ( hopSequenceId & 0x0F ) << 4 ) | ( ( ( params->HeaderCount - replica - 1 ) & 0x03 ) << 2 );
+    header[4] = LrFhssHeaderCrc8( header, LR_FHSS_HEADER_SIZE - 1 );
+}
+
+/*!
+ * \brief Encodes the header with the rate 1/2 code, the two outputs of each
+ *        input bit are consecutive
+ */
+static void LrFhssEncodeHeader( const uint8_t* header, uint8_t* coded )
+{
+    uint8_t reg = 0;
+
+    for( uint8_t i = 0; i < ( LR_FHSS_HEADER_SIZE * 8 ); i++ )
+    {
+        uint8_t outputs = LrFhssConvEncode( &reg, LrFhssGetBit( header, i ) );
+
+        LrFhssSetBit( coded, 2 * i, outputs & 0x01 );
+        LrFhssSetBit( coded, ( 2 * i ) + 1, ( outputs >> 1 ) & 0x01 );
+    }
+}
+
+/*!
+ * \brief Encodes the payload with the punctured rate 1/3 code
+ *
+ * \param [IN]  codingRate Payload coding rate
+ * \param [IN]  input      Whitened payload, CRC and trellis termination
+ * \param [IN]  inputBits  Number of input bits
+ * \param [OUT] coded      Coded bits
+ *
+ * \retval nbBits Number of coded bits
+ */
+static uint16_t LrFhssEncodePayload( LrFhssCodingRates_t codingRate, const uint8_t* input, uint16_t inputBits, uint8_t* coded )
+{
+    uint16_t nbBits = 0;
+    uint8_t puncture = 0;
+    uint8_t reg = 0;
+
+    for( uint16_t i = 0; i < inputBits; i++ )
+    {
+        uint8_t outputs = LrFhssConvEncode( &reg, LrFhssGetBit( input, i ) );
+
+        for( uint8_t k = 0; k < 3; k++ )
+        {
+            if( ( Puncturing[codingRate].Mask & ( 1 << puncture ) ) != 0 )
+            {
+                LrFhssSetBit( coded, nbBits++, ( outputs >> k ) & 0x01 );
+            }
+            puncture = ( puncture + 1 ) % Puncturing[codingRate].Period;
+        }
+    }
+    return nbBits;
+}
+
+/*!
+ * \brief Gets the number of coded payload bits
+ */
+static uint16_t LrFhssGetNbCodedBits( LrFhssCodingRates_t codingRate, uint8_t payloadLen )
+{
+    uint16_t nbBits = ( ( payloadLen + LR_FHSS_PAYLOAD_CRC_SIZE ) * 8 ) + LR_FHSS_TRELLIS_TAIL_BITS;
+
+    // Punctured mother code output length
+    switch( codingRate )
+    {
+        case LR_FHSS_CR_5_6:
+            return ( ( nbBits * 6 ) + 4 ) / 5;
+        case LR_FHSS_CR_2_3:
+            return ( nbBits * 3 ) / 2;
+        case LR_FHSS_CR_1_2:
+            return nbBits * 2;
+        case LR_FHSS_CR_1_3:
+        default:
+            return nbBits * 3;
+    }
+}
+
+/*!
+ * \brief Gets the number of grid positions of the operating channel
+ */
+static uint16_t LrFhssGetNbGrid( const LrFhssParams_t* params )
+{
+    // The channel widths are rounded to the Hz, 722656 Hz holds 185 grid steps
+    return ( uint16_t )( ( ( uint64_t )( Bandwidths[params->Bandwidth] + 1 ) * LR_FHSS_PLL_STEP_DEN ) /
+                         ( ( uint64_t )GridSteps[params->Grid] * LR_FHSS_PLL_STEP_NUM ) );
+}
+
+uint8_t LrFhssGetHeaderCount( LrFhssCodingRates_t codingRate )
+{
+    return ( codingRate == LR_FHSS_CR_1_3 ) ? 3 : 2;
+}
+
+uint16_t LrFhssGetNbBits( const LrFhssParams_t* params, uint8_t payloadLen )
+{
+    uint16_t codedBits = LrFhssGetNbCodedBits( params->CodingRate, payloadLen );
+    uint16_t nbBits = ( codedBits / LR_FHSS_FRAG_BITS ) * LR_FHSS_BLOCK_BITS;
+
+    if( ( codedBits % LR_FHSS_FRAG_BITS ) != 0 )
+    {
+        nbBits += ( codedBits % LR_FHSS_FRAG_BITS ) + LR_FHSS_BLOCK_PREAMBLE_BITS;
+    }
+    return ( LR_FHSS_HEADER_BITS * params->HeaderCount ) + nbBits;
+}
+
+uint32_t LrFhssGetTimeOnAir( const LrFhssParams_t* params, uint8_t payloadLen )
+{
+    uint32_t numerator = ( uint32_t )LrFhssGetNbBits( params, payloadLen ) * LR_FHSS_BITRATE_DEN * 1000;
+
+    // Perform integral ceil()
+    return ( numerator + LR_FHSS_BITRATE_NUM - 1 ) / LR_FHSS_BITRATE_NUM;
+}
+
+uint16_t LrFhssGetNbHops( const LrFhssParams_t* params, uint8_t payloadLen )
+{
+    uint16_t codedBits = LrFhssGetNbCodedBits( params->CodingRate, payloadLen );
+
+    return params->HeaderCount + ( ( codedBits + LR_FHSS_FRAG_BITS - 1 ) / LR_FHSS_FRAG_BITS );
+}
+
+uint16_t LrFhssGetHopNbBits( const LrFhssParams_t* params, uint8_t payloadLen, uint16_t hop )
+{
+    uint16_t codedBits = LrFhssGetNbCodedBits( params->CodingRate, payloadLen );
+    uint16_t fragment = 0;
+
+    if( hop < params->HeaderCount )
+    {
+        return LR_FHSS_HEADER_BITS;
+    }
+    fragment = hop - params->HeaderCount;
+    if( ( ( fragment + 1 ) * LR_FHSS_FRAG_BITS ) > codedBits )
+    {
+        return ( codedBits - ( fragment * LR_FHSS_FRAG_BITS ) ) + LR_FHSS_BLOCK_PREAMBLE_BITS;
+    }
+    return LR_FHSS_BLOCK_BITS;
+}
+
+uint16_t LrFhssGetHopSequenceCount( const LrFhssParams_t* params )
+{
+    if( LrFhssGetNbGrid( params ) <= 64 )
+    {
+        return sizeof( LfsrPolynomials6 ) / sizeof( LfsrPolynomials6[0] ) * 64;
+    }
+    return sizeof( LfsrPolynomials7 ) / sizeof( LfsrPolynomials7[0] ) * 128;
+}
+
+void LrFhssHopSequenceInit( const LrFhssParams_t* params, uint16_t hopSequenceId, LrFhssHopSequence_t* sequence )
+{
+    sequence->NbGrid = LrFhssGetNbGrid( params );
+    sequence->State = LR_FHSS_LFSR_INITIAL_STATE;
+    sequence->Hop = 0;
+
+    hopSequenceId %= LrFhssGetHopSequenceCount( params );
+    if( sequence->NbGrid <= 64 )
+    {
+        sequence->Polynomial = LfsrPolynomials6[hopSequenceId >> 6];
+        sequence->Seed = hopSequenceId & 0x3F;
+    }
+    else
+    {
+        sequence->Polynomial = LfsrPolynomials7[hopSequenceId >> 7];
+        sequence->Seed = hopSequenceId & 0x7F;
+    }
+}
+
+int32_t LrFhssGetNextHopOffset( const LrFhssParams_t* params, LrFhssHopSequence_t* sequence )
+{
+    uint16_t hop = 0;
+    int32_t offset = 0;
+
+    // The LFSR visits every non null state, the hops are numbered from 1
+    // and those past the operating channel are dropped
+    do
+    {
+        uint16_t lsb = sequence->State & 0x01;
+
+        sequence->State >>= 1;
+        if( lsb != 0 )
+        {
+            sequence->State ^= sequence->Polynomial;
+        }
+        hop = sequence->Seed;
+        if( hop != sequence->State )
+        {
+            hop ^= sequence->State;
+        }
+    }while( hop > sequence->NbGrid );
+
+    offset = ( ( int32_t )hop - 1 - ( sequence->NbGrid >> 1 ) ) * ( int32_t )GridSteps[params->Grid];
+    if( ( sequence->Hop < params->HeaderCount ) && ( ( ( params->HeaderCount - sequence->Hop ) % 2 ) == 0 ) )
+    {
+        offset += LR_FHSS_HEADER_FREQ_CORRECTION;
+    }
+    sequence->Hop++;
+    return ( int32_t )( ( ( int64_t )offset * LR_FHSS_PLL_STEP_NUM ) / LR_FHSS_PLL_STEP_DEN );
+}
+
+uint8_t LrFhssBuildFrame( const LrFhssParams_t* params, uint16_t hopSequenceId, const uint8_t* payload, uint8_t payloadLen, uint8_t* frame )
+{
+    const uint8_t syncWord[] = LR_FHSS_SYNC_WORD;
+    uint8_t buffer[LR_FHSS_MAX_FRAME_SIZE];
+    uint8_t coded[LR_FHSS_MAX_FRAME_SIZE];
+    uint8_t header[LR_FHSS_HEADER_SIZE];
+    LrFhssInterleaver_t interleaver;
+    uint16_t nbBits = LrFhssGetNbBits( params, payloadLen );
+    uint16_t inputBits = ( ( payloadLen + LR_FHSS_PAYLOAD_CRC_SIZE ) * 8 ) + LR_FHSS_TRELLIS_TAIL_BITS;
+    uint16_t codedBits = 0;
+    uint16_t pos = 0;
+    uint16_t crc = 0;
+
+    if( ( nbBits > ( LR_FHSS_MAX_FRAME_SIZE * 8 ) ) || ( payload == NULL ) || ( frame == NULL ) )
+    {
+        return 0;
+    }
+    // The block preambles are the zero bits left
+    memset1( frame, 0, ( nbBits + 7 ) >> 3 );
+
+    // Header replicas, the interleaved coded header is split by the sync word
+    for( uint8_t replica = 0; replica < params->HeaderCount; replica++ )
+    {
+        LrFhssBuildHeader( params, hopSequenceId, payloadLen, replica, header );
+        LrFhssEncodeHeader( header, coded );
+        LrFhssInterleaverInit( &interleaver, LR_FHSS_HEADER_CODED_BITS );
+
+        pos += LR_FHSS_BLOCK_PREAMBLE_BITS;
+        for( uint8_t i = 0; i < LR_FHSS_HEADER_HALF_BITS; i++ )
+        {
+            LrFhssSetBit( frame, pos++, LrFhssGetBit( coded, LrFhssInterleaverNext( &interleaver ) ) );
+        }
+        for( uint8_t i = 0; i < LR_FHSS_SYNC_WORD_BITS; i++ )
+        {
+            LrFhssSetBit( frame, pos++, LrFhssGetBit( syncWord, i ) );
+        }
+        for( uint8_t i = 0; i < LR_FHSS_HEADER_HALF_BITS; i++ )
+        {
+            LrFhssSetBit( frame, pos++, LrFhssGetBit( coded, LrFhssInterleaverNext( &interleaver ) ) );
+        }
+    }
+
+    // Whitened payload followed by its CRC and the trellis termination
+    LrFhssWhitening( payload, payloadLen, buffer );
+    crc = LrFhssPayloadCrc16( buffer, payloadLen );
+    buffer[payloadLen] = ( crc >> 8 ) & 0xFF;
+    buffer[payloadLen + 1] = crc & 0xFF;
+    buffer[payloadLen + 2] = 0;
+
+    // Interleaved coded payload, LR_FHSS_FRAG_BITS per block
+    codedBits = LrFhssEncodePayload( params->CodingRate, buffer, inputBits, coded );
+    LrFhssInterleaverInit( &interleaver, codedBits );
+    for( uint16_t i = 0; i < codedBits; i++ )
+    {
+        if( ( i % LR_FHSS_FRAG_BITS ) == 0 )
+        {
+            pos += LR_FHSS_BLOCK_PREAMBLE_BITS;
+        }
+        LrFhssSetBit( frame, pos++, LrFhssGetBit( coded, LrFhssInterleaverNext( &interleaver ) ) );
+    }
+    return ( nbBits + 7 ) >> 3;
+}
@@ -0,0 +1,249 @@
+/*!
+ * \file      lr-fhss.h
+ *
+ * \brief     LR-FHSS frame encoding, hopping sequence and time-on-air
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The radio transmits the frame built by the host bit by bit with
+ *            a 488.28125 bps GMSK modulation. The frame is made of
+ *            HeaderCount header replicas followed by the payload fragments,
+ *            each header replica and each fragment being sent on its own hop.
+ */
+#ifndef __LR_FHSS_H__
+#define __LR_FHSS_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ * LR-FHSS bit rate numerator [bps]. Bit rate is 488.28125 bps
+ */
+#define LR_FHSS_BITRATE_NUM                         15625
+
+/*!
+ * LR-FHSS bit rate denominator
+ */
+#define LR_FHSS_BITRATE_DEN                         32
+
+/*!
+ * Number of bits of a header block ( block preamble, coded header and sync word )
+ */
+#define LR_FHSS_HEADER_BITS                         114
+
+/*!
+ * Number of coded payload bits of a fragment
+ */
+#define LR_FHSS_FRAG_BITS                           48
+
+/*!
+ * Number of preamble bits sent at the beginning of each block
+ */
+#define LR_FHSS_BLOCK_PREAMBLE_BITS                 2
+
+/*!
+ * Number of bits of a payload block
+ */
+#define LR_FHSS_BLOCK_BITS                          ( LR_FHSS_FRAG_BITS + LR_FHSS_BLOCK_PREAMBLE_BITS )
+
+/*!
+ * Maximum frame size handled by the radio data buffer
+ */
+#define LR_FHSS_MAX_FRAME_SIZE                      255
+
+/*!
+ * LR-FHSS sync word
+ */
+#define LR_FHSS_SYNC_WORD                           { 0x2C, 0x0F, 0x79, 0x95 }
+
+/*!
+ * LR-FHSS coding rates
+ */
+typedef enum
+{
+    LR_FHSS_CR_5_6                          = 0x00,
+    LR_FHSS_CR_2_3                          = 0x01,
+    LR_FHSS_CR_1_2                          = 0x02,
+    LR_FHSS_CR_1_3                          = 0x03,
+}LrFhssCodingRates_t;
+
+/*!
+ * LR-FHSS operating channel widths
+ */
+typedef enum
+{
+    LR_FHSS_BW_39063_HZ                     = 0x00,
+    LR_FHSS_BW_85938_HZ                     = 0x01,
+    LR_FHSS_BW_136719_HZ                    = 0x02,
+    LR_FHSS_BW_183594_HZ                    = 0x03,
+    LR_FHSS_BW_335938_HZ                    = 0x04,
+    LR_FHSS_BW_386719_HZ                    = 0x05,
+    LR_FHSS_BW_722656_HZ                    = 0x06,
+    LR_FHSS_BW_773438_HZ                    = 0x07,
+    LR_FHSS_BW_1523438_HZ                   = 0x08,
+    LR_FHSS_BW_1574219_HZ                   = 0x09,
+}LrFhssBandwidths_t;
+
+/*!
+ * LR-FHSS minimum frequency separation between two hops
+ */
+typedef enum
+{
+    LR_FHSS_GRID_25391_HZ                   = 0x00,
+    LR_FHSS_GRID_3906_HZ                    = 0x01,
+}LrFhssGrids_t;
+
+/*!
+ * LR-FHSS transmission parameters
+ */
+typedef struct sLrFhssParams
+{
+    /*!
+     * Operating channel width
+     */
+    LrFhssBandwidths_t Bandwidth;
+    /*!
+     * Payload coding rate
+     */
+    LrFhssCodingRates_t CodingRate;
+    /*!
+     * Hopping grid
+     */
+    LrFhssGrids_t Grid;
+    /*!
+     * Number of header replicas
+     */
+    uint8_t HeaderCount;
+}LrFhssParams_t;
+
+/*!
+ * LR-FHSS hopping sequence generator state
+ */
+typedef struct sLrFhssHopSequence
+{
+    /*!
+     * LFSR polynomial
+     */
+    uint16_t Polynomial;
+    /*!
+     * Value xored with the LFSR state to get the grid position
+     */
+    uint16_t Seed;
+    /*!
+     * LFSR state
+     */
+    uint16_t State;
+    /*!
+     * Number of grid positions in the operating channel
+     */
+    uint16_t NbGrid;
+    /*!
+     * Index of the next hop
+     */
+    uint16_t Hop;
+}LrFhssHopSequence_t;
+
+/*!
+ * \brief Gets the number of header replicas to be used with the given
+ *        coding rate
+ *
+ * \param [IN] codingRate Payload coding rate
+ *
+ * \retval headerCount Number of header replicas
+ */
+uint8_t LrFhssGetHeaderCount( LrFhssCodingRates_t codingRate );
+
+/*!
+ * \brief Gets the number of bits transmitted for the given payload
+ *
+ * \param [IN] params     LR-FHSS parameters
+ * \param [IN] payloadLen Payload length
+ *
+ * \retval nbBits Number of transmitted bits
+ */
+uint16_t LrFhssGetNbBits( const LrFhssParams_t* params, uint8_t payloadLen );
+
+/*!
+ * \brief Computes the time on air of the given payload
+ *
+ * \param [IN] params     LR-FHSS parameters
+ * \param [IN] payloadLen Payload length
+ *
+ * \retval timeOnAir Time on air [ms]
+ */
+uint32_t LrFhssGetTimeOnAir( const LrFhssParams_t* params, uint8_t payloadLen );
+
+/*!
+ * \brief Gets the number of hops of the frame carrying the given payload
+ *
+ * \param [IN] params     LR-FHSS parameters
+ * \param [IN] payloadLen Payload length
+ *
+ * \retval nbHops Number of hops
+ */
+uint16_t LrFhssGetNbHops( const LrFhssParams_t* params, uint8_t payloadLen );
+
+/*!
+ * \brief Gets the number of bits transmitted on the given hop
+ *
+ * \param [IN] params     LR-FHSS parameters
+ * \param [IN] payloadLen Payload length
+ * \param [IN] hop        Hop index
+ *
+ * \retval nbBits Number of bits of the hop
+ */
+uint16_t LrFhssGetHopNbBits( const LrFhssParams_t* params, uint8_t payloadLen, uint16_t hop );
+
+/*!
+ * \brief Gets the number of available hopping sequences
+ *
+ * \param [IN] params LR-FHSS parameters
+ *
+ * \retval count Number of hopping sequences
+ */
+uint16_t LrFhssGetHopSequenceCount( const LrFhssParams_t* params );
+
+/*!
+ * \brief Initializes the hopping sequence generator
+ *
+ * \param [IN]  params        LR-FHSS parameters
+ * \param [IN]  hopSequenceId Hopping sequence identifier
+ *                            [0: LrFhssGetHopSequenceCount - 1]
+ * \param [OUT] sequence      Hopping sequence generator state
+ */
+void LrFhssHopSequenceInit( const LrFhssParams_t* params, uint16_t hopSequenceId, LrFhssHopSequence_t* sequence );
+
+/*!
+ * \brief Gets the frequency offset of the next hop. Every other header
+ *        replica is sent half the bit rate above its grid position.
+ *
+ * \param [IN]  params   LR-FHSS parameters
+ * \param [IN]  sequence Hopping sequence generator state
+ *
+ * \retval offset Frequency offset from the channel center frequency [Hz]
+ */
+int32_t LrFhssGetNextHopOffset( const LrFhssParams_t* params, LrFhssHopSequence_t* sequence );
+
+/*!
+ * \brief Builds the frame to be uploaded to the radio
+ *
+ * \param [IN]  params        LR-FHSS parameters
+ * \param [IN]  hopSequenceId Hopping sequence identifier
+ * \param [IN]  payload       Payload
+ * \param [IN]  payloadLen    Payload length
+ * \param [OUT] frame         Frame buffer of LR_FHSS_MAX_FRAME_SIZE bytes
+ *
+ * \retval frameSize Frame size [0: payload too long]
+ */
+uint8_t LrFhssBuildFrame( const LrFhssParams_t* params, uint16_t hopSequenceId, const uint8_t* payload, uint8_t payloadLen, uint8_t* frame );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LR_FHSS_H__
@@ -0,0 +1,87 @@
+/*!
+ * \file      radio-irq-stats.h
+ *
+ * \brief     SX126x radio IRQ latency instrumentation
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Latencies are measured from the DIO1 rising edge to the call of
+ *            the TxDone/RxDone radio event callbacks and expressed in RTC
+ *            timer ticks ( 1 us on tinyLoRa ).
+ *            Only available when RADIO_IRQ_LATENCY_STATS is defined.
+ */
+#ifndef __RADIO_IRQ_STATS_H__
+#define __RADIO_IRQ_STATS_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Number of histogram bins. Bin i counts latencies in [2^i, 2^(i+1)[ ticks,
+ * bin 0 also counts null latencies and the last bin saturates.
+ */
+#define RADIO_IRQ_LATENCY_NB_BINS                   16
+
+/*!
+ * Latency histogram of a single radio event
+ */
+typedef struct sRadioIrqLatencyHistogram
+{
+    /*!
+     * Number of recorded events
+     */
+    uint32_t Count;
+    /*!
+     * Minimum latency [ticks]
+     */
+    uint32_t Min;
+    /*!
+     * Maximum latency [ticks]
+     */
+    uint32_t Max;
+    /*!
+     * Sum of all the latencies [ticks]
+     */
+    uint64_t Sum;
+    /*!
+     * Logarithmic latency bins
+     */
+    uint32_t Bins[RADIO_IRQ_LATENCY_NB_BINS];
+}RadioIrqLatencyHistogram_t;
+
+/*!
+ * Radio IRQ latency statistics
+ */
+typedef struct sRadioIrqLatencyStats
+{
+    /*!
+     * DIO1 edge to TxDone callback
+     */
+    RadioIrqLatencyHistogram_t TxDone;
+    /*!
+     * DIO1 edge to RxDone callback
+     */
+    RadioIrqLatencyHistogram_t RxDone;
+}RadioIrqLatencyStats_t;
+
+/*!
+ * \brief Gets a copy of the radio IRQ latency statistics
+ *
+ * \param [OUT] stats Statistics copy
+ */
+void RadioIrqLatencyStatsGet( RadioIrqLatencyStats_t* stats );
+
+/*!
+ * \brief Resets the radio IRQ latency statistics
+ */
+void RadioIrqLatencyStatsReset( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __RADIO_IRQ_STATS_H__
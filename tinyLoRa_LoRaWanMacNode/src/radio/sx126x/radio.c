@@ -28,7 +28,12 @@
 #include "radio.h"
 #include "sx126x.h"
 #include "sx126x-board.h"
+#include "lr-fhss.h"
 #include "board.h"
+#if defined( RADIO_IRQ_LATENCY_STATS )
+#include "rtc-board.h"
+#include "radio-irq-stats.h"
+#endif
 
 /*!
  * \brief Initializes the radio
@@ -336,6 +341,40 @@ void RadioRxBoosted( uint32_t timeout );
  */
 void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime );
 
+/*!
+ * \brief Sets the buffer the received payloads are read into
+ *
+ * \param [IN] buffer Caller owned buffer of at least 255 bytes
+ *                    [NULL: radio driver internal buffer]
+ */
+void RadioSetRxBuffer( uint8_t *buffer );
+
+/*!
+ * \brief Uploads a packet to the radio ahead of its transmission
+ *
+ * \param [IN]: buffer     Buffer pointer
+ * \param [IN]: size       Buffer size
+ */
+void RadioPrepareTx( uint8_t *buffer, uint8_t size );
+
+/*!
+ * \brief Starts the transmission of the packet uploaded by RadioPrepareTx
+ *
+ * \retval status [true: transmission started, false: no prepared packet]
+ */
+bool RadioSendPrepared( void );
+
+/*!
+ * \brief Starts checking if the channel is free for the given time without
+ *        blocking
+ *
+ * \param [IN] freq                Channel RF frequency in Hertz
+ * \param [IN] rxBandwidth         Rx bandwidth in Hertz
+ * \param [IN] rssiThresh          RSSI threshold in dBm
+ * \param [IN] maxCarrierSenseTime Max time in milliseconds while the RSSI is measured
+ */
+void RadioStartChannelSense( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime );
+
 /*!
  * \brief Add a register to the retention list
  *
@@ -343,39 +382,116 @@ void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime );
  */
 void RadioAddRegisterToRetentionList( uint16_t registerAddress );
 
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+/*!
+ * Radio driver API entries holding the radio software interrupt back for the
+ * whole call. The operations are made of several SPI transactions and
+ * RadioIrqProcess, run by the software interrupt, is not re-entrant.
+ */
+#define RADIO_HELD_CALL( name, params, args )                                 \
+static void RadioHeld##name params                                            \
+{                                                                             \
+    SX126xIoSwIrqHold( );                                                     \
+    Radio##name args;                                                         \
+    SX126xIoSwIrqRelease( );                                                  \
+}
+
+#define RADIO_HELD_QUERY( type, name, params, args )                          \
+static type RadioHeld##name params                                            \
+{                                                                             \
+    type ret;                                                                 \
+                                                                              \
+    SX126xIoSwIrqHold( );                                                     \
+    ret = Radio##name args;                                                   \
+    SX126xIoSwIrqRelease( );                                                  \
+    return ret;                                                               \
+}
+
+RADIO_HELD_CALL( Init, ( RadioEvents_t *events ), ( events ) )
+RADIO_HELD_CALL( SetModem, ( RadioModems_t modem ), ( modem ) )
+RADIO_HELD_CALL( SetChannel, ( uint32_t freq ), ( freq ) )
+RADIO_HELD_QUERY( bool, IsChannelFree,
+                  ( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime ),
+                  ( freq, rxBandwidth, rssiThresh, maxCarrierSenseTime ) )
+RADIO_HELD_QUERY( uint32_t, Random, ( void ), ( ) )
+RADIO_HELD_CALL( SetRxConfig,
+                 ( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                   uint32_t bandwidthAfc, uint16_t preambleLen, uint16_t symbTimeout, bool fixLen,
+                   uint8_t payloadLen, bool crcOn, bool FreqHopOn, uint8_t HopPeriod, bool iqInverted,
+                   bool rxContinuous ),
+                 ( modem, bandwidth, datarate, coderate, bandwidthAfc, preambleLen, symbTimeout, fixLen,
+                   payloadLen, crcOn, FreqHopOn, HopPeriod, iqInverted, rxContinuous ) )
+RADIO_HELD_CALL( SetTxConfig,
+                 ( RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth, uint32_t datarate,
+                   uint8_t coderate, uint16_t preambleLen, bool fixLen, bool crcOn, bool FreqHopOn,
+                   uint8_t HopPeriod, bool iqInverted, uint32_t timeout ),
+                 ( modem, power, fdev, bandwidth, datarate, coderate, preambleLen, fixLen, crcOn, FreqHopOn,
+                   HopPeriod, iqInverted, timeout ) )
+RADIO_HELD_CALL( Send, ( uint8_t *buffer, uint8_t size ), ( buffer, size ) )
+RADIO_HELD_CALL( Sleep, ( void ), ( ) )
+RADIO_HELD_CALL( Standby, ( void ), ( ) )
+RADIO_HELD_CALL( Rx, ( uint32_t timeout ), ( timeout ) )
+RADIO_HELD_CALL( StartCad, ( void ), ( ) )
+RADIO_HELD_CALL( SetTxContinuousWave, ( uint32_t freq, int8_t power, uint16_t time ), ( freq, power, time ) )
+RADIO_HELD_QUERY( int16_t, Rssi, ( RadioModems_t modem ), ( modem ) )
+RADIO_HELD_CALL( Write, ( uint32_t addr, uint8_t data ), ( addr, data ) )
+RADIO_HELD_QUERY( uint8_t, Read, ( uint32_t addr ), ( addr ) )
+RADIO_HELD_CALL( WriteBuffer, ( uint32_t addr, uint8_t *buffer, uint8_t size ), ( addr, buffer, size ) )
+RADIO_HELD_CALL( ReadBuffer, ( uint32_t addr, uint8_t *buffer, uint8_t size ), ( addr, buffer, size ) )
+RADIO_HELD_CALL( SetMaxPayloadLength, ( RadioModems_t modem, uint8_t max ), ( modem, max ) )
+RADIO_HELD_CALL( SetPublicNetwork, ( bool enable ), ( enable ) )
+RADIO_HELD_CALL( IrqProcess, ( void ), ( ) )
+RADIO_HELD_CALL( RxBoosted, ( uint32_t timeout ), ( timeout ) )
+RADIO_HELD_CALL( SetRxDutyCycle, ( uint32_t rxTime, uint32_t sleepTime ), ( rxTime, sleepTime ) )
+RADIO_HELD_CALL( SetRxBuffer, ( uint8_t *buffer ), ( buffer ) )
+RADIO_HELD_CALL( PrepareTx, ( uint8_t *buffer, uint8_t size ), ( buffer, size ) )
+RADIO_HELD_QUERY( bool, SendPrepared, ( void ), ( ) )
+RADIO_HELD_CALL( StartChannelSense,
+                 ( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime ),
+                 ( freq, rxBandwidth, rssiThresh, maxCarrierSenseTime ) )
+
+#define RADIO_API( name )                           RadioHeld##name
+#else
+#define RADIO_API( name )                           Radio##name
+#endif
+
 /*!
  * Radio driver structure initialization
  */
 const struct Radio_s Radio =
 {
-    RadioInit,
+    RADIO_API( Init ),
     RadioGetStatus,
-    RadioSetModem,
-    RadioSetChannel,
-    RadioIsChannelFree,
-    RadioRandom,
-    RadioSetRxConfig,
-    RadioSetTxConfig,
+    RADIO_API( SetModem ),
+    RADIO_API( SetChannel ),
+    RADIO_API( IsChannelFree ),
+    RADIO_API( Random ),
+    RADIO_API( SetRxConfig ),
+    RADIO_API( SetTxConfig ),
     RadioCheckRfFrequency,
     RadioTimeOnAir,
-    RadioSend,
-    RadioSleep,
-    RadioStandby,
-    RadioRx,
-    RadioStartCad,
-    RadioSetTxContinuousWave,
-    RadioRssi,
-    RadioWrite,
-    RadioRead,
-    RadioWriteBuffer,
-    RadioReadBuffer,
-    RadioSetMaxPayloadLength,
-    RadioSetPublicNetwork,
+    RADIO_API( Send ),
+    RADIO_API( Sleep ),
+    RADIO_API( Standby ),
+    RADIO_API( Rx ),
+    RADIO_API( StartCad ),
+    RADIO_API( SetTxContinuousWave ),
+    RADIO_API( Rssi ),
+    RADIO_API( Write ),
+    RADIO_API( Read ),
+    RADIO_API( WriteBuffer ),
+    RADIO_API( ReadBuffer ),
+    RADIO_API( SetMaxPayloadLength ),
+    RADIO_API( SetPublicNetwork ),
     RadioGetWakeupTime,
-    RadioIrqProcess,
+    RADIO_API( IrqProcess ),
     // Available on SX126x only
-    RadioRxBoosted,
-    RadioSetRxDutyCycle
+    RADIO_API( RxBoosted ),
+    RADIO_API( SetRxDutyCycle ),
+    RADIO_API( SetRxBuffer ),
+    RADIO_API( PrepareTx ),
+    RADIO_API( SendPrepared ),
+    RADIO_API( StartChannelSense )
 };
 
 /*
@@ -434,8 +550,74 @@ bool RxContinuous = false;
 PacketStatus_t RadioPktStatus;
 uint8_t RadioRxPayload[255];
 
+/*!
+ * Buffer the received payloads are read into
+ */
+static uint8_t* RadioRxBuffer = RadioRxPayload;
+
+/*!
+ * Set when the radio data buffer holds a packet uploaded by RadioPrepareTx
+ */
+static bool TxPrepared = false;
+
+/*!
+ * Size of the packet uploaded by RadioPrepareTx
+ */
+static uint8_t TxPreparedSize = 0;
+
+/*!
+ * Channel sense RSSI sampling period [ms]
+ */
+#define RADIO_CHANNEL_SENSE_SAMPLE_PERIOD           1
+
+/*!
+ * Asynchronous channel sense context
+ */
+static struct
+{
+    bool Running;
+    int16_t RssiThresh;
+    uint32_t CarrierSenseTime;
+    TimerTime_t StartTime;
+    bool Sampling;
+    bool SampleDue;
+}ChannelSense;
+
+/*!
+ * LR-FHSS transmission context
+ */
+static struct
+{
+    LrFhssParams_t Params;
+    LrFhssHopSequence_t HopSequence;
+    uint32_t CenterFreq;
+    uint8_t PayloadLen;
+    uint16_t NbHops;
+    uint16_t NextHop;
+    uint8_t Frame[LR_FHSS_MAX_FRAME_SIZE];
+}LrFhss;
+
 bool IrqFired = false;
 
+#if defined( RADIO_IRQ_LATENCY_STATS )
+/*!
+ * RTC timer value captured on the first DIO1 edge of the pending IRQ
+ */
+static volatile uint32_t IrqTimestamp = 0;
+
+/*!
+ * DIO1 edge to radio event callback latency statistics
+ */
+static RadioIrqLatencyStats_t IrqLatencyStats;
+
+/*!
+ * \brief Records the latency elapsed since the DIO1 edge in the given histogram
+ *
+ * \param [IN] histogram Histogram to be updated
+ */
+static void RadioIrqLatencyRecord( RadioIrqLatencyHistogram_t* histogram );
+#endif
+
 /*
  * SX126x DIO IRQ callback functions prototype
  */
@@ -455,6 +637,36 @@ void RadioOnTxTimeoutIrq( void* context );
  */
 void RadioOnRxTimeoutIrq( void* context );
 
+/*!
+ * \brief Channel sense RSSI sampling timer callback
+ */
+static void RadioOnChannelSenseTimerIrq( void* context );
+
+/*!
+ * \brief Samples the RSSI of the running channel sense and reports the
+ *        result once it is known. Called by RadioIrqProcess.
+ */
+static void RadioChannelSenseProcess( void );
+
+/*!
+ * \brief Aborts a running channel sense
+ */
+static void RadioChannelSenseAbort( void );
+
+/*!
+ * \brief Writes the next LR-FHSS hop in the radio hop table
+ */
+static void RadioLrFhssSetNextHop( void );
+
+/*!
+ * \brief Gets the LoRa bandwidth in Hz
+ *
+ * \param [IN] bw LoRa bandwidth parameter
+ *
+ * \retval bandwidthInHz LoRa bandwidth in Hz
+ */
+static uint32_t RadioGetLoRaBandwidthInHz( RadioLoRaBandwidths_t bw );
+
 /*
  * Private global variables
  */
@@ -490,6 +702,7 @@ SX126x_t SX126x;
  */
 TimerEvent_t TxTimeoutTimer;
 TimerEvent_t RxTimeoutTimer;
+TimerEvent_t ChannelSenseTimer;
 
 /*!
  * Returns the known FSK bandwidth registers value
@@ -506,15 +719,20 @@ static uint8_t RadioGetFskBandwidthRegValue( uint32_t bandwidth )
         return( 0x1F );
     }
 
-    for( i = 0; i < ( sizeof( FskBandwidths ) / sizeof( FskBandwidth_t ) ) - 1; i++ )
+    // The last entry is an invalid bandwidth only used as upper bound
+    for( i = 0; i < ( sizeof( FskBandwidths ) / sizeof( FskBandwidth_t ) ) - 2; i++ )
     {
         if( ( bandwidth >= FskBandwidths[i].bandwidth ) && ( bandwidth < FskBandwidths[i + 1].bandwidth ) )
         {
             return FskBandwidths[i+1].RegValue;
         }
     }
-    // ERROR: Value not found
-    while( 1 );
+    if( bandwidth < FskBandwidths[0].bandwidth )
+    {
+        return FskBandwidths[0].RegValue;
+    }
+    // Saturate to the widest filter
+    return FskBandwidths[( sizeof( FskBandwidths ) / sizeof( FskBandwidth_t ) ) - 2].RegValue;
 }
 
 void RadioInit( RadioEvents_t *events )
@@ -536,8 +754,19 @@ void RadioInit( RadioEvents_t *events )
     // Initialize driver timeout timers
     TimerInit( &TxTimeoutTimer, RadioOnTxTimeoutIrq );
     TimerInit( &RxTimeoutTimer, RadioOnRxTimeoutIrq );
+    TimerInit( &ChannelSenseTimer, RadioOnChannelSenseTimerIrq );
 
     IrqFired = false;
+    TxPrepared = false;
+    ChannelSense.Running = false;
+
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+    // DIO1 events are processed from the radio software interrupt
+    SX126xIoSwIrqInit( RadioIrqProcess );
+#endif
+#if defined( RADIO_IRQ_LATENCY_STATS )
+    RadioIrqLatencyStatsReset( );
+#endif
 }
 
 RadioState_t RadioGetStatus( void )
@@ -547,6 +776,7 @@ RadioState_t RadioGetStatus( void )
         case MODE_TX:
             return RF_TX_RUNNING;
         case MODE_RX:
+        case MODE_RX_DC:
             return RF_RX_RUNNING;
         case MODE_CAD:
             return RF_CAD;
@@ -566,6 +796,11 @@ void RadioSetModem( RadioModems_t modem )
         // Thus, we also reset the RadioPublicNetwork variable
         RadioPublicNetwork.Current = false;
         break;
+    case MODEM_LR_FHSS:
+        SX126xSetPacketType( PACKET_TYPE_LR_FHSS );
+        // The LoRa SyncWord register value is reset as for GFSK
+        RadioPublicNetwork.Current = false;
+        break;
     case MODEM_LORA:
         SX126xSetPacketType( PACKET_TYPE_LORA );
         // Public/Private network register is reset when switching modems
@@ -580,6 +815,8 @@ void RadioSetModem( RadioModems_t modem )
 
 void RadioSetChannel( uint32_t freq )
 {
+    // LR-FHSS hops are relative to the channel center frequency
+    LrFhss.CenterFreq = freq;
     SX126xSetRfFrequency( freq );
 }
 
@@ -589,6 +826,8 @@ bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh
     int16_t  rssi             = 0;
     uint32_t carrierSenseTime = 0;
 
+    RadioChannelSenseAbort( );
+
     RadioSetModem( MODEM_FSK );
 
     RadioSetChannel( freq );
@@ -617,8 +856,46 @@ bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh
     return status;
 }
 
+void RadioStartChannelSense( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+    RadioChannelSenseAbort( );
+
+    RadioSetModem( MODEM_FSK );
+
+    RadioSetChannel( freq );
+
+    // Set Rx bandwidth. Other parameters are not used.
+    RadioSetRxConfig( MODEM_FSK, rxBandwidth, 600, 0, rxBandwidth, 3, 0, false,
+                      0, false, 0, 0, false, true );
+
+    // Only the RSSI is used, no radio event is expected
+    SX126xSetDioIrqParams( IRQ_RADIO_NONE, IRQ_RADIO_NONE, IRQ_RADIO_NONE, IRQ_RADIO_NONE );
+    SX126xSetRx( 0xFFFFFF ); // Rx Continuous
+
+    ChannelSense.RssiThresh = rssiThresh;
+    ChannelSense.CarrierSenseTime = maxCarrierSenseTime;
+    ChannelSense.Sampling = false;
+    ChannelSense.SampleDue = false;
+    ChannelSense.Running = true;
+
+    // Let the RSSI settle before the first sample
+    TimerSetValue( &ChannelSenseTimer, 1 );
+    TimerStart( &ChannelSenseTimer );
+}
+
+static void RadioChannelSenseAbort( void )
+{
+    if( ChannelSense.Running == true )
+    {
+        ChannelSense.Running = false;
+        ChannelSense.SampleDue = false;
+        TimerStop( &ChannelSenseTimer );
+    }
+}
+
 uint32_t RadioRandom( void )
 {
+    RadioChannelSenseAbort( );
     uint32_t rnd = 0;
 
     /*
@@ -627,6 +904,9 @@ uint32_t RadioRandom( void )
     // Set LoRa modem ON
     RadioSetModem( MODEM_LORA );
 
+    // The random number generation uses the receiver
+    TxPrepared = false;
+
     // Disable LoRa modem interrupts
     SX126xSetDioIrqParams( IRQ_RADIO_NONE, IRQ_RADIO_NONE, IRQ_RADIO_NONE, IRQ_RADIO_NONE );
 
@@ -696,7 +976,8 @@ void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
             break;
 
         case MODEM_LORA:
-            SX126xSetStopRxTimerOnPreambleDetect( false );
+            // The single reception window only lasts until a preamble is detected
+            SX126xSetStopRxTimerOnPreambleDetect( rxContinuous == false );
             SX126x.ModulationParams.PacketType = PACKET_TYPE_LORA;
             SX126x.ModulationParams.Params.LoRa.SpreadingFactor = ( RadioLoRaSpreadingFactors_t )datarate;
             SX126x.ModulationParams.Params.LoRa.Bandwidth = Bandwidths[bandwidth];
@@ -754,9 +1035,23 @@ void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
             }
             // WORKAROUND END
 
-            // Timeout Max, Timeout handled directly in SetRx function
-            RxTimeout = 0xFFFF;
+            if( symbTimeout != 0 )
+            {
+                // The radio timer closes the window when no preamble is detected
+                // within the symbol timeout and is stopped on preamble detection
+                RxTimeout = ( uint32_t )( ( ( ( uint64_t )symbTimeout << datarate ) * 1000UL ) /
+                                          RadioGetLoRaBandwidthInHz( SX126x.ModulationParams.Params.LoRa.Bandwidth ) ) + 1;
+            }
+            else
+            {
+                // Timeout Max, Timeout handled directly in SetRx function
+                RxTimeout = 0xFFFF;
+            }
+
+            break;
 
+        case MODEM_LR_FHSS:
+            // LR-FHSS reception is not supported
             break;
     }
 }
@@ -848,6 +1143,21 @@ void RadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
             SX126xSetModulationParams( &SX126x.ModulationParams );
             SX126xSetPacketParams( &SX126x.PacketParams );
             break;
+
+        case MODEM_LR_FHSS:
+            LrFhss.Params.Bandwidth = ( LrFhssBandwidths_t )bandwidth;
+            LrFhss.Params.CodingRate = ( LrFhssCodingRates_t )coderate;
+            LrFhss.Params.Grid = ( freqHopOn == true ) ? LR_FHSS_GRID_25391_HZ : LR_FHSS_GRID_3906_HZ;
+            LrFhss.Params.HeaderCount = LrFhssGetHeaderCount( LrFhss.Params.CodingRate );
+
+            SX126x.ModulationParams.PacketType = PACKET_TYPE_LR_FHSS;
+            SX126x.ModulationParams.Params.LrFhss.ModulationShaping = MOD_SHAPING_G_BT_1;
+            SX126x.PacketParams.PacketType = PACKET_TYPE_LR_FHSS;
+
+            RadioStandby( );
+            RadioSetModem( MODEM_LR_FHSS );
+            SX126xSetModulationParams( &SX126x.ModulationParams );
+            break;
     }
 
     // WORKAROUND - Modulation Quality with 500 kHz LoRa Bandwidth, see DS_SX1261-2_V1.2 datasheet chapter 15.1
@@ -1019,13 +1329,85 @@ uint32_t RadioTimeOnAir( RadioModems_t modem, uint32_t bandwidth,
             denominator = RadioGetLoRaBandwidthInHz( Bandwidths[bandwidth] );
         }
         break;
+    case MODEM_LR_FHSS:
+        {
+            LrFhssParams_t params;
+
+            params.Bandwidth = ( LrFhssBandwidths_t )bandwidth;
+            params.CodingRate = ( LrFhssCodingRates_t )coderate;
+            params.Grid = LR_FHSS_GRID_3906_HZ;
+            params.HeaderCount = LrFhssGetHeaderCount( params.CodingRate );
+            numerator   = LrFhssGetTimeOnAir( &params, payloadLen );
+            denominator = 1;
+        }
+        break;
     }
     // Perform integral ceil()
     return ( numerator + denominator - 1 ) / denominator;
 }
 
+static void RadioLrFhssSetNextHop( void )
+{
+    int32_t offset = 0;
+
+    if( LrFhss.NextHop >= LrFhss.NbHops )
+    {
+        return;
+    }
+    offset = LrFhssGetNextHopOffset( &LrFhss.Params, &LrFhss.HopSequence );
+    SX126xSetLrFhssHop( LrFhss.NextHop % LR_FHSS_HOP_TABLE_SIZE,
+                        LrFhssGetHopNbBits( &LrFhss.Params, LrFhss.PayloadLen, LrFhss.NextHop ),
+                        ( uint32_t )( ( int32_t )LrFhss.CenterFreq + offset ) );
+    LrFhss.NextHop++;
+}
+
+/*!
+ * \brief Encodes the payload as an LR-FHSS frame, programs the hop table
+ *        and starts the transmission
+ *
+ * \param [IN]: buffer     Buffer pointer
+ * \param [IN]: size       Buffer size
+ */
+static void RadioLrFhssSend( uint8_t *buffer, uint8_t size )
+{
+    uint16_t hopSequenceId = randr( 0, LrFhssGetHopSequenceCount( &LrFhss.Params ) - 1 );
+    uint8_t frameSize = LrFhssBuildFrame( &LrFhss.Params, hopSequenceId, buffer, size, LrFhss.Frame );
+
+    // A payload not fitting in the radio buffer is reported by the Tx timeout
+    if( frameSize != 0 )
+    {
+        LrFhss.PayloadLen = size;
+        LrFhss.NbHops = LrFhssGetNbHops( &LrFhss.Params, size );
+        LrFhss.NextHop = 0;
+        LrFhssHopSequenceInit( &LrFhss.Params, hopSequenceId, &LrFhss.HopSequence );
+
+        SX126xSetLrFhssHopping( frameSize, LrFhss.NbHops );
+        // The following hops are written as the table entries get free
+        while( ( LrFhss.NextHop < LrFhss.NbHops ) && ( LrFhss.NextHop < LR_FHSS_HOP_TABLE_SIZE ) )
+        {
+            RadioLrFhssSetNextHop( );
+        }
+        SX126xSendPayload( LrFhss.Frame, frameSize, 0 );
+    }
+    TimerSetValue( &TxTimeoutTimer, TxTimeout );
+    TimerStart( &TxTimeoutTimer );
+}
+
 void RadioSend( uint8_t *buffer, uint8_t size )
 {
+    RadioChannelSenseAbort( );
+    TxPrepared = false;
+
+    if( SX126xGetPacketType( ) == PACKET_TYPE_LR_FHSS )
+    {
+        SX126xSetDioIrqParams( IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_LR_FHSS_HOP,
+                               IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT | IRQ_LR_FHSS_HOP,
+                               IRQ_RADIO_NONE,
+                               IRQ_RADIO_NONE );
+        RadioLrFhssSend( buffer, size );
+        return;
+    }
+
     SX126xSetDioIrqParams( IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
                            IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
                            IRQ_RADIO_NONE,
@@ -1046,10 +1428,55 @@ void RadioSend( uint8_t *buffer, uint8_t size )
     TimerStart( &TxTimeoutTimer );
 }
 
+void RadioPrepareTx( uint8_t *buffer, uint8_t size )
+{
+    RadioChannelSenseAbort( );
+    SX126xSetStandby( STDBY_RC );
+    SX126xSetDioIrqParams( IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
+                           IRQ_TX_DONE | IRQ_RX_TX_TIMEOUT,
+                           IRQ_RADIO_NONE,
+                           IRQ_RADIO_NONE );
+    SX126xSetPayload( buffer, size );
+
+    TxPreparedSize = size;
+    TxPrepared = true;
+}
+
+bool RadioSendPrepared( void )
+{
+    // LR-FHSS frames are encoded on transmission
+    if( ( TxPrepared == false ) || ( SX126xGetPacketType( ) == PACKET_TYPE_LR_FHSS ) )
+    {
+        TxPrepared = false;
+        return false;
+    }
+    TxPrepared = false;
+
+    // Tx configuration may have been applied after the upload
+    if( SX126xGetPacketType( ) == PACKET_TYPE_LORA )
+    {
+        SX126x.PacketParams.Params.LoRa.PayloadLength = TxPreparedSize;
+    }
+    else
+    {
+        SX126x.PacketParams.Params.Gfsk.PayloadLength = TxPreparedSize;
+    }
+    SX126xSetPacketParams( &SX126x.PacketParams );
+
+    SX126xSetTx( 0 );
+    TimerSetValue( &TxTimeoutTimer, TxTimeout );
+    TimerStart( &TxTimeoutTimer );
+    return true;
+}
+
 void RadioSleep( void )
 {
     SleepParams_t params = { 0 };
 
+    // The data buffer is not retained in sleep mode
+    TxPrepared = false;
+    RadioChannelSenseAbort( );
+
     params.Fields.WarmStart = 1;
     SX126xSetSleep( params );
 
@@ -1058,11 +1485,14 @@ void RadioSleep( void )
 
 void RadioStandby( void )
 {
+    RadioChannelSenseAbort( );
     SX126xSetStandby( STDBY_RC );
 }
 
 void RadioRx( uint32_t timeout )
 {
+    RadioChannelSenseAbort( );
+    TxPrepared = false;
     SX126xSetDioIrqParams( IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
                            IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
                            IRQ_RADIO_NONE,
@@ -1086,6 +1516,8 @@ void RadioRx( uint32_t timeout )
 
 void RadioRxBoosted( uint32_t timeout )
 {
+    RadioChannelSenseAbort( );
+    TxPrepared = false;
     SX126xSetDioIrqParams( IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
                            IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
                            IRQ_RADIO_NONE,
@@ -1109,9 +1541,20 @@ void RadioRxBoosted( uint32_t timeout )
 
 void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime )
 {
+    RadioChannelSenseAbort( );
+    TxPrepared = false;
+    SX126xSetDioIrqParams( IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
+                           IRQ_RADIO_ALL, //IRQ_RX_DONE | IRQ_RX_TX_TIMEOUT,
+                           IRQ_RADIO_NONE,
+                           IRQ_RADIO_NONE );
     SX126xSetRxDutyCycle( rxTime, sleepTime );
 }
 
+void RadioSetRxBuffer( uint8_t *buffer )
+{
+    RadioRxBuffer = ( buffer != NULL ) ? buffer : RadioRxPayload;
+}
+
 void RadioAddRegisterToRetentionList( uint16_t registerAddress )
 {
     uint8_t buffer[9];
@@ -1144,6 +1587,8 @@ void RadioAddRegisterToRetentionList( uint16_t registerAddress )
 
 void RadioStartCad( void )
 {
+    RadioChannelSenseAbort( );
+    TxPrepared = false;
     SX126xSetDioIrqParams( IRQ_CAD_DONE | IRQ_CAD_ACTIVITY_DETECTED, IRQ_CAD_DONE | IRQ_CAD_ACTIVITY_DETECTED, IRQ_RADIO_NONE, IRQ_RADIO_NONE );
     SX126xSetCad( );
 }
@@ -1152,6 +1597,9 @@ void RadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time )
 {
     uint32_t timeout = ( uint32_t )time * 1000;
 
+    TxPrepared = false;
+    RadioChannelSenseAbort( );
+
     SX126xSetRfFrequency( freq );
     SX126xSetRfTxPower( power );
     SX126xSetTxContinuousWave( );
@@ -1177,6 +1625,7 @@ uint8_t RadioRead( uint32_t addr )
 
 void RadioWriteBuffer( uint32_t addr, uint8_t *buffer, uint8_t size )
 {
+    TxPrepared = false;
     SX126xWriteRegisters( addr, buffer, size );
 }
 
@@ -1192,6 +1641,11 @@ void RadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
         SX126x.PacketParams.Params.LoRa.PayloadLength = MaxPayloadLength = max;
         SX126xSetPacketParams( &SX126x.PacketParams );
     }
+    else if( modem == MODEM_LR_FHSS )
+    {
+        // The frame length is set on transmission
+        MaxPayloadLength = max;
+    }
     else
     {
         if( SX126x.PacketParams.Params.Gfsk.HeaderType == RADIO_PACKET_VARIABLE_LENGTH )
@@ -1242,9 +1696,62 @@ void RadioOnRxTimeoutIrq( void* context )
     }
 }
 
+static void RadioOnChannelSenseTimerIrq( void* context )
+{
+    // The RSSI read and the radio sleep use the SPI, they are done by RadioIrqProcess
+    ChannelSense.SampleDue = true;
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+    SX126xIoSwIrqTrigger( );
+#endif
+}
+
+static void RadioChannelSenseProcess( void )
+{
+    bool channelFree = true;
+
+    if( ChannelSense.Running == false )
+    {
+        return;
+    }
+
+    if( ChannelSense.Sampling == false )
+    {
+        ChannelSense.Sampling = true;
+        ChannelSense.StartTime = TimerGetCurrentTime( );
+    }
+
+    if( RadioRssi( MODEM_FSK ) > ChannelSense.RssiThresh )
+    {
+        channelFree = false;
+    }
+    else if( TimerGetElapsedTime( ChannelSense.StartTime ) < ChannelSense.CarrierSenseTime )
+    {
+        TimerSetValue( &ChannelSenseTimer, RADIO_CHANNEL_SENSE_SAMPLE_PERIOD );
+        TimerStart( &ChannelSenseTimer );
+        return;
+    }
+
+    ChannelSense.Running = false;
+    RadioSleep( );
+
+    if( ( RadioEvents != NULL ) && ( RadioEvents->ChannelSenseDone != NULL ) )
+    {
+        RadioEvents->ChannelSenseDone( channelFree );
+    }
+}
+
 void RadioOnDioIrq( void* context )
 {
+#if defined( RADIO_IRQ_LATENCY_STATS )
+    if( IrqFired == false )
+    {
+        IrqTimestamp = RtcGetTimerValue( );
+    }
+#endif
     IrqFired = true;
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+    SX126xIoSwIrqTrigger( );
+#endif
 }
 
 void RadioIrqProcess( void )
@@ -1252,9 +1759,16 @@ void RadioIrqProcess( void )
     CRITICAL_SECTION_BEGIN( );
     // Clear IRQ flag
     const bool isIrqFired = IrqFired;
+    const bool isChannelSenseSampleDue = ChannelSense.SampleDue;
     IrqFired = false;
+    ChannelSense.SampleDue = false;
     CRITICAL_SECTION_END( );
 
+    if( isChannelSenseSampleDue == true )
+    {
+        RadioChannelSenseProcess( );
+    }
+
     if( isIrqFired == true )
     {
         uint16_t irqRegs = SX126xGetIrqStatus( );
@@ -1265,14 +1779,30 @@ void RadioIrqProcess( void )
         if( SX126xGetDio1PinState( ) == 1 )
         {
             IrqFired = true;
+#if defined( RADIO_IRQ_DIRECT_DISPATCH )
+            SX126xIoSwIrqTrigger( );
+#endif
         }
         CRITICAL_SECTION_END( );
 
+        if( ( irqRegs & IRQ_LR_FHSS_HOP ) == IRQ_LR_FHSS_HOP )
+        {
+            // The hop table entry of the completed hop is free
+            RadioLrFhssSetNextHop( );
+        }
+
         if( ( irqRegs & IRQ_TX_DONE ) == IRQ_TX_DONE )
         {
             TimerStop( &TxTimeoutTimer );
+            if( SX126xGetPacketType( ) == PACKET_TYPE_LR_FHSS )
+            {
+                SX126xStopLrFhssHopping( );
+            }
             //!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
             SX126xSetOperatingMode( MODE_STDBY_RC );
+#if defined( RADIO_IRQ_LATENCY_STATS )
+            RadioIrqLatencyRecord( &IrqLatencyStats.TxDone );
+#endif
             if( ( RadioEvents != NULL ) && ( RadioEvents->TxDone != NULL ) )
             {
                 RadioEvents->TxDone( );
@@ -1283,9 +1813,11 @@ void RadioIrqProcess( void )
         {
             TimerStop( &RxTimeoutTimer );
 
+            // The radio leaves the RX duty cycle for standby once a packet is received
+
             if( ( irqRegs & IRQ_CRC_ERROR ) == IRQ_CRC_ERROR )
             {
-                if( RxContinuous == false )
+                if( ( RxContinuous == false ) || ( SX126xGetOperatingMode( ) == MODE_RX_DC ) )
                 {
                     //!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
                     SX126xSetOperatingMode( MODE_STDBY_RC );
@@ -1299,7 +1831,7 @@ void RadioIrqProcess( void )
             {
                 uint8_t size;
 
-                if( RxContinuous == false )
+                if( ( RxContinuous == false ) || ( SX126xGetOperatingMode( ) == MODE_RX_DC ) )
                 {
                     //!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
                     SX126xSetOperatingMode( MODE_STDBY_RC );
@@ -1309,11 +1841,14 @@ void RadioIrqProcess( void )
                     SX126xWriteRegister( REG_EVT_CLR, SX126xReadRegister( REG_EVT_CLR ) | ( 1 << 1 ) );
                     // WORKAROUND END
                 }
-                SX126xGetPayload( RadioRxPayload, &size , 255 );
+                SX126xGetPayload( RadioRxBuffer, &size , 255 );
                 SX126xGetPacketStatus( &RadioPktStatus );
+#if defined( RADIO_IRQ_LATENCY_STATS )
+                RadioIrqLatencyRecord( &IrqLatencyStats.RxDone );
+#endif
                 if( ( RadioEvents != NULL ) && ( RadioEvents->RxDone != NULL ) )
                 {
-                    RadioEvents->RxDone( RadioRxPayload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt );
+                    RadioEvents->RxDone( RadioRxBuffer, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt );
                 }
             }
         }
@@ -1370,7 +1905,7 @@ void RadioIrqProcess( void )
         if( ( irqRegs & IRQ_HEADER_ERROR ) == IRQ_HEADER_ERROR )
         {
             TimerStop( &RxTimeoutTimer );
-            if( RxContinuous == false )
+            if( ( RxContinuous == false ) || ( SX126xGetOperatingMode( ) == MODE_RX_DC ) )
             {
                 //!< Update operating mode state to a value lower than \ref MODE_STDBY_XOSC
                 SX126xSetOperatingMode( MODE_STDBY_RC );
@@ -1382,3 +1917,50 @@ void RadioIrqProcess( void )
         }
     }
 }
+
+#if defined( RADIO_IRQ_LATENCY_STATS )
+static void RadioIrqLatencyRecord( RadioIrqLatencyHistogram_t* histogram )
+{
+    uint32_t latency = RtcGetTimerValue( ) - IrqTimestamp;
+    uint32_t value = latency >> 1;
+    uint8_t bin = 0;
+
+    while( ( value != 0 ) && ( bin < ( RADIO_IRQ_LATENCY_NB_BINS - 1 ) ) )
+    {
+        value >>= 1;
+        bin++;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    if( ( histogram->Count == 0 ) || ( latency < histogram->Min ) )
+    {
+        histogram->Min = latency;
+    }
+    if( latency > histogram->Max )
+    {
+        histogram->Max = latency;
+    }
+    histogram->Count++;
+    histogram->Sum += latency;
+    histogram->Bins[bin]++;
+    CRITICAL_SECTION_END( );
+}
+
+void RadioIrqLatencyStatsGet( RadioIrqLatencyStats_t* stats )
+{
+    if( stats == NULL )
+    {
+        return;
+    }
+    CRITICAL_SECTION_BEGIN( );
+    *stats = IrqLatencyStats;
+    CRITICAL_SECTION_END( );
+}
+
+void RadioIrqLatencyStatsReset( void )
+{
+    CRITICAL_SECTION_BEGIN( );
+    memset1( ( uint8_t* )&IrqLatencyStats, 0, sizeof( IrqLatencyStats ) );
+    CRITICAL_SECTION_END( );
+}
+#endif
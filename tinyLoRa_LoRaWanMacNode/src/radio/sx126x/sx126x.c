@@ -27,6 +27,7 @@
 #include "sx-delay.h"
 #include "sx126x.h"
 #include "sx126x-board.h"
+#include "lr-fhss.h"
 
 /*!
  * \brief Internal frequency of the radio
@@ -607,6 +608,16 @@ void SX126xSetModulationParams( ModulationParams_t *modulationParams )
 
         SX126xWriteCommand( RADIO_SET_MODULATIONPARAMS, buf, n );
 
+        break;
+    case PACKET_TYPE_LR_FHSS:
+        n = 8;
+        tempVal = ( uint32_t )( ( 32ULL * SX126X_XTAL_FREQ * LR_FHSS_BITRATE_DEN ) / LR_FHSS_BITRATE_NUM );
+        buf[0] = ( tempVal >> 16 ) & 0xFF;
+        buf[1] = ( tempVal >> 8 ) & 0xFF;
+        buf[2] = tempVal & 0xFF;
+        buf[3] = modulationParams->Params.LrFhss.ModulationShaping;
+        // Bandwidth and frequency deviation are not used
+        SX126xWriteCommand( RADIO_SET_MODULATIONPARAMS, buf, n );
         break;
     default:
     case PACKET_TYPE_NONE:
@@ -666,6 +677,8 @@ void SX126xSetPacketParams( PacketParams_t *packetParams )
         buf[4] = packetParams->Params.LoRa.CrcMode;
         buf[5] = packetParams->Params.LoRa.InvertIQ;
         break;
+    case PACKET_TYPE_LR_FHSS:
+        // The frame length is given by SX126xSetLrFhssHopping
     default:
     case PACKET_TYPE_NONE:
         return;
@@ -803,6 +816,35 @@ void SX126xClearIrqStatus( uint16_t irq )
     SX126xWriteCommand( RADIO_CLR_IRQSTATUS, buf, 2 );
 }
 
+void SX126xSetLrFhssHopping( uint8_t frameSize, uint8_t nbHops )
+{
+    uint8_t buf[3];
+
+    buf[0] = LR_FHSS_HOPPING_ENABLE;
+    buf[1] = frameSize;
+    buf[2] = nbHops;
+    SX126xWriteRegisters( REG_LR_FHSS_CTRL, buf, 3 );
+}
+
+void SX126xStopLrFhssHopping( void )
+{
+    SX126xWriteRegister( REG_LR_FHSS_CTRL, LR_FHSS_HOPPING_DISABLE );
+}
+
+void SX126xSetLrFhssHop( uint8_t index, uint16_t nbSymbols, uint32_t freqInHz )
+{
+    uint8_t buf[LR_FHSS_HOP_ENTRY_SIZE];
+    uint32_t freqInPllSteps = SX126xConvertFreqInHzToPllStep( freqInHz );
+
+    buf[0] = ( uint8_t )( ( nbSymbols >> 8 ) & 0xFF );
+    buf[1] = ( uint8_t )( nbSymbols & 0xFF );
+    buf[2] = ( uint8_t )( ( freqInPllSteps >> 24 ) & 0xFF );
+    buf[3] = ( uint8_t )( ( freqInPllSteps >> 16 ) & 0xFF );
+    buf[4] = ( uint8_t )( ( freqInPllSteps >> 8 ) & 0xFF );
+    buf[5] = ( uint8_t )( freqInPllSteps & 0xFF );
+    SX126xWriteRegisters( REG_LR_FHSS_HOP_TABLE + ( index * LR_FHSS_HOP_ENTRY_SIZE ), buf, LR_FHSS_HOP_ENTRY_SIZE );
+}
+
 static uint32_t SX126xConvertFreqInHzToPllStep( uint32_t freqInHz )
 {
     uint32_t stepsInt;
@@ -186,6 +186,43 @@ extern "C"
  */
 #define REG_EVT_CLR                                 0x0944
 
+/*!
+ * \brief LR-FHSS frequency hopping control
+ */
+#define REG_LR_FHSS_CTRL                            0x0385
+
+/*!
+ * \brief LR-FHSS frame length in bytes
+ */
+#define REG_LR_FHSS_PACKET_LEN                      0x0386
+
+/*!
+ * \brief LR-FHSS total number of hops
+ */
+#define REG_LR_FHSS_NUM_HOPS                        0x0387
+
+/*!
+ * \brief LR-FHSS hop table. Each entry holds the number of symbols of the hop
+ *        ( 16 bits ) followed by its frequency in PLL steps ( 32 bits )
+ */
+#define REG_LR_FHSS_HOP_TABLE                       0x0388
+
+/*!
+ * \brief LR-FHSS hop table number of entries
+ */
+#define LR_FHSS_HOP_TABLE_SIZE                      16
+
+/*!
+ * \brief LR-FHSS hop table entry size in bytes
+ */
+#define LR_FHSS_HOP_ENTRY_SIZE                      6
+
+/*!
+ * \brief LR-FHSS hopping control values
+ */
+#define LR_FHSS_HOPPING_DISABLE                     0x08
+#define LR_FHSS_HOPPING_ENABLE                      0x0C
+
 /*!
  * \brief Structure describing the radio status
  */
@@ -264,6 +301,7 @@ typedef enum
 {
     PACKET_TYPE_GFSK                        = 0x00,
     PACKET_TYPE_LORA                        = 0x01,
+    PACKET_TYPE_LR_FHSS                     = 0x03,
     PACKET_TYPE_NONE                        = 0x0F,
 }RadioPacketTypes_t;
 
@@ -503,6 +541,7 @@ typedef enum
     IRQ_CAD_DONE                            = 0x0080,
     IRQ_CAD_ACTIVITY_DETECTED               = 0x0100,
     IRQ_RX_TX_TIMEOUT                       = 0x0200,
+    IRQ_LR_FHSS_HOP                         = 0x4000,
     IRQ_RADIO_ALL                           = 0xFFFF,
 }RadioIrqMasks_t;
 
@@ -576,6 +615,10 @@ typedef struct
             RadioLoRaCodingRates_t       CodingRate;        //!< Coding rate for the LoRa modulation
             uint8_t                      LowDatarateOptimize; //!< Indicates if the modem uses the low datarate optimization
         }LoRa;
+        struct
+        {
+            RadioModShapings_t           ModulationShaping; //!< Pulse shape of the LR-FHSS GMSK modulation
+        }LrFhss;
     }Params;                                                //!< Holds the modulation parameters structure
 }ModulationParams_t;
 
@@ -1151,6 +1194,28 @@ void SX126xClearDeviceErrors( void );
  */
 void SX126xClearIrqStatus( uint16_t irq );
 
+/*!
+ * \brief Enables the LR-FHSS frequency hopping for the next transmission
+ *
+ * \param [in]  frameSize     Size of the LR-FHSS frame
+ * \param [in]  nbHops        Total number of hops of the frame
+ */
+void SX126xSetLrFhssHopping( uint8_t frameSize, uint8_t nbHops );
+
+/*!
+ * \brief Disables the LR-FHSS frequency hopping
+ */
+void SX126xStopLrFhssHopping( void );
+
+/*!
+ * \brief Writes an LR-FHSS hop table entry
+ *
+ * \param [in]  index         Hop table entry [0: LR_FHSS_HOP_TABLE_SIZE - 1]
+ * \param [in]  nbSymbols     Number of symbols sent on the hop
+ * \param [in]  freqInHz      Hop RF frequency in Hertz
+ */
+void SX126xSetLrFhssHop( uint8_t index, uint16_t nbSymbols, uint32_t freqInHz );
+
 #ifdef __cplusplus
 }
 #endif
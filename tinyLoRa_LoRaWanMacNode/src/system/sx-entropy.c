@@ -0,0 +1,359 @@
+/*!
+ * \file      sx-entropy.c
+ *
+ * \brief     Entropy pool and random number generator
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    The generator is a CTR_DRBG ( NIST SP 800-90A ) using AES-128
+ *            without derivation function. Seeds are folded into a pool of
+ *            seed length which is used as additional input on reseed.
+ *
+ *            Compiled with USE_ENTROPY_POOL only, the generator runs on the
+ *            AES of soft-se ( see ENTROPY_POOL_ENABLED ).
+ */
+#if defined( USE_ENTROPY_POOL )
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "utilities.h"
+#include "board.h"
+#include "aes.h"
+#include "sx-entropy.h"
+
+/*!
+ * Generator seed length ( key length + block length )
+ */
+#define ENTROPY_SEED_LENGTH                         32
+
+/*!
+ * Number of AES blocks generated on each buffer refill
+ */
+#define ENTROPY_REFILL_NB_BLOCKS                    4
+
+/*!
+ * Size of the random words buffer
+ */
+#define ENTROPY_BUFFER_NB_WORDS                     ( ENTROPY_REFILL_NB_BLOCKS * 4 )
+
+/*!
+ * Number of generated blocks after which the generator is reseeded
+ */
+#define ENTROPY_RESEED_INTERVAL                     1024
+
+/*!
+ * Number of board entropy words harvested on each reseed
+ */
+#define ENTROPY_BOARD_SEED_NB_WORDS                 8
+
+/*!
+ * Entropy module context
+ */
+static struct
+{
+    /*!
+     * Set once the generator is instantiated
+     */
+    bool Initialized;
+    /*!
+     * Generator key
+     */
+    uint8_t Key[16];
+    /*!
+     * Generator counter
+     */
+    uint8_t V[16];
+    /*!
+     * Seed pool
+     */
+    uint8_t Pool[ENTROPY_SEED_LENGTH];
+    /*!
+     * Next pool byte to mix a seed into
+     */
+    uint8_t PoolIndex;
+    /*!
+     * Set when the pool holds seeds not yet used by the generator
+     */
+    bool PoolPending;
+    /*!
+     * Number of blocks generated since the last reseed
+     */
+    uint16_t BlockCounter;
+    /*!
+     * Random words buffers. Words are served from the active buffer while
+     * the spare one is refilled
+     */
+    uint32_t Buffers[2][ENTROPY_BUFFER_NB_WORDS];
+    /*!
+     * Active buffer index
+     */
+    uint8_t ActiveBuffer;
+    /*!
+     * Next random word of the active buffer to serve
+     */
+    uint8_t BufferIndex;
+    /*!
+     * Set when the spare buffer holds random words
+     */
+    bool SpareReady;
+    /*!
+     * Set while a refill owns the generator state and the spare buffer
+     */
+    bool Refilling;
+}EntropyCtx;
+
+/*!
+ * \brief Increments the generator counter
+ */
+static void EntropyIncrementV( void )
+{
+    for( int8_t i = 15; i >= 0; i-- )
+    {
+        if( ++EntropyCtx.V[i] != 0 )
+        {
+            break;
+        }
+    }
+}
+
+/*!
+ * \brief CTR_DRBG update function
+ *
+ * \param [IN] providedData Seed length additional input [NULL: zeros]
+ */
+static void EntropyUpdate( const uint8_t* providedData )
+{
+    aes_context aesContext;
+    uint8_t temp[ENTROPY_SEED_LENGTH];
+
+    aes_set_key( EntropyCtx.Key, 16, &aesContext );
+
+    EntropyIncrementV( );
+    aes_encrypt( EntropyCtx.V, &temp[0], &aesContext );
+    EntropyIncrementV( );
+    aes_encrypt( EntropyCtx.V, &temp[16], &aesContext );
+
+    if( providedData != NULL )
+    {
+        for( uint8_t i = 0; i < ENTROPY_SEED_LENGTH; i++ )
+        {
+            temp[i] ^= providedData[i];
+        }
+    }
+    memcpy1( EntropyCtx.Key, &temp[0], 16 );
+    memcpy1( EntropyCtx.V, &temp[16], 16 );
+
+    memset1( temp, 0, sizeof( temp ) );
+    memset1( ( uint8_t* )&aesContext, 0, sizeof( aesContext ) );
+}
+
+/*!
+ * \brief Mixes the board entropy source into the pool
+ */
+static void EntropyHarvestBoard( void )
+{
+    for( uint8_t i = 0; i < ENTROPY_BOARD_SEED_NB_WORDS; i++ )
+    {
+        uint32_t bits = BoardGetEntropy( );
+
+        EntropyAddSeed( ( uint8_t* )&bits, sizeof( bits ) );
+    }
+}
+
+/*!
+ * \brief Publishes the refilled spare buffer and gives up the refill ownership
+ */
+static void EntropyReleaseRefill( void )
+{
+    CRITICAL_SECTION_BEGIN( );
+    EntropyCtx.SpareReady = true;
+    EntropyCtx.Refilling = false;
+    CRITICAL_SECTION_END( );
+}
+
+/*!
+ * \brief Refills the spare random words buffer, reseeding the generator
+ *        first when the pool holds new seeds
+ *
+ * \remark The caller owns the refill ( Refilling set ). Only the pool and the
+ *         buffer indices are accessed under critical section, the AES runs
+ *         with the interrupts enabled.
+ */
+static void EntropyRefill( void )
+{
+    aes_context aesContext;
+    uint8_t pool[ENTROPY_SEED_LENGTH];
+    bool reseed = false;
+    uint8_t* spare;
+
+    CRITICAL_SECTION_BEGIN( );
+    if( EntropyCtx.PoolPending == true )
+    {
+        memcpy1( pool, EntropyCtx.Pool, sizeof( pool ) );
+        memset1( EntropyCtx.Pool, 0, sizeof( EntropyCtx.Pool ) );
+        EntropyCtx.PoolIndex = 0;
+        EntropyCtx.PoolPending = false;
+        reseed = true;
+    }
+    spare = ( uint8_t* )EntropyCtx.Buffers[EntropyCtx.ActiveBuffer ^ 1];
+    CRITICAL_SECTION_END( );
+
+    if( reseed == true )
+    {
+        EntropyUpdate( pool );
+        memset1( pool, 0, sizeof( pool ) );
+        EntropyCtx.BlockCounter = 0;
+    }
+
+    aes_set_key( EntropyCtx.Key, 16, &aesContext );
+    for( uint8_t i = 0; i < ENTROPY_REFILL_NB_BLOCKS; i++ )
+    {
+        EntropyIncrementV( );
+        aes_encrypt( EntropyCtx.V, &spare[i * 16], &aesContext );
+    }
+    memset1( ( uint8_t* )&aesContext, 0, sizeof( aesContext ) );
+
+    // Backtracking resistance
+    EntropyUpdate( NULL );
+
+    EntropyCtx.BlockCounter += ENTROPY_REFILL_NB_BLOCKS;
+
+    EntropyReleaseRefill( );
+}
+
+/*!
+ * \brief Serves a word of the active buffer, switching to the spare buffer
+ *        when the active one is exhausted
+ *
+ * \param [OUT] random Random value
+ *
+ * \retval served False when both buffers are exhausted
+ */
+static bool EntropyServe( uint32_t* random )
+{
+    bool served = false;
+
+    CRITICAL_SECTION_BEGIN( );
+    if( ( EntropyCtx.BufferIndex >= ENTROPY_BUFFER_NB_WORDS ) && ( EntropyCtx.SpareReady == true ) )
+    {
+        EntropyCtx.ActiveBuffer ^= 1;
+        EntropyCtx.BufferIndex = 0;
+        EntropyCtx.SpareReady = false;
+    }
+    if( EntropyCtx.BufferIndex < ENTROPY_BUFFER_NB_WORDS )
+    {
+        uint32_t* buffer = EntropyCtx.Buffers[EntropyCtx.ActiveBuffer];
+
+        *random = buffer[EntropyCtx.BufferIndex];
+        // A served word is never served again
+        buffer[EntropyCtx.BufferIndex++] = 0;
+        served = true;
+    }
+    CRITICAL_SECTION_END( );
+
+    return served;
+}
+
+/*!
+ * \brief Takes the ownership of a refill
+ *
+ * \param [IN] force Refill even if the spare buffer is ready and no seed is pending
+ *
+ * \retval claimed True when the caller has to run EntropyRefill
+ */
+static bool EntropyClaimRefill( bool force )
+{
+    bool claimed = false;
+
+    CRITICAL_SECTION_BEGIN( );
+    if( ( EntropyCtx.Refilling == false ) &&
+        ( ( force == true ) || ( EntropyCtx.SpareReady == false ) || ( EntropyCtx.PoolPending == true ) ) )
+    {
+        // A spare buffer generated before the new seeds is dropped
+        EntropyCtx.SpareReady = false;
+        EntropyCtx.Refilling = true;
+        claimed = true;
+    }
+    CRITICAL_SECTION_END( );
+
+    return claimed;
+}
+
+void EntropyInit( void )
+{
+    bool init = false;
+
+    CRITICAL_SECTION_BEGIN( );
+    if( ( EntropyCtx.Initialized == false ) && ( EntropyCtx.Refilling == false ) )
+    {
+        EntropyCtx.Initialized = true;
+        EntropyCtx.Refilling = true;
+        EntropyCtx.BufferIndex = ENTROPY_BUFFER_NB_WORDS;
+        init = true;
+    }
+    CRITICAL_SECTION_END( );
+
+    if( init == true )
+    {
+        EntropyHarvestBoard( );
+        EntropyRefill( );
+    }
+}
+
+void EntropyAddSeed( const uint8_t* seed, uint16_t size )
+{
+    if( seed == NULL )
+    {
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    for( uint16_t i = 0; i < size; i++ )
+    {
+        EntropyCtx.Pool[EntropyCtx.PoolIndex] ^= seed[i];
+        EntropyCtx.PoolIndex = ( EntropyCtx.PoolIndex + 1 ) % ENTROPY_SEED_LENGTH;
+    }
+    EntropyCtx.PoolPending = true;
+    CRITICAL_SECTION_END( );
+}
+
+bool EntropyIsSeedDue( void )
+{
+    return ( EntropyCtx.BlockCounter >= ENTROPY_RESEED_INTERVAL ) && ( EntropyCtx.PoolPending == false );
+}
+
+void EntropyProcess( void )
+{
+    EntropyInit( );
+
+    if( EntropyIsSeedDue( ) == true )
+    {
+        EntropyHarvestBoard( );
+    }
+
+    if( EntropyClaimRefill( false ) == true )
+    {
+        EntropyRefill( );
+    }
+}
+
+uint32_t EntropyGetRandom( void )
+{
+    uint32_t random = 0;
+
+    EntropyInit( );
+
+    while( EntropyServe( &random ) == false )
+    {
+        if( EntropyClaimRefill( true ) == false )
+        {
+            // Called from an interrupt while a refill is in progress, the
+            // generator state is not usable
+            return BoardGetEntropy( );
+        }
+        EntropyRefill( );
+    }
+    return random;
+}
+
+#endif // USE_ENTROPY_POOL
@@ -0,0 +1,69 @@
+/*!
+ * \file      sx-entropy.h
+ *
+ * \brief     Entropy pool and random number generator
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \remark    Seeds ( radio RNG, board entropy source... ) are accumulated in
+ *            a pool and conditioned by an AES-128 CTR_DRBG. Random words are
+ *            served from a buffer while EntropyProcess refills a second one
+ *            at idle.
+ */
+#ifndef __SX_ENTROPY_H__
+#define __SX_ENTROPY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*!
+ * Number of radio random numbers used to seed the pool at start up and on
+ * each reseed
+ */
+#define ENTROPY_RADIO_SEED_NB_WORDS                 8
+
+/*!
+ * \brief Initializes the entropy pool with the board entropy source
+ *
+ * \remark Called on first use when not called by the application.
+ */
+void EntropyInit( void );
+
+/*!
+ * \brief Mixes the given seed into the entropy pool
+ *
+ * \param [IN] seed Seed buffer
+ * \param [IN] size Seed buffer size
+ */
+void EntropyAddSeed( const uint8_t* seed, uint16_t size );
+
+/*!
+ * \brief Checks if the generator waits for new seeds before its next reseed
+ *
+ * \retval due True when seeds should be added with EntropyAddSeed
+ */
+bool EntropyIsSeedDue( void );
+
+/*!
+ * \brief Reseeds the generator when due and refills the random words buffer.
+ *        To be called when the system is idle.
+ */
+void EntropyProcess( void );
+
+/*!
+ * \brief Gets a 32 bits random value
+ *
+ * \retval random Random value
+ */
+uint32_t EntropyGetRandom( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SX_ENTROPY_H__